@@ -0,0 +1,674 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Decode conmon status message bodies into plain structures
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_aud_decode_msg.h"
+#include <string.h>
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_aud_decode_interface_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_interface_status_t * decoded
+)
+{
+	uint16_t p, np = conmon_audinate_interface_status_num_interfaces(aud_msg);
+
+	decoded->mode = conmon_audinate_interface_status_get_mode(aud_msg);
+	decoded->flags = conmon_audinate_interface_status_get_flags(aud_msg);
+	decoded->num_interfaces = np;
+	if (np > CONMON_AUD_DECODE_MAX_INTERFACES)
+	{
+		np = CONMON_AUD_DECODE_MAX_INTERFACES;
+	}
+	decoded->interfaces_decoded = np;
+
+	for (p = 0; p < np; p++)
+	{
+		conmon_aud_decoded_interface_t * out = decoded->interfaces + p;
+		const conmon_audinate_interface_t * i = conmon_audinate_interface_status_interface_at_index(aud_msg, p);
+
+		out->flags = conmon_audinate_interface_get_flags(i, aud_msg);
+		out->link_speed = conmon_audinate_interface_get_link_speed(i, aud_msg);
+		memcpy(out->mac_address, conmon_audinate_interface_get_mac_address(i, aud_msg), sizeof(out->mac_address));
+		out->ip_address = conmon_audinate_interface_get_ip_address(i, aud_msg);
+		out->netmask = conmon_audinate_interface_get_netmask(i, aud_msg);
+		out->dns_server = conmon_audinate_interface_get_dns_server(i, aud_msg);
+		out->gateway = conmon_audinate_interface_get_gateway(i, aud_msg);
+		out->domain_name = conmon_audinate_interface_status_get_domain_name(i, aud_msg, body_size);
+
+		out->reboot_configured = conmon_audinate_interface_is_reboot_configured(i, aud_msg);
+		if (out->reboot_configured)
+		{
+			out->reboot_flags = conmon_audinate_interface_get_reboot_flags(i, aud_msg);
+			out->reboot_ip_address = conmon_audinate_interface_get_reboot_ip_address(i, aud_msg);
+			out->reboot_netmask = conmon_audinate_interface_get_reboot_netmask(i, aud_msg);
+			out->reboot_dns_server = conmon_audinate_interface_get_reboot_dns_server(i, aud_msg);
+			out->reboot_gateway = conmon_audinate_interface_get_reboot_gateway(i, aud_msg);
+			out->reboot_domain_name = conmon_audinate_interface_status_get_reboot_domain_name(i, aud_msg, body_size);
+		}
+		else
+		{
+			out->reboot_flags = 0;
+			out->reboot_ip_address = 0;
+			out->reboot_netmask = 0;
+			out->reboot_dns_server = 0;
+			out->reboot_gateway = 0;
+			out->reboot_domain_name = NULL;
+		}
+	}
+	return (np < decoded->num_interfaces) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_clocking_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_clocking_status_t * decoded
+)
+{
+	uint16_t p, np = conmon_audinate_clocking_status_num_ports(aud_msg);
+
+	AUD_UNUSED(body_size);
+
+	decoded->capabilities = conmon_audinate_clocking_status_get_capabilities(aud_msg);
+	decoded->clock_source = conmon_audinate_clocking_status_get_clock_source(aud_msg);
+	decoded->clock_state = conmon_audinate_clocking_status_get_clock_state(aud_msg);
+	decoded->servo_state = conmon_audinate_clocking_status_get_servo_state(aud_msg);
+	decoded->clock_stratum = conmon_audinate_clocking_status_get_clock_stratum(aud_msg);
+	decoded->clock_preferred = conmon_audinate_clocking_status_is_clock_preferred(aud_msg);
+	decoded->unicast_delay_requests = conmon_audinate_clocking_status_get_unicast_delay_requests(aud_msg);
+	decoded->multicast_ports_enabled = conmon_audinate_clocking_status_get_multicast_ports_enabled(aud_msg);
+	decoded->slave_only_enabled = conmon_audinate_clocking_status_get_slave_only_enabled(aud_msg);
+	decoded->drift = conmon_audinate_clocking_status_get_drift(aud_msg);
+	decoded->max_drift = conmon_audinate_clocking_status_get_max_drift(aud_msg);
+	decoded->uuid = conmon_audinate_clocking_status_get_uuid(aud_msg);
+	decoded->master_uuid = conmon_audinate_clocking_status_get_master_uuid(aud_msg);
+	decoded->grandmaster_uuid = conmon_audinate_clocking_status_get_grandmaster_uuid(aud_msg);
+	decoded->subdomain_name = conmon_audinate_clocking_status_get_subdomain_name(aud_msg);
+	decoded->subdomain_index = conmon_audinate_clocking_status_get_subdomain_index(aud_msg);
+	decoded->mute_flags = conmon_audinate_clocking_status_get_mute_flags(aud_msg);
+	decoded->ext_wc_state = conmon_audinate_clocking_status_get_ext_wc_state(aud_msg);
+
+	decoded->num_ports = np;
+	if (np > CONMON_AUD_DECODE_MAX_CLOCK_PORTS)
+	{
+		np = CONMON_AUD_DECODE_MAX_CLOCK_PORTS;
+	}
+	decoded->ports_decoded = np;
+	decoded->ports_valid = 0;
+	for (p = 0; p < np; p++)
+	{
+		const conmon_audinate_port_status_t * port_status = conmon_audinate_clocking_status_port_at_index(aud_msg, p);
+		if (port_status)
+		{
+			decoded->port_states[p] = conmon_audinate_port_status_get_port_state(port_status, aud_msg);
+			decoded->ports_valid |= (1u << p);
+		}
+	}
+	return (np < decoded->num_ports) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_unicast_clocking_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_unicast_clocking_status_t * decoded
+)
+{
+	uint16_t p, np = conmon_audinate_unicast_clocking_status_num_ports(aud_msg);
+
+	AUD_UNUSED(body_size);
+
+	decoded->num_ports = np;
+	if (np > CONMON_AUD_DECODE_MAX_UNICAST_CLOCK_PORTS)
+	{
+		np = CONMON_AUD_DECODE_MAX_UNICAST_CLOCK_PORTS;
+	}
+	decoded->ports_decoded = np;
+	decoded->ports_valid = 0;
+	for (p = 0; p < np; p++)
+	{
+		const conmon_audinate_unicast_port_status_t * port_status = conmon_audinate_unicast_clocking_status_port_at_index(aud_msg, p);
+		if (port_status)
+		{
+			conmon_aud_decoded_unicast_clock_port_t * out = decoded->ports + p;
+			out->port_state = conmon_audinate_unicast_port_status_get_port_state(port_status, aud_msg);
+			out->num_devices = conmon_audinate_unicast_port_status_num_devices(port_status, aud_msg);
+			out->max_devices = conmon_audinate_unicast_port_status_max_devices(port_status, aud_msg);
+			decoded->ports_valid |= (1u << p);
+		}
+	}
+	return (np < decoded->num_ports) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_master_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_master_status_t * decoded
+)
+{
+	uint16_t p, np = conmon_audinate_master_status_num_ports(aud_msg);
+
+	AUD_UNUSED(body_size);
+
+	decoded->clock_subdomain_name = conmon_audinate_master_status_get_clock_subdomain_name(aud_msg);
+	decoded->num_ports = np;
+	if (np > CONMON_AUD_DECODE_MAX_CLOCK_PORTS)
+	{
+		np = CONMON_AUD_DECODE_MAX_CLOCK_PORTS;
+	}
+	decoded->ports_decoded = np;
+	for (p = 0; p < np; p++)
+	{
+		decoded->port_states[p] = conmon_audinate_master_status_port_state_at_index(aud_msg, p);
+	}
+	return (np < decoded->num_ports) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_ifstats_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_ifstats_status_t * decoded
+)
+{
+	uint16_t i, ni = conmon_audinate_ifstats_status_num_interfaces(aud_msg);
+
+	decoded->capabilities = conmon_audinate_ifstats_status_get_capabilities(aud_msg, body_size);
+	decoded->num_interfaces = ni;
+	decoded->num_ports = 0;
+	decoded->ports_decoded = 0;
+
+	for (i = 0; i < ni; i++)
+	{
+		uint16_t p, np = conmon_audinate_ifstats_status_num_interface_ports(aud_msg, i);
+		for (p = 0; p < np; p++)
+		{
+			const conmon_audinate_ifstats_t * ifstats;
+			conmon_aud_decoded_ifstats_port_t * out;
+
+			decoded->num_ports++;
+			if (decoded->ports_decoded == CONMON_AUD_DECODE_MAX_IFSTATS_PORTS)
+			{
+				continue;
+			}
+			ifstats = conmon_audinate_ifstats_status_interface_port_at_index(aud_msg, i, p);
+			out = decoded->ports + decoded->ports_decoded++;
+			out->interface_index = i;
+			out->port = p;
+			out->port_type = conmon_audinate_ifstats_get_port_type(ifstats, aud_msg);
+			out->port_type_index = conmon_audinate_ifstats_get_port_type_index(ifstats, aud_msg);
+			out->flags = conmon_audinate_ifstats_get_flags(ifstats, aud_msg);
+			out->link_speed = conmon_audinate_ifstats_get_link_speed(ifstats, aud_msg);
+			out->tx_util = conmon_audinate_ifstats_get_tx_util(ifstats, aud_msg);
+			out->rx_util = conmon_audinate_ifstats_get_rx_util(ifstats, aud_msg);
+			out->tx_errors = conmon_audinate_ifstats_get_tx_errors(ifstats, aud_msg);
+			out->rx_errors = conmon_audinate_ifstats_get_rx_errors(ifstats, aud_msg);
+		}
+	}
+	return (decoded->ports_decoded < decoded->num_ports) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_versions_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_versions_status_t * decoded
+)
+{
+	AUD_UNUSED(body_size);
+
+	conmon_audinate_versions_status_get_dante_software_version_build(aud_msg,
+		&decoded->software_version, &decoded->software_build);
+	conmon_audinate_versions_status_get_dante_firmware_version_build(aud_msg,
+		&decoded->firmware_version, &decoded->firmware_build);
+	decoded->dante_api_version = conmon_audinate_versions_status_get_dante_api_version(aud_msg);
+	decoded->uboot_version = conmon_audinate_versions_status_get_uboot_version(aud_msg);
+	decoded->upgrade_version = conmon_audinate_versions_status_get_upgrade_version(aud_msg);
+	decoded->capability_flags = conmon_audinate_versions_status_get_capability_flags(aud_msg);
+	decoded->inferred_capability_flags = conmon_audinate_versions_status_infer_all_capability_flags(aud_msg);
+	decoded->readonly_capability_flags = conmon_audinate_versions_status_get_readonly_capability_flags(aud_msg);
+	decoded->preferred_link_speed = conmon_audinate_versions_status_get_preferred_link_speed(aud_msg);
+	decoded->model_id = conmon_audinate_versions_status_get_dante_model_id(aud_msg);
+	decoded->model_name = conmon_audinate_versions_status_get_dante_model_name(aud_msg);
+	decoded->device_status = conmon_audinate_versions_status_get_device_status(aud_msg);
+	decoded->clock_protocols = conmon_audinate_versions_status_get_clock_protocols(aud_msg);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_manf_versions_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_manf_versions_status_t * decoded
+)
+{
+	AUD_UNUSED(body_size);
+
+	decoded->manufacturer = conmon_audinate_manf_versions_status_get_manufacturer(aud_msg);
+	decoded->manufacturer_name = conmon_audinate_manf_versions_status_get_manufacturer_name(aud_msg);
+	decoded->model_id = conmon_audinate_manf_versions_status_get_model_id(aud_msg);
+	decoded->model_name = conmon_audinate_manf_versions_status_get_model_name(aud_msg);
+	decoded->serial_id = conmon_audinate_manf_versions_status_get_serial_id(aud_msg);
+	decoded->model_version = conmon_audinate_manf_versions_status_get_model_version(aud_msg);
+	decoded->model_version_string = conmon_audinate_manf_versions_status_get_model_version_string(aud_msg);
+	conmon_audinate_manf_versions_status_get_software_version_build(aud_msg,
+		&decoded->software_version, &decoded->software_build);
+	conmon_audinate_manf_versions_status_get_firmware_version_build(aud_msg,
+		&decoded->firmware_version, &decoded->firmware_build);
+	decoded->capabilities = conmon_audinate_manf_versions_status_get_capabilities(aud_msg);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_upgrade_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_upgrade_status_t * decoded
+)
+{
+	if (conmon_audinate_upgrade_status_get_upgrade_status(aud_msg, body_size, &decoded->status) != AUD_SUCCESS)
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+	decoded->has_source_file =
+		(conmon_audinate_upgrade_status_get_source_file_info(aud_msg, body_size, &decoded->source_file) == AUD_SUCCESS);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_serial_port_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_serial_port_status_t * decoded
+)
+{
+	aud_bool_t truncated = AUD_FALSE;
+	uint16_t i, n;
+
+	AUD_UNUSED(body_size);
+
+	decoded->num_ports = conmon_audinate_serial_port_status_num_ports(aud_msg);
+	n = decoded->num_ports;
+	if (n > CONMON_AUD_DECODE_MAX_SERIAL_PORTS)
+	{
+		n = CONMON_AUD_DECODE_MAX_SERIAL_PORTS;
+		truncated = AUD_TRUE;
+	}
+	decoded->ports_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		conmon_aud_decoded_serial_port_t * out = decoded->ports + i;
+		const conmon_audinate_serial_port_t * serial_port = conmon_audinate_serial_port_status_port_at_index(aud_msg, i);
+		out->mode = conmon_audinate_serial_port_get_mode(serial_port);
+		out->baud_rate = conmon_audinate_serial_port_get_baud_rate(serial_port);
+		out->bits = conmon_audinate_serial_port_get_bits(serial_port);
+		out->parity = conmon_audinate_serial_port_get_parity(serial_port);
+		out->stop_bits = conmon_audinate_serial_port_get_stop_bits(serial_port);
+		out->is_configurable = conmon_audinate_serial_port_is_configurable(serial_port);
+	}
+
+	decoded->num_baud_rates = conmon_audinate_serial_port_status_num_available_baud_rates(aud_msg);
+	decoded->num_bits = conmon_audinate_serial_port_status_num_available_bits(aud_msg);
+	decoded->num_parities = conmon_audinate_serial_port_status_num_available_parities(aud_msg);
+	decoded->num_stop_bits = conmon_audinate_serial_port_status_num_available_stop_bits(aud_msg);
+	for (i = 0; i < decoded->num_baud_rates && i < CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS; i++)
+	{
+		decoded->baud_rates[i] = conmon_audinate_serial_port_status_available_baud_rate_at_index(aud_msg, i);
+	}
+	for (i = 0; i < decoded->num_bits && i < CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS; i++)
+	{
+		decoded->bits[i] = conmon_audinate_serial_port_status_available_bits_at_index(aud_msg, i);
+	}
+	for (i = 0; i < decoded->num_parities && i < CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS; i++)
+	{
+		decoded->parities[i] = conmon_audinate_serial_port_status_available_parity_at_index(aud_msg, i);
+	}
+	for (i = 0; i < decoded->num_stop_bits && i < CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS; i++)
+	{
+		decoded->stop_bits[i] = conmon_audinate_serial_port_status_available_stop_bits_at_index(aud_msg, i);
+	}
+	if (decoded->num_baud_rates > CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS
+		|| decoded->num_bits > CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS
+		|| decoded->num_parities > CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS
+		|| decoded->num_stop_bits > CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS)
+	{
+		truncated = AUD_TRUE;
+	}
+	return truncated ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_haremote_stats_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_haremote_stats_status_t * decoded
+)
+{
+	uint16_t i, n = conmon_audinate_haremote_stats_status_num_ports(aud_msg);
+
+	AUD_UNUSED(body_size);
+
+	decoded->num_ports = n;
+	if (n > CONMON_AUD_DECODE_MAX_HAREMOTE_PORTS)
+	{
+		n = CONMON_AUD_DECODE_MAX_HAREMOTE_PORTS;
+	}
+	decoded->ports_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		conmon_aud_decoded_haremote_port_stats_t * out = decoded->ports + i;
+		const conmon_audinate_haremote_port_stats_t * port_stats = conmon_audinate_haremote_stats_status_port_stats_at_index(aud_msg, i);
+		out->port_number = conmon_audinate_haremote_port_stats_get_port_number(port_stats);
+		out->num_recv_packets = conmon_audinate_haremote_port_stats_num_recv_packets(port_stats);
+		out->num_sent_packets = conmon_audinate_haremote_port_stats_num_sent_packets(port_stats);
+		out->num_checksum_fails = conmon_audinate_haremote_port_stats_num_checksum_fails(port_stats);
+		out->num_timeouts = conmon_audinate_haremote_port_stats_num_timeouts(port_stats);
+	}
+	return (n < decoded->num_ports) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_srate_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_srate_status_t * decoded
+)
+{
+	uint16_t i, n;
+
+	AUD_UNUSED(body_size);
+
+	decoded->mode = conmon_audinate_srate_get_mode(aud_msg);
+	decoded->current = (uint32_t) conmon_audinate_srate_get_current(aud_msg);
+	decoded->reboot = (uint32_t) conmon_audinate_srate_get_new(aud_msg);
+	decoded->num_available = (uint16_t) conmon_audinate_srate_get_available_count(aud_msg);
+	n = decoded->num_available;
+	if (n > CONMON_AUD_DECODE_MAX_SRATES)
+	{
+		n = CONMON_AUD_DECODE_MAX_SRATES;
+	}
+	decoded->available_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		decoded->available[i] = (uint32_t) conmon_audinate_srate_get_available(aud_msg, i);
+	}
+	return (n < decoded->num_available) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_enc_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_srate_status_t * decoded
+)
+{
+	uint16_t i, n;
+
+	AUD_UNUSED(body_size);
+
+	decoded->mode = conmon_audinate_enc_get_mode(aud_msg);
+	decoded->current = (uint32_t) conmon_audinate_enc_get_current(aud_msg);
+	decoded->reboot = (uint32_t) conmon_audinate_enc_get_new(aud_msg);
+	decoded->num_available = (uint16_t) conmon_audinate_enc_get_available_count(aud_msg);
+	n = decoded->num_available;
+	if (n > CONMON_AUD_DECODE_MAX_SRATES)
+	{
+		n = CONMON_AUD_DECODE_MAX_SRATES;
+	}
+	decoded->available_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		decoded->available[i] = (uint32_t) conmon_audinate_enc_get_available(aud_msg, i);
+	}
+	return (n < decoded->num_available) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_srate_pullup_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_pullup_status_t * decoded
+)
+{
+	uint16_t i, n;
+
+	AUD_UNUSED(body_size);
+
+	decoded->mode = conmon_audinate_srate_pullup_get_mode(aud_msg);
+	decoded->current = conmon_audinate_srate_pullup_get_current(aud_msg);
+	decoded->reboot = conmon_audinate_srate_pullup_get_new(aud_msg);
+	decoded->flags_known = conmon_audinate_srate_pullup_get_flags_known(aud_msg);
+	decoded->flags = conmon_audinate_srate_pullup_get_flags(aud_msg);
+	decoded->subdomain = conmon_audinate_srate_pullup_has_subdomain(aud_msg)
+		? conmon_audinate_srate_pullup_get_subdomain(aud_msg) : NULL;
+	decoded->num_available = conmon_audinate_srate_pullup_get_available_count(aud_msg);
+	n = decoded->num_available;
+	if (n > CONMON_AUD_DECODE_MAX_SRATES)
+	{
+		n = CONMON_AUD_DECODE_MAX_SRATES;
+	}
+	decoded->available_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		// read the same way conmon_aud_print_msg_srate_pullup_status reads them
+		decoded->available[i] = (uint32_t) conmon_audinate_srate_get_available(aud_msg, i);
+	}
+	return (n < decoded->num_available) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_gpio_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_gpio_status_t * decoded
+)
+{
+	uint16_t i, n = conmon_audinate_gpio_status_get_state_num(aud_msg);
+
+	AUD_UNUSED(body_size);
+
+	decoded->field = conmon_audinate_gpio_status_get_fields(aud_msg);
+	decoded->num_states = n;
+	if (n > CONMON_AUD_DECODE_MAX_GPIO_STATES)
+	{
+		n = CONMON_AUD_DECODE_MAX_GPIO_STATES;
+	}
+	decoded->states_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		conmon_aud_decoded_gpio_state_t * out = decoded->states + i;
+		conmon_audinate_gpio_status_state_get_at_index(aud_msg, i,
+			&out->trigger_mask, &out->input_mask, &out->input_value, &out->output_mask, &out->output_value);
+	}
+	return (n < decoded->num_states) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_led_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_led_status_t * decoded
+)
+{
+	uint16_t i, n = conmon_audinate_led_status_num_leds(aud_msg);
+
+	AUD_UNUSED(body_size);
+
+	decoded->num_leds = n;
+	if (n > CONMON_AUD_DECODE_MAX_LEDS)
+	{
+		n = CONMON_AUD_DECODE_MAX_LEDS;
+	}
+	decoded->leds_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		decoded->leds[i].type = conmon_audinate_led_status_led_type_at_index(aud_msg, i);
+		decoded->leds[i].colour = conmon_audinate_led_status_led_colour_at_index(aud_msg, i);
+		decoded->leds[i].state = conmon_audinate_led_status_led_state_at_index(aud_msg, i);
+	}
+	return (n < decoded->num_leds) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_aud_decode_id_set
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_id_set_t * decoded
+)
+{
+	uint16_t i, n = (uint16_t) conmon_audinate_id_set_num_elements(aud_msg);
+
+	AUD_UNUSED(body_size);
+
+	decoded->num_elements = n;
+	if (n > CONMON_AUD_DECODE_MAX_ID_SET_ELEMENTS)
+	{
+		n = CONMON_AUD_DECODE_MAX_ID_SET_ELEMENTS;
+	}
+	decoded->elements_decoded = n;
+	for (i = 0; i < n; i++)
+	{
+		decoded->elements[i] = conmon_audinate_id_set_element_at_index(aud_msg, i);
+	}
+	return (n < decoded->num_elements) ? AUD_ERR_TRUNCATED : AUD_SUCCESS;
+}
+
+
+aud_bool_t
+conmon_aud_decode_msg_supported (uint16_t msg_type)
+{
+	switch (msg_type)
+	{
+	case CONMON_AUDINATE_MESSAGE_TYPE_INTERFACE_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_UNICAST_CLOCKING_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_MASTER_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_IFSTATS_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_MANF_VERSIONS_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_SERIAL_PORT_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_SRATE_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_ENC_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_SRATE_PULLUP_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_GPIO_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_LED_STATUS:
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_CHANNEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_CHANNEL_RX_ERROR:
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_LABEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_TX_CHANNEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_TX_LABEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_FLOW_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_TX_FLOW_CHANGE:
+		return AUD_TRUE;
+	default:
+		return AUD_FALSE;
+	}
+}
+
+
+aud_error_t
+conmon_aud_decode_msg
+(
+	const conmon_message_body_t * aud_msg,
+	uint16_t body_size,
+	conmon_aud_decoded_msg_t * decoded
+)
+{
+	decoded->type = conmon_audinate_message_get_type(aud_msg);
+	switch (decoded->type)
+	{
+	case CONMON_AUDINATE_MESSAGE_TYPE_INTERFACE_STATUS:
+		return conmon_aud_decode_interface_status(aud_msg, body_size, &decoded->u.interface_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_STATUS:
+		return conmon_aud_decode_clocking_status(aud_msg, body_size, &decoded->u.clocking_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_UNICAST_CLOCKING_STATUS:
+		return conmon_aud_decode_unicast_clocking_status(aud_msg, body_size, &decoded->u.unicast_clocking_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_MASTER_STATUS:
+		return conmon_aud_decode_master_status(aud_msg, body_size, &decoded->u.master_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_IFSTATS_STATUS:
+		return conmon_aud_decode_ifstats_status(aud_msg, body_size, &decoded->u.ifstats_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_STATUS:
+		return conmon_aud_decode_versions_status(aud_msg, body_size, &decoded->u.versions_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_MANF_VERSIONS_STATUS:
+		return conmon_aud_decode_manf_versions_status(aud_msg, body_size, &decoded->u.manf_versions_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_STATUS:
+		return conmon_aud_decode_upgrade_status(aud_msg, body_size, &decoded->u.upgrade_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_SERIAL_PORT_STATUS:
+		return conmon_aud_decode_serial_port_status(aud_msg, body_size, &decoded->u.serial_port_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_STATUS:
+		return conmon_aud_decode_haremote_stats_status(aud_msg, body_size, &decoded->u.haremote_stats_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_SRATE_STATUS:
+		return conmon_aud_decode_srate_status(aud_msg, body_size, &decoded->u.srate_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_ENC_STATUS:
+		return conmon_aud_decode_enc_status(aud_msg, body_size, &decoded->u.srate_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_SRATE_PULLUP_STATUS:
+		return conmon_aud_decode_srate_pullup_status(aud_msg, body_size, &decoded->u.pullup_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_GPIO_STATUS:
+		return conmon_aud_decode_gpio_status(aud_msg, body_size, &decoded->u.gpio_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_LED_STATUS:
+		return conmon_aud_decode_led_status(aud_msg, body_size, &decoded->u.led_status);
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_CHANNEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_CHANNEL_RX_ERROR:
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_LABEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_TX_CHANNEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_TX_LABEL_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_RX_FLOW_CHANGE:
+	case CONMON_AUDINATE_MESSAGE_TYPE_TX_FLOW_CHANGE:
+		return conmon_aud_decode_id_set(aud_msg, body_size, &decoded->u.id_set);
+	default:
+		return AUD_ERR_NOTFOUND;
+	}
+}
+
+
+//----------
@@ -0,0 +1,483 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Decode conmon status message bodies into plain structures
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_AUD_DECODE_MESSAGE_H
+#define _CONMON_AUD_DECODE_MESSAGE_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The decoders extract the same fields that conmon_aud_print_msg prints,
+	without doing any formatting. This lets tools that only care about the
+	values (collectors, benchmarks) skip the cost of printf.
+
+	String and identifier pointers in the decoded structures point into the
+	message body and are only valid for as long as the body is. Lists longer
+	than the fixed capacities below are cut short and the decoder returns
+	AUD_ERR_TRUNCATED; the num_* fields always hold the count reported by the
+	message, and the matching *_decoded field holds how many were kept.
+ */
+
+enum
+{
+	CONMON_AUD_DECODE_MAX_INTERFACES = 16,
+	CONMON_AUD_DECODE_MAX_CLOCK_PORTS = 16,
+	CONMON_AUD_DECODE_MAX_UNICAST_CLOCK_PORTS = 16,
+	CONMON_AUD_DECODE_MAX_IFSTATS_PORTS = 32,
+	CONMON_AUD_DECODE_MAX_SERIAL_PORTS = 8,
+	CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS = 16,
+	CONMON_AUD_DECODE_MAX_HAREMOTE_PORTS = 8,
+	CONMON_AUD_DECODE_MAX_SRATES = 16,
+	CONMON_AUD_DECODE_MAX_GPIO_STATES = 8,
+	CONMON_AUD_DECODE_MAX_LEDS = 16,
+	CONMON_AUD_DECODE_MAX_ID_SET_ELEMENTS = 256
+};
+
+typedef struct conmon_aud_decoded_interface
+{
+	uint16_t flags;
+	uint32_t link_speed;
+	uint8_t mac_address[6];
+	uint32_t ip_address;
+	uint32_t netmask;
+	uint32_t dns_server;
+	uint32_t gateway;
+	const char * domain_name;
+
+	aud_bool_t reboot_configured;
+	uint16_t reboot_flags;
+	uint32_t reboot_ip_address;
+	uint32_t reboot_netmask;
+	uint32_t reboot_dns_server;
+	uint32_t reboot_gateway;
+	const char * reboot_domain_name;
+} conmon_aud_decoded_interface_t;
+
+typedef struct conmon_aud_decoded_interface_status
+{
+	uint16_t mode;
+	conmon_audinate_interfaces_flags_t flags;
+	uint16_t num_interfaces;
+	uint16_t interfaces_decoded;
+	conmon_aud_decoded_interface_t interfaces [CONMON_AUD_DECODE_MAX_INTERFACES];
+} conmon_aud_decoded_interface_status_t;
+
+typedef struct conmon_aud_decoded_clocking_status
+{
+	conmon_audinate_clock_capabilities_t capabilities;
+	conmon_audinate_clock_source_t clock_source;
+	conmon_audinate_clock_state_t clock_state;
+	conmon_audinate_servo_state_t servo_state;
+	uint8_t clock_stratum;
+	aud_bool_t clock_preferred;
+	aud_bool_t unicast_delay_requests;
+	aud_bool_t multicast_ports_enabled;
+	aud_bool_t slave_only_enabled;
+	int32_t drift;
+	int32_t max_drift;
+	const conmon_audinate_clock_uuid_t * uuid;
+	const conmon_audinate_clock_uuid_t * master_uuid;
+	const conmon_audinate_clock_uuid_t * grandmaster_uuid;
+	const char * subdomain_name;
+	conmon_audinate_clock_subdomain_t subdomain_index;
+	uint16_t mute_flags;
+	uint16_t ext_wc_state;
+	uint16_t num_ports;
+	uint16_t ports_decoded;
+	uint32_t ports_valid;
+		// bit p is set if port_states[p] could be read from the message
+	conmon_audinate_port_state_t port_states [CONMON_AUD_DECODE_MAX_CLOCK_PORTS];
+} conmon_aud_decoded_clocking_status_t;
+
+typedef struct conmon_aud_decoded_unicast_clock_port
+{
+	conmon_audinate_port_state_t port_state;
+	uint16_t num_devices;
+	uint16_t max_devices;
+} conmon_aud_decoded_unicast_clock_port_t;
+
+typedef struct conmon_aud_decoded_unicast_clocking_status
+{
+	uint16_t num_ports;
+	uint16_t ports_decoded;
+	uint32_t ports_valid;
+		// bit p is set if ports[p] could be read from the message
+	conmon_aud_decoded_unicast_clock_port_t ports [CONMON_AUD_DECODE_MAX_UNICAST_CLOCK_PORTS];
+} conmon_aud_decoded_unicast_clocking_status_t;
+
+typedef struct conmon_aud_decoded_master_status
+{
+	const char * clock_subdomain_name;
+	uint16_t num_ports;
+	uint16_t ports_decoded;
+	conmon_audinate_port_state_t port_states [CONMON_AUD_DECODE_MAX_CLOCK_PORTS];
+} conmon_aud_decoded_master_status_t;
+
+typedef struct conmon_aud_decoded_ifstats_port
+{
+	uint16_t interface_index;
+	uint16_t port;
+	uint8_t port_type;
+	uint8_t port_type_index;
+	uint16_t flags;
+	uint32_t link_speed;
+	uint32_t tx_util;
+	uint32_t rx_util;
+	uint32_t tx_errors;
+	uint32_t rx_errors;
+} conmon_aud_decoded_ifstats_port_t;
+
+typedef struct conmon_aud_decoded_ifstats_status
+{
+	conmon_audinate_ifstats_capability_t capabilities;
+	uint16_t num_interfaces;
+	uint16_t num_ports;
+		// across all interfaces
+	uint16_t ports_decoded;
+	conmon_aud_decoded_ifstats_port_t ports [CONMON_AUD_DECODE_MAX_IFSTATS_PORTS];
+} conmon_aud_decoded_ifstats_status_t;
+
+typedef struct conmon_aud_decoded_versions_status
+{
+	dante_version_t software_version;
+	dante_version_build_t software_build;
+	dante_version_t firmware_version;
+	dante_version_build_t firmware_build;
+	uint32_t dante_api_version;
+	uint32_t uboot_version;
+	unsigned int upgrade_version;
+	uint32_t capability_flags;
+	uint32_t inferred_capability_flags;
+	uint32_t readonly_capability_flags;
+	uint32_t preferred_link_speed;
+	const conmon_audinate_model_id_t * model_id;
+	const char * model_name;
+	uint32_t device_status;
+	conmon_audinate_clock_protocol_flags_t clock_protocols;
+} conmon_aud_decoded_versions_status_t;
+
+typedef struct conmon_aud_decoded_manf_versions_status
+{
+	const conmon_vendor_id_t * manufacturer;
+	const char * manufacturer_name;
+	const conmon_audinate_model_id_t * model_id;
+	const char * model_name;
+	const conmon_device_id_t * serial_id;
+	uint32_t model_version;
+		// 8.8.16 packed, as dante_version_from_uint32_8_8_16 expects
+	const char * model_version_string;
+	dante_version_t software_version;
+	dante_version_build_t software_build;
+	dante_version_t firmware_version;
+	dante_version_build_t firmware_build;
+	uint32_t capabilities;
+} conmon_aud_decoded_manf_versions_status_t;
+
+typedef struct conmon_aud_decoded_upgrade_status
+{
+	conmon_audinate_upgrade_status_t status;
+	aud_bool_t has_source_file;
+	conmon_audinate_upgrade_source_file_t source_file;
+} conmon_aud_decoded_upgrade_status_t;
+
+typedef struct conmon_aud_decoded_serial_port
+{
+	conmon_audinate_serial_port_mode_t mode;
+	conmon_audinate_serial_port_baud_rate_t baud_rate;
+	conmon_audinate_serial_port_bits_t bits;
+	conmon_audinate_serial_port_parity_t parity;
+	conmon_audinate_serial_port_stop_bits_t stop_bits;
+	aud_bool_t is_configurable;
+} conmon_aud_decoded_serial_port_t;
+
+typedef struct conmon_aud_decoded_serial_port_status
+{
+	uint16_t num_ports;
+	uint16_t ports_decoded;
+	conmon_aud_decoded_serial_port_t ports [CONMON_AUD_DECODE_MAX_SERIAL_PORTS];
+
+	uint16_t num_baud_rates;
+	uint16_t num_bits;
+	uint16_t num_parities;
+	uint16_t num_stop_bits;
+	conmon_audinate_serial_port_baud_rate_t baud_rates [CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS];
+	conmon_audinate_serial_port_bits_t bits [CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS];
+	conmon_audinate_serial_port_parity_t parities [CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS];
+	conmon_audinate_serial_port_stop_bits_t stop_bits [CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS];
+		// each list holds at most CONMON_AUD_DECODE_MAX_SERIAL_OPTIONS entries
+} conmon_aud_decoded_serial_port_status_t;
+
+typedef struct conmon_aud_decoded_haremote_port_stats
+{
+	int port_number;
+	uint32_t num_recv_packets;
+	uint32_t num_sent_packets;
+	uint32_t num_checksum_fails;
+	uint32_t num_timeouts;
+} conmon_aud_decoded_haremote_port_stats_t;
+
+typedef struct conmon_aud_decoded_haremote_stats_status
+{
+	uint16_t num_ports;
+	uint16_t ports_decoded;
+	conmon_aud_decoded_haremote_port_stats_t ports [CONMON_AUD_DECODE_MAX_HAREMOTE_PORTS];
+} conmon_aud_decoded_haremote_stats_status_t;
+
+// Used for both sample rate and encoding status
+typedef struct conmon_aud_decoded_srate_status
+{
+	uint16_t mode;
+	uint32_t current;
+	uint32_t reboot;
+	uint16_t num_available;
+	uint16_t available_decoded;
+	uint32_t available [CONMON_AUD_DECODE_MAX_SRATES];
+} conmon_aud_decoded_srate_status_t;
+
+typedef struct conmon_aud_decoded_pullup_status
+{
+	uint16_t mode;
+	uint32_t current;
+		// a CONMON_AUDINATE_SRATE_PULLUP value
+	uint32_t reboot;
+	uint32_t flags_known;
+	uint32_t flags;
+	const char * subdomain;
+		// NULL if the device has no subdomain
+	uint16_t num_available;
+	uint16_t available_decoded;
+	uint32_t available [CONMON_AUD_DECODE_MAX_SRATES];
+} conmon_aud_decoded_pullup_status_t;
+
+typedef struct conmon_aud_decoded_gpio_state
+{
+	uint32_t trigger_mask;
+	uint32_t input_mask;
+	uint32_t input_value;
+	uint32_t output_mask;
+	uint32_t output_value;
+} conmon_aud_decoded_gpio_state_t;
+
+typedef struct conmon_aud_decoded_gpio_status
+{
+	uint16_t field;
+		// a CONMON_AUDINATE_GPIO_STATUS_FIELD value: why the state was sent
+	uint16_t num_states;
+	uint16_t states_decoded;
+	conmon_aud_decoded_gpio_state_t states [CONMON_AUD_DECODE_MAX_GPIO_STATES];
+} conmon_aud_decoded_gpio_status_t;
+
+typedef struct conmon_aud_decoded_led
+{
+	conmon_audinate_led_type_t type;
+	conmon_audinate_led_colour_t colour;
+	conmon_audinate_led_state_t state;
+} conmon_aud_decoded_led_t;
+
+typedef struct conmon_aud_decoded_led_status
+{
+	uint16_t num_leds;
+	uint16_t leds_decoded;
+	conmon_aud_decoded_led_t leds [CONMON_AUD_DECODE_MAX_LEDS];
+} conmon_aud_decoded_led_status_t;
+
+typedef struct conmon_aud_decoded_id_set
+{
+	uint16_t num_elements;
+	uint16_t elements_decoded;
+	conmon_audinate_id_set_elem_t elements [CONMON_AUD_DECODE_MAX_ID_SET_ELEMENTS];
+		// bit b of element i set means id (i * 8 + b + 1) is present
+} conmon_aud_decoded_id_set_t;
+
+typedef struct conmon_aud_decoded_msg
+{
+	conmon_audinate_message_type_t type;
+	union
+	{
+		conmon_aud_decoded_interface_status_t interface_status;
+		conmon_aud_decoded_clocking_status_t clocking_status;
+		conmon_aud_decoded_unicast_clocking_status_t unicast_clocking_status;
+		conmon_aud_decoded_master_status_t master_status;
+		conmon_aud_decoded_ifstats_status_t ifstats_status;
+		conmon_aud_decoded_versions_status_t versions_status;
+		conmon_aud_decoded_manf_versions_status_t manf_versions_status;
+		conmon_aud_decoded_upgrade_status_t upgrade_status;
+		conmon_aud_decoded_serial_port_status_t serial_port_status;
+		conmon_aud_decoded_haremote_stats_status_t haremote_stats_status;
+		conmon_aud_decoded_srate_status_t srate_status;
+		conmon_aud_decoded_pullup_status_t pullup_status;
+		conmon_aud_decoded_gpio_status_t gpio_status;
+		conmon_aud_decoded_led_status_t led_status;
+		conmon_aud_decoded_id_set_t id_set;
+	} u;
+} conmon_aud_decoded_msg_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_aud_decode_interface_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_interface_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_clocking_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_clocking_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_unicast_clocking_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_unicast_clocking_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_master_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_master_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_ifstats_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_ifstats_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_versions_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_versions_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_manf_versions_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_manf_versions_status_t * decoded
+);
+
+// @return AUD_ERR_INVALIDDATA if the upgrade status could not be read
+aud_error_t
+conmon_aud_decode_upgrade_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_upgrade_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_serial_port_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_serial_port_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_haremote_stats_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_haremote_stats_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_srate_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_srate_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_enc_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_srate_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_srate_pullup_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_pullup_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_gpio_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_gpio_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_led_status
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_led_status_t * decoded
+);
+
+aud_error_t
+conmon_aud_decode_id_set
+(
+	const conmon_message_body_t * aud_msg,
+	size_t body_size,
+	conmon_aud_decoded_id_set_t * decoded
+);
+
+// Returns true if conmon_aud_decode_msg has a decoder for this message type
+aud_bool_t
+conmon_aud_decode_msg_supported (uint16_t msg_type);
+
+/*
+	Decode any supported message, selecting the decoder from the message type.
+
+	@return AUD_ERR_NOTFOUND if there is no decoder for this message type
+ */
+aud_error_t
+conmon_aud_decode_msg
+(
+	const conmon_message_body_t * aud_msg,
+	uint16_t body_size,
+	conmon_aud_decoded_msg_t * decoded
+);
+
+
+//----------
+
+#endif // _CONMON_AUD_DECODE_MESSAGE_H
@@ -0,0 +1,672 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Benchmark the conmon message decoders and printers on built in
+ *            control and query messages, and on status messages from a capture
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+/*
+	For every message type found in the corpus this times:
+
+	  decode  the conmon_aud_decode_msg decoder for the type, with no output
+	  format  conmon_aud_print_msg, which decodes and formats, writing to
+	          the null device and (where supported) to a memory buffer
+
+	Results are written as CSV, one line per type/path/sink, so that runs can
+	be compared by a script.
+
+	The corpus is built in, so a run needs no network and its results only
+	change when the code does. It holds every control and query message
+	the API can build: each command the control builder knows, with a few
+	values apiece, a query of every type the printer handles, and name/id
+	controls of 1 to BENCH_MAX_NAME_IDS names.
+
+	Status messages are not covered by the built in corpus. Only devices
+	send them, the API has no way to build them and their layouts are
+	private to the API, so there is nothing to build a faithful fixture
+	from. Interface status with many interfaces, clocking, ifstats,
+	versions, upgrade, serial port and HA remote stats are only timed when
+	a capture file holding them is given: one written by
+	'conmon_audinate_listener -w' from a network with a representative mix
+	of devices, replayed unchanged for every run. The run ends by listing
+	those status types that had no messages and so were not timed.
+ */
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_capture.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_control_builder.h"
+
+#ifdef WIN32
+	#include <io.h>
+#define NULL_DEVICE "NUL"
+#define dup _dup
+#define fdopen _fdopen
+#define fileno _fileno
+#else
+	#include <libgen.h>
+	#include <errno.h>
+	#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Printing into memory relies on being able to point stdout at another stream
+#if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__)
+#define BENCH_HAVE_MEMORY_SINK 1
+#endif
+
+//----------
+// Types and Constants
+
+static char * g_progname;
+
+enum
+{
+	BENCH_MAX_TYPES = 0x10000,
+	BENCH_DEFAULT_ITERATIONS = 10000,
+	BENCH_MEMORY_SINK_SIZE = 64 * 1024,
+	BENCH_MAX_COMMAND_ARGS = 8,
+	BENCH_MAX_NAME_IDS = 8
+		// in the largest name/id control of the built in corpus
+};
+
+// Control builder commands for the built in corpus, arguments separated by spaces
+static const char * const k_builder_commands [] =
+{
+	"switch_vlan", "switch_vlan id=2",
+	"clocking", "clocking src=bnc pref=true", "clocking subdomain=_DFLT enabled=true slave_only=false udelay=true",
+	"uclocking enabled=true", "uclocking reload=true",
+	"ifstats", "ifstats clear=true",
+	"igmp", "igmp vers=3",
+	"srate", "srate rate=48000", "srate rate=96000",
+	"pullup", "pullup val=0 subdomain=_DFLT",
+	"enc", "enc enc=24",
+	"sysreset mode=soft",
+	"edk", "edk rev=green dig=aes src=sync",
+	"access", "access mode=enable",
+	"errthres thres=10 win=60 reset=300",
+	"metering", "metering rate=10",
+	"serial", "serial index=0 speed=115200 bits=8 parity=none stop=1",
+	"haremote", "haremote mode=all",
+	"clear_config", "clear_config keep_ip",
+	"gpio", "gpio output mask=0xff val=0x0f",
+	"ptp_logging", "ptp_logging enabled=true"
+};
+
+// Query messages for the built in corpus, beyond those the builder makes
+static const conmon_audinate_message_type_t k_query_types [] =
+{
+	CONMON_AUDINATE_MESSAGE_TYPE_UNICAST_CLOCKING_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_MASTER_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_IDENTIFY_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_MANF_VERSIONS_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_AUDIO_INTERFACE_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_RX_CHANNEL_RX_ERROR_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_ROUTING_READY_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_LED_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_QUERY,
+	CONMON_AUDINATE_MESSAGE_TYPE_DANTE_READY_QUERY
+};
+
+// Status messages whose cost matters most, reported if the corpus has none
+static const conmon_audinate_message_type_t k_status_types [] =
+{
+	CONMON_AUDINATE_MESSAGE_TYPE_INTERFACE_STATUS,
+	CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_STATUS,
+	CONMON_AUDINATE_MESSAGE_TYPE_IFSTATS_STATUS,
+	CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_STATUS,
+	CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_STATUS,
+	CONMON_AUDINATE_MESSAGE_TYPE_SERIAL_PORT_STATUS,
+	CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_STATUS
+};
+
+typedef struct bench_info
+{
+	// options
+	unsigned long iterations;
+	const char * capture;
+	const char * results_file;
+
+	// corpus, grouped by message type
+	conmon_capture_record_t * records;
+	unsigned long n_records;
+	unsigned long capacity;
+	unsigned long * by_type;
+		// record indices sorted by message type
+	unsigned long type_start [BENCH_MAX_TYPES + 1];
+
+	FILE * results;
+	FILE * null_sink;
+#ifdef BENCH_HAVE_MEMORY_SINK
+	FILE * memory_sink;
+	char memory_buf [BENCH_MEMORY_SINK_SIZE];
+#endif
+
+	// stops the compiler discarding decode results
+	uint32_t checksum;
+} bench_info_t;
+
+static bench_info_t g_info;
+	// too big for the stack
+
+typedef struct bench_result
+{
+	unsigned long messages;
+	uint64_t ns;
+	uint64_t bytes;
+} bench_result_t;
+
+
+//----------
+// Local functions
+
+AUD_INLINE const char *
+pname (void)
+{
+#ifdef WIN32
+	return g_progname;
+#else
+	return basename (g_progname);
+#endif
+}
+
+
+static int
+usage (const char * msg)
+{
+	const char * name = pname ();
+
+	if (msg)
+	{
+		fprintf (stderr, "%s: %s\n", name, msg);
+	}
+
+	fprintf (stderr,
+		"Usage: %s [-n iterations] [-o results_file] [capture_file]\n"
+		"  -n  messages to process per type, path and sink (default %u)\n"
+		"  -o  write results here rather than to standard output\n"
+		"  capture_file  adds the messages in a capture to the built in corpus;\n"
+		"                status messages are only timed if one is given\n"
+		, name, BENCH_DEFAULT_ITERATIONS
+	);
+
+	return 2;
+}
+
+
+static int
+handle_args (bench_info_t * info, int argc, char ** argv)
+{
+	int curr_arg_index = 1;
+
+	g_progname = argv [0];
+	info->iterations = BENCH_DEFAULT_ITERATIONS;
+
+	while (curr_arg_index < argc && argv [curr_arg_index][0] == '-')
+	{
+		char * arg = argv [curr_arg_index++];
+
+		if (curr_arg_index >= argc)
+		{
+			return usage ("Missing argument");
+		}
+
+		switch (arg [1])
+		{
+		case 'n':
+			info->iterations = strtoul (argv [curr_arg_index++], NULL, 0);
+			if (! info->iterations)
+			{
+				return usage ("Invalid number of iterations");
+			}
+			break;
+
+		case 'o':
+			info->results_file = argv [curr_arg_index++];
+			break;
+
+		default:
+			fprintf (stderr, "%s: Unknown option '%s'\n"
+				, pname (), arg
+			);
+			return usage (NULL);
+		}
+	}
+
+	if (curr_arg_index < argc - 1)
+	{
+		return usage ("Expected at most one capture file");
+	}
+	info->capture = argv [curr_arg_index];
+		// NULL if there is none
+	return 0;
+}
+
+
+// Make room for one more record at the end of the corpus
+static conmon_capture_record_t *
+next_record (bench_info_t * info)
+{
+	if (info->n_records == info->capacity)
+	{
+		unsigned long capacity = info->capacity ? info->capacity * 2 : 1024;
+		conmon_capture_record_t * records = realloc (info->records, capacity * sizeof (conmon_capture_record_t));
+		if (! records)
+		{
+			return NULL;
+		}
+		info->records = records;
+		info->capacity = capacity;
+	}
+	return info->records + info->n_records;
+}
+
+
+static aud_error_t
+add_body (bench_info_t * info, const conmon_message_body_t * body, uint16_t body_size)
+{
+	conmon_capture_record_t * record = next_record (info);
+
+	if (! record)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	memset (record, 0, sizeof (* record));
+	memcpy (& record->body, body, body_size);
+	record->body_size = body_size;
+	info->n_records++;
+	return AUD_SUCCESS;
+}
+
+
+static aud_error_t
+build_corpus (bench_info_t * info)
+{
+	conmon_control_builder_t * builder;
+	conmon_message_body_t body;
+	uint16_t body_size;
+	unsigned int i, n;
+	aud_error_t result;
+
+	result = conmon_control_builder_new (conmon_control_audinate_specs, conmon_control_audinate_num_specs, & builder);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	for (i = 0; result == AUD_SUCCESS && i < sizeof (k_builder_commands) / sizeof (k_builder_commands [0]); i++)
+	{
+		char command [128];
+		char * args [BENCH_MAX_COMMAND_ARGS];
+		int argc = 0;
+		const conmon_control_spec_t * spec;
+		const char * bad_arg;
+
+		SNPRINTF (command, sizeof (command), "%s", k_builder_commands [i]);
+		for (args [0] = strtok (command, " "); args [argc] && argc < BENCH_MAX_COMMAND_ARGS - 1; )
+		{
+			args [++argc] = strtok (NULL, " ");
+		}
+		spec = conmon_control_builder_find (builder, args [0]);
+		result = spec
+			? conmon_control_builder_build (builder, spec, argc - 1, args + 1, & body, & body_size, & bad_arg)
+			: AUD_ERR_INVALIDPARAMETER;
+		if (result == AUD_SUCCESS)
+		{
+			result = add_body (info, & body, body_size);
+		}
+		else
+		{
+			fprintf (stderr, "%s: failed to build '%s'\n", pname (), k_builder_commands [i]);
+		}
+	}
+	conmon_control_builder_delete (builder);
+
+	for (i = 0; result == AUD_SUCCESS && i < sizeof (k_query_types) / sizeof (k_query_types [0]); i++)
+	{
+		conmon_audinate_init_query_message (& body, k_query_types [i], 0);
+		result = add_body (info, & body, conmon_audinate_query_message_get_size (& body));
+	}
+
+	for (n = 1; result == AUD_SUCCESS && n <= BENCH_MAX_NAME_IDS; n *= 2)
+	{
+		conmon_audinate_init_name_id_control (& body, 0, (uint16_t) n);
+		for (i = 0; i < n; i++)
+		{
+			conmon_name_t name;
+			SNPRINTF (name, sizeof (name), "bench-%u", i);
+			conmon_audinate_name_id_set_device_name_id_at_index (& body, (uint16_t) i, name, NULL, NULL, NULL);
+		}
+		result = add_body (info, & body, conmon_audinate_name_id_get_size (& body));
+	}
+	return result;
+}
+
+
+static aud_error_t
+load_capture (bench_info_t * info)
+{
+	aud_error_t result;
+	aud_errbuf_t ebuf;
+	unsigned long n_built = info->n_records;
+	FILE * fp = fopen (info->capture, "rb");
+
+	if (! fp)
+	{
+		fprintf (stderr, "%s: failed to open '%s': %s\n"
+			, pname (), info->capture, strerror (errno)
+		);
+		return AUD_ERR_NOTFOUND;
+	}
+
+	result = conmon_capture_read_file_head (fp);
+	if (result != AUD_SUCCESS)
+	{
+		fprintf (stderr, "%s: '%s' is not a compatible capture file\n"
+			, pname (), info->capture
+		);
+		goto l__done;
+	}
+
+	for (;;)
+	{
+		conmon_capture_record_t * record = next_record (info);
+		if (! record)
+		{
+			result = AUD_ERR_NOMEMORY;
+			goto l__done;
+		}
+
+		result = conmon_capture_read_record (fp, record);
+		if (result != AUD_SUCCESS)
+		{
+			break;
+		}
+		info->n_records++;
+	}
+
+	if (result == AUD_ERR_DONE)
+	{
+		result = AUD_SUCCESS;
+	}
+	else
+	{
+		fprintf (stderr, "%s: stopped reading '%s' after %lu records: %s\n"
+			, pname (), info->capture, info->n_records - n_built
+			, aud_error_message (result, ebuf)
+		);
+		result = (info->n_records > n_built) ? AUD_SUCCESS : result;
+	}
+
+l__done:
+	fclose (fp);
+	return result;
+}
+
+
+// Counting sort of the corpus by message type
+static aud_error_t
+group_by_type (bench_info_t * info)
+{
+	unsigned long i, t;
+	unsigned long * next;
+
+	info->by_type = malloc (info->n_records * sizeof (unsigned long));
+	next = malloc ((BENCH_MAX_TYPES + 1) * sizeof (unsigned long));
+	if (! (info->by_type && next))
+	{
+		free (next);
+		return AUD_ERR_NOMEMORY;
+	}
+
+	for (i = 0; i < info->n_records; i++)
+	{
+		info->type_start [conmon_audinate_message_get_type (& info->records [i].body) + 1]++;
+	}
+	for (t = 0; t < BENCH_MAX_TYPES; t++)
+	{
+		info->type_start [t + 1] += info->type_start [t];
+	}
+	memcpy (next, info->type_start, (BENCH_MAX_TYPES + 1) * sizeof (unsigned long));
+	for (i = 0; i < info->n_records; i++)
+	{
+		info->by_type [next [conmon_audinate_message_get_type (& info->records [i].body)]++] = i;
+	}
+	free (next);
+	return AUD_SUCCESS;
+}
+
+
+AUD_INLINE const conmon_capture_record_t *
+record_for_iteration (const bench_info_t * info, unsigned int type, unsigned long i)
+{
+	unsigned long start = info->type_start [type];
+	unsigned long n = info->type_start [type + 1] - start;
+	return info->records + info->by_type [start + (i % n)];
+}
+
+
+static void
+bench_decode (bench_info_t * info, unsigned int type, bench_result_t * result)
+{
+	conmon_aud_decoded_msg_t decoded;
+	unsigned long i, n = info->type_start [type + 1] - info->type_start [type];
+	uint64_t start;
+
+	// warm up caches and branch predictors with one pass over the corpus
+	for (i = 0; i < n; i++)
+	{
+		const conmon_capture_record_t * record = record_for_iteration (info, type, i);
+		conmon_aud_decode_msg (& record->body, record->body_size, & decoded);
+	}
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < info->iterations; i++)
+	{
+		const conmon_capture_record_t * record = record_for_iteration (info, type, i);
+		aud_error_t err = conmon_aud_decode_msg (& record->body, record->body_size, & decoded);
+		info->checksum += (uint32_t) err + decoded.type;
+	}
+	result->ns = conmon_example_clock_ns () - start;
+	result->messages = info->iterations;
+	result->bytes = 0;
+}
+
+
+/*
+	Time conmon_aud_print_msg with stdout pointing at the given sink. If the
+	sink is a memory buffer it is rewound before each message so that every
+	message is formatted into the same (warm) buffer.
+ */
+static void
+bench_format (bench_info_t * info, unsigned int type, FILE * sink, aud_bool_t rewind_sink, bench_result_t * result)
+{
+	unsigned long i, n = info->type_start [type + 1] - info->type_start [type];
+	uint64_t start, bytes = 0;
+
+	for (i = 0; i < n; i++)
+	{
+		const conmon_capture_record_t * record = record_for_iteration (info, type, i);
+		if (rewind_sink)
+		{
+			rewind (sink);
+		}
+		conmon_aud_print_msg (& record->body, record->body_size);
+	}
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < info->iterations; i++)
+	{
+		const conmon_capture_record_t * record = record_for_iteration (info, type, i);
+		if (rewind_sink)
+		{
+			rewind (sink);
+		}
+		conmon_aud_print_msg (& record->body, record->body_size);
+		if (rewind_sink)
+		{
+			bytes += (uint64_t) ftell (sink);
+		}
+	}
+	fflush (sink);
+	result->ns = conmon_example_clock_ns () - start;
+	result->messages = info->iterations;
+	result->bytes = bytes;
+}
+
+
+static void
+print_result
+(
+	const bench_info_t * info,
+	unsigned int type,
+	const char * path,
+	const char * sink,
+	const bench_result_t * result
+)
+{
+	const char * name = conmon_aud_print_msg_type_name ((uint16_t) type);
+	fprintf (info->results, "0x%04x,%s,%s,%s,%lu,%llu,%.1f,%.1f\n"
+		, type, name ? name : "UNKNOWN", path, sink
+		, result->messages
+		, (unsigned long long) result->ns
+		, (double) result->ns / result->messages
+		, (double) result->bytes / result->messages
+	);
+	fflush (info->results);
+}
+
+
+static aud_error_t
+open_sinks (bench_info_t * info)
+{
+	if (info->results_file)
+	{
+		info->results = fopen (info->results_file, "w");
+	}
+	else
+	{
+		// keep the real stdout for results before it is redirected
+		info->results = fdopen (dup (fileno (stdout)), "w");
+	}
+	if (! info->results)
+	{
+		fprintf (stderr, "%s: failed to open results: %s\n", pname (), strerror (errno));
+		return AUD_ERR_NOTFOUND;
+	}
+
+	info->null_sink = freopen (NULL_DEVICE, "w", stdout);
+	if (! info->null_sink)
+	{
+		fprintf (stderr, "%s: failed to redirect output: %s\n", pname (), strerror (errno));
+		return AUD_ERR_NOTFOUND;
+	}
+
+#ifdef BENCH_HAVE_MEMORY_SINK
+	info->memory_sink = fmemopen (info->memory_buf, sizeof (info->memory_buf), "w");
+	if (! info->memory_sink)
+	{
+		fprintf (stderr, "%s: failed to create memory sink: %s\n", pname (), strerror (errno));
+		return AUD_ERR_NOMEMORY;
+	}
+#else
+	fprintf (stderr, "%s: memory sink not supported on this platform\n", pname ());
+#endif
+	return AUD_SUCCESS;
+}
+
+
+//----------
+// Main
+
+int
+main (int argc, char ** argv)
+{
+	bench_info_t * info = & g_info;
+	unsigned int t;
+	int result;
+
+	result = handle_args (info, argc, argv);
+	if (result != 0)
+	{
+		return result;
+	}
+
+	if (build_corpus (info) != AUD_SUCCESS)
+	{
+		fprintf (stderr, "%s: failed to build the corpus\n", pname ());
+		return 1;
+	}
+	if (info->capture && load_capture (info) != AUD_SUCCESS)
+	{
+		return 1;
+	}
+	if (group_by_type (info) != AUD_SUCCESS || open_sinks (info) != AUD_SUCCESS)
+	{
+		return 1;
+	}
+
+	fprintf (info->results, "type,name,path,sink,messages,total_ns,ns_per_msg,bytes_per_msg\n");
+	for (t = 0; t < BENCH_MAX_TYPES; t++)
+	{
+		bench_result_t r;
+
+		if (info->type_start [t] == info->type_start [t + 1])
+		{
+			continue;
+		}
+
+		if (conmon_aud_decode_msg_supported ((uint16_t) t))
+		{
+			bench_decode (info, t, & r);
+			print_result (info, t, "decode", "none", & r);
+		}
+
+		bench_format (info, t, stdout, AUD_FALSE, & r);
+		print_result (info, t, "format", "null", & r);
+
+#ifdef BENCH_HAVE_MEMORY_SINK
+		{
+			FILE * saved = stdout;
+			stdout = info->memory_sink;
+			bench_format (info, t, info->memory_sink, AUD_TRUE, & r);
+			stdout = saved;
+			print_result (info, t, "format", "memory", & r);
+		}
+#endif
+	}
+
+	fprintf (stderr, "%s: %lu messages of corpus, checksum 0x%08x\n"
+		, pname (), info->n_records, info->checksum
+	);
+	for (t = 0; t < sizeof (k_status_types) / sizeof (k_status_types [0]); t++)
+	{
+		const unsigned int type = k_status_types [t];
+
+		if (info->type_start [type] == info->type_start [type + 1])
+		{
+			fprintf (stderr, "%s: not timed, no %s messages%s\n"
+				, pname (), conmon_aud_print_msg_type_name ((uint16_t) type)
+				, info->capture ? " in the capture" : " without a capture"
+			);
+		}
+	}
+
+#ifdef BENCH_HAVE_MEMORY_SINK
+	fclose (info->memory_sink);
+#endif
+	fclose (info->results);
+	free (info->by_type);
+	free (info->records);
+	return 0;
+}
+
+
+//----------
@@ -421,6 +421,14 @@ typedef union in_addr_convert
 } in_addr_convert_t;
 
 
+const char *
+conmon_aud_print_msg_type_name (uint16_t msg_type)
+{
+	const conmon_aud_print_msg_t * info = info_for_type (msg_type);
+	return info ? info->typename : NULL;
+}
+
+
 aud_bool_t
 conmon_aud_print_msg 
 (
@@ -34,6 +34,13 @@ conmon_aud_print_msg_fn
 aud_bool_t
 conmon_aud_print_msg(const conmon_message_body_t * aud_msg, uint16_t body_size);
 
+// Returns the short name of an audinate message type, or NULL if unknown
+const char *
+conmon_aud_print_msg_type_name (uint16_t msg_type);
+
+// Names of the versions status capability flags, indexed by bit number
+extern const char * CAPABILITY_NAMES[CONMON_AUDINATE_NUM_CAPABILITIES];
+
 conmon_aud_print_msg_fn
 	conmon_aud_print_msg_idset,
 	conmon_aud_print_msg_interface_status,
@@ -12,33 +12,29 @@
 
 #include "conmon_audinate_controller.h"
 #include "dapi_io.h"
+#include "conmon_control_cache.h"
+#include "conmon_dispatch.h"
 
 
 #define CONGESTION_DELAY ONE_SECOND_US
+#define CONTROL_CACHE_SIZE 16
+
+#define MAX_TARGETS 1024
+#define MAX_TARGET_PATTERNS 16
+#define DISPATCH_WINDOW 64
+	// control messages in flight at once
+#define DISPATCH_TIMEOUT_MS 6000
+	// a second longer than the server keeps trying, so the server's own timeout is normally seen
+#define DISCOVERY_TIME_MS 3000
+#define MAX_BATCH_ARGS 32
+	// on a line of a batch file, including the program name
 
 static conmon_audinate_control_handler_fn 
 	conmon_audinate_interface_control_handler,
-	conmon_audinate_switch_vlan_control_handler,
-	conmon_audinate_clocking_control_handler,
-	conmon_audinate_unicast_clocking_control_handler,
 	conmon_audinate_name_id_control_handler,
-	conmon_audinate_igmp_vers_control_handler,
-	conmon_audinate_srate_control_handler,
-	conmon_audinate_srate_pullup_control_handler,
-	conmon_audinate_enc_control_handler,
-	conmon_audinate_access_control_handler,
-	conmon_audinate_edk_board_control_handler,
-	conmon_audinate_ifstats_control_handler,
-	conmon_audinate_rx_error_threshold_control_handler,
-	conmon_audinate_sys_reset_handler,
-	conmon_audinate_metering_control_handler,
-	conmon_audinate_serial_port_control_handler,
-	conmon_audinate_haremote_control_handler,
 	conmon_audinate_upgrade_control_handler,
 	conmon_audinate_upgrade_v3_control_handler,
-	conmon_audinate_clear_config_control_handler,
-	conmon_audinate_gpio_control_handler,
-	conmon_audinate_ptp_logging_control_handler;
+	conmon_audinate_builder_control_handler;
 
 
 typedef struct conmon_audinate_control_handler_map
@@ -46,45 +42,47 @@ typedef struct conmon_audinate_control_handler_map
 	conmon_audinate_message_type_t type;
 	char cmd[16];
 	conmon_audinate_control_handler_fn * handler;
+	conmon_channel_type_t channel;
+		// CONTROL messages go to each device; LOCAL and BROADCAST ones are sent once
 } conmon_audinate_control_handler_map;
 
 static const conmon_audinate_control_handler_map
 audinate_control_map[] =
 {
-	{CONMON_AUDINATE_MESSAGE_TYPE_INTERFACE_CONTROL, "interface", conmon_audinate_interface_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_SWITCH_VLAN_CONTROL, "switch_vlan", conmon_audinate_switch_vlan_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_CONTROL, "clocking",  conmon_audinate_clocking_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_UNICAST_CLOCKING_CONTROL, "uclocking",  conmon_audinate_unicast_clocking_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_MASTER_QUERY, "master", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_NAME_ID_CONTROL, "name_id", conmon_audinate_name_id_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_IFSTATS_QUERY, "ifstats", conmon_audinate_ifstats_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_IGMP_VERS_CONTROL, "igmp", conmon_audinate_igmp_vers_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_QUERY, "versions", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_SRATE_CONTROL, "srate", conmon_audinate_srate_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_SRATE_PULLUP_CONTROL, "pullup", conmon_audinate_srate_pullup_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_ENC_CONTROL, "enc", conmon_audinate_enc_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_AUDIO_INTERFACE_QUERY, "audio_interface", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_SYS_RESET, "sysreset", conmon_audinate_sys_reset_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_EDK_BOARD_CONTROL, "edk", conmon_audinate_edk_board_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_ACCESS_CONTROL, "access", conmon_audinate_access_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_MANF_VERSIONS_QUERY, "manf_versions", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_IDENTIFY_QUERY, "identify",  NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_RX_ERROR_THRES_CONTROL, "errthres", conmon_audinate_rx_error_threshold_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_RX_CHANNEL_RX_ERROR_QUERY, "rxerrq", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_METERING_CONTROL, "metering", conmon_audinate_metering_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_SERIAL_PORT_CONTROL, "serial", conmon_audinate_serial_port_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_CONTROL, "upgrade", conmon_audinate_upgrade_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_V3_CONTROL, "upgrade3", conmon_audinate_upgrade_v3_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_CLEAR_CONFIG_CONTROL, "clear_config", conmon_audinate_clear_config_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_ROUTING_READY_QUERY, "routing_ready", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_CONTROL, "haremote", conmon_audinate_haremote_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_QUERY, "haremote_stats", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_DANTE_READY_QUERY, "dante_ready", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_PTP_LOGGING_CONTROL, "ptp_logging", conmon_audinate_ptp_logging_control_handler},
-	{CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_UNMUTE_CONTROL, "clock_unmute", NULL},
-	{CONMON_AUDINATE_MESSAGE_TYPE_GPIO_QUERY, "gpio", conmon_audinate_gpio_control_handler},
-
-	{0, "", 0}
+	{CONMON_AUDINATE_MESSAGE_TYPE_INTERFACE_CONTROL, "interface", conmon_audinate_interface_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_SWITCH_VLAN_CONTROL, "switch_vlan", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_CONTROL, "clocking", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_UNICAST_CLOCKING_CONTROL, "uclocking", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_MASTER_QUERY, "master", NULL, CONMON_CHANNEL_TYPE_BROADCAST},
+	{CONMON_AUDINATE_MESSAGE_TYPE_NAME_ID_CONTROL, "name_id", conmon_audinate_name_id_control_handler, CONMON_CHANNEL_TYPE_BROADCAST},
+	{CONMON_AUDINATE_MESSAGE_TYPE_IFSTATS_QUERY, "ifstats", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_IGMP_VERS_CONTROL, "igmp", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_QUERY, "versions", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_SRATE_CONTROL, "srate", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_SRATE_PULLUP_CONTROL, "pullup", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_ENC_CONTROL, "enc", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_AUDIO_INTERFACE_QUERY, "audio_interface", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_SYS_RESET, "sysreset", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_EDK_BOARD_CONTROL, "edk", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_ACCESS_CONTROL, "access", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_LOCAL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_MANF_VERSIONS_QUERY, "manf_versions", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_IDENTIFY_QUERY, "identify", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_RX_ERROR_THRES_CONTROL, "errthres", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_RX_CHANNEL_RX_ERROR_QUERY, "rxerrq", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_METERING_CONTROL, "metering", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_SERIAL_PORT_CONTROL, "serial", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_CONTROL, "upgrade", conmon_audinate_upgrade_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_V3_CONTROL, "upgrade3", conmon_audinate_upgrade_v3_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_CLEAR_CONFIG_CONTROL, "clear_config", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_ROUTING_READY_QUERY, "routing_ready", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_CONTROL, "haremote", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_QUERY, "haremote_stats", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_DANTE_READY_QUERY, "dante_ready", NULL, CONMON_CHANNEL_TYPE_LOCAL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_PTP_LOGGING_CONTROL, "ptp_logging", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_UNMUTE_CONTROL, "clock_unmute", NULL, CONMON_CHANNEL_TYPE_CONTROL},
+	{CONMON_AUDINATE_MESSAGE_TYPE_GPIO_QUERY, "gpio", conmon_audinate_builder_control_handler, CONMON_CHANNEL_TYPE_CONTROL},
+
+	{0, "", NULL, CONMON_CHANNEL_TYPE_NONE}
 		// Terminator
 };
 
@@ -95,10 +93,36 @@ const aud_utime_t comms_timeout = {2, 0};
 
 const aud_utime_t control_timeout = {1, 500000};
 
+// the server will give up trying to reach a device after this long
+static const aud_utime_t device_timeout = {5, 0};
+
+static const aud_utime_t poll_delay = {0, 10000};
+
 aud_bool_t communicating = AUD_FALSE;
 
 aud_error_t last_result = AUD_SUCCESS;
 
+// made on first use by conmon_audinate_builder_control_handler, or for a batch file
+static conmon_control_builder_t * control_builder = NULL;
+
+// only for a batch file, where the same commands are sent again and again
+static conmon_control_cache_t * control_cache = NULL;
+
+// set if the command came from the cache, whose body is sent in place of the one built
+static const conmon_control_template_t * control_template = NULL;
+
+// the devices a CONTROL message goes to, named or matching one of the patterns
+static conmon_dispatch_t * control_dispatch = NULL;
+static char * target_patterns[MAX_TARGET_PATTERNS];
+static unsigned int num_target_patterns = 0;
+static aud_bool_t discovery_full = AUD_FALSE;
+
+AUD_INLINE uint64_t
+now_ms(void)
+{
+	return conmon_example_clock_ns() / 1000000;
+}
+
 static conmon_client_response_fn handle_response;
 
 static void
@@ -108,11 +132,21 @@ handle_response
 	conmon_client_request_id_t request_id,
 	aud_error_t result
 ) {
-	// TODO: should check request id codes to ensure correct matching
+	// while dispatching, control responses are matched to their device by request id;
+	// anything else is what wait_for_response is waiting for
 	aud_errbuf_t errbuf;
 
+	unsigned int index;
+
 	(void) client;
 
+	if (control_dispatch && !communicating && conmon_dispatch_response(control_dispatch, request_id, result, now_ms(), &index))
+	{
+		const conmon_dispatch_target_t * target = conmon_dispatch_target_at_index(control_dispatch, index);
+		printf ("Got response from '%s' after %llu ms: %s\n", target->device_name,
+			(unsigned long long) (target->done_ms - target->sent_ms), aud_error_message(result, errbuf));
+		return;
+	}
 	printf ("Got response for request 0x%p: %s\n",
 		request_id, aud_error_message(result, errbuf));
 	communicating = AUD_FALSE;
@@ -172,7 +206,7 @@ handle_networks_changed
 static void usage(char * cmd)
 {
 	int i;
-	fprintf(stderr,"%s controlled_device ", cmd);
+	fprintf(stderr,"%s controlled_device[,controlled_device...] ", cmd);
 
 	fprintf(stderr,"%s",audinate_control_map[0].cmd);
 	for (i = 1; audinate_control_map [i].cmd [0]; i++)
@@ -180,6 +214,10 @@ static void usage(char * cmd)
 		fprintf(stderr,"|%s",audinate_control_map[i].cmd);
 	}
 	fputc ('\n', stderr);
+	fprintf(stderr,"  a controlled device may be a pattern such as 'stage-*' or 'amp-[0-9]?', matched against\n");
+	fprintf(stderr,"  the devices heard from in %u seconds; control messages go to every device at once\n", DISCOVERY_TIME_MS / 1000);
+	fprintf(stderr,"%s -f command_file|-\n", cmd);
+	fprintf(stderr,"  runs one 'devices command [args...]' per line, building each distinct control message once\n");
 	exit(1);
 }
 
@@ -188,11 +226,14 @@ static aud_error_t parse_args
 	int argc, 
 	char **argv, 
 	conmon_message_body_t *body,
-	uint16_t *body_size
+	uint16_t *body_size,
+	const conmon_audinate_control_handler_map ** entry
 )
 {
 	
 	int i;
+
+	control_template = NULL;
 	for (i = 0; audinate_control_map [i].cmd [0]; i++)
 	{
 		if(strcmp(argv[2], audinate_control_map[i].cmd) == 0)
@@ -202,6 +243,7 @@ static aud_error_t parse_args
 			//conmon_audinate_message_head_initialise((conmon_audinate_message_head_t*)body,
 			//	audinate_control_map[i].type, ONE_SECOND_US);
 
+			*entry = &audinate_control_map[i];
 			if(handler) 
 			{
 				return (* handler)(argc, argv, body, body_size);					
@@ -217,204 +259,642 @@ static aud_error_t parse_args
 	return AUD_ERR_INVALIDPARAMETER;
 }
 
-int main(int argc, char **argv)
+// "localhost" and "broadcast" both mean the local device, which has no name on the control channel
+static const char *
+control_name(const char * device_name)
 {
+	if (!strcmp(device_name, "localhost") || !strcmp(device_name, "broadcast"))
+	{
+		return "";
+	}
+	return device_name;
+}
+
+static conmon_client_handle_monitoring_message_fn handle_discovery_message;
+
+// Any status message makes its device a target if its name matches one of the patterns
+static void
+handle_discovery_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+) {
+	conmon_instance_id_t instance_id;
+	const char * device_name;
+	unsigned int i;
+
+	(void) channel_type;
+	(void) channel_direction;
+	(void) body;
+
+	conmon_message_head_get_instance_id(head, &instance_id);
+	device_name = conmon_client_device_name_for_instance_id(client, &instance_id);
+	if (!device_name || !device_name[0])
+	{
+		return;
+	}
+	for (i = 0; i < num_target_patterns; i++)
+	{
+		if (conmon_dispatch_match(target_patterns[i], device_name))
+		{
+			if (conmon_dispatch_add(control_dispatch, device_name) == AUD_ERR_NOBUFS && !discovery_full)
+			{
+				printf("More than %u devices match, ignoring the rest\n", MAX_TARGETS);
+				discovery_full = AUD_TRUE;
+			}
+			break;
+		}
+	}
+}
+
+// Listen for status messages from every device for a while, collecting the names that match
+static aud_error_t
+discover_targets
+(
+	conmon_client_t * client
+) {
 	aud_error_t result;
 	aud_errbuf_t errbuf;
 	conmon_client_request_id_t req_id;
-	
-	aud_env_t * env = NULL;
-	conmon_client_t * client = NULL;
+	const uint64_t until = now_ms() + DISCOVERY_TIME_MS;
 
-	conmon_name_t controlled_name;
-	aud_utime_t control_timeout = {5, 0};
+	result = conmon_client_register_monitoring_messages(client,
+		handle_response, &req_id,
+		CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+		handle_discovery_message);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response(client, &comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error registering for status messages: %s\n", aud_error_message(result, errbuf));
+		return result;
+	}
+	result = conmon_client_subscribe_global(client, handle_response, &req_id, CONMON_CHANNEL_TYPE_STATUS);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response(client, &comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error subscribing to status from all devices: %s\n", aud_error_message(result, errbuf));
+		return result;
+	}
 
-	conmon_message_body_t body;
-	uint16_t body_size = 0; // = sizeof(conmon_audinate_message_head_t); // message with no payload
+	printf("Discovering devices for %u seconds\n", DISCOVERY_TIME_MS / 1000);
+	while (now_ms() < until)
+	{
+		conmon_example_sleep(&poll_delay);
+		conmon_client_process(client);
+	}
 
-	if(argc < 3) 
+	// stop listening before sending, so that only control responses arrive from here on
+	result = conmon_client_unsubscribe_global(client, handle_response, &req_id, CONMON_CHANNEL_TYPE_STATUS);
+	if (result == AUD_SUCCESS)
 	{
-		usage(argv[0]);
+		result = wait_for_response(client, &comms_timeout);
 	}
-	result = parse_args(argc, argv, &body, &body_size);
-	if (result == AUD_ERR_INVALIDPARAMETER)
+	if (result != AUD_SUCCESS)
 	{
-		usage(argv[0]);
-	} 
-	else 
-	{	
+		printf("Error unsubscribing from status: %s\n", aud_error_message(result, errbuf));
+	}
+	return AUD_SUCCESS;
+}
+
+static aud_error_t
+send_to_target
+(
+	conmon_client_t * client,
+	const char * device_name,
+	const conmon_message_body_t * body,
+	uint16_t body_size,
+	conmon_client_request_id_t * req_id
+) {
+	return conmon_client_send_control_message(client,
+		handle_response, req_id,
+		control_name(device_name), CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+		body, body_size,
+		&device_timeout); // the server will give up trying after this long, so that we don't wait forever for a response
+}
+
+static void print_results(void)
+{
+	conmon_dispatch_summary_t summary;
+	unsigned int i;
+
+	printf("\n%-32s %-9s %8s  %s\n", "DEVICE", "STATE", "MS", "RESULT");
+	for (i = 0; i < conmon_dispatch_num_targets(control_dispatch); i++)
+	{
+		const conmon_dispatch_target_t * target = conmon_dispatch_target_at_index(control_dispatch, i);
+		aud_errbuf_t errbuf;
+
+		printf("%-32s %-9s %8llu  %s\n", target->device_name,
+			conmon_dispatch_target_state_to_string(target->state),
+			(target->state == CONMON_DISPATCH_TARGET_PENDING) ? 0ull : (unsigned long long) (target->done_ms - target->sent_ms),
+			aud_error_message(target->result, errbuf));
+	}
+	conmon_dispatch_get_summary(control_dispatch, &summary);
+	printf("%u devices: %u done, %u failed, %u timed out; slowest response %llu ms\n",
+		summary.num_targets,
+		summary.num_in_state[CONMON_DISPATCH_TARGET_DONE],
+		summary.num_in_state[CONMON_DISPATCH_TARGET_FAILED],
+		summary.num_in_state[CONMON_DISPATCH_TARGET_TIMEDOUT],
+		(unsigned long long) summary.max_elapsed_ms);
+}
+
+// Send to every target at once, up to DISPATCH_WINDOW in flight, and gather the responses as they come
+static aud_error_t
+dispatch_control
+(
+	conmon_client_t * client,
+	const conmon_message_body_t * body,
+	uint16_t body_size
+) {
+	aud_error_t result = AUD_SUCCESS;
+	unsigned int i;
+
+	while (!conmon_dispatch_is_finished(control_dispatch))
+	{
+		aud_utime_t delay = poll_delay;
+		unsigned int index, ms;
 
-	// get the name of the device to be controlled
-		if (!strcmp(argv[1], "localhost"))
+		while (conmon_dispatch_next(control_dispatch, &index))
 		{
-			controlled_name[0] = '\0';
+			const conmon_dispatch_target_t * target = conmon_dispatch_target_at_index(control_dispatch, index);
+			conmon_client_request_id_t req_id = NULL;
+			aud_error_t send_result = send_to_target(client, target->device_name, body, body_size, &req_id);
+
+			conmon_dispatch_sent(control_dispatch, index, send_result, req_id, now_ms());
+			if (send_result != AUD_SUCCESS)
+			{
+				aud_errbuf_t errbuf;
+				printf ("Error sending control message to '%s' (request): %s\n",
+					target->device_name, aud_error_message(send_result, errbuf));
+			}
 		}
-		else if (!strcmp(argv[1], "broadcast"))
+
+		ms = conmon_dispatch_ms_to_next(control_dispatch, now_ms());
+		if (ms < poll_delay.tv_usec / 1000)
 		{
-			controlled_name[0] = '\0';
+			delay.tv_usec = ms * 1000;
 		}
-		else
+		conmon_example_sleep(&delay);
+		conmon_client_process(client);
+		conmon_dispatch_expire(control_dispatch, now_ms());
+	}
+
+	print_results();
+
+	// report the first failure
+	for (i = 0; i < conmon_dispatch_num_targets(control_dispatch) && result == AUD_SUCCESS; i++)
+	{
+		result = conmon_dispatch_target_at_index(control_dispatch, i)->result;
+	}
+	return result;
+}
+
+// Create the target list and fill it from a comma separated list of device names and patterns
+static aud_error_t
+add_targets
+(
+	char * device_list
+) {
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+
+	result = conmon_dispatch_new(MAX_TARGETS, DISPATCH_WINDOW, DISPATCH_TIMEOUT_MS, &control_dispatch);
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error creating dispatch: %s\n", aud_error_message(result, errbuf));
+		return result;
+	}
+
+	// split the comma separated list into device names and patterns to match
+	do
+	{
+		char * next = strchr(device_list, ',');
+		if (next)
 		{
-			SNPRINTF(controlled_name, CONMON_NAME_LENGTH, "%s", argv[1]);
+			*next++ = '\0';
 		}
-
-		
-		result = aud_env_setup (&env);
-		if (result != AUD_SUCCESS)
+		if (conmon_dispatch_is_pattern(device_list))
 		{
-			printf("Error initialising conmon client library: %s\n",
-				aud_error_message(result, errbuf));
-			goto cleanup;
+			if (num_target_patterns == MAX_TARGET_PATTERNS)
+			{
+				printf("More than %u device patterns\n", MAX_TARGET_PATTERNS);
+				return AUD_ERR_INVALIDPARAMETER;
+			}
+			target_patterns[num_target_patterns++] = device_list;
 		}
-	
-		result = conmon_client_new (env, & client, "conmon_audinate_controller");
-		if (client == NULL)
+		else
 		{
-			printf("Error creating client: %s\n", aud_error_message(result, errbuf));
-			goto cleanup;
+			result = conmon_dispatch_add(control_dispatch, device_list);
+			if (result != AUD_SUCCESS)
+			{
+				printf("Error adding device '%s': %s\n", device_list, aud_error_message(result, errbuf));
+				return result;
+			}
 		}
-	
-		// set before connecting to avoid possible race conditions / missed notifications
-		conmon_client_set_networks_changed_callback(client, handle_networks_changed);
-	
-		result = conmon_client_connect (client, & handle_response, & req_id); // store client at pos 0 of array
-		if (result == AUD_SUCCESS)
+		device_list = next;
+	} while (device_list);
+	return AUD_SUCCESS;
+}
+
+static void
+clear_targets(void)
+{
+	conmon_dispatch_delete(control_dispatch);
+	control_dispatch = NULL;
+	num_target_patterns = 0;
+	discovery_full = AUD_FALSE;
+}
+
+// Send a command built by parse_args, to the local device, as a broadcast or to every target
+static aud_error_t
+send_command
+(
+	conmon_client_t * client,
+	const conmon_audinate_control_handler_map * entry,
+	const conmon_message_body_t * body,
+	uint16_t body_size
+) {
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	conmon_client_request_id_t req_id;
+
+	if (control_template)
+	{
+		// built from the cache in batch mode, so send the cached body itself
+		body = conmon_control_template_get_body(control_template);
+		body_size = conmon_control_template_get_body_size(control_template);
+	}
+
+	if (entry->channel == CONMON_CHANNEL_TYPE_LOCAL)
+	{
+		result = conmon_client_send_monitoring_message(client,
+			handle_response, &req_id,
+			CONMON_CHANNEL_TYPE_LOCAL,
+			CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+			body, body_size);
+		if (result != AUD_SUCCESS)
 		{
-			printf("Connecting, request id is 0x%p\n", req_id);
+			printf ("Error sending local control message (request): %s\n", aud_error_message(result, errbuf));
 		}
 		else
 		{
-			printf("Error connecting client: %s\n", aud_error_message(result, errbuf));
-			goto cleanup;
+			printf("sending local control message with request_id %p\n", req_id);
+			result = wait_for_response(client, &comms_timeout);
+			if (result != AUD_SUCCESS)
+			{
+				printf ("Error sending local control message (response): %s\n", aud_error_message(result, errbuf));
+			}
 		}
-		result = wait_for_response(client, &comms_timeout);
+	}
+	else if (entry->channel == CONMON_CHANNEL_TYPE_BROADCAST)
+	{
+		result = conmon_client_send_monitoring_message(client,
+			handle_response, &req_id,
+			CONMON_CHANNEL_TYPE_BROADCAST,
+			CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+			body, body_size);
 		if (result != AUD_SUCCESS)
 		{
-			printf("Error connecting client: %s\n", aud_error_message(result, errbuf));
-			goto cleanup;
+			printf ("Error sending broadcast message (request): %s\n", aud_error_message(result, errbuf));
 		}
-	
-		if((!strncmp(argv[2],"access", 6))||(!strncmp(argv[2],"dante_ready",11)))
+		else
 		{
-			result = conmon_client_send_monitoring_message(client,
-				handle_response, &req_id,
-				CONMON_CHANNEL_TYPE_LOCAL,
-				CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
-				&body, body_size);
+			printf("sent broadcast message with request id %p\n", req_id);
+			result = wait_for_response(client, &comms_timeout);
 			if (result != AUD_SUCCESS)
 			{
-				printf ("Error sending local control message (request): %s\n", aud_error_message(result, errbuf));
-			}
-			else
-			{
-				printf("sending local control message with request_id %p\n", req_id);
-				result = wait_for_response(client, &comms_timeout);
-				if (result != AUD_SUCCESS)
-				{
-					printf ("Error sending local control message (response): %s\n", aud_error_message(result, errbuf));
-				}
+				printf ("Error sending broadcast message (response): %s\n", aud_error_message(result, errbuf));
 			}
-		}
-		else if (!strncmp(argv[2], "master",6) || !strncmp(argv[2], "name_id", 7))
+		}	
+	}
+	else
+	{
+		// we're connected, find any devices matching the patterns then send to them all at once
+		if (num_target_patterns)
 		{
-			result = conmon_client_send_monitoring_message(client,
-				handle_response, &req_id,
-				CONMON_CHANNEL_TYPE_BROADCAST,
-				CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
-				&body, body_size);
+			result = discover_targets(client);
 			if (result != AUD_SUCCESS)
 			{
-				printf ("Error sending broadcast message (request): %s\n", aud_error_message(result, errbuf));
+				return result;
 			}
-			else
-			{
-				printf("sent broadcast message with request id %p\n", req_id);
-				result = wait_for_response(client, &comms_timeout);
-				if (result != AUD_SUCCESS)
-				{
-					printf ("Error sending broadcast message (response): %s\n", aud_error_message(result, errbuf));
-				}
-			}	
+		}
+		if (!conmon_dispatch_num_targets(control_dispatch))
+		{
+			printf("No devices to control\n");
+			return AUD_ERR_NOTFOUND;
+		}
+		result = dispatch_control(client, body, body_size);
+	}
+	return result;
+}
+
+/*
+	Run one command per line, each written as on the command line:
+	"devices command [args...]". Arguments are separated by spaces and
+	lines starting with '#' are skipped. Builder commands come from a
+	template cache, so a change repeated across lines is built once.
+	Every line is run; the first failure is returned.
+ */
+static aud_error_t
+run_batch
+(
+	conmon_client_t * client,
+	char * cmd,
+	const char * path
+) {
+	char line[1024];
+	unsigned int line_num = 0, num_commands = 0;
+	aud_error_t result = AUD_SUCCESS;
+	aud_errbuf_t errbuf;
+	conmon_control_cache_stats_t stats;
+	FILE * fp = strcmp(path, "-") ? fopen(path, "r") : stdin;
+
+	if (!fp)
+	{
+		printf("Error opening file '%s'\n", path);
+		return AUD_ERR_NOTFOUND;
+	}
+
+	result = conmon_control_builder_new(conmon_control_audinate_specs,
+		conmon_control_audinate_num_specs, &control_builder);
+	if (result == AUD_SUCCESS)
+	{
+		result = conmon_control_cache_new(control_builder, CONTROL_CACHE_SIZE, &control_cache);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error creating control cache: %s\n", aud_error_message(result, errbuf));
+		goto cleanup;
+	}
+
+	while (fgets(line, sizeof(line), fp))
+	{
+		char * args[MAX_BATCH_ARGS];
+		int n = 0;
+		char * arg;
+		const conmon_audinate_control_handler_map * entry = NULL;
+		conmon_message_body_t body;
+		uint16_t body_size = 0;
+		aud_error_t line_result;
+
+		line_num++;
+		args[n++] = cmd;
+		for (arg = strtok(line, " \t\r\n"); arg && n < MAX_BATCH_ARGS; arg = strtok(NULL, " \t\r\n"))
+		{
+			args[n++] = arg;
+		}
+		if (n == 1 || args[1][0] == '#')
+		{
+			continue;
+		}
+		num_commands++;
+		printf("\n%s:%u: %s %s\n", path, line_num, args[1], (n > 2) ? args[2] : "");
+		if (n < 3 || arg)
+		{
+			printf("%s:%u: expected DEVICES COMMAND [ARGS...], at most %u arguments\n",
+				path, line_num, MAX_BATCH_ARGS - 3);
+			line_result = AUD_ERR_INVALIDPARAMETER;
 		}
 		else
 		{
-			// we're connected, send control message
-			result = conmon_client_send_control_message(client,
-					handle_response, &req_id,
-					controlled_name, CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
-				&body, body_size,
-				&control_timeout); // the server will give up trying after this long, so that we don't wait forever for a response
-			if (result != AUD_SUCCESS)
+			line_result = parse_args(n, args, &body, &body_size, &entry);
+			if (line_result == AUD_ERR_INVALIDPARAMETER)
 			{
-				printf ("Error sending control message (request): %s\n", aud_error_message(result, errbuf));
+				printf("%s:%u: unknown command or invalid arguments\n", path, line_num);
 			}
 			else
 			{
-				printf("sent control message with request id %p\n", req_id);
-				result = wait_for_response(client, &comms_timeout);
-				if (result != AUD_SUCCESS)
+				line_result = add_targets(args[1]);
+				if (line_result == AUD_SUCCESS)
 				{
-					printf ("Error sending control message (response): %s\n", aud_error_message(result, errbuf));
+					line_result = send_command(client, entry, &body, body_size);
 				}
+				clear_targets();
 			}
 		}
+		if (result == AUD_SUCCESS)
+		{
+			result = line_result;
+		}
 	}
 
+	conmon_control_cache_get_stats(control_cache, &stats);
+	printf("\n%u commands; %lu control messages built, %lu reused from the cache\n",
+		num_commands, stats.num_builds, stats.num_hits);
+
 cleanup:
-	if (client)
-	{
-		conmon_client_delete(client);
-			// Note: this calls conmon_client_disconnect as part of clean-up
-	}
-	if (env)
+	if (fp != stdin)
 	{
-		aud_env_release (env);
+		fclose(fp);
 	}
 	return result;
 }
 
-static uint32_t parse_address(const char * msg)
+int main(int argc, char **argv)
 {
-	uint32_t addr;
-	int v1, v2, v3, v4;
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	conmon_client_request_id_t req_id;
+	
+	aud_env_t * env = NULL;
+	conmon_client_t * client = NULL;
 
-	if (sscanf(msg, "%d.%d.%d.%d", &v1, &v2, &v3, &v4) < 4)
-	{
-		return 0;
-	}
-	if (v1 < 0 || v1 > 255 || v2 < 0 || v2 > 255 || v3 < 0 || v3 > 255 || v3 < 0 || v3 > 255)
-	{
-		return 0;
-	}
-	addr = v1 << 24 | v2 << 16 | v3 << 8 | v4;
-	return addr;
-}
+	const conmon_audinate_control_handler_map * entry = NULL;
+	const char * batch_path = NULL;
 
-aud_error_t conmon_audinate_interface_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	char * str;
-	const char * domain_name = NULL;
-	conmon_audinate_init_interface_control(body, 0);
-	
-	if(argc == 3)
+	conmon_message_body_t body;
+	uint16_t body_size = 0; // = sizeof(conmon_audinate_message_head_t); // message with no payload
+
+	if(argc < 3) 
 	{
-		// no params send null message
-		printf("sending query message\n");
-		*body_size = conmon_audinate_interface_control_get_size(body);
-		return AUD_SUCCESS;
+		usage(argv[0]);
 	}
-	else if (argc == 5 && !strcmp(argv[3], "redundancy") && !strcmp(argv[4], "true"))
+	if (argc == 3 && !strcmp(argv[1], "-f"))
 	{
-		conmon_audinate_interface_control_set_switch_redundancy(body, AUD_TRUE);
-		*body_size = conmon_audinate_interface_control_get_size(body);
-		return AUD_SUCCESS;
+		batch_path = argv[2];
 	}
-	else if (argc == 5 && !strcmp(argv[3], "redundancy") && !strcmp(argv[4], "false"))
+	else
+	{
+		result = parse_args(argc, argv, &body, &body_size, &entry);
+		if (result == AUD_ERR_INVALIDPARAMETER)
+		{
+			usage(argv[0]);
+		}
+		result = add_targets(argv[1]);
+		if (result == AUD_ERR_INVALIDPARAMETER)
+		{
+			usage(argv[0]);
+		}
+		else if (result != AUD_SUCCESS)
+		{
+			goto cleanup;
+		}
+	}
+		
+	result = aud_env_setup (&env);
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error initialising conmon client library: %s\n",
+			aud_error_message(result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_client_new (env, & client, "conmon_audinate_controller");
+	if (client == NULL)
+	{
+		printf("Error creating client: %s\n", aud_error_message(result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_networks_changed_callback(client, handle_networks_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id); // store client at pos 0 of array
+	if (result == AUD_SUCCESS)
+	{
+		printf("Connecting, request id is 0x%p\n", req_id);
+	}
+	else
+	{
+		printf("Error connecting client: %s\n", aud_error_message(result, errbuf));
+		goto cleanup;
+	}
+	result = wait_for_response(client, &comms_timeout);
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error connecting client: %s\n", aud_error_message(result, errbuf));
+		goto cleanup;
+	}
+
+	if (batch_path)
+	{
+		result = run_batch(client, argv[0], batch_path);
+	}
+	else
+	{
+		result = send_command(client, entry, &body, body_size);
+	}
+
+cleanup:
+	if (client)
+	{
+		conmon_client_delete(client);
+			// Note: this calls conmon_client_disconnect as part of clean-up
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	clear_targets();
+	conmon_control_cache_delete(control_cache);
+	conmon_control_builder_delete(control_builder);
+	return result;
+}
+
+static uint32_t parse_address(const char * msg)
+{
+	uint32_t addr;
+	int v1, v2, v3, v4;
+
+	if (sscanf(msg, "%d.%d.%d.%d", &v1, &v2, &v3, &v4) < 4)
+	{
+		return 0;
+	}
+	if (v1 < 0 || v1 > 255 || v2 < 0 || v2 > 255 || v3 < 0 || v3 > 255 || v3 < 0 || v3 > 255)
+	{
+		return 0;
+	}
+	addr = v1 << 24 | v2 << 16 | v3 << 8 | v4;
+	return addr;
+}
+
+// Commands described by a spec in conmon_control_builder.c
+aud_error_t conmon_audinate_builder_control_handler
+(
+	int argc,
+	char ** argv,
+	conmon_message_body_t *body,
+	uint16_t *body_size
+) {
+	aud_error_t result;
+	const conmon_control_spec_t * spec;
+	const char * bad_arg;
+
+	if (!control_builder)
+	{
+		result = conmon_control_builder_new(conmon_control_audinate_specs,
+			conmon_control_audinate_num_specs, &control_builder);
+		if (result != AUD_SUCCESS)
+		{
+			return result;
+		}
+	}
+	spec = conmon_control_builder_find(control_builder, argv[2]);
+	if (!spec)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	if (control_cache)
+	{
+		result = conmon_control_cache_lookup(control_cache, spec,
+			argc - 3, argv + 3, &control_template, &bad_arg);
+	}
+	else
+	{
+		result = conmon_control_builder_build(control_builder, spec,
+			argc - 3, argv + 3, body, body_size, &bad_arg);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		if (bad_arg)
+		{
+			fprintf(stderr, "Invalid argument '%s'\n", bad_arg);
+		}
+		conmon_control_builder_print_usage(stderr, argv[0], spec);
+		control_template = NULL;
+		return result;
+	}
+	if (argc == 3)
+	{
+		printf("sending query message\n");
+	}
+	return AUD_SUCCESS;
+}
+
+aud_error_t conmon_audinate_interface_control_handler
+(
+	int argc,
+	char ** argv,
+	conmon_message_body_t *body,
+	uint16_t *body_size
+) {
+	char * str;
+	const char * domain_name = NULL;
+	conmon_audinate_init_interface_control(body, 0);
+	
+	if(argc == 3)
+	{
+		// no params send null message
+		printf("sending query message\n");
+		*body_size = conmon_audinate_interface_control_get_size(body);
+		return AUD_SUCCESS;
+	}
+	else if (argc == 5 && !strcmp(argv[3], "redundancy") && !strcmp(argv[4], "true"))
+	{
+		conmon_audinate_interface_control_set_switch_redundancy(body, AUD_TRUE);
+		*body_size = conmon_audinate_interface_control_get_size(body);
+		return AUD_SUCCESS;
+	}
+	else if (argc == 5 && !strcmp(argv[3], "redundancy") && !strcmp(argv[4], "false"))
 	{
 		conmon_audinate_interface_control_set_switch_redundancy(body, AUD_FALSE);
 		*body_size = conmon_audinate_interface_control_get_size(body);
@@ -498,32 +978,6 @@ aud_error_t conmon_audinate_interface_control_handler
 }
 
 
-aud_error_t conmon_audinate_switch_vlan_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	conmon_audinate_init_switch_vlan_control(body, 0);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		*body_size = conmon_audinate_switch_vlan_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	else if (argc == 4 && !strncmp(argv[3], "id=", 3) && strlen(argv[3]) > 3)
-	{
-		uint16_t id = (uint16_t) atoi(argv[3]+3);
-		conmon_audinate_switch_vlan_control_set_config_id(body, id);
-		*body_size = conmon_audinate_switch_vlan_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	fprintf(stderr, "%s controlled_device switch_vlan [id=ID]\n", argv[0]);
-	return AUD_ERR_INVALIDPARAMETER;
-
-}
-
 aud_error_t conmon_audinate_upgrade_control_handler
 (
 	int argc,
@@ -771,1106 +1225,56 @@ l__error:
 	return AUD_ERR_INVALIDPARAMETER;
 }
 
-aud_error_t
-conmon_audinate_clear_config_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	conmon_message_size_info_t size = { 0 };
-	conmon_audinate_clear_config_action_t action = CONMON_AUDINATE_CLEAR_CONFIG_QUERY;
-
-	conmon_audinate_init_clear_config_control(body, &size, 0);
-	
-	if ((argc == 4) && !strcmp(argv[3], "keep_ip"))
-		action = CONMON_AUDINATE_CLEAR_CONFIG_KEEP_IP;
-	else if ((argc == 4) && !strcmp(argv[3], "all"))
-		action = CONMON_AUDINATE_CLEAR_CONFIG_CLEAR_ALL;
-	else if ((argc == 4) && !strcmp(argv[3], "query"))
-		action = CONMON_AUDINATE_CLEAR_CONFIG_QUERY;
-	else if (argc >= 3)
-	{
-		fprintf(stderr, "%s controlled_device %s [keep_ip|all|query]\n", argv[0], argv[2]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	
-	conmon_audinate_clear_config_control_set_action(body, &size, action);
-
-	* body_size = (uint16_t) size.curr;
-	return AUD_SUCCESS;
-}
-
-aud_error_t
-conmon_audinate_gpio_control_handler
+aud_error_t conmon_audinate_name_id_control_handler
 (
 	int argc,
 	char ** argv,
 	conmon_message_body_t *body,
 	uint16_t *body_size
-)
-{
-	uint16_t action = CONMON_AUDINATE_GPIO_CONTROL_FIELD_QUERY_STATE;
-	uint32_t output_state_valid_mask;
-	uint32_t output_state_values;
-	char * str;
-
-	output_state_valid_mask = output_state_values = 0;
-
-	if ((argc == 4) && !strcmp(argv[3], "query"))
-		action = CONMON_AUDINATE_GPIO_CONTROL_FIELD_QUERY_STATE;
-	else if ((argc == 6) && !strcmp(argv[3], "output"))
-	{
-		action = CONMON_AUDINATE_GPIO_CONTROL_FIELD_OUTPUT_STATE;
-
-		if(!strncmp(argv[4], "mask=0x", 7) && strlen(argv[4]) > 7)
-		{
-			str = argv[4] + 7;
-			sscanf(str, "%x", &output_state_valid_mask);
-		}
-
-		if(!strncmp(argv[5], "val=0x", 6) && strlen(argv[5]) > 6)
-		{
-			str = argv[5] + 6;
-			sscanf(str, "%x", &output_state_values);
-		}
-	}
-	else if (argc >= 3)
+) {
+	uint16_t d, nd;
+	if (argc == 3)
 	{
-		fprintf(stderr, "%s controlled_device %s [query]\n", argv[0], argv[2]);
-		fprintf(stderr, "%s controlled_device %s [output] mask=0xXX val=0xXX\n", argv[0], argv[2]);
+		fprintf(stderr,"%s controlled_device [name=NAME | id=DEVICE_ID:PROCESS_ID | uuid=UUID]*\n",argv[0]);
 		return AUD_ERR_INVALIDPARAMETER;
 	}
-
-	conmon_audinate_init_gpio_control(body, 0, action, 1);
-	conmon_audinate_gpio_control_state_set_at_index(body, 0, output_state_valid_mask, output_state_values);
-
-	* body_size = (uint16_t) conmon_audinate_gpio_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-aud_error_t conmon_audinate_clocking_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	//conmon_audinate_clocking_control_t * clock_control = (conmon_audinate_clocking_control_t *)body;
-	uint16_t param;
-	char * str;
-
-	conmon_audinate_init_clocking_control(body,0);
-	// parse args
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-	}
-	else if(!strncmp(argv[3], "src", 3) && strlen(argv[3]) > 3)
-	{
-		str = argv[3] + 4;
-		if(!strncmp(str,"bnc",3)) 
-		{
-			param = CONMON_AUDINATE_CLOCK_SOURCE_BNC;
-		} 
-		else if (!strncmp(str,"aes",3))
-		{
-			param = CONMON_AUDINATE_CLOCK_SOURCE_AES;
-		}
-		else if (!strncmp(str,"int",3))
-		{
-			param = CONMON_AUDINATE_CLOCK_SOURCE_INTERNAL;
-		} 
-		else
-		{
-			fprintf(stderr,"%s controlled_device clocking src=int|bnc|aes\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_clocking_control_set_source(body, param);
-	}	
-	else if(!strncmp(argv[3], "pref", 4) && strlen(argv[3]) > 4)
-	{
-		uint8_t pref;
-		str = argv[3] + 5;
-		if(!strncmp(str,"true",4)) 
-		{
-			pref = (uint8_t) AUD_TRUE;
-		} 
-		else if (!strncmp(str,"false",5))
-		{
-			pref = (uint8_t) AUD_FALSE;
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device clocking pref=true|false\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_clocking_control_set_preferred(body, pref);
-	}
-	else if(!strncmp(argv[3], "udelay", 6) && strlen(argv[3]) > 6)
+	nd = (uint16_t) (argc-3);
+	conmon_audinate_init_name_id_control(body, 0, nd);
+	for (d = 0; d < nd; d++)
 	{
-		aud_bool_t udelay;
-		str = argv[3] + 7;
-		if(!strncmp(str,"true",4)) 
-		{
-			udelay = AUD_TRUE;
-		} 
-		else if (!strncmp(str,"false",5))
-		{
-			udelay = AUD_FALSE;
-		}
-		else
+		const char * str = argv[d+3];
+		int i, x[8], p;
+		if (!strncmp(str, "name=", 5) && strlen(str) > 5)
 		{
-			fprintf(stderr,"%s controlled_device clocking udelay=true|false\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
+			conmon_audinate_name_id_set_device_name_id_at_index(body, d, str+5, NULL, NULL, NULL);
 		}
-		conmon_audinate_clocking_control_set_unicast_delay_requests(body, udelay);
-	}
-	else if(!strncmp(argv[3], "subdomain", 9) && strlen(argv[3]) > 9)
-	{
-		const char * subdomain_name = NULL;
-		str = argv[3] + 10;
-		if (str[0])
+		else if (!strncmp(str, "id=", 3) && sscanf(str+3, "%02x%02x%02x%02x%02x%02x%02x%02x:%04x",
+			x+0, x+1, x+2, x+3, x+4, x+5, x+6, x+7, &p) == 9)
 		{
-			//subdomain = (conmon_audinate_clock_subdomain_t) atoi(str);
-			subdomain_name = str;
+			conmon_instance_id_t instance_id;
+			for (i = 0; i < CONMON_DEVICE_ID_LENGTH; i++)
+			{
+				instance_id.device_id.data[i] = (uint8_t) x[i];
+			}
+			instance_id.process_id = (uint16_t) p;
+			conmon_audinate_name_id_set_device_name_id_at_index(body, d, NULL, NULL, &instance_id, NULL);
 		}
-		conmon_audinate_clocking_control_set_subdomain_name(body, subdomain_name);
-
-	}
-	else if(!strncmp(argv[3], "enabled", 7) && strlen(argv[3]) > 7)
-	{
-		aud_bool_t enabled;
-		str = argv[3] + 8;
-		if(!strncmp(str,"true",4)) 
-		{
-			enabled = AUD_TRUE;
-		} 
-		else if (!strncmp(str,"false",5))
+		else if (!strncmp(str, "uuid=", 5) && sscanf(str+5, "%02x:%02x:%02x:%02x:%02x:%02x", 
+			x+0, x+1, x+2, x+3, x+4, x+5) == 6)
 		{
-			enabled = AUD_FALSE;
+			conmon_audinate_clock_uuid_t uuid;
+			for (i = 0; i < CONMON_AUDINATE_CLOCK_UUID_LENGTH; i++)
+			{
+				uuid.data[i] = (uint8_t) x[i];
+			}
+			conmon_audinate_name_id_set_device_name_id_at_index(body, d, NULL, NULL, NULL, &uuid);
 		}
 		else
 		{
-			fprintf(stderr,"%s controlled_device clocking enabled=true|false\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_clocking_control_set_multicast_ports_enabled(body, enabled);
-	}
-	else if(!strncmp(argv[3], "slave_only", 10) && strlen(argv[3]) > 10)
-        {
-                aud_bool_t enabled;
-                str = argv[3] + 11;
-                if(!strncmp(str,"true",4))
-                {
-                        enabled = AUD_TRUE;
-                }
-                else if (!strncmp(str,"false",5))
-                {
-                        enabled = AUD_FALSE;
-                }
-                else
-                {
-                        fprintf(stderr,"%s controlled_device clocking slave_only=true|false\n", argv[0]);
-                        return AUD_ERR_INVALIDPARAMETER;
-                }
-                conmon_audinate_clocking_control_set_slave_only_enabled(body, enabled);
-        }
-	// TODO set sync mode ?
-	else
-	{
-		fprintf(stderr,"%s controlled_device clocking src=int|bnc|aes\n", argv[0]);
-		fprintf(stderr,"%s controlled_device clocking pref=true|false\n", argv[0]);
-		fprintf(stderr,"%s controlled_device clocking udelay=true|false\n", argv[0]);
-		fprintf(stderr,"%s controlled_device clocking subdomain=[_DFLT|_ALT1|_ALT2|_ALT3|_ALT4]\n", argv[0]);
-		fprintf(stderr,"%s controlled_device clocking enabled=true|false\n", argv[0]);
-		fprintf(stderr,"%s controlled_device clocking slave_only=true|false\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-
-	//*body_size = sizeof(conmon_audinate_clocking_control_t);
-	*body_size = conmon_audinate_clocking_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-
-aud_error_t conmon_audinate_unicast_clocking_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	conmon_audinate_init_unicast_clocking_control(body, 0);
-
-	// parse args
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-	}
-	else if(!strcmp(argv[3], "enabled=true"))
-	{
-		conmon_audinate_unicast_clocking_control_set_enabled(body, AUD_TRUE);
-	}
-	else if(!strcmp(argv[3], "enabled=false"))
-	{
-		conmon_audinate_unicast_clocking_control_set_enabled(body, AUD_FALSE);
-	}
-	else if(!strcmp(argv[3], "reload"))
-	{
-		conmon_audinate_unicast_clocking_control_set_reload_devices(body, AUD_TRUE);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device uclocking enabled=true|false\n", argv[0]);
-		fprintf(stderr,"%s controlled_device clocking reload\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-
-	*body_size = conmon_audinate_unicast_clocking_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-
-aud_error_t conmon_audinate_name_id_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	uint16_t d, nd;
-	if (argc == 3)
-	{
-		fprintf(stderr,"%s controlled_device [name=NAME | id=DEVICE_ID:PROCESS_ID | uuid=UUID]*\n",argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	nd = (uint16_t) (argc-3);
-	conmon_audinate_init_name_id_control(body, 0, nd);
-	for (d = 0; d < nd; d++)
-	{
-		const char * str = argv[d+3];
-		int i, x[8], p;
-		if (!strncmp(str, "name=", 5) && strlen(str) > 5)
-		{
-			conmon_audinate_name_id_set_device_name_id_at_index(body, d, str+5, NULL, NULL, NULL);
-		}
-		else if (!strncmp(str, "id=", 3) && sscanf(str+3, "%02x%02x%02x%02x%02x%02x%02x%02x:%04x",
-			x+0, x+1, x+2, x+3, x+4, x+5, x+6, x+7, &p) == 9)
-		{
-			conmon_instance_id_t instance_id;
-			for (i = 0; i < CONMON_DEVICE_ID_LENGTH; i++)
-			{
-				instance_id.device_id.data[i] = (uint8_t) x[i];
-			}
-			instance_id.process_id = (uint16_t) p;
-			conmon_audinate_name_id_set_device_name_id_at_index(body, d, NULL, NULL, &instance_id, NULL);
-		}
-		else if (!strncmp(str, "uuid=", 5) && sscanf(str+5, "%02x:%02x:%02x:%02x:%02x:%02x", 
-			x+0, x+1, x+2, x+3, x+4, x+5) == 6)
-		{
-			conmon_audinate_clock_uuid_t uuid;
-			for (i = 0; i < CONMON_AUDINATE_CLOCK_UUID_LENGTH; i++)
-			{
-				uuid.data[i] = (uint8_t) x[i];
-			}
-			conmon_audinate_name_id_set_device_name_id_at_index(body, d, NULL, NULL, NULL, &uuid);
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device [name=NAME | id=DEVICE_ID:PROCESS_ID | uuid=UUID]*\n",argv[0]);
+			fprintf(stderr,"%s controlled_device [name=NAME | id=DEVICE_ID:PROCESS_ID | uuid=UUID]*\n",argv[0]);
 			return AUD_ERR_INVALIDPARAMETER;
 		}
 	}
 	*body_size = conmon_audinate_name_id_get_size(body);
 	return AUD_SUCCESS;
 }
-
-
-aud_error_t conmon_audinate_igmp_vers_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	uint16_t version;
-	//conmon_audinate_igmp_version_control_t * igmp_control = (conmon_audinate_igmp_version_control_t *)body;
-	conmon_audinate_init_igmp_version_control(body, CONGESTION_DELAY);
-	// parse args
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-	}
-	else if(!strncmp(argv[3], "vers", 4) && strlen(argv[3]) > 4)
-	{
-		version = (uint16_t) atoi(argv[3] + 5);
-		if(version < 1 || version > 3) 
-		{
-			fprintf(stderr,"%s controlled_device igmp vers=1|2|3\n",argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		else
-		{
-			conmon_audinate_igmp_version_control_set_version(body, version);
-		}
-	}	
-	else
-	{
-		fprintf(stderr,"%s controlled_device igmp vers=1|2|3\n",argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	//*body_size = sizeof(conmon_audinate_igmp_version_control_t);
-	*body_size = conmon_audinate_igmp_version_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-
-aud_error_t
-conmon_audinate_ifstats_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	conmon_audinate_init_ifstats_control (body, 0);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-	}
-	else
-	{
-		char * arg = argv [3];
-		if (strcmp (arg, "clear") == 0)
-		{
-			conmon_audinate_ifstats_control_set_clear_errors(body);
-		}
-		else
-		{
-			goto l__usage;
-		}
-	}
-
-	*body_size = (uint16_t) conmon_audinate_ifstats_control_get_size(body);
-	return AUD_SUCCESS;
-
-l__usage:
-	fprintf(stderr,"%s controlled_device ifstats clear\n", argv[0]);
-	return AUD_ERR_INVALIDPARAMETER;
-}
-
-
-#define CHECK_SRATE(x) ( x == CONMON_AUDINATE_SRATE_44K || x == CONMON_AUDINATE_SRATE_48K  || x == CONMON_AUDINATE_SRATE_96K || x == CONMON_AUDINATE_SRATE_192K ||  x == CONMON_AUDINATE_SRATE_88K ||  x == CONMON_AUDINATE_SRATE_176K) 	 
-
-aud_error_t
-conmon_audinate_srate_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	conmon_audinate_init_srate_control (body, 0);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-
-		*body_size = conmon_audinate_srate_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	else
-	{
-		char * arg = argv [3];
-
-		char * value = strchr (arg, '=');
-		if (! value)
-		{
-			goto l__usage;
-		}
-
-		* value = 0;
-		value ++;
-		if (! * value)
-		{
-			goto l__usage;
-		}
-		
-		if (strcmp (arg, "rate") == 0)
-		{
-			uint32_t rate = atol (value);
-
-			if (CHECK_SRATE(rate))
-			{
-				conmon_audinate_srate_control_set_rate(body, rate);
-				*body_size = conmon_audinate_srate_control_get_size(body);
-				return AUD_SUCCESS;
-			}
-			else
-			{
-				goto l__usage;
-			}
-		}
-		else
-		{
-			goto l__usage;
-		}
-	}
-
-l__usage:
-	fprintf(stderr,"%s controlled_device srate rate=44100|48000|88200|96000|176400|192000\n", argv[0]);
-	return AUD_ERR_INVALIDPARAMETER;
-}
-
-
-aud_error_t
-conmon_audinate_enc_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	conmon_audinate_init_enc_control (body, 0);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-
-		*body_size = conmon_audinate_enc_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	else
-	{
-		char * arg = argv [3];
-
-		char * value = strchr (arg, '=');
-		if (! value)
-		{
-			goto l__usage;
-		}
-
-		* value = 0;
-		value ++;
-		if (! * value)
-		{
-			goto l__usage;
-		}
-		
-		if (strcmp (arg, "enc") == 0)
-		{
-			uint16_t enc = (uint16_t) atoi (value);
-			if (! enc)
-			{
-				if (strcmp (value, "pcm24") == 0)
-				{
-					enc = 24;
-				}
-				else if (strcmp (value, "raw32") == 0)
-				{
-					enc = 0x1300;
-				}
-				else
-				{
-					goto l__usage;
-				}
-			}
-
-			conmon_audinate_enc_control_set_encoding (body, enc);
-			*body_size = conmon_audinate_enc_control_get_size (body);
-			return AUD_SUCCESS;
-		}
-	}
-
-l__usage:
-	fprintf(stderr,"%s controlled_device enc enc=<n>|pcm24|raw32\n", argv[0]);
-	return AUD_ERR_INVALIDPARAMETER;
-}
-
-#define PULLUP_STRING_NONE "0"
-#define PULLUP_STRING_PLUS4 "+4.1667"
-#define PULLUP_STRING_PLUS01 "+0.1"
-#define PULLUP_STRING_MINUS01 "-0.1"
-#define PULLUP_STRING_MINUS4 "-4.0"
-
-aud_error_t
-conmon_audinate_srate_pullup_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	uint32_t value;
-	char * str;
-
-	conmon_audinate_init_srate_pullup_control (body, 0);
-
-	// parse args
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-		*body_size = conmon_audinate_srate_pullup_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	else if (argc == 5)
-	{
-		if(!strncmp(argv[3], "val", 3) && strlen(argv[3]) > 3)
-		{
-			str = argv[3] + 4;
-			if(!strcmp(str,PULLUP_STRING_NONE))
-			{
-				value = CONMON_AUDINATE_SRATE_PULLUP_NONE;
-			} 
-			else if (!strcmp(str,PULLUP_STRING_PLUS4))
-			{
-				value =  CONMON_AUDINATE_SRATE_PULLUP_PLUSFOURPOINTONESIXSIXSEVEN;
-			}
-			else if (!strcmp(str,PULLUP_STRING_PLUS01))
-			{
-				value =  CONMON_AUDINATE_SRATE_PULLUP_PLUSPOINTONE;
-			} 
-			else if (!strcmp(str,PULLUP_STRING_MINUS01))
-			{
-				value =  CONMON_AUDINATE_SRATE_PULLUP_MINUSPOINTONE;
-			} 
-			else if (!strcmp(str,PULLUP_STRING_MINUS4))
-			{
-				value =  CONMON_AUDINATE_SRATE_PULLUP_MINUSFOUR;
-			} 
-			else
-			{
-				goto l__usage;
-			}
-			conmon_audinate_srate_pullup_control_set_rate(body, value);	
-		}
-		if(!strncmp(argv[4], "subdomain", 9) && strlen(argv[4]) > 9)
-		{
-			const char * subdomain_name = NULL;
-			str = argv[4] + 10;
-			if (str[0])
-			{
-				subdomain_name = str;
-			}
-			conmon_audinate_srate_pullup_control_set_subdomain(body, subdomain_name);
-		}	
-		*body_size = conmon_audinate_srate_pullup_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-l__usage:
-		fprintf(stderr,"%s controlled_device pullup val="
-			PULLUP_STRING_NONE "|" PULLUP_STRING_PLUS4 "|"
-			PULLUP_STRING_PLUS01 "|" PULLUP_STRING_MINUS01 "|" PULLUP_STRING_MINUS4 " subdomain=[_DFLT|_ALT1|_ALT2|_ALT3|_ALT4]\n"
-			, argv[0]
-		);
-		return AUD_ERR_INVALIDPARAMETER;
-}
-
-
-aud_error_t conmon_audinate_edk_board_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	//conmon_audinate_edk_board_control_t * edk_control = (conmon_audinate_edk_board_control_t *)body;
-	uint16_t param;
-	char * str;
-
-	conmon_audinate_init_edk_board_control(body, CONGESTION_DELAY);
-	// parse args
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-	}
-	else if(!strncmp(argv[3], "rev", 3) && strlen(argv[3]) > 3)
-	{
-		str = argv[3] + 4;
-		if(!strncmp(str,"other",5)) 
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_REV_OTHER;
-		} 
-		else if (!strncmp(str,"red",3))
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_REV_RED;
-		}
-		else if (!strncmp(str,"green",5))
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_REV_GREEN;
-		} 
-		else
-		{
-			fprintf(stderr,"%s controlled_device edk rev=other|red|green\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_edk_board_set_rev(body, param);
-	}	
-	else if(!strncmp(argv[3], "pad", 3) && strlen(argv[3]) > 3)
-	{
-		int db;
-		str = argv[3] + 4;
-		db=atoi(str);
-		if(db == 0)
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_PAD_0DB;
-		}
-		else if (db == -6)
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_PAD_MINUS6DB;
-		}
-		else if (db == -12)
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_PAD_MINUS12DB;
-		}
-		else if (db == -24)
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_PAD_MINUS24DB;
-		}
-		else if (db == -48)
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_PAD_MINUS48DB;
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device edk pad=0|-6|-12|-24|-48\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_edk_board_set_pad(body, param);
-	}	
-	else if(!strncmp(argv[3], "dig", 3) && strlen(argv[3]) > 3)
-	{
-		str = argv[3] + 4;
-		if(!strncmp(str,"spdif",5)) 
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_DIG_SPDIF;
-		}
-		else if(!strncmp(str,"aes",3))
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_DIG_AES;
-		}
-		else if(!strncmp(str,"tos",3))
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_DIG_TOSLINK;
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device edk dig=spdif|aes|tos\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_edk_board_set_dig(body, param);
-	}
-	else if(!strncmp(argv[3], "src", 3) && strlen(argv[3]) > 3)
-	{
-		str = argv[3] + 4;
-		if(!strncmp(str,"sync",4)) 
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_SRC_SYNC;
-		}
-		else if(!strncmp(str,"async",5)) 
-		{
-			param = CONMON_AUDINATE_EDK_BOARD_SRC_ASYNC;
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device edk src=sync|async\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_edk_board_set_src(body, param);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device edk rev=other|red|green\n", argv[0]);
-		fprintf(stderr,"%s controlled_device edk pad=0|-6|-12|-24|-48\n", argv[0]);
-		fprintf(stderr,"%s controlled_device edk dig=spdif|aes|tos\n", argv[0]);
-		fprintf(stderr,"%s controlled_device edk src=sync|async\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-
-	//*body_size = sizeof(conmon_audinate_edk_board_control_t);
-	*body_size = conmon_audinate_edk_board_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-aud_error_t conmon_audinate_sys_reset_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	//conmon_audinate_sys_reset_control_t * rst_control = (conmon_audinate_sys_reset_control_t *)body;
-	uint16_t param;
-	char * str;
-	// parse args
-	conmon_audinate_init_sys_reset_control(body, CONGESTION_DELAY);
-
-	if(argv[3] && !strncmp(argv[3], "mode", 4) && strlen(argv[3]) > 4)
-	{
-		str = argv[3] + 5;
-		if(!strncmp(str,"soft",4)) 
-		{
-			param = CONMON_AUDINATE_SYS_RESET_SOFT;
-		}
-		else if(!strncmp(str,"factory",7)) 
-		{
-			param = CONMON_AUDINATE_SYS_RESET_FACTORY;
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device sysreset mode=soft|factory\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_sys_reset_control_set_mode(body, param);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device sysreset mode=soft|factory\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	//*body_size = sizeof(conmon_audinate_sys_reset_control_t);
-	*body_size = conmon_audinate_sys_reset_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-aud_error_t conmon_audinate_access_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	uint16_t param;
-	char * str;
-	// parse args
-	conmon_audinate_init_access_control(body, CONGESTION_DELAY);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-	}
-	else if(!strncmp(argv[3], "mode", 4) && strlen(argv[3]) > 4)
-	{
-		str = argv[3] + 5;
-		if(!strncmp(str,"enable",6)) 
-		{
-			param = CONMON_AUDINATE_ACCESS_ENABLE;
-		}
-		else if(!strncmp(str,"disable",7)) 
-		{
-			param = CONMON_AUDINATE_ACCESS_DISABLE;
-		}
-		else if(!strncmp(str,"inetd_enable",7))
-		{
-			param = CONMON_AUDINATE_INETD_ENABLE;
-		}
-		else if(!strncmp(str,"inetd_disable",7)) 
-		{
-			param = CONMON_AUDINATE_INETD_DISABLE;
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device access mode=enable|disable|inetd_enable|inetd_disable\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_access_control_set_mode(body, param);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device access mode=enable|disable|inetd_enable|inetd_disable\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	//*body_size = sizeof(conmon_audinate_access_control_t);
-	*body_size = conmon_audinate_access_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-
-aud_error_t conmon_audinate_rx_error_threshold_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-)
-{
-	uint16_t win;
-	uint16_t thres;
-	uint16_t reset;
-	//char * str;
-	// parse args
-	conmon_audinate_init_rx_error_threshold_control(body, CONGESTION_DELAY);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		// no params send null message
-		goto send_msg;
-	}
-	else if(!strncmp(argv[3], "thres", 5) && strlen(argv[3]) > 5)
-	{
-		thres = (uint16_t) atoi(argv[3] + 6);
-		conmon_audinate_rx_error_threshold_set_threshold(body, thres);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device errthres thres=val win=val reset=val\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	if(argv[4] && !strncmp(argv[4], "win", 3) && strlen(argv[4]) > 3)
-	{
-		win = (uint16_t) atoi(argv[4] + 4);
-		conmon_audinate_rx_error_threshold_set_window(body, win);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device errthres thres=val win=val reset=val\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	if(argv[5] && !strncmp(argv[5], "reset", 5) && strlen(argv[5]) > 5)
-	{
-		reset = (uint16_t) atoi(argv[5] + 6);
-		conmon_audinate_rx_error_threshold_set_reset_time(body, reset);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device errthres thres=val win=val reset=val\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	send_msg:
-	*body_size = conmon_audinate_rx_error_threshold_control_get_size(body);
-	return AUD_SUCCESS;
-}
-
-
-aud_error_t conmon_audinate_metering_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	conmon_audinate_init_metering_control(body, CONGESTION_DELAY);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		*body_size = conmon_audinate_metering_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	else if (argc == 4)
-	{
-		uint32_t rate;
-
-		if (!strncmp(argv[3], "rate=", 5) && strlen(argv[3]) > 5)
-		{
-			rate = (uint16_t) atoi(argv[3]+5);
-		}
-		else
-		{
-			goto __error;
-		}
-		
-		conmon_audinate_metering_control_set_update_rate(body, rate);
-		*body_size = conmon_audinate_metering_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-
-__error:
-	fprintf(stderr,"%s controlled_device metering rate=RATE\n", argv[0]);
-	return AUD_ERR_INVALIDPARAMETER;
-}
-
-
-aud_error_t conmon_audinate_serial_port_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	conmon_audinate_init_serial_port_control(body, CONGESTION_DELAY);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		*body_size = conmon_audinate_serial_port_control_size(body);
-		return AUD_SUCCESS;
-	}
-	else if (argc == 8)
-	{
-		uint16_t index;
-		conmon_audinate_serial_port_baud_rate_t baud_rate;
-		conmon_audinate_serial_port_bits_t bits;
-		conmon_audinate_serial_port_parity_t parity;
-		conmon_audinate_serial_port_stop_bits_t stop_bits;
-
-		if (!strncmp(argv[3], "index=", 6) && strlen(argv[3]) > 6)
-		{
-			index = (uint16_t) atoi(argv[3]);
-		}
-		else
-		{
-			goto __error;
-		}
-		if (!strncmp(argv[4], "speed=", 6) && strlen(argv[4]) > 6)
-		{
-			baud_rate = (conmon_audinate_serial_port_baud_rate_t) atoi(argv[4]+6);
-		}
-		else
-		{
-			goto __error;
-		}
-		if (!strncmp(argv[5], "bits=", 5) && strlen(argv[5]) > 5)
-		{
-			bits = (conmon_audinate_serial_port_bits_t) atoi(argv[5]+5);
-		}
-		else
-		{
-			goto __error;
-		}
-		if (!strcmp(argv[6], "parity=none"))
-		{
-			parity = CONMON_AUDINATE_SERIAL_PORT_PARITY_NONE;
-		}
-		else if (!strcmp(argv[6], "parity=odd"))
-		{
-			parity = CONMON_AUDINATE_SERIAL_PORT_PARITY_ODD;
-		}
-		else if (!strcmp(argv[6], "parity=even"))
-		{
-			parity = CONMON_AUDINATE_SERIAL_PORT_PARITY_EVEN;
-		}
-		else
-		{
-			goto __error;
-		}
-		if (!strncmp(argv[7], "stop=", 5) && strlen(argv[7]) > 5)
-		{
-			stop_bits = (conmon_audinate_serial_port_stop_bits_t) atoi(argv[7]+5);
-		}
-		else
-		{
-			goto __error;
-		}
-		
-		conmon_audinate_serial_port_control_set_port(body, index,
-			baud_rate, bits, parity, stop_bits);
-		*body_size = conmon_audinate_serial_port_control_size(body);
-		return AUD_SUCCESS;
-	}
-
-__error:
-	fprintf(stderr,"%s controlled_device serial index=val speed=val bits=7|8 parity=none|odd|even stop=0|1|2\n", argv[0]);
-	return AUD_ERR_INVALIDPARAMETER;
-}
-
-aud_error_t conmon_audinate_haremote_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	conmon_audinate_init_haremote_control(body, CONGESTION_DELAY);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		*body_size = conmon_audinate_haremote_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	else if (argc == 4)
-	{
-		conmon_audinate_haremote_bridge_mode_t mode;
-		if (!strcmp(argv[3], "mode=all"))
-		{
-			mode = CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_ALL;
-		}
-		else if (!strcmp(argv[3], "mode=none"))
-		{
-			mode = CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_NONE;
-		}
-		else if (!strcmp(argv[3], "mode=slot_db9"))
-		{
-			mode = CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_SLOT_DB9;
-		}
-		else if (!strcmp(argv[3], "mode=network_slot"))
-		{
-			mode = CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_NETWORK_SLOT;
-		}
-		else if (!strcmp(argv[3], "mode=network_db9"))
-		{
-			mode = CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_NETWORK_DB9;
-		}
-		else
-		{
-			goto __error;
-		}
-		conmon_audinate_haremote_control_set_bridge_mode(body, mode);
-		*body_size = conmon_audinate_haremote_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-
-__error:
-	fprintf(stderr,"%s controlled_device haremote mode=all|none|slot_db9|network_slot|network_db9\n", argv[0]);
-	return AUD_ERR_INVALIDPARAMETER;
-}
-
-aud_error_t conmon_audinate_ptp_logging_control_handler
-(
-	int argc,
-	char ** argv,
-	conmon_message_body_t *body,
-	uint16_t *body_size
-) {
-	char * str;
-
-	conmon_audinate_init_ptp_logging_control(body, CONGESTION_DELAY);
-	if(argc == 3)
-	{
-		printf("sending query message\n");
-		*body_size = conmon_audinate_ptp_logging_control_get_size(body);
-		return AUD_SUCCESS;
-	}
-	else if(!strncmp(argv[3], "enabled", 7) && strlen(argv[3]) > 7)
-	{
-		aud_bool_t enabled;
-		str = argv[3] + 8;
-		if(!strncmp(str,"true",4)) 
-		{
-			enabled = AUD_TRUE;
-		} 
-		else if (!strncmp(str,"false",5))
-		{
-			enabled = AUD_FALSE;
-		}
-		else
-		{
-			fprintf(stderr,"%s controlled_device ptp_logging enabled=true|false\n", argv[0]);
-			return AUD_ERR_INVALIDPARAMETER;
-		}
-		conmon_audinate_ptp_logging_network_set_enabled(body,enabled);
-		*body_size = conmon_audinate_ptp_logging_control_get_size(body);
-	}
-	else
-	{
-		fprintf(stderr,"%s controlled_device ptp_logging enabled=true|false\n", argv[0]);
-		return AUD_ERR_INVALIDPARAMETER;
-	}
-	return AUD_SUCCESS;
-}
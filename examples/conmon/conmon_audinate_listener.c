@@ -15,11 +15,17 @@
 // Include
 
 #include "conmon_examples.h"
+#include "conmon_msg_filter.h"
+#include "conmon_capture.h"
+#include "conmon_ring.h"
+#include "conmon_name_cache.h"
+#include "dapi_io.h"
 
 #ifdef WIN32
 #else
 	#include <libgen.h>
 	#include <errno.h>
+	#include <pthread.h>
 #endif
 
 //----------
@@ -29,16 +35,22 @@ static char * g_progname;
 
 enum
 {
-	LISTEN_MAX_TARGETS = 16,
-	FILTER_MAX_FILTERS = 16
+	LISTEN_MAX_TARGETS = 1024,
+	LISTEN_MAX_WORKERS = 64,
+	LISTEN_RING_SIZE = 1024 * 1024,
+		// bytes per worker, so -j N takes N MB whatever the traffic. Messages
+		// take their own size plus about 100 bytes, so this holds a few
+		// thousand typical status messages.
+	LISTEN_WRITER_BATCH = 64,
+		// records taken from one worker before moving to the next
+	LISTEN_NAME_CACHE_SIZE = 2048,
+		// instance ids
+	LISTEN_CAPTURE_FLUSH_MS = 1000,
+		// longest a captured message waits in the stdio buffer, give or take the next message
+	LISTEN_EVENT_LENGTH = 1024
+		// of an event line queued by a collector worker
 };
 
-typedef enum message_filter_mode
-{
-	MESSAGE_FILTER_MODE_PASS = 0,
-	MESSAGE_FILTER_MODE_FAIL
-} message_filter_mode_t;
-
 typedef enum print_mode_raw
 {
 	PRINT_MODE_RAW_NONE = 0,
@@ -57,9 +69,12 @@ struct conmon_info
 	aud_env_t * env;
 	uint16_t server_port;
 	conmon_client_t * client;
+	conmon_name_cache_t * names;
+		// device names and quiet mode matches for message sources
 	
 	// runtime
-	aud_bool_t running;
+	volatile aud_bool_t running;
+		// a collector's main thread clears its workers' flags to stop them
 	int result;
 	
 	// Target devices
@@ -68,7 +83,37 @@ struct conmon_info
 
 	// options
 	aud_bool_t quiet;
+	FILE * capture;
+		// if set, every monitoring message is written here
+	volatile aud_bool_t capturing;
+		// set while capture is open; collector workers follow the main thread's flag
+	uint64_t capture_flush_ns;
+		// when the capture is next flushed; it is also flushed when closed at exit
+
+	// collector mode
+	unsigned int n_workers;
+		// if set, run this many worker threads, each with its own client
+	unsigned int worker_index;
+	aud_bool_t shared_channels;
+		// register for the broadcast, local and tx channels and the local
+		// device events. Every client sees the same messages on these, so
+		// only one worker in a collector does this.
+	conmon_ring_t * ring;
+		// if set, this is a collector worker: monitoring messages and events
+		// are queued here and the writer thread captures and prints them
+	struct conmon_info * collector;
+		// for a collector worker, the main thread's info
+	struct listener_wake * wake;
+	volatile aud_bool_t writer_idle;
+		// for a collector's main thread, which sleeps on wake while it has
+		// nothing to write; workers signal it only while writer_idle is set
+	conmon_message_body_t body;
+		// a collector's main thread copies each queued body here to write it
 	
+	const struct conmon_target * match_targets;
+	unsigned int n_match_targets;
+		// every target given, which quiet mode matches against even in a
+		// collector worker, as broadcasts come from any device
 	unsigned int n_targets;
 	struct conmon_target
 	{
@@ -85,10 +130,7 @@ struct conmon_info
 
 	unsigned n_filters;
 	message_filter_mode_t filter_mode;
-	struct message_filter
-	{
-		conmon_audinate_message_type_t mtype;
-	} filter [FILTER_MAX_FILTERS];
+	struct message_filter filter [FILTER_MAX_FILTERS];
 
 	struct conmon_info_raw
 	{
@@ -101,6 +143,50 @@ struct conmon_info
 
 typedef struct conmon_target cm_target_t;
 
+/*
+	A monitoring message or event line queued by a collector worker for the
+	writer thread. The message body, or the event line and its terminator,
+	follows the record in the ring, taking only as much space as it needs.
+ */
+typedef struct listener_record
+{
+	aud_bool_t is_event;
+		// if set, only timestamp and stamped are used
+	aud_bool_t print;
+		// not set if the message is only queued to be captured
+	aud_bool_t stamped;
+		// an event printed with a timestamp, see listener_output
+	aud_utime_t timestamp;
+	conmon_channel_type_t channel_type;
+	conmon_channel_direction_t channel_direction;
+	conmon_message_head_t head;
+	char device_name [CONMON_NAME_LENGTH];
+		// empty if the worker's client could not resolve the instance id
+} listener_record_t;
+
+#ifdef WIN32
+typedef HANDLE listener_thread_t;
+typedef DWORD listener_thread_result_t;
+#define LISTENER_THREAD_CALL WINAPI
+#else
+typedef pthread_t listener_thread_t;
+typedef void * listener_thread_result_t;
+#define LISTENER_THREAD_CALL
+#endif
+
+// Wakes a collector's main thread; a signal before the wait is not lost
+typedef struct listener_wake
+{
+#ifdef WIN32
+	HANDLE event;
+		// auto reset
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	aud_bool_t signalled;
+#endif
+} listener_wake_t;
+
 
 //----------
 // Local function prototypes
@@ -115,13 +201,72 @@ pname (void)
 #endif
 }
 
+// Flags one thread sets for another: a worker's running flag and the capturing flag
+#ifdef WIN32
+
+AUD_INLINE aud_bool_t
+listener_flag_get (const volatile aud_bool_t * p)
+{
+	aud_bool_t value = *p;
+	MemoryBarrier ();
+	return value;
+}
+
+AUD_INLINE void
+listener_flag_set (volatile aud_bool_t * p, aud_bool_t value)
+{
+	MemoryBarrier ();
+	*p = value;
+}
+
+// Orders a flag store before a later load, as acquire and release do not
+AUD_INLINE void
+listener_fence (void)
+{
+	MemoryBarrier ();
+}
+
+#else
+
+AUD_INLINE aud_bool_t
+listener_flag_get (const volatile aud_bool_t * p)
+{
+	return __atomic_load_n (p, __ATOMIC_ACQUIRE);
+}
+
+AUD_INLINE void
+listener_flag_set (volatile aud_bool_t * p, aud_bool_t value)
+{
+	__atomic_store_n (p, value, __ATOMIC_RELEASE);
+}
+
+AUD_INLINE void
+listener_fence (void)
+{
+	__atomic_thread_fence (__ATOMIC_SEQ_CST);
+}
+
+#endif
+
 
 static void
 timestamp_event (void);
 
+static void
+timestamp_event_at (const aud_utime_t * at);
+
 static void
 timestamp_error (void);
 
+static void
+listener_commit (const conmon_info_t * info);
+
+static void
+listener_output (const conmon_info_t * info, aud_bool_t stamped, const char * line);
+
+static void
+print_networks (const conmon_info_t * info, conmon_client_t * client);
+
 
 static int
 handle_args (conmon_info_t * cm, unsigned int argc, char ** argv);
@@ -129,6 +274,12 @@ handle_args (conmon_info_t * cm, unsigned int argc, char ** argv);
 static aud_error_t
 setup_conmon (conmon_info_t * cm);
 
+static void
+run_client (conmon_info_t * cm);
+
+static int
+run_collector (conmon_info_t * cm);
+
 static aud_error_t
 shutdown_conmon (conmon_info_t * cm);
 
@@ -141,6 +292,31 @@ subscribe_to_remote_clients (conmon_info_t * cm);
 static cm_target_t *
 target_for_sub (conmon_info_t * cm, const conmon_client_subscription_t * sub);
 
+static conmon_name_cache_match_fn listener_name_matches;
+
+static void
+capture_message
+(
+	conmon_info_t * info,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const aud_utime_t * timestamp,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+);
+
+static void
+print_monitoring_message
+(
+	const conmon_info_t * info,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const aud_utime_t * timestamp,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body,
+	const char * device_name
+);
+
 
 //----------
 // Callback prototypes
@@ -165,8 +341,7 @@ static conmon_client_handle_subscriptions_changed_fn conmon_cb_cm_sub_changed;
 int
 main (int argc, char ** argv)
 {
-	aud_error_t result;
-	aud_errbuf_t ebuf;
+	int result;
 	conmon_info_t info = { 0 };
 	
 	result = handle_args (& info, argc, argv);
@@ -175,65 +350,30 @@ main (int argc, char ** argv)
 		return result;
 	}
 	
-	result = setup_conmon (& info);
-	if (result != AUD_SUCCESS)
+	if (info.n_workers)
 	{
-		return 1;
+		result = run_collector (& info);
 	}
-	
-	info.running = AUD_TRUE;
-	while (info.running)
+	else
 	{
-		int nfds;
-		fd_set fdr;
-		int count;
-
-		aud_socket_t fd = conmon_client_get_socket (info.client);
-		
-		FD_ZERO (& fdr);
-		FD_SET (fd, & fdr);
-
-#ifdef WIN32
-		nfds = 1;
-#else
-		nfds = fd + 1;
-#endif
-		count = select (nfds, & fdr, NULL, NULL, NULL);
-		if (count > 0)
-		{
-			result = conmon_client_process (info.client);
-			if (result != AUD_SUCCESS)
-			{
-				timestamp_error ();
-				fprintf (stderr,
-					"%s: failed processing fd %d: %s (%d)\n"
-					, pname (), fd
-					, aud_error_message (result, ebuf), result
-				);
-			}
-		}
-		else if (count == 0)
-		{
-			timestamp_error ();
-			fprintf (stderr,
-				"%s: unexpected timeout from select\n"
-				, pname ()
-			);
-		}
-		else
+		if (setup_conmon (& info) != AUD_SUCCESS)
 		{
-			timestamp_error ();
-			fprintf (stderr,
-				"%s: select failed: %s (%d)\n"
-				, pname ()
-				, strerror (errno), errno
-			);
+			return 1;
 		}
+
+		info.running = AUD_TRUE;
+		run_client (& info);
+
+		shutdown_conmon (& info);
+		result = info.result;
+	}
+
+	if (info.capture)
+	{
+		fclose (info.capture);
 	}
 	
-	shutdown_conmon (& info);
-	
-	return info.result;
+	return result;
 }
 
 
@@ -242,9 +382,16 @@ main (int argc, char ** argv)
 
 static void
 timestamp_event ()
+{
+	timestamp_event_at (NULL);
+}
+
+
+static void
+timestamp_event_at (const aud_utime_t * at)
 {
 	aud_ctime_buf_t buf;
-	printf ("#EVENT %s: ", aud_utime_ctime_no_newline (NULL, buf));
+	printf ("#EVENT %s: ", aud_utime_ctime_no_newline (at, buf));
 }
 
 
@@ -256,15 +403,162 @@ timestamp_error ()
 }
 
 
+static aud_error_t
+listener_wake_init (listener_wake_t * wake)
+{
+#ifdef WIN32
+	wake->event = CreateEvent (NULL, FALSE, FALSE, NULL);
+	return wake->event ? AUD_SUCCESS : aud_error_from_system_error (GetLastError ());
+#else
+	wake->signalled = AUD_FALSE;
+	if (pthread_mutex_init (& wake->lock, NULL))
+	{
+		return AUD_ERR_SYSTEM;
+	}
+	if (pthread_cond_init (& wake->cond, NULL))
+	{
+		pthread_mutex_destroy (& wake->lock);
+		return AUD_ERR_SYSTEM;
+	}
+	return AUD_SUCCESS;
+#endif
+}
+
+
+static void
+listener_wake_destroy (listener_wake_t * wake)
+{
+#ifdef WIN32
+	CloseHandle (wake->event);
+#else
+	pthread_cond_destroy (& wake->cond);
+	pthread_mutex_destroy (& wake->lock);
+#endif
+}
+
+
+static void
+listener_wake_signal (listener_wake_t * wake)
+{
+#ifdef WIN32
+	SetEvent (wake->event);
+#else
+	pthread_mutex_lock (& wake->lock);
+	wake->signalled = AUD_TRUE;
+	pthread_cond_signal (& wake->cond);
+	pthread_mutex_unlock (& wake->lock);
+#endif
+}
+
+
+// Wait until signalled or timeout_ms have passed
+static void
+listener_wake_wait (listener_wake_t * wake, unsigned int timeout_ms)
+{
+#ifdef WIN32
+	WaitForSingleObject (wake->event, timeout_ms);
+#else
+	struct timespec deadline;
+
+	clock_gettime (CLOCK_REALTIME, & deadline);
+	deadline.tv_sec += timeout_ms / 1000;
+	deadline.tv_nsec += (long) (timeout_ms % 1000) * 1000000;
+	if (deadline.tv_nsec >= 1000000000)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock (& wake->lock);
+	while (! wake->signalled)
+	{
+		if (pthread_cond_timedwait (& wake->cond, & wake->lock, & deadline))
+		{
+			break;
+		}
+	}
+	wake->signalled = AUD_FALSE;
+	pthread_mutex_unlock (& wake->lock);
+#endif
+}
+
+
+// Publish a collector worker's record, waking the writer if it is waiting for one
+static void
+listener_commit (const conmon_info_t * info)
+{
+	conmon_ring_commit (info->ring);
+	listener_fence ();
+	if (listener_flag_get (& info->collector->writer_idle))
+	{
+		listener_wake_signal (info->collector->wake);
+	}
+}
+
+
+// Print a line, or in a collector worker queue it for the writer thread to print
+static void
+listener_output (const conmon_info_t * info, aud_bool_t stamped, const char * line)
+{
+	listener_record_t * r;
+	size_t length;
+
+	if (! info->ring)
+	{
+		if (stamped)
+		{
+			timestamp_event ();
+		}
+		puts (line);
+		return;
+	}
+
+	length = strlen (line) + 1;
+	r = conmon_ring_reserve (info->ring, sizeof (* r) + length);
+	if (! r)
+	{
+		return;
+	}
+	r->is_event = AUD_TRUE;
+	r->print = AUD_TRUE;
+	r->stamped = stamped;
+	aud_utime_get (& r->timestamp);
+	memcpy (r + 1, line, length);
+	listener_commit (info);
+}
+
+
+static void
+print_networks (const conmon_info_t * info, conmon_client_t * client)
+{
+	const conmon_networks_t * networks = conmon_client_get_networks (client);
+	char line [LISTEN_EVENT_LENGTH];
+	char buf [LISTEN_EVENT_LENGTH - 16];
+
+	if (! info->ring)
+	{
+		puts ("Networks:");
+		conmon_aud_print_networks (networks, " ");
+		return;
+	}
+	SNPRINTF (line, sizeof (line), "Networks: %s"
+		, conmon_example_networks_to_string (networks, buf, sizeof (buf))
+	);
+	listener_output (info, AUD_FALSE, line);
+}
+
+
 static aud_error_t
 setup_conmon (conmon_info_t * cm)
 {
 	conmon_client_config_t * config = NULL;
 	aud_error_t result;
 	aud_errbuf_t ebuf;
+	char client_name [32];
 
 	cm->env = NULL;
 	cm->client = NULL;
+	cm->names = NULL;
 	cm->running = NO;
 	cm->result = 0;
 
@@ -284,7 +578,15 @@ setup_conmon (conmon_info_t * cm)
 	//	cm->env, 9889, NULL
 	//);
 
-	config = conmon_client_config_new("demo_listener");
+	if (cm->ring)
+	{
+		SNPRINTF (client_name, sizeof (client_name), "demo_listener_%u", cm->worker_index);
+	}
+	else
+	{
+		SNPRINTF (client_name, sizeof (client_name), "demo_listener");
+	}
+	config = conmon_client_config_new(client_name);
 	if (!config)
 	{
 		timestamp_error ();
@@ -315,6 +617,23 @@ setup_conmon (conmon_info_t * cm)
 
 	conmon_client_set_context (cm->client, cm);
 
+	result =
+		conmon_name_cache_new (
+			cm->client, LISTEN_NAME_CACHE_SIZE,
+			& listener_name_matches, cm,
+			& cm->names
+		);
+	if (result != AUD_SUCCESS)
+	{
+		timestamp_error ();
+		fprintf (stderr,
+			"%s: failed to create device name cache: %s (%d)\n"
+			, pname ()
+			, aud_error_message (result, ebuf), result
+		);
+		goto l__error;
+	}
+
 	result =
 		conmon_client_connect (
 			cm->client,
@@ -374,6 +693,12 @@ l__error:
 static aud_error_t
 shutdown_conmon (conmon_info_t * cm)
 {
+	if (cm->names)
+	{
+		conmon_name_cache_delete (cm->names);
+		cm->names = NULL;
+	}
+
 	if (cm->client)
 	{
 		conmon_client_delete (cm->client);
@@ -390,163 +715,432 @@ shutdown_conmon (conmon_info_t * cm)
 }
 
 
-static aud_error_t
-register_for_events (conmon_info_t * cm)
+static void
+run_client (conmon_info_t * cm)
 {
 	aud_error_t result;
-	aud_bool_t has_success = AUD_FALSE;
+	aud_errbuf_t ebuf;
+	struct timeval poll_interval;
+	struct timeval * timeout = NULL;
 
-	conmon_client_set_networks_changed_callback (
-		cm->client, & conmon_cb_network
-	);
+	if (cm->ring)
+	{
+		// wake up now and then so that a collector can stop its workers
+		poll_interval.tv_sec = 1;
+		poll_interval.tv_usec = 0;
+		timeout = & poll_interval;
+	}
+
+	while (listener_flag_get (& cm->running))
+	{
+		int nfds;
+		fd_set fdr;
+		int count;
+
+		aud_socket_t fd = conmon_client_get_socket (cm->client);
+		
+		FD_ZERO (& fdr);
+		FD_SET (fd, & fdr);
+
+#ifdef WIN32
+		nfds = 1;
+#else
+		nfds = fd + 1;
+#endif
+		count = select (nfds, & fdr, NULL, NULL, timeout);
+		if (count > 0)
+		{
+			result = conmon_client_process (cm->client);
+			if (result != AUD_SUCCESS)
+			{
+				timestamp_error ();
+				fprintf (stderr,
+					"%s: failed processing fd %d: %s (%d)\n"
+					, pname (), fd
+					, aud_error_message (result, ebuf), result
+				);
+			}
+		}
+		else if (count == 0)
+		{
+			if (cm->ring)
+			{
+				continue;
+			}
+			timestamp_error ();
+			fprintf (stderr,
+				"%s: unexpected timeout from select\n"
+				, pname ()
+			);
+		}
+		else
+		{
+			timestamp_error ();
+			fprintf (stderr,
+				"%s: select failed: %s (%d)\n"
+				, pname ()
+				, strerror (errno), errno
+			);
+		}
+	}
 	
-	conmon_client_set_dante_device_name_changed_callback (
-		cm->client, & conmon_cb_dante_device_name
-	);
-	conmon_client_set_dns_domain_name_changed_callback (
-		cm->client, & conmon_cb_dns_domain_name
-	);
+}
 
-	// Register for outgoing (TX) status messages
-	result =
-		conmon_client_register_monitoring_messages (
-			cm->client, & conmon_cb_reg_monitoring, NULL,
-			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_TX,
-			& conmon_cb_monitoring
-		);
-	if (result == AUD_SUCCESS)
+
+static uint32_t
+shard_for_name (const char * name, unsigned int n_shards)
+{
+	// case folded, as device names compare case-insensitively
+	return dapi_name_hash (name) % n_shards;
+}
+
+
+static listener_thread_result_t LISTENER_THREAD_CALL
+collector_worker (void * arg)
+{
+	run_client ((conmon_info_t *) arg);
+	return 0;
+}
+
+
+static aud_error_t
+collector_start_worker (conmon_info_t * worker, listener_thread_t * thread)
+{
+#ifdef WIN32
+	* thread = CreateThread (NULL, 0, & collector_worker, worker, 0, NULL);
+	if (! * thread)
 	{
-		has_success = AUD_TRUE;
+		return aud_error_from_system_error (GetLastError ());
 	}
-	else
+#else
+	int err = pthread_create (thread, NULL, & collector_worker, worker);
+	if (err)
 	{
-		aud_errbuf_t ebuf;
-		
-		timestamp_error ();
-		fprintf (stderr,
-			"%s: failed to register monitoring channel (status): %s (%d)\n"
-			, pname ()
-			, aud_error_message (result, ebuf), result
-		);
+		return aud_error_from_system_error (err);
 	}
+#endif
+	return AUD_SUCCESS;
+}
 
-	// Register for outgoing (TX) broadcast messages
-	result =
-		conmon_client_register_monitoring_messages (
-			cm->client, & conmon_cb_reg_monitoring, NULL,
-			CONMON_CHANNEL_TYPE_BROADCAST, CONMON_CHANNEL_DIRECTION_TX,
-			& conmon_cb_monitoring
-		);
-	if (result == AUD_SUCCESS)
+
+static void
+collector_join_worker (listener_thread_t thread)
+{
+#ifdef WIN32
+	WaitForSingleObject (thread, INFINITE);
+	CloseHandle (thread);
+#else
+	pthread_join (thread, NULL);
+#endif
+}
+
+
+static void
+collector_output (conmon_info_t * cm, const listener_record_t * r)
+{
+	const uint16_t body_size = conmon_message_head_get_body_size (& r->head);
+
+	if (r->is_event)
 	{
-		has_success = AUD_TRUE;
+		if (r->stamped)
+		{
+			timestamp_event_at (& r->timestamp);
+		}
+		puts ((const char *) (r + 1));
+		return;
 	}
-	else
+
+	// printers may look past a short body, so give them a whole one as a capture replay does
+	memcpy (& cm->body, r + 1, body_size);
+	memset ((uint8_t *) & cm->body + body_size, 0, sizeof (cm->body) - body_size);
+	if (cm->capture)
 	{
-		aud_errbuf_t ebuf;
-		
-		timestamp_error ();
-		fprintf (stderr,
-			"%s: failed to register monitoring channel (broadcast): %s (%d)\n"
-			, pname ()
-			, aud_error_message (result, ebuf), result
+		capture_message (
+			cm, r->channel_type, r->channel_direction,
+			& r->timestamp, & r->head, & cm->body
 		);
 	}
+	if (r->print)
+	{
+		print_monitoring_message (
+			cm, r->channel_type, r->channel_direction,
+			& r->timestamp, & r->head, & cm->body,
+			r->device_name [0] ? r->device_name : NULL
+		);
+	}
+}
+
+
+/*
+	Collector mode: each worker thread owns a conmon client and a shard of
+	the targets, chosen by a hash of the device name. Workers do the socket
+	and protocol work and the per-message filtering, then copy the messages
+	they keep into their own ring, along with the events they would have
+	printed. This (main) thread is the only consumer of the rings and the
+	only thread that captures or writes to stdout, so capture and output
+	ordering per worker are preserved without locking. Workers write
+	errors straight to stderr.
+
+	Worker 0 also handles the channels that every client would see (tx,
+	local, broadcast) and any -a global subscription. Quiet mode matches
+	these against every target, not just worker 0's shard.
+ */
+static int
+run_collector (conmon_info_t * cm)
+{
+	const unsigned int n = cm->n_workers;
+	conmon_info_t * workers;
+	listener_thread_t * threads;
+	unsigned long * overflows;
+	listener_wake_t wake;
+	aud_bool_t have_wake = AUD_FALSE;
+	unsigned int n_started = 0;
+	uint64_t next_overflow_check = 0;
+	aud_error_t result = AUD_SUCCESS;
+	aud_errbuf_t ebuf;
+	unsigned int i;
+
+	workers = calloc (n, sizeof (* workers));
+	threads = calloc (n, sizeof (* threads));
+	overflows = calloc (n, sizeof (* overflows));
+	if (! (workers && threads && overflows))
+	{
+		result = AUD_ERR_NOMEMORY;
+		goto l__done;
+	}
+	result = listener_wake_init (& wake);
+	if (result != AUD_SUCCESS)
+	{
+		goto l__done;
+	}
+	have_wake = AUD_TRUE;
+	cm->wake = & wake;
+
+	for (i = 0; i < n; i++)
+	{
+		conmon_info_t * worker = workers + i;
+
+		// Workers never write the capture; they queue every message while
+		// the main thread's capturing flag is set.
+		* worker = * cm;
+		worker->capture = NULL;
+		worker->collector = cm;
+		worker->worker_index = i;
+		worker->shared_channels = (i == 0);
+		worker->all = cm->all && (i == 0);
+		worker->n_targets = 0;
+		result = conmon_ring_new (LISTEN_RING_SIZE, & worker->ring);
+		if (result != AUD_SUCCESS)
+		{
+			goto l__done;
+		}
+	}
+	for (i = 0; i < cm->n_targets; i++)
+	{
+		conmon_info_t * worker = workers + shard_for_name (cm->targets [i].name, n);
+		worker->targets [worker->n_targets++] = cm->targets [i];
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		result = setup_conmon (workers + i);
+		if (result != AUD_SUCCESS)
+		{
+			goto l__done;
+		}
+	}
+	for (i = 0; i < n; i++)
+	{
+		listener_flag_set (& workers [i].running, AUD_TRUE);
+		result = collector_start_worker (workers + i, threads + i);
+		if (result != AUD_SUCCESS)
+		{
+			timestamp_error ();
+			fprintf (stderr,
+				"%s: failed to start worker %u: %s (%d)\n"
+				, pname (), i
+				, aud_error_message (result, ebuf), result
+			);
+			listener_flag_set (& workers [i].running, AUD_FALSE);
+			goto l__done;
+		}
+		n_started++;
+	}
+
+	cm->running = AUD_TRUE;
+	while (cm->running)
+	{
+		unsigned int n_records = 0;
+		uint64_t now;
+
+		for (i = 0; i < n; i++)
+		{
+			conmon_ring_t * ring = workers [i].ring;
+			const listener_record_t * r;
+			unsigned int batch;
+
+			for (batch = 0; batch < LISTEN_WRITER_BATCH; batch++)
+			{
+				r = conmon_ring_peek (ring);
+				if (! r)
+				{
+					break;
+				}
+				collector_output (cm, r);
+				conmon_ring_release (ring);
+			}
+			n_records += batch;
+		}
+
+		now = conmon_example_clock_ns ();
+		if (now >= next_overflow_check)
+		{
+			next_overflow_check = now + 1000000000;
+			for (i = 0; i < n; i++)
+			{
+				unsigned long count = conmon_ring_num_overflows (workers [i].ring);
+				if (count != overflows [i])
+				{
+					timestamp_error ();
+					fprintf (stderr,
+						"%s: worker %u dropped %lu messages, output is not keeping up\n"
+						, pname (), i, (unsigned long) (uint32_t) (count - overflows [i])
+					);
+					overflows [i] = count;
+				}
+			}
+		}
+
+		if (! n_records)
+		{
+			// Workers only signal while writer_idle is set, so look at the
+			// rings once more after setting it before going to sleep
+			listener_flag_set (& cm->writer_idle, AUD_TRUE);
+			listener_fence ();
+			for (i = 0; i < n && ! conmon_ring_peek (workers [i].ring); i++)
+				;
+			if (i == n)
+			{
+				listener_wake_wait (& wake, (unsigned int) ((next_overflow_check - now) / 1000000) + 1);
+			}
+			listener_flag_set (& cm->writer_idle, AUD_FALSE);
+		}
+	}
 
-	// Register for "outgoing" (TX) local messages
-	result =
-		conmon_client_register_monitoring_messages (
-			cm->client, & conmon_cb_reg_monitoring, NULL,
-			CONMON_CHANNEL_TYPE_LOCAL, CONMON_CHANNEL_DIRECTION_TX,
-			& conmon_cb_monitoring
-		);
-	if (result == AUD_SUCCESS)
+l__done:
+	if (result != AUD_SUCCESS && ! n_started)
 	{
-		has_success = AUD_TRUE;
-	}
-	else
-	{
-		aud_errbuf_t ebuf;
-		
 		timestamp_error ();
 		fprintf (stderr,
-			"%s: failed to register monitoring channel (local): %s (%d)\n"
+			"%s: failed to set up collector: %s (%d)\n"
 			, pname ()
 			, aud_error_message (result, ebuf), result
 		);
 	}
-
-	// register for incoming (RX) status messages
-	result =
-		conmon_client_register_monitoring_messages (
-			cm->client, & conmon_cb_reg_monitoring, NULL,
-			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
-			& conmon_cb_monitoring
-		);
-	if (result == AUD_SUCCESS)
+	for (i = 0; i < n_started; i++)
 	{
-		has_success = AUD_TRUE;
+		listener_flag_set (& workers [i].running, AUD_FALSE);
 	}
-	else
+	for (i = 0; i < n_started; i++)
 	{
-		aud_errbuf_t ebuf;
-		
-		timestamp_error ();
-		fprintf (stderr,
-			"%s: failed to register external monitoring channel (status): %s (%d)\n"
-			, pname ()
-			, aud_error_message (result, ebuf), result
-		);
+		collector_join_worker (threads [i]);
 	}
-
-	// register for incoming (RX) broadcast messages
-	result =
-		conmon_client_register_monitoring_messages (
-			cm->client, & conmon_cb_reg_monitoring, NULL,
-			CONMON_CHANNEL_TYPE_BROADCAST, CONMON_CHANNEL_DIRECTION_RX,
-			& conmon_cb_monitoring
-		);
-	if (result == AUD_SUCCESS)
+	if (workers)
 	{
-		has_success = AUD_TRUE;
+		for (i = 0; i < n; i++)
+		{
+			shutdown_conmon (workers + i);
+			conmon_ring_delete (workers [i].ring);
+		}
 	}
-	else
+	if (have_wake)
 	{
-		aud_errbuf_t ebuf;
-		
-		timestamp_error ();
-		fprintf (stderr,
-			"%s: failed to register external monitoring channel (rx broadcast): %s (%d)\n"
-			, pname ()
-			, aud_error_message (result, ebuf), result
-		);
+		listener_wake_destroy (& wake);
 	}
+	free (overflows);
+	free (threads);
+	free (workers);
 
-	// catch outbound messages as well (useful for
-	// when we are a PTP master)
-	/*
-	result =
-		conmon_client_register_monitoring_messages (
-			cm->client, & conmon_cb_reg_status, NULL,
-			CONMON_CHANNEL_TYPE_BROADCAST, CONMON_CHANNEL_DIRECTION_TX,
-			& conmon_cb_status
-		);
-	if (result == AUD_SUCCESS)
+	return (result == AUD_SUCCESS) ? cm->result : 1;
+}
+
+
+static const struct listener_channel
+{
+	conmon_channel_type_t type;
+	conmon_channel_direction_t direction;
+	aud_bool_t shared;
+		// same messages for every client, see shared_channels
+	const char * description;
+} k_listener_channels [] =
+{
+	// outgoing (TX) status messages
+	{ CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_TX, AUD_TRUE, "monitoring channel (status)" },
+	// outgoing (TX) broadcast messages
+	{ CONMON_CHANNEL_TYPE_BROADCAST, CONMON_CHANNEL_DIRECTION_TX, AUD_TRUE, "monitoring channel (broadcast)" },
+	// "outgoing" (TX) local messages
+	{ CONMON_CHANNEL_TYPE_LOCAL, CONMON_CHANNEL_DIRECTION_TX, AUD_TRUE, "monitoring channel (local)" },
+	// incoming (RX) status messages, from the devices this client subscribes to
+	{ CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX, AUD_FALSE, "external monitoring channel (status)" },
+	// incoming (RX) broadcast messages
+	{ CONMON_CHANNEL_TYPE_BROADCAST, CONMON_CHANNEL_DIRECTION_RX, AUD_TRUE, "external monitoring channel (rx broadcast)" }
+};
+
+
+static aud_error_t
+register_for_events (conmon_info_t * cm)
+{
+	aud_error_t result = AUD_SUCCESS;
+	aud_bool_t has_success = AUD_FALSE;
+	unsigned int i;
+
+	// every worker needs this one, to keep its name cache up to date
+	conmon_client_set_dante_device_name_changed_callback (
+		cm->client, & conmon_cb_dante_device_name
+	);
+
+	if (cm->shared_channels)
 	{
-		has_success = AUD_TRUE;
+		conmon_client_set_networks_changed_callback (
+			cm->client, & conmon_cb_network
+		);
+		conmon_client_set_dns_domain_name_changed_callback (
+			cm->client, & conmon_cb_dns_domain_name
+		);
 	}
-	else
+
+	for (i = 0; i < sizeof (k_listener_channels) / sizeof (k_listener_channels [0]); i++)
 	{
-		aud_errbuf_t ebuf;
-		
-		timestamp_error ();
-		fprintf (stderr,
-			"%s: failed to register external monitoring channel (tx broadcast): %s (%d)\n"
-			, pname ()
-			, aud_error_message (result, ebuf), result
-		);
+		const struct listener_channel * channel = k_listener_channels + i;
+
+		if (channel->shared && ! cm->shared_channels)
+		{
+			continue;
+		}
+
+		result =
+			conmon_client_register_monitoring_messages (
+				cm->client, & conmon_cb_reg_monitoring, NULL,
+				channel->type, channel->direction,
+				& conmon_cb_monitoring
+			);
+		if (result == AUD_SUCCESS)
+		{
+			has_success = AUD_TRUE;
+		}
+		else
+		{
+			aud_errbuf_t ebuf;
+			
+			timestamp_error ();
+			fprintf (stderr,
+				"%s: failed to register %s: %s (%d)\n"
+				, pname ()
+				, channel->description
+				, aud_error_message (result, ebuf), result
+			);
+		}
 	}
-	*/
 
 	if (has_success)
 	{
@@ -639,20 +1233,12 @@ print_raw_body
 {
 	unsigned i;
 
-	if (info->raw.n_filters)
+	if (! conmon_msg_filter_accepts (
+			info->raw.filter, info->raw.n_filters, MESSAGE_FILTER_MODE_PASS,
+			conmon_audinate_message_get_type(aud_msg)))
 	{
-		uint16_t aud_type = conmon_audinate_message_get_type(aud_msg);
-
-		for (i = 0; i < info->raw.n_filters; i++)
-		{
-			if (aud_type == info->raw.filter[i].mtype)
-			{
-				goto l__pass_filter;
-			}
-		}
 		return;
 	}
-	l__pass_filter:
 
 	printf("> Body length: %u bytes:", (unsigned) body_size);
 	for (i = 0; i < body_size; i++)
@@ -694,10 +1280,9 @@ conmon_cb_reg_connect (
 
 	if (result == AUD_SUCCESS)
 	{
-		const conmon_networks_t * networks;
+		char line [LISTEN_EVENT_LENGTH];
 
-		timestamp_event ();
-		puts ("Conmon connection successful");
+		listener_output (info, AUD_TRUE, "Conmon connection successful");
 		
 		if (info)
 		{
@@ -716,17 +1301,23 @@ conmon_cb_reg_connect (
 			);
 		}
 
-		puts ("Networks:");
-		networks = conmon_client_get_networks (client);
-		conmon_aud_print_networks (networks, " ");
+		if (info && ! info->shared_channels)
+		{
+			// only one worker in a collector reports on the local device
+			return;
+		}
 
-		fprintf (stdout,
-		"Dante device name '%s'\n"
+		print_networks (info, client);
+
+		SNPRINTF (line, sizeof (line),
+		"Dante device name '%s'"
 		, conmon_client_get_dante_device_name (client));
+		listener_output (info, AUD_FALSE, line);
 
-		fprintf (stdout,
-		"DNS domain name '%s'\n"
+		SNPRINTF (line, sizeof (line),
+		"DNS domain name '%s'"
 		, conmon_client_get_dns_domain_name (client));
+		listener_output (info, AUD_FALSE, line);
 	}
 	else
 	{
@@ -756,15 +1347,13 @@ conmon_cb_reg_monitoring (
 	aud_error_t result
 )
 {
-	(void) client;
 	(void) request_id;
 	
 	if (result == AUD_SUCCESS)
 	{
-		//conmon_info_t * info = conmon_client_context (client);
+		const conmon_info_t * info = conmon_client_context (client);
 
-		timestamp_event ();
-		puts ("Conmon status registration successful");
+		listener_output (info, AUD_TRUE, "Conmon status registration successful");
 	}
 	else
 	{
@@ -915,6 +1504,10 @@ conmon_cb_cm_sub_changed (
 {
 	unsigned int i;
 	conmon_info_t * cm = conmon_client_context (client);
+	char line [LISTEN_EVENT_LENGTH];
+
+	// instance ids may have come or gone
+	conmon_name_cache_invalidate (cm->names);
 	
 	for (i = 0; i < num_changes; i++)
 	{
@@ -945,18 +1538,18 @@ conmon_cb_cm_sub_changed (
 						target->id_buf,
 						sizeof(target->id_buf)
 					);
-					timestamp_event ();
-					printf ("Subscription to '%s' active, id=%s\n"
+					SNPRINTF (line, sizeof (line), "Subscription to '%s' active, id=%s"
 						, target->name
 						, target->id_buf
 					);
+					listener_output (cm, AUD_TRUE, line);
 				}
 				break;
 
 			case CONMON_RXSTATUS_UNRESOLVED:
 				target->found = NO;
-				timestamp_event ();
-				printf ("Subscription to '%s' is now UNRESOLVED\n", target->name);
+				SNPRINTF (line, sizeof (line), "Subscription to '%s' is now UNRESOLVED", target->name);
+				listener_output (cm, AUD_TRUE, line);
 				break;
 
 			// transient states, don't print anything
@@ -966,10 +1559,10 @@ conmon_cb_cm_sub_changed (
 				target->id_buf [0] = 0;
 				target->conmon_id = NULL;
 
-				timestamp_event ();
-				printf ("Subscription to '%s' has entered transient state 0x%04x (%s)\n", 
+				SNPRINTF (line, sizeof (line), "Subscription to '%s' has entered transient state 0x%04x (%s)", 
 					target->name, rxstatus, conmon_example_rxstatus_to_string(rxstatus)
 				);
+				listener_output (cm, AUD_TRUE, line);
 				break;
 
 			default:
@@ -977,10 +1570,10 @@ conmon_cb_cm_sub_changed (
 				target->id_buf [0] = 0;
 				target->conmon_id = NULL;
 
-				timestamp_event ();
-				printf ("Subscription to '%s' has entered error state 0x%04x (%s)\n", 
+				SNPRINTF (line, sizeof (line), "Subscription to '%s' has entered error state 0x%04x (%s)", 
 					target->name, rxstatus, conmon_example_rxstatus_to_string(rxstatus)
 				);
+				listener_output (cm, AUD_TRUE, line);
 			}
 		}
 		// else we ignore because we're not interested in this subscription
@@ -991,15 +1584,15 @@ conmon_cb_cm_sub_changed (
 static void
 conmon_cb_network (conmon_client_t * client)
 {
-	//conmon_info_t * info = conmon_client_context (client);
-	const conmon_networks_t * networks;
+	const conmon_info_t * info = conmon_client_context (client);
 
-	timestamp_event ();
-	puts ("Addresses changed");
+	if (! info->shared_channels)
+	{
+		return;
+	}
 
-	puts ("Networks:");
-	networks = conmon_client_get_networks (client);
-	conmon_aud_print_networks (networks, " ");
+	listener_output (info, AUD_TRUE, "Addresses changed");
+	print_networks (info, client);
 }
 
 // unused
@@ -1039,128 +1632,259 @@ conmon_cb_subscriptions
 static void
 conmon_cb_dante_device_name (conmon_client_t * client)
 {
-	timestamp_event ();
-	fprintf (stdout,
-		"Dante device name changed to '%s'\n"
+	conmon_info_t * info = conmon_client_context (client);
+	char line [LISTEN_EVENT_LENGTH];
+
+	// the local device's name is part of both the cache and quiet mode matching
+	conmon_name_cache_invalidate (info->names);
+	if (! info->shared_channels)
+	{
+		return;
+	}
+
+	SNPRINTF (line, sizeof (line),
+		"Dante device name changed to '%s'"
 		, conmon_client_get_dante_device_name (client)
 	);
+	listener_output (info, AUD_TRUE, line);
 }
 
 static void
 conmon_cb_dns_domain_name (conmon_client_t * client)
 {
-	timestamp_event ();
-	fprintf (stdout,
-		"DNS domain name changed to '%s'\n"
+	const conmon_info_t * info = conmon_client_context (client);
+	char line [LISTEN_EVENT_LENGTH];
+
+	if (! info->shared_channels)
+	{
+		return;
+	}
+
+	SNPRINTF (line, sizeof (line),
+		"DNS domain name changed to '%s'"
 		, conmon_client_get_dns_domain_name (client)
 	);
+	listener_output (info, AUD_TRUE, line);
 }
 
 
-void 
-conmon_cb_monitoring
+// timestamp may be NULL for the current time
+static void
+capture_message
 (
-	conmon_client_t * client,
+	conmon_info_t * info,
 	conmon_channel_type_t channel_type,
 	conmon_channel_direction_t channel_direction,
+	const aud_utime_t * timestamp,
 	const conmon_message_head_t * head,
 	const conmon_message_body_t * body
 )
 {
-	aud_bool_t want_to_print = AUD_FALSE;
-	//conmon_info_t * info = conmon_client_context (client);
-	conmon_instance_id_t id;
-	char id_buf[64];
-	//const conmon_audinate_message_head_t * aud_msg = (void *) body;
-	uint16_t aud_type = conmon_audinate_message_get_type(body);
+	aud_error_t result;
 
-	conmon_info_t * info = conmon_client_context(client);
+	if (timestamp)
+	{
+		result =
+			conmon_capture_write_record_at (
+				info->capture, channel_type, channel_direction, timestamp, head, body
+			);
+	}
+	else
+	{
+		result =
+			conmon_capture_write_record (
+				info->capture, channel_type, channel_direction, head, body
+			);
+	}
+	if (result == AUD_SUCCESS)
+	{
+		// flush now and then rather than for every message
+		uint64_t now = conmon_example_clock_ns ();
+		if (now >= info->capture_flush_ns)
+		{
+			fflush (info->capture);
+			info->capture_flush_ns = now + (uint64_t) LISTEN_CAPTURE_FLUSH_MS * 1000000;
+		}
+	}
+	else
+	{
+		aud_errbuf_t ebuf;
 
-	conmon_message_head_get_instance_id(head, &id);
+		timestamp_error ();
+		fprintf (stderr,
+			"%s: failed to write capture, capture stopped: %s (%d)\n"
+			, pname ()
+			, aud_error_message (result, ebuf), result
+		);
+		fclose (info->capture);
+		info->capture = NULL;
+		listener_flag_set (& info->capturing, AUD_FALSE);
+	}
+}
 
-	if (info->n_filters)
+
+// in 'quiet' mode we only print things we know we have specifically requested
+static aud_bool_t
+listener_name_matches (void * context, const char * name)
+{
+	const conmon_info_t * info = context;
+
+	if (info->n_match_targets)
 	{
-		unsigned i;
-		for (i = 0; i < info->n_filters; i++)
+		unsigned int i;
+		for (i = 0; i < info->n_match_targets; i++)
 		{
-			if (aud_type == info->filter[i].mtype)
+			if (dapi_name_equals(name, info->match_targets[i].name))
 			{
-				if (info->filter_mode == MESSAGE_FILTER_MODE_PASS)
-					goto l__pass_filter;
-				else
-					return;
+				return AUD_TRUE;
 			}
 		}
-		if (info->filter_mode == MESSAGE_FILTER_MODE_PASS)
-			return;
+		return AUD_FALSE;
 	}
-	l__pass_filter:
+	return dapi_name_equals(name, conmon_client_get_dante_device_name(info->client));
+}
+
+
+// timestamp may be NULL for the current time
+static void
+print_monitoring_message
+(
+	const conmon_info_t * info,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const aud_utime_t * timestamp,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body,
+	const char * device_name
+)
+{
+	aud_bool_t printed;
+	conmon_instance_id_t id;
+	char id_buf[64];
+	uint16_t body_size = conmon_message_head_get_body_size(head);
+	uint16_t aud_version = conmon_audinate_message_get_version(body);
+	uint16_t aud_type = conmon_audinate_message_get_type(body);
+
+	conmon_message_head_get_instance_id(head, &id);
 
-	if (info->all)
+	timestamp_event_at (timestamp);
+
+	printf (
+		"Received status message from %s (%s)\n:"
+		"  chan=%s (%s) size=%d aud-version=0x%04x aud-type=0x%04x\n"
+		, conmon_example_instance_id_to_string(&id, id_buf, sizeof(id_buf))
+		, (device_name ? device_name : "[unknown device]")
+		, conmon_example_channel_type_to_string(channel_type)
+		, (channel_direction == CONMON_CHANNEL_DIRECTION_TX ? "tx" : "rx")
+		, body_size
+		, (unsigned int) aud_version
+		, (unsigned int) aud_type
+	);
+	
+	printed = conmon_aud_print_msg (body, body_size);
+	if (info->raw.mode == PRINT_MODE_RAW_ALWAYS ||
+		(info->raw.mode == PRINT_MODE_RAW_UNKNOWN && !printed)
+	)
 	{
-		want_to_print = AUD_TRUE;
+		print_raw_body(body, body_size, info);
 	}
-	else if (!info->quiet)
+}
+
+
+// Copy a message into a collector worker's ring for the writer thread
+static void
+queue_monitoring_message
+(
+	conmon_info_t * info,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body,
+	aud_bool_t print,
+	const char * device_name
+)
+{
+	listener_record_t * r;
+	uint16_t body_size = conmon_message_head_get_body_size(head);
+
+	if (body_size > sizeof (conmon_message_body_t))
 	{
-		want_to_print = AUD_TRUE;
+		return;
 	}
-	else
+
+	r = conmon_ring_reserve (info->ring, sizeof (* r) + body_size);
+	if (! r)
 	{
-		// in 'quiet' mode we only print things we know we have specifically requested
-		const char * name = conmon_client_device_name_for_instance_id(client, &id);
-		if (name)
-		{
-			if (info->n_targets)
-			{
-				unsigned int i;
-				for (i = 0; i < info->n_targets; i++)
-				{
-					if (!STRCASECMP(name, info->targets[i].name))
-					{
-						want_to_print = AUD_TRUE;
-						break;
-					}
-				}
-			}
-			else if (!STRCASECMP(name, conmon_client_get_dante_device_name(info->client)))
-			{
-				want_to_print = AUD_TRUE;
-			}
-		}
+		// counted by the ring and reported by the writer
+		return;
 	}
-	if (!want_to_print)
+
+	r->is_event = AUD_FALSE;
+	r->channel_type = channel_type;
+	r->channel_direction = channel_direction;
+	aud_utime_get (& r->timestamp);
+	r->head = * head;
+	memcpy (r + 1, body, body_size);
+	r->print = print;
+	r->device_name [0] = 0;
+	if (device_name)
 	{
-		return;
+		SNPRINTF (r->device_name, sizeof (r->device_name), "%s", device_name);
+		r->device_name [sizeof (r->device_name) - 1] = 0;
 	}
+	listener_commit (info);
+}
 
-	timestamp_event ();
-	
-	
+
+void 
+conmon_cb_monitoring
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	aud_bool_t want_to_print = AUD_FALSE;
+	const char * device_name = NULL;
+	uint16_t aud_type = conmon_audinate_message_get_type(body);
+
+	conmon_info_t * info = conmon_client_context(client);
+
+	if (info->capture && ! info->ring)
 	{
-		aud_bool_t printed;
-		uint16_t body_size = conmon_message_head_get_body_size(head);
-		const char * device_name = conmon_client_device_name_for_instance_id(client, &id);
-		uint16_t aud_version = conmon_audinate_message_get_version(body);
-		printf (
-			"Received status message from %s (%s)\n:"
-			"  chan=%s (%s) size=%d aud-version=0x%04x aud-type=0x%04x\n"
-			, conmon_example_instance_id_to_string(&id, id_buf, sizeof(id_buf))
-			, (device_name ? device_name : "[unknown device]")
-			, conmon_example_channel_type_to_string(channel_type)
-			, (channel_direction == CONMON_CHANNEL_DIRECTION_TX ? "tx" : "rx")
-			, conmon_message_head_get_body_size(head)
-			, (unsigned int) aud_version
-			, (unsigned int) aud_type
-		);
-		
-		printed = conmon_aud_print_msg (body, body_size);
-		if (info->raw.mode == PRINT_MODE_RAW_ALWAYS ||
-			(info->raw.mode == PRINT_MODE_RAW_UNKNOWN && !printed)
-		)
+		// capture before filtering so that a replay can apply its own filters
+		capture_message (info, channel_type, channel_direction, NULL, head, body);
+	}
+
+	if (conmon_msg_filter_accepts (info->filter, info->n_filters, info->filter_mode, aud_type))
+	{
+		conmon_instance_id_t id;
+		const conmon_name_cache_entry_t * source;
+
+		conmon_message_head_get_instance_id(head, &id);
+		source = conmon_name_cache_lookup (info->names, &id);
+		device_name = source->device_name;
+		want_to_print = info->all || !info->quiet || source->matches;
+	}
+
+	if (info->ring)
+	{
+		if (want_to_print || listener_flag_get (& info->collector->capturing))
 		{
-			print_raw_body(body, body_size, info);
+			queue_monitoring_message (
+				info, channel_type, channel_direction, head, body,
+				want_to_print, device_name
+			);
 		}
 	}
+	else if (want_to_print)
+	{
+		print_monitoring_message (
+			info, channel_type, channel_direction, NULL, head, body, device_name
+		);
+	}
 }
 
 
@@ -1178,6 +1902,7 @@ handle_args (conmon_info_t * cm, unsigned int argc, char ** argv)
 	unsigned int more_opts = 1;
 
 	g_progname = argv [0];
+	cm->shared_channels = AUD_TRUE;
 	
 	while (more_opts && curr_arg_index < argc)
 	{
@@ -1210,6 +1935,22 @@ handle_args (conmon_info_t * cm, unsigned int argc, char ** argv)
 			case 'q':
 				cm->quiet = AUD_TRUE;
 				break;
+
+			case 'j':
+				if (curr_arg_index >= argc)
+				{
+					return usage("Missing argument to -j");
+				}
+				else
+				{
+					int n_workers = atoi(argv[curr_arg_index++]);
+					if (n_workers < 1 || n_workers > LISTEN_MAX_WORKERS)
+					{
+						return usage("Invalid number of workers");
+					}
+					cm->n_workers = (unsigned int) n_workers;
+				}
+				break;
 			
 			case 'a':
 				cm->all = AUD_TRUE;
@@ -1278,6 +2019,37 @@ handle_args (conmon_info_t * cm, unsigned int argc, char ** argv)
 				cm->raw.offsets = AUD_TRUE;
 				break;
 
+			case 'w':
+				if (curr_arg_index >= argc)
+				{
+					return usage("Missing argument to -w");
+				}
+				else if (cm->capture)
+				{
+					return usage("Only one capture file may be given");
+				}
+				else
+				{
+					const char * path = argv[curr_arg_index++];
+					cm->capture = fopen (path, "wb");
+					if (! cm->capture)
+					{
+						fprintf (stderr, "%s: failed to open capture file '%s': %s\n"
+							, pname (), path, strerror (errno)
+						);
+						return 1;
+					}
+					if (conmon_capture_write_file_head (cm->capture) != AUD_SUCCESS)
+					{
+						fprintf (stderr, "%s: failed to write capture file '%s'\n"
+							, pname (), path
+						);
+						return 1;
+					}
+					cm->capturing = AUD_TRUE;
+				}
+				break;
+
 			default:
 				fprintf (stderr, "%s: Unknown option '%s'\n"
 					, pname (), arg
@@ -1292,12 +2064,18 @@ handle_args (conmon_info_t * cm, unsigned int argc, char ** argv)
 	}
 	
 	cm->n_targets = argc - curr_arg_index;
+	if (cm->n_targets > LISTEN_MAX_TARGETS)
+	{
+		return usage("Too many devices");
+	}
 	for (i = 0; i < cm->n_targets; i++)
 	{
 		cm->targets [i].name = argv [curr_arg_index ++];
 		cm->targets [i].req_id = CONMON_CLIENT_NULL_REQ_ID;
 		cm->targets [i].found = NO;
 	}
+	cm->match_targets = cm->targets;
+	cm->n_match_targets = cm->n_targets;
 	
 	return 0;
 }
@@ -1314,7 +2092,9 @@ usage (const char * msg)
 	}
 
 	fprintf (stderr,
-		"Usage: %s [-p port] [-q] -a [-x|f msg_type ...] [device ...]\n"
+		"Usage: %s [-p port] [-q] -a [-x|f msg_type ...] [-w capture_file] [-j workers] [device ...]\n"
+		"  -j  collector mode: share the devices between this many worker threads,\n"
+		"      each with its own conmon client and a 1 MB queue to the output thread\n"
 		, name
 	);
 	
@@ -0,0 +1,175 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Capture file format for conmon monitoring messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_capture.h"
+#include <string.h>
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_capture_write_file_head
+(
+	FILE * fp
+)
+{
+	conmon_capture_file_head_t file_head;
+
+	if (! fp)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	file_head.magic = CONMON_CAPTURE_MAGIC;
+	file_head.version = CONMON_CAPTURE_VERSION;
+	file_head.message_head_size = (uint16_t) sizeof (conmon_message_head_t);
+	if (fwrite (& file_head, sizeof (file_head), 1, fp) != 1)
+	{
+		return aud_error_get_last ();
+	}
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_capture_write_record
+(
+	FILE * fp,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	aud_utime_t now;
+
+	aud_utime_get (& now);
+	return
+		conmon_capture_write_record_at (
+			fp, channel_type, channel_direction, & now, head, body
+		);
+}
+
+
+aud_error_t
+conmon_capture_write_record_at
+(
+	FILE * fp,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const aud_utime_t * timestamp,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	conmon_capture_record_head_t record_head;
+
+	if (! (fp && timestamp && head && body))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	record_head.channel_type = (uint8_t) channel_type;
+	record_head.channel_direction = (uint8_t) channel_direction;
+	record_head.body_size = conmon_message_head_get_body_size (head);
+	record_head.timestamp_sec = (uint32_t) timestamp->tv_sec;
+	record_head.timestamp_usec = (uint32_t) timestamp->tv_usec;
+	if (record_head.body_size > sizeof (conmon_message_body_t))
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+
+	if (fwrite (& record_head, sizeof (record_head), 1, fp) != 1
+		|| fwrite (head, sizeof (conmon_message_head_t), 1, fp) != 1
+		|| (record_head.body_size && fwrite (body, record_head.body_size, 1, fp) != 1))
+	{
+		return aud_error_get_last ();
+	}
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_capture_read_file_head
+(
+	FILE * fp
+)
+{
+	conmon_capture_file_head_t file_head;
+
+	if (! fp)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	if (fread (& file_head, sizeof (file_head), 1, fp) != 1
+		|| file_head.magic != CONMON_CAPTURE_MAGIC
+		|| file_head.version != CONMON_CAPTURE_VERSION
+		|| file_head.message_head_size != sizeof (conmon_message_head_t))
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_capture_read_record
+(
+	FILE * fp,
+	conmon_capture_record_t * record
+)
+{
+	conmon_capture_record_head_t record_head;
+	size_t n;
+
+	if (! (fp && record))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	n = fread (& record_head, 1, sizeof (record_head), fp);
+	if (n == 0 && feof (fp))
+	{
+		return AUD_ERR_DONE;
+	}
+	if (n != sizeof (record_head))
+	{
+		return AUD_ERR_TRUNCATED;
+	}
+	if (record_head.body_size > sizeof (conmon_message_body_t))
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+
+	if (fread (& record->head, sizeof (conmon_message_head_t), 1, fp) != 1
+		|| (record_head.body_size && fread (& record->body, record_head.body_size, 1, fp) != 1))
+	{
+		return AUD_ERR_TRUNCATED;
+	}
+
+	// so that a decoder reading past a short body sees zeros rather than the previous record
+	memset (record->body.data + record_head.body_size, 0, sizeof (conmon_message_body_t) - record_head.body_size);
+
+	record->channel_type = (conmon_channel_type_t) record_head.channel_type;
+	record->channel_direction = (conmon_channel_direction_t) record_head.channel_direction;
+	record->timestamp.tv_sec = record_head.timestamp_sec;
+	record->timestamp.tv_usec = record_head.timestamp_usec;
+	record->body_size = record_head.body_size;
+	return AUD_SUCCESS;
+}
+
+
+//----------
@@ -0,0 +1,127 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Capture file format for conmon monitoring messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_CAPTURE_H
+#define _CONMON_CAPTURE_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include <stdio.h>
+
+
+//----------
+// Types and Constants
+
+/*
+	A capture file is a file header followed by a sequence of records. Each
+	record is a record header, the message head and then body_size bytes of
+	message body.
+
+	Everything is written in host byte order exactly as it was handed to the
+	monitoring callback, so a capture can only be replayed on a host with the
+	same byte order and the same conmon_message_head_t layout. The header
+	records the size of the message head so that a mismatch is detected.
+ */
+
+#define CONMON_CAPTURE_MAGIC 0x50434d43u	// "CMCP" on little-endian hosts
+#define CONMON_CAPTURE_VERSION 1
+
+typedef struct conmon_capture_file_head
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t message_head_size;
+} conmon_capture_file_head_t;
+
+typedef struct conmon_capture_record_head
+{
+	uint8_t channel_type;
+	uint8_t channel_direction;
+	uint16_t body_size;
+	uint32_t timestamp_sec;
+	uint32_t timestamp_usec;
+} conmon_capture_record_head_t;
+
+typedef struct conmon_capture_record
+{
+	conmon_channel_type_t channel_type;
+	conmon_channel_direction_t channel_direction;
+	aud_utime_t timestamp;
+	uint16_t body_size;
+	conmon_message_head_t head;
+	conmon_message_body_t body;
+} conmon_capture_record_t;
+
+
+//----------
+// Functions
+
+// Write a file header. Must be called once before writing any records.
+aud_error_t
+conmon_capture_write_file_head
+(
+	FILE * fp
+);
+
+// Write one monitoring message, timestamped with the current time
+aud_error_t
+conmon_capture_write_record
+(
+	FILE * fp,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+);
+
+// Write one monitoring message that was received at the given time
+aud_error_t
+conmon_capture_write_record_at
+(
+	FILE * fp,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const aud_utime_t * timestamp,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+);
+
+/*
+	Read and check a file header.
+
+	@return AUD_ERR_INVALIDDATA if this is not a capture file or was captured
+		with an incompatible message head layout
+ */
+aud_error_t
+conmon_capture_read_file_head
+(
+	FILE * fp
+);
+
+/*
+	Read the next record. The body is zero filled past body_size.
+
+	@return AUD_ERR_DONE at the end of the file, or AUD_ERR_TRUNCATED if the
+		file ends part way through a record
+ */
+aud_error_t
+conmon_capture_read_record
+(
+	FILE * fp,
+	conmon_capture_record_t * record
+);
+
+
+//----------
+
+#endif // _CONMON_CAPTURE_H
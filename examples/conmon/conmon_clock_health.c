@@ -0,0 +1,535 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Track clock and PTP health of devices from clocking status messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_clock_health.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	CLOCK_SEEN_CLOCKING = 0x1,
+	CLOCK_SEEN_UNICAST = 0x2,
+	CLOCK_SEEN_MASTER = 0x4
+};
+
+typedef struct clock_health_entry
+{
+	conmon_clock_device_t device;
+		// must be first, handed out as the public view of the entry
+	unsigned int seen;
+		// CLOCK_SEEN_* for the kinds of status received so far
+	uint64_t changes_ms [CONMON_CLOCK_HEALTH_MAX_FLAP_THRESHOLD];
+		// ring of the most recent master changes
+	unsigned int next_change;
+	unsigned int num_changes;
+} clock_health_entry_t;
+
+struct conmon_clock_health
+{
+	conmon_clock_health_config_t config;
+	conmon_clock_health_event_fn * event_fn;
+	void * event_context;
+
+	clock_health_entry_t * entries;
+	unsigned int num_entries;
+	dapi_id_map_t * index;
+		// entries are never removed, so an instance id's index here is its index in entries
+
+	aud_bool_t have_grandmaster;
+	conmon_audinate_clock_uuid_t grandmaster_uuid;
+	unsigned long num_grandmaster_changes;
+	unsigned long num_updates;
+	unsigned long num_events [CONMON_NUM_CLOCK_EVENTS];
+};
+
+static const char * const k_ext_wc_state_names [] =
+{
+	"UNKNOWN",
+	"NONE",
+	"INVALID",
+	"VALID",
+	"MISSING"
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE aud_bool_t
+uuid_equals (const conmon_audinate_clock_uuid_t * a, const conmon_audinate_clock_uuid_t * b)
+{
+	return ! memcmp (a, b, sizeof (* a));
+}
+
+
+static void
+raise_event
+(
+	conmon_clock_health_t * health,
+	conmon_clock_event_type_t type,
+	const clock_health_entry_t * entry,
+	uint32_t old_value,
+	uint32_t new_value,
+	uint64_t now_ms
+)
+{
+	health->num_events [type]++;
+	if (health->event_fn)
+	{
+		conmon_clock_event_t event;
+
+		event.type = type;
+		event.device = & entry->device;
+		event.old_value = old_value;
+		event.new_value = new_value;
+		event.time_ms = now_ms;
+		health->event_fn (health->event_context, & event);
+	}
+}
+
+
+static clock_health_entry_t *
+find_or_add_entry
+(
+	conmon_clock_health_t * health,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms
+)
+{
+	unsigned int i;
+	aud_bool_t added;
+	clock_health_entry_t * entry;
+
+	if (dapi_id_map_insert (health->index, instance_id, & i, & added) != AUD_SUCCESS)
+	{
+		return NULL;
+	}
+	entry = health->entries + i;
+	if (! added)
+	{
+		return entry;
+	}
+	health->num_entries++;
+	memset (entry, 0, sizeof (* entry));
+	entry->device.instance_id = * instance_id;
+	entry->device.master_since_ms = now_ms;
+	raise_event (health, CONMON_CLOCK_EVENT_NEW_DEVICE, entry, 0, 0, now_ms);
+	return entry;
+}
+
+
+// Returns AUD_TRUE if this is the first status of its kind from the device
+AUD_INLINE aud_bool_t
+first_seen (clock_health_entry_t * entry, unsigned int kind)
+{
+	const aud_bool_t first = ! (entry->seen & kind);
+	entry->seen |= kind;
+	return first;
+}
+
+
+// A baseline update takes the master state without counting it as a change
+static void
+update_master
+(
+	conmon_clock_health_t * health,
+	clock_health_entry_t * entry,
+	aud_bool_t baseline,
+	uint64_t now_ms
+)
+{
+	conmon_clock_device_t * device = & entry->device;
+	const aud_bool_t master = (device->master_ports | device->unicast_master_ports) != 0;
+	const unsigned int threshold = health->config.flap_threshold;
+	uint64_t oldest_ms;
+
+	if (master == device->master)
+	{
+		return;
+	}
+	device->master = master;
+	device->master_since_ms = now_ms;
+	if (baseline)
+	{
+		return;
+	}
+	device->num_master_changes++;
+	raise_event (health, CONMON_CLOCK_EVENT_MASTER, entry, ! master, master, now_ms);
+
+	entry->changes_ms [entry->next_change] = now_ms;
+	entry->next_change = (entry->next_change + 1) % threshold;
+	if (entry->num_changes < threshold)
+	{
+		entry->num_changes++;
+	}
+	// once the ring is full the next slot holds the oldest of the last threshold changes
+	oldest_ms = entry->changes_ms [entry->next_change];
+	if (! device->flapping
+		&& entry->num_changes == threshold
+		&& now_ms - oldest_ms <= health->config.flap_window_ms)
+	{
+		device->flapping = AUD_TRUE;
+		raise_event (health, CONMON_CLOCK_EVENT_FLAPPING, entry, AUD_FALSE, AUD_TRUE, now_ms);
+	}
+}
+
+
+static void
+update_grandmaster
+(
+	conmon_clock_health_t * health,
+	clock_health_entry_t * entry,
+	const conmon_audinate_clock_uuid_t * uuid,
+	uint64_t now_ms
+)
+{
+	conmon_clock_device_t * device = & entry->device;
+	aud_bool_t followed_network;
+
+	if (! uuid || (device->have_grandmaster && uuid_equals (& device->grandmaster_uuid, uuid)))
+	{
+		return;
+	}
+
+	// Only a device that agreed with the network and has moved on can
+	// change the network's grandmaster, so devices that are still catching
+	// up with an earlier change (or have just appeared) don't flip it back
+	followed_network = ! health->have_grandmaster
+		|| (device->have_grandmaster && uuid_equals (& device->grandmaster_uuid, & health->grandmaster_uuid));
+	device->grandmaster_uuid = * uuid;
+	device->have_grandmaster = AUD_TRUE;
+
+	if (followed_network
+		&& ! (health->have_grandmaster && uuid_equals (& health->grandmaster_uuid, uuid)))
+	{
+		if (health->have_grandmaster)
+		{
+			health->num_grandmaster_changes++;
+		}
+		health->grandmaster_uuid = * uuid;
+		health->have_grandmaster = AUD_TRUE;
+		raise_event (health, CONMON_CLOCK_EVENT_GRANDMASTER, entry, 0, 0, now_ms);
+	}
+}
+
+
+static uint32_t
+master_port_mask
+(
+	const conmon_audinate_port_state_t * port_states,
+	unsigned int num_ports,
+	uint32_t valid
+)
+{
+	uint32_t mask = 0;
+	unsigned int p;
+
+	for (p = 0; p < num_ports; p++)
+	{
+		if ((valid & (1u << p)) && port_states [p] == CONMON_AUDINATE_PORT_STATE_MASTER)
+		{
+			mask |= (1u << p);
+		}
+	}
+	return mask;
+}
+
+
+//----------
+// Functions
+
+void
+conmon_clock_health_config_init
+(
+	conmon_clock_health_config_t * config
+)
+{
+	config->flap_window_ms = 60000;
+	config->flap_threshold = 4;
+	config->max_devices = 1024;
+}
+
+
+aud_error_t
+conmon_clock_health_new
+(
+	const conmon_clock_health_config_t * config,
+	conmon_clock_health_event_fn * event_fn,
+	void * event_context,
+	conmon_clock_health_t ** health_ptr
+)
+{
+	conmon_clock_health_t * health;
+
+	if (! (config && health_ptr)
+		|| config->flap_threshold < 2 || config->flap_threshold > CONMON_CLOCK_HEALTH_MAX_FLAP_THRESHOLD
+		|| ! config->flap_window_ms
+		|| ! config->max_devices || config->max_devices > 0x100000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	health = calloc (1, sizeof (* health));
+	if (! health)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	health->entries = calloc (config->max_devices, sizeof (* health->entries));
+	if (! health->entries
+		|| dapi_id_map_new (config->max_devices, 0, & health->index) != AUD_SUCCESS)
+	{
+		conmon_clock_health_delete (health);
+		return AUD_ERR_NOMEMORY;
+	}
+	health->config = * config;
+	health->event_fn = event_fn;
+	health->event_context = event_context;
+
+	* health_ptr = health;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_clock_health_delete
+(
+	conmon_clock_health_t * health
+)
+{
+	if (health)
+	{
+		dapi_id_map_delete (health->index);
+		free (health->entries);
+		free (health);
+	}
+}
+
+
+aud_error_t
+conmon_clock_health_update_clocking
+(
+	conmon_clock_health_t * health,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms,
+	const conmon_aud_decoded_clocking_status_t * status
+)
+{
+	clock_health_entry_t * entry = find_or_add_entry (health, instance_id, now_ms);
+	conmon_clock_device_t * device;
+	aud_bool_t baseline;
+
+	if (! entry)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	device = & entry->device;
+	health->num_updates++;
+	device->num_updates++;
+	device->last_update_ms = now_ms;
+
+	baseline = first_seen (entry, CLOCK_SEEN_CLOCKING);
+	if (baseline)
+	{
+		device->mute_flags = status->mute_flags;
+		device->ext_wc_state = status->ext_wc_state;
+		device->preferred = (status->clock_preferred != AUD_FALSE);
+	}
+	if (status->mute_flags != device->mute_flags)
+	{
+		raise_event (health, CONMON_CLOCK_EVENT_MUTE, entry, device->mute_flags, status->mute_flags, now_ms);
+		device->mute_flags = status->mute_flags;
+		device->num_mute_changes++;
+	}
+	if (status->ext_wc_state != device->ext_wc_state)
+	{
+		raise_event (health, CONMON_CLOCK_EVENT_EXT_WC, entry, device->ext_wc_state, status->ext_wc_state, now_ms);
+		device->ext_wc_state = status->ext_wc_state;
+	}
+	if ((status->clock_preferred != AUD_FALSE) != device->preferred)
+	{
+		device->preferred = ! device->preferred;
+		raise_event (health, CONMON_CLOCK_EVENT_PREFERRED, entry, ! device->preferred, device->preferred, now_ms);
+	}
+
+	device->master_ports = master_port_mask (status->port_states, status->ports_decoded, status->ports_valid);
+	update_master (health, entry, baseline, now_ms);
+	update_grandmaster (health, entry, status->grandmaster_uuid, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_clock_health_update_unicast
+(
+	conmon_clock_health_t * health,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms,
+	const conmon_aud_decoded_unicast_clocking_status_t * status
+)
+{
+	clock_health_entry_t * entry = find_or_add_entry (health, instance_id, now_ms);
+	uint32_t mask = 0;
+	unsigned int p;
+
+	if (! entry)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	health->num_updates++;
+	entry->device.num_updates++;
+	entry->device.last_update_ms = now_ms;
+
+	for (p = 0; p < status->ports_decoded; p++)
+	{
+		if ((status->ports_valid & (1u << p))
+			&& status->ports [p].port_state == CONMON_AUDINATE_PORT_STATE_MASTER)
+		{
+			mask |= (1u << p);
+		}
+	}
+	entry->device.unicast_master_ports = mask;
+	update_master (health, entry, first_seen (entry, CLOCK_SEEN_UNICAST), now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_clock_health_update_master
+(
+	conmon_clock_health_t * health,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms,
+	const conmon_aud_decoded_master_status_t * status
+)
+{
+	clock_health_entry_t * entry = find_or_add_entry (health, instance_id, now_ms);
+
+	if (! entry)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	health->num_updates++;
+	entry->device.num_updates++;
+	entry->device.last_update_ms = now_ms;
+
+	// master status describes the same multicast ports as clocking status
+	entry->device.master_ports =
+		master_port_mask (status->port_states, status->ports_decoded, 0xFFFFFFFFu);
+	update_master (health, entry, first_seen (entry, CLOCK_SEEN_MASTER), now_ms);
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_clock_health_advance
+(
+	conmon_clock_health_t * health,
+	uint64_t now_ms
+)
+{
+	unsigned int i;
+
+	for (i = 0; i < health->num_entries; i++)
+	{
+		clock_health_entry_t * entry = health->entries + i;
+
+		if (entry->device.flapping
+			&& now_ms - entry->device.master_since_ms > health->config.flap_window_ms)
+		{
+			entry->device.flapping = AUD_FALSE;
+			// start counting afresh so one more change doesn't report flapping again
+			entry->num_changes = 0;
+			entry->next_change = 0;
+			raise_event (health, CONMON_CLOCK_EVENT_FLAPPING, entry, AUD_TRUE, AUD_FALSE, now_ms);
+		}
+	}
+}
+
+
+const conmon_clock_device_t *
+conmon_clock_health_device_at_index
+(
+	const conmon_clock_health_t * health,
+	unsigned int index
+)
+{
+	return (index < health->num_entries) ? & health->entries [index].device : NULL;
+}
+
+
+void
+conmon_clock_health_get_summary
+(
+	const conmon_clock_health_t * health,
+	conmon_clock_health_summary_t * summary
+)
+{
+	unsigned int i;
+
+	memset (summary, 0, sizeof (* summary));
+	for (i = 0; i < health->num_entries; i++)
+	{
+		const conmon_clock_device_t * device = & health->entries [i].device;
+
+		summary->num_masters += device->master ? 1 : 0;
+		summary->num_preferred += device->preferred ? 1 : 0;
+		summary->num_muted += device->mute_flags ? 1 : 0;
+		summary->num_flapping += device->flapping ? 1 : 0;
+	}
+	summary->num_devices = health->num_entries;
+	summary->have_grandmaster = health->have_grandmaster;
+	summary->grandmaster_uuid = health->grandmaster_uuid;
+	summary->num_grandmaster_changes = health->num_grandmaster_changes;
+	summary->num_updates = health->num_updates;
+	memcpy (summary->num_events, health->num_events, sizeof (summary->num_events));
+}
+
+
+const char *
+conmon_clock_event_type_to_string
+(
+	conmon_clock_event_type_t type
+)
+{
+	switch (type)
+	{
+	case CONMON_CLOCK_EVENT_NEW_DEVICE:  return "NEW";
+	case CONMON_CLOCK_EVENT_MUTE:        return "MUTE";
+	case CONMON_CLOCK_EVENT_EXT_WC:      return "EXT_WC";
+	case CONMON_CLOCK_EVENT_PREFERRED:   return "PREFERRED";
+	case CONMON_CLOCK_EVENT_MASTER:      return "MASTER";
+	case CONMON_CLOCK_EVENT_FLAPPING:    return "FLAPPING";
+	case CONMON_CLOCK_EVENT_GRANDMASTER: return "GRANDMASTER";
+	default:                             return "???";
+	}
+}
+
+
+const char *
+conmon_clock_ext_wc_state_to_string
+(
+	uint16_t ext_wc_state
+)
+{
+	return (ext_wc_state < sizeof (k_ext_wc_state_names) / sizeof (k_ext_wc_state_names [0]))
+		? k_ext_wc_state_names [ext_wc_state] : "???";
+}
+
+
+//----------
@@ -0,0 +1,221 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Track clock and PTP health of devices from clocking status messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_CLOCK_HEALTH_H
+#define _CONMON_CLOCK_HEALTH_H
+
+
+//----------
+// Include
+
+#include "conmon_aud_decode_msg.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The tracker keeps the last known clock state of each device that has
+	sent a CLOCKING_STATUS, UNICAST_CLOCKING_STATUS or MASTER_STATUS message
+	and reports only what changed: mute flags, external word clock state,
+	the preferred flag, whether the device is a PTP master on any port, and
+	the grandmaster it follows. The first status of each kind from a device
+	is its baseline and raises no change events.
+
+	A device that changes master state flap_threshold times within
+	flap_window_ms is reported as flapping, and reported again when it has
+	been stable for flap_window_ms. A grandmaster change is reported once
+	for the network, by the first device to follow the new grandmaster,
+	rather than once per device.
+
+	Times are supplied by the caller in milliseconds from any monotonic
+	clock.
+ */
+
+enum
+{
+	CONMON_CLOCK_HEALTH_MAX_FLAP_THRESHOLD = 32
+};
+
+typedef struct conmon_clock_health conmon_clock_health_t;
+
+typedef enum conmon_clock_event_type
+{
+	CONMON_CLOCK_EVENT_NEW_DEVICE = 0,
+		// first clock status from a device
+	CONMON_CLOCK_EVENT_MUTE,
+		// values are mute flags
+	CONMON_CLOCK_EVENT_EXT_WC,
+		// values are external word clock states
+	CONMON_CLOCK_EVENT_PREFERRED,
+	CONMON_CLOCK_EVENT_MASTER,
+	CONMON_CLOCK_EVENT_FLAPPING,
+	CONMON_CLOCK_EVENT_GRANDMASTER,
+		// device is the first to follow a new grandmaster, values are unused
+	CONMON_NUM_CLOCK_EVENTS
+} conmon_clock_event_type_t;
+
+typedef struct conmon_clock_health_config
+{
+	unsigned int flap_window_ms;
+	unsigned int flap_threshold;
+		// master changes within the window, at most CONMON_CLOCK_HEALTH_MAX_FLAP_THRESHOLD
+	unsigned int max_devices;
+} conmon_clock_health_config_t;
+
+typedef struct conmon_clock_device
+{
+	conmon_instance_id_t instance_id;
+	uint16_t mute_flags;
+	uint16_t ext_wc_state;
+	aud_bool_t preferred;
+	aud_bool_t master;
+	aud_bool_t flapping;
+	uint32_t master_ports;
+		// multicast ports in the MASTER state, from clocking or master status
+	uint32_t unicast_master_ports;
+	aud_bool_t have_grandmaster;
+	conmon_audinate_clock_uuid_t grandmaster_uuid;
+	uint64_t last_update_ms;
+	uint64_t master_since_ms;
+		// when master last changed
+	unsigned long num_updates;
+	unsigned long num_master_changes;
+	unsigned long num_mute_changes;
+} conmon_clock_device_t;
+
+typedef struct conmon_clock_event
+{
+	conmon_clock_event_type_t type;
+	const conmon_clock_device_t * device;
+	uint32_t old_value;
+	uint32_t new_value;
+	uint64_t time_ms;
+} conmon_clock_event_t;
+
+typedef void
+conmon_clock_health_event_fn
+(
+	void * context,
+	const conmon_clock_event_t * event
+);
+
+typedef struct conmon_clock_health_summary
+{
+	unsigned int num_devices;
+	unsigned int num_masters;
+	unsigned int num_preferred;
+	unsigned int num_muted;
+	unsigned int num_flapping;
+	aud_bool_t have_grandmaster;
+	conmon_audinate_clock_uuid_t grandmaster_uuid;
+	unsigned long num_grandmaster_changes;
+	unsigned long num_updates;
+	unsigned long num_events [CONMON_NUM_CLOCK_EVENTS];
+} conmon_clock_health_summary_t;
+
+
+//----------
+// Functions
+
+// Fill in defaults: flapping at 4 master changes within 60 s, 1024 devices
+void
+conmon_clock_health_config_init
+(
+	conmon_clock_health_config_t * config
+);
+
+aud_error_t
+conmon_clock_health_new
+(
+	const conmon_clock_health_config_t * config,
+	conmon_clock_health_event_fn * event_fn,
+	void * event_context,
+	conmon_clock_health_t ** health_ptr
+);
+
+void
+conmon_clock_health_delete
+(
+	conmon_clock_health_t * health
+);
+
+/*
+	Update a device from a decoded status message. Events are raised from
+	within these calls.
+
+	@return AUD_ERR_NOBUFS if this is a new device and max_devices are already tracked
+ */
+aud_error_t
+conmon_clock_health_update_clocking
+(
+	conmon_clock_health_t * health,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms,
+	const conmon_aud_decoded_clocking_status_t * status
+);
+
+aud_error_t
+conmon_clock_health_update_unicast
+(
+	conmon_clock_health_t * health,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms,
+	const conmon_aud_decoded_unicast_clocking_status_t * status
+);
+
+aud_error_t
+conmon_clock_health_update_master
+(
+	conmon_clock_health_t * health,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms,
+	const conmon_aud_decoded_master_status_t * status
+);
+
+// Report devices that have stopped flapping; call about once a second
+void
+conmon_clock_health_advance
+(
+	conmon_clock_health_t * health,
+	uint64_t now_ms
+);
+
+// Devices are never removed, so index runs from 0 to num_devices - 1 in order of first update
+const conmon_clock_device_t *
+conmon_clock_health_device_at_index
+(
+	const conmon_clock_health_t * health,
+	unsigned int index
+);
+
+void
+conmon_clock_health_get_summary
+(
+	const conmon_clock_health_t * health,
+	conmon_clock_health_summary_t * summary
+);
+
+const char *
+conmon_clock_event_type_to_string
+(
+	conmon_clock_event_type_t type
+);
+
+const char *
+conmon_clock_ext_wc_state_to_string
+(
+	uint16_t ext_wc_state
+);
+
+
+//----------
+
+#endif // _CONMON_CLOCK_HEALTH_H
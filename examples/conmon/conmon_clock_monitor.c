@@ -0,0 +1,568 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Report clock and PTP master changes across all devices
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_clock_health.h"
+#include "conmon_name_cache.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	CLOCK_MONITOR_NAME_CACHE_SIZE = 2048
+};
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static conmon_clock_health_t * g_health = NULL;
+static conmon_name_cache_t * g_names = NULL;
+static aud_bool_t g_full_reported = AUD_FALSE;
+static aud_bool_t g_show_new = AUD_FALSE;
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_ms (void)
+{
+	return conmon_example_clock_ns () / 1000000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+static const char *
+device_name (const conmon_instance_id_t * instance_id)
+{
+	const char * name = conmon_name_cache_lookup (g_names, instance_id)->device_name;
+	return name ? name : "[unknown device]";
+}
+
+
+static const char *
+uuid_to_string (const conmon_audinate_clock_uuid_t * uuid, char * buf, size_t len)
+{
+	SNPRINTF (buf, len, "%02x%02x%02x%02x%02x%02x"
+		, uuid->data[0], uuid->data[1], uuid->data[2], uuid->data[3], uuid->data[4], uuid->data[5]);
+	return buf;
+}
+
+
+static void
+handle_clock_event
+(
+	void * context,
+	const conmon_clock_event_t * event
+)
+{
+	const conmon_clock_device_t * device = event->device;
+	aud_ctime_buf_t time_buf;
+	char uuid_buf [16];
+
+	AUD_UNUSED (context);
+
+	if (event->type == CONMON_CLOCK_EVENT_NEW_DEVICE && ! g_show_new)
+	{
+		return;
+	}
+
+	// one line per event, so that the output can be filtered by field
+	printf ("#CLOCK %s %-11s '%s'"
+		, aud_utime_ctime_no_newline (NULL, time_buf)
+		, conmon_clock_event_type_to_string (event->type)
+		, device_name (& device->instance_id)
+	);
+	switch (event->type)
+	{
+	case CONMON_CLOCK_EVENT_MUTE:
+		printf (" 0x%04x -> 0x%04x\n", event->old_value, event->new_value);
+		break;
+	case CONMON_CLOCK_EVENT_EXT_WC:
+		printf (" %s -> %s\n"
+			, conmon_clock_ext_wc_state_to_string ((uint16_t) event->old_value)
+			, conmon_clock_ext_wc_state_to_string ((uint16_t) event->new_value)
+		);
+		break;
+	case CONMON_CLOCK_EVENT_MASTER:
+		printf (" %s (%lu changes)%s\n"
+			, event->new_value ? "became master" : "no longer master"
+			, device->num_master_changes
+			, device->flapping ? " FLAPPING" : ""
+		);
+		break;
+	case CONMON_CLOCK_EVENT_PREFERRED:
+	case CONMON_CLOCK_EVENT_FLAPPING:
+		printf (" %s\n", event->new_value ? "on" : "off");
+		break;
+	case CONMON_CLOCK_EVENT_GRANDMASTER:
+		printf (" now follows %s\n", uuid_to_string (& device->grandmaster_uuid, uuid_buf, sizeof (uuid_buf)));
+		break;
+	default:
+		putchar ('\n');
+		break;
+	}
+	fflush (stdout);
+}
+
+
+static void
+print_summary (aud_bool_t verbose)
+{
+	const uint64_t now = now_ms ();
+	const conmon_clock_device_t * device;
+	conmon_clock_health_summary_t summary;
+	char uuid_buf [16];
+	unsigned int i;
+
+	conmon_clock_health_get_summary (g_health, & summary);
+	printf ("#SUMMARY %u devices, %u masters, %u preferred, %u muted, %u flapping; grandmaster %s, %lu changes\n"
+		, summary.num_devices, summary.num_masters, summary.num_preferred
+		, summary.num_muted, summary.num_flapping
+		, summary.have_grandmaster ? uuid_to_string (& summary.grandmaster_uuid, uuid_buf, sizeof (uuid_buf)) : "unknown"
+		, summary.num_grandmaster_changes
+	);
+	if (summary.num_preferred > 1)
+	{
+		printf ("#SUMMARY warning: %u devices are set as preferred master\n", summary.num_preferred);
+	}
+	if (! verbose)
+	{
+		fflush (stdout);
+		return;
+	}
+	for (i = 0; (device = conmon_clock_health_device_at_index (g_health, i)) != NULL; i++)
+	{
+		printf ("  %-32s %-6s%s%s mute=0x%04x wc=%s, %lu master changes, last %u s ago, %lu updates\n"
+			, device_name (& device->instance_id)
+			, device->master ? "MASTER" : "slave"
+			, device->preferred ? " preferred" : ""
+			, device->flapping ? " FLAPPING" : ""
+			, device->mute_flags
+			, conmon_clock_ext_wc_state_to_string (device->ext_wc_state)
+			, device->num_master_changes
+			, (unsigned int) ((now - device->master_since_ms) / 1000)
+			, device->num_updates
+		);
+	}
+	fflush (stdout);
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_clock_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	conmon_aud_decoded_msg_t decoded;
+	conmon_instance_id_t instance_id;
+	aud_error_t result;
+	uint16_t type;
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+
+	if (!conmon_vendor_id_equals (conmon_message_head_get_vendor_id (head), CONMON_VENDOR_ID_AUDINATE))
+	{
+		return;
+	}
+	type = conmon_audinate_message_get_type (body);
+	if (type != CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_STATUS
+		&& type != CONMON_AUDINATE_MESSAGE_TYPE_UNICAST_CLOCKING_STATUS
+		&& type != CONMON_AUDINATE_MESSAGE_TYPE_MASTER_STATUS)
+	{
+		return;
+	}
+
+	result = conmon_aud_decode_msg (body, conmon_message_head_get_body_size (head), & decoded);
+	if (result != AUD_SUCCESS && result != AUD_ERR_TRUNCATED)
+	{
+		return;
+	}
+
+	conmon_message_head_get_instance_id (head, & instance_id);
+	switch (type)
+	{
+	case CONMON_AUDINATE_MESSAGE_TYPE_CLOCKING_STATUS:
+		result = conmon_clock_health_update_clocking (g_health, & instance_id, now_ms (), & decoded.u.clocking_status);
+		break;
+	case CONMON_AUDINATE_MESSAGE_TYPE_UNICAST_CLOCKING_STATUS:
+		result = conmon_clock_health_update_unicast (g_health, & instance_id, now_ms (), & decoded.u.unicast_clocking_status);
+		break;
+	default:
+		result = conmon_clock_health_update_master (g_health, & instance_id, now_ms (), & decoded.u.master_status);
+		break;
+	}
+	if (result == AUD_ERR_NOBUFS && ! g_full_reported)
+	{
+		fprintf (stderr, "Device table is full, new devices will not be tracked (see -max)\n");
+		g_full_reported = AUD_TRUE;
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (num_changes);
+	AUD_UNUSED (changes);
+
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Main
+
+static void
+usage (const char * bin)
+{
+	conmon_clock_health_config_t defaults;
+
+	conmon_clock_health_config_init (& defaults);
+	printf ("Usage: %s [-p=PORT] [-window=MS] [-flaps=N] [-max=N] [-summary=SEC] [-new]\n", bin);
+	printf ("  Report clock state changes and PTP master flapping across all devices\n");
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -window=MS, -flaps=N: report a device as flapping after N master changes\n"
+		"      within MS milliseconds (default %u changes in %u ms)\n",
+		defaults.flap_threshold, defaults.flap_window_ms);
+	printf ("  -max=N: track at most N devices (default %u)\n", defaults.max_devices);
+	printf ("  -summary=SEC: print a one line summary every SEC seconds\n");
+	printf ("  -new: also report each device the first time it is seen\n");
+	printf ("  Ctrl-C prints the state of all devices and exits\n");
+}
+
+
+int
+main (int argc, char * argv[])
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	conmon_clock_health_config_t health_config;
+	dante_sockets_t sockets;
+	uint16_t server_port = 0;
+	unsigned int summary_s = 0;
+	uint64_t next_summary_ms = 0, next_advance_ms = 0;
+	int a;
+
+	conmon_clock_health_config_init (& health_config);
+
+	for (a = 1; a < argc; a++)
+	{
+		const char * arg = argv[a];
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if (!strncmp (arg, "-window=", 8) && strlen (arg) > 8)
+		{
+			health_config.flap_window_ms = (unsigned int) atoi (arg + 8);
+		}
+		else if (!strncmp (arg, "-flaps=", 7) && strlen (arg) > 7)
+		{
+			health_config.flap_threshold = (unsigned int) atoi (arg + 7);
+		}
+		else if (!strncmp (arg, "-max=", 5) && strlen (arg) > 5)
+		{
+			health_config.max_devices = (unsigned int) atoi (arg + 5);
+		}
+		else if (!strncmp (arg, "-summary=", 9) && strlen (arg) > 9)
+		{
+			summary_s = (unsigned int) atoi (arg + 9);
+		}
+		else if (!strcmp (arg, "-new"))
+		{
+			g_show_new = AUD_TRUE;
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+
+	result = conmon_clock_health_new (& health_config, & handle_clock_event, NULL, & g_health);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Invalid settings: need 2 <= flaps <= %u and a non-zero window: %s\n",
+			CONMON_CLOCK_HEALTH_MAX_FLAP_THRESHOLD, aud_error_message (result, errbuf));
+		usage (argv[0]);
+		exit (1);
+	}
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	config = conmon_client_config_new ("clock_monitor");
+	if (!config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (config, server_port);
+	}
+	result = conmon_client_new_config (env, config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, CLOCK_MONITOR_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device name cache: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// clocking status arrives on the status channel, master status is broadcast
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+			handle_clock_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result == AUD_SUCCESS)
+	{
+		result =
+			conmon_client_register_monitoring_messages (
+				client, & handle_response, & req_id,
+				CONMON_CHANNEL_TYPE_BROADCAST, CONMON_CHANNEL_DIRECTION_RX,
+				handle_clock_message
+			);
+		if (result == AUD_SUCCESS)
+		{
+			result = wait_for_response (client, & k_comms_timeout);
+		}
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for status and broadcast messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_subscribe_global (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error subscribing to status from all devices: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	printf ("Tracking clock status: flapping at %u master changes within %u ms\n"
+		, health_config.flap_threshold, health_config.flap_window_ms
+	);
+
+	// The loop runs until the user hits CTRL-C, waking once a second to
+	// notice devices that have stopped flapping and to print summaries
+	signal (SIGINT, sig_handler);
+	next_advance_ms = now_ms () + 1000;
+	if (summary_s)
+	{
+		next_summary_ms = now_ms () + summary_s * 1000;
+	}
+	while (g_running)
+	{
+		aud_utime_t timeout;
+		uint64_t now;
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& sockets);
+			conmon_client_get_sockets (client, & sockets);
+		}
+
+		timeout.tv_sec = 1;
+		timeout.tv_usec = 0;
+		conmon_example_client_process (client, & sockets, & timeout, NULL);
+
+		now = now_ms ();
+		if (now >= next_advance_ms)
+		{
+			conmon_clock_health_advance (g_health, now);
+			next_advance_ms = now + 1000;
+		}
+		if (summary_s && now >= next_summary_ms)
+		{
+			print_summary (AUD_FALSE);
+			next_summary_ms = now + summary_s * 1000;
+		}
+	}
+
+	print_summary (AUD_TRUE);
+	result = AUD_SUCCESS;
+
+cleanup:
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (config)
+	{
+		conmon_client_config_delete (config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	conmon_clock_health_delete (g_health);
+	return result;
+}
+
+
+//----------
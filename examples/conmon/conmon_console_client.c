@@ -1,4 +1,5 @@
 #include "conmon_examples.h"
+#include "conmon_sub_manager.h"
 
 #ifdef WIN32
 #include "conio.h"
@@ -19,6 +20,12 @@ conmon_vendor_id_t g_tx_vendor_id = {{'e', 'x', 'a', 'm', 'p', 'l', 'e', '\0'}};
 conmon_vendor_id_t * g_rx_vendor_id = NULL;
 aud_bool_t g_print_payloads = AUD_FALSE;
 
+// Bulk subscription management
+conmon_sub_manager_t * g_sub_manager = NULL;
+unsigned int g_sub_max_in_flight = 16;
+aud_bool_t g_sub_sync_active = AUD_FALSE;
+aud_utime_t g_sub_sync_start;
+
 
 typedef struct
 {
@@ -78,7 +85,8 @@ static conmon_client_handle_monitoring_message_fn handle_monitoring_message;
 
 static conmon_client_response_fn 
 	handle_connect_response,
-	handle_response;
+	handle_response,
+	handle_sub_manager_response;
 
 static void 
 handle_message
@@ -231,6 +239,11 @@ handle_subscriptions_changed
 
 	AUD_UNUSED(client);
 
+	if (g_sub_manager)
+	{
+		conmon_sub_manager_handle_subscriptions_changed(g_sub_manager, num_changes, changes);
+	}
+
 	aud_utime_get(&now);
 	printf("  %u.%u: Subscriptions changed:\n", (unsigned int) now.tv_sec, (unsigned int) now.tv_usec);
 	for (i = 0; i < num_changes; i++)
@@ -280,6 +293,123 @@ list_subscriptions(conmon_client_t * client)
 	}
 }
 
+static void
+print_sub_manager_table(void)
+{
+	unsigned int i;
+	conmon_sub_manager_stats_t stats;
+	const conmon_sub_manager_entry_t * entry;
+
+	conmon_sub_manager_get_stats(g_sub_manager, &stats);
+	printf("Managed subscriptions: %u entries, %u desired, %u queued, %u in flight\n",
+		stats.num_entries, stats.num_desired, stats.num_queued, stats.num_in_flight);
+	printf("  %lu subscribes, %lu unsubscribes, %lu failures\n",
+		stats.num_subscribes, stats.num_unsubscribes, stats.num_failures);
+	for (i = 0; (entry = conmon_sub_manager_entry_at_index(g_sub_manager, i)) != NULL; i++)
+	{
+		printf("  %u: %s@%s: %s%s status=%s",
+			i,
+			channel_type_to_string(entry->channel_type),
+			entry->device_name,
+			(entry->desired ? "desired" : "unwanted"),
+			(entry->subscribed ? " subscribed" : ""),
+			conmon_example_rxstatus_to_string(entry->rxstatus));
+		if (entry->pending != CONMON_SUB_MANAGER_OP_NONE)
+		{
+			printf(" (%s pending)", entry->pending == CONMON_SUB_MANAGER_OP_SUBSCRIBE ? "subscribe" : "unsubscribe");
+		}
+		if (entry->last_error != AUD_SUCCESS)
+		{
+			printf(" error=%s", aud_error_message(entry->last_error, g_errbuf));
+		}
+		printf("\n");
+	}
+}
+
+/*
+	Read a set of subscriptions, one "CHANNEL DEVICE" pair per line, and
+	start bringing the client's subscriptions in line with it. Subscriptions
+	to devices not in the file are removed. Blank lines and lines starting
+	with '#' are ignored.
+ */
+static aud_error_t
+sync_subscriptions_from_file(const char * filename)
+{
+	char line[BUFSIZ];
+	char channel[BUFSIZ];
+	char device_name[BUFSIZ];
+	unsigned int line_num = 0, num_queued = 0;
+	aud_error_t result = AUD_SUCCESS;
+	FILE * fp = fopen(filename, "r");
+
+	if (!fp)
+	{
+		printf("Error opening file '%s'\n", filename);
+		return AUD_ERR_NOTFOUND;
+	}
+
+	conmon_sub_manager_clear_desired(g_sub_manager);
+	while (fgets(line, sizeof(line), fp))
+	{
+		conmon_channel_type_t channel_type;
+		char * p = line;
+
+		line_num++;
+		while (isspace(*p))
+		{
+			p++;
+		}
+		if (*p == '\0' || *p == '#')
+		{
+			continue;
+		}
+		if (sscanf(p, "%s %s", channel, device_name) != 2)
+		{
+			printf("%s:%u: expected CHANNEL DEVICE\n", filename, line_num);
+			result = AUD_ERR_INVALIDDATA;
+			break;
+		}
+		channel_type = channel_type_from_string(channel);
+		result = conmon_sub_manager_add_desired(g_sub_manager, channel_type, device_name);
+		if (result != AUD_SUCCESS)
+		{
+			printf("%s:%u: can't subscribe to %s@%s: %s\n",
+				filename, line_num, channel, device_name, aud_error_message(result, g_errbuf));
+			break;
+		}
+	}
+	fclose(fp);
+
+	if (result == AUD_SUCCESS)
+	{
+		result = conmon_sub_manager_sync(g_sub_manager, &num_queued);
+	}
+	if (result == AUD_SUCCESS)
+	{
+		printf("Syncing subscriptions from '%s': %u changes needed\n", filename, num_queued);
+		aud_utime_get(&g_sub_sync_start);
+		g_sub_sync_active = AUD_TRUE;
+	}
+	return result;
+}
+
+static void
+check_sub_manager_done(void)
+{
+	if (g_sub_sync_active && !conmon_sub_manager_busy(g_sub_manager))
+	{
+		conmon_sub_manager_stats_t stats;
+		aud_utime_t now;
+
+		aud_utime_get(&now);
+		aud_utime_sub(&now, &g_sub_sync_start);
+		conmon_sub_manager_get_stats(g_sub_manager, &stats);
+		printf("  Subscription sync complete in %u.%06us, %lu failures so far\n",
+			(unsigned int) now.tv_sec, (unsigned int) now.tv_usec, stats.num_failures);
+		g_sub_sync_active = AUD_FALSE;
+	}
+}
+
 static void
 print_commands(char c)
 {
@@ -300,6 +430,11 @@ print_commands(char c)
 		printf(" [s|u] CHANNEL         subscribe to / unsubscribe from channel CHANNEL for ALL devices\n");
 		printf(" s                     list subscriptions\n");
 	}
+	if (c == '\0' || c == 'b' || c == 't')
+	{
+		printf(" b FILE                make subscriptions match the CHANNEL DEVICE pairs in FILE\n");
+		printf(" t                     list managed subscriptions and their status\n");
+	}
 	if (c == '\0' || c == 'e')
 	{
 		printf(" e +                   enable Tx Metering\n");
@@ -548,6 +683,15 @@ process_line(char * buf, conmon_client_t * client)
 			return req_id;
 		}
 	}
+	else if (sscanf(buf, "%c %s", &c, channel) == 2 && (c == 'b'))
+	{
+		result = sync_subscriptions_from_file(channel);
+		if (result != AUD_SUCCESS)
+		{
+			printf("Error syncing subscriptions: %s\n", aud_error_message(result, g_errbuf));
+		}
+		return req_id;
+	}
 	else if (sscanf(buf, "%c %c", &c, &d) == 2 && (c == 'a') && (d == '+' || d == '-'))
 	{
 		if (d == '+')
@@ -599,6 +743,11 @@ process_line(char * buf, conmon_client_t * client)
 			list_subscriptions(client);
 			return req_id;
 		}
+		else if (c == 't')
+		{
+			print_sub_manager_table();
+			return req_id;
+		}
 		else if (c == '?')
 		{
 			print_commands('\0');
@@ -726,6 +875,10 @@ main_loop(conmon_client_t * client)
 			}
 		}
 
+		// responses free up room for more subscription changes
+		conmon_sub_manager_process(g_sub_manager);
+		check_sub_manager_done();
+
 		// and check stdin 
 		buf[0] = '\0';
 #ifdef _WIN32
@@ -795,6 +948,7 @@ static void usage(char * bin)
 	printf("  -vba=A.B.C.D Set vendor broadcast channel address\n");
 	printf("  -vrx Filter rx packets by transmit vendor id\n");
 	printf("  -pp print payloads\n");
+	printf("  -bw=N keep up to N bulk subscription requests in flight (default %u)\n", g_sub_max_in_flight);
 }
 
 int main(int argc, char * argv[])
@@ -880,6 +1034,10 @@ int main(int argc, char * argv[])
 		{
 			g_print_payloads = AUD_TRUE;
 		}
+		else if (!strncmp(arg, "-bw=", 4) && atoi(arg + 4) > 0)
+		{
+			g_sub_max_in_flight = (unsigned int) atoi(arg + 4);
+		}
 		else
 		{
 			usage(argv[0]);
@@ -916,6 +1074,13 @@ int main(int argc, char * argv[])
 	conmon_client_set_dns_domain_name_changed_callback(client, handle_dns_domain_name_changed);
 	conmon_client_set_subscriptions_changed_callback(client,handle_subscriptions_changed);
 
+	result = conmon_sub_manager_new(client, handle_sub_manager_response, g_sub_max_in_flight, &g_sub_manager);
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error creating subscription manager: %s\n", aud_error_message(result, g_errbuf));
+		goto cleanup;
+	}
+
 	if (auto_connect)
 	{
 		result = conmon_client_auto_connect(client);
@@ -987,6 +1152,11 @@ int main(int argc, char * argv[])
 	main_loop(client);
 	
 cleanup:
+	if (g_sub_manager)
+	{
+		conmon_sub_manager_delete(g_sub_manager);
+		g_sub_manager = NULL;
+	}
 	if (client)
 	{
 		conmon_client_delete(client);
@@ -1040,3 +1210,20 @@ handle_response
 		g_req_id = CONMON_CLIENT_NULL_REQ_ID;
 	}
 }
+
+
+static void
+handle_sub_manager_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+) {
+	AUD_UNUSED(client);
+
+	// only report failures, there may be hundreds of these
+	if (conmon_sub_manager_handle_response(g_sub_manager, request_id, result) && result != AUD_SUCCESS)
+	{
+		printf("  Subscription request %p failed: %s\n", request_id, aud_error_message(result, g_errbuf));
+	}
+}
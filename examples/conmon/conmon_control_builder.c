@@ -0,0 +1,1440 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Build conmon audinate control messages from key=value arguments
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_control_builder.h"
+#include "conmon_examples.h"
+#include "dapi_io.h"
+
+
+//----------
+// Types and Constants
+
+#define CONGESTION_DELAY ONE_SECOND_US
+
+#define CONTROL_NO_FIELD 0xFFFFFFFFu
+#define CONTROL_NO_SPEC 0xFFFFFFFFu
+
+enum
+{
+	CONTROL_MAX_STRING = 64
+		// longest string a shape keeps a copy of to spot repeated values
+};
+
+typedef struct control_spec_info
+{
+	uint32_t hashes [CONMON_CONTROL_MAX_FIELDS];
+	uint8_t lengths [CONMON_CONTROL_MAX_FIELDS];
+	unsigned int bare_field;
+		// CONTROL_NO_FIELD if none
+} control_spec_info_t;
+
+struct conmon_control_builder
+{
+	const conmon_control_spec_t * specs;
+	unsigned int num_specs;
+	control_spec_info_t * info;
+
+	unsigned int * cmd_slots;
+		// open addressed by command hash, holding spec indexes
+	unsigned int cmd_mask;
+
+	conmon_control_stats_t stats;
+};
+
+struct conmon_control_shape
+{
+	conmon_control_builder_t * builder;
+	const conmon_control_spec_t * spec;
+	unsigned int num_fields;
+	unsigned int fields [CONMON_CONTROL_MAX_FIELDS];
+	uint32_t present;
+
+	aud_bool_t cached;
+	conmon_control_value_t last [CONMON_CONTROL_MAX_FIELDS];
+	char strings [CONMON_CONTROL_MAX_FIELDS][CONTROL_MAX_STRING + 1];
+	uint16_t body_size;
+	conmon_message_body_t body;
+
+	conmon_control_stats_t stats;
+};
+
+
+//----------
+// Local functions
+
+// FNV-1a over a name, stopping at the end of the string, '=' or ','
+static uint32_t
+control_hash (const char * str, size_t * len)
+{
+	* len = strcspn (str, "=,");
+	return dapi_fnv1a_bytes (DAPI_FNV1A_BASIS, str, * len);
+}
+
+
+static unsigned int
+control_spec_index
+(
+	const conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec
+)
+{
+	if (spec < builder->specs || spec >= builder->specs + builder->num_specs)
+	{
+		return CONTROL_NO_SPEC;
+	}
+	return (unsigned int) (spec - builder->specs);
+}
+
+
+static unsigned int
+control_find_field
+(
+	const conmon_control_builder_t * builder,
+	unsigned int spec_index,
+	const char * name,
+	size_t len,
+	uint32_t hash
+)
+{
+	const conmon_control_spec_t * spec = builder->specs + spec_index;
+	const control_spec_info_t * info = builder->info + spec_index;
+	unsigned int f;
+
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		if (info->hashes [f] == hash && info->lengths [f] == len
+			&& memcmp (spec->fields [f].name, name, len) == 0)
+		{
+			return f;
+		}
+	}
+	return CONTROL_NO_FIELD;
+}
+
+
+static aud_bool_t
+control_find_name
+(
+	const conmon_control_name_t * names,
+	const char * str,
+	int64_t * value
+)
+{
+	if (names)
+	{
+		for (; names->name; names++)
+		{
+			if (strcmp (names->name, str) == 0)
+			{
+				* value = names->value;
+				return AUD_TRUE;
+			}
+		}
+	}
+	return AUD_FALSE;
+}
+
+
+static aud_bool_t
+control_has_value
+(
+	const conmon_control_name_t * names,
+	int64_t value
+)
+{
+	if (names)
+	{
+		for (; names->name; names++)
+		{
+			if (names->value == value)
+			{
+				return AUD_TRUE;
+			}
+		}
+	}
+	return AUD_FALSE;
+}
+
+
+// Decimal with an optional sign, or 0x hex, with nothing after it
+static aud_bool_t
+control_parse_int (const char * str, int64_t * value)
+{
+	uint64_t v = 0;
+	aud_bool_t negative = AUD_FALSE;
+	const char * p = str;
+
+	if (* p == '-' || * p == '+')
+	{
+		negative = (* p == '-');
+		p++;
+	}
+	if (p [0] == '0' && (p [1] == 'x' || p [1] == 'X'))
+	{
+		const char * digits = p + 2;
+		for (p = digits; * p; p++)
+		{
+			unsigned int d;
+			if (* p >= '0' && * p <= '9')
+				d = * p - '0';
+			else if (* p >= 'a' && * p <= 'f')
+				d = * p - 'a' + 10;
+			else if (* p >= 'A' && * p <= 'F')
+				d = * p - 'A' + 10;
+			else
+				return AUD_FALSE;
+			if (p - digits >= 15)
+			{
+				return AUD_FALSE;
+			}
+			v = (v << 4) | d;
+		}
+		if (p == digits)
+		{
+			return AUD_FALSE;
+		}
+	}
+	else
+	{
+		const char * digits = p;
+		for (; * p; p++)
+		{
+			if (* p < '0' || * p > '9' || p - digits >= 18)
+			{
+				return AUD_FALSE;
+			}
+			v = v * 10 + (* p - '0');
+		}
+		if (p == digits)
+		{
+			return AUD_FALSE;
+		}
+	}
+	* value = negative ? - (int64_t) v : (int64_t) v;
+	return AUD_TRUE;
+}
+
+
+static aud_bool_t
+control_convert
+(
+	const conmon_control_field_spec_t * field,
+	const char * str,
+	conmon_control_value_t * value
+)
+{
+	size_t len;
+
+	value->i = 0;
+	value->s = NULL;
+	switch (field->type)
+	{
+	case CONMON_CONTROL_FIELD_INT:
+		if (control_find_name (field->names, str, & value->i))
+		{
+			return AUD_TRUE;
+		}
+		return control_parse_int (str, & value->i)
+			&& value->i >= field->min && value->i <= field->max;
+
+	case CONMON_CONTROL_FIELD_BOOL:
+		if (strcmp (str, "true") == 0)
+		{
+			value->i = AUD_TRUE;
+			return AUD_TRUE;
+		}
+		return strcmp (str, "false") == 0;
+
+	case CONMON_CONTROL_FIELD_ENUM:
+		return control_find_name (field->names, str, & value->i);
+
+	case CONMON_CONTROL_FIELD_STRING:
+		len = strlen (str);
+		if ((int64_t) len < field->min || (int64_t) len > field->max)
+		{
+			return AUD_FALSE;
+		}
+		value->s = str;
+		return AUD_TRUE;
+	}
+	return AUD_FALSE;
+}
+
+
+// The typed equivalent of control_convert, for values that did not come from a string
+static aud_bool_t
+control_check
+(
+	const conmon_control_field_spec_t * field,
+	const conmon_control_value_t * value
+)
+{
+	size_t len;
+
+	switch (field->type)
+	{
+	case CONMON_CONTROL_FIELD_INT:
+		return (value->i >= field->min && value->i <= field->max)
+			|| control_has_value (field->names, value->i);
+
+	case CONMON_CONTROL_FIELD_BOOL:
+		return value->i == AUD_FALSE || value->i == AUD_TRUE;
+
+	case CONMON_CONTROL_FIELD_ENUM:
+		return control_has_value (field->names, value->i);
+
+	case CONMON_CONTROL_FIELD_STRING:
+		if (! value->s)
+		{
+			return AUD_FALSE;
+		}
+		len = strlen (value->s);
+		return (int64_t) len >= field->min && (int64_t) len <= field->max;
+	}
+	return AUD_FALSE;
+}
+
+
+static aud_bool_t
+control_check_present
+(
+	const conmon_control_spec_t * spec,
+	uint32_t present
+)
+{
+	unsigned int f;
+
+	if (! present)
+	{
+		return ! (spec->flags & CONMON_CONTROL_SPEC_FLAG_NO_QUERY);
+	}
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		if ((spec->fields [f].flags & CONMON_CONTROL_FIELD_FLAG_REQUIRED)
+			&& ! (present & (1u << f)))
+		{
+			return AUD_FALSE;
+		}
+	}
+	return AUD_TRUE;
+}
+
+
+static void
+control_print_int (FILE * fp, int64_t value)
+{
+	char buf [24];
+	unsigned int i = sizeof (buf);
+	uint64_t v = value < 0 ? (uint64_t) - value : (uint64_t) value;
+
+	buf [--i] = '\0';
+	do
+	{
+		buf [--i] = (char) ('0' + v % 10);
+		v /= 10;
+	} while (v);
+	if (value < 0)
+	{
+		buf [--i] = '-';
+	}
+	fputs (buf + i, fp);
+}
+
+
+static void
+control_print_names (FILE * fp, const conmon_control_name_t * names, aud_bool_t first)
+{
+	for (; names && names->name; names++)
+	{
+		fprintf (fp, "%s%s", first ? "" : "|", names->name);
+		first = AUD_FALSE;
+	}
+}
+
+
+// Build into the shape's copy of the body, or reuse it if the values have not changed
+static void
+control_shape_build_values
+(
+	conmon_control_shape_t * shape,
+	const conmon_control_value_t * values,
+	conmon_message_body_t * body,
+	uint16_t * body_size
+)
+{
+	conmon_control_value_t spec_values [CONMON_CONTROL_MAX_FIELDS];
+	aud_bool_t same = shape->cached;
+	unsigned int i;
+
+	for (i = 0; i < shape->num_fields && same; i++)
+	{
+		if (shape->spec->fields [shape->fields [i]].type == CONMON_CONTROL_FIELD_STRING)
+		{
+			same = strcmp (values [i].s, shape->last [i].s) == 0;
+		}
+		else
+		{
+			same = values [i].i == shape->last [i].i;
+		}
+	}
+
+	shape->stats.num_builds++;
+	if (same)
+	{
+		shape->stats.num_reused++;
+	}
+	else
+	{
+		memset (spec_values, 0, sizeof (spec_values));
+		for (i = 0; i < shape->num_fields; i++)
+		{
+			spec_values [shape->fields [i]].i = values [i].i;
+			if (shape->spec->fields [shape->fields [i]].type == CONMON_CONTROL_FIELD_STRING)
+			{
+				spec_values [shape->fields [i]].s = values [i].s;
+			}
+		}
+		shape->spec->build (& shape->body, & shape->body_size, spec_values, shape->present);
+
+		// only cache values we can keep a copy of
+		shape->cached = AUD_TRUE;
+		for (i = 0; i < shape->num_fields; i++)
+		{
+			shape->last [i].i = values [i].i;
+			shape->last [i].s = NULL;
+			if (shape->spec->fields [shape->fields [i]].type == CONMON_CONTROL_FIELD_STRING)
+			{
+				size_t len = strlen (values [i].s);
+				if (len > CONTROL_MAX_STRING)
+				{
+					shape->cached = AUD_FALSE;
+					break;
+				}
+				memcpy (shape->strings [i], values [i].s, len + 1);
+				shape->last [i].s = shape->strings [i];
+			}
+		}
+	}
+	memcpy (body, & shape->body, shape->body_size);
+	* body_size = shape->body_size;
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_control_builder_new
+(
+	const conmon_control_spec_t * specs,
+	unsigned int num_specs,
+	conmon_control_builder_t ** builder_ptr
+)
+{
+	conmon_control_builder_t * builder;
+	unsigned int capacity = 8;
+	unsigned int s;
+
+	if (! (specs && num_specs && builder_ptr))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	for (s = 0; s < num_specs; s++)
+	{
+		if (specs [s].num_fields > CONMON_CONTROL_MAX_FIELDS || ! specs [s].build)
+		{
+			return AUD_ERR_INVALIDPARAMETER;
+		}
+	}
+	while (capacity < num_specs * 2)
+	{
+		capacity <<= 1;
+	}
+
+	builder = calloc (1, sizeof (* builder));
+	if (! builder)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	builder->info = calloc (num_specs, sizeof (* builder->info));
+	builder->cmd_slots = malloc (capacity * sizeof (* builder->cmd_slots));
+	if (! (builder->info && builder->cmd_slots))
+	{
+		conmon_control_builder_delete (builder);
+		return AUD_ERR_NOMEMORY;
+	}
+	builder->specs = specs;
+	builder->num_specs = num_specs;
+	builder->cmd_mask = capacity - 1;
+	// 0xFF bytes give CONTROL_NO_SPEC in every slot
+	memset (builder->cmd_slots, 0xFF, capacity * sizeof (* builder->cmd_slots));
+
+	for (s = 0; s < num_specs; s++)
+	{
+		const conmon_control_spec_t * spec = specs + s;
+		control_spec_info_t * info = builder->info + s;
+		unsigned int f;
+		size_t len;
+		uint32_t slot = control_hash (spec->cmd, & len) & builder->cmd_mask;
+
+		while (builder->cmd_slots [slot] != CONTROL_NO_SPEC)
+		{
+			slot = (slot + 1) & builder->cmd_mask;
+		}
+		builder->cmd_slots [slot] = s;
+
+		info->bare_field = CONTROL_NO_FIELD;
+		for (f = 0; f < spec->num_fields; f++)
+		{
+			info->hashes [f] = control_hash (spec->fields [f].name, & len);
+			info->lengths [f] = (uint8_t) len;
+			if (spec->fields [f].flags & CONMON_CONTROL_FIELD_FLAG_BARE)
+			{
+				info->bare_field = f;
+			}
+		}
+	}
+
+	* builder_ptr = builder;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_control_builder_delete
+(
+	conmon_control_builder_t * builder
+)
+{
+	if (builder)
+	{
+		free (builder->info);
+		free (builder->cmd_slots);
+		free (builder);
+	}
+}
+
+
+const conmon_control_spec_t *
+conmon_control_builder_find
+(
+	const conmon_control_builder_t * builder,
+	const char * cmd
+)
+{
+	size_t len;
+	uint32_t slot = control_hash (cmd, & len) & builder->cmd_mask;
+
+	while (builder->cmd_slots [slot] != CONTROL_NO_SPEC)
+	{
+		const conmon_control_spec_t * spec = builder->specs + builder->cmd_slots [slot];
+		if (strcmp (spec->cmd, cmd) == 0)
+		{
+			return spec;
+		}
+		slot = (slot + 1) & builder->cmd_mask;
+	}
+	return NULL;
+}
+
+
+aud_error_t
+conmon_control_builder_parse
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	int argc,
+	char * const * argv,
+	conmon_control_value_t * values,
+	uint32_t * present_ptr,
+	const char ** bad_arg
+)
+{
+	unsigned int spec_index = control_spec_index (builder, spec);
+	uint32_t present = 0;
+	int a;
+
+	if (bad_arg)
+	{
+		* bad_arg = NULL;
+	}
+	if (spec_index == CONTROL_NO_SPEC || argc < 0)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	memset (values, 0, CONMON_CONTROL_MAX_FIELDS * sizeof (* values));
+
+	for (a = 0; a < argc; a++)
+	{
+		const char * arg = argv [a];
+		size_t len;
+		uint32_t hash = control_hash (arg, & len);
+		unsigned int f = control_find_field (builder, spec_index, arg, len, hash);
+		aud_bool_t ok;
+
+		if (arg [len] == '=')
+		{
+			ok = (f != CONTROL_NO_FIELD)
+				&& control_convert (spec->fields + f, arg + len + 1, values + f);
+		}
+		else if (! arg [len] && f != CONTROL_NO_FIELD && spec->fields [f].type == CONMON_CONTROL_FIELD_BOOL)
+		{
+			values [f].i = AUD_TRUE;
+			ok = AUD_TRUE;
+		}
+		else
+		{
+			f = builder->info [spec_index].bare_field;
+			ok = (f != CONTROL_NO_FIELD)
+				&& control_find_name (spec->fields [f].names, arg, & values [f].i);
+		}
+
+		if (! ok || (present & (1u << f)))
+		{
+			builder->stats.num_rejected++;
+			if (bad_arg)
+			{
+				* bad_arg = arg;
+			}
+			return AUD_ERR_INVALIDPARAMETER;
+		}
+		present |= 1u << f;
+	}
+
+	if (! control_check_present (spec, present))
+	{
+		builder->stats.num_rejected++;
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	* present_ptr = present;
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_control_builder_build
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	int argc,
+	char * const * argv,
+	conmon_message_body_t * body,
+	uint16_t * body_size,
+	const char ** bad_arg
+)
+{
+	conmon_control_value_t values [CONMON_CONTROL_MAX_FIELDS];
+	uint32_t present;
+	aud_error_t result;
+
+	result = conmon_control_builder_parse (builder, spec, argc, argv, values, & present, bad_arg);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	builder->stats.num_builds++;
+	spec->build (body, body_size, values, present);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_control_builder_build_values
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	const conmon_control_value_t * values,
+	uint32_t present,
+	conmon_message_body_t * body,
+	uint16_t * body_size
+)
+{
+	conmon_control_value_t spec_values [CONMON_CONTROL_MAX_FIELDS];
+	unsigned int f;
+
+	if (control_spec_index (builder, spec) == CONTROL_NO_SPEC
+		|| (present >> spec->num_fields)
+		|| ! control_check_present (spec, present))
+	{
+		builder->stats.num_rejected++;
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	// build functions expect absent fields to be zero
+	memset (spec_values, 0, sizeof (spec_values));
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		if (! (present & (1u << f)))
+		{
+			continue;
+		}
+		if (! control_check (spec->fields + f, values + f))
+		{
+			builder->stats.num_rejected++;
+			return AUD_ERR_INVALIDPARAMETER;
+		}
+		spec_values [f] = values [f];
+	}
+	builder->stats.num_builds++;
+	spec->build (body, body_size, spec_values, present);
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_control_builder_print_usage
+(
+	FILE * fp,
+	const char * bin,
+	const conmon_control_spec_t * spec
+)
+{
+	unsigned int f;
+
+	fprintf (fp, "%s controlled_device %s", bin, spec->cmd);
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		const conmon_control_field_spec_t * field = spec->fields + f;
+		aud_bool_t required = (field->flags & CONMON_CONTROL_FIELD_FLAG_REQUIRED) != 0;
+
+		fputs (required ? " " : " [", fp);
+		if (field->flags & CONMON_CONTROL_FIELD_FLAG_BARE)
+		{
+			control_print_names (fp, field->names, AUD_TRUE);
+		}
+		else
+		{
+			fprintf (fp, "%s", field->name);
+			switch (field->type)
+			{
+			case CONMON_CONTROL_FIELD_INT:
+				fputc ('=', fp);
+				control_print_int (fp, field->min);
+				fputs ("..", fp);
+				control_print_int (fp, field->max);
+				control_print_names (fp, field->names, AUD_FALSE);
+				break;
+			case CONMON_CONTROL_FIELD_BOOL:
+				fputs ("[=true|false]", fp);
+				break;
+			case CONMON_CONTROL_FIELD_ENUM:
+				fputc ('=', fp);
+				control_print_names (fp, field->names, AUD_TRUE);
+				break;
+			case CONMON_CONTROL_FIELD_STRING:
+				fputs ("=STRING", fp);
+				break;
+			}
+		}
+		if (! required)
+		{
+			fputc (']', fp);
+		}
+	}
+	fputc ('\n', fp);
+}
+
+
+void
+conmon_control_builder_get_stats
+(
+	const conmon_control_builder_t * builder,
+	conmon_control_stats_t * stats
+)
+{
+	* stats = builder->stats;
+}
+
+
+aud_error_t
+conmon_control_shape_new
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	const char * names,
+	conmon_control_shape_t ** shape_ptr
+)
+{
+	conmon_control_shape_t * shape;
+	unsigned int spec_index;
+	const char * name = names;
+
+	if (! (builder && spec && names && shape_ptr))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	spec_index = control_spec_index (builder, spec);
+	if (spec_index == CONTROL_NO_SPEC)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	shape = calloc (1, sizeof (* shape));
+	if (! shape)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	shape->builder = builder;
+	shape->spec = spec;
+
+	while (* name)
+	{
+		size_t len;
+		uint32_t hash = control_hash (name, & len);
+		unsigned int f = control_find_field (builder, spec_index, name, len, hash);
+
+		if (f == CONTROL_NO_FIELD || (shape->present & (1u << f)) || name [len] == '=')
+		{
+			conmon_control_shape_delete (shape);
+			return AUD_ERR_INVALIDPARAMETER;
+		}
+		shape->fields [shape->num_fields++] = f;
+		shape->present |= 1u << f;
+
+		name += len;
+		if (* name == ',')
+		{
+			name++;
+		}
+	}
+	if (! control_check_present (spec, shape->present))
+	{
+		conmon_control_shape_delete (shape);
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	* shape_ptr = shape;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_control_shape_delete
+(
+	conmon_control_shape_t * shape
+)
+{
+	free (shape);
+}
+
+
+unsigned int
+conmon_control_shape_num_fields
+(
+	const conmon_control_shape_t * shape
+)
+{
+	return shape->num_fields;
+}
+
+
+aud_error_t
+conmon_control_shape_build
+(
+	conmon_control_shape_t * shape,
+	const conmon_control_value_t * values,
+	conmon_message_body_t * body,
+	uint16_t * body_size
+)
+{
+	unsigned int i;
+
+	for (i = 0; i < shape->num_fields; i++)
+	{
+		if (! control_check (shape->spec->fields + shape->fields [i], values + i))
+		{
+			shape->stats.num_rejected++;
+			return AUD_ERR_INVALIDPARAMETER;
+		}
+	}
+	control_shape_build_values (shape, values, body, body_size);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_control_shape_build_strings
+(
+	conmon_control_shape_t * shape,
+	const char * const * strings,
+	conmon_message_body_t * body,
+	uint16_t * body_size
+)
+{
+	conmon_control_value_t values [CONMON_CONTROL_MAX_FIELDS];
+	unsigned int i;
+
+	for (i = 0; i < shape->num_fields; i++)
+	{
+		if (! control_convert (shape->spec->fields + shape->fields [i], strings [i], values + i))
+		{
+			shape->stats.num_rejected++;
+			return AUD_ERR_INVALIDPARAMETER;
+		}
+	}
+	control_shape_build_values (shape, values, body, body_size);
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_control_shape_get_stats
+(
+	const conmon_control_shape_t * shape,
+	conmon_control_stats_t * stats
+)
+{
+	* stats = shape->stats;
+}
+
+
+//----------
+// Audinate specs
+
+#define FIELD_SET(F) (present & (1u << (F)))
+
+#define BOOL_FIELD(NAME) \
+	{ NAME, CONMON_CONTROL_FIELD_BOOL, 0, 0, 1, NULL }
+#define U16_FIELD(NAME, FLAGS) \
+	{ NAME, CONMON_CONTROL_FIELD_INT, FLAGS, 0, 0xFFFF, NULL }
+#define ENUM_FIELD(NAME, FLAGS, NAMES) \
+	{ NAME, CONMON_CONTROL_FIELD_ENUM, FLAGS, 0, 0, NAMES }
+#define STRING_FIELD(NAME, MAX) \
+	{ NAME, CONMON_CONTROL_FIELD_STRING, 0, 0, MAX, NULL }
+
+#define SPEC(CMD, TYPE, FLAGS, FIELDS, BUILD) \
+	{ CMD, CONMON_AUDINATE_MESSAGE_TYPE_ ## TYPE, FLAGS, \
+		sizeof (FIELDS) / sizeof (FIELDS [0]), FIELDS, BUILD }
+
+
+static const conmon_control_field_spec_t k_switch_vlan_fields [] =
+{
+	U16_FIELD ("id", 0)
+};
+
+static void
+build_switch_vlan (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_switch_vlan_control (body, 0);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_switch_vlan_control_set_config_id (body, (uint16_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_switch_vlan_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_clock_sources [] =
+{
+	{ "int", CONMON_AUDINATE_CLOCK_SOURCE_INTERNAL },
+	{ "bnc", CONMON_AUDINATE_CLOCK_SOURCE_BNC },
+	{ "aes", CONMON_AUDINATE_CLOCK_SOURCE_AES },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_clocking_fields [] =
+{
+	ENUM_FIELD ("src", 0, k_clock_sources),
+	BOOL_FIELD ("pref"),
+	BOOL_FIELD ("udelay"),
+	STRING_FIELD ("subdomain", CONMON_NAME_LENGTH - 1),
+	BOOL_FIELD ("enabled"),
+	BOOL_FIELD ("slave_only")
+};
+
+static void
+build_clocking (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_clocking_control (body, 0);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_clocking_control_set_source (body, (uint16_t) values [0].i);
+	}
+	if (FIELD_SET (1))
+	{
+		conmon_audinate_clocking_control_set_preferred (body, (uint8_t) values [1].i);
+	}
+	if (FIELD_SET (2))
+	{
+		conmon_audinate_clocking_control_set_unicast_delay_requests (body, (aud_bool_t) values [2].i);
+	}
+	if (FIELD_SET (3))
+	{
+		// an empty name goes back to the default subdomain
+		conmon_audinate_clocking_control_set_subdomain_name (body, values [3].s [0] ? values [3].s : NULL);
+	}
+	if (FIELD_SET (4))
+	{
+		conmon_audinate_clocking_control_set_multicast_ports_enabled (body, (aud_bool_t) values [4].i);
+	}
+	if (FIELD_SET (5))
+	{
+		conmon_audinate_clocking_control_set_slave_only_enabled (body, (aud_bool_t) values [5].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_clocking_control_get_size (body);
+}
+
+
+static const conmon_control_field_spec_t k_unicast_clocking_fields [] =
+{
+	BOOL_FIELD ("enabled"),
+	BOOL_FIELD ("reload")
+};
+
+static void
+build_unicast_clocking (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_unicast_clocking_control (body, 0);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_unicast_clocking_control_set_enabled (body, (aud_bool_t) values [0].i);
+	}
+	if (FIELD_SET (1) && values [1].i)
+	{
+		conmon_audinate_unicast_clocking_control_set_reload_devices (body, AUD_TRUE);
+	}
+	* body_size = (uint16_t) conmon_audinate_unicast_clocking_control_get_size (body);
+}
+
+
+static const conmon_control_field_spec_t k_ifstats_fields [] =
+{
+	BOOL_FIELD ("clear")
+};
+
+static void
+build_ifstats (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_ifstats_control (body, 0);
+	if (FIELD_SET (0) && values [0].i)
+	{
+		conmon_audinate_ifstats_control_set_clear_errors (body);
+	}
+	* body_size = (uint16_t) conmon_audinate_ifstats_control_get_size (body);
+}
+
+
+static const conmon_control_field_spec_t k_igmp_fields [] =
+{
+	{ "vers", CONMON_CONTROL_FIELD_INT, 0, 1, 3, NULL }
+};
+
+static void
+build_igmp (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_igmp_version_control (body, CONGESTION_DELAY);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_igmp_version_control_set_version (body, (uint16_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_igmp_version_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_srates [] =
+{
+	{ "44100", CONMON_AUDINATE_SRATE_44K },
+	{ "48000", CONMON_AUDINATE_SRATE_48K },
+	{ "88200", CONMON_AUDINATE_SRATE_88K },
+	{ "96000", CONMON_AUDINATE_SRATE_96K },
+	{ "176400", CONMON_AUDINATE_SRATE_176K },
+	{ "192000", CONMON_AUDINATE_SRATE_192K },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_srate_fields [] =
+{
+	ENUM_FIELD ("rate", 0, k_srates)
+};
+
+static void
+build_srate (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_srate_control (body, 0);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_srate_control_set_rate (body, (uint32_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_srate_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_encodings [] =
+{
+	{ "pcm24", 24 },
+	{ "raw32", 0x1300 },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_enc_fields [] =
+{
+	{ "enc", CONMON_CONTROL_FIELD_INT, 0, 1, 0xFFFF, k_encodings }
+};
+
+static void
+build_enc (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_enc_control (body, 0);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_enc_control_set_encoding (body, (uint16_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_enc_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_pullups [] =
+{
+	{ "0", CONMON_AUDINATE_SRATE_PULLUP_NONE },
+	{ "+4.1667", CONMON_AUDINATE_SRATE_PULLUP_PLUSFOURPOINTONESIXSIXSEVEN },
+	{ "+0.1", CONMON_AUDINATE_SRATE_PULLUP_PLUSPOINTONE },
+	{ "-0.1", CONMON_AUDINATE_SRATE_PULLUP_MINUSPOINTONE },
+	{ "-4.0", CONMON_AUDINATE_SRATE_PULLUP_MINUSFOUR },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_pullup_fields [] =
+{
+	ENUM_FIELD ("val", 0, k_pullups),
+	STRING_FIELD ("subdomain", CONMON_NAME_LENGTH - 1)
+};
+
+static void
+build_pullup (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_srate_pullup_control (body, 0);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_srate_pullup_control_set_rate (body, (uint32_t) values [0].i);
+	}
+	if (FIELD_SET (1))
+	{
+		conmon_audinate_srate_pullup_control_set_subdomain (body, values [1].s [0] ? values [1].s : NULL);
+	}
+	* body_size = (uint16_t) conmon_audinate_srate_pullup_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_reset_modes [] =
+{
+	{ "soft", CONMON_AUDINATE_SYS_RESET_SOFT },
+	{ "factory", CONMON_AUDINATE_SYS_RESET_FACTORY },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_sys_reset_fields [] =
+{
+	ENUM_FIELD ("mode", CONMON_CONTROL_FIELD_FLAG_REQUIRED, k_reset_modes)
+};
+
+static void
+build_sys_reset (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_sys_reset_control (body, CONGESTION_DELAY);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_sys_reset_control_set_mode (body, (uint16_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_sys_reset_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_edk_revs [] =
+{
+	{ "other", CONMON_AUDINATE_EDK_BOARD_REV_OTHER },
+	{ "red", CONMON_AUDINATE_EDK_BOARD_REV_RED },
+	{ "green", CONMON_AUDINATE_EDK_BOARD_REV_GREEN },
+	{ NULL, 0 }
+};
+
+static const conmon_control_name_t k_edk_pads [] =
+{
+	{ "0", CONMON_AUDINATE_EDK_BOARD_PAD_0DB },
+	{ "-6", CONMON_AUDINATE_EDK_BOARD_PAD_MINUS6DB },
+	{ "-12", CONMON_AUDINATE_EDK_BOARD_PAD_MINUS12DB },
+	{ "-24", CONMON_AUDINATE_EDK_BOARD_PAD_MINUS24DB },
+	{ "-48", CONMON_AUDINATE_EDK_BOARD_PAD_MINUS48DB },
+	{ NULL, 0 }
+};
+
+static const conmon_control_name_t k_edk_digs [] =
+{
+	{ "spdif", CONMON_AUDINATE_EDK_BOARD_DIG_SPDIF },
+	{ "aes", CONMON_AUDINATE_EDK_BOARD_DIG_AES },
+	{ "tos", CONMON_AUDINATE_EDK_BOARD_DIG_TOSLINK },
+	{ NULL, 0 }
+};
+
+static const conmon_control_name_t k_edk_srcs [] =
+{
+	{ "sync", CONMON_AUDINATE_EDK_BOARD_SRC_SYNC },
+	{ "async", CONMON_AUDINATE_EDK_BOARD_SRC_ASYNC },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_edk_fields [] =
+{
+	ENUM_FIELD ("rev", 0, k_edk_revs),
+	ENUM_FIELD ("pad", 0, k_edk_pads),
+	ENUM_FIELD ("dig", 0, k_edk_digs),
+	ENUM_FIELD ("src", 0, k_edk_srcs)
+};
+
+static void
+build_edk (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_edk_board_control (body, CONGESTION_DELAY);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_edk_board_set_rev (body, (uint16_t) values [0].i);
+	}
+	if (FIELD_SET (1))
+	{
+		conmon_audinate_edk_board_set_pad (body, (uint16_t) values [1].i);
+	}
+	if (FIELD_SET (2))
+	{
+		conmon_audinate_edk_board_set_dig (body, (uint16_t) values [2].i);
+	}
+	if (FIELD_SET (3))
+	{
+		conmon_audinate_edk_board_set_src (body, (uint16_t) values [3].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_edk_board_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_access_modes [] =
+{
+	{ "enable", CONMON_AUDINATE_ACCESS_ENABLE },
+	{ "disable", CONMON_AUDINATE_ACCESS_DISABLE },
+	{ "inetd_enable", CONMON_AUDINATE_INETD_ENABLE },
+	{ "inetd_disable", CONMON_AUDINATE_INETD_DISABLE },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_access_fields [] =
+{
+	ENUM_FIELD ("mode", 0, k_access_modes)
+};
+
+static void
+build_access (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_access_control (body, CONGESTION_DELAY);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_access_control_set_mode (body, (uint16_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_access_control_get_size (body);
+}
+
+
+static const conmon_control_field_spec_t k_rx_error_threshold_fields [] =
+{
+	U16_FIELD ("thres", CONMON_CONTROL_FIELD_FLAG_REQUIRED),
+	U16_FIELD ("win", CONMON_CONTROL_FIELD_FLAG_REQUIRED),
+	U16_FIELD ("reset", CONMON_CONTROL_FIELD_FLAG_REQUIRED)
+};
+
+static void
+build_rx_error_threshold (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_rx_error_threshold_control (body, CONGESTION_DELAY);
+	if (present)
+	{
+		conmon_audinate_rx_error_threshold_set_threshold (body, (uint16_t) values [0].i);
+		conmon_audinate_rx_error_threshold_set_window (body, (uint16_t) values [1].i);
+		conmon_audinate_rx_error_threshold_set_reset_time (body, (uint16_t) values [2].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_rx_error_threshold_control_get_size (body);
+}
+
+
+static const conmon_control_field_spec_t k_metering_fields [] =
+{
+	U16_FIELD ("rate", 0)
+};
+
+static void
+build_metering (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_metering_control (body, CONGESTION_DELAY);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_metering_control_set_update_rate (body, (uint32_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_metering_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_serial_parities [] =
+{
+	{ "none", CONMON_AUDINATE_SERIAL_PORT_PARITY_NONE },
+	{ "odd", CONMON_AUDINATE_SERIAL_PORT_PARITY_ODD },
+	{ "even", CONMON_AUDINATE_SERIAL_PORT_PARITY_EVEN },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_serial_port_fields [] =
+{
+	U16_FIELD ("index", CONMON_CONTROL_FIELD_FLAG_REQUIRED),
+	{ "speed", CONMON_CONTROL_FIELD_INT, CONMON_CONTROL_FIELD_FLAG_REQUIRED, 1, 0x7FFFFFFF, NULL },
+	{ "bits", CONMON_CONTROL_FIELD_INT, CONMON_CONTROL_FIELD_FLAG_REQUIRED, 7, 8, NULL },
+	ENUM_FIELD ("parity", CONMON_CONTROL_FIELD_FLAG_REQUIRED, k_serial_parities),
+	{ "stop", CONMON_CONTROL_FIELD_INT, CONMON_CONTROL_FIELD_FLAG_REQUIRED, 0, 2, NULL }
+};
+
+static void
+build_serial_port (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_serial_port_control (body, CONGESTION_DELAY);
+	if (present)
+	{
+		conmon_audinate_serial_port_control_set_port (body,
+			(uint16_t) values [0].i,
+			(conmon_audinate_serial_port_baud_rate_t) values [1].i,
+			(conmon_audinate_serial_port_bits_t) values [2].i,
+			(conmon_audinate_serial_port_parity_t) values [3].i,
+			(conmon_audinate_serial_port_stop_bits_t) values [4].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_serial_port_control_size (body);
+}
+
+
+static const conmon_control_name_t k_haremote_modes [] =
+{
+	{ "all", CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_ALL },
+	{ "none", CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_NONE },
+	{ "slot_db9", CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_SLOT_DB9 },
+	{ "network_slot", CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_NETWORK_SLOT },
+	{ "network_db9", CONMON_AUDINATE_HAREMOTE_BRIDGE_MODE_NETWORK_DB9 },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_haremote_fields [] =
+{
+	ENUM_FIELD ("mode", 0, k_haremote_modes)
+};
+
+static void
+build_haremote (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_haremote_control (body, CONGESTION_DELAY);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_haremote_control_set_bridge_mode (body,
+			(conmon_audinate_haremote_bridge_mode_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_haremote_control_get_size (body);
+}
+
+
+static const conmon_control_name_t k_clear_config_actions [] =
+{
+	{ "keep_ip", CONMON_AUDINATE_CLEAR_CONFIG_KEEP_IP },
+	{ "all", CONMON_AUDINATE_CLEAR_CONFIG_CLEAR_ALL },
+	{ "query", CONMON_AUDINATE_CLEAR_CONFIG_QUERY },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_clear_config_fields [] =
+{
+	ENUM_FIELD ("action", CONMON_CONTROL_FIELD_FLAG_BARE, k_clear_config_actions)
+};
+
+static void
+build_clear_config (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_message_size_info_t size = { 0 };
+
+	conmon_audinate_init_clear_config_control (body, & size, 0);
+	conmon_audinate_clear_config_control_set_action (body, & size,
+		FIELD_SET (0)
+			? (conmon_audinate_clear_config_action_t) values [0].i
+			: CONMON_AUDINATE_CLEAR_CONFIG_QUERY);
+	* body_size = (uint16_t) size.curr;
+}
+
+
+static const conmon_control_name_t k_gpio_actions [] =
+{
+	{ "query", CONMON_AUDINATE_GPIO_CONTROL_FIELD_QUERY_STATE },
+	{ "output", CONMON_AUDINATE_GPIO_CONTROL_FIELD_OUTPUT_STATE },
+	{ NULL, 0 }
+};
+
+static const conmon_control_field_spec_t k_gpio_fields [] =
+{
+	ENUM_FIELD ("action", CONMON_CONTROL_FIELD_FLAG_BARE, k_gpio_actions),
+	{ "mask", CONMON_CONTROL_FIELD_INT, 0, 0, 0xFFFFFFFF, NULL },
+	{ "val", CONMON_CONTROL_FIELD_INT, 0, 0, 0xFFFFFFFF, NULL }
+};
+
+static void
+build_gpio (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	uint16_t action = FIELD_SET (0)
+		? (uint16_t) values [0].i
+		: CONMON_AUDINATE_GPIO_CONTROL_FIELD_QUERY_STATE;
+
+	conmon_audinate_init_gpio_control (body, 0, action, 1);
+	conmon_audinate_gpio_control_state_set_at_index (body, 0, (uint32_t) values [1].i, (uint32_t) values [2].i);
+	* body_size = (uint16_t) conmon_audinate_gpio_control_get_size (body);
+}
+
+
+static const conmon_control_field_spec_t k_ptp_logging_fields [] =
+{
+	BOOL_FIELD ("enabled")
+};
+
+static void
+build_ptp_logging (conmon_message_body_t * body, uint16_t * body_size, const conmon_control_value_t * values, uint32_t present)
+{
+	conmon_audinate_init_ptp_logging_control (body, CONGESTION_DELAY);
+	if (FIELD_SET (0))
+	{
+		conmon_audinate_ptp_logging_network_set_enabled (body, (aud_bool_t) values [0].i);
+	}
+	* body_size = (uint16_t) conmon_audinate_ptp_logging_control_get_size (body);
+}
+
+
+const conmon_control_spec_t conmon_control_audinate_specs [] =
+{
+	SPEC ("switch_vlan", SWITCH_VLAN_CONTROL, 0, k_switch_vlan_fields, build_switch_vlan),
+	SPEC ("clocking", CLOCKING_CONTROL, 0, k_clocking_fields, build_clocking),
+	SPEC ("uclocking", UNICAST_CLOCKING_CONTROL, 0, k_unicast_clocking_fields, build_unicast_clocking),
+	SPEC ("ifstats", IFSTATS_QUERY, 0, k_ifstats_fields, build_ifstats),
+	SPEC ("igmp", IGMP_VERS_CONTROL, 0, k_igmp_fields, build_igmp),
+	SPEC ("srate", SRATE_CONTROL, 0, k_srate_fields, build_srate),
+	SPEC ("pullup", SRATE_PULLUP_CONTROL, 0, k_pullup_fields, build_pullup),
+	SPEC ("enc", ENC_CONTROL, 0, k_enc_fields, build_enc),
+	SPEC ("sysreset", SYS_RESET, CONMON_CONTROL_SPEC_FLAG_NO_QUERY, k_sys_reset_fields, build_sys_reset),
+	SPEC ("edk", EDK_BOARD_CONTROL, 0, k_edk_fields, build_edk),
+	SPEC ("access", ACCESS_CONTROL, 0, k_access_fields, build_access),
+	SPEC ("errthres", RX_ERROR_THRES_CONTROL, 0, k_rx_error_threshold_fields, build_rx_error_threshold),
+	SPEC ("metering", METERING_CONTROL, 0, k_metering_fields, build_metering),
+	SPEC ("serial", SERIAL_PORT_CONTROL, 0, k_serial_port_fields, build_serial_port),
+	SPEC ("haremote", HAREMOTE_CONTROL, 0, k_haremote_fields, build_haremote),
+	SPEC ("clear_config", CLEAR_CONFIG_CONTROL, 0, k_clear_config_fields, build_clear_config),
+	SPEC ("gpio", GPIO_QUERY, 0, k_gpio_fields, build_gpio),
+	SPEC ("ptp_logging", PTP_LOGGING_CONTROL, 0, k_ptp_logging_fields, build_ptp_logging)
+};
+
+const unsigned int conmon_control_audinate_num_specs =
+	sizeof (conmon_control_audinate_specs) / sizeof (conmon_control_audinate_specs [0]);
+
+
+//----------
@@ -0,0 +1,303 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Build conmon audinate control messages from key=value arguments
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_CONTROL_BUILDER_H
+#define _CONMON_CONTROL_BUILDER_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include <stdio.h>
+
+
+//----------
+// Types and Constants
+
+/*
+	Each control message is described by a spec: the command name, the
+	fields it takes and a build function that fills in the body from typed
+	values. The builder only does the string work. It checks each argument
+	against the spec, converts it and range checks it, then hands the
+	values to the build function, which just calls the SDK setters.
+
+	Arguments are "name=value". A bare word sets a bool field of that name
+	to true, or else picks the value of the spec's bare enum field, so
+	"clear_config keep_ip" and "uclocking reload" keep working. With no
+	arguments at all the spec builds a query unless it is marked NO_QUERY.
+	If any field is given then every REQUIRED field must be given too.
+
+	Field names are hashed when the builder is made, so matching an
+	argument reads it once. For sending the same kind of message many
+	times, a shape resolves a fixed list of field names once and then
+	takes values with no names to match. The last body a shape built is
+	kept and copied if the next values are the same, which is the common
+	case when one command goes to many devices.
+ */
+
+enum
+{
+	CONMON_CONTROL_MAX_FIELDS = 8
+};
+
+typedef enum
+{
+	CONMON_CONTROL_FIELD_INT = 1,
+		// decimal or 0x hex between min and max, or one of names
+	CONMON_CONTROL_FIELD_BOOL,
+		// true or false
+	CONMON_CONTROL_FIELD_ENUM,
+		// one of names
+	CONMON_CONTROL_FIELD_STRING
+		// between min and max characters, possibly empty
+} conmon_control_field_type_t;
+
+enum
+{
+	CONMON_CONTROL_FIELD_FLAG_REQUIRED = 0x01,
+	CONMON_CONTROL_FIELD_FLAG_BARE = 0x02
+		// enum whose names may be given without "name="
+};
+
+enum
+{
+	CONMON_CONTROL_SPEC_FLAG_NO_QUERY = 0x01
+		// at least one field must be given
+};
+
+typedef struct conmon_control_name
+{
+	const char * name;
+	int64_t value;
+} conmon_control_name_t;
+
+typedef struct conmon_control_field_spec
+{
+	const char * name;
+	conmon_control_field_type_t type;
+	unsigned int flags;
+	int64_t min;
+	int64_t max;
+	const conmon_control_name_t * names;
+		// terminated by a NULL name, or NULL for none
+} conmon_control_field_spec_t;
+
+typedef struct conmon_control_value
+{
+	int64_t i;
+		// INT, BOOL and ENUM fields
+	const char * s;
+		// STRING fields; points into the caller's arguments
+} conmon_control_value_t;
+
+/*
+	Fill in a body from the values of the fields named by present, a bit
+	per field in spec order. Values of absent fields are zero.
+ */
+typedef void
+conmon_control_build_fn
+(
+	conmon_message_body_t * body,
+	uint16_t * body_size,
+	const conmon_control_value_t * values,
+	uint32_t present
+);
+
+typedef struct conmon_control_spec
+{
+	const char * cmd;
+	conmon_audinate_message_type_t type;
+	unsigned int flags;
+	unsigned int num_fields;
+	const conmon_control_field_spec_t * fields;
+	conmon_control_build_fn * build;
+} conmon_control_spec_t;
+
+typedef struct conmon_control_builder conmon_control_builder_t;
+typedef struct conmon_control_shape conmon_control_shape_t;
+
+typedef struct conmon_control_stats
+{
+	unsigned long num_builds;
+	unsigned long num_reused;
+		// shape builds answered from the last body
+	unsigned long num_rejected;
+} conmon_control_stats_t;
+
+// Specs for the audinate control messages that take key=value arguments
+extern const conmon_control_spec_t conmon_control_audinate_specs [];
+extern const unsigned int conmon_control_audinate_num_specs;
+
+
+//----------
+// Functions
+
+// The specs must stay valid for the life of the builder
+aud_error_t
+conmon_control_builder_new
+(
+	const conmon_control_spec_t * specs,
+	unsigned int num_specs,
+	conmon_control_builder_t ** builder_ptr
+);
+
+void
+conmon_control_builder_delete
+(
+	conmon_control_builder_t * builder
+);
+
+// @return NULL if no spec has that command name
+const conmon_control_spec_t *
+conmon_control_builder_find
+(
+	const conmon_control_builder_t * builder,
+	const char * cmd
+);
+
+/*
+	Convert argc arguments, not including the command name, to values in
+	spec order (CONMON_CONTROL_MAX_FIELDS of them) and a bit per field
+	given, without building anything.
+
+	@return as conmon_control_builder_build
+ */
+aud_error_t
+conmon_control_builder_parse
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	int argc,
+	char * const * argv,
+	conmon_control_value_t * values,
+	uint32_t * present,
+	const char ** bad_arg
+);
+
+/*
+	Build a body from argc arguments, not including the command name.
+
+	@return AUD_ERR_INVALIDPARAMETER if an argument is unknown, repeated or
+	out of range, with bad_arg (if not NULL) set to it, or if a required
+	field is missing, with bad_arg set to NULL
+ */
+aud_error_t
+conmon_control_builder_build
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	int argc,
+	char * const * argv,
+	conmon_message_body_t * body,
+	uint16_t * body_size,
+	const char ** bad_arg
+);
+
+/*
+	Build a body from values in spec order, as given by
+	conmon_control_builder_parse. Values of fields in present are range
+	checked and others are ignored.
+
+	@return AUD_ERR_INVALIDPARAMETER if a value is out of range or a
+	required field is missing
+ */
+aud_error_t
+conmon_control_builder_build_values
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	const conmon_control_value_t * values,
+	uint32_t present,
+	conmon_message_body_t * body,
+	uint16_t * body_size
+);
+
+// Print the arguments a spec takes, one line in the style of the examples' usage messages
+void
+conmon_control_builder_print_usage
+(
+	FILE * fp,
+	const char * bin,
+	const conmon_control_spec_t * spec
+);
+
+void
+conmon_control_builder_get_stats
+(
+	const conmon_control_builder_t * builder,
+	conmon_control_stats_t * stats
+);
+
+/*
+	Resolve a comma separated list of field names for a spec, such as
+	"thres,win,reset". Values are then given in that order. An empty list
+	gives a query shape.
+
+	@return AUD_ERR_INVALIDPARAMETER if a name is unknown or repeated, or a
+	required field is left out
+ */
+aud_error_t
+conmon_control_shape_new
+(
+	conmon_control_builder_t * builder,
+	const conmon_control_spec_t * spec,
+	const char * names,
+	conmon_control_shape_t ** shape_ptr
+);
+
+void
+conmon_control_shape_delete
+(
+	conmon_control_shape_t * shape
+);
+
+unsigned int
+conmon_control_shape_num_fields
+(
+	const conmon_control_shape_t * shape
+);
+
+/*
+	Build a body from typed values, one per field of the shape. Values are
+	range checked but not converted, and s is only read for STRING fields.
+
+	@return AUD_ERR_INVALIDPARAMETER if a value is out of range
+ */
+aud_error_t
+conmon_control_shape_build
+(
+	conmon_control_shape_t * shape,
+	const conmon_control_value_t * values,
+	conmon_message_body_t * body,
+	uint16_t * body_size
+);
+
+// As conmon_control_shape_build, converting a value string per field
+aud_error_t
+conmon_control_shape_build_strings
+(
+	conmon_control_shape_t * shape,
+	const char * const * strings,
+	conmon_message_body_t * body,
+	uint16_t * body_size
+);
+
+void
+conmon_control_shape_get_stats
+(
+	const conmon_control_shape_t * shape,
+	conmon_control_stats_t * stats
+);
+
+
+//----------
+
+#endif // _CONMON_CONTROL_BUILDER_H
@@ -0,0 +1,381 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Cache of prebuilt control message bodies for sending to many devices
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_control_cache.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+
+
+//----------
+// Types and Constants
+
+#define CONTROL_CACHE_NO_ENTRY 0xFFFFFFFFu
+
+struct conmon_control_template
+{
+	const conmon_control_spec_t * spec;
+	uint32_t hash;
+	uint32_t present;
+	conmon_control_value_t values [CONMON_CONTROL_MAX_FIELDS];
+		// zero for fields not given; strings point into strings below
+	char strings [CONMON_CONTROL_MAX_FIELDS][CONMON_CONTROL_CACHE_MAX_STRING + 1];
+	uint16_t body_size;
+	conmon_message_body_t body;
+};
+
+struct conmon_control_cache
+{
+	conmon_control_builder_t * builder;
+	unsigned int max_templates;
+	unsigned int num_templates;
+	conmon_control_template_t * templates;
+		// one more than max_templates; the last is scratch for a build
+		// that may restart the cache
+
+	uint32_t * slots;
+		// open addressed by key hash, holding template indexes
+	uint32_t slot_mask;
+
+	conmon_control_cache_stats_t stats;
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE aud_bool_t
+control_cache_is_string (const conmon_control_spec_t * spec, unsigned int f)
+{
+	return spec->fields [f].type == CONMON_CONTROL_FIELD_STRING;
+}
+
+
+static uint32_t
+control_cache_hash
+(
+	const conmon_control_spec_t * spec,
+	const conmon_control_value_t * values,
+	uint32_t present
+)
+{
+	uint64_t h = dapi_hash_mix64 ((uint64_t) (size_t) spec ^ ((uint64_t) present << 32));
+	unsigned int f;
+
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		uint64_t v;
+
+		if (! (present & (1u << f)))
+		{
+			continue;
+		}
+		if (control_cache_is_string (spec, f))
+		{
+			v = dapi_fnv1a_bytes (DAPI_FNV1A_BASIS, values [f].s, strlen (values [f].s));
+		}
+		else
+		{
+			v = (uint64_t) values [f].i;
+		}
+		h = dapi_hash_mix64 (h ^ v ^ f);
+	}
+	return (uint32_t) h;
+}
+
+
+static aud_bool_t
+control_cache_matches
+(
+	const conmon_control_template_t * tmpl,
+	const conmon_control_spec_t * spec,
+	const conmon_control_value_t * values,
+	uint32_t present,
+	uint32_t hash
+)
+{
+	unsigned int f;
+
+	if (tmpl->hash != hash || tmpl->spec != spec || tmpl->present != present)
+	{
+		return AUD_FALSE;
+	}
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		if (! (present & (1u << f)))
+		{
+			continue;
+		}
+		if (control_cache_is_string (spec, f)
+			? strcmp (tmpl->values [f].s, values [f].s) != 0
+			: tmpl->values [f].i != values [f].i)
+		{
+			return AUD_FALSE;
+		}
+	}
+	return AUD_TRUE;
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_control_cache_new
+(
+	conmon_control_builder_t * builder,
+	unsigned int max_templates,
+	conmon_control_cache_t ** cache_ptr
+)
+{
+	conmon_control_cache_t * cache;
+	uint32_t num_slots = 8;
+
+	if (! (builder && max_templates && cache_ptr))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (num_slots < max_templates * 2)
+	{
+		num_slots <<= 1;
+	}
+
+	cache = calloc (1, sizeof (* cache));
+	if (! cache)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	cache->templates = malloc ((max_templates + 1) * sizeof (* cache->templates));
+	cache->slots = malloc (num_slots * sizeof (* cache->slots));
+	if (! (cache->templates && cache->slots))
+	{
+		conmon_control_cache_delete (cache);
+		return AUD_ERR_NOMEMORY;
+	}
+	cache->builder = builder;
+	cache->max_templates = max_templates;
+	cache->slot_mask = num_slots - 1;
+	conmon_control_cache_clear (cache);
+
+	* cache_ptr = cache;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_control_cache_delete
+(
+	conmon_control_cache_t * cache
+)
+{
+	if (cache)
+	{
+		free (cache->templates);
+		free (cache->slots);
+		free (cache);
+	}
+}
+
+
+void
+conmon_control_cache_clear
+(
+	conmon_control_cache_t * cache
+)
+{
+	cache->num_templates = 0;
+	// 0xFF bytes give CONTROL_CACHE_NO_ENTRY in every slot
+	memset (cache->slots, 0xFF, (cache->slot_mask + 1) * sizeof (* cache->slots));
+}
+
+
+aud_error_t
+conmon_control_cache_lookup
+(
+	conmon_control_cache_t * cache,
+	const conmon_control_spec_t * spec,
+	int argc,
+	char * const * argv,
+	const conmon_control_template_t ** template_ptr,
+	const char ** bad_arg
+)
+{
+	conmon_control_value_t values [CONMON_CONTROL_MAX_FIELDS];
+	uint32_t present;
+	aud_error_t result;
+
+	result = conmon_control_builder_parse (cache->builder, spec, argc, argv, values, & present, bad_arg);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	return conmon_control_cache_lookup_values (cache, spec, values, present, template_ptr);
+}
+
+
+aud_error_t
+conmon_control_cache_lookup_values
+(
+	conmon_control_cache_t * cache,
+	const conmon_control_spec_t * spec,
+	const conmon_control_value_t * values,
+	uint32_t present,
+	const conmon_control_template_t ** template_ptr
+)
+{
+	conmon_control_template_t * tmpl;
+	uint32_t hash, slot;
+	unsigned int f;
+	aud_error_t result;
+
+	if (! (spec && values && template_ptr) || (present >> spec->num_fields))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		if ((present & (1u << f)) && control_cache_is_string (spec, f)
+			&& (! values [f].s || strlen (values [f].s) > CONMON_CONTROL_CACHE_MAX_STRING))
+		{
+			return values [f].s ? AUD_ERR_NOBUFS : AUD_ERR_INVALIDPARAMETER;
+		}
+	}
+	cache->stats.num_lookups++;
+
+	hash = control_cache_hash (spec, values, present);
+	for (slot = hash & cache->slot_mask;
+		cache->slots [slot] != CONTROL_CACHE_NO_ENTRY;
+		slot = (slot + 1) & cache->slot_mask)
+	{
+		tmpl = cache->templates + cache->slots [slot];
+		if (control_cache_matches (tmpl, spec, values, present, hash))
+		{
+			cache->stats.num_hits++;
+			* template_ptr = tmpl;
+			return AUD_SUCCESS;
+		}
+	}
+
+	// a full cache is only thrown away once the new body has built, so a
+	// bad request leaves the existing templates in place
+	tmpl = cache->templates + cache->num_templates;
+	result = conmon_control_builder_build_values (cache->builder, spec, values, present,
+		& tmpl->body, & tmpl->body_size);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	cache->stats.num_builds++;
+
+	if (cache->num_templates == cache->max_templates)
+	{
+		const conmon_control_template_t * scratch = tmpl;
+
+		cache->stats.num_restarts++;
+		conmon_control_cache_clear (cache);
+		slot = hash & cache->slot_mask;
+		tmpl = cache->templates;
+		tmpl->body_size = scratch->body_size;
+		memcpy (& tmpl->body, & scratch->body, scratch->body_size);
+	}
+
+	tmpl->spec = spec;
+	tmpl->hash = hash;
+	tmpl->present = present;
+	memset (tmpl->values, 0, sizeof (tmpl->values));
+	for (f = 0; f < spec->num_fields; f++)
+	{
+		if (! (present & (1u << f)))
+		{
+			continue;
+		}
+		if (control_cache_is_string (spec, f))
+		{
+			strcpy (tmpl->strings [f], values [f].s);
+			tmpl->values [f].s = tmpl->strings [f];
+		}
+		else
+		{
+			tmpl->values [f].i = values [f].i;
+		}
+	}
+	cache->slots [slot] = cache->num_templates++;
+
+	* template_ptr = tmpl;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_control_cache_get_stats
+(
+	const conmon_control_cache_t * cache,
+	conmon_control_cache_stats_t * stats
+)
+{
+	* stats = cache->stats;
+	stats->num_templates = cache->num_templates;
+}
+
+
+const conmon_control_spec_t *
+conmon_control_template_get_spec
+(
+	const conmon_control_template_t * tmpl
+)
+{
+	return tmpl->spec;
+}
+
+
+const conmon_message_body_t *
+conmon_control_template_get_body
+(
+	const conmon_control_template_t * tmpl
+)
+{
+	return & tmpl->body;
+}
+
+
+uint16_t
+conmon_control_template_get_body_size
+(
+	const conmon_control_template_t * tmpl
+)
+{
+	return tmpl->body_size;
+}
+
+
+aud_error_t
+conmon_control_template_send
+(
+	const conmon_control_template_t * tmpl,
+	conmon_client_t * client,
+	conmon_client_response_fn * response_fn,
+	conmon_client_request_id_t * request_id,
+	const char * device_name,
+	const aud_utime_t * timeout
+)
+{
+	return
+		conmon_client_send_control_message (
+			client, response_fn, request_id,
+			device_name, CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+			& tmpl->body, tmpl->body_size, timeout
+		);
+}
+
+
+//----------
@@ -0,0 +1,160 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Cache of prebuilt control message bodies for sending to many devices
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_CONTROL_CACHE_H
+#define _CONMON_CONTROL_CACHE_H
+
+
+//----------
+// Include
+
+#include "conmon_control_builder.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	A template is a control message body built once by a
+	conmon_control_builder, with its size, keyed by the spec and the
+	values of the fields given. Looking up the same command with the same
+	values again finds the template without building anything, so sending
+	one change to a whole fleet costs one build and then a send per device.
+
+	Keys are the converted values rather than the argument strings, so
+	"srate rate=48000" and a typed lookup of the same rate share a
+	template. Templates are never changed once built; callers read their
+	body and size directly.
+
+	The cache holds max_templates. When it is full the next new key that
+	builds clears it and starts again, which invalidates every template
+	pointer handed out before; a key that fails to build leaves the cache
+	as it was. Automation sends a handful of distinct messages, so in
+	practice the cache fills once and stays put.
+ */
+
+enum
+{
+	CONMON_CONTROL_CACHE_MAX_STRING = 64
+		// longest string value a template can be keyed on
+};
+
+typedef struct conmon_control_cache conmon_control_cache_t;
+typedef struct conmon_control_template conmon_control_template_t;
+
+typedef struct conmon_control_cache_stats
+{
+	unsigned long num_lookups;
+	unsigned long num_hits;
+	unsigned long num_builds;
+	unsigned long num_restarts;
+		// times the cache was full and started again
+	unsigned int num_templates;
+} conmon_control_cache_stats_t;
+
+
+//----------
+// Functions
+
+// The builder must outlive the cache
+aud_error_t
+conmon_control_cache_new
+(
+	conmon_control_builder_t * builder,
+	unsigned int max_templates,
+	conmon_control_cache_t ** cache_ptr
+);
+
+void
+conmon_control_cache_delete
+(
+	conmon_control_cache_t * cache
+);
+
+void
+conmon_control_cache_clear
+(
+	conmon_control_cache_t * cache
+);
+
+/*
+	Find or build the template for a command's arguments, not including
+	the command name.
+
+	@return as conmon_control_builder_build, or AUD_ERR_NOBUFS if a string
+	value is longer than CONMON_CONTROL_CACHE_MAX_STRING
+ */
+aud_error_t
+conmon_control_cache_lookup
+(
+	conmon_control_cache_t * cache,
+	const conmon_control_spec_t * spec,
+	int argc,
+	char * const * argv,
+	const conmon_control_template_t ** template_ptr,
+	const char ** bad_arg
+);
+
+/*
+	Find or build the template for values in spec order with a bit per
+	field given, as for conmon_control_builder_build_values. Values are
+	only range checked when the template is built.
+ */
+aud_error_t
+conmon_control_cache_lookup_values
+(
+	conmon_control_cache_t * cache,
+	const conmon_control_spec_t * spec,
+	const conmon_control_value_t * values,
+	uint32_t present,
+	const conmon_control_template_t ** template_ptr
+);
+
+void
+conmon_control_cache_get_stats
+(
+	const conmon_control_cache_t * cache,
+	conmon_control_cache_stats_t * stats
+);
+
+const conmon_control_spec_t *
+conmon_control_template_get_spec
+(
+	const conmon_control_template_t * tmpl
+);
+
+const conmon_message_body_t *
+conmon_control_template_get_body
+(
+	const conmon_control_template_t * tmpl
+);
+
+uint16_t
+conmon_control_template_get_body_size
+(
+	const conmon_control_template_t * tmpl
+);
+
+// Send a template as a control message, as conmon_client_send_control_message
+aud_error_t
+conmon_control_template_send
+(
+	const conmon_control_template_t * tmpl,
+	conmon_client_t * client,
+	conmon_client_response_fn * response_fn,
+	conmon_client_request_id_t * request_id,
+	const char * device_name,
+	const aud_utime_t * timeout
+);
+
+
+//----------
+
+#endif // _CONMON_CONTROL_CACHE_H
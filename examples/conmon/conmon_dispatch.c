@@ -0,0 +1,566 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Send one control message to many devices at once and gather the responses
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_dispatch.h"
+#include "dapi_io.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+#define DISPATCH_NO_ENTRY 0xFFFFFFFFu
+
+struct conmon_dispatch
+{
+	unsigned int window;
+	unsigned int timeout_ms;
+
+	conmon_dispatch_target_t * targets;
+	unsigned int num_targets;
+	unsigned int max_targets;
+
+	uint32_t * names;
+		// open addressing on the case-folded device name
+	uint32_t * completions;
+		// open addressing on the request id, holding SENT targets only
+	uint32_t mask;
+		// both tables are the same size
+
+	uint32_t * sent_order;
+		// targets in the order they were sent, and so the order they time out
+	unsigned int num_sent;
+	unsigned int expire_from;
+		// targets before this one in sent_order are no longer SENT
+	unsigned int next_pending;
+		// targets before this one are not PENDING
+
+	unsigned int num_in_state [CONMON_NUM_DISPATCH_TARGET_STATES];
+	unsigned long num_late;
+	uint64_t max_elapsed_ms;
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE uint32_t
+hash_request_id (conmon_client_request_id_t request_id)
+{
+	return (uint32_t) dapi_hash_mix64 ((uint64_t) (size_t) request_id);
+}
+
+
+// Returns the slot holding the target, or the empty slot where it would go
+static uint32_t
+find_name_slot (const conmon_dispatch_t * dispatch, const char * device_name)
+{
+	uint32_t slot = dapi_name_hash (device_name) & dispatch->mask;
+	uint32_t i;
+
+	while ((i = dispatch->names [slot]) != DISPATCH_NO_ENTRY)
+	{
+		if (dapi_name_equals (dispatch->targets [i].device_name, device_name))
+		{
+			break;
+		}
+		slot = (slot + 1) & dispatch->mask;
+	}
+	return slot;
+}
+
+
+// Returns the slot holding the request, or the empty slot where it would go
+static uint32_t
+find_completion_slot (const conmon_dispatch_t * dispatch, conmon_client_request_id_t request_id)
+{
+	uint32_t slot = hash_request_id (request_id) & dispatch->mask;
+	uint32_t i;
+
+	while ((i = dispatch->completions [slot]) != DISPATCH_NO_ENTRY)
+	{
+		if (dispatch->targets [i].request_id == request_id)
+		{
+			break;
+		}
+		slot = (slot + 1) & dispatch->mask;
+	}
+	return slot;
+}
+
+
+static void
+remove_completion (conmon_dispatch_t * dispatch, uint32_t hole)
+{
+	uint32_t slot;
+
+	// shift back any later entry in the run whose home slot is not between the hole and itself
+	for (slot = (hole + 1) & dispatch->mask;
+		dispatch->completions [slot] != DISPATCH_NO_ENTRY;
+		slot = (slot + 1) & dispatch->mask)
+	{
+		const conmon_dispatch_target_t * target = dispatch->targets + dispatch->completions [slot];
+		const uint32_t home = hash_request_id (target->request_id) & dispatch->mask;
+
+		if (((slot - home) & dispatch->mask) >= ((slot - hole) & dispatch->mask))
+		{
+			dispatch->completions [hole] = dispatch->completions [slot];
+			hole = slot;
+		}
+	}
+	dispatch->completions [hole] = DISPATCH_NO_ENTRY;
+}
+
+
+static void
+finish
+(
+	conmon_dispatch_t * dispatch,
+	conmon_dispatch_target_t * target,
+	conmon_dispatch_target_state_t state,
+	aud_error_t result,
+	uint64_t now_ms
+)
+{
+	dispatch->num_in_state [target->state]--;
+	dispatch->num_in_state [state]++;
+	target->state = state;
+	target->result = result;
+	target->done_ms = now_ms;
+	target->request_id = NULL;
+}
+
+
+static aud_bool_t
+match_set (const char ** pattern_ptr, char c)
+{
+	const char * p = * pattern_ptr + 1;
+	aud_bool_t negate = AUD_FALSE, found = AUD_FALSE;
+
+	if (* p == '!')
+	{
+		negate = AUD_TRUE;
+		p++;
+	}
+	// a ']' straight after the '[' is part of the set
+	do
+	{
+		char lo = (char) tolower ((unsigned char) * p), hi = lo;
+
+		if (p [1] == '-' && p [2] && p [2] != ']')
+		{
+			hi = (char) tolower ((unsigned char) p [2]);
+			p += 2;
+		}
+		if (lo <= c && c <= hi)
+		{
+			found = AUD_TRUE;
+		}
+		p++;
+	} while (* p && * p != ']');
+
+	* pattern_ptr = * p ? p + 1 : p;
+	return found != negate;
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_dispatch_new
+(
+	unsigned int max_targets,
+	unsigned int window,
+	unsigned int timeout_ms,
+	conmon_dispatch_t ** dispatch_ptr
+)
+{
+	conmon_dispatch_t * dispatch;
+	uint32_t table_size = 1;
+
+	if (! (dispatch_ptr && max_targets && timeout_ms) || max_targets > 0x100000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (table_size < 2 * max_targets)
+	{
+		table_size <<= 1;
+	}
+
+	dispatch = calloc (1, sizeof (* dispatch));
+	if (! dispatch)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	dispatch->targets = calloc (max_targets, sizeof (* dispatch->targets));
+	dispatch->sent_order = malloc (max_targets * sizeof (uint32_t));
+	dispatch->names = malloc (table_size * sizeof (uint32_t));
+	dispatch->completions = malloc (table_size * sizeof (uint32_t));
+	if (! (dispatch->targets && dispatch->sent_order && dispatch->names && dispatch->completions))
+	{
+		conmon_dispatch_delete (dispatch);
+		return AUD_ERR_NOMEMORY;
+	}
+	// 0xFF bytes give DISPATCH_NO_ENTRY in every slot
+	memset (dispatch->names, 0xFF, table_size * sizeof (uint32_t));
+	memset (dispatch->completions, 0xFF, table_size * sizeof (uint32_t));
+	dispatch->mask = table_size - 1;
+	dispatch->max_targets = max_targets;
+	dispatch->window = window ? window : max_targets;
+	dispatch->timeout_ms = timeout_ms;
+
+	* dispatch_ptr = dispatch;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_dispatch_delete
+(
+	conmon_dispatch_t * dispatch
+)
+{
+	if (dispatch)
+	{
+		free (dispatch->completions);
+		free (dispatch->names);
+		free (dispatch->sent_order);
+		free (dispatch->targets);
+		free (dispatch);
+	}
+}
+
+
+aud_error_t
+conmon_dispatch_add
+(
+	conmon_dispatch_t * dispatch,
+	const char * device_name
+)
+{
+	conmon_dispatch_target_t * target;
+	uint32_t slot;
+
+	if (! (dispatch && device_name && * device_name) || strlen (device_name) >= sizeof (target->device_name))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	slot = find_name_slot (dispatch, device_name);
+	if (dispatch->names [slot] != DISPATCH_NO_ENTRY)
+	{
+		return AUD_SUCCESS;
+	}
+	if (dispatch->num_targets >= dispatch->max_targets)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+
+	dispatch->names [slot] = dispatch->num_targets;
+	target = dispatch->targets + dispatch->num_targets++;
+	strcpy (target->device_name, device_name);
+	target->state = CONMON_DISPATCH_TARGET_PENDING;
+	target->result = AUD_SUCCESS;
+	dispatch->num_in_state [CONMON_DISPATCH_TARGET_PENDING]++;
+	return AUD_SUCCESS;
+}
+
+
+aud_bool_t
+conmon_dispatch_next
+(
+	conmon_dispatch_t * dispatch,
+	unsigned int * target_index
+)
+{
+	if (dispatch->num_in_state [CONMON_DISPATCH_TARGET_SENT] >= dispatch->window
+		|| ! dispatch->num_in_state [CONMON_DISPATCH_TARGET_PENDING])
+	{
+		return AUD_FALSE;
+	}
+	// targets only leave PENDING, so the scan can resume where it stopped
+	while (dispatch->next_pending < dispatch->num_targets)
+	{
+		const unsigned int i = dispatch->next_pending++;
+		if (dispatch->targets [i].state == CONMON_DISPATCH_TARGET_PENDING)
+		{
+			* target_index = i;
+			return AUD_TRUE;
+		}
+	}
+	return AUD_FALSE;
+}
+
+
+void
+conmon_dispatch_sent
+(
+	conmon_dispatch_t * dispatch,
+	unsigned int target_index,
+	aud_error_t result,
+	conmon_client_request_id_t request_id,
+	uint64_t now_ms
+)
+{
+	conmon_dispatch_target_t * target;
+	uint32_t slot;
+
+	if (target_index >= dispatch->num_targets)
+	{
+		return;
+	}
+	target = dispatch->targets + target_index;
+	if (target->state != CONMON_DISPATCH_TARGET_PENDING)
+	{
+		return;
+	}
+	target->sent_ms = now_ms;
+
+	if (result == AUD_SUCCESS)
+	{
+		slot = find_completion_slot (dispatch, request_id);
+		if (dispatch->completions [slot] != DISPATCH_NO_ENTRY)
+		{
+			// the client handed out an id that is still outstanding; the older request can't be matched any more
+			finish (dispatch, dispatch->targets + dispatch->completions [slot],
+				CONMON_DISPATCH_TARGET_FAILED, AUD_ERR_INUSE, now_ms);
+		}
+		dispatch->completions [slot] = target_index;
+		target->request_id = request_id;
+		target->done_ms = now_ms + dispatch->timeout_ms;
+		dispatch->num_in_state [CONMON_DISPATCH_TARGET_PENDING]--;
+		dispatch->num_in_state [CONMON_DISPATCH_TARGET_SENT]++;
+		target->state = CONMON_DISPATCH_TARGET_SENT;
+		dispatch->sent_order [dispatch->num_sent++] = target_index;
+	}
+	else
+	{
+		finish (dispatch, target, CONMON_DISPATCH_TARGET_FAILED, result, now_ms);
+	}
+}
+
+
+aud_bool_t
+conmon_dispatch_response
+(
+	conmon_dispatch_t * dispatch,
+	conmon_client_request_id_t request_id,
+	aud_error_t result,
+	uint64_t now_ms,
+	unsigned int * target_index
+)
+{
+	const uint32_t slot = find_completion_slot (dispatch, request_id);
+	const uint32_t i = dispatch->completions [slot];
+	conmon_dispatch_target_t * target;
+
+	if (i == DISPATCH_NO_ENTRY)
+	{
+		dispatch->num_late++;
+		return AUD_FALSE;
+	}
+	target = dispatch->targets + i;
+	remove_completion (dispatch, slot);
+
+	if (now_ms - target->sent_ms > dispatch->max_elapsed_ms)
+	{
+		dispatch->max_elapsed_ms = now_ms - target->sent_ms;
+	}
+	finish (dispatch, target,
+		(result == AUD_SUCCESS) ? CONMON_DISPATCH_TARGET_DONE : CONMON_DISPATCH_TARGET_FAILED,
+		result, now_ms);
+	if (target_index)
+	{
+		* target_index = i;
+	}
+	return AUD_TRUE;
+}
+
+
+void
+conmon_dispatch_expire
+(
+	conmon_dispatch_t * dispatch,
+	uint64_t now_ms
+)
+{
+	// every target has the same timeout, so they time out in the order they were sent
+	while (dispatch->expire_from < dispatch->num_sent)
+	{
+		conmon_dispatch_target_t * target = dispatch->targets + dispatch->sent_order [dispatch->expire_from];
+
+		if (target->state == CONMON_DISPATCH_TARGET_SENT)
+		{
+			if (target->done_ms > now_ms)
+			{
+				break;
+			}
+			remove_completion (dispatch, find_completion_slot (dispatch, target->request_id));
+			finish (dispatch, target, CONMON_DISPATCH_TARGET_TIMEDOUT, AUD_ERR_TIMEDOUT, now_ms);
+		}
+		dispatch->expire_from++;
+	}
+}
+
+
+unsigned int
+conmon_dispatch_ms_to_next
+(
+	const conmon_dispatch_t * dispatch,
+	uint64_t now_ms
+)
+{
+	unsigned int i;
+
+	for (i = dispatch->expire_from; i < dispatch->num_sent; i++)
+	{
+		const conmon_dispatch_target_t * target = dispatch->targets + dispatch->sent_order [i];
+		if (target->state == CONMON_DISPATCH_TARGET_SENT)
+		{
+			return (target->done_ms > now_ms) ? (unsigned int) (target->done_ms - now_ms) : 0;
+		}
+	}
+	return dispatch->timeout_ms;
+}
+
+
+aud_bool_t
+conmon_dispatch_is_finished
+(
+	const conmon_dispatch_t * dispatch
+)
+{
+	return ! (dispatch->num_in_state [CONMON_DISPATCH_TARGET_PENDING]
+		|| dispatch->num_in_state [CONMON_DISPATCH_TARGET_SENT]);
+}
+
+
+unsigned int
+conmon_dispatch_num_targets
+(
+	const conmon_dispatch_t * dispatch
+)
+{
+	return dispatch->num_targets;
+}
+
+
+const conmon_dispatch_target_t *
+conmon_dispatch_target_at_index
+(
+	const conmon_dispatch_t * dispatch,
+	unsigned int target_index
+)
+{
+	return (target_index < dispatch->num_targets) ? dispatch->targets + target_index : NULL;
+}
+
+
+void
+conmon_dispatch_get_summary
+(
+	const conmon_dispatch_t * dispatch,
+	conmon_dispatch_summary_t * summary
+)
+{
+	summary->num_targets = dispatch->num_targets;
+	memcpy (summary->num_in_state, dispatch->num_in_state, sizeof (summary->num_in_state));
+	summary->num_late = dispatch->num_late;
+	summary->max_elapsed_ms = dispatch->max_elapsed_ms;
+}
+
+
+const char *
+conmon_dispatch_target_state_to_string
+(
+	conmon_dispatch_target_state_t state
+)
+{
+	switch (state)
+	{
+	case CONMON_DISPATCH_TARGET_PENDING:  return "PENDING";
+	case CONMON_DISPATCH_TARGET_SENT:     return "SENT";
+	case CONMON_DISPATCH_TARGET_DONE:     return "DONE";
+	case CONMON_DISPATCH_TARGET_FAILED:   return "FAILED";
+	case CONMON_DISPATCH_TARGET_TIMEDOUT: return "TIMEDOUT";
+	default:                              return "???";
+	}
+}
+
+
+aud_bool_t
+conmon_dispatch_is_pattern
+(
+	const char * pattern
+)
+{
+	return strpbrk (pattern, "*?[") != NULL;
+}
+
+
+aud_bool_t
+conmon_dispatch_match
+(
+	const char * pattern,
+	const char * device_name
+)
+{
+	const char * p = pattern, * n = device_name;
+	const char * star_p = NULL, * star_n = NULL;
+
+	// on a mismatch, go back to the last '*' and let it take one more character
+	while (* n)
+	{
+		const char c = (char) tolower ((unsigned char) * n);
+
+		if (* p == '*')
+		{
+			star_p = ++p;
+			star_n = n;
+			continue;
+		}
+		if (* p == '[' && p [1])
+		{
+			const char * next_p = p;
+			if (match_set (& next_p, c))
+			{
+				p = next_p;
+				n++;
+				continue;
+			}
+		}
+		else if (* p && (* p == '?' || tolower ((unsigned char) * p) == c))
+		{
+			p++;
+			n++;
+			continue;
+		}
+		if (! star_p)
+		{
+			return AUD_FALSE;
+		}
+		p = star_p;
+		n = ++star_n;
+	}
+	while (* p == '*')
+	{
+		p++;
+	}
+	return * p == '\0';
+}
+
+
+//----------
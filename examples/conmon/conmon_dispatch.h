@@ -0,0 +1,221 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Send one control message to many devices at once and gather the responses
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_DISPATCH_H
+#define _CONMON_DISPATCH_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	A dispatch tracks one message going to a set of target devices. The
+	application adds the targets, then loops: it asks for the next target
+	to send to, sends, and tells the dispatch the request id it got back.
+	Responses arrive in any order and are matched to their target through
+	a completion table keyed by request id, so there is no waiting on one
+	device before sending to the next.
+
+	Up to window targets are in flight at once. A target that has not been
+	answered within timeout_ms of being sent is marked TIMEDOUT, and a late
+	response to it is ignored.
+
+	Targets are added by name, with case-insensitive duplicates dropped.
+	conmon_dispatch_match matches a name against a glob such as "stage-*"
+	for applications that expand patterns against the devices they can see.
+ */
+
+typedef struct conmon_dispatch conmon_dispatch_t;
+
+typedef enum
+{
+	CONMON_DISPATCH_TARGET_PENDING,
+	CONMON_DISPATCH_TARGET_SENT,
+		// waiting for a response
+	CONMON_DISPATCH_TARGET_DONE,
+	CONMON_DISPATCH_TARGET_FAILED,
+		// the send or the response gave an error
+	CONMON_DISPATCH_TARGET_TIMEDOUT,
+	CONMON_NUM_DISPATCH_TARGET_STATES
+} conmon_dispatch_target_state_t;
+
+typedef struct conmon_dispatch_target
+{
+	conmon_name_t device_name;
+	conmon_dispatch_target_state_t state;
+	conmon_client_request_id_t request_id;
+		// valid while SENT
+	aud_error_t result;
+		// AUD_SUCCESS until the target fails or times out
+	uint64_t sent_ms;
+	uint64_t done_ms;
+		// when a SENT target times out, or when it finished
+} conmon_dispatch_target_t;
+
+typedef struct conmon_dispatch_summary
+{
+	unsigned int num_targets;
+	unsigned int num_in_state [CONMON_NUM_DISPATCH_TARGET_STATES];
+	unsigned long num_late;
+		// responses that arrived after their target timed out, or for no target
+	uint64_t max_elapsed_ms;
+		// longest time from sending to a response
+} conmon_dispatch_summary_t;
+
+
+//----------
+// Functions
+
+// A window of 0 sends to every target at once
+aud_error_t
+conmon_dispatch_new
+(
+	unsigned int max_targets,
+	unsigned int window,
+	unsigned int timeout_ms,
+	conmon_dispatch_t ** dispatch_ptr
+);
+
+void
+conmon_dispatch_delete
+(
+	conmon_dispatch_t * dispatch
+);
+
+// Adding a device that is already a target does nothing
+// @return AUD_ERR_NOBUFS if max_targets devices are already targets
+aud_error_t
+conmon_dispatch_add
+(
+	conmon_dispatch_t * dispatch,
+	const char * device_name
+);
+
+/*
+	If a target should be sent to now, return AUD_TRUE with its index.
+	The caller must then call conmon_dispatch_sent for it. Call repeatedly
+	until it returns AUD_FALSE.
+ */
+aud_bool_t
+conmon_dispatch_next
+(
+	conmon_dispatch_t * dispatch,
+	unsigned int * target_index
+);
+
+/*
+	Record the result of sending to a target. On success the request id is
+	entered in the completion table and the target is SENT; otherwise the
+	target FAILED with that result.
+ */
+void
+conmon_dispatch_sent
+(
+	conmon_dispatch_t * dispatch,
+	unsigned int target_index,
+	aud_error_t result,
+	conmon_client_request_id_t request_id,
+	uint64_t now_ms
+);
+
+/*
+	Record the server's response to a request.
+
+	@return AUD_TRUE with the target's index (if target_index is not NULL)
+	if the request id belongs to a SENT target
+ */
+aud_bool_t
+conmon_dispatch_response
+(
+	conmon_dispatch_t * dispatch,
+	conmon_client_request_id_t request_id,
+	aud_error_t result,
+	uint64_t now_ms,
+	unsigned int * target_index
+);
+
+// Time out SENT targets whose deadline has passed
+void
+conmon_dispatch_expire
+(
+	conmon_dispatch_t * dispatch,
+	uint64_t now_ms
+);
+
+// Milliseconds until the next target times out, for use as a poll timeout
+unsigned int
+conmon_dispatch_ms_to_next
+(
+	const conmon_dispatch_t * dispatch,
+	uint64_t now_ms
+);
+
+// True once no target is PENDING or SENT
+aud_bool_t
+conmon_dispatch_is_finished
+(
+	const conmon_dispatch_t * dispatch
+);
+
+unsigned int
+conmon_dispatch_num_targets
+(
+	const conmon_dispatch_t * dispatch
+);
+
+const conmon_dispatch_target_t *
+conmon_dispatch_target_at_index
+(
+	const conmon_dispatch_t * dispatch,
+	unsigned int target_index
+);
+
+void
+conmon_dispatch_get_summary
+(
+	const conmon_dispatch_t * dispatch,
+	conmon_dispatch_summary_t * summary
+);
+
+const char *
+conmon_dispatch_target_state_to_string
+(
+	conmon_dispatch_target_state_t state
+);
+
+// True if pattern contains any of the glob characters '*', '?' or '['
+aud_bool_t
+conmon_dispatch_is_pattern
+(
+	const char * pattern
+);
+
+/*
+	Match a device name against a glob, ignoring case. '*' matches any run
+	of characters, '?' any one character, and "[a-z0-9]" any one character
+	in the set, or not in it if the set starts with '!'.
+ */
+aud_bool_t
+conmon_dispatch_match
+(
+	const char * pattern,
+	const char * device_name
+);
+
+
+//----------
+
+#endif // _CONMON_DISPATCH_H
@@ -30,6 +30,7 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <time.h>
 #define SNPRINTF snprintf
 #define STRCASECMP strcasecmp
 #endif
@@ -74,6 +75,27 @@ conmon_example_sleep
 
 #define ONE_SECOND_US 1000000
 
+// A monotonic clock in nanoseconds for timing benchmarks
+AUD_INLINE uint64_t
+conmon_example_clock_ns (void)
+{
+#ifdef WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER now;
+	if (! freq.QuadPart)
+	{
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&now);
+	return (uint64_t) (now.QuadPart / freq.QuadPart) * 1000000000
+		+ (uint64_t) (now.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
 //----------------------------------------------------------
 // Support functions for the example clients
 //----------------------------------------------------------
@@ -0,0 +1,869 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Group devices into clock and format domains and check routes between them
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_format_check.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+#define FORMAT_NO_ENTRY 0xFFFFFFFFu
+
+// Kept beside each public device entry
+typedef struct format_device_state
+{
+	uint32_t first_in;
+	uint32_t first_out;
+		// heads of the device's route lists
+	aud_bool_t unplaced;
+		// a domain it belongs in could not be made
+	aud_bool_t have_instance_id;
+		// a status has come from the device and its id is in the id map
+} format_device_state_t;
+
+typedef struct format_route_links
+{
+	uint32_t next_in;
+		// the next route into the same receiver
+	uint32_t next_out;
+		// the next route out of the same transmitter
+} format_route_links_t;
+
+/*
+	Devices are stored densely in order of first mention and indexed by an
+	open addressing table keyed on a case-folded hash of the name, which is
+	what routes give. Status arrives with the device's instance id, so the
+	first status from a device also maps its id to the entry and later ones
+	find it through that map without hashing the name. Routes
+	are stored densely too, threaded onto two singly linked lists per
+	device. There are only a handful of distinct formats on a network, so
+	domains are short arrays searched linearly.
+ */
+struct conmon_format_check
+{
+	unsigned int max_devices;
+	unsigned int max_routes;
+	conmon_format_mismatch_fn * mismatch_fn;
+	void * mismatch_context;
+
+	conmon_format_device_t * devices;
+	format_device_state_t * states;
+	unsigned int num_devices;
+	uint32_t * index;
+	uint32_t index_mask;
+	dapi_id_map_t * ids;
+		// instance id to device index
+
+	conmon_format_route_t * routes;
+	format_route_links_t * route_links;
+	unsigned int num_routes;
+
+	conmon_format_domain_t clock_domains [CONMON_FORMAT_MAX_DOMAINS];
+	unsigned int num_clock_slots;
+	conmon_format_domain_t format_domains [CONMON_FORMAT_MAX_DOMAINS];
+	unsigned int num_format_slots;
+
+	unsigned int num_unplaced;
+	unsigned int num_clock_mismatches;
+	unsigned int num_encoding_mismatches;
+	unsigned long num_updates;
+};
+
+
+//----------
+// Local functions
+
+static uint32_t
+find_entry (const conmon_format_check_t * check, const char * name, uint32_t * slot_ptr)
+{
+	uint32_t slot = dapi_name_hash (name) & check->index_mask;
+	uint32_t i;
+
+	while ((i = check->index [slot]) != FORMAT_NO_ENTRY)
+	{
+		if (dapi_name_equals (check->devices [i].name, name))
+		{
+			break;
+		}
+		slot = (slot + 1) & check->index_mask;
+	}
+	if (slot_ptr)
+	{
+		* slot_ptr = slot;
+	}
+	return i;
+}
+
+
+static aud_bool_t
+is_available (const conmon_format_available_t * available, uint32_t value)
+{
+	uint16_t i;
+
+	if (available->values_kept < available->num_values)
+	{
+		// can't rule anything out from a partial list
+		return AUD_TRUE;
+	}
+	for (i = 0; i < available->values_kept; i++)
+	{
+		if (available->values [i] == value)
+		{
+			return AUD_TRUE;
+		}
+	}
+	return AUD_FALSE;
+}
+
+
+static void
+set_available (conmon_format_available_t * available, uint16_t num_values, uint16_t values_decoded, const uint32_t * values)
+{
+	available->num_values = num_values;
+	available->values_kept = values_decoded;
+	memcpy (available->values, values, values_decoded * sizeof (uint32_t));
+}
+
+
+static unsigned int
+join_domain (conmon_format_domain_t * domains, unsigned int * num_slots, const conmon_format_t * format)
+{
+	unsigned int i, empty = CONMON_FORMAT_NO_DOMAIN;
+
+	for (i = 0; i < * num_slots; i++)
+	{
+		const conmon_format_domain_t * domain = domains + i;
+		if (domain->format.srate == format->srate && domain->format.pullup == format->pullup
+			&& domain->format.encoding == format->encoding)
+		{
+			break;
+		}
+		if (! domain->num_devices && empty == CONMON_FORMAT_NO_DOMAIN)
+		{
+			empty = i;
+		}
+	}
+	if (i == * num_slots)
+	{
+		if (empty != CONMON_FORMAT_NO_DOMAIN)
+		{
+			i = empty;
+		}
+		else if (* num_slots < CONMON_FORMAT_MAX_DOMAINS)
+		{
+			(* num_slots)++;
+		}
+		else
+		{
+			return CONMON_FORMAT_NO_DOMAIN;
+		}
+		domains [i].format = * format;
+		domains [i].num_devices = 0;
+	}
+	domains [i].num_devices++;
+	return i;
+}
+
+
+// Move a device out of its domains and into those its current format and known parts give
+static void
+place_device (conmon_format_check_t * check, unsigned int device_index)
+{
+	conmon_format_device_t * device = check->devices + device_index;
+	format_device_state_t * state = check->states + device_index;
+	const unsigned int format_parts = CONMON_FORMAT_SRATE | CONMON_FORMAT_ENCODING;
+
+	if (device->clock_domain != CONMON_FORMAT_NO_DOMAIN)
+	{
+		check->clock_domains [device->clock_domain].num_devices--;
+		device->clock_domain = CONMON_FORMAT_NO_DOMAIN;
+	}
+	if (device->format_domain != CONMON_FORMAT_NO_DOMAIN)
+	{
+		check->format_domains [device->format_domain].num_devices--;
+		device->format_domain = CONMON_FORMAT_NO_DOMAIN;
+	}
+	if (state->unplaced)
+	{
+		check->num_unplaced--;
+		state->unplaced = AUD_FALSE;
+	}
+
+	if (device->known & CONMON_FORMAT_SRATE)
+	{
+		conmon_format_t clock = device->current;
+
+		clock.encoding = 0;
+		device->clock_domain = join_domain (check->clock_domains, & check->num_clock_slots, & clock);
+		state->unplaced = (device->clock_domain == CONMON_FORMAT_NO_DOMAIN);
+	}
+	if ((device->known & format_parts) == format_parts)
+	{
+		device->format_domain = join_domain (check->format_domains, & check->num_format_slots, & device->current);
+		state->unplaced |= (device->format_domain == CONMON_FORMAT_NO_DOMAIN);
+	}
+	if (state->unplaced)
+	{
+		check->num_unplaced++;
+	}
+}
+
+
+static unsigned int
+route_mismatch (const conmon_format_device_t * rx, const conmon_format_device_t * tx)
+{
+	unsigned int mismatch = 0;
+
+	if ((rx->known & tx->known & CONMON_FORMAT_SRATE)
+		&& (rx->current.srate != tx->current.srate || rx->current.pullup != tx->current.pullup))
+	{
+		mismatch |= CONMON_FORMAT_MISMATCH_CLOCK;
+	}
+	if ((rx->known & tx->known & CONMON_FORMAT_ENCODING) && rx->current.encoding != tx->current.encoding)
+	{
+		mismatch |= CONMON_FORMAT_MISMATCH_ENCODING;
+	}
+	return mismatch;
+}
+
+
+static void
+check_route (conmon_format_check_t * check, uint32_t route_index, uint64_t now_ms)
+{
+	conmon_format_route_t * route = check->routes + route_index;
+	conmon_format_device_t * rx = check->devices + route->rx_device;
+	conmon_format_device_t * tx = check->devices + route->tx_device;
+	const unsigned int mismatch = route_mismatch (rx, tx);
+	const unsigned int previous = route->mismatch;
+	conmon_format_mismatch_t event;
+
+	if (mismatch == previous)
+	{
+		return;
+	}
+	route->mismatch = mismatch;
+
+	if ((mismatch ^ previous) & CONMON_FORMAT_MISMATCH_CLOCK)
+	{
+		if (mismatch & CONMON_FORMAT_MISMATCH_CLOCK)
+		{
+			check->num_clock_mismatches++;
+		}
+		else
+		{
+			check->num_clock_mismatches--;
+		}
+	}
+	if ((mismatch ^ previous) & CONMON_FORMAT_MISMATCH_ENCODING)
+	{
+		if (mismatch & CONMON_FORMAT_MISMATCH_ENCODING)
+		{
+			check->num_encoding_mismatches++;
+		}
+		else
+		{
+			check->num_encoding_mismatches--;
+		}
+	}
+	if (! previous)
+	{
+		rx->num_mismatched++;
+		tx->num_mismatched++;
+	}
+	else if (! mismatch)
+	{
+		rx->num_mismatched--;
+		tx->num_mismatched--;
+	}
+
+	if (check->mismatch_fn)
+	{
+		event.route = route;
+		event.route_index = route_index;
+		event.rx = rx;
+		event.tx = tx;
+		event.previous = previous;
+		event.now_ms = now_ms;
+		check->mismatch_fn (check->mismatch_context, & event);
+	}
+}
+
+
+static void
+check_device_routes (conmon_format_check_t * check, unsigned int device_index, uint64_t now_ms)
+{
+	const format_device_state_t * state = check->states + device_index;
+	uint32_t r;
+
+	for (r = state->first_in; r != FORMAT_NO_ENTRY; r = check->route_links [r].next_in)
+	{
+		check_route (check, r, now_ms);
+	}
+	for (r = state->first_out; r != FORMAT_NO_ENTRY; r = check->route_links [r].next_out)
+	{
+		check_route (check, r, now_ms);
+	}
+}
+
+
+/*
+	Find the device a status came from by its id, falling back to its name
+	the first time. A device keeps the name it was first mentioned by, as
+	routes refer to it that way. If a second device later turns up with the
+	name of one already mapped, it shares the entry but is looked up by
+	name, so the map never holds more ids than there are devices.
+ */
+static aud_error_t
+find_status_device
+(
+	conmon_format_check_t * check,
+	const conmon_instance_id_t * instance_id,
+	const char * name,
+	unsigned int * device_index
+)
+{
+	unsigned int m = dapi_id_map_find (check->ids, instance_id);
+	aud_error_t result;
+
+	if (m != DAPI_ID_MAP_NO_ENTRY)
+	{
+		* device_index = * (const uint32_t *) dapi_id_map_value_at (check->ids, m);
+		return AUD_SUCCESS;
+	}
+	result = conmon_format_check_add_device (check, name, device_index);
+	if (result == AUD_SUCCESS && ! check->states [* device_index].have_instance_id)
+	{
+		// cannot fail, each device adds at most one id
+		dapi_id_map_insert (check->ids, instance_id, & m, NULL);
+		* (uint32_t *) dapi_id_map_value_at (check->ids, m) = * device_index;
+		check->states [* device_index].have_instance_id = AUD_TRUE;
+	}
+	return result;
+}
+
+
+// Called after a status has been applied to the device
+static void
+device_updated
+(
+	conmon_format_check_t * check,
+	unsigned int device_index,
+	const conmon_format_t * was,
+	unsigned int was_known,
+	uint64_t now_ms
+)
+{
+	conmon_format_device_t * device = check->devices + device_index;
+
+	check->num_updates++;
+	device->last_update_ms = now_ms;
+
+	// resent status is the common case, and changes nothing
+	if (device->known == was_known && device->current.srate == was->srate
+		&& device->current.pullup == was->pullup && device->current.encoding == was->encoding)
+	{
+		return;
+	}
+	place_device (check, device_index);
+	check_device_routes (check, device_index, now_ms);
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_format_check_new
+(
+	unsigned int max_devices,
+	unsigned int max_routes,
+	conmon_format_mismatch_fn * mismatch_fn,
+	void * mismatch_context,
+	conmon_format_check_t ** check_ptr
+)
+{
+	conmon_format_check_t * check;
+	uint32_t index_size = 1;
+
+	if (! check_ptr || ! max_devices || max_devices > 0x1000000 || max_routes > 0x1000000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (index_size < 2 * max_devices)
+	{
+		index_size <<= 1;
+	}
+
+	check = calloc (1, sizeof (* check));
+	if (! check)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	check->devices = malloc (max_devices * sizeof (* check->devices));
+	check->states = malloc (max_devices * sizeof (* check->states));
+	check->index = malloc (index_size * sizeof (uint32_t));
+	dapi_id_map_new (max_devices, sizeof (uint32_t), & check->ids);
+	if (max_routes)
+	{
+		check->routes = malloc (max_routes * sizeof (* check->routes));
+		check->route_links = malloc (max_routes * sizeof (* check->route_links));
+	}
+	if (! (check->devices && check->states && check->index && check->ids)
+		|| (max_routes && ! (check->routes && check->route_links)))
+	{
+		conmon_format_check_delete (check);
+		return AUD_ERR_NOMEMORY;
+	}
+	// 0xFF bytes give FORMAT_NO_ENTRY in every slot
+	memset (check->index, 0xFF, index_size * sizeof (uint32_t));
+
+	check->max_devices = max_devices;
+	check->max_routes = max_routes;
+	check->mismatch_fn = mismatch_fn;
+	check->mismatch_context = mismatch_context;
+	check->index_mask = index_size - 1;
+
+	* check_ptr = check;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_format_check_delete
+(
+	conmon_format_check_t * check
+)
+{
+	if (check)
+	{
+		free (check->route_links);
+		free (check->routes);
+		dapi_id_map_delete (check->ids);
+		free (check->index);
+		free (check->states);
+		free (check->devices);
+		free (check);
+	}
+}
+
+
+aud_error_t
+conmon_format_check_add_device
+(
+	conmon_format_check_t * check,
+	const char * name,
+	unsigned int * device_index
+)
+{
+	conmon_format_device_t * device;
+	format_device_state_t * state;
+	uint32_t slot, i;
+
+	if (! name || ! name [0] || strlen (name) >= sizeof (device->name))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	i = find_entry (check, name, & slot);
+	if (i == FORMAT_NO_ENTRY)
+	{
+		if (check->num_devices == check->max_devices)
+		{
+			return AUD_ERR_NOBUFS;
+		}
+		i = check->num_devices++;
+		check->index [slot] = i;
+
+		device = check->devices + i;
+		memset (device, 0, sizeof (* device));
+		strcpy (device->name, name);
+		device->clock_domain = CONMON_FORMAT_NO_DOMAIN;
+		device->format_domain = CONMON_FORMAT_NO_DOMAIN;
+
+		state = check->states + i;
+		state->first_in = FORMAT_NO_ENTRY;
+		state->first_out = FORMAT_NO_ENTRY;
+		state->unplaced = AUD_FALSE;
+		state->have_instance_id = AUD_FALSE;
+	}
+	if (device_index)
+	{
+		* device_index = i;
+	}
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_format_check_add_route
+(
+	conmon_format_check_t * check,
+	const char * rx_name,
+	const char * tx_name,
+	uint64_t now_ms
+)
+{
+	unsigned int rx, tx;
+	aud_error_t result;
+	uint32_t r;
+
+	result = conmon_format_check_add_device (check, rx_name, & rx);
+	if (result == AUD_SUCCESS)
+	{
+		result = conmon_format_check_add_device (check, tx_name, & tx);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	for (r = check->states [rx].first_in; r != FORMAT_NO_ENTRY; r = check->route_links [r].next_in)
+	{
+		if (check->routes [r].tx_device == tx)
+		{
+			return AUD_SUCCESS;
+		}
+	}
+	if (check->num_routes == check->max_routes)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+
+	r = check->num_routes++;
+	check->routes [r].rx_device = rx;
+	check->routes [r].tx_device = tx;
+	check->routes [r].mismatch = 0;
+	check->route_links [r].next_in = check->states [rx].first_in;
+	check->route_links [r].next_out = check->states [tx].first_out;
+	check->states [rx].first_in = r;
+	check->states [tx].first_out = r;
+	check->devices [rx].num_routes++;
+	if (tx != rx)
+	{
+		check->devices [tx].num_routes++;
+	}
+
+	check_route (check, r, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_format_check_update_srate
+(
+	conmon_format_check_t * check,
+	const conmon_instance_id_t * instance_id,
+	const char * name,
+	const conmon_aud_decoded_srate_status_t * status,
+	uint64_t now_ms
+)
+{
+	conmon_format_device_t * device;
+	conmon_format_t was;
+	unsigned int d, was_known;
+	aud_error_t result = find_status_device (check, instance_id, name, & d);
+
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	device = check->devices + d;
+	was = device->current;
+	was_known = device->known;
+
+	device->current.srate = status->current;
+	device->reboot.srate = status->reboot;
+	device->known |= CONMON_FORMAT_SRATE;
+	set_available (& device->srates, status->num_available, status->available_decoded, status->available);
+
+	device_updated (check, d, & was, was_known, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_format_check_update_pullup
+(
+	conmon_format_check_t * check,
+	const conmon_instance_id_t * instance_id,
+	const char * name,
+	const conmon_aud_decoded_pullup_status_t * status,
+	uint64_t now_ms
+)
+{
+	conmon_format_device_t * device;
+	conmon_format_t was;
+	unsigned int d, was_known;
+	aud_error_t result = find_status_device (check, instance_id, name, & d);
+
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	device = check->devices + d;
+	was = device->current;
+	was_known = device->known;
+
+	device->current.pullup = status->current;
+	device->reboot.pullup = status->reboot;
+	device->known |= CONMON_FORMAT_PULLUP;
+	set_available (& device->pullups, status->num_available, status->available_decoded, status->available);
+
+	device_updated (check, d, & was, was_known, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_format_check_update_encoding
+(
+	conmon_format_check_t * check,
+	const conmon_instance_id_t * instance_id,
+	const char * name,
+	const conmon_aud_decoded_srate_status_t * status,
+	uint64_t now_ms
+)
+{
+	conmon_format_device_t * device;
+	conmon_format_t was;
+	unsigned int d, was_known;
+	aud_error_t result = find_status_device (check, instance_id, name, & d);
+
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	device = check->devices + d;
+	was = device->current;
+	was_known = device->known;
+
+	device->current.encoding = status->current;
+	device->reboot.encoding = status->reboot;
+	device->known |= CONMON_FORMAT_ENCODING;
+	set_available (& device->encodings, status->num_available, status->available_decoded, status->available);
+
+	device_updated (check, d, & was, was_known, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+const conmon_format_device_t *
+conmon_format_check_device_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+)
+{
+	return (index < check->num_devices) ? check->devices + index : NULL;
+}
+
+
+const conmon_format_device_t *
+conmon_format_check_find
+(
+	const conmon_format_check_t * check,
+	const char * name
+)
+{
+	const uint32_t i = find_entry (check, name, NULL);
+	return (i == FORMAT_NO_ENTRY) ? NULL : check->devices + i;
+}
+
+
+const conmon_format_route_t *
+conmon_format_check_route_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+)
+{
+	return (index < check->num_routes) ? check->routes + index : NULL;
+}
+
+
+const conmon_format_domain_t *
+conmon_format_check_clock_domain_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+)
+{
+	return (index < check->num_clock_slots) ? check->clock_domains + index : NULL;
+}
+
+
+const conmon_format_domain_t *
+conmon_format_check_format_domain_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+)
+{
+	return (index < check->num_format_slots) ? check->format_domains + index : NULL;
+}
+
+
+aud_bool_t
+conmon_format_check_get_reference
+(
+	const conmon_format_check_t * check,
+	conmon_format_t * format
+)
+{
+	const conmon_format_domain_t * best = NULL;
+	unsigned int i;
+
+	for (i = 0; i < check->num_format_slots; i++)
+	{
+		const conmon_format_domain_t * domain = check->format_domains + i;
+		if (domain->num_devices && (! best || domain->num_devices > best->num_devices))
+		{
+			best = domain;
+		}
+	}
+	if (! best)
+	{
+		return AUD_FALSE;
+	}
+	* format = best->format;
+	return AUD_TRUE;
+}
+
+
+unsigned int
+conmon_format_check_corrections
+(
+	const conmon_format_check_t * check,
+	const conmon_format_t * target,
+	unsigned int parts,
+	aud_bool_t routed_only,
+	conmon_format_correction_fn * correction_fn,
+	void * correction_context
+)
+{
+	unsigned int d, num_needed = 0;
+
+	for (d = 0; d < check->num_devices; d++)
+	{
+		const conmon_format_device_t * device = check->devices + d;
+		const unsigned int known = device->known & parts;
+		conmon_format_correction_t correction;
+
+		if (! known || (routed_only && ! device->num_routes))
+		{
+			continue;
+		}
+		memset (& correction, 0, sizeof (correction));
+
+		if ((known & CONMON_FORMAT_SRATE) && device->current.srate != target->srate)
+		{
+			if (device->reboot.srate == target->srate)
+			{
+				correction.pending |= CONMON_FORMAT_SRATE;
+			}
+			else
+			{
+				correction.needed |= CONMON_FORMAT_SRATE;
+				if (! is_available (& device->srates, target->srate))
+				{
+					correction.impossible |= CONMON_FORMAT_SRATE;
+				}
+			}
+		}
+		if ((known & CONMON_FORMAT_PULLUP) && device->current.pullup != target->pullup)
+		{
+			if (device->reboot.pullup == target->pullup)
+			{
+				correction.pending |= CONMON_FORMAT_PULLUP;
+			}
+			else
+			{
+				correction.needed |= CONMON_FORMAT_PULLUP;
+				if (! is_available (& device->pullups, target->pullup))
+				{
+					correction.impossible |= CONMON_FORMAT_PULLUP;
+				}
+			}
+		}
+		if ((known & CONMON_FORMAT_ENCODING) && device->current.encoding != target->encoding)
+		{
+			if (device->reboot.encoding == target->encoding)
+			{
+				correction.pending |= CONMON_FORMAT_ENCODING;
+			}
+			else
+			{
+				correction.needed |= CONMON_FORMAT_ENCODING;
+				if (! is_available (& device->encodings, target->encoding))
+				{
+					correction.impossible |= CONMON_FORMAT_ENCODING;
+				}
+			}
+		}
+
+		if (! (correction.needed | correction.pending))
+		{
+			continue;
+		}
+		if (correction.needed)
+		{
+			num_needed++;
+		}
+		if (correction_fn)
+		{
+			correction.device = device;
+			correction.device_index = d;
+			correction_fn (correction_context, & correction);
+		}
+	}
+	return num_needed;
+}
+
+
+void
+conmon_format_check_get_summary
+(
+	const conmon_format_check_t * check,
+	conmon_format_summary_t * summary
+)
+{
+	unsigned int i;
+
+	memset (summary, 0, sizeof (* summary));
+	for (i = 0; i < check->num_clock_slots; i++)
+	{
+		if (check->clock_domains [i].num_devices)
+		{
+			summary->num_clock_domains++;
+		}
+	}
+	for (i = 0; i < check->num_format_slots; i++)
+	{
+		if (check->format_domains [i].num_devices)
+		{
+			summary->num_format_domains++;
+		}
+	}
+	summary->num_devices = check->num_devices;
+	summary->num_unplaced = check->num_unplaced;
+	summary->num_routes = check->num_routes;
+	summary->num_clock_mismatches = check->num_clock_mismatches;
+	summary->num_encoding_mismatches = check->num_encoding_mismatches;
+	summary->num_updates = check->num_updates;
+}
+
+
+//----------
@@ -0,0 +1,352 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Group devices into clock and format domains and check routes between them
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_FORMAT_CHECK_H
+#define _CONMON_FORMAT_CHECK_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_aud_decode_msg.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The check keeps the sample rate, pullup and encoding each device last
+	reported, current and after reboot, along with what it says it can
+	run at. Devices are keyed by name, case-insensitively, since that is
+	how routes name them. Status updates also carry the sending device's
+	instance id, and once a device has been seen that is how its updates
+	find it.
+
+	Devices on the same sample rate and pullup are in one clock domain,
+	and those that also share an encoding are in one format domain. A
+	device that has never reported a pullup is taken to have none. Member
+	counts are kept as devices move, so the domains are always current.
+
+	Routes are added as (receiver, transmitter) pairs. Each device keeps
+	lists of the routes into and out of it, so a status only rechecks the
+	routes that touch that device and a mismatch is reported while the
+	status is being handled. A route mismatches on CLOCK when its ends are
+	in different clock domains and on ENCODING when they have different
+	encodings; a part is only checked once both ends have reported it.
+
+	Corrections compare each device with a target format, usually the
+	reference (the largest format domain). A device whose reboot value
+	already matches is pending rather than needing a change, and a target
+	missing from the device's complete list of available values is
+	reported as not possible.
+ */
+
+enum
+{
+	CONMON_FORMAT_MAX_DOMAINS = 64,
+		// distinct formats tracked; devices in any others are counted as unplaced
+	CONMON_FORMAT_MAX_AVAILABLE = CONMON_AUD_DECODE_MAX_SRATES
+};
+
+#define CONMON_FORMAT_NO_DOMAIN 0xFFFFFFFFu
+
+// Parts of a format, used for what a device has reported and for what differs
+enum
+{
+	CONMON_FORMAT_SRATE = 0x01,
+	CONMON_FORMAT_PULLUP = 0x02,
+	CONMON_FORMAT_ENCODING = 0x04,
+	CONMON_FORMAT_ALL = 0x07
+};
+
+// Route mismatch bits
+enum
+{
+	CONMON_FORMAT_MISMATCH_CLOCK = 0x01,
+		// sample rate or pullup differ
+	CONMON_FORMAT_MISMATCH_ENCODING = 0x02
+};
+
+typedef struct conmon_format_check conmon_format_check_t;
+
+typedef struct conmon_format
+{
+	uint32_t srate;
+		// in Hz
+	uint32_t pullup;
+		// a CONMON_AUDINATE_SRATE_PULLUP value
+	uint32_t encoding;
+} conmon_format_t;
+
+typedef struct conmon_format_available
+{
+	uint16_t num_values;
+		// as reported by the device
+	uint16_t values_kept;
+	uint32_t values [CONMON_FORMAT_MAX_AVAILABLE];
+} conmon_format_available_t;
+
+typedef struct conmon_format_device
+{
+	conmon_name_t name;
+	unsigned int known;
+		// CONMON_FORMAT_* bits for the parts the device has reported
+	conmon_format_t current;
+	conmon_format_t reboot;
+		// what the device will run at after a reboot
+	conmon_format_available_t srates;
+	conmon_format_available_t pullups;
+	conmon_format_available_t encodings;
+	unsigned int clock_domain;
+	unsigned int format_domain;
+		// CONMON_FORMAT_NO_DOMAIN until the parts they need are known
+	unsigned int num_routes;
+	unsigned int num_mismatched;
+		// routes into or out of the device that mismatch
+	uint64_t last_update_ms;
+} conmon_format_device_t;
+
+// Clock domains have an encoding of 0
+typedef struct conmon_format_domain
+{
+	conmon_format_t format;
+	unsigned int num_devices;
+		// 0 once the last member has left; the slot is then reused
+} conmon_format_domain_t;
+
+typedef struct conmon_format_route
+{
+	unsigned int rx_device;
+	unsigned int tx_device;
+		// device indexes
+	unsigned int mismatch;
+		// CONMON_FORMAT_MISMATCH_* bits
+} conmon_format_route_t;
+
+typedef struct conmon_format_mismatch
+{
+	const conmon_format_route_t * route;
+	unsigned int route_index;
+	const conmon_format_device_t * rx;
+	const conmon_format_device_t * tx;
+	unsigned int previous;
+		// the route's mismatch bits before this change
+	uint64_t now_ms;
+} conmon_format_mismatch_t;
+
+// Called whenever a route's mismatch bits change, including when it is added mismatched
+typedef void
+conmon_format_mismatch_fn
+(
+	void * context,
+	const conmon_format_mismatch_t * mismatch
+);
+
+typedef struct conmon_format_correction
+{
+	const conmon_format_device_t * device;
+	unsigned int device_index;
+	unsigned int needed;
+		// CONMON_FORMAT_* parts to change
+	unsigned int pending;
+		// parts already set to change at the next reboot
+	unsigned int impossible;
+		// needed parts whose target the device does not offer
+} conmon_format_correction_t;
+
+typedef void
+conmon_format_correction_fn
+(
+	void * context,
+	const conmon_format_correction_t * correction
+);
+
+typedef struct conmon_format_summary
+{
+	unsigned int num_devices;
+	unsigned int num_clock_domains;
+	unsigned int num_format_domains;
+		// with at least one member
+	unsigned int num_unplaced;
+		// devices left out because CONMON_FORMAT_MAX_DOMAINS were in use
+	unsigned int num_routes;
+	unsigned int num_clock_mismatches;
+	unsigned int num_encoding_mismatches;
+	unsigned long num_updates;
+} conmon_format_summary_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_format_check_new
+(
+	unsigned int max_devices,
+	unsigned int max_routes,
+	conmon_format_mismatch_fn * mismatch_fn,
+	void * mismatch_context,
+	conmon_format_check_t ** check_ptr
+);
+
+void
+conmon_format_check_delete
+(
+	conmon_format_check_t * check
+);
+
+/*
+	Find a device by name, adding it if it is new.
+
+	@return AUD_ERR_NOBUFS if max_devices are already tracked,
+	AUD_ERR_INVALIDPARAMETER if the name is empty or too long
+ */
+aud_error_t
+conmon_format_check_add_device
+(
+	conmon_format_check_t * check,
+	const char * name,
+	unsigned int * device_index
+);
+
+/*
+	Add a route from tx_name to rx_name, adding either device if new, and
+	check it. Adding a route that exists already does nothing.
+
+	@return as conmon_format_check_add_device, or AUD_ERR_NOBUFS if
+	max_routes are already tracked
+ */
+aud_error_t
+conmon_format_check_add_route
+(
+	conmon_format_check_t * check,
+	const char * rx_name,
+	const char * tx_name,
+	uint64_t now_ms
+);
+
+/*
+	Apply a sample rate, pullup or encoding status from a device and
+	recheck its routes. The name is only used the first time instance_id
+	is seen.
+
+	@return as conmon_format_check_add_device
+ */
+aud_error_t
+conmon_format_check_update_srate
+(
+	conmon_format_check_t * check,
+	const conmon_instance_id_t * instance_id,
+	const char * name,
+	const conmon_aud_decoded_srate_status_t * status,
+	uint64_t now_ms
+);
+
+aud_error_t
+conmon_format_check_update_pullup
+(
+	conmon_format_check_t * check,
+	const conmon_instance_id_t * instance_id,
+	const char * name,
+	const conmon_aud_decoded_pullup_status_t * status,
+	uint64_t now_ms
+);
+
+aud_error_t
+conmon_format_check_update_encoding
+(
+	conmon_format_check_t * check,
+	const conmon_instance_id_t * instance_id,
+	const char * name,
+	const conmon_aud_decoded_srate_status_t * status,
+	uint64_t now_ms
+);
+
+// Devices are never removed, so index runs from 0 to num_devices - 1 in order of first mention
+const conmon_format_device_t *
+conmon_format_check_device_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+);
+
+// NULL if the device has not been seen
+const conmon_format_device_t *
+conmon_format_check_find
+(
+	const conmon_format_check_t * check,
+	const char * name
+);
+
+const conmon_format_route_t *
+conmon_format_check_route_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+);
+
+// Slots up to CONMON_FORMAT_MAX_DOMAINS; NULL past the last one used
+const conmon_format_domain_t *
+conmon_format_check_clock_domain_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+);
+
+const conmon_format_domain_t *
+conmon_format_check_format_domain_at_index
+(
+	const conmon_format_check_t * check,
+	unsigned int index
+);
+
+/*
+	Get the format of the format domain with the most members, the first
+	formed winning a tie.
+
+	@return AUD_FALSE if no device has reported both sample rate and encoding
+ */
+aud_bool_t
+conmon_format_check_get_reference
+(
+	const conmon_format_check_t * check,
+	conmon_format_t * format
+);
+
+/*
+	Compare the parts of target given in parts with every device that has
+	reported them, or only devices with a route if routed_only is set, and
+	call correction_fn for each device that differs.
+
+	@return the number of devices with a needed part
+ */
+unsigned int
+conmon_format_check_corrections
+(
+	const conmon_format_check_t * check,
+	const conmon_format_t * target,
+	unsigned int parts,
+	aud_bool_t routed_only,
+	conmon_format_correction_fn * correction_fn,
+	void * correction_context
+);
+
+void
+conmon_format_check_get_summary
+(
+	const conmon_format_check_t * check,
+	conmon_format_summary_t * summary
+);
+
+
+//----------
+
+#endif // _CONMON_FORMAT_CHECK_H
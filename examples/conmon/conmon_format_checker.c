@@ -0,0 +1,1031 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Check sample rate, pullup and encoding across all devices and the routes between them
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_control_builder.h"
+#include "conmon_dispatch.h"
+#include "conmon_format_check.h"
+#include "conmon_name_cache.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	FORMAT_NAME_CACHE_SIZE = 2048,
+	FORMAT_DEFAULT_MAX_DEVICES = 1024,
+	FORMAT_DEFAULT_MAX_ROUTES = 8192,
+	FORMAT_DEFAULT_SETTLE_S = 10,
+	FORMAT_DISPATCH_WINDOW = 64,
+	FORMAT_DISPATCH_TIMEOUT_MS = 6000,
+	FORMAT_LINE_LENGTH = 256
+};
+
+// The parts of a format in the order corrections and queries are sent
+enum
+{
+	PART_SRATE,
+	PART_PULLUP,
+	PART_ENCODING,
+	NUM_PARTS
+};
+
+typedef struct format_part
+{
+	const char * cmd;
+		// the control builder spec
+	const char * field;
+	unsigned int bit;
+		// CONMON_FORMAT_* bit
+} format_part_t;
+
+static const format_part_t k_parts [NUM_PARTS] =
+{
+	{ "srate", "rate", CONMON_FORMAT_SRATE },
+	{ "pullup", "val", CONMON_FORMAT_PULLUP },
+	{ "enc", "enc", CONMON_FORMAT_ENCODING }
+};
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static conmon_format_check_t * g_check = NULL;
+static conmon_name_cache_t * g_names = NULL;
+static aud_bool_t g_full_reported = AUD_FALSE;
+static unsigned long g_num_unnamed = 0;
+	// status from devices whose name could not be resolved
+
+static conmon_control_builder_t * g_builder = NULL;
+static conmon_control_shape_t * g_set_shapes [NUM_PARTS];
+static conmon_control_shape_t * g_query_shapes [NUM_PARTS];
+static conmon_dispatch_t * g_dispatch = NULL;
+	// the dispatch being sent, if any
+static conmon_dispatch_t * g_fix_dispatches [NUM_PARTS];
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+// the server will give up on a device after this long
+static const aud_utime_t k_device_timeout = {5, 0};
+static const aud_utime_t k_poll_delay = {0, 10000};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_ms (void)
+{
+	return conmon_example_clock_ns () / 1000000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+
+	// while dispatching, control responses are matched to their device by request id
+	if (g_dispatch && ! g_communicating && conmon_dispatch_response (g_dispatch, request_id, result, now_ms (), NULL))
+	{
+		return;
+	}
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+static const char *
+pullup_to_string (uint32_t pullup)
+{
+	switch (pullup)
+	{
+	case CONMON_AUDINATE_SRATE_PULLUP_NONE:                        return "none";
+	case CONMON_AUDINATE_SRATE_PULLUP_PLUSFOURPOINTONESIXSIXSEVEN: return "+4.1667%";
+	case CONMON_AUDINATE_SRATE_PULLUP_PLUSPOINTONE:                return "+0.1%";
+	case CONMON_AUDINATE_SRATE_PULLUP_MINUSPOINTONE:               return "-0.1%";
+	case CONMON_AUDINATE_SRATE_PULLUP_MINUSFOUR:                   return "-4.0%";
+	default:                                                       return "???";
+	}
+}
+
+
+static char *
+format_to_string (const conmon_format_t * format, unsigned int parts, char * buf, size_t len)
+{
+	char enc_buf [16] = "?";
+
+	if (parts & CONMON_FORMAT_ENCODING)
+	{
+		SNPRINTF (enc_buf, sizeof (enc_buf), "%u", format->encoding);
+	}
+	if (parts & CONMON_FORMAT_SRATE)
+	{
+		SNPRINTF (buf, len, "%u Hz pullup %s enc %s"
+			, format->srate, pullup_to_string (format->pullup), enc_buf
+		);
+	}
+	else
+	{
+		SNPRINTF (buf, len, "? Hz pullup ? enc %s", enc_buf);
+	}
+	return buf;
+}
+
+
+static char *
+parts_to_string (unsigned int parts, char * buf, size_t len)
+{
+	SNPRINTF (buf, len, "%s%s%s"
+		, (parts & CONMON_FORMAT_SRATE) ? " srate" : ""
+		, (parts & CONMON_FORMAT_PULLUP) ? " pullup" : ""
+		, (parts & CONMON_FORMAT_ENCODING) ? " enc" : ""
+	);
+	return buf;
+}
+
+
+static void
+handle_mismatch
+(
+	void * context,
+	const conmon_format_mismatch_t * mismatch
+)
+{
+	const unsigned int now = mismatch->route->mismatch;
+	aud_ctime_buf_t time_buf;
+	const char * time = aud_utime_ctime_no_newline (NULL, time_buf);
+	char rx_buf [64], tx_buf [64];
+
+	AUD_UNUSED (context);
+
+	if (now)
+	{
+		printf ("#MISMATCH %s: '%s' (%s) <- '%s' (%s):%s%s\n"
+			, time
+			, mismatch->rx->name, format_to_string (& mismatch->rx->current, mismatch->rx->known, rx_buf, sizeof (rx_buf))
+			, mismatch->tx->name, format_to_string (& mismatch->tx->current, mismatch->tx->known, tx_buf, sizeof (tx_buf))
+			, (now & CONMON_FORMAT_MISMATCH_CLOCK) ? " clock" : ""
+			, (now & CONMON_FORMAT_MISMATCH_ENCODING) ? " encoding" : ""
+		);
+	}
+	else
+	{
+		printf ("#RESOLVED %s: '%s' <- '%s'\n", time, mismatch->rx->name, mismatch->tx->name);
+	}
+	fflush (stdout);
+}
+
+
+static void
+print_report (void)
+{
+	const conmon_format_domain_t * domain;
+	const conmon_format_route_t * route;
+	conmon_format_summary_t summary;
+	char buf [64];
+	unsigned int i;
+
+	conmon_format_check_get_summary (g_check, & summary);
+	printf ("#SUMMARY %u devices in %u clock and %u format domains; %u of %u routes mismatch on clock, %u on encoding; "
+		"%lu updates\n"
+		, summary.num_devices, summary.num_clock_domains, summary.num_format_domains
+		, summary.num_clock_mismatches, summary.num_routes, summary.num_encoding_mismatches
+		, summary.num_updates
+	);
+	if (summary.num_unplaced)
+	{
+		printf ("#SUMMARY %u devices are in no domain, too many distinct formats\n", summary.num_unplaced);
+	}
+	if (g_num_unnamed)
+	{
+		printf ("#SUMMARY %lu status messages from devices without a name were ignored\n", g_num_unnamed);
+	}
+
+	for (i = 0; (domain = conmon_format_check_clock_domain_at_index (g_check, i)) != NULL; i++)
+	{
+		if (domain->num_devices)
+		{
+			printf ("#CLOCK %u Hz pullup %s: %u devices\n"
+				, domain->format.srate, pullup_to_string (domain->format.pullup), domain->num_devices
+			);
+		}
+	}
+	for (i = 0; (domain = conmon_format_check_format_domain_at_index (g_check, i)) != NULL; i++)
+	{
+		if (domain->num_devices)
+		{
+			printf ("#FORMAT %s: %u devices\n"
+				, format_to_string (& domain->format, CONMON_FORMAT_ALL, buf, sizeof (buf)), domain->num_devices
+			);
+		}
+	}
+	for (i = 0; (route = conmon_format_check_route_at_index (g_check, i)) != NULL; i++)
+	{
+		if (route->mismatch)
+		{
+			printf ("#ROUTE '%s' <- '%s':%s%s\n"
+				, conmon_format_check_device_at_index (g_check, route->rx_device)->name
+				, conmon_format_check_device_at_index (g_check, route->tx_device)->name
+				, (route->mismatch & CONMON_FORMAT_MISMATCH_CLOCK) ? " clock" : ""
+				, (route->mismatch & CONMON_FORMAT_MISMATCH_ENCODING) ? " encoding" : ""
+			);
+		}
+	}
+	fflush (stdout);
+}
+
+
+// Lines are "RX_DEVICE TX_DEVICE", with '#' starting a comment
+static aud_error_t
+load_routes (const char * path)
+{
+	char line [FORMAT_LINE_LENGTH];
+	unsigned int line_number = 0, num_routes = 0;
+	aud_error_t result = AUD_SUCCESS;
+	FILE * fp = fopen (path, "r");
+
+	if (! fp)
+	{
+		printf ("Error opening routes file '%s'\n", path);
+		return AUD_ERR_NOTFOUND;
+	}
+	while (result == AUD_SUCCESS && fgets (line, sizeof (line), fp))
+	{
+		char * comment = strchr (line, '#');
+		const char * rx, * tx;
+
+		line_number++;
+		if (comment)
+		{
+			* comment = '\0';
+		}
+		rx = strtok (line, " \t\r\n");
+		if (! rx)
+		{
+			continue;
+		}
+		tx = strtok (NULL, " \t\r\n");
+		if (! tx || strtok (NULL, " \t\r\n"))
+		{
+			printf ("%s:%u: expected RX_DEVICE TX_DEVICE\n", path, line_number);
+			result = AUD_ERR_INVALIDPARAMETER;
+			break;
+		}
+		result = conmon_format_check_add_route (g_check, rx, tx, now_ms ());
+		if (result == AUD_ERR_INVALIDPARAMETER)
+		{
+			printf ("%s:%u: bad device name\n", path, line_number);
+		}
+		else if (result == AUD_ERR_NOBUFS)
+		{
+			printf ("%s:%u: too many devices or routes (see -max and -max_routes)\n", path, line_number);
+		}
+		num_routes++;
+	}
+	fclose (fp);
+	if (result == AUD_SUCCESS)
+	{
+		printf ("Loaded %u routes from '%s'\n", num_routes, path);
+	}
+	return result;
+}
+
+
+// Convert a target given on the command line with the builder, which knows the names of each value
+static aud_error_t
+parse_target (unsigned int part, const char * value, int64_t * target)
+{
+	const conmon_control_spec_t * spec = conmon_control_builder_find (g_builder, k_parts [part].cmd);
+	conmon_control_value_t values [CONMON_CONTROL_MAX_FIELDS];
+	char arg [FORMAT_LINE_LENGTH];
+	char * args [1];
+	uint32_t present;
+	aud_error_t result;
+
+	SNPRINTF (arg, sizeof (arg), "%s=%s", k_parts [part].field, value);
+	args [0] = arg;
+	result = conmon_control_builder_parse (g_builder, spec, 1, args, values, & present, NULL);
+	if (result == AUD_SUCCESS)
+	{
+		// the part's field is the first of its spec
+		* target = values [0].i;
+	}
+	return result;
+}
+
+
+// Send to every target at once, up to FORMAT_DISPATCH_WINDOW in flight, handling status as it arrives
+static void
+run_dispatch
+(
+	conmon_client_t * client,
+	conmon_dispatch_t * dispatch,
+	const char * what,
+	const conmon_message_body_t * body,
+	uint16_t body_size
+)
+{
+	conmon_dispatch_summary_t summary;
+	unsigned int i;
+
+	g_dispatch = dispatch;
+	while (g_running && ! conmon_dispatch_is_finished (dispatch))
+	{
+		aud_utime_t delay = k_poll_delay;
+		unsigned int index, ms;
+
+		while (conmon_dispatch_next (dispatch, & index))
+		{
+			const conmon_dispatch_target_t * target = conmon_dispatch_target_at_index (dispatch, index);
+			conmon_client_request_id_t req_id = NULL;
+			aud_error_t result =
+				conmon_client_send_control_message (
+					client, & handle_response, & req_id,
+					target->device_name, CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+					body, body_size, & k_device_timeout
+				);
+			conmon_dispatch_sent (dispatch, index, result, req_id, now_ms ());
+		}
+
+		ms = conmon_dispatch_ms_to_next (dispatch, now_ms ());
+		if (ms < k_poll_delay.tv_usec / 1000)
+		{
+			delay.tv_usec = ms * 1000;
+		}
+		conmon_example_sleep (& delay);
+		conmon_client_process (client);
+		conmon_dispatch_expire (dispatch, now_ms ());
+	}
+	g_dispatch = NULL;
+
+	for (i = 0; i < conmon_dispatch_num_targets (dispatch); i++)
+	{
+		const conmon_dispatch_target_t * target = conmon_dispatch_target_at_index (dispatch, i);
+		if (target->state != CONMON_DISPATCH_TARGET_DONE)
+		{
+			aud_errbuf_t errbuf;
+			printf ("#SEND %s to '%s' %s: %s\n"
+				, what, target->device_name, conmon_dispatch_target_state_to_string (target->state)
+				, aud_error_message (target->result, errbuf)
+			);
+		}
+	}
+	conmon_dispatch_get_summary (dispatch, & summary);
+	printf ("#SEND %s to %u devices: %u done, %u failed, %u timed out; slowest response %llu ms\n"
+		, what, summary.num_targets
+		, summary.num_in_state [CONMON_DISPATCH_TARGET_DONE]
+		, summary.num_in_state [CONMON_DISPATCH_TARGET_FAILED]
+		, summary.num_in_state [CONMON_DISPATCH_TARGET_TIMEDOUT]
+		, (unsigned long long) summary.max_elapsed_ms
+	);
+	fflush (stdout);
+}
+
+
+// Ask every device named in the routes for its sample rate, pullup and encoding
+static void
+query_devices (conmon_client_t * client)
+{
+	const conmon_format_device_t * device;
+	conmon_format_summary_t summary;
+	conmon_control_value_t no_values [1];
+	conmon_message_body_t body;
+	uint16_t body_size;
+	unsigned int p, d;
+
+	conmon_format_check_get_summary (g_check, & summary);
+	if (! summary.num_devices)
+	{
+		return;
+	}
+	for (p = 0; p < NUM_PARTS && g_running; p++)
+	{
+		conmon_dispatch_t * dispatch = NULL;
+		char what [32];
+
+		if (conmon_dispatch_new (summary.num_devices, FORMAT_DISPATCH_WINDOW, FORMAT_DISPATCH_TIMEOUT_MS, & dispatch)
+				!= AUD_SUCCESS
+			|| conmon_control_shape_build (g_query_shapes [p], no_values, & body, & body_size) != AUD_SUCCESS)
+		{
+			conmon_dispatch_delete (dispatch);
+			continue;
+		}
+		for (d = 0; (device = conmon_format_check_device_at_index (g_check, d)) != NULL; d++)
+		{
+			conmon_dispatch_add (dispatch, device->name);
+		}
+		SNPRINTF (what, sizeof (what), "%s query", k_parts [p].cmd);
+		run_dispatch (client, dispatch, what, & body, body_size);
+		conmon_dispatch_delete (dispatch);
+	}
+}
+
+
+static void
+handle_correction
+(
+	void * context,
+	const conmon_format_correction_t * correction
+)
+{
+	const aud_bool_t send = * (const aud_bool_t *) context;
+	char needed_buf [32], pending_buf [32], impossible_buf [32];
+	unsigned int p;
+
+	printf ("#FIX '%s':%s%s%s%s%s%s\n"
+		, correction->device->name
+		, correction->needed ? " change" : "", parts_to_string (correction->needed & ~correction->impossible, needed_buf, sizeof (needed_buf))
+		, correction->pending ? ", pending reboot" : "", parts_to_string (correction->pending, pending_buf, sizeof (pending_buf))
+		, correction->impossible ? ", not available" : "", parts_to_string (correction->impossible, impossible_buf, sizeof (impossible_buf))
+	);
+	if (! send)
+	{
+		return;
+	}
+	for (p = 0; p < NUM_PARTS; p++)
+	{
+		if ((correction->needed & ~correction->impossible) & k_parts [p].bit)
+		{
+			conmon_dispatch_add (g_fix_dispatches [p], correction->device->name);
+		}
+	}
+}
+
+
+/*
+	Bring every device that has reported a part of the format into line
+	with the target, or with the reference for parts not given. Sample
+	rate changes are sent first, then pullup, then encoding, each to all
+	of its devices at once.
+ */
+static void
+fix_devices
+(
+	conmon_client_t * client,
+	unsigned int target_parts,
+	const conmon_format_t * target_values,
+	aud_bool_t routed_only,
+	aud_bool_t send
+)
+{
+	conmon_format_t target;
+	conmon_format_summary_t summary;
+	char buf [64];
+	unsigned int p, n;
+
+	if (! conmon_format_check_get_reference (g_check, & target) && target_parts != CONMON_FORMAT_ALL)
+	{
+		printf ("#FIX no device has reported its format yet\n");
+		return;
+	}
+	if (target_parts & CONMON_FORMAT_SRATE)
+	{
+		target.srate = target_values->srate;
+	}
+	if (target_parts & CONMON_FORMAT_PULLUP)
+	{
+		target.pullup = target_values->pullup;
+	}
+	if (target_parts & CONMON_FORMAT_ENCODING)
+	{
+		target.encoding = target_values->encoding;
+	}
+	printf ("#FIX target %s\n", format_to_string (& target, CONMON_FORMAT_ALL, buf, sizeof (buf)));
+
+	conmon_format_check_get_summary (g_check, & summary);
+	for (p = 0; p < NUM_PARTS; p++)
+	{
+		g_fix_dispatches [p] = NULL;
+		if (send && summary.num_devices)
+		{
+			conmon_dispatch_new (summary.num_devices, FORMAT_DISPATCH_WINDOW, FORMAT_DISPATCH_TIMEOUT_MS, & g_fix_dispatches [p]);
+		}
+	}
+
+	n = conmon_format_check_corrections (g_check, & target, CONMON_FORMAT_ALL, routed_only, & handle_correction, & send);
+	printf ("#FIX %u devices need changes\n", n);
+
+	for (p = 0; p < NUM_PARTS; p++)
+	{
+		conmon_dispatch_t * dispatch = g_fix_dispatches [p];
+		conmon_control_value_t value;
+		conmon_message_body_t body;
+		uint16_t body_size;
+
+		if (! dispatch || ! conmon_dispatch_num_targets (dispatch) || ! g_running)
+		{
+			conmon_dispatch_delete (dispatch);
+			continue;
+		}
+		value.i = (p == PART_SRATE) ? target.srate : (p == PART_PULLUP) ? target.pullup : target.encoding;
+		value.s = NULL;
+		if (conmon_control_shape_build (g_set_shapes [p], & value, & body, & body_size) == AUD_SUCCESS)
+		{
+			run_dispatch (client, dispatch, k_parts [p].cmd, & body, body_size);
+		}
+		else
+		{
+			printf ("#FIX target is out of range for %s\n", k_parts [p].cmd);
+		}
+		conmon_dispatch_delete (dispatch);
+	}
+	fflush (stdout);
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_status_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	conmon_aud_decoded_msg_t decoded;
+	conmon_audinate_message_type_t type;
+	conmon_instance_id_t instance_id;
+	const char * name;
+	aud_error_t result;
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+
+	if (!conmon_vendor_id_equals (conmon_message_head_get_vendor_id (head), CONMON_VENDOR_ID_AUDINATE))
+	{
+		return;
+	}
+	type = conmon_audinate_message_get_type (body);
+	if (type != CONMON_AUDINATE_MESSAGE_TYPE_SRATE_STATUS
+		&& type != CONMON_AUDINATE_MESSAGE_TYPE_SRATE_PULLUP_STATUS
+		&& type != CONMON_AUDINATE_MESSAGE_TYPE_ENC_STATUS)
+	{
+		return;
+	}
+	result = conmon_aud_decode_msg (body, conmon_message_head_get_body_size (head), & decoded);
+	if (result != AUD_SUCCESS && result != AUD_ERR_TRUNCATED)
+	{
+		return;
+	}
+
+	conmon_message_head_get_instance_id (head, & instance_id);
+	name = conmon_name_cache_lookup (g_names, & instance_id)->device_name;
+	if (! name)
+	{
+		g_num_unnamed++;
+		return;
+	}
+
+	if (type == CONMON_AUDINATE_MESSAGE_TYPE_SRATE_STATUS)
+	{
+		result = conmon_format_check_update_srate (g_check, & instance_id, name, & decoded.u.srate_status, now_ms ());
+	}
+	else if (type == CONMON_AUDINATE_MESSAGE_TYPE_SRATE_PULLUP_STATUS)
+	{
+		result = conmon_format_check_update_pullup (g_check, & instance_id, name, & decoded.u.pullup_status, now_ms ());
+	}
+	else
+	{
+		result = conmon_format_check_update_encoding (g_check, & instance_id, name, & decoded.u.srate_status, now_ms ());
+	}
+	if (result == AUD_ERR_NOBUFS && ! g_full_reported)
+	{
+		fprintf (stderr, "Device table is full, new devices will not be tracked (see -max)\n");
+		g_full_reported = AUD_TRUE;
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (num_changes);
+	AUD_UNUSED (changes);
+
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Main
+
+static void
+usage (const char * bin)
+{
+	printf ("Usage: %s [-p=PORT] [-max=N] [-max_routes=N] [-routes=FILE] [-query] [-report=SEC]\n"
+		"    [-fix | -plan] [-srate=RATE] [-pullup=VAL] [-enc=ENC] [-all] [-settle=SEC]\n", bin);
+	printf ("  Group devices into clock and format domains and report routes between domains\n");
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -max=N: track at most N devices (default %u)\n", FORMAT_DEFAULT_MAX_DEVICES);
+	printf ("  -max_routes=N: track at most N routes (default %u)\n", FORMAT_DEFAULT_MAX_ROUTES);
+	printf ("  -routes=FILE: read routes from FILE, one \"RX_DEVICE TX_DEVICE\" per line\n");
+	printf ("  -query: ask the devices in the routes for their format at startup\n");
+	printf ("  -report=SEC: print the domains and mismatched routes every SEC seconds\n");
+	printf ("  -fix: after settling, send the changes that bring devices to the target format\n");
+	printf ("  -plan: as -fix, but only print the changes\n");
+	printf ("  -srate=RATE, -pullup=VAL, -enc=ENC: the target format, as for the srate, pullup\n"
+		"      and enc commands of conmon_audinate_controller; parts not given come from\n"
+		"      the largest format domain\n");
+	printf ("  -all: fix every device, not only those in the routes\n");
+	printf ("  -settle=SEC: gather status for SEC seconds before fixing (default %u)\n", FORMAT_DEFAULT_SETTLE_S);
+	printf ("  Ctrl-C prints the report and exits\n");
+}
+
+
+int
+main (int argc, char * argv[])
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	dante_sockets_t sockets;
+	uint16_t server_port = 0;
+	unsigned int max_devices = FORMAT_DEFAULT_MAX_DEVICES;
+	unsigned int max_routes = FORMAT_DEFAULT_MAX_ROUTES;
+	unsigned int report_s = 0, settle_s = FORMAT_DEFAULT_SETTLE_S;
+	const char * routes_path = NULL;
+	const char * target_strings [NUM_PARTS] = { NULL, NULL, NULL };
+	aud_bool_t query = AUD_FALSE, fix = AUD_FALSE, send = AUD_FALSE, routed_only = AUD_TRUE;
+	unsigned int target_parts = 0;
+	conmon_format_t target_values;
+	uint64_t next_report_ms = 0, fix_ms = 0;
+	unsigned int p;
+	int a;
+
+	for (a = 1; a < argc; a++)
+	{
+		const char * arg = argv[a];
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if (!strncmp (arg, "-max=", 5) && strlen (arg) > 5)
+		{
+			max_devices = (unsigned int) atoi (arg + 5);
+		}
+		else if (!strncmp (arg, "-max_routes=", 12) && strlen (arg) > 12)
+		{
+			max_routes = (unsigned int) atoi (arg + 12);
+		}
+		else if (!strncmp (arg, "-routes=", 8) && strlen (arg) > 8)
+		{
+			routes_path = arg + 8;
+		}
+		else if (!strcmp (arg, "-query"))
+		{
+			query = AUD_TRUE;
+		}
+		else if (!strncmp (arg, "-report=", 8) && strlen (arg) > 8)
+		{
+			report_s = (unsigned int) atoi (arg + 8);
+		}
+		else if (!strcmp (arg, "-fix") || !strcmp (arg, "-plan"))
+		{
+			fix = AUD_TRUE;
+			send = (arg[1] == 'f');
+		}
+		else if (!strncmp (arg, "-srate=", 7) && strlen (arg) > 7)
+		{
+			target_strings [PART_SRATE] = arg + 7;
+		}
+		else if (!strncmp (arg, "-pullup=", 8) && strlen (arg) > 8)
+		{
+			target_strings [PART_PULLUP] = arg + 8;
+		}
+		else if (!strncmp (arg, "-enc=", 5) && strlen (arg) > 5)
+		{
+			target_strings [PART_ENCODING] = arg + 5;
+		}
+		else if (!strcmp (arg, "-all"))
+		{
+			routed_only = AUD_FALSE;
+		}
+		else if (!strncmp (arg, "-settle=", 8) && strlen (arg) > 8)
+		{
+			settle_s = (unsigned int) atoi (arg + 8);
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+
+	result = conmon_format_check_new (max_devices, max_routes, & handle_mismatch, NULL, & g_check);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device table: %s\n", aud_error_message (result, errbuf));
+		usage (argv[0]);
+		exit (1);
+	}
+
+	result = conmon_control_builder_new (conmon_control_audinate_specs, conmon_control_audinate_num_specs, & g_builder);
+	for (p = 0; p < NUM_PARTS && result == AUD_SUCCESS; p++)
+	{
+		const conmon_control_spec_t * spec = conmon_control_builder_find (g_builder, k_parts [p].cmd);
+
+		result = conmon_control_shape_new (g_builder, spec, k_parts [p].field, & g_set_shapes [p]);
+		if (result == AUD_SUCCESS)
+		{
+			result = conmon_control_shape_new (g_builder, spec, "", & g_query_shapes [p]);
+		}
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating control messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	memset (& target_values, 0, sizeof (target_values));
+	for (p = 0; p < NUM_PARTS; p++)
+	{
+		int64_t value;
+
+		if (! target_strings [p])
+		{
+			continue;
+		}
+		if (parse_target (p, target_strings [p], & value) != AUD_SUCCESS)
+		{
+			printf ("Invalid %s '%s'\n", k_parts [p].cmd, target_strings [p]);
+			usage (argv[0]);
+			result = AUD_ERR_INVALIDPARAMETER;
+			goto cleanup;
+		}
+		if (p == PART_SRATE)
+		{
+			target_values.srate = (uint32_t) value;
+		}
+		else if (p == PART_PULLUP)
+		{
+			target_values.pullup = (uint32_t) value;
+		}
+		else
+		{
+			target_values.encoding = (uint32_t) value;
+		}
+		target_parts |= k_parts [p].bit;
+	}
+
+	if (routes_path)
+	{
+		result = load_routes (routes_path);
+		if (result != AUD_SUCCESS)
+		{
+			goto cleanup;
+		}
+	}
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	config = conmon_client_config_new ("format_checker");
+	if (!config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (config, server_port);
+	}
+	result = conmon_client_new_config (env, config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, FORMAT_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device name cache: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+			handle_status_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for status messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_subscribe_global (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error subscribing to status from all devices: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	printf ("Checking sample rate, pullup and encoding across all devices\n");
+
+	// The loop runs until the user hits CTRL-C, waking once a second to print reports and fix devices
+	signal (SIGINT, sig_handler);
+	if (query)
+	{
+		query_devices (client);
+	}
+	if (report_s)
+	{
+		next_report_ms = now_ms () + report_s * 1000;
+	}
+	if (fix)
+	{
+		fix_ms = now_ms () + settle_s * 1000;
+	}
+	while (g_running)
+	{
+		aud_utime_t timeout;
+		uint64_t now;
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& sockets);
+			conmon_client_get_sockets (client, & sockets);
+		}
+
+		timeout.tv_sec = 1;
+		timeout.tv_usec = 0;
+		conmon_example_client_process (client, & sockets, & timeout, NULL);
+
+		now = now_ms ();
+		if (fix && now >= fix_ms)
+		{
+			fix = AUD_FALSE;
+			fix_devices (client, target_parts, & target_values, routed_only, send);
+		}
+		if (report_s && now >= next_report_ms)
+		{
+			print_report ();
+			next_report_ms = now + report_s * 1000;
+		}
+	}
+
+	print_report ();
+	result = AUD_SUCCESS;
+
+cleanup:
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (config)
+	{
+		conmon_client_config_delete (config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	for (p = 0; p < NUM_PARTS; p++)
+	{
+		conmon_control_shape_delete (g_query_shapes [p]);
+		conmon_control_shape_delete (g_set_shapes [p]);
+	}
+	conmon_control_builder_delete (g_builder);
+	conmon_format_check_delete (g_check);
+	return result;
+}
+
+
+//----------
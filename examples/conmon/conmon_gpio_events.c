@@ -0,0 +1,855 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Stream GPIO and LED edges from Dante devices to local subscribers
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_gpio_table.h"
+#include "conmon_name_cache.h"
+
+#ifndef WIN32
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+#endif
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	GPIO_NAME_CACHE_SIZE = 2048,
+	GPIO_DEFAULT_MAX_DEVICES = 1024,
+	GPIO_DEFAULT_MAX_SUBSCRIBERS = 32,
+	GPIO_MAX_SUBSCRIBERS = 256,
+	GPIO_LINE_SIZE = 256,
+	GPIO_OUT_SIZE = 16384
+};
+
+#define GPIO_DEFAULT_SOCKET_PATH "/tmp/conmon_gpio_events"
+
+typedef struct subscriber
+{
+	int fd;
+	conmon_gpio_filter_t filter;
+	char in [GPIO_LINE_SIZE];
+	size_t in_len;
+	char out [GPIO_OUT_SIZE];
+	size_t out_len;
+		// queued bytes not yet taken by the socket
+	unsigned long num_dropped;
+		// lines lost since the last notice because the subscriber was not reading
+} subscriber_t;
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static conmon_gpio_table_t * g_table = NULL;
+static conmon_name_cache_t * g_names = NULL;
+static aud_bool_t g_full_reported = AUD_FALSE;
+static aud_bool_t g_print = AUD_FALSE;
+
+static subscriber_t * g_subscribers = NULL;
+static unsigned int g_max_subscribers = GPIO_DEFAULT_MAX_SUBSCRIBERS;
+static unsigned int g_num_subscribers = 0;
+static unsigned long g_num_dropped = 0;
+
+// added to monotonic microseconds to give microseconds since the epoch
+static int64_t g_wall_offset_us = 0;
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_us (void)
+{
+	return conmon_example_clock_ns () / 1000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+// A single word naming the device: its name if known, otherwise its instance id
+static const char *
+device_word (const conmon_instance_id_t * instance_id, char * buf, size_t len)
+{
+	const char * name = conmon_name_cache_lookup (g_names, instance_id)->device_name;
+	return name ? name : conmon_example_instance_id_to_string (instance_id, buf, len);
+}
+
+
+#ifndef WIN32
+
+// Queue a line for a subscriber, or count it as dropped if the subscriber is too far behind
+static void
+queue_line (subscriber_t * sub, const char * line, size_t len)
+{
+	if (sub->num_dropped)
+	{
+		char notice [64];
+		const int n = SNPRINTF (notice, sizeof (notice), "dropped %lu\n", sub->num_dropped);
+
+		if (sub->out_len + n + len > sizeof (sub->out))
+		{
+			sub->num_dropped++;
+			g_num_dropped++;
+			return;
+		}
+		memcpy (sub->out + sub->out_len, notice, n);
+		sub->out_len += n;
+		sub->num_dropped = 0;
+	}
+	if (sub->out_len + len > sizeof (sub->out))
+	{
+		sub->num_dropped++;
+		g_num_dropped++;
+		return;
+	}
+	memcpy (sub->out + sub->out_len, line, len);
+	sub->out_len += len;
+}
+
+
+static void
+close_subscriber (unsigned int i)
+{
+	close (g_subscribers [i].fd);
+	g_subscribers [i] = g_subscribers [--g_num_subscribers];
+}
+
+
+// Write out what the socket will take without blocking
+// @return AUD_FALSE if the subscriber has gone away
+static aud_bool_t
+flush_subscriber (subscriber_t * sub)
+{
+	while (sub->out_len)
+	{
+		const ssize_t n = write (sub->fd, sub->out, sub->out_len);
+		if (n < 0)
+		{
+			return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+		}
+		sub->out_len -= (size_t) n;
+		memmove (sub->out, sub->out + n, sub->out_len);
+	}
+	return AUD_TRUE;
+}
+
+
+static void
+send_state (subscriber_t * sub)
+{
+	const conmon_gpio_device_t * device;
+	const uint64_t now = (uint64_t) ((int64_t) now_us () + g_wall_offset_us);
+	char line [GPIO_LINE_SIZE];
+	unsigned int d, b;
+	int n;
+
+	for (d = 0; (device = conmon_gpio_table_device_at_index (g_table, d)) != NULL; d++)
+	{
+		char id_buf [64];
+		const char * name = device_word (& device->instance_id, id_buf, sizeof (id_buf));
+
+		for (b = 0; b < device->num_banks; b++)
+		{
+			n = SNPRINTF (line, sizeof (line), "%llu %s state %u 0x%08x 0x%08x 0x%08x 0x%08x\n"
+				, (unsigned long long) now, name, b
+				, device->input_mask [b], device->input_value [b]
+				, device->output_mask [b], device->output_value [b]
+			);
+			queue_line (sub, line, (size_t) n);
+		}
+		if (device->leds_known)
+		{
+			n = SNPRINTF (line, sizeof (line), "%llu %s leds %u 0x%08x 0x%08x\n"
+				, (unsigned long long) now, name, device->num_leds
+				, device->led_states, device->led_colours
+			);
+			queue_line (sub, line, (size_t) n);
+		}
+	}
+}
+
+
+// A subscriber sends one command per line: "state" for a snapshot, anything else is a filter
+static void
+handle_subscriber_line (subscriber_t * sub, const char * line)
+{
+	static const char k_ok [] = "ok\n";
+	static const char k_error [] = "error\n";
+
+	if (! strncmp (line, "state", 5) && (line [5] == '\0' || line [5] == '\r'))
+	{
+		send_state (sub);
+	}
+	else if (conmon_gpio_filter_parse (& sub->filter, line) == AUD_SUCCESS)
+	{
+		queue_line (sub, k_ok, sizeof (k_ok) - 1);
+	}
+	else
+	{
+		queue_line (sub, k_error, sizeof (k_error) - 1);
+	}
+}
+
+
+// @return AUD_FALSE if the subscriber has gone away
+static aud_bool_t
+read_subscriber (subscriber_t * sub)
+{
+	char * newline;
+	const ssize_t n = read (sub->fd, sub->in + sub->in_len, sizeof (sub->in) - 1 - sub->in_len);
+
+	if (n <= 0)
+	{
+		return (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+	}
+	sub->in_len += (size_t) n;
+	sub->in [sub->in_len] = '\0';
+
+	while ((newline = strchr (sub->in, '\n')) != NULL)
+	{
+		* newline = '\0';
+		handle_subscriber_line (sub, sub->in);
+		sub->in_len -= (size_t) (newline + 1 - sub->in);
+		memmove (sub->in, newline + 1, sub->in_len + 1);
+	}
+	// a line longer than the buffer can never be a valid command
+	if (sub->in_len == sizeof (sub->in) - 1)
+	{
+		sub->in_len = 0;
+	}
+	return AUD_TRUE;
+}
+
+
+static void
+accept_subscriber (int listen_fd)
+{
+	const int fd = accept (listen_fd, NULL, NULL);
+	subscriber_t * sub;
+
+	if (fd < 0)
+	{
+		return;
+	}
+	if (g_num_subscribers >= g_max_subscribers
+		|| fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK) < 0)
+	{
+		close (fd);
+		return;
+	}
+	sub = g_subscribers + g_num_subscribers++;
+	memset (sub, 0, sizeof (* sub));
+	sub->fd = fd;
+	conmon_gpio_filter_init (& sub->filter);
+}
+
+
+static int
+open_listener (const char * path)
+{
+	struct sockaddr_un addr;
+	int fd;
+
+	if (strlen (path) >= sizeof (addr.sun_path))
+	{
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+	memset (& addr, 0, sizeof (addr));
+	addr.sun_family = AF_UNIX;
+	strcpy (addr.sun_path, path);
+
+	fd = socket (AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		return -1;
+	}
+	// a socket file left behind by an earlier run would make bind fail
+	unlink (path);
+	if (bind (fd, (struct sockaddr *) & addr, sizeof (addr)) < 0
+		|| listen (fd, 8) < 0
+		|| fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK) < 0)
+	{
+		close (fd);
+		return -1;
+	}
+	return fd;
+}
+
+#endif // WIN32
+
+
+static void
+handle_gpio_event
+(
+	void * context,
+	const conmon_gpio_event_t * event
+)
+{
+	char line [GPIO_LINE_SIZE];
+	char id_buf [64];
+	const char * name = device_word (& event->device->instance_id, id_buf, sizeof (id_buf));
+	const unsigned long long timestamp_us =
+		(unsigned long long) ((int64_t) event->timestamp_us + g_wall_offset_us);
+	unsigned int i;
+	int n;
+
+	AUD_UNUSED (context);
+
+	if (event->kind == CONMON_GPIO_EVENT_LED)
+	{
+		n = SNPRINTF (line, sizeof (line), "%llu %s led %u %u %u %u\n"
+			, timestamp_us, name, event->pin, event->value, event->previous, event->colour
+		);
+	}
+	else
+	{
+		n = SNPRINTF (line, sizeof (line), "%llu %s %s %u %u %s\n"
+			, timestamp_us, name, conmon_gpio_event_kind_to_string (event->kind)
+			, event->bank, event->pin, event->value ? "rise" : "fall"
+		);
+	}
+	if (n <= 0 || (size_t) n >= sizeof (line))
+	{
+		return;
+	}
+	if (g_print)
+	{
+		fputs (line, stdout);
+		fflush (stdout);
+	}
+
+#ifndef WIN32
+	for (i = 0; i < g_num_subscribers; i++)
+	{
+		subscriber_t * sub = g_subscribers + i;
+		if (conmon_gpio_filter_match (& sub->filter, event, name))
+		{
+			queue_line (sub, line, (size_t) n);
+		}
+	}
+#else
+	AUD_UNUSED (i);
+#endif
+}
+
+
+static void
+print_devices (void)
+{
+	const conmon_gpio_device_t * device;
+	conmon_gpio_stats_t stats;
+	unsigned int i;
+
+	conmon_gpio_table_get_stats (g_table, & stats);
+	printf ("%u devices: %lu GPIO and %lu LED updates; %lu input, %lu output and %lu LED edges; %lu lines dropped\n"
+		, stats.num_devices, stats.num_gpio_updates, stats.num_led_updates
+		, stats.num_edges [CONMON_GPIO_EVENT_INPUT]
+		, stats.num_edges [CONMON_GPIO_EVENT_OUTPUT]
+		, stats.num_edges [CONMON_GPIO_EVENT_LED]
+		, g_num_dropped
+	);
+	for (i = 0; (device = conmon_gpio_table_device_at_index (g_table, i)) != NULL; i++)
+	{
+		char id_buf [64];
+
+		printf ("  %-32s %u banks, %u LEDs, %lu edges"
+			, device_word (& device->instance_id, id_buf, sizeof (id_buf))
+			, device->num_banks, device->num_leds, device->num_edges
+		);
+		if (device->num_banks)
+		{
+			printf (", inputs 0x%08x outputs 0x%08x", device->input_value [0], device->output_value [0]);
+		}
+		putchar ('\n');
+	}
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_status_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	const uint64_t received_us = now_us ();
+	conmon_aud_decoded_msg_t decoded;
+	conmon_instance_id_t instance_id;
+	aud_error_t result;
+	uint16_t type;
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+
+	if (!conmon_vendor_id_equals (conmon_message_head_get_vendor_id (head), CONMON_VENDOR_ID_AUDINATE))
+	{
+		return;
+	}
+	type = conmon_audinate_message_get_type (body);
+	if (type != CONMON_AUDINATE_MESSAGE_TYPE_GPIO_STATUS
+		&& type != CONMON_AUDINATE_MESSAGE_TYPE_LED_STATUS)
+	{
+		return;
+	}
+
+	result = conmon_aud_decode_msg (body, conmon_message_head_get_body_size (head), & decoded);
+	if (result != AUD_SUCCESS && result != AUD_ERR_TRUNCATED)
+	{
+		return;
+	}
+
+	conmon_message_head_get_instance_id (head, & instance_id);
+	if (type == CONMON_AUDINATE_MESSAGE_TYPE_GPIO_STATUS)
+	{
+		result = conmon_gpio_table_update_gpio (g_table, & instance_id, & decoded.u.gpio_status, received_us);
+	}
+	else
+	{
+		result = conmon_gpio_table_update_led (g_table, & instance_id, & decoded.u.led_status, received_us);
+	}
+	if (result == AUD_ERR_NOBUFS && ! g_full_reported)
+	{
+		fprintf (stderr, "Device table is full, new devices will not be tracked (see -max)\n");
+		g_full_reported = AUD_TRUE;
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (num_changes);
+	AUD_UNUSED (changes);
+
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Main
+
+static void
+usage (const char * bin)
+{
+	printf ("Usage: %s [-p=PORT] [-socket=PATH] [-max=N] [-subs=N] [-print]\n", bin);
+	printf ("  Stream GPIO and LED edges from all devices to subscribers on a local socket\n");
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -socket=PATH: listen on the Unix domain socket PATH (default %s)\n", GPIO_DEFAULT_SOCKET_PATH);
+	printf ("  -max=N: track at most N devices (default %u)\n", GPIO_DEFAULT_MAX_DEVICES);
+	printf ("  -subs=N: accept at most N subscribers at once (default %u, at most %u)\n",
+		GPIO_DEFAULT_MAX_SUBSCRIBERS, GPIO_MAX_SUBSCRIBERS);
+	printf ("  -print: also print every edge on stdout\n");
+	printf ("  Each edge is one line, with the time in microseconds since the epoch:\n");
+	printf ("    TIME DEVICE in|out BANK PIN rise|fall\n");
+	printf ("    TIME DEVICE led LED STATE PREVIOUS_STATE COLOUR\n");
+	printf ("  A subscriber gets every edge until it sends a filter line:\n");
+	printf ("    DEVICE_GLOB [in] [out] [led] [rise|fall] [pins=MASK]\n");
+	printf ("  or \"state\" for the current state of every device\n");
+	printf ("  Ctrl-C prints a summary of all devices and exits\n");
+}
+
+
+#ifdef WIN32
+
+int
+main (int argc, char * argv[])
+{
+	AUD_UNUSED (argc);
+	usage (argv[0]);
+	printf ("Unix domain sockets are not available on this platform\n");
+	return 1;
+}
+
+#else
+
+int
+main (int argc, char * argv[])
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	dante_sockets_t client_sockets;
+	const char * socket_path = GPIO_DEFAULT_SOCKET_PATH;
+	unsigned int max_devices = GPIO_DEFAULT_MAX_DEVICES;
+	uint16_t server_port = 0;
+	int listen_fd = -1;
+	aud_utime_t wall;
+	unsigned int i;
+	int a;
+
+	for (a = 1; a < argc; a++)
+	{
+		const char * arg = argv[a];
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if (!strncmp (arg, "-socket=", 8) && strlen (arg) > 8)
+		{
+			socket_path = arg + 8;
+		}
+		else if (!strncmp (arg, "-max=", 5) && strlen (arg) > 5)
+		{
+			max_devices = (unsigned int) atoi (arg + 5);
+		}
+		else if (!strncmp (arg, "-subs=", 6) && strlen (arg) > 6)
+		{
+			g_max_subscribers = (unsigned int) atoi (arg + 6);
+		}
+		else if (!strcmp (arg, "-print"))
+		{
+			g_print = AUD_TRUE;
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+	if (! g_max_subscribers || g_max_subscribers > GPIO_MAX_SUBSCRIBERS)
+	{
+		usage (argv[0]);
+		exit (1);
+	}
+
+	result = conmon_gpio_table_new (max_devices, & handle_gpio_event, NULL, & g_table);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device table: %s\n", aud_error_message (result, errbuf));
+		usage (argv[0]);
+		exit (1);
+	}
+	g_subscribers = malloc (g_max_subscribers * sizeof (* g_subscribers));
+	if (! g_subscribers)
+	{
+		result = AUD_ERR_NOMEMORY;
+		goto cleanup;
+	}
+
+	aud_utime_get (& wall);
+	g_wall_offset_us = (int64_t) wall.tv_sec * 1000000 + wall.tv_usec - (int64_t) now_us ();
+
+	// a subscriber that goes away mid-write must not kill the service
+	signal (SIGPIPE, SIG_IGN);
+	listen_fd = open_listener (socket_path);
+	if (listen_fd < 0)
+	{
+		result = aud_error_from_system_error (aud_system_error_get_last ());
+		printf ("Error listening on '%s': %s\n", socket_path, aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	config = conmon_client_config_new ("gpio_events");
+	if (!config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (config, server_port);
+	}
+	result = conmon_client_new_config (env, config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, GPIO_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device name cache: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+			handle_status_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for status messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_subscribe_global (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error subscribing to status from all devices: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	printf ("Streaming GPIO and LED edges on '%s'\n", socket_path);
+
+	// The loop runs until the user hits CTRL-C, waking whenever the client,
+	// the listener or a subscriber has data, or a subscriber can take more
+	signal (SIGINT, sig_handler);
+	while (g_running)
+	{
+		dante_sockets_t sockets;
+		fd_set write_fds;
+		aud_utime_t timeout = {1, 0};
+		int count;
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& client_sockets);
+			conmon_client_get_sockets (client, & client_sockets);
+		}
+		sockets = client_sockets;
+		FD_ZERO (& write_fds);
+
+		dante_sockets_add_read (& sockets, listen_fd);
+		for (i = 0; i < g_num_subscribers; i++)
+		{
+			const subscriber_t * sub = g_subscribers + i;
+			dante_sockets_add_read (& sockets, sub->fd);
+			if (sub->out_len)
+			{
+				FD_SET (sub->fd, & write_fds);
+			}
+		}
+
+		count = select (sockets.n, & sockets.read_fds, & write_fds, NULL, & timeout);
+		if (count < 0)
+		{
+			result = aud_error_from_system_error (aud_system_error_get_last ());
+			if (result == AUD_ERR_INTERRUPTED)
+			{
+				continue;
+			}
+			printf ("Error select()ing: %s\n", aud_error_message (result, errbuf));
+			break;
+		}
+		if (count == 0)
+		{
+			continue;
+		}
+
+		// commands first, so that a new filter applies to the messages processed below
+		for (i = 0; i < g_num_subscribers; )
+		{
+			subscriber_t * sub = g_subscribers + i;
+			const int fd = sub->fd;
+
+			if (FD_ISSET (fd, & sockets.read_fds) && ! read_subscriber (sub))
+			{
+				FD_CLR (fd, & sockets.read_fds);
+				close_subscriber (i);
+				continue;
+			}
+			FD_CLR (fd, & sockets.read_fds);
+			i++;
+		}
+		if (FD_ISSET (listen_fd, & sockets.read_fds))
+		{
+			accept_subscriber (listen_fd);
+			FD_CLR (listen_fd, & sockets.read_fds);
+		}
+		conmon_client_process_sockets (client, & sockets, NULL);
+
+		// send edges at once rather than waiting for the next wakeup
+		for (i = 0; i < g_num_subscribers; )
+		{
+			if (! flush_subscriber (g_subscribers + i))
+			{
+				close_subscriber (i);
+				continue;
+			}
+			i++;
+		}
+	}
+
+	print_devices ();
+	result = AUD_SUCCESS;
+
+cleanup:
+	for (i = 0; i < g_num_subscribers; i++)
+	{
+		close (g_subscribers [i].fd);
+	}
+	free (g_subscribers);
+	if (listen_fd >= 0)
+	{
+		close (listen_fd);
+		unlink (socket_path);
+	}
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (config)
+	{
+		conmon_client_config_delete (config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	conmon_gpio_table_delete (g_table);
+	return result;
+}
+
+#endif // WIN32
+
+
+//----------
@@ -0,0 +1,525 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Track GPIO and LED state per device and turn status messages into edge events
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_gpio_table.h"
+#include "conmon_dispatch.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+/*
+	Devices are stored densely in order of first status and found through an
+	id set. Nothing is ever removed, so the set's index for an instance id
+	is also its index in devices.
+ */
+struct conmon_gpio_table
+{
+	conmon_gpio_event_fn * event_fn;
+	void * event_context;
+
+	conmon_gpio_device_t * devices;
+	unsigned int num_devices;
+	dapi_id_map_t * index;
+
+	unsigned long num_gpio_updates;
+	unsigned long num_led_updates;
+	unsigned long num_edges [CONMON_NUM_GPIO_EVENT_KINDS];
+};
+
+
+//----------
+// Local functions
+
+static conmon_gpio_device_t *
+find_or_add_device (conmon_gpio_table_t * table, const conmon_instance_id_t * instance_id)
+{
+	conmon_gpio_device_t * device;
+	unsigned int i;
+	aud_bool_t added;
+
+	if (dapi_id_map_insert (table->index, instance_id, & i, & added) != AUD_SUCCESS)
+	{
+		return NULL;
+	}
+	device = table->devices + i;
+	if (! added)
+	{
+		return device;
+	}
+
+	table->num_devices++;
+	memset (device, 0, sizeof (* device));
+	device->instance_id = * instance_id;
+	return device;
+}
+
+
+// Raise one event per set bit of changed, lowest first
+static void
+raise_edges
+(
+	conmon_gpio_table_t * table,
+	conmon_gpio_event_t * event,
+	uint32_t changed,
+	uint32_t value
+)
+{
+	uint8_t pin;
+
+	for (pin = 0; changed; pin++, changed >>= 1, value >>= 1)
+	{
+		if (changed & 1)
+		{
+			event->pin = pin;
+			event->value = (uint8_t) (value & 1);
+			event->previous = (uint8_t) (event->value ^ 1);
+			table->num_edges [event->kind]++;
+			if (table->event_fn)
+			{
+				table->event_fn (table->event_context, event);
+			}
+		}
+	}
+}
+
+
+AUD_INLINE unsigned int
+popcount32 (uint32_t x)
+{
+	unsigned int n = 0;
+	for (; x; x &= x - 1)
+	{
+		n++;
+	}
+	return n;
+}
+
+
+static const char *
+skip_spaces (const char * s)
+{
+	while (* s == ' ' || * s == '\t' || * s == '\r' || * s == '\n')
+	{
+		s++;
+	}
+	return s;
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_gpio_table_new
+(
+	unsigned int max_devices,
+	conmon_gpio_event_fn * event_fn,
+	void * event_context,
+	conmon_gpio_table_t ** table_ptr
+)
+{
+	conmon_gpio_table_t * table;
+
+	if (! table_ptr || ! max_devices || max_devices > 0x1000000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	table = calloc (1, sizeof (* table));
+	if (! table)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	table->devices = malloc (max_devices * sizeof (* table->devices));
+	if (! table->devices
+		|| dapi_id_map_new (max_devices, 0, & table->index) != AUD_SUCCESS)
+	{
+		conmon_gpio_table_delete (table);
+		return AUD_ERR_NOMEMORY;
+	}
+
+	table->event_fn = event_fn;
+	table->event_context = event_context;
+
+	* table_ptr = table;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_gpio_table_delete
+(
+	conmon_gpio_table_t * table
+)
+{
+	if (table)
+	{
+		dapi_id_map_delete (table->index);
+		free (table->devices);
+		free (table);
+	}
+}
+
+
+aud_error_t
+conmon_gpio_table_update_gpio
+(
+	conmon_gpio_table_t * table,
+	const conmon_instance_id_t * instance_id,
+	const conmon_aud_decoded_gpio_status_t * status,
+	uint64_t now_us
+)
+{
+	conmon_gpio_device_t * device;
+	conmon_gpio_device_t previous;
+	conmon_gpio_event_t event;
+	uint8_t b, num_banks, num_common;
+
+	if (! (table && instance_id && status))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	device = find_or_add_device (table, instance_id);
+	if (! device)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	table->num_gpio_updates++;
+
+	// apply the whole message first so that events see the final state
+	previous = * device;
+	num_banks = (uint8_t) status->states_decoded;
+	for (b = 0; b < num_banks; b++)
+	{
+		const conmon_aud_decoded_gpio_state_t * state = status->states + b;
+		device->input_mask [b] = state->input_mask;
+		device->input_value [b] = state->input_value & state->input_mask;
+		device->output_mask [b] = state->output_mask;
+		device->output_value [b] = state->output_value & state->output_mask;
+	}
+	if (num_banks > device->num_banks)
+	{
+		device->num_banks = num_banks;
+	}
+	device->last_update_us = now_us;
+
+	num_common = (num_banks < previous.num_banks) ? num_banks : previous.num_banks;
+	memset (& event, 0, sizeof (event));
+	event.device = device;
+	event.device_index = (unsigned int) (device - table->devices);
+	event.timestamp_us = now_us;
+	for (b = 0; b < num_common; b++)
+	{
+		const uint32_t in_changed = (previous.input_value [b] ^ device->input_value [b])
+			& previous.input_mask [b] & device->input_mask [b];
+		const uint32_t out_changed = (previous.output_value [b] ^ device->output_value [b])
+			& previous.output_mask [b] & device->output_mask [b];
+
+		event.bank = b;
+		device->num_edges += popcount32 (in_changed) + popcount32 (out_changed);
+		event.kind = CONMON_GPIO_EVENT_INPUT;
+		raise_edges (table, & event, in_changed, device->input_value [b]);
+		event.kind = CONMON_GPIO_EVENT_OUTPUT;
+		raise_edges (table, & event, out_changed, device->output_value [b]);
+	}
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_gpio_table_update_led
+(
+	conmon_gpio_table_t * table,
+	const conmon_instance_id_t * instance_id,
+	const conmon_aud_decoded_led_status_t * status,
+	uint64_t now_us
+)
+{
+	conmon_gpio_device_t * device;
+	conmon_gpio_event_t event;
+	uint32_t states = 0, colours = 0, old_states, changed;
+	uint8_t i, num_leds, num_common;
+	aud_bool_t was_known;
+
+	if (! (table && instance_id && status))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	device = find_or_add_device (table, instance_id);
+	if (! device)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	table->num_led_updates++;
+
+	num_leds = (uint8_t) status->leds_decoded;
+	for (i = 0; i < num_leds; i++)
+	{
+		states |= ((uint32_t) status->leds [i].state & 3) << (2 * i);
+		colours |= ((uint32_t) status->leds [i].colour & 3) << (2 * i);
+	}
+
+	// a pair of bits differs if either bit of its state or its colour does
+	changed = (states ^ device->led_states) | (colours ^ device->led_colours);
+	changed = (changed | (changed >> 1)) & 0x55555555u;
+
+	old_states = device->led_states;
+	was_known = device->leds_known;
+	num_common = (num_leds < device->num_leds) ? num_leds : device->num_leds;
+	device->led_states = states;
+	device->led_colours = colours;
+	device->num_leds = num_leds;
+	device->leds_known = AUD_TRUE;
+	device->last_update_us = now_us;
+	if (! was_known)
+	{
+		return AUD_SUCCESS;
+	}
+
+	memset (& event, 0, sizeof (event));
+	event.device = device;
+	event.device_index = (unsigned int) (device - table->devices);
+	event.kind = CONMON_GPIO_EVENT_LED;
+	event.timestamp_us = now_us;
+	for (i = 0; i < num_common; i++)
+	{
+		if (changed & ((uint32_t) 1 << (2 * i)))
+		{
+			event.pin = i;
+			event.value = (uint8_t) ((states >> (2 * i)) & 3);
+			event.previous = (uint8_t) ((old_states >> (2 * i)) & 3);
+			event.colour = (uint8_t) ((colours >> (2 * i)) & 3);
+			device->num_edges++;
+			table->num_edges [CONMON_GPIO_EVENT_LED]++;
+			if (table->event_fn)
+			{
+				table->event_fn (table->event_context, & event);
+			}
+		}
+	}
+	return AUD_SUCCESS;
+}
+
+
+const conmon_gpio_device_t *
+conmon_gpio_table_device_at_index
+(
+	const conmon_gpio_table_t * table,
+	unsigned int index
+)
+{
+	if (! table || index >= table->num_devices)
+	{
+		return NULL;
+	}
+	return table->devices + index;
+}
+
+
+const conmon_gpio_device_t *
+conmon_gpio_table_find
+(
+	const conmon_gpio_table_t * table,
+	const conmon_instance_id_t * instance_id
+)
+{
+	unsigned int i;
+
+	if (! (table && instance_id))
+	{
+		return NULL;
+	}
+	i = dapi_id_map_find (table->index, instance_id);
+	return (i == DAPI_ID_MAP_NO_ENTRY) ? NULL : table->devices + i;
+}
+
+
+void
+conmon_gpio_table_get_stats
+(
+	const conmon_gpio_table_t * table,
+	conmon_gpio_stats_t * stats
+)
+{
+	if (! (table && stats))
+	{
+		return;
+	}
+	stats->num_devices = table->num_devices;
+	stats->num_gpio_updates = table->num_gpio_updates;
+	stats->num_led_updates = table->num_led_updates;
+	memcpy (stats->num_edges, table->num_edges, sizeof (stats->num_edges));
+}
+
+
+unsigned int
+conmon_gpio_device_led_state
+(
+	const conmon_gpio_device_t * device,
+	unsigned int led
+)
+{
+	if (led >= device->num_leds)
+	{
+		return 0;
+	}
+	return (device->led_states >> (2 * led)) & 3;
+}
+
+
+const char *
+conmon_gpio_event_kind_to_string
+(
+	conmon_gpio_event_kind_t kind
+)
+{
+	switch (kind)
+	{
+	case CONMON_GPIO_EVENT_INPUT:  return "in";
+	case CONMON_GPIO_EVENT_OUTPUT: return "out";
+	case CONMON_GPIO_EVENT_LED:    return "led";
+	default:                       return "???";
+	}
+}
+
+
+void
+conmon_gpio_filter_init
+(
+	conmon_gpio_filter_t * filter
+)
+{
+	memset (filter, 0, sizeof (* filter));
+	filter->device_pattern [0] = '*';
+	filter->kinds = (1u << CONMON_NUM_GPIO_EVENT_KINDS) - 1;
+	filter->pin_mask = 0xFFFFFFFFu;
+	filter->rising = AUD_TRUE;
+	filter->falling = AUD_TRUE;
+}
+
+
+aud_error_t
+conmon_gpio_filter_parse
+(
+	conmon_gpio_filter_t * filter,
+	const char * line
+)
+{
+	conmon_gpio_filter_t parsed;
+	aud_bool_t have_pattern = AUD_FALSE;
+	unsigned int kinds = 0;
+	const char * s = skip_spaces (line);
+
+	conmon_gpio_filter_init (& parsed);
+	while (* s)
+	{
+		const char * end = s;
+		size_t len;
+
+		while (* end && * end != ' ' && * end != '\t' && * end != '\r' && * end != '\n')
+		{
+			end++;
+		}
+		len = (size_t) (end - s);
+
+		if (! have_pattern)
+		{
+			if (len >= sizeof (parsed.device_pattern))
+			{
+				return AUD_ERR_INVALIDPARAMETER;
+			}
+			memcpy (parsed.device_pattern, s, len);
+			parsed.device_pattern [len] = '\0';
+			have_pattern = AUD_TRUE;
+		}
+		else if (len == 2 && ! strncmp (s, "in", 2))
+		{
+			kinds |= 1u << CONMON_GPIO_EVENT_INPUT;
+		}
+		else if (len == 3 && ! strncmp (s, "out", 3))
+		{
+			kinds |= 1u << CONMON_GPIO_EVENT_OUTPUT;
+		}
+		else if (len == 3 && ! strncmp (s, "led", 3))
+		{
+			kinds |= 1u << CONMON_GPIO_EVENT_LED;
+		}
+		else if (len == 4 && ! strncmp (s, "rise", 4))
+		{
+			parsed.falling = AUD_FALSE;
+		}
+		else if (len == 4 && ! strncmp (s, "fall", 4))
+		{
+			parsed.rising = AUD_FALSE;
+		}
+		else if (len > 5 && ! strncmp (s, "pins=", 5))
+		{
+			char * num_end;
+			parsed.pin_mask = (uint32_t) strtoul (s + 5, & num_end, 0);
+			if (num_end != end)
+			{
+				return AUD_ERR_INVALIDPARAMETER;
+			}
+		}
+		else
+		{
+			return AUD_ERR_INVALIDPARAMETER;
+		}
+		s = skip_spaces (end);
+	}
+	if (! (parsed.rising || parsed.falling))
+	{
+		// "rise fall" asks for both
+		parsed.rising = parsed.falling = AUD_TRUE;
+	}
+	if (kinds)
+	{
+		parsed.kinds = kinds;
+	}
+
+	* filter = parsed;
+	return AUD_SUCCESS;
+}
+
+
+aud_bool_t
+conmon_gpio_filter_match
+(
+	const conmon_gpio_filter_t * filter,
+	const conmon_gpio_event_t * event,
+	const char * device_name
+)
+{
+	if (! (filter->kinds & (1u << event->kind)))
+	{
+		return AUD_FALSE;
+	}
+	if (! (filter->pin_mask & ((uint32_t) 1 << event->pin)))
+	{
+		return AUD_FALSE;
+	}
+	if (event->kind != CONMON_GPIO_EVENT_LED
+		&& ! (event->value ? filter->rising : filter->falling))
+	{
+		return AUD_FALSE;
+	}
+	return conmon_dispatch_match (filter->device_pattern, device_name ? device_name : "");
+}
+
+
+//----------
@@ -0,0 +1,238 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Track GPIO and LED state per device and turn status messages into edge events
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_GPIO_TABLE_H
+#define _CONMON_GPIO_TABLE_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_aud_decode_msg.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The table keeps the last GPIO and LED state seen from each device as
+	bitmaps: one word per GPIO bank for each of the input mask, input
+	levels, output mask and output levels, and two bits per LED for its
+	state and its colour. A new status message is compared against the
+	stored words with a single XOR per word, and each bit that differs is
+	raised as an edge event, so a message that changes nothing costs a few
+	word compares and no events.
+
+	Only pins that are inputs (or outputs) in both the old and new state
+	give input (or output) edges. The first GPIO or LED status from a
+	device, and any bank it did not report before, only sets the baseline.
+
+	Timestamps are supplied by the caller in microseconds from any
+	monotonic clock, normally the time the message was received.
+ */
+
+enum
+{
+	CONMON_GPIO_MAX_BANKS = CONMON_AUD_DECODE_MAX_GPIO_STATES,
+	CONMON_GPIO_MAX_LEDS = CONMON_AUD_DECODE_MAX_LEDS
+};
+
+typedef struct conmon_gpio_table conmon_gpio_table_t;
+
+typedef enum conmon_gpio_event_kind
+{
+	CONMON_GPIO_EVENT_INPUT = 0,
+	CONMON_GPIO_EVENT_OUTPUT,
+	CONMON_GPIO_EVENT_LED,
+	CONMON_NUM_GPIO_EVENT_KINDS
+} conmon_gpio_event_kind_t;
+
+typedef struct conmon_gpio_device
+{
+	conmon_instance_id_t instance_id;
+	uint8_t num_banks;
+		// GPIO banks with a known state, 0 until the first GPIO status
+	uint8_t num_leds;
+	aud_bool_t leds_known;
+	uint32_t input_mask [CONMON_GPIO_MAX_BANKS];
+	uint32_t input_value [CONMON_GPIO_MAX_BANKS];
+	uint32_t output_mask [CONMON_GPIO_MAX_BANKS];
+	uint32_t output_value [CONMON_GPIO_MAX_BANKS];
+	uint32_t led_states;
+		// two bits per LED, LED 0 in the lowest bits
+	uint32_t led_colours;
+	uint64_t last_update_us;
+	unsigned long num_edges;
+} conmon_gpio_device_t;
+
+typedef struct conmon_gpio_event
+{
+	const conmon_gpio_device_t * device;
+		// state after the whole message has been applied
+	unsigned int device_index;
+	conmon_gpio_event_kind_t kind;
+	uint8_t bank;
+		// 0 for LEDs
+	uint8_t pin;
+		// bit within the bank, or LED index
+	uint8_t value;
+		// new pin level, or new conmon_audinate_led_state_t
+	uint8_t previous;
+	uint8_t colour;
+		// LED colour after the change, 0 for pins
+	uint64_t timestamp_us;
+} conmon_gpio_event_t;
+
+// Called for every edge, in bank then pin order within a message
+typedef void
+conmon_gpio_event_fn
+(
+	void * context,
+	const conmon_gpio_event_t * event
+);
+
+typedef struct conmon_gpio_stats
+{
+	unsigned int num_devices;
+	unsigned long num_gpio_updates;
+	unsigned long num_led_updates;
+	unsigned long num_edges [CONMON_NUM_GPIO_EVENT_KINDS];
+} conmon_gpio_stats_t;
+
+/*
+	A subscriber's choice of events. Every part must match: the device
+	name against a glob (see conmon_dispatch_match), the event kind, the
+	pin or LED index against pin_mask, and for pins the edge direction.
+ */
+typedef struct conmon_gpio_filter
+{
+	conmon_name_t device_pattern;
+	unsigned int kinds;
+		// bit (1 << kind) set for each kind wanted
+	uint32_t pin_mask;
+	aud_bool_t rising;
+	aud_bool_t falling;
+} conmon_gpio_filter_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_gpio_table_new
+(
+	unsigned int max_devices,
+	conmon_gpio_event_fn * event_fn,
+	void * event_context,
+	conmon_gpio_table_t ** table_ptr
+);
+
+void
+conmon_gpio_table_delete
+(
+	conmon_gpio_table_t * table
+);
+
+/*
+	Apply a GPIO status from a device and raise an event for each edge.
+
+	@return AUD_ERR_NOBUFS if this is a new device and max_devices are already tracked
+ */
+aud_error_t
+conmon_gpio_table_update_gpio
+(
+	conmon_gpio_table_t * table,
+	const conmon_instance_id_t * instance_id,
+	const conmon_aud_decoded_gpio_status_t * status,
+	uint64_t now_us
+);
+
+// As conmon_gpio_table_update_gpio, for an LED status
+aud_error_t
+conmon_gpio_table_update_led
+(
+	conmon_gpio_table_t * table,
+	const conmon_instance_id_t * instance_id,
+	const conmon_aud_decoded_led_status_t * status,
+	uint64_t now_us
+);
+
+// Devices are never removed, so index runs from 0 to num_devices - 1 in order of first status
+const conmon_gpio_device_t *
+conmon_gpio_table_device_at_index
+(
+	const conmon_gpio_table_t * table,
+	unsigned int index
+);
+
+// NULL if the device has sent no GPIO or LED status
+const conmon_gpio_device_t *
+conmon_gpio_table_find
+(
+	const conmon_gpio_table_t * table,
+	const conmon_instance_id_t * instance_id
+);
+
+void
+conmon_gpio_table_get_stats
+(
+	const conmon_gpio_table_t * table,
+	conmon_gpio_stats_t * stats
+);
+
+// The conmon_audinate_led_state_t of an LED
+unsigned int
+conmon_gpio_device_led_state
+(
+	const conmon_gpio_device_t * device,
+	unsigned int led
+);
+
+const char *
+conmon_gpio_event_kind_to_string
+(
+	conmon_gpio_event_kind_t kind
+);
+
+// Everything from every device
+void
+conmon_gpio_filter_init
+(
+	conmon_gpio_filter_t * filter
+);
+
+/*
+	Parse a filter from words separated by spaces: a device name or glob,
+	then any of "in", "out" and "led" to limit the kinds, "rise" or "fall"
+	to limit the pin edges, and "pins=MASK" to limit the pins and LEDs.
+	An empty line or "*" alone selects everything.
+
+	@return AUD_ERR_INVALIDPARAMETER for an unknown word, leaving filter as it was
+ */
+aud_error_t
+conmon_gpio_filter_parse
+(
+	conmon_gpio_filter_t * filter,
+	const char * line
+);
+
+aud_bool_t
+conmon_gpio_filter_match
+(
+	const conmon_gpio_filter_t * filter,
+	const conmon_gpio_event_t * event,
+	const char * device_name
+);
+
+
+//----------
+
+#endif // _CONMON_GPIO_TABLE_H
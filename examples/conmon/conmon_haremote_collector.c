@@ -0,0 +1,99 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Collect HA remote bridge statistics from devices into per-port time series with rates
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_haremote_store.h"
+#include "conmon_poll_collector.h"
+
+
+//----------
+// Local functions
+
+static uint16_t
+init_query (conmon_message_body_t * body)
+{
+	conmon_audinate_init_query_message (body, CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_QUERY, 0);
+	return (uint16_t) conmon_audinate_query_message_get_size (body);
+}
+
+
+static aud_error_t
+add_status
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t time_ms,
+	const conmon_message_body_t * body,
+	uint16_t body_size
+)
+{
+	conmon_aud_decoded_haremote_stats_status_t stats;
+	aud_error_t result = conmon_aud_decode_haremote_stats_status (body, body_size, & stats);
+
+	if (result != AUD_SUCCESS && result != AUD_ERR_TRUNCATED)
+	{
+		return result;
+	}
+	return conmon_haremote_store_add (store, instance_id, device_name, time_ms, & stats);
+}
+
+
+// Rates over the samples taken since since_ms, so that printing every so often shows the trend
+static void
+print_series (const conmon_series_t * series, uint64_t since_ms)
+{
+	conmon_haremote_series_info_t info;
+	conmon_haremote_summary_t summary;
+
+	conmon_haremote_series_get_info (series, & info);
+	conmon_haremote_series_summarise (series, since_ms, & summary);
+	printf ("    port %d: %u samples, recv %.1f/%.1f/%.1f pps, sent %.1f/%.1f/%.1f pps (avg/max/last), "
+		"%lu checksum fails, %lu timeouts, %.2f errors/s last, %u resets\n"
+		, info.port_number, summary.num_samples
+		, summary.avg_recv_rate, summary.max_recv_rate, summary.last_recv_rate
+		, summary.avg_sent_rate, summary.max_sent_rate, summary.last_sent_rate
+		, summary.checksum_fails, summary.timeouts, summary.last_error_rate
+		, summary.num_resets
+	);
+}
+
+
+//----------
+// Main
+
+int
+main (int argc, char * argv[])
+{
+	// most devices have no HA remote bridge and never answer, so stop polling those
+	const conmon_poll_collector_config_t config =
+	{
+		"haremote_collector",
+		"  Poll devices for HA remote bridge statistics and keep a history of counters\n"
+			"  and packet and error rates for each port",
+		"HA remote stats",
+		CONMON_AUDINATE_MESSAGE_TYPE_HAREMOTE_STATS_STATUS,
+		AUD_TRUE,
+		init_query,
+		conmon_haremote_store_new,
+		add_status,
+		print_series
+	};
+
+	return conmon_poll_collector_main (& config, argc, argv);
+}
+
+
+//----------
@@ -0,0 +1,256 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Per-port time series of HA remote bridge statistics with packet and error rates
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_haremote_store.h"
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+static conmon_series_write_fn write_csv_row;
+static conmon_series_write_fn write_json_series;
+static conmon_series_write_fn write_json_sample;
+
+static const conmon_series_format_t k_haremote_format =
+{
+	",port,interval_ms,recv_packets,sent_packets,checksum_fails,timeouts,"
+		"recv_packets_delta,sent_packets_delta,checksum_fails_delta,timeouts_delta,"
+		"recv_rate,sent_rate,checksum_fail_rate,timeout_rate,counters_reset",
+	write_csv_row,
+	"ports",
+	write_json_series,
+	write_json_sample
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE float
+per_second (uint32_t delta, uint32_t interval_ms)
+{
+	return interval_ms ? (float) delta * 1000.0f / (float) interval_ms : 0.0f;
+}
+
+
+static void
+add_sample
+(
+	conmon_haremote_series_t * series,
+	uint64_t time_ms,
+	const conmon_aud_decoded_haremote_port_stats_t * port
+)
+{
+	conmon_haremote_sample_t prev;
+	conmon_haremote_sample_t * sample;
+	const aud_bool_t have_prev = conmon_series_push (series, time_ms, & prev, (void **) & sample);
+
+	sample->recv_packets = port->num_recv_packets;
+	sample->sent_packets = port->num_sent_packets;
+	sample->checksum_fails = port->num_checksum_fails;
+	sample->timeouts = port->num_timeouts;
+
+	if (! have_prev)
+	{
+		return;
+	}
+	sample->interval_ms = (time_ms > prev.time_ms) ? (uint32_t) (time_ms - prev.time_ms) : 0;
+
+	// each counter may be cleared on its own
+	sample->recv_packets_delta =
+		conmon_series_counter_delta (port->num_recv_packets, prev.recv_packets, & sample->counters_reset);
+	sample->sent_packets_delta =
+		conmon_series_counter_delta (port->num_sent_packets, prev.sent_packets, & sample->counters_reset);
+	sample->checksum_fails_delta =
+		conmon_series_counter_delta (port->num_checksum_fails, prev.checksum_fails, & sample->counters_reset);
+	sample->timeouts_delta =
+		conmon_series_counter_delta (port->num_timeouts, prev.timeouts, & sample->counters_reset);
+	sample->recv_rate = per_second (sample->recv_packets_delta, sample->interval_ms);
+	sample->sent_rate = per_second (sample->sent_packets_delta, sample->interval_ms);
+	sample->checksum_fail_rate = per_second (sample->checksum_fails_delta, sample->interval_ms);
+	sample->timeout_rate = per_second (sample->timeouts_delta, sample->interval_ms);
+}
+
+
+static void
+write_csv_row (FILE * fp, const conmon_series_t * series, const void * record)
+{
+	const conmon_haremote_sample_t * sample = record;
+
+	fprintf (fp, ",%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%.3f,%.3f,%.3f,%.3f,%d"
+		, (int) series->key, sample->interval_ms
+		, sample->recv_packets, sample->sent_packets
+		, sample->checksum_fails, sample->timeouts
+		, sample->recv_packets_delta, sample->sent_packets_delta
+		, sample->checksum_fails_delta, sample->timeouts_delta
+		, sample->recv_rate, sample->sent_rate
+		, sample->checksum_fail_rate, sample->timeout_rate
+		, sample->counters_reset ? 1 : 0
+	);
+}
+
+
+static void
+write_json_series (FILE * fp, const conmon_series_t * series, const void * record)
+{
+	AUD_UNUSED (record);
+	fprintf (fp, "\"port\":%d", (int) series->key);
+}
+
+
+static void
+write_json_sample (FILE * fp, const conmon_series_t * series, const void * record)
+{
+	const conmon_haremote_sample_t * sample = record;
+
+	AUD_UNUSED (series);
+	fprintf (fp,
+		",\"interval_ms\":%u,"
+		"\"recv_packets\":%u,\"sent_packets\":%u,\"checksum_fails\":%u,\"timeouts\":%u,"
+		"\"recv_packets_delta\":%u,\"sent_packets_delta\":%u,"
+		"\"checksum_fails_delta\":%u,\"timeouts_delta\":%u,"
+		"\"recv_rate\":%.3f,\"sent_rate\":%.3f,\"checksum_fail_rate\":%.3f,\"timeout_rate\":%.3f,"
+		"\"counters_reset\":%s"
+		, sample->interval_ms
+		, sample->recv_packets, sample->sent_packets
+		, sample->checksum_fails, sample->timeouts
+		, sample->recv_packets_delta, sample->sent_packets_delta
+		, sample->checksum_fails_delta, sample->timeouts_delta
+		, sample->recv_rate, sample->sent_rate
+		, sample->checksum_fail_rate, sample->timeout_rate
+		, sample->counters_reset ? "true" : "false"
+	);
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_haremote_store_new
+(
+	unsigned int max_devices,
+	unsigned int samples_per_port,
+	conmon_series_store_t ** store_ptr
+)
+{
+	return
+		conmon_series_store_new (
+			max_devices, CONMON_AUD_DECODE_MAX_HAREMOTE_PORTS, samples_per_port,
+			sizeof (conmon_haremote_sample_t), & k_haremote_format, store_ptr
+		);
+}
+
+
+aud_error_t
+conmon_haremote_store_add
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t time_ms,
+	const conmon_aud_decoded_haremote_stats_status_t * status
+)
+{
+	unsigned int d, i;
+	aud_error_t result;
+
+	if (! status)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	result = conmon_series_store_device (store, instance_id, device_name, & d);
+	for (i = 0; result == AUD_SUCCESS && i < status->ports_decoded; i++)
+	{
+		conmon_haremote_series_t * series;
+
+		result = conmon_series_store_series (store, d, (uint32_t) status->ports [i].port_number, & series);
+		if (result == AUD_SUCCESS)
+		{
+			add_sample (series, time_ms, status->ports + i);
+		}
+	}
+	return result;
+}
+
+
+void
+conmon_haremote_series_get_info
+(
+	const conmon_haremote_series_t * series,
+	conmon_haremote_series_info_t * info
+)
+{
+	info->device_name = series->device_name;
+	info->port_number = (int) series->key;
+	info->num_samples = conmon_history_count (series->samples);
+}
+
+
+void
+conmon_haremote_series_summarise
+(
+	const conmon_haremote_series_t * series,
+	uint64_t since_ms,
+	conmon_haremote_summary_t * summary
+)
+{
+	const conmon_haremote_sample_t * sample;
+	const conmon_haremote_sample_t * last = NULL;
+	unsigned int i;
+
+	memset (summary, 0, sizeof (* summary));
+	for (i = 0; (sample = conmon_series_sample_at (series, i)) != NULL; i++)
+	{
+		if (sample->time_ms < since_ms)
+		{
+			continue;
+		}
+		summary->num_samples++;
+		if (! sample->interval_ms)
+		{
+			continue;
+		}
+		last = sample;
+
+		summary->interval_ms += sample->interval_ms;
+		summary->recv_packets += sample->recv_packets_delta;
+		summary->sent_packets += sample->sent_packets_delta;
+		summary->checksum_fails += sample->checksum_fails_delta;
+		summary->timeouts += sample->timeouts_delta;
+		if (sample->recv_rate > summary->max_recv_rate) summary->max_recv_rate = sample->recv_rate;
+		if (sample->sent_rate > summary->max_sent_rate) summary->max_sent_rate = sample->sent_rate;
+		if (sample->checksum_fail_rate > summary->max_checksum_fail_rate) summary->max_checksum_fail_rate = sample->checksum_fail_rate;
+		if (sample->timeout_rate > summary->max_timeout_rate) summary->max_timeout_rate = sample->timeout_rate;
+		if (sample->counters_reset)
+		{
+			summary->num_resets++;
+		}
+	}
+	if (summary->interval_ms)
+	{
+		summary->avg_recv_rate = (float) summary->recv_packets * 1000.0f / (float) summary->interval_ms;
+		summary->avg_sent_rate = (float) summary->sent_packets * 1000.0f / (float) summary->interval_ms;
+	}
+	if (last)
+	{
+		summary->last_recv_rate = last->recv_rate;
+		summary->last_sent_rate = last->sent_rate;
+		summary->last_error_rate = last->checksum_fail_rate + last->timeout_rate;
+	}
+}
+
+
+//----------
@@ -0,0 +1,143 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Per-port time series of HA remote bridge statistics with packet and error rates
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_HAREMOTE_STORE_H
+#define _CONMON_HAREMOTE_STORE_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_series_store.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	HA remote bridge statistics are kept in a conmon_series_store with one
+	series for every bridge port of every device it has seen an HA remote
+	stats status from, keyed on the port number. The store's own functions
+	give the devices, series and samples and write the CSV and JSON exports.
+
+	The device reports cumulative packet and error counters. Each sample
+	holds them along with the change since the previous sample from the
+	same port and the rate per second over that interval. A counter going
+	backwards (the device rebooted or cleared its counters) shows up as
+	counters_reset, and that counter's delta is then its new value; each
+	counter is judged on its own.
+
+	Times are whatever the caller supplies, in milliseconds; wall clock time
+	makes the exports easiest to line up with other logs.
+ */
+
+typedef conmon_series_t conmon_haremote_series_t;
+
+typedef struct conmon_haremote_sample
+{
+	uint64_t time_ms;
+	uint32_t interval_ms;
+		// since the previous sample, 0 for the first sample
+	aud_bool_t counters_reset;
+	uint32_t recv_packets;
+	uint32_t sent_packets;
+	uint32_t checksum_fails;
+	uint32_t timeouts;
+	uint32_t recv_packets_delta;
+	uint32_t sent_packets_delta;
+	uint32_t checksum_fails_delta;
+	uint32_t timeouts_delta;
+	float recv_rate;
+	float sent_rate;
+		// packets per second since the previous sample
+	float checksum_fail_rate;
+	float timeout_rate;
+		// errors per second since the previous sample
+} conmon_haremote_sample_t;
+
+typedef struct conmon_haremote_series_info
+{
+	const char * device_name;
+	int port_number;
+	unsigned int num_samples;
+} conmon_haremote_series_info_t;
+
+typedef struct conmon_haremote_summary
+{
+	unsigned int num_samples;
+	uint64_t interval_ms;
+		// covered by the deltas below
+	unsigned long recv_packets;
+	unsigned long sent_packets;
+	unsigned long checksum_fails;
+	unsigned long timeouts;
+	float avg_recv_rate, max_recv_rate;
+	float avg_sent_rate, max_sent_rate;
+	float max_checksum_fail_rate;
+	float max_timeout_rate;
+	float last_recv_rate, last_sent_rate;
+	float last_error_rate;
+		// checksum fails and timeouts per second over the newest interval
+	unsigned int num_resets;
+} conmon_haremote_summary_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_haremote_store_new
+(
+	unsigned int max_devices,
+	unsigned int samples_per_port,
+	conmon_series_store_t ** store_ptr
+);
+
+/*
+	Add one decoded HA remote stats status from a device.
+
+	@return AUD_ERR_NOBUFS if this is a new device and max_devices are already stored
+ */
+aud_error_t
+conmon_haremote_store_add
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t time_ms,
+	const conmon_aud_decoded_haremote_stats_status_t * status
+);
+
+void
+conmon_haremote_series_get_info
+(
+	const conmon_haremote_series_t * series,
+	conmon_haremote_series_info_t * info
+);
+
+/*
+	Summarise the samples taken at or after since_ms. Average rates are
+	the total change over the total time, so a missed poll does not skew
+	them.
+ */
+void
+conmon_haremote_series_summarise
+(
+	const conmon_haremote_series_t * series,
+	uint64_t since_ms,
+	conmon_haremote_summary_t * summary
+);
+
+
+//----------
+
+#endif // _CONMON_HAREMOTE_STORE_H
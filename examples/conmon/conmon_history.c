@@ -0,0 +1,183 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Fixed size history of records that overwrites its oldest entry
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_history.h"
+#include <stdlib.h>
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	HISTORY_RECORD_ALIGN = 8
+};
+
+struct conmon_history
+{
+	unsigned int capacity;
+	unsigned int count;
+	unsigned int next;
+		// where the next record goes; also the oldest record once full
+	size_t record_size;
+	uint8_t * records;
+};
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_history_new
+(
+	unsigned int capacity,
+	size_t record_size,
+	conmon_history_t ** history_ptr
+)
+{
+	conmon_history_t * history;
+
+	if (! (capacity && record_size && history_ptr))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	record_size = (record_size + HISTORY_RECORD_ALIGN - 1) & ~ (size_t) (HISTORY_RECORD_ALIGN - 1);
+	if (record_size > ((size_t) -1 - sizeof (* history)) / capacity)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	// one allocation, records straight after the header
+	history = malloc (sizeof (* history) + HISTORY_RECORD_ALIGN + capacity * record_size);
+	if (! history)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	history->capacity = capacity;
+	history->count = 0;
+	history->next = 0;
+	history->record_size = record_size;
+	history->records = (uint8_t *) (history + 1);
+	history->records += (HISTORY_RECORD_ALIGN - ((size_t) history->records % HISTORY_RECORD_ALIGN)) % HISTORY_RECORD_ALIGN;
+
+	* history_ptr = history;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_history_delete
+(
+	conmon_history_t * history
+)
+{
+	free (history);
+}
+
+
+void *
+conmon_history_push
+(
+	conmon_history_t * history
+)
+{
+	void * record = history->records + history->next * history->record_size;
+
+	if (++history->next == history->capacity)
+	{
+		history->next = 0;
+	}
+	if (history->count < history->capacity)
+	{
+		history->count++;
+	}
+	return record;
+}
+
+
+void
+conmon_history_clear
+(
+	conmon_history_t * history
+)
+{
+	history->count = 0;
+	history->next = 0;
+}
+
+
+unsigned int
+conmon_history_count
+(
+	const conmon_history_t * history
+)
+{
+	return history->count;
+}
+
+
+unsigned int
+conmon_history_capacity
+(
+	const conmon_history_t * history
+)
+{
+	return history->capacity;
+}
+
+
+size_t
+conmon_history_record_size
+(
+	const conmon_history_t * history
+)
+{
+	return history->record_size;
+}
+
+
+const void *
+conmon_history_at
+(
+	const conmon_history_t * history,
+	unsigned int index
+)
+{
+	unsigned int slot;
+
+	if (index >= history->count)
+	{
+		return NULL;
+	}
+	// until the history is full the oldest record is in slot 0
+	slot = (history->count < history->capacity) ? index : history->next + index;
+	if (slot >= history->capacity)
+	{
+		slot -= history->capacity;
+	}
+	return history->records + slot * history->record_size;
+}
+
+
+const void *
+conmon_history_newest
+(
+	const conmon_history_t * history
+)
+{
+	return history->count ? conmon_history_at (history, history->count - 1) : NULL;
+}
+
+
+//----------
@@ -0,0 +1,102 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Fixed size history of records that overwrites its oldest entry
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_HISTORY_H
+#define _CONMON_HISTORY_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	A history holds the most recent capacity records of a fixed size in one
+	allocation made up front. Adding a record to a full history overwrites
+	the oldest, so memory use does not grow with running time.
+
+	Records are addressed from the oldest (index 0) to the newest
+	(index count - 1). Not thread safe.
+ */
+
+typedef struct conmon_history conmon_history_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_history_new
+(
+	unsigned int capacity,
+	size_t record_size,
+	conmon_history_t ** history_ptr
+);
+
+void
+conmon_history_delete
+(
+	conmon_history_t * history
+);
+
+// Returns space for a new newest record, dropping the oldest record if the history is full
+void *
+conmon_history_push
+(
+	conmon_history_t * history
+);
+
+void
+conmon_history_clear
+(
+	conmon_history_t * history
+);
+
+unsigned int
+conmon_history_count
+(
+	const conmon_history_t * history
+);
+
+unsigned int
+conmon_history_capacity
+(
+	const conmon_history_t * history
+);
+
+size_t
+conmon_history_record_size
+(
+	const conmon_history_t * history
+);
+
+// Returns NULL if index is out of range
+const void *
+conmon_history_at
+(
+	const conmon_history_t * history,
+	unsigned int index
+);
+
+// Returns NULL if the history is empty
+const void *
+conmon_history_newest
+(
+	const conmon_history_t * history
+);
+
+
+//----------
+
+#endif // _CONMON_HISTORY_H
@@ -0,0 +1,97 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Collect interface statistics from devices into per-port time series
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_ifstats_store.h"
+#include "conmon_poll_collector.h"
+
+
+//----------
+// Local functions
+
+static uint16_t
+init_query (conmon_message_body_t * body)
+{
+	conmon_audinate_init_ifstats_control (body, 0);
+	return (uint16_t) conmon_audinate_ifstats_control_get_size (body);
+}
+
+
+static aud_error_t
+add_status
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t time_ms,
+	const conmon_message_body_t * body,
+	uint16_t body_size
+)
+{
+	conmon_aud_decoded_ifstats_status_t ifstats;
+	aud_error_t result = conmon_aud_decode_ifstats_status (body, body_size, & ifstats);
+
+	if (result != AUD_SUCCESS && result != AUD_ERR_TRUNCATED)
+	{
+		return result;
+	}
+	return conmon_ifstats_store_add (store, instance_id, device_name, time_ms, & ifstats);
+}
+
+
+static void
+print_series (const conmon_series_t * series, uint64_t since_ms)
+{
+	conmon_ifstats_series_info_t info;
+	conmon_ifstats_summary_t summary;
+
+	conmon_ifstats_series_get_info (series, & info);
+	conmon_ifstats_series_summarise (series, since_ms, & summary);
+	printf ("    if %u port %u: %u samples, tx %u/%u/%u Kbps, rx %u/%u/%u Kbps (min/avg/max), "
+		"errors tx %lu rx %lu, %u resets, %u link changes\n"
+		, info.interface_index, info.port, summary.num_samples
+		, (summary.min_tx_util * 8) >> 10, (summary.avg_tx_util * 8) >> 10, (summary.max_tx_util * 8) >> 10
+		, (summary.min_rx_util * 8) >> 10, (summary.avg_rx_util * 8) >> 10, (summary.max_rx_util * 8) >> 10
+		, summary.tx_errors, summary.rx_errors
+		, summary.num_resets, summary.num_link_changes
+	);
+}
+
+
+//----------
+// Main
+
+int
+main (int argc, char * argv[])
+{
+	// every Dante device answers an ifstats query, so none are dropped
+	const conmon_poll_collector_config_t config =
+	{
+		"ifstats_collector",
+		"  Poll devices for interface statistics and keep a history for each port",
+		"interface statistics",
+		CONMON_AUDINATE_MESSAGE_TYPE_IFSTATS_STATUS,
+		AUD_FALSE,
+		init_query,
+		conmon_ifstats_store_new,
+		add_status,
+		print_series
+	};
+
+	return conmon_poll_collector_main (& config, argc, argv);
+}
+
+
+//----------
@@ -0,0 +1,262 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Per-port time series of interface statistics from ifstats status messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_ifstats_store.h"
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+static conmon_series_write_fn write_csv_row;
+static conmon_series_write_fn write_json_series;
+static conmon_series_write_fn write_json_sample;
+
+static const conmon_series_format_t k_ifstats_format =
+{
+	",interface,port,port_type,port_type_index,link_speed,flags,"
+		"tx_util,rx_util,tx_errors,rx_errors,tx_errors_delta,rx_errors_delta,"
+		"tx_error_rate,rx_error_rate,counters_reset",
+	write_csv_row,
+	"ports",
+	write_json_series,
+	write_json_sample
+};
+
+
+//----------
+// Local functions
+
+static void
+add_sample
+(
+	conmon_ifstats_series_t * series,
+	uint64_t time_ms,
+	const conmon_aud_decoded_ifstats_port_t * port
+)
+{
+	conmon_ifstats_sample_t prev;
+	conmon_ifstats_sample_t * sample;
+	const aud_bool_t have_prev = conmon_series_push (series, time_ms, & prev, (void **) & sample);
+
+	// the port's identity can change if the device reconfigures its interfaces
+	series->attributes = ((uint32_t) port->port_type << 8) | port->port_type_index;
+
+	sample->link_speed = port->link_speed;
+	sample->flags = port->flags;
+	sample->tx_util = port->tx_util;
+	sample->rx_util = port->rx_util;
+	sample->tx_errors = port->tx_errors;
+	sample->rx_errors = port->rx_errors;
+
+	if (have_prev)
+	{
+		const uint64_t interval_ms = (time_ms > prev.time_ms) ? time_ms - prev.time_ms : 0;
+
+		// each counter may be cleared on its own
+		sample->tx_errors_delta = conmon_series_counter_delta (port->tx_errors, prev.tx_errors, & sample->counters_reset);
+		sample->rx_errors_delta = conmon_series_counter_delta (port->rx_errors, prev.rx_errors, & sample->counters_reset);
+		if (interval_ms)
+		{
+			sample->tx_error_rate = (float) sample->tx_errors_delta * 1000.0f / (float) interval_ms;
+			sample->rx_error_rate = (float) sample->rx_errors_delta * 1000.0f / (float) interval_ms;
+		}
+	}
+}
+
+
+static void
+write_csv_row (FILE * fp, const conmon_series_t * series, const void * record)
+{
+	const conmon_ifstats_sample_t * sample = record;
+	conmon_ifstats_series_info_t info;
+
+	conmon_ifstats_series_get_info (series, & info);
+	fprintf (fp, ",%u,%u,%u,%u,%u,0x%04x,%u,%u,%u,%u,%u,%u,%.3f,%.3f,%d"
+		, info.interface_index, info.port
+		, info.port_type, info.port_type_index
+		, sample->link_speed, sample->flags
+		, sample->tx_util, sample->rx_util
+		, sample->tx_errors, sample->rx_errors
+		, sample->tx_errors_delta, sample->rx_errors_delta
+		, sample->tx_error_rate, sample->rx_error_rate
+		, sample->counters_reset ? 1 : 0
+	);
+}
+
+
+static void
+write_json_series (FILE * fp, const conmon_series_t * series, const void * record)
+{
+	conmon_ifstats_series_info_t info;
+
+	AUD_UNUSED (record);
+	conmon_ifstats_series_get_info (series, & info);
+	fprintf (fp, "\"interface\":%u,\"port\":%u,\"port_type\":%u,\"port_type_index\":%u"
+		, info.interface_index, info.port
+		, info.port_type, info.port_type_index
+	);
+}
+
+
+static void
+write_json_sample (FILE * fp, const conmon_series_t * series, const void * record)
+{
+	const conmon_ifstats_sample_t * sample = record;
+
+	AUD_UNUSED (series);
+	fprintf (fp,
+		",\"link_speed\":%u,\"flags\":%u,"
+		"\"tx_util\":%u,\"rx_util\":%u,\"tx_errors\":%u,\"rx_errors\":%u,"
+		"\"tx_errors_delta\":%u,\"rx_errors_delta\":%u,"
+		"\"tx_error_rate\":%.3f,\"rx_error_rate\":%.3f,\"counters_reset\":%s"
+		, sample->link_speed, sample->flags
+		, sample->tx_util, sample->rx_util
+		, sample->tx_errors, sample->rx_errors
+		, sample->tx_errors_delta, sample->rx_errors_delta
+		, sample->tx_error_rate, sample->rx_error_rate
+		, sample->counters_reset ? "true" : "false"
+	);
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_ifstats_store_new
+(
+	unsigned int max_devices,
+	unsigned int samples_per_port,
+	conmon_series_store_t ** store_ptr
+)
+{
+	return
+		conmon_series_store_new (
+			max_devices, CONMON_AUD_DECODE_MAX_IFSTATS_PORTS, samples_per_port,
+			sizeof (conmon_ifstats_sample_t), & k_ifstats_format, store_ptr
+		);
+}
+
+
+aud_error_t
+conmon_ifstats_store_add
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t time_ms,
+	const conmon_aud_decoded_ifstats_status_t * status
+)
+{
+	unsigned int d, i;
+	aud_error_t result;
+
+	if (! status)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	result = conmon_series_store_device (store, instance_id, device_name, & d);
+	for (i = 0; result == AUD_SUCCESS && i < status->ports_decoded; i++)
+	{
+		const conmon_aud_decoded_ifstats_port_t * port = status->ports + i;
+		conmon_ifstats_series_t * series;
+
+		result =
+			conmon_series_store_series (
+				store, d, conmon_ifstats_series_key (port->interface_index, port->port), & series
+			);
+		if (result == AUD_SUCCESS)
+		{
+			add_sample (series, time_ms, port);
+		}
+	}
+	return result;
+}
+
+
+void
+conmon_ifstats_series_get_info
+(
+	const conmon_ifstats_series_t * series,
+	conmon_ifstats_series_info_t * info
+)
+{
+	info->device_name = series->device_name;
+	info->interface_index = (uint16_t) (series->key >> 16);
+	info->port = (uint16_t) series->key;
+	info->port_type = (uint8_t) (series->attributes >> 8);
+	info->port_type_index = (uint8_t) series->attributes;
+	info->num_samples = conmon_history_count (series->samples);
+}
+
+
+void
+conmon_ifstats_series_summarise
+(
+	const conmon_ifstats_series_t * series,
+	uint64_t since_ms,
+	conmon_ifstats_summary_t * summary
+)
+{
+	const conmon_ifstats_sample_t * sample;
+	const conmon_ifstats_sample_t * prev = NULL;
+	uint64_t tx_total = 0, rx_total = 0;
+	unsigned int i;
+
+	memset (summary, 0, sizeof (* summary));
+	for (i = 0; (sample = conmon_series_sample_at (series, i)) != NULL; i++)
+	{
+		if (sample->time_ms < since_ms)
+		{
+			continue;
+		}
+		if (! summary->num_samples)
+		{
+			summary->min_tx_util = sample->tx_util;
+			summary->min_rx_util = sample->rx_util;
+		}
+		summary->num_samples++;
+
+		if (sample->tx_util < summary->min_tx_util) summary->min_tx_util = sample->tx_util;
+		if (sample->tx_util > summary->max_tx_util) summary->max_tx_util = sample->tx_util;
+		if (sample->rx_util < summary->min_rx_util) summary->min_rx_util = sample->rx_util;
+		if (sample->rx_util > summary->max_rx_util) summary->max_rx_util = sample->rx_util;
+		tx_total += sample->tx_util;
+		rx_total += sample->rx_util;
+
+		summary->tx_errors += sample->tx_errors_delta;
+		summary->rx_errors += sample->rx_errors_delta;
+		if (sample->tx_error_rate > summary->max_tx_error_rate) summary->max_tx_error_rate = sample->tx_error_rate;
+		if (sample->rx_error_rate > summary->max_rx_error_rate) summary->max_rx_error_rate = sample->rx_error_rate;
+		if (sample->counters_reset)
+		{
+			summary->num_resets++;
+		}
+		// only changes between samples inside the window count
+		if (prev && (prev->link_speed != sample->link_speed || prev->flags != sample->flags))
+		{
+			summary->num_link_changes++;
+		}
+		prev = sample;
+	}
+	if (summary->num_samples)
+	{
+		summary->avg_tx_util = (uint32_t) (tx_total / summary->num_samples);
+		summary->avg_rx_util = (uint32_t) (rx_total / summary->num_samples);
+	}
+}
+
+
+//----------
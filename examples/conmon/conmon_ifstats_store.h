@@ -0,0 +1,143 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Per-port time series of interface statistics from ifstats status messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_IFSTATS_STORE_H
+#define _CONMON_IFSTATS_STORE_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_series_store.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	Interface statistics are kept in a conmon_series_store with one series
+	for every port of every device it has seen an ifstats status from. Each
+	sample holds the values the device reported plus the change in the
+	error counters since the previous sample from the same port and the
+	error rates over that interval. The store's own functions give the
+	devices, series and samples and write the CSV and JSON exports.
+
+	Utilisation is reported by the device as a rate in bytes per second and
+	is stored as is; error counters are cumulative on the device and may be
+	cleared, which shows up as counters_reset on the next sample. The delta
+	of a counter that went backwards is its new value; the other counter's
+	delta is unaffected.
+
+	Times are whatever the caller supplies, in milliseconds; wall clock time
+	makes the exports easiest to line up with other logs.
+ */
+
+typedef conmon_series_t conmon_ifstats_series_t;
+
+typedef struct conmon_ifstats_sample
+{
+	uint64_t time_ms;
+	uint32_t link_speed;
+	uint16_t flags;
+	aud_bool_t counters_reset;
+		// an error counter went backwards; deltas are the new counter values
+	uint32_t tx_util;
+	uint32_t rx_util;
+		// bytes per second
+	uint32_t tx_errors;
+	uint32_t rx_errors;
+	uint32_t tx_errors_delta;
+	uint32_t rx_errors_delta;
+		// since the previous sample, 0 for the first sample
+	float tx_error_rate;
+	float rx_error_rate;
+		// errors per second since the previous sample
+} conmon_ifstats_sample_t;
+
+typedef struct conmon_ifstats_series_info
+{
+	const char * device_name;
+	uint16_t interface_index;
+	uint16_t port;
+	uint8_t port_type;
+	uint8_t port_type_index;
+	unsigned int num_samples;
+} conmon_ifstats_series_info_t;
+
+typedef struct conmon_ifstats_summary
+{
+	unsigned int num_samples;
+	uint32_t min_tx_util, max_tx_util, avg_tx_util;
+	uint32_t min_rx_util, max_rx_util, avg_rx_util;
+	unsigned long tx_errors;
+	unsigned long rx_errors;
+	float max_tx_error_rate;
+	float max_rx_error_rate;
+	unsigned int num_resets;
+	unsigned int num_link_changes;
+		// samples whose link speed or flags differ from the sample before
+} conmon_ifstats_summary_t;
+
+
+//----------
+// Functions
+
+// The series key of a port, for conmon_series_store_find_series
+AUD_INLINE uint32_t
+conmon_ifstats_series_key (uint16_t interface_index, uint16_t port)
+{
+	return ((uint32_t) interface_index << 16) | port;
+}
+
+aud_error_t
+conmon_ifstats_store_new
+(
+	unsigned int max_devices,
+	unsigned int samples_per_port,
+	conmon_series_store_t ** store_ptr
+);
+
+/*
+	Add one decoded ifstats status from a device.
+
+	@return AUD_ERR_NOBUFS if this is a new device and max_devices are already stored
+ */
+aud_error_t
+conmon_ifstats_store_add
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t time_ms,
+	const conmon_aud_decoded_ifstats_status_t * status
+);
+
+void
+conmon_ifstats_series_get_info
+(
+	const conmon_ifstats_series_t * series,
+	conmon_ifstats_series_info_t * info
+);
+
+// Summarise the samples taken at or after since_ms
+void
+conmon_ifstats_series_summarise
+(
+	const conmon_ifstats_series_t * series,
+	uint64_t since_ms,
+	conmon_ifstats_summary_t * summary
+);
+
+
+//----------
+
+#endif // _CONMON_IFSTATS_STORE_H
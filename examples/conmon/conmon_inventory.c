@@ -0,0 +1,1016 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Indexed table of device versions, models and capabilities
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_inventory.h"
+#include "dapi_io.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+#define INVENTORY_NO_ENTRY 0xFFFFFFFFu
+
+enum
+{
+	INVENTORY_ORDER_FIRMWARE = 0,
+	INVENTORY_ORDER_SOFTWARE,
+	INVENTORY_NUM_ORDERS
+};
+
+typedef struct inventory_entry
+{
+	conmon_inventory_record_t record;
+		// must be first, handed out as the public view of the entry
+	uint64_t keys [INVENTORY_NUM_ORDERS];
+	uint64_t due_ms;
+	uint32_t heap_pos;
+		// INVENTORY_NO_ENTRY if no refresh is scheduled
+} inventory_entry_t;
+
+/*
+	Entries are stored densely in order of arrival. The id map gives the
+	entry index for each instance id; expected entries are not in it until
+	their first status, and are found by name while num_expected is
+	non-zero. The version
+	orders hold the indexes of entries that have versions, sorted by key,
+	and the refresh heap holds the scheduled entries ordered by due time.
+ */
+struct conmon_inventory
+{
+	conmon_inventory_config_t config;
+	conmon_inventory_event_fn * event_fn;
+	void * event_context;
+
+	inventory_entry_t * entries;
+	unsigned int num_entries;
+	dapi_id_map_t * ids;
+		// instance id to uint32_t entry index
+	unsigned int num_expected;
+		// entries without an instance id
+
+	uint32_t * orders [INVENTORY_NUM_ORDERS];
+	unsigned int num_ordered;
+
+	uint32_t * heap;
+	unsigned int heap_len;
+
+	unsigned long num_queries;
+	unsigned long num_updates;
+	unsigned long num_changes;
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE uint64_t
+version_key (const dante_version_t * version, const dante_version_build_t * build)
+{
+	return ((uint64_t) version->major << 56)
+		| ((uint64_t) version->minor << 48)
+		| ((uint64_t) version->bugfix << 32)
+		| build->build_number;
+}
+
+
+// Copy a string that may be NULL, returning true if the copy differs from what was there
+static aud_bool_t
+copy_string (char * dst, const char * src)
+{
+	char buf [CONMON_INVENTORY_MAX_STRING];
+
+	buf [0] = 0;
+	if (src)
+	{
+		strncpy (buf, src, sizeof (buf) - 1);
+		buf [sizeof (buf) - 1] = 0;
+	}
+	if (! strcmp (dst, buf))
+	{
+		return AUD_FALSE;
+	}
+	strcpy (dst, buf);
+	return AUD_TRUE;
+}
+
+
+// First position in the order whose key is at least key
+static unsigned int
+order_lower_bound (const conmon_inventory_t * inventory, unsigned int order, uint64_t key)
+{
+	const uint32_t * o = inventory->orders [order];
+	unsigned int lo = 0, hi = inventory->num_ordered;
+
+	while (lo < hi)
+	{
+		const unsigned int mid = lo + (hi - lo) / 2;
+		if (inventory->entries [o [mid]].keys [order] < key)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+
+// Insert after any entries with an equal key, so equal versions stay in order of insertion
+static void
+order_insert (conmon_inventory_t * inventory, unsigned int order, uint32_t i, unsigned int num_ordered)
+{
+	uint32_t * o = inventory->orders [order];
+	const uint64_t key = inventory->entries [i].keys [order];
+	unsigned int lo = 0, hi = num_ordered;
+
+	while (lo < hi)
+	{
+		const unsigned int mid = lo + (hi - lo) / 2;
+		if (inventory->entries [o [mid]].keys [order] <= key)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	memmove (o + lo + 1, o + lo, (num_ordered - lo) * sizeof (uint32_t));
+	o [lo] = i;
+}
+
+
+static void
+order_remove (conmon_inventory_t * inventory, unsigned int order, uint32_t i)
+{
+	uint32_t * o = inventory->orders [order];
+	unsigned int pos = order_lower_bound (inventory, order, inventory->entries [i].keys [order]);
+
+	while (o [pos] != i)
+	{
+		pos++;
+	}
+	memmove (o + pos, o + pos + 1, (inventory->num_ordered - pos - 1) * sizeof (uint32_t));
+}
+
+
+// Set an entry's version keys, adding it to the orders the first time
+static void
+set_keys (conmon_inventory_t * inventory, uint32_t i, const uint64_t keys [INVENTORY_NUM_ORDERS], aud_bool_t ordered)
+{
+	inventory_entry_t * entry = inventory->entries + i;
+	unsigned int order;
+
+	for (order = 0; order < INVENTORY_NUM_ORDERS; order++)
+	{
+		if (ordered)
+		{
+			if (entry->keys [order] == keys [order])
+			{
+				continue;
+			}
+			order_remove (inventory, order, i);
+			entry->keys [order] = keys [order];
+			order_insert (inventory, order, i, inventory->num_ordered - 1);
+		}
+		else
+		{
+			entry->keys [order] = keys [order];
+			order_insert (inventory, order, i, inventory->num_ordered);
+		}
+	}
+	if (! ordered)
+	{
+		inventory->num_ordered++;
+	}
+}
+
+
+AUD_INLINE void
+heap_place (conmon_inventory_t * inventory, unsigned int pos, uint32_t i)
+{
+	inventory->heap [pos] = i;
+	inventory->entries [i].heap_pos = pos;
+}
+
+
+static void
+heap_sift (conmon_inventory_t * inventory, unsigned int pos)
+{
+	const uint32_t i = inventory->heap [pos];
+	const uint64_t due = inventory->entries [i].due_ms;
+
+	while (pos > 0)
+	{
+		const unsigned int parent = (pos - 1) / 2;
+		if (inventory->entries [inventory->heap [parent]].due_ms <= due)
+		{
+			break;
+		}
+		heap_place (inventory, pos, inventory->heap [parent]);
+		pos = parent;
+	}
+	for (;;)
+	{
+		unsigned int child = 2 * pos + 1;
+		if (child >= inventory->heap_len)
+		{
+			break;
+		}
+		if (child + 1 < inventory->heap_len
+			&& inventory->entries [inventory->heap [child + 1]].due_ms
+				< inventory->entries [inventory->heap [child]].due_ms)
+		{
+			child++;
+		}
+		if (inventory->entries [inventory->heap [child]].due_ms >= due)
+		{
+			break;
+		}
+		heap_place (inventory, pos, inventory->heap [child]);
+		pos = child;
+	}
+	heap_place (inventory, pos, i);
+}
+
+
+static void
+schedule (conmon_inventory_t * inventory, uint32_t i, uint64_t due_ms)
+{
+	inventory_entry_t * entry = inventory->entries + i;
+
+	entry->due_ms = due_ms;
+	if (entry->heap_pos == INVENTORY_NO_ENTRY)
+	{
+		heap_place (inventory, inventory->heap_len++, i);
+	}
+	heap_sift (inventory, entry->heap_pos);
+}
+
+
+static void
+unschedule (conmon_inventory_t * inventory, uint32_t i)
+{
+	inventory_entry_t * entry = inventory->entries + i;
+	const unsigned int pos = entry->heap_pos;
+
+	if (pos == INVENTORY_NO_ENTRY)
+	{
+		return;
+	}
+	entry->heap_pos = INVENTORY_NO_ENTRY;
+	if (pos < --inventory->heap_len)
+	{
+		heap_place (inventory, pos, inventory->heap [inventory->heap_len]);
+		heap_sift (inventory, pos);
+	}
+}
+
+
+static uint32_t
+find_expected (const conmon_inventory_t * inventory, const char * device_name)
+{
+	uint32_t i;
+
+	if (! inventory->num_expected)
+	{
+		return INVENTORY_NO_ENTRY;
+	}
+	for (i = 0; i < inventory->num_entries; i++)
+	{
+		const conmon_inventory_record_t * record = & inventory->entries [i].record;
+		if (! record->have_instance_id && dapi_name_equals (record->device_name, device_name))
+		{
+			return i;
+		}
+	}
+	return INVENTORY_NO_ENTRY;
+}
+
+
+static uint32_t
+add_entry (conmon_inventory_t * inventory, const char * device_name, uint64_t now_ms)
+{
+	const uint32_t i = inventory->num_entries++;
+	inventory_entry_t * entry = inventory->entries + i;
+
+	strcpy (entry->record.device_name, device_name);
+	entry->record.pending = CONMON_INVENTORY_VERSIONS;
+	entry->heap_pos = INVENTORY_NO_ENTRY;
+	schedule (inventory, i, now_ms);
+	return i;
+}
+
+
+static aud_error_t
+find_or_add
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t now_ms,
+	uint32_t * index
+)
+{
+	conmon_inventory_record_t * record;
+	unsigned int m;
+	uint32_t i;
+
+	if (! (inventory && instance_id && device_name)
+		|| strlen (device_name) >= sizeof (record->device_name))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	m = dapi_id_map_find (inventory->ids, instance_id);
+	if (m != DAPI_ID_MAP_NO_ENTRY)
+	{
+		i = * (const uint32_t *) dapi_id_map_value_at (inventory->ids, m);
+		record = & inventory->entries [i].record;
+		if (strcmp (record->device_name, device_name))
+		{
+			strcpy (record->device_name, device_name);
+		}
+		* index = i;
+		return AUD_SUCCESS;
+	}
+
+	i = find_expected (inventory, device_name);
+	if (i != INVENTORY_NO_ENTRY)
+	{
+		inventory->num_expected--;
+	}
+	else if (inventory->num_entries >= inventory->config.max_devices)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	else
+	{
+		i = add_entry (inventory, device_name, now_ms);
+	}
+
+	// cannot fail, the map holds as many ids as there are entries
+	dapi_id_map_insert (inventory->ids, instance_id, & m, NULL);
+	* (uint32_t *) dapi_id_map_value_at (inventory->ids, m) = i;
+	record = & inventory->entries [i].record;
+	record->instance_id = * instance_id;
+	record->have_instance_id = AUD_TRUE;
+	strcpy (record->device_name, device_name);
+	* index = i;
+	return AUD_SUCCESS;
+}
+
+
+static void
+finish_update
+(
+	conmon_inventory_t * inventory,
+	uint32_t i,
+	unsigned int received,
+	unsigned int changes,
+	uint64_t now_ms
+)
+{
+	conmon_inventory_record_t * record = & inventory->entries [i].record;
+	const unsigned int was_pending = record->pending;
+
+	record->have |= received;
+	record->pending &= ~received;
+
+	// manufacturer versions are only wanted from devices that have them
+	if (record->capability_flags & (1u << CONMON_AUDINATE_CAPABILITY_HAS_MANF_VERSIONS))
+	{
+		if (! (record->have & CONMON_INVENTORY_MANF_VERSIONS))
+		{
+			record->pending |= CONMON_INVENTORY_MANF_VERSIONS;
+		}
+	}
+	else if (record->have & CONMON_INVENTORY_VERSIONS)
+	{
+		record->pending &= ~CONMON_INVENTORY_MANF_VERSIONS;
+	}
+
+	if (! record->pending)
+	{
+		record->attempts = 0;
+		unschedule (inventory, i);
+	}
+	else if (record->pending & ~was_pending)
+	{
+		// newly wanted, so it gets a fresh set of attempts
+		record->attempts = 0;
+		schedule (inventory, i, now_ms);
+	}
+
+	inventory->num_updates++;
+	record->num_updates++;
+	record->updated_ms = now_ms;
+	if (changes)
+	{
+		inventory->num_changes++;
+		record->num_changes++;
+		record->changed_ms = now_ms;
+		if (inventory->event_fn)
+		{
+			inventory->event_fn (inventory->event_context, record, changes);
+		}
+	}
+}
+
+
+static aud_bool_t
+record_matches (const inventory_entry_t * entry, const conmon_inventory_filter_t * filter)
+{
+	const conmon_inventory_record_t * record = & entry->record;
+	const unsigned int criteria = filter->criteria;
+
+	if (criteria & (CONMON_INVENTORY_FILTER_FIRMWARE_AT_LEAST | CONMON_INVENTORY_FILTER_FIRMWARE_BELOW
+		| CONMON_INVENTORY_FILTER_SOFTWARE_AT_LEAST | CONMON_INVENTORY_FILTER_SOFTWARE_BELOW))
+	{
+		if (! (record->have & CONMON_INVENTORY_VERSIONS))
+		{
+			return AUD_FALSE;
+		}
+		if ((criteria & CONMON_INVENTORY_FILTER_FIRMWARE_AT_LEAST)
+			&& entry->keys [INVENTORY_ORDER_FIRMWARE]
+				< version_key (& filter->firmware_at_least, & filter->firmware_at_least_build))
+		{
+			return AUD_FALSE;
+		}
+		if ((criteria & CONMON_INVENTORY_FILTER_FIRMWARE_BELOW)
+			&& entry->keys [INVENTORY_ORDER_FIRMWARE]
+				>= version_key (& filter->firmware_below, & filter->firmware_below_build))
+		{
+			return AUD_FALSE;
+		}
+		if ((criteria & CONMON_INVENTORY_FILTER_SOFTWARE_AT_LEAST)
+			&& entry->keys [INVENTORY_ORDER_SOFTWARE]
+				< version_key (& filter->software_at_least, & filter->software_at_least_build))
+		{
+			return AUD_FALSE;
+		}
+		if ((criteria & CONMON_INVENTORY_FILTER_SOFTWARE_BELOW)
+			&& entry->keys [INVENTORY_ORDER_SOFTWARE]
+				>= version_key (& filter->software_below, & filter->software_below_build))
+		{
+			return AUD_FALSE;
+		}
+	}
+	if (criteria & CONMON_INVENTORY_FILTER_CAPABILITIES)
+	{
+		if (! (record->have & CONMON_INVENTORY_VERSIONS)
+			|| (record->capability_flags & filter->capabilities_set) != filter->capabilities_set
+			|| (record->capability_flags & filter->capabilities_clear))
+		{
+			return AUD_FALSE;
+		}
+	}
+	if ((criteria & CONMON_INVENTORY_FILTER_MODEL_NAME)
+		&& ! (filter->model_name && dapi_name_equals (record->model_name, filter->model_name)))
+	{
+		return AUD_FALSE;
+	}
+	if ((criteria & CONMON_INVENTORY_FILTER_STALE) && ! record->pending)
+	{
+		return AUD_FALSE;
+	}
+	return AUD_TRUE;
+}
+
+
+//----------
+// Functions
+
+void
+conmon_inventory_config_init
+(
+	conmon_inventory_config_t * config
+)
+{
+	config->max_devices = 4096;
+	config->retry_ms = 10000;
+	config->max_attempts = 3;
+}
+
+
+aud_error_t
+conmon_inventory_new
+(
+	const conmon_inventory_config_t * config,
+	conmon_inventory_event_fn * event_fn,
+	void * event_context,
+	conmon_inventory_t ** inventory_ptr
+)
+{
+	conmon_inventory_t * inventory;
+	unsigned int order;
+
+	if (! (config && inventory_ptr && config->max_devices && config->max_attempts)
+		|| config->max_devices > 0x100000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	inventory = calloc (1, sizeof (* inventory));
+	if (! inventory)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	inventory->entries = calloc (config->max_devices, sizeof (* inventory->entries));
+	inventory->heap = malloc (config->max_devices * sizeof (uint32_t));
+	for (order = 0; order < INVENTORY_NUM_ORDERS; order++)
+	{
+		inventory->orders [order] = malloc (config->max_devices * sizeof (uint32_t));
+	}
+	if (! (inventory->entries && inventory->heap
+			&& inventory->orders [INVENTORY_ORDER_FIRMWARE] && inventory->orders [INVENTORY_ORDER_SOFTWARE])
+		|| dapi_id_map_new (config->max_devices, sizeof (uint32_t), & inventory->ids) != AUD_SUCCESS)
+	{
+		conmon_inventory_delete (inventory);
+		return AUD_ERR_NOMEMORY;
+	}
+	inventory->config = * config;
+	inventory->event_fn = event_fn;
+	inventory->event_context = event_context;
+
+	* inventory_ptr = inventory;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_inventory_delete
+(
+	conmon_inventory_t * inventory
+)
+{
+	unsigned int order;
+
+	if (! inventory)
+	{
+		return;
+	}
+	for (order = 0; order < INVENTORY_NUM_ORDERS; order++)
+	{
+		free (inventory->orders [order]);
+	}
+	free (inventory->heap);
+	dapi_id_map_delete (inventory->ids);
+	free (inventory->entries);
+	free (inventory);
+}
+
+
+aud_error_t
+conmon_inventory_seen
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t now_ms
+)
+{
+	uint32_t i;
+	return find_or_add (inventory, instance_id, device_name, now_ms, & i);
+}
+
+
+aud_error_t
+conmon_inventory_expect
+(
+	conmon_inventory_t * inventory,
+	const char * device_name,
+	uint64_t now_ms
+)
+{
+	uint32_t i;
+
+	if (! (inventory && device_name)
+		|| strlen (device_name) >= sizeof (inventory->entries [0].record.device_name))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	for (i = 0; i < inventory->num_entries; i++)
+	{
+		if (dapi_name_equals (inventory->entries [i].record.device_name, device_name))
+		{
+			return AUD_SUCCESS;
+		}
+	}
+	if (inventory->num_entries >= inventory->config.max_devices)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	add_entry (inventory, device_name, now_ms);
+	inventory->num_expected++;
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_inventory_invalidate
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t now_ms
+)
+{
+	conmon_inventory_record_t * record;
+	uint32_t i;
+	aud_error_t result = find_or_add (inventory, instance_id, device_name, now_ms, & i);
+
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	record = & inventory->entries [i].record;
+	record->pending =
+		CONMON_INVENTORY_VERSIONS | (record->have & CONMON_INVENTORY_MANF_VERSIONS);
+	record->attempts = 0;
+	schedule (inventory, i, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_inventory_update_versions
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	const conmon_aud_decoded_versions_status_t * versions,
+	uint64_t now_ms
+)
+{
+	conmon_inventory_record_t * record;
+	uint64_t keys [INVENTORY_NUM_ORDERS];
+	unsigned int changes = 0;
+	aud_bool_t model_changed;
+	uint32_t i;
+	aud_error_t result;
+
+	if (! versions)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	result = find_or_add (inventory, instance_id, device_name, now_ms, & i);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	record = & inventory->entries [i].record;
+
+	keys [INVENTORY_ORDER_FIRMWARE] = version_key (& versions->firmware_version, & versions->firmware_build);
+	keys [INVENTORY_ORDER_SOFTWARE] = version_key (& versions->software_version, & versions->software_build);
+	model_changed = copy_string (record->model_name, versions->model_name);
+	if (versions->model_id
+		&& memcmp (& record->model_id, versions->model_id, sizeof (record->model_id)))
+	{
+		record->model_id = * versions->model_id;
+		model_changed = AUD_TRUE;
+	}
+
+	if (! (record->have & CONMON_INVENTORY_VERSIONS))
+	{
+		changes = CONMON_INVENTORY_CHANGE_NEW;
+	}
+	else
+	{
+		if (keys [INVENTORY_ORDER_SOFTWARE] != inventory->entries [i].keys [INVENTORY_ORDER_SOFTWARE])
+		{
+			changes |= CONMON_INVENTORY_CHANGE_SOFTWARE;
+		}
+		if (keys [INVENTORY_ORDER_FIRMWARE] != inventory->entries [i].keys [INVENTORY_ORDER_FIRMWARE]
+			|| record->dante_api_version != versions->dante_api_version
+			|| record->uboot_version != versions->uboot_version
+			|| record->upgrade_version != versions->upgrade_version)
+		{
+			changes |= CONMON_INVENTORY_CHANGE_FIRMWARE;
+		}
+		if (record->capability_flags != versions->capability_flags
+			|| record->inferred_capability_flags != versions->inferred_capability_flags
+			|| record->readonly_capability_flags != versions->readonly_capability_flags)
+		{
+			changes |= CONMON_INVENTORY_CHANGE_CAPABILITIES;
+		}
+		if (model_changed)
+		{
+			changes |= CONMON_INVENTORY_CHANGE_MODEL;
+		}
+	}
+
+	record->software_version = versions->software_version;
+	record->software_build = versions->software_build;
+	record->firmware_version = versions->firmware_version;
+	record->firmware_build = versions->firmware_build;
+	record->dante_api_version = versions->dante_api_version;
+	record->uboot_version = versions->uboot_version;
+	record->upgrade_version = versions->upgrade_version;
+	record->capability_flags = versions->capability_flags;
+	record->inferred_capability_flags = versions->inferred_capability_flags;
+	record->readonly_capability_flags = versions->readonly_capability_flags;
+	set_keys (inventory, i, keys, (record->have & CONMON_INVENTORY_VERSIONS) != 0);
+
+	finish_update (inventory, i, CONMON_INVENTORY_VERSIONS, changes, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_inventory_update_manf_versions
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	const conmon_aud_decoded_manf_versions_status_t * manf_versions,
+	uint64_t now_ms
+)
+{
+	conmon_inventory_record_t * record;
+	aud_bool_t changed;
+	uint32_t i;
+	aud_error_t result;
+
+	if (! manf_versions)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	result = find_or_add (inventory, instance_id, device_name, now_ms, & i);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	record = & inventory->entries [i].record;
+
+	changed = ! (record->have & CONMON_INVENTORY_MANF_VERSIONS);
+	changed |= copy_string (record->manufacturer_name, manf_versions->manufacturer_name);
+	changed |= copy_string (record->manf_model_name, manf_versions->model_name);
+	changed |= copy_string (record->manf_model_version_string, manf_versions->model_version_string);
+	if (manf_versions->manufacturer
+		&& memcmp (& record->manufacturer, manf_versions->manufacturer, sizeof (record->manufacturer)))
+	{
+		record->manufacturer = * manf_versions->manufacturer;
+		changed = AUD_TRUE;
+	}
+	if (manf_versions->model_id
+		&& memcmp (& record->manf_model_id, manf_versions->model_id, sizeof (record->manf_model_id)))
+	{
+		record->manf_model_id = * manf_versions->model_id;
+		changed = AUD_TRUE;
+	}
+	if (manf_versions->serial_id
+		&& memcmp (& record->serial_id, manf_versions->serial_id, sizeof (record->serial_id)))
+	{
+		record->serial_id = * manf_versions->serial_id;
+		changed = AUD_TRUE;
+	}
+	if (record->manf_model_version != manf_versions->model_version
+		|| record->manf_capabilities != manf_versions->capabilities
+		|| version_key (& record->manf_software_version, & record->manf_software_build)
+			!= version_key (& manf_versions->software_version, & manf_versions->software_build)
+		|| version_key (& record->manf_firmware_version, & record->manf_firmware_build)
+			!= version_key (& manf_versions->firmware_version, & manf_versions->firmware_build))
+	{
+		changed = AUD_TRUE;
+	}
+
+	record->manf_model_version = manf_versions->model_version;
+	record->manf_capabilities = manf_versions->capabilities;
+	record->manf_software_version = manf_versions->software_version;
+	record->manf_software_build = manf_versions->software_build;
+	record->manf_firmware_version = manf_versions->firmware_version;
+	record->manf_firmware_build = manf_versions->firmware_build;
+
+	finish_update (inventory, i, CONMON_INVENTORY_MANF_VERSIONS,
+		changed ? CONMON_INVENTORY_CHANGE_MANUFACTURER : 0, now_ms);
+	return AUD_SUCCESS;
+}
+
+
+aud_bool_t
+conmon_inventory_next_refresh
+(
+	conmon_inventory_t * inventory,
+	uint64_t now_ms,
+	unsigned int * record_index,
+	unsigned int * queries
+)
+{
+	conmon_inventory_record_t * record;
+	uint32_t i;
+
+	if (! (inventory && inventory->heap_len && record_index && queries))
+	{
+		return AUD_FALSE;
+	}
+	i = inventory->heap [0];
+	if (inventory->entries [i].due_ms > now_ms)
+	{
+		return AUD_FALSE;
+	}
+
+	record = & inventory->entries [i].record;
+	record->attempts++;
+	inventory->num_queries++;
+	if (record->attempts < inventory->config.max_attempts)
+	{
+		schedule (inventory, i, now_ms + inventory->config.retry_ms);
+	}
+	else
+	{
+		unschedule (inventory, i);
+	}
+
+	* record_index = i;
+	* queries = record->pending;
+	return AUD_TRUE;
+}
+
+
+unsigned int
+conmon_inventory_ms_to_next_refresh
+(
+	const conmon_inventory_t * inventory,
+	uint64_t now_ms
+)
+{
+	uint64_t due;
+
+	if (! (inventory && inventory->heap_len))
+	{
+		return UINT_MAX;
+	}
+	due = inventory->entries [inventory->heap [0]].due_ms;
+	if (due <= now_ms)
+	{
+		return 0;
+	}
+	return (due - now_ms < UINT_MAX) ? (unsigned int) (due - now_ms) : UINT_MAX;
+}
+
+
+const conmon_inventory_record_t *
+conmon_inventory_find
+(
+	const conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id
+)
+{
+	unsigned int m;
+
+	if (! (inventory && instance_id))
+	{
+		return NULL;
+	}
+	m = dapi_id_map_find (inventory->ids, instance_id);
+	if (m == DAPI_ID_MAP_NO_ENTRY)
+	{
+		return NULL;
+	}
+	return & inventory->entries [* (const uint32_t *) dapi_id_map_value_at (inventory->ids, m)].record;
+}
+
+
+const conmon_inventory_record_t *
+conmon_inventory_record_at_index
+(
+	const conmon_inventory_t * inventory,
+	unsigned int index
+)
+{
+	if (! inventory || index >= inventory->num_entries)
+	{
+		return NULL;
+	}
+	return & inventory->entries [index].record;
+}
+
+
+void
+conmon_inventory_filter_init
+(
+	conmon_inventory_filter_t * filter
+)
+{
+	memset (filter, 0, sizeof (* filter));
+}
+
+
+unsigned int
+conmon_inventory_query
+(
+	const conmon_inventory_t * inventory,
+	const conmon_inventory_filter_t * filter,
+	unsigned int * indices,
+	unsigned int max_indices
+)
+{
+	const uint32_t * order = NULL;
+	unsigned int begin = 0, end, pos, num_matches = 0;
+
+	if (! (inventory && filter))
+	{
+		return 0;
+	}
+
+	// narrow a version range to a slice of its order before filtering
+	end = inventory->num_entries;
+	if (filter->criteria & (CONMON_INVENTORY_FILTER_FIRMWARE_AT_LEAST | CONMON_INVENTORY_FILTER_FIRMWARE_BELOW))
+	{
+		order = inventory->orders [INVENTORY_ORDER_FIRMWARE];
+		end = inventory->num_ordered;
+		if (filter->criteria & CONMON_INVENTORY_FILTER_FIRMWARE_AT_LEAST)
+		{
+			begin = order_lower_bound (inventory, INVENTORY_ORDER_FIRMWARE,
+				version_key (& filter->firmware_at_least, & filter->firmware_at_least_build));
+		}
+		if (filter->criteria & CONMON_INVENTORY_FILTER_FIRMWARE_BELOW)
+		{
+			end = order_lower_bound (inventory, INVENTORY_ORDER_FIRMWARE,
+				version_key (& filter->firmware_below, & filter->firmware_below_build));
+		}
+	}
+	else if (filter->criteria & (CONMON_INVENTORY_FILTER_SOFTWARE_AT_LEAST | CONMON_INVENTORY_FILTER_SOFTWARE_BELOW))
+	{
+		order = inventory->orders [INVENTORY_ORDER_SOFTWARE];
+		end = inventory->num_ordered;
+		if (filter->criteria & CONMON_INVENTORY_FILTER_SOFTWARE_AT_LEAST)
+		{
+			begin = order_lower_bound (inventory, INVENTORY_ORDER_SOFTWARE,
+				version_key (& filter->software_at_least, & filter->software_at_least_build));
+		}
+		if (filter->criteria & CONMON_INVENTORY_FILTER_SOFTWARE_BELOW)
+		{
+			end = order_lower_bound (inventory, INVENTORY_ORDER_SOFTWARE,
+				version_key (& filter->software_below, & filter->software_below_build));
+		}
+	}
+
+	for (pos = begin; pos < end; pos++)
+	{
+		const uint32_t i = order ? order [pos] : pos;
+		if (record_matches (inventory->entries + i, filter))
+		{
+			if (indices && num_matches < max_indices)
+			{
+				indices [num_matches] = i;
+			}
+			num_matches++;
+		}
+	}
+	return num_matches;
+}
+
+
+void
+conmon_inventory_get_stats
+(
+	const conmon_inventory_t * inventory,
+	conmon_inventory_stats_t * stats
+)
+{
+	unsigned int i;
+
+	if (! (inventory && stats))
+	{
+		return;
+	}
+
+	memset (stats, 0, sizeof (* stats));
+	stats->num_devices = inventory->num_entries;
+	for (i = 0; i < inventory->num_entries; i++)
+	{
+		const conmon_inventory_record_t * record = & inventory->entries [i].record;
+		if (record->pending)
+		{
+			stats->num_stale++;
+		}
+		else if (record->have & CONMON_INVENTORY_VERSIONS)
+		{
+			stats->num_current++;
+		}
+	}
+	stats->num_scheduled = inventory->heap_len;
+	stats->num_queries = inventory->num_queries;
+	stats->num_updates = inventory->num_updates;
+	stats->num_changes = inventory->num_changes;
+}
+
+
+//----------
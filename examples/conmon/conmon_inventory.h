@@ -0,0 +1,352 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Indexed table of device versions, models and capabilities
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_INVENTORY_H
+#define _CONMON_INVENTORY_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_aud_decode_msg.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The inventory holds one record per device, keyed on the instance id of
+	its status messages and filled in from decoded versions and manufacturer
+	versions status messages. A device that is renamed keeps its record. Records are kept in
+	two indexes sorted by firmware and software version, so a version range
+	query is a binary search followed by a walk over the matching records.
+
+	A record is stale until the messages it needs have arrived: versions
+	always, and manufacturer versions too if the device reports the
+	HAS_MANF_VERSIONS capability. Stale records are handed out by
+	conmon_inventory_next_refresh so the caller can query the device, and
+	retried every retry_ms until max_attempts queries have gone unanswered.
+	Devices that send status unprompted are updated in place and never need
+	a query, so a refresh costs one query per device that actually changed.
+
+	A device named up front, before anything has been heard from it, gets a
+	record from conmon_inventory_expect; the first status from a device of
+	that name, compared case-insensitively, fills in its instance id.
+	Strings are copied into the record, truncated to
+	CONMON_INVENTORY_MAX_STRING - 1 characters.
+
+	Times are supplied by the caller in milliseconds from any monotonic
+	clock.
+ */
+
+enum
+{
+	CONMON_INVENTORY_MAX_STRING = 64
+};
+
+typedef struct conmon_inventory conmon_inventory_t;
+
+// What a record has received (have) and what it is still waiting for (pending)
+enum
+{
+	CONMON_INVENTORY_VERSIONS = 0x1,
+	CONMON_INVENTORY_MANF_VERSIONS = 0x2
+};
+
+// What changed in a record, as passed to the event function
+enum
+{
+	CONMON_INVENTORY_CHANGE_NEW = 0x1,
+		// the first versions for this device
+	CONMON_INVENTORY_CHANGE_SOFTWARE = 0x2,
+	CONMON_INVENTORY_CHANGE_FIRMWARE = 0x4,
+	CONMON_INVENTORY_CHANGE_CAPABILITIES = 0x8,
+	CONMON_INVENTORY_CHANGE_MODEL = 0x10,
+	CONMON_INVENTORY_CHANGE_MANUFACTURER = 0x20
+		// anything from manufacturer versions
+};
+
+typedef struct conmon_inventory_config
+{
+	unsigned int max_devices;
+	unsigned int retry_ms;
+		// wait this long for an answer before querying again
+	unsigned int max_attempts;
+		// queries per refresh before the record is left stale
+} conmon_inventory_config_t;
+
+typedef struct conmon_inventory_record
+{
+	conmon_name_t device_name;
+		// the name the device last sent status under
+	conmon_instance_id_t instance_id;
+	aud_bool_t have_instance_id;
+		// false for an expected device until its first status
+	unsigned int have;
+	unsigned int pending;
+		// non-zero while the record is stale
+
+	// from versions status
+	dante_version_t software_version;
+	dante_version_build_t software_build;
+	dante_version_t firmware_version;
+	dante_version_build_t firmware_build;
+	uint32_t dante_api_version;
+	uint32_t uboot_version;
+	unsigned int upgrade_version;
+	uint32_t capability_flags;
+	uint32_t inferred_capability_flags;
+	uint32_t readonly_capability_flags;
+	conmon_audinate_model_id_t model_id;
+	char model_name [CONMON_INVENTORY_MAX_STRING];
+
+	// from manufacturer versions status
+	conmon_vendor_id_t manufacturer;
+	char manufacturer_name [CONMON_INVENTORY_MAX_STRING];
+	conmon_audinate_model_id_t manf_model_id;
+	char manf_model_name [CONMON_INVENTORY_MAX_STRING];
+	uint32_t manf_model_version;
+	char manf_model_version_string [CONMON_INVENTORY_MAX_STRING];
+	conmon_device_id_t serial_id;
+	dante_version_t manf_software_version;
+	dante_version_build_t manf_software_build;
+	dante_version_t manf_firmware_version;
+	dante_version_build_t manf_firmware_build;
+	uint32_t manf_capabilities;
+
+	unsigned int attempts;
+		// queries sent for the current refresh
+	unsigned long num_updates;
+	unsigned long num_changes;
+	uint64_t updated_ms;
+	uint64_t changed_ms;
+} conmon_inventory_record_t;
+
+// Called whenever a message changes a record
+typedef void
+conmon_inventory_event_fn
+(
+	void * context,
+	const conmon_inventory_record_t * record,
+	unsigned int changes
+);
+
+// Criteria for conmon_inventory_query
+enum
+{
+	CONMON_INVENTORY_FILTER_FIRMWARE_AT_LEAST = 0x1,
+	CONMON_INVENTORY_FILTER_FIRMWARE_BELOW = 0x2,
+	CONMON_INVENTORY_FILTER_SOFTWARE_AT_LEAST = 0x4,
+	CONMON_INVENTORY_FILTER_SOFTWARE_BELOW = 0x8,
+	CONMON_INVENTORY_FILTER_CAPABILITIES = 0x10,
+	CONMON_INVENTORY_FILTER_MODEL_NAME = 0x20,
+	CONMON_INVENTORY_FILTER_STALE = 0x40
+		// only records still waiting for a refresh
+};
+
+/*
+	Versions compare by major, minor, bugfix and then build number, so
+	"below 4.2.1" with a zero build matches every 4.2.0 build but no 4.2.1
+	build.
+ */
+typedef struct conmon_inventory_filter
+{
+	unsigned int criteria;
+	dante_version_t firmware_at_least;
+	dante_version_build_t firmware_at_least_build;
+	dante_version_t firmware_below;
+	dante_version_build_t firmware_below_build;
+	dante_version_t software_at_least;
+	dante_version_build_t software_at_least_build;
+	dante_version_t software_below;
+	dante_version_build_t software_below_build;
+	uint32_t capabilities_set;
+		// every one of these capability flags must be set
+	uint32_t capabilities_clear;
+		// and every one of these clear
+	const char * model_name;
+		// matched case-insensitively against the versions model name
+} conmon_inventory_filter_t;
+
+typedef struct conmon_inventory_stats
+{
+	unsigned int num_devices;
+	unsigned int num_current;
+	unsigned int num_stale;
+	unsigned int num_scheduled;
+		// stale records that will still be handed out for a query
+	unsigned long num_queries;
+	unsigned long num_updates;
+	unsigned long num_changes;
+} conmon_inventory_stats_t;
+
+
+//----------
+// Functions
+
+// Fill in defaults: 4096 devices, retry after 10 s, 3 attempts
+void
+conmon_inventory_config_init
+(
+	conmon_inventory_config_t * config
+);
+
+aud_error_t
+conmon_inventory_new
+(
+	const conmon_inventory_config_t * config,
+	conmon_inventory_event_fn * event_fn,
+	void * event_context,
+	conmon_inventory_t ** inventory_ptr
+);
+
+void
+conmon_inventory_delete
+(
+	conmon_inventory_t * inventory
+);
+
+/*
+	Note that a device exists, from a status message. A device not seen
+	before gets a stale record that is due for a refresh straight away;
+	known devices are left alone apart from taking on a new name.
+
+	@return AUD_ERR_NOBUFS if the device is new and max_devices are already held
+ */
+aud_error_t
+conmon_inventory_seen
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t now_ms
+);
+
+/*
+	Add a record for a device known only by name, due for a refresh
+	straight away. Does nothing if a record already has that name.
+
+	@return as conmon_inventory_seen
+ */
+aud_error_t
+conmon_inventory_expect
+(
+	conmon_inventory_t * inventory,
+	const char * device_name,
+	uint64_t now_ms
+);
+
+// Mark a device stale and due for a refresh straight away, adding it if needed
+aud_error_t
+conmon_inventory_invalidate
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t now_ms
+);
+
+aud_error_t
+conmon_inventory_update_versions
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	const conmon_aud_decoded_versions_status_t * versions,
+	uint64_t now_ms
+);
+
+aud_error_t
+conmon_inventory_update_manf_versions
+(
+	conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	const conmon_aud_decoded_manf_versions_status_t * manf_versions,
+	uint64_t now_ms
+);
+
+/*
+	Hand out the next stale record that is due for a query, and count the
+	attempt. queries is set to the CONMON_INVENTORY_VERSIONS and
+	CONMON_INVENTORY_MANF_VERSIONS bits the device should be asked for.
+
+	@return false if nothing is due
+ */
+aud_bool_t
+conmon_inventory_next_refresh
+(
+	conmon_inventory_t * inventory,
+	uint64_t now_ms,
+	unsigned int * record_index,
+	unsigned int * queries
+);
+
+// Milliseconds until the next refresh is due, or UINT_MAX if none are scheduled
+unsigned int
+conmon_inventory_ms_to_next_refresh
+(
+	const conmon_inventory_t * inventory,
+	uint64_t now_ms
+);
+
+// @return NULL if no status from the device has reached the inventory
+const conmon_inventory_record_t *
+conmon_inventory_find
+(
+	const conmon_inventory_t * inventory,
+	const conmon_instance_id_t * instance_id
+);
+
+// Records are never removed, so index runs from 0 to num_devices - 1 in order of arrival
+const conmon_inventory_record_t *
+conmon_inventory_record_at_index
+(
+	const conmon_inventory_t * inventory,
+	unsigned int index
+);
+
+// Clear every criterion, so the filter matches all records
+void
+conmon_inventory_filter_init
+(
+	conmon_inventory_filter_t * filter
+);
+
+/*
+	Find the records matching a filter. Up to max_indices record indexes are
+	written to indices, in firmware order if the filter has a firmware
+	criterion, in software order if it has a software criterion, and in
+	order of arrival otherwise. Records without versions only match filters
+	with no version criteria.
+
+	@return the total number of matching records, which may exceed max_indices
+ */
+unsigned int
+conmon_inventory_query
+(
+	const conmon_inventory_t * inventory,
+	const conmon_inventory_filter_t * filter,
+	unsigned int * indices,
+	unsigned int max_indices
+);
+
+void
+conmon_inventory_get_stats
+(
+	const conmon_inventory_t * inventory,
+	conmon_inventory_stats_t * stats
+);
+
+
+//----------
+
+#endif // _CONMON_INVENTORY_H
@@ -0,0 +1,453 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Track device liveness from conmon keepalive messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_liveness.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+#define LIVENESS_NO_ENTRY 0xFFFFFFFFu
+
+typedef struct liveness_entry
+{
+	conmon_liveness_device_t device;
+		// must be first, handed out as the public view of the entry
+	uint64_t deadline_tick;
+	uint32_t next;
+	uint32_t prev;
+	aud_bool_t in_wheel;
+} liveness_entry_t;
+
+/*
+	Entries are stored densely in order of first keepalive and found through
+	an id set. Nothing is ever removed, so the set's index for an instance
+	id is also its index in entries. The wheel has more slots than the
+	longest deadline is ticks away, so each slot list only holds entries
+	that are due on one tick; the deadline is still checked when a slot is
+	walked so that a late call to advance cannot expire anything early.
+ */
+struct conmon_liveness
+{
+	conmon_liveness_config_t config;
+	conmon_liveness_event_fn * event_fn;
+	void * event_context;
+
+	liveness_entry_t * entries;
+	unsigned int num_entries;
+	dapi_id_map_t * index;
+
+	uint32_t * wheel;
+	uint32_t wheel_mask;
+	uint64_t current_tick;
+	aud_bool_t started;
+
+	unsigned int num_in_state [CONMON_LIVENESS_STATE_DOWN + 1];
+	unsigned long num_keepalives;
+	unsigned long num_events;
+};
+
+
+//----------
+// Local functions
+
+// The first tick at or after threshold_ms past from_ms
+AUD_INLINE uint64_t
+deadline_tick (const conmon_liveness_t * liveness, uint64_t from_ms, unsigned int threshold_ms)
+{
+	const unsigned int tick_ms = liveness->config.tick_ms;
+	return (from_ms + threshold_ms + tick_ms - 1) / tick_ms;
+}
+
+
+static void
+wheel_link (conmon_liveness_t * liveness, uint32_t i)
+{
+	liveness_entry_t * entry = liveness->entries + i;
+	uint32_t * head = liveness->wheel + (entry->deadline_tick & liveness->wheel_mask);
+
+	entry->prev = LIVENESS_NO_ENTRY;
+	entry->next = * head;
+	if (* head != LIVENESS_NO_ENTRY)
+	{
+		liveness->entries [* head].prev = i;
+	}
+	* head = i;
+	entry->in_wheel = AUD_TRUE;
+}
+
+
+static void
+wheel_unlink (conmon_liveness_t * liveness, uint32_t i)
+{
+	liveness_entry_t * entry = liveness->entries + i;
+
+	if (entry->prev != LIVENESS_NO_ENTRY)
+	{
+		liveness->entries [entry->prev].next = entry->next;
+	}
+	else
+	{
+		liveness->wheel [entry->deadline_tick & liveness->wheel_mask] = entry->next;
+	}
+	if (entry->next != LIVENESS_NO_ENTRY)
+	{
+		liveness->entries [entry->next].prev = entry->prev;
+	}
+	entry->in_wheel = AUD_FALSE;
+}
+
+
+static void
+set_state
+(
+	conmon_liveness_t * liveness,
+	liveness_entry_t * entry,
+	conmon_liveness_state_t state,
+	uint64_t since_ms
+)
+{
+	liveness->num_in_state [entry->device.state]--;
+	liveness->num_in_state [state]++;
+	entry->device.state = state;
+	entry->device.state_since_ms = since_ms;
+	if (state == CONMON_LIVENESS_STATE_DOWN)
+	{
+		entry->device.num_downs++;
+	}
+
+	liveness->num_events++;
+	if (liveness->event_fn)
+	{
+		liveness->event_fn (liveness->event_context, & entry->device);
+	}
+}
+
+
+// Apply every deadline that has passed by now_tick to an entry that is out of the wheel
+static void
+expire_entry (conmon_liveness_t * liveness, uint32_t i, uint64_t now_tick)
+{
+	liveness_entry_t * entry = liveness->entries + i;
+	const conmon_liveness_config_t * config = & liveness->config;
+	const uint64_t last_seen_ms = entry->device.last_seen_ms;
+
+	if (entry->device.state == CONMON_LIVENESS_STATE_UP && config->late_ms)
+	{
+		set_state (liveness, entry, CONMON_LIVENESS_STATE_LATE, last_seen_ms + config->late_ms);
+
+		entry->deadline_tick = deadline_tick (liveness, last_seen_ms, config->down_ms);
+		if (entry->deadline_tick > now_tick)
+		{
+			wheel_link (liveness, i);
+			return;
+		}
+	}
+	set_state (liveness, entry, CONMON_LIVENESS_STATE_DOWN, last_seen_ms + config->down_ms);
+}
+
+
+static uint32_t
+find_or_add_entry (conmon_liveness_t * liveness, const conmon_instance_id_t * instance_id, aud_bool_t * added)
+{
+	unsigned int i;
+	liveness_entry_t * entry;
+
+	if (dapi_id_map_insert (liveness->index, instance_id, & i, added) != AUD_SUCCESS)
+	{
+		return LIVENESS_NO_ENTRY;
+	}
+	if (! * added)
+	{
+		return i;
+	}
+
+	liveness->num_entries++;
+	entry = liveness->entries + i;
+	memset (entry, 0, sizeof (* entry));
+	entry->device.instance_id = * instance_id;
+	entry->device.state = CONMON_LIVENESS_STATE_DOWN;
+	liveness->num_in_state [CONMON_LIVENESS_STATE_DOWN]++;
+		// a new entry starts DOWN so that its first keepalive reports UP
+	* added = AUD_TRUE;
+	return i;
+}
+
+
+//----------
+// Functions
+
+void
+conmon_liveness_config_init
+(
+	conmon_liveness_config_t * config
+)
+{
+	if (config)
+	{
+		config->tick_ms = 100;
+		config->late_ms = 3000;
+		config->down_ms = 6000;
+		config->max_devices = 1024;
+	}
+}
+
+
+aud_error_t
+conmon_liveness_new
+(
+	const conmon_liveness_config_t * config,
+	conmon_liveness_event_fn * event_fn,
+	void * event_context,
+	conmon_liveness_t ** liveness_ptr
+)
+{
+	conmon_liveness_t * liveness;
+	uint64_t max_ticks;
+	uint32_t wheel_size = 1;
+
+	if (! (config && liveness_ptr)
+		|| ! config->tick_ms || ! config->max_devices || config->max_devices > 0x1000000
+		|| config->down_ms < config->tick_ms
+		|| (config->late_ms && (config->late_ms < config->tick_ms || config->late_ms >= config->down_ms)))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	// a deadline is at most this many ticks past the current tick
+	max_ticks = (uint64_t) config->down_ms / config->tick_ms + 2;
+	if (max_ticks > 0x100000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (wheel_size <= max_ticks)
+	{
+		wheel_size <<= 1;
+	}
+
+	liveness = calloc (1, sizeof (* liveness));
+	if (! liveness)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	liveness->entries = malloc (config->max_devices * sizeof (* liveness->entries));
+	liveness->wheel = malloc (wheel_size * sizeof (uint32_t));
+	if (! (liveness->entries && liveness->wheel)
+		|| dapi_id_map_new (config->max_devices, 0, & liveness->index) != AUD_SUCCESS)
+	{
+		conmon_liveness_delete (liveness);
+		return AUD_ERR_NOMEMORY;
+	}
+	// 0xFF bytes give LIVENESS_NO_ENTRY in every slot
+	memset (liveness->wheel, 0xFF, wheel_size * sizeof (uint32_t));
+
+	liveness->config = * config;
+	liveness->event_fn = event_fn;
+	liveness->event_context = event_context;
+	liveness->wheel_mask = wheel_size - 1;
+
+	* liveness_ptr = liveness;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_liveness_delete
+(
+	conmon_liveness_t * liveness
+)
+{
+	if (liveness)
+	{
+		free (liveness->wheel);
+		dapi_id_map_delete (liveness->index);
+		free (liveness->entries);
+		free (liveness);
+	}
+}
+
+
+aud_error_t
+conmon_liveness_keepalive
+(
+	conmon_liveness_t * liveness,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms
+)
+{
+	const conmon_liveness_config_t * config;
+	liveness_entry_t * entry;
+	aud_bool_t added;
+	uint32_t i;
+
+	if (! (liveness && instance_id))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	config = & liveness->config;
+
+	if (! liveness->started)
+	{
+		liveness->current_tick = now_ms / config->tick_ms;
+		liveness->started = AUD_TRUE;
+	}
+
+	i = find_or_add_entry (liveness, instance_id, & added);
+	if (i == LIVENESS_NO_ENTRY)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	entry = liveness->entries + i;
+
+	if (entry->in_wheel)
+	{
+		wheel_unlink (liveness, i);
+	}
+	entry->device.last_seen_ms = now_ms;
+	entry->device.num_keepalives++;
+	liveness->num_keepalives++;
+
+	if (entry->device.state != CONMON_LIVENESS_STATE_UP)
+	{
+		set_state (liveness, entry, CONMON_LIVENESS_STATE_UP, now_ms);
+	}
+
+	entry->deadline_tick =
+		deadline_tick (liveness, now_ms, config->late_ms ? config->late_ms : config->down_ms);
+	wheel_link (liveness, i);
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_liveness_advance
+(
+	conmon_liveness_t * liveness,
+	uint64_t now_ms
+)
+{
+	uint64_t now_tick, tick, num_steps;
+
+	if (! liveness)
+	{
+		return;
+	}
+
+	now_tick = now_ms / liveness->config.tick_ms;
+	if (! liveness->started)
+	{
+		liveness->current_tick = now_tick;
+		liveness->started = AUD_TRUE;
+		return;
+	}
+	if (now_tick <= liveness->current_tick)
+	{
+		return;
+	}
+
+	// after a long stall, one turn of the wheel visits every entry
+	num_steps = now_tick - liveness->current_tick;
+	if (num_steps > liveness->wheel_mask + 1)
+	{
+		num_steps = liveness->wheel_mask + 1;
+	}
+
+	for (tick = liveness->current_tick + 1; num_steps; tick++, num_steps--)
+	{
+		uint32_t i = liveness->wheel [tick & liveness->wheel_mask];
+		while (i != LIVENESS_NO_ENTRY)
+		{
+			liveness_entry_t * entry = liveness->entries + i;
+			const uint32_t next = entry->next;
+
+			if (entry->deadline_tick <= now_tick)
+			{
+				wheel_unlink (liveness, i);
+				expire_entry (liveness, i, now_tick);
+			}
+			i = next;
+		}
+	}
+	liveness->current_tick = now_tick;
+}
+
+
+unsigned int
+conmon_liveness_ms_to_next_tick
+(
+	const conmon_liveness_t * liveness,
+	uint64_t now_ms
+)
+{
+	const unsigned int tick_ms = liveness->config.tick_ms;
+	return (unsigned int) (tick_ms - now_ms % tick_ms);
+}
+
+
+const conmon_liveness_device_t *
+conmon_liveness_device_at_index
+(
+	const conmon_liveness_t * liveness,
+	unsigned int index
+)
+{
+	if (! liveness || index >= liveness->num_entries)
+	{
+		return NULL;
+	}
+	return & liveness->entries [index].device;
+}
+
+
+void
+conmon_liveness_get_stats
+(
+	const conmon_liveness_t * liveness,
+	conmon_liveness_stats_t * stats
+)
+{
+	if (! (liveness && stats))
+	{
+		return;
+	}
+
+	stats->num_devices = liveness->num_entries;
+	stats->num_up = liveness->num_in_state [CONMON_LIVENESS_STATE_UP];
+	stats->num_late = liveness->num_in_state [CONMON_LIVENESS_STATE_LATE];
+	stats->num_down = liveness->num_in_state [CONMON_LIVENESS_STATE_DOWN];
+	stats->num_keepalives = liveness->num_keepalives;
+	stats->num_events = liveness->num_events;
+}
+
+
+const char *
+conmon_liveness_state_to_string
+(
+	conmon_liveness_state_t state
+)
+{
+	switch (state)
+	{
+	case CONMON_LIVENESS_STATE_UP:   return "UP";
+	case CONMON_LIVENESS_STATE_LATE: return "LATE";
+	case CONMON_LIVENESS_STATE_DOWN: return "DOWN";
+	default:                         return "???";
+	}
+}
+
+
+//----------
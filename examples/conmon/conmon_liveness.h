@@ -0,0 +1,168 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Track device liveness from conmon keepalive messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_LIVENESS_H
+#define _CONMON_LIVENESS_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The tracker keeps one entry per instance id that has sent a keepalive.
+	Each live entry sits in a timer wheel slot for its next deadline, so a
+	keepalive is a hash lookup plus moving the entry between two slots, and
+	advancing time only visits the slots that have come due.
+
+	A device that has been silent for late_ms is reported LATE, and after
+	down_ms it is reported DOWN and leaves the wheel. The next keepalive
+	from a LATE or DOWN device reports it UP again, as does the first
+	keepalive from a new device. Deadlines are rounded up to whole ticks,
+	so events are raised up to tick_ms after the threshold passes.
+
+	Times are supplied by the caller in milliseconds from any monotonic
+	clock.
+ */
+
+typedef struct conmon_liveness conmon_liveness_t;
+
+typedef enum conmon_liveness_state
+{
+	CONMON_LIVENESS_STATE_UP = 0,
+	CONMON_LIVENESS_STATE_LATE,
+	CONMON_LIVENESS_STATE_DOWN
+} conmon_liveness_state_t;
+
+typedef struct conmon_liveness_config
+{
+	unsigned int tick_ms;
+		// timer wheel resolution
+	unsigned int late_ms;
+		// 0 to go straight from UP to DOWN
+	unsigned int down_ms;
+	unsigned int max_devices;
+} conmon_liveness_config_t;
+
+typedef struct conmon_liveness_device
+{
+	conmon_instance_id_t instance_id;
+	conmon_liveness_state_t state;
+	uint64_t last_seen_ms;
+	uint64_t state_since_ms;
+		// when the current state was entered
+	unsigned long num_keepalives;
+	unsigned long num_downs;
+} conmon_liveness_device_t;
+
+// Called whenever a device changes state, including its first UP
+typedef void
+conmon_liveness_event_fn
+(
+	void * context,
+	const conmon_liveness_device_t * device
+);
+
+typedef struct conmon_liveness_stats
+{
+	unsigned int num_devices;
+	unsigned int num_up;
+	unsigned int num_late;
+	unsigned int num_down;
+	unsigned long num_keepalives;
+	unsigned long num_events;
+} conmon_liveness_stats_t;
+
+
+//----------
+// Functions
+
+// Fill in default thresholds: 100 ms ticks, late after 3 s, down after 6 s
+void
+conmon_liveness_config_init
+(
+	conmon_liveness_config_t * config
+);
+
+// @return AUD_ERR_INVALIDPARAMETER unless tick_ms <= late_ms < down_ms (or late_ms is 0)
+aud_error_t
+conmon_liveness_new
+(
+	const conmon_liveness_config_t * config,
+	conmon_liveness_event_fn * event_fn,
+	void * event_context,
+	conmon_liveness_t ** liveness_ptr
+);
+
+void
+conmon_liveness_delete
+(
+	conmon_liveness_t * liveness
+);
+
+/*
+	Record a keepalive from a device.
+
+	@return AUD_ERR_NOBUFS if this is a new device and max_devices are already tracked
+ */
+aud_error_t
+conmon_liveness_keepalive
+(
+	conmon_liveness_t * liveness,
+	const conmon_instance_id_t * instance_id,
+	uint64_t now_ms
+);
+
+// Raise the LATE and DOWN events that are due by now_ms
+void
+conmon_liveness_advance
+(
+	conmon_liveness_t * liveness,
+	uint64_t now_ms
+);
+
+// Milliseconds until the next tick, for use as a poll timeout
+unsigned int
+conmon_liveness_ms_to_next_tick
+(
+	const conmon_liveness_t * liveness,
+	uint64_t now_ms
+);
+
+// Devices are never removed, so index runs from 0 to num_devices - 1 in order of first keepalive
+const conmon_liveness_device_t *
+conmon_liveness_device_at_index
+(
+	const conmon_liveness_t * liveness,
+	unsigned int index
+);
+
+void
+conmon_liveness_get_stats
+(
+	const conmon_liveness_t * liveness,
+	conmon_liveness_stats_t * stats
+);
+
+const char *
+conmon_liveness_state_to_string
+(
+	conmon_liveness_state_t state
+);
+
+
+//----------
+
+#endif // _CONMON_LIVENESS_H
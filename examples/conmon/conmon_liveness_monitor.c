@@ -0,0 +1,455 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Report devices going up and down from conmon keepalive messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_liveness.h"
+#include "conmon_name_cache.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	LIVENESS_NAME_CACHE_SIZE = 2048
+};
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static conmon_liveness_t * g_liveness = NULL;
+static conmon_name_cache_t * g_names = NULL;
+static aud_bool_t g_full_reported = AUD_FALSE;
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_ms (void)
+{
+	return conmon_example_clock_ns () / 1000000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+static const char *
+device_name (const conmon_instance_id_t * instance_id)
+{
+	const char * name = conmon_name_cache_lookup (g_names, instance_id)->device_name;
+	return name ? name : "[unknown device]";
+}
+
+
+static void
+handle_liveness_event
+(
+	void * context,
+	const conmon_liveness_device_t * device
+)
+{
+	aud_ctime_buf_t time_buf;
+	char id_buf [64];
+
+	AUD_UNUSED (context);
+
+	printf ("#EVENT %s: '%s' (%s) is %s"
+		, aud_utime_ctime_no_newline (NULL, time_buf)
+		, device_name (& device->instance_id)
+		, conmon_example_instance_id_to_string (& device->instance_id, id_buf, sizeof (id_buf))
+		, conmon_liveness_state_to_string (device->state)
+	);
+	if (device->state == CONMON_LIVENESS_STATE_UP)
+	{
+		putchar ('\n');
+	}
+	else
+	{
+		printf (", no keepalive for %u ms\n"
+			, (unsigned int) (now_ms () - device->last_seen_ms)
+		);
+	}
+	fflush (stdout);
+}
+
+
+static void
+print_devices (void)
+{
+	const uint64_t now = now_ms ();
+	const conmon_liveness_device_t * device;
+	conmon_liveness_stats_t stats;
+	unsigned int i;
+
+	conmon_liveness_get_stats (g_liveness, & stats);
+	printf ("%u devices: %u up, %u late, %u down; %lu keepalives, %lu events\n"
+		, stats.num_devices, stats.num_up, stats.num_late, stats.num_down
+		, stats.num_keepalives, stats.num_events
+	);
+	for (i = 0; (device = conmon_liveness_device_at_index (g_liveness, i)) != NULL; i++)
+	{
+		char id_buf [64];
+
+		printf ("  %-32s %s %-4s for %u s, last seen %u ms ago, %lu keepalives, down %lu times\n"
+			, device_name (& device->instance_id)
+			, conmon_example_instance_id_to_string (& device->instance_id, id_buf, sizeof (id_buf))
+			, conmon_liveness_state_to_string (device->state)
+			, (unsigned int) ((now - device->state_since_ms) / 1000)
+			, (unsigned int) (now - device->last_seen_ms)
+			, device->num_keepalives
+			, device->num_downs
+		);
+	}
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_keepalive_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	conmon_instance_id_t instance_id;
+	aud_error_t result;
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+	AUD_UNUSED (body);
+
+	conmon_message_head_get_instance_id (head, & instance_id);
+	result = conmon_liveness_keepalive (g_liveness, & instance_id, now_ms ());
+	if (result == AUD_ERR_NOBUFS && ! g_full_reported)
+	{
+		fprintf (stderr, "Device table is full, new devices will not be tracked (see -max)\n");
+		g_full_reported = AUD_TRUE;
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (num_changes);
+	AUD_UNUSED (changes);
+
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Main
+
+static void
+usage (const char * bin)
+{
+	conmon_liveness_config_t defaults;
+
+	conmon_liveness_config_init (& defaults);
+	printf ("Usage: %s [-p=PORT] [-tick=MS] [-late=MS] [-down=MS] [-max=N]\n", bin);
+	printf ("  Report devices going up and down, based on keepalives from all devices\n");
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -tick=MS: check for silent devices every MS milliseconds (default %u)\n", defaults.tick_ms);
+	printf ("  -late=MS: report a device LATE after MS milliseconds without a keepalive,\n"
+		"      0 to skip this stage (default %u)\n", defaults.late_ms);
+	printf ("  -down=MS: report a device DOWN after MS milliseconds without a keepalive (default %u)\n",
+		defaults.down_ms);
+	printf ("  -max=N: track at most N devices (default %u)\n", defaults.max_devices);
+	printf ("  Ctrl-C prints a summary of all devices and exits\n");
+}
+
+
+int
+main (int argc, char * argv[])
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	conmon_liveness_config_t liveness_config;
+	dante_sockets_t sockets;
+	uint16_t server_port = 0;
+	int a;
+
+	conmon_liveness_config_init (& liveness_config);
+
+	for (a = 1; a < argc; a++)
+	{
+		const char * arg = argv[a];
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if (!strncmp (arg, "-tick=", 6) && strlen (arg) > 6)
+		{
+			liveness_config.tick_ms = (unsigned int) atoi (arg + 6);
+		}
+		else if (!strncmp (arg, "-late=", 6) && strlen (arg) > 6)
+		{
+			liveness_config.late_ms = (unsigned int) atoi (arg + 6);
+		}
+		else if (!strncmp (arg, "-down=", 6) && strlen (arg) > 6)
+		{
+			liveness_config.down_ms = (unsigned int) atoi (arg + 6);
+		}
+		else if (!strncmp (arg, "-max=", 5) && strlen (arg) > 5)
+		{
+			liveness_config.max_devices = (unsigned int) atoi (arg + 5);
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+
+	result = conmon_liveness_new (& liveness_config, & handle_liveness_event, NULL, & g_liveness);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Invalid thresholds: need tick <= late < down (or late = 0): %s\n",
+			aud_error_message (result, errbuf));
+		usage (argv[0]);
+		exit (1);
+	}
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	config = conmon_client_config_new ("liveness_monitor");
+	if (!config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (config, server_port);
+	}
+	result = conmon_client_new_config (env, config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, LIVENESS_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device name cache: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_KEEPALIVE, CONMON_CHANNEL_DIRECTION_RX,
+			handle_keepalive_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for keepalive messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_subscribe_global (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_KEEPALIVE
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error subscribing to keepalives from all devices: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	printf ("Tracking keepalives: late after %u ms, down after %u ms, %u ms ticks\n"
+		, liveness_config.late_ms, liveness_config.down_ms, liveness_config.tick_ms
+	);
+
+	// The loop runs until the user hits CTRL-C, waking at least once a tick
+	// so that silent devices are reported on time
+	signal (SIGINT, sig_handler);
+	while (g_running)
+	{
+		aud_utime_t timeout;
+		unsigned int ms;
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& sockets);
+			conmon_client_get_sockets (client, & sockets);
+		}
+
+		ms = conmon_liveness_ms_to_next_tick (g_liveness, now_ms ());
+		timeout.tv_sec = ms / 1000;
+		timeout.tv_usec = (ms % 1000) * 1000;
+		conmon_example_client_process (client, & sockets, & timeout, NULL);
+
+		conmon_liveness_advance (g_liveness, now_ms ());
+	}
+
+	print_devices ();
+	result = AUD_SUCCESS;
+
+cleanup:
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (config)
+	{
+		conmon_client_config_delete (config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	conmon_liveness_delete (g_liveness);
+	return (result == AUD_SUCCESS) ? 0 : 1;
+}
+
+
+//----------
@@ -10,6 +10,7 @@
  * Audinate Copyright Header Version 1
  */
 #include "conmon_examples.h"
+#include "conmon_name_cache.h"
 
 //----------------------------------------------------------
 // Signal handler to allow exit using CTRL-C
@@ -94,6 +95,9 @@ wait_for_response
 
 
 static aud_bool_t g_print_raw_bytes = AUD_FALSE;
+
+// Metering arrives many times a second per device, so don't resolve names per packet
+static conmon_name_cache_t * g_names = NULL;
 /**
  * Handle an incoming metering message. This function simply
  * checks that the message is valid (ie. it has the right vendor ID)
@@ -129,7 +133,7 @@ handle_metering_message
 	}
 	
 	conmon_message_head_get_instance_id(head, &instance_id);
-	name = conmon_client_device_name_for_instance_id(client, &instance_id);
+	name = conmon_name_cache_lookup(g_names, &instance_id)->device_name;
 
 
 	result = conmon_metering_message_parse(body, &version, &num_txchannels, &num_rxchannels);
@@ -182,6 +186,7 @@ aud_bool_t g_sockets_changed = AUD_FALSE;
 conmon_client_sockets_changed_fn handle_sockets_changed;
 conmon_client_handle_networks_changed_fn handle_networks_changed;
 conmon_client_handle_subscriptions_changed_fn handle_subscriptions_changed;
+conmon_client_handle_dante_device_name_changed_fn handle_dante_device_name_changed;
 
 void
 handle_sockets_changed
@@ -235,6 +240,9 @@ handle_subscriptions_changed
 ) {
 	char buf[1024];
 	unsigned int i;
+
+	conmon_name_cache_invalidate(g_names);
+
 	printf("SUBSCRIPTION CHANGES:\n");
 	for (i = 0; i < num_changes; i++)
 	{
@@ -243,6 +251,15 @@ handle_subscriptions_changed
 	}
 }
 
+void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+) {
+	conmon_name_cache_invalidate(g_names);
+	printf("DANTE DEVICE NAME CHANGED: %s\n", conmon_client_get_dante_device_name(client));
+}
+
 static void
 usage(const char * bin)
 {
@@ -336,6 +353,13 @@ int main(int argc, char * argv[])
 		goto cleanup;
 	}
 
+	result = conmon_name_cache_new(client, 256, NULL, NULL, &g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf("Error creating device name cache: %s\n", aud_error_message(result, errbuf));
+		goto cleanup;
+	}
+
 	if (!conmon_client_is_metering_channel_active(client))
 	{
 		printf("Metering channel configuration failed\n");
@@ -344,6 +368,7 @@ int main(int argc, char * argv[])
 	// set before connecting to avoid possible race conditions / missed notifications
 	conmon_client_set_networks_changed_callback(client, handle_networks_changed);
 	conmon_client_set_subscriptions_changed_callback(client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback(client, handle_dante_device_name_changed);
 
 	result = conmon_client_connect (client, &handle_response, &req_id);
 	if (result == AUD_SUCCESS)
@@ -462,6 +487,10 @@ int main(int argc, char * argv[])
 
 cleanup:
 	// Now cleanup the metering channel and the client and shutdown
+	if (g_names)
+	{
+		conmon_name_cache_delete(g_names);
+	}
 	if (client)
 	{
 		conmon_client_delete(client);
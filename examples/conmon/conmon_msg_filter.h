@@ -0,0 +1,79 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Message type filtering shared by the conmon listener tools
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_MSG_FILTER_H
+#define _CONMON_MSG_FILTER_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	FILTER_MAX_FILTERS = 16
+};
+
+typedef enum message_filter_mode
+{
+	MESSAGE_FILTER_MODE_PASS = 0,
+		// Only messages matching a filter are accepted
+	MESSAGE_FILTER_MODE_FAIL
+		// Messages matching a filter are rejected
+} message_filter_mode_t;
+
+struct message_filter
+{
+	conmon_audinate_message_type_t mtype;
+};
+
+
+//----------
+// Functions
+
+/*
+	Apply a set of message type filters to an audinate message type.
+
+	An empty filter set accepts everything.
+ */
+AUD_INLINE aud_bool_t
+conmon_msg_filter_accepts
+(
+	const struct message_filter * filters,
+	unsigned int n_filters,
+	message_filter_mode_t mode,
+	uint16_t aud_type
+)
+{
+	unsigned int i;
+
+	if (! n_filters)
+	{
+		return AUD_TRUE;
+	}
+	for (i = 0; i < n_filters; i++)
+	{
+		if (aud_type == filters[i].mtype)
+		{
+			return (mode == MESSAGE_FILTER_MODE_PASS);
+		}
+	}
+	return (mode != MESSAGE_FILTER_MODE_PASS);
+}
+
+
+//----------
+
+#endif // _CONMON_MSG_FILTER_H
@@ -0,0 +1,266 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Cache of device names and target matches by conmon instance id
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_name_cache.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+#define NAME_CACHE_NO_ENTRY 0xFFFFFFFFu
+
+typedef struct name_cache_name
+{
+	conmon_name_t name;
+	aud_bool_t matches;
+} name_cache_name_t;
+
+/*
+	Entries live in an id map keyed on instance id. Interned names are stored
+	densely and indexed by an open addressing table of at least twice their
+	capacity, so probes stay short. Entries point into the names array, which
+	is never reallocated, so a name is only written once however many
+	instance ids share it.
+ */
+struct conmon_name_cache
+{
+	conmon_client_t * client;
+	conmon_name_cache_match_fn * match_fn;
+	void * match_context;
+
+	unsigned int capacity;
+	uint32_t mask;
+
+	dapi_id_map_t * entries;
+
+	name_cache_name_t * names;
+	unsigned int num_names;
+	uint32_t * name_slots;
+
+	unsigned long num_hits;
+	unsigned long num_misses;
+	unsigned long num_invalidations;
+};
+
+
+//----------
+// Local functions
+
+static const name_cache_name_t *
+intern_name (conmon_name_cache_t * cache, const char * name)
+{
+	const size_t len = strlen (name);
+	uint32_t slot = dapi_fnv1a_bytes (DAPI_FNV1A_BASIS, name, len) & cache->mask;
+	uint32_t index;
+	name_cache_name_t * interned;
+
+	while ((index = cache->name_slots [slot]) != NAME_CACHE_NO_ENTRY)
+	{
+		if (! strcmp (cache->names [index].name, name))
+		{
+			return cache->names + index;
+		}
+		slot = (slot + 1) & cache->mask;
+	}
+
+	if (cache->num_names >= cache->capacity || len >= sizeof (interned->name))
+	{
+		return NULL;
+	}
+
+	index = cache->num_names++;
+	cache->name_slots [slot] = index;
+	interned = cache->names + index;
+	memcpy (interned->name, name, len + 1);
+	interned->matches =
+		cache->match_fn ? cache->match_fn (cache->match_context, interned->name) : AUD_FALSE;
+	return interned;
+}
+
+
+static void
+resolve_entry (conmon_name_cache_t * cache, conmon_name_cache_entry_t * entry)
+{
+	const char * name =
+		conmon_client_device_name_for_instance_id (cache->client, & entry->instance_id);
+	const name_cache_name_t * interned = name ? intern_name (cache, name) : NULL;
+
+	if (interned)
+	{
+		entry->device_name = interned->name;
+		entry->matches = interned->matches;
+		entry->retry = 0;
+	}
+	else
+	{
+		entry->device_name = NULL;
+		entry->matches = AUD_FALSE;
+		entry->retry = CONMON_NAME_CACHE_RETRY_INTERVAL;
+	}
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_name_cache_new
+(
+	conmon_client_t * client,
+	unsigned int capacity,
+	conmon_name_cache_match_fn * match_fn,
+	void * match_context,
+	conmon_name_cache_t ** cache_ptr
+)
+{
+	conmon_name_cache_t * cache;
+	uint32_t num_slots = 1;
+	aud_error_t result;
+
+	if (! (client && capacity && cache_ptr) || capacity > 0x1000000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (num_slots < 2 * capacity)
+	{
+		num_slots <<= 1;
+	}
+
+	cache = calloc (1, sizeof (* cache));
+	if (! cache)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	result = dapi_id_map_new (capacity, sizeof (conmon_name_cache_entry_t), & cache->entries);
+	if (result != AUD_SUCCESS)
+	{
+		conmon_name_cache_delete (cache);
+		return result;
+	}
+	cache->names = calloc (capacity, sizeof (* cache->names));
+	cache->name_slots = malloc (num_slots * sizeof (uint32_t));
+	if (! (cache->names && cache->name_slots))
+	{
+		conmon_name_cache_delete (cache);
+		return AUD_ERR_NOMEMORY;
+	}
+
+	cache->client = client;
+	cache->match_fn = match_fn;
+	cache->match_context = match_context;
+	cache->capacity = capacity;
+	cache->mask = num_slots - 1;
+	conmon_name_cache_invalidate (cache);
+	cache->num_invalidations = 0;
+
+	* cache_ptr = cache;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_name_cache_delete
+(
+	conmon_name_cache_t * cache
+)
+{
+	if (cache)
+	{
+		free (cache->name_slots);
+		free (cache->names);
+		dapi_id_map_delete (cache->entries);
+		free (cache);
+	}
+}
+
+
+void
+conmon_name_cache_invalidate
+(
+	conmon_name_cache_t * cache
+)
+{
+	if (! cache)
+	{
+		return;
+	}
+
+	dapi_id_map_clear (cache->entries);
+	// 0xFF bytes give NAME_CACHE_NO_ENTRY in every slot
+	memset (cache->name_slots, 0xFF, (cache->mask + 1) * sizeof (uint32_t));
+	cache->num_names = 0;
+	cache->num_invalidations++;
+}
+
+
+const conmon_name_cache_entry_t *
+conmon_name_cache_lookup
+(
+	conmon_name_cache_t * cache,
+	const conmon_instance_id_t * instance_id
+)
+{
+	unsigned int index;
+	aud_bool_t added;
+	conmon_name_cache_entry_t * entry;
+
+	if (dapi_id_map_insert (cache->entries, instance_id, & index, & added) != AUD_SUCCESS)
+	{
+		// full, so start again
+		conmon_name_cache_invalidate (cache);
+		dapi_id_map_insert (cache->entries, instance_id, & index, & added);
+	}
+	entry = dapi_id_map_value_at (cache->entries, index);
+
+	if (! added)
+	{
+		cache->num_hits++;
+		if (! entry->device_name && --entry->retry == 0)
+		{
+			resolve_entry (cache, entry);
+		}
+		return entry;
+	}
+
+	cache->num_misses++;
+	entry->instance_id = * instance_id;
+	resolve_entry (cache, entry);
+	return entry;
+}
+
+
+void
+conmon_name_cache_get_stats
+(
+	const conmon_name_cache_t * cache,
+	conmon_name_cache_stats_t * stats
+)
+{
+	if (! (cache && stats))
+	{
+		return;
+	}
+
+	stats->num_entries = dapi_id_map_size (cache->entries);
+	stats->num_names = cache->num_names;
+	stats->num_hits = cache->num_hits;
+	stats->num_misses = cache->num_misses;
+	stats->num_invalidations = cache->num_invalidations;
+}
+
+
+//----------
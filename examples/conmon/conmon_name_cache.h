@@ -0,0 +1,129 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Cache of device names and target matches by conmon instance id
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_NAME_CACHE_H
+#define _CONMON_NAME_CACHE_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The cache maps the instance id in a message head to the device name
+	conmon_client_device_name_for_instance_id returns for it. Each distinct
+	name is stored once, and the application's match function is run once
+	per name, so per-message filtering becomes a hash lookup.
+
+	An instance id that does not resolve is cached as unresolved and looked
+	up again every CONMON_NAME_CACHE_RETRY_INTERVAL lookups.
+
+	The client's mapping changes when subscriptions change or when the local
+	device is renamed; the application must call conmon_name_cache_invalidate
+	from both callbacks, and after anything else that changes the result of
+	its match function.
+ */
+
+enum
+{
+	CONMON_NAME_CACHE_RETRY_INTERVAL = 16
+};
+
+typedef struct conmon_name_cache conmon_name_cache_t;
+
+// Return true if messages from the named device are of interest
+typedef aud_bool_t
+conmon_name_cache_match_fn
+(
+	void * context,
+	const char * device_name
+);
+
+typedef struct conmon_name_cache_entry
+{
+	conmon_instance_id_t instance_id;
+	const char * device_name;
+		// NULL if unresolved
+	aud_bool_t matches;
+		// result of the match function, false if unresolved or no function
+	unsigned int retry;
+		// lookups left before an unresolved id is resolved again
+} conmon_name_cache_entry_t;
+
+typedef struct conmon_name_cache_stats
+{
+	unsigned int num_entries;
+	unsigned int num_names;
+	unsigned long num_hits;
+	unsigned long num_misses;
+	unsigned long num_invalidations;
+} conmon_name_cache_stats_t;
+
+
+//----------
+// Functions
+
+/*
+	Create a cache for up to capacity instance ids. When the cache fills up
+	it is emptied and starts again.
+
+	match_fn may be NULL if only names are wanted.
+ */
+aud_error_t
+conmon_name_cache_new
+(
+	conmon_client_t * client,
+	unsigned int capacity,
+	conmon_name_cache_match_fn * match_fn,
+	void * match_context,
+	conmon_name_cache_t ** cache_ptr
+);
+
+void
+conmon_name_cache_delete
+(
+	conmon_name_cache_t * cache
+);
+
+void
+conmon_name_cache_invalidate
+(
+	conmon_name_cache_t * cache
+);
+
+/*
+	Find or resolve the name for an instance id. Never returns NULL.
+
+	The entry, and the name it points to, are valid until the next lookup
+	or invalidation.
+ */
+const conmon_name_cache_entry_t *
+conmon_name_cache_lookup
+(
+	conmon_name_cache_t * cache,
+	const conmon_instance_id_t * instance_id
+);
+
+void
+conmon_name_cache_get_stats
+(
+	const conmon_name_cache_t * cache,
+	conmon_name_cache_stats_t * stats
+);
+
+
+//----------
+
+#endif // _CONMON_NAME_CACHE_H
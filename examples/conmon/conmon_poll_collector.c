@@ -0,0 +1,752 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Shared main program for collectors that poll devices into a series store
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_poll_collector.h"
+#include "conmon_name_cache.h"
+#include "conmon_poll_scheduler.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	COLLECTOR_NAME_CACHE_SIZE = 2048,
+	COLLECTOR_DEFAULT_PERIOD_MS = 5000,
+	COLLECTOR_DEFAULT_SAMPLES = 720,
+	COLLECTOR_DEFAULT_MAX_DEVICES = 256,
+	COLLECTOR_MAX_UNANSWERED = 3,
+		// discovered devices stop being polled after this many queries with no answer
+	COLLECTOR_DROPPED = 0xFFFFFFFFu
+		// unanswered count of a device that is no longer polled
+};
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static const conmon_poll_collector_config_t * g_config = NULL;
+static conmon_series_store_t * g_store = NULL;
+static conmon_poll_scheduler_t * g_scheduler = NULL;
+static conmon_name_cache_t * g_names = NULL;
+
+// devices to poll, indexed by scheduler item
+static conmon_name_t * g_devices = NULL;
+static unsigned int * g_unanswered = NULL;
+	// queries sent since the device last answered
+static unsigned int g_num_devices = 0;
+static unsigned int g_max_devices = COLLECTOR_DEFAULT_MAX_DEVICES;
+static aud_bool_t g_discover = AUD_TRUE;
+static aud_bool_t g_full_reported = AUD_FALSE;
+
+static unsigned long g_num_queries = 0;
+static unsigned long g_num_query_errors = 0;
+static unsigned long g_num_samples = 0;
+static unsigned int g_num_dropped = 0;
+
+static const char * g_csv_file = NULL;
+static const char * g_json_file = NULL;
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+// how long the server keeps trying to deliver each query
+static const aud_utime_t k_control_timeout = {1, 500000};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_ms (void)
+{
+	return conmon_example_clock_ns () / 1000000;
+}
+
+
+// Samples are stamped with wall clock time so that exports can be lined up with other logs
+AUD_INLINE uint64_t
+wall_clock_ms (void)
+{
+	aud_utime_t now;
+	aud_utime_get (& now);
+	return (uint64_t) now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static void
+handle_query_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	if (result != AUD_SUCCESS)
+	{
+		g_num_query_errors++;
+	}
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+// Returns g_num_devices if the device is not in the table
+static unsigned int
+find_device (const char * name)
+{
+	unsigned int i;
+
+	for (i = 0; i < g_num_devices; i++)
+	{
+		if (! STRCASECMP (g_devices [i], name))
+		{
+			break;
+		}
+	}
+	return i;
+}
+
+
+static aud_error_t
+add_device (const char * name)
+{
+	aud_error_t result;
+
+	if (find_device (name) < g_num_devices)
+	{
+		return AUD_SUCCESS;
+	}
+	if (g_num_devices >= g_max_devices)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	if (strlen (name) >= sizeof (g_devices [0]))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	result = conmon_poll_scheduler_add (g_scheduler, g_num_devices);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	g_unanswered [g_num_devices] = 0;
+	strcpy (g_devices [g_num_devices++], name);
+	return AUD_SUCCESS;
+}
+
+
+/*
+	When polling every device seen for something only some devices have,
+	most never answer; stop polling those so that the period is spent on
+	the devices that do. A late answer puts a device back.
+ */
+static void
+device_polled (unsigned int item)
+{
+	if (! (g_discover && g_config->drop_unanswered) || ++g_unanswered [item] <= COLLECTOR_MAX_UNANSWERED)
+	{
+		return;
+	}
+	conmon_poll_scheduler_remove (g_scheduler, item);
+	g_unanswered [item] = COLLECTOR_DROPPED;
+	g_num_dropped++;
+}
+
+
+static void
+device_answered (unsigned int item)
+{
+	if (g_unanswered [item] == COLLECTOR_DROPPED
+		&& conmon_poll_scheduler_add (g_scheduler, item) == AUD_SUCCESS)
+	{
+		g_num_dropped--;
+	}
+	g_unanswered [item] = 0;
+}
+
+
+static void
+send_query (conmon_client_t * client, const char * name)
+{
+	conmon_message_body_t body;
+	conmon_client_request_id_t req_id;
+	uint16_t body_size;
+	aud_error_t result;
+
+	body_size = g_config->query_fn (& body);
+
+	result =
+		conmon_client_send_control_message (
+			client, & handle_query_response, & req_id,
+			name, CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+			& body, body_size, & k_control_timeout
+		);
+	g_num_queries++;
+	if (result != AUD_SUCCESS)
+	{
+		g_num_query_errors++;
+	}
+}
+
+
+static void
+export_file
+(
+	const char * filename,
+	aud_error_t (* write_fn) (const conmon_series_store_t *, uint64_t, FILE *)
+)
+{
+	aud_errbuf_t errbuf;
+	aud_error_t result;
+	FILE * fp;
+
+	if (! filename)
+	{
+		return;
+	}
+	fp = fopen (filename, "w");
+	if (! fp)
+	{
+		fprintf (stderr, "Error opening %s for writing\n", filename);
+		return;
+	}
+	result = write_fn (g_store, 0, fp);
+	if (fclose (fp) != 0 && result == AUD_SUCCESS)
+	{
+		result = AUD_ERR_SYSTEM;
+	}
+	if (result != AUD_SUCCESS)
+	{
+		fprintf (stderr, "Error writing %s: %s\n", filename, aud_error_message (result, errbuf));
+	}
+}
+
+
+static void
+export_all (void)
+{
+	export_file (g_csv_file, conmon_series_store_write_csv);
+	export_file (g_json_file, conmon_series_store_write_json);
+}
+
+
+// Covers the samples taken since since_ms, so that printing every so often shows the trend
+static void
+print_summary (uint64_t since_ms)
+{
+	const unsigned int num_devices = conmon_series_store_num_devices (g_store);
+	const conmon_series_t * series;
+	unsigned int d, s;
+
+	printf ("%u devices polled (%u dropped), %lu queries (%lu failed), %lu samples from %u devices\n"
+		, g_num_devices - g_num_dropped, g_num_dropped, g_num_queries, g_num_query_errors, g_num_samples, num_devices
+	);
+	for (d = 0; d < num_devices; d++)
+	{
+		printf ("  %s\n", conmon_series_store_device_name (g_store, d));
+		for (s = 0; (series = conmon_series_store_series_at_index (g_store, d, s)) != NULL; s++)
+		{
+			g_config->print_fn (series, since_ms);
+		}
+	}
+	fflush (stdout);
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_status_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	const conmon_name_cache_entry_t * source;
+	conmon_instance_id_t instance_id;
+	unsigned int item;
+	aud_error_t result;
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+
+	if (!conmon_vendor_id_equals (conmon_message_head_get_vendor_id (head), CONMON_VENDOR_ID_AUDINATE))
+	{
+		return;
+	}
+
+	conmon_message_head_get_instance_id (head, & instance_id);
+	source = conmon_name_cache_lookup (g_names, & instance_id);
+	if (! source->device_name)
+	{
+		return;
+	}
+
+	if (g_discover)
+	{
+		result = add_device (source->device_name);
+		if (result == AUD_ERR_NOBUFS && ! g_full_reported)
+		{
+			fprintf (stderr, "Device table is full, new devices will not be polled (see -max)\n");
+			g_full_reported = AUD_TRUE;
+		}
+	}
+
+	if (conmon_audinate_message_get_type (body) != g_config->status_type)
+	{
+		return;
+	}
+	result =
+		g_config->add_fn (
+			g_store, & instance_id, source->device_name, wall_clock_ms (),
+			body, conmon_message_head_get_body_size (head)
+		);
+	if (result != AUD_SUCCESS)
+	{
+		return;
+	}
+	g_num_samples++;
+	item = find_device (source->device_name);
+	if (item < g_num_devices)
+	{
+		device_answered (item);
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (num_changes);
+	AUD_UNUSED (changes);
+
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Functions
+
+static void
+usage (const char * bin)
+{
+	printf ("Usage: %s [-p=PORT] [-period=MS] [-samples=N] [-max=N] [-csv=FILE] [-json=FILE]\n"
+		"    [-export=SEC] [-summary=SEC] [DEVICE...]\n", bin);
+	printf ("%s\n", g_config->description);
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -period=MS: query each device once every MS milliseconds (default %u),\n"
+		"      spreading the queries evenly over the period\n", COLLECTOR_DEFAULT_PERIOD_MS);
+	printf ("  -samples=N: keep the last N samples for each port (default %u)\n", COLLECTOR_DEFAULT_SAMPLES);
+	printf ("  -max=N: poll at most N devices (default %u)\n", COLLECTOR_DEFAULT_MAX_DEVICES);
+	printf ("  -csv=FILE: write all samples to FILE as CSV\n");
+	printf ("  -json=FILE: write all samples to FILE as JSON\n");
+	printf ("  -export=SEC: rewrite the export files every SEC seconds as well as on exit\n");
+	printf ("  -summary=SEC: every SEC seconds, summarise the samples from the last SEC seconds\n");
+	if (g_config->drop_unanswered)
+	{
+		printf ("  DEVICE: poll the named devices, otherwise poll every device seen on the network,\n"
+			"      dropping those that do not answer %u queries in a row\n", COLLECTOR_MAX_UNANSWERED);
+	}
+	else
+	{
+		printf ("  DEVICE: poll the named devices, otherwise poll every device seen on the network\n");
+	}
+	printf ("  Ctrl-C prints a summary, writes the export files and exits\n");
+}
+
+
+int
+conmon_poll_collector_main
+(
+	const conmon_poll_collector_config_t * config,
+	int argc,
+	char * argv[]
+)
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * client_config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	dante_sockets_t sockets;
+	uint16_t server_port = 0;
+	unsigned int period_ms = COLLECTOR_DEFAULT_PERIOD_MS;
+	unsigned int samples = COLLECTOR_DEFAULT_SAMPLES;
+	unsigned int export_s = 0, summary_s = 0;
+	uint64_t next_export_ms = 0, next_summary_ms = 0;
+	int a, first_device = argc;
+
+	g_config = config;
+
+	for (a = 1; a < argc; a++)
+	{
+		const char * arg = argv[a];
+		if (arg[0] != '-')
+		{
+			first_device = a;
+			break;
+		}
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if (!strncmp (arg, "-period=", 8) && strlen (arg) > 8)
+		{
+			period_ms = (unsigned int) atoi (arg + 8);
+		}
+		else if (!strncmp (arg, "-samples=", 9) && strlen (arg) > 9)
+		{
+			samples = (unsigned int) atoi (arg + 9);
+		}
+		else if (!strncmp (arg, "-max=", 5) && strlen (arg) > 5)
+		{
+			g_max_devices = (unsigned int) atoi (arg + 5);
+		}
+		else if (!strncmp (arg, "-csv=", 5) && strlen (arg) > 5)
+		{
+			g_csv_file = arg + 5;
+		}
+		else if (!strncmp (arg, "-json=", 6) && strlen (arg) > 6)
+		{
+			g_json_file = arg + 6;
+		}
+		else if (!strncmp (arg, "-export=", 8) && strlen (arg) > 8)
+		{
+			export_s = (unsigned int) atoi (arg + 8);
+		}
+		else if (!strncmp (arg, "-summary=", 9) && strlen (arg) > 9)
+		{
+			summary_s = (unsigned int) atoi (arg + 9);
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+	if (!period_ms || !samples || !g_max_devices || (unsigned int) (argc - first_device) > g_max_devices)
+	{
+		usage (argv[0]);
+		exit (1);
+	}
+
+	g_devices = calloc (g_max_devices, sizeof (* g_devices));
+	g_unanswered = calloc (g_max_devices, sizeof (* g_unanswered));
+	result = (g_devices && g_unanswered) ? conmon_poll_scheduler_new (period_ms, g_max_devices, & g_scheduler) : AUD_ERR_NOMEMORY;
+	if (result == AUD_SUCCESS)
+	{
+		result = g_config->store_fn (g_max_devices, samples, & g_store);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error allocating statistics store: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	for (a = first_device; a < argc; a++)
+	{
+		result = add_device (argv[a]);
+		if (result != AUD_SUCCESS)
+		{
+			printf ("Invalid device name '%s': %s\n", argv[a], aud_error_message (result, errbuf));
+			goto cleanup;
+		}
+	}
+	g_discover = (g_num_devices == 0);
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	client_config = conmon_client_config_new (g_config->client_name);
+	if (!client_config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (client_config, server_port);
+	}
+	result = conmon_client_new_config (env, client_config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, COLLECTOR_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device name cache: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+			handle_status_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for status messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	if (g_discover)
+	{
+		result =
+			conmon_client_subscribe_global (
+				client, & handle_response, & req_id,
+				CONMON_CHANNEL_TYPE_STATUS
+			);
+		if (result == AUD_SUCCESS)
+		{
+			result = wait_for_response (client, & k_comms_timeout);
+		}
+		if (result != AUD_SUCCESS)
+		{
+			printf ("Error subscribing to status from all devices: %s\n", aud_error_message (result, errbuf));
+			goto cleanup;
+		}
+	}
+	else
+	{
+		unsigned int i;
+		for (i = 0; i < g_num_devices; i++)
+		{
+			result =
+				conmon_client_subscribe (
+					client, & handle_response, & req_id,
+					CONMON_CHANNEL_TYPE_STATUS, g_devices [i]
+				);
+			if (result == AUD_SUCCESS)
+			{
+				result = wait_for_response (client, & k_comms_timeout);
+			}
+			if (result != AUD_SUCCESS)
+			{
+				printf ("Error subscribing to status from %s: %s\n", g_devices [i], aud_error_message (result, errbuf));
+				goto cleanup;
+			}
+		}
+	}
+
+	printf ("Polling %s for %s every %u ms, keeping %u samples per port\n"
+		, g_discover ? "all devices" : "the named devices", g_config->polling, period_ms, samples
+	);
+
+	// The loop runs until the user hits CTRL-C, waking whenever a query is due
+	signal (SIGINT, sig_handler);
+	if (export_s)
+	{
+		next_export_ms = now_ms () + export_s * 1000;
+	}
+	if (summary_s)
+	{
+		next_summary_ms = now_ms () + summary_s * 1000;
+	}
+	while (g_running)
+	{
+		aud_utime_t timeout;
+		unsigned int ms, item;
+		uint64_t now;
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& sockets);
+			conmon_client_get_sockets (client, & sockets);
+		}
+
+		now = now_ms ();
+		while (conmon_poll_scheduler_next (g_scheduler, now, & item))
+		{
+			send_query (client, g_devices [item]);
+			device_polled (item);
+		}
+		if (export_s && now >= next_export_ms)
+		{
+			export_all ();
+			next_export_ms = now + export_s * 1000;
+		}
+		if (summary_s && now >= next_summary_ms)
+		{
+			print_summary (wall_clock_ms () - summary_s * 1000);
+			next_summary_ms = now + summary_s * 1000;
+		}
+
+		ms = conmon_poll_scheduler_ms_to_next (g_scheduler, now);
+		if (export_s && next_export_ms - now < ms)
+		{
+			ms = (unsigned int) (next_export_ms - now);
+		}
+		if (summary_s && next_summary_ms - now < ms)
+		{
+			ms = (unsigned int) (next_summary_ms - now);
+		}
+		timeout.tv_sec = ms / 1000;
+		timeout.tv_usec = (ms % 1000) * 1000;
+		conmon_example_client_process (client, & sockets, & timeout, NULL);
+	}
+
+	print_summary (0);
+	export_all ();
+	result = AUD_SUCCESS;
+
+cleanup:
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (client_config)
+	{
+		conmon_client_config_delete (client_config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	conmon_series_store_delete (g_store);
+	conmon_poll_scheduler_delete (g_scheduler);
+	free (g_unanswered);
+	free (g_devices);
+	return (result == AUD_SUCCESS) ? 0 : 1;
+}
+
+
+//----------
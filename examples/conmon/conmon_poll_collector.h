@@ -0,0 +1,104 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Shared main program for collectors that poll devices into a series store
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_POLL_COLLECTOR_H
+#define _CONMON_POLL_COLLECTOR_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_series_store.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	A poll collector queries each device on a conmon_poll_scheduler, either
+	the devices named on the command line or every device seen on the
+	network, and adds the status each device answers with to a series
+	store. It handles the command line, the conmon client, the device
+	table, the periodic summary and the CSV and JSON exports; a collector
+	gives what to query, how to store the answer and how to summarise a
+	series.
+ */
+
+// Fill in the query sent to each device and return its size
+typedef uint16_t
+conmon_poll_collector_query_fn
+(
+	conmon_message_body_t * body
+);
+
+typedef aud_error_t
+conmon_poll_collector_store_fn
+(
+	unsigned int max_devices,
+	unsigned int samples_per_series,
+	conmon_series_store_t ** store_ptr
+);
+
+// Decode a status of the collector's status_type and add it to the store
+typedef aud_error_t
+conmon_poll_collector_add_fn
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	uint64_t time_ms,
+	const conmon_message_body_t * body,
+	uint16_t body_size
+);
+
+// Print one line for a series, covering the samples taken at or after since_ms
+typedef void
+conmon_poll_collector_print_fn
+(
+	const conmon_series_t * series,
+	uint64_t since_ms
+);
+
+typedef struct conmon_poll_collector_config
+{
+	const char * client_name;
+		// given to the conmon server
+	const char * description;
+		// a line or two for the usage text, saying what is collected
+	const char * polling;
+		// what is polled for, as in "Polling all devices for ..."
+	uint16_t status_type;
+		// CONMON_AUDINATE_MESSAGE_TYPE_* of the answer
+	aud_bool_t drop_unanswered;
+		// stop polling discovered devices that do not answer several queries in a row
+	conmon_poll_collector_query_fn * query_fn;
+	conmon_poll_collector_store_fn * store_fn;
+	conmon_poll_collector_add_fn * add_fn;
+	conmon_poll_collector_print_fn * print_fn;
+} conmon_poll_collector_config_t;
+
+
+//----------
+// Functions
+
+// Run the collector until Ctrl-C, returning the process exit status
+int
+conmon_poll_collector_main
+(
+	const conmon_poll_collector_config_t * config,
+	int argc,
+	char * argv[]
+);
+
+
+//----------
+
+#endif // _CONMON_POLL_COLLECTOR_H
@@ -0,0 +1,212 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Spread periodic polls of many items evenly across a period
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_poll_scheduler.h"
+#include <stdlib.h>
+
+
+//----------
+// Types and Constants
+
+struct conmon_poll_scheduler
+{
+	unsigned int period_ms;
+	unsigned int max_items;
+	unsigned int num_items;
+	unsigned int * items;
+	unsigned int cursor;
+		// next item to poll
+	uint64_t next_due_ms;
+	aud_bool_t started;
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE unsigned int
+poll_interval (const conmon_poll_scheduler_t * scheduler)
+{
+	unsigned int interval = scheduler->period_ms / scheduler->num_items;
+	return interval ? interval : 1;
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_poll_scheduler_new
+(
+	unsigned int period_ms,
+	unsigned int max_items,
+	conmon_poll_scheduler_t ** scheduler_ptr
+)
+{
+	conmon_poll_scheduler_t * scheduler;
+
+	if (! (period_ms && max_items && scheduler_ptr))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	scheduler = calloc (1, sizeof (* scheduler));
+	if (! scheduler)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	scheduler->items = malloc (max_items * sizeof (* scheduler->items));
+	if (! scheduler->items)
+	{
+		free (scheduler);
+		return AUD_ERR_NOMEMORY;
+	}
+	scheduler->period_ms = period_ms;
+	scheduler->max_items = max_items;
+
+	* scheduler_ptr = scheduler;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_poll_scheduler_delete
+(
+	conmon_poll_scheduler_t * scheduler
+)
+{
+	if (scheduler)
+	{
+		free (scheduler->items);
+		free (scheduler);
+	}
+}
+
+
+aud_error_t
+conmon_poll_scheduler_add
+(
+	conmon_poll_scheduler_t * scheduler,
+	unsigned int item
+)
+{
+	if (scheduler->num_items >= scheduler->max_items)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	// new items join the end of the cycle, so they wait a full cycle at most
+	scheduler->items [scheduler->num_items++] = item;
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_poll_scheduler_remove
+(
+	conmon_poll_scheduler_t * scheduler,
+	unsigned int item
+)
+{
+	unsigned int i;
+
+	for (i = 0; i < scheduler->num_items; i++)
+	{
+		if (scheduler->items [i] == item)
+		{
+			// keep the order so the remaining items keep their spacing,
+			// and keep the cursor on the item that was due next
+			if (i < scheduler->cursor)
+			{
+				scheduler->cursor--;
+			}
+			scheduler->num_items--;
+			for (; i < scheduler->num_items; i++)
+			{
+				scheduler->items [i] = scheduler->items [i + 1];
+			}
+			return AUD_SUCCESS;
+		}
+	}
+	return AUD_ERR_NOTFOUND;
+}
+
+
+unsigned int
+conmon_poll_scheduler_num_items
+(
+	const conmon_poll_scheduler_t * scheduler
+)
+{
+	return scheduler->num_items;
+}
+
+
+aud_bool_t
+conmon_poll_scheduler_next
+(
+	conmon_poll_scheduler_t * scheduler,
+	uint64_t now_ms,
+	unsigned int * item
+)
+{
+	if (! scheduler->num_items)
+	{
+		scheduler->started = AUD_FALSE;
+		return AUD_FALSE;
+	}
+	if (! scheduler->started)
+	{
+		scheduler->next_due_ms = now_ms;
+		scheduler->started = AUD_TRUE;
+	}
+	if (now_ms < scheduler->next_due_ms)
+	{
+		return AUD_FALSE;
+	}
+
+	if (scheduler->cursor >= scheduler->num_items)
+	{
+		scheduler->cursor = 0;
+	}
+	* item = scheduler->items [scheduler->cursor++];
+
+	scheduler->next_due_ms += poll_interval (scheduler);
+	if (scheduler->next_due_ms + scheduler->period_ms < now_ms)
+	{
+		scheduler->next_due_ms = now_ms + poll_interval (scheduler);
+	}
+	return AUD_TRUE;
+}
+
+
+unsigned int
+conmon_poll_scheduler_ms_to_next
+(
+	const conmon_poll_scheduler_t * scheduler,
+	uint64_t now_ms
+)
+{
+	if (! scheduler->num_items)
+	{
+		return scheduler->period_ms;
+	}
+	if (! scheduler->started || now_ms >= scheduler->next_due_ms)
+	{
+		return 0;
+	}
+	return (unsigned int) (scheduler->next_due_ms - now_ms);
+}
+
+
+//----------
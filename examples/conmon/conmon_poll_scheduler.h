@@ -0,0 +1,103 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Spread periodic polls of many items evenly across a period
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_POLL_SCHEDULER_H
+#define _CONMON_POLL_SCHEDULER_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The scheduler polls each of its items once per period, one at a time, at
+	intervals of period / num_items, cycling through the items in the order
+	they were added. Querying every device at the same moment makes all the
+	replies arrive in a burst; this keeps the request and reply rate flat.
+
+	Items are the caller's own identifiers (typically an index into its own
+	table). Adding or removing items changes the interval from the next poll
+	on. If the caller falls behind by more than a whole period the schedule
+	restarts from the current time instead of catching up in a burst.
+
+	Times are supplied by the caller in milliseconds from any monotonic clock.
+ */
+
+typedef struct conmon_poll_scheduler conmon_poll_scheduler_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_poll_scheduler_new
+(
+	unsigned int period_ms,
+	unsigned int max_items,
+	conmon_poll_scheduler_t ** scheduler_ptr
+);
+
+void
+conmon_poll_scheduler_delete
+(
+	conmon_poll_scheduler_t * scheduler
+);
+
+// @return AUD_ERR_NOBUFS if max_items are already scheduled
+aud_error_t
+conmon_poll_scheduler_add
+(
+	conmon_poll_scheduler_t * scheduler,
+	unsigned int item
+);
+
+// @return AUD_ERR_NOTFOUND if the item is not scheduled
+aud_error_t
+conmon_poll_scheduler_remove
+(
+	conmon_poll_scheduler_t * scheduler,
+	unsigned int item
+);
+
+unsigned int
+conmon_poll_scheduler_num_items
+(
+	const conmon_poll_scheduler_t * scheduler
+);
+
+/*
+	If a poll is due by now_ms, return AUD_TRUE with the item to poll and
+	move on to the next one. Call repeatedly until it returns AUD_FALSE.
+ */
+aud_bool_t
+conmon_poll_scheduler_next
+(
+	conmon_poll_scheduler_t * scheduler,
+	uint64_t now_ms,
+	unsigned int * item
+);
+
+// Milliseconds until the next poll is due (0 if one is due now), or period_ms if there are no items
+unsigned int
+conmon_poll_scheduler_ms_to_next
+(
+	const conmon_poll_scheduler_t * scheduler,
+	uint64_t now_ms
+);
+
+
+//----------
+
+#endif // _CONMON_POLL_SCHEDULER_H
@@ -0,0 +1,437 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Replay captured conmon monitoring messages through the
+ *            listener's filter and print path as fast as possible
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_msg_filter.h"
+#include "conmon_capture.h"
+
+#ifdef WIN32
+#define NULL_DEVICE "NUL"
+#else
+	#include <libgen.h>
+	#include <errno.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+//----------
+// Types and Constants
+
+static char * g_progname;
+
+enum
+{
+	REPLAY_MAX_TYPES = 0x10000
+};
+
+typedef struct replay_type_stats
+{
+	uint64_t count;
+	uint64_t ns;
+} replay_type_stats_t;
+
+typedef struct replay_info
+{
+	// options
+	unsigned int passes;
+	unsigned long num_messages;
+		// if non-zero, replay this many messages, cycling through the
+		// capture's records as often as needed; nothing new is generated
+	const char * output;
+	const char * capture;
+	const char * channel;
+		// if set, only replay messages captured on the channel of this name
+
+	unsigned n_filters;
+	message_filter_mode_t filter_mode;
+	struct message_filter filter [FILTER_MAX_FILTERS];
+
+	// corpus
+	conmon_capture_record_t * records;
+	unsigned long n_records;
+
+	// results
+	uint64_t n_filtered;
+	uint64_t n_other_channel;
+	uint64_t n_other_vendor;
+	uint64_t n_short;
+		// too short to hold an Audinate message head
+	replay_type_stats_t types [REPLAY_MAX_TYPES];
+} replay_info_t;
+
+static replay_info_t g_info;
+	// too big for the stack
+
+
+//----------
+// Local functions
+
+AUD_INLINE const char *
+pname (void)
+{
+#ifdef WIN32
+	return g_progname;
+#else
+	return basename (g_progname);
+#endif
+}
+
+
+static int
+usage (const char * msg)
+{
+	const char * name = pname ();
+
+	if (msg)
+	{
+		fprintf (stderr, "%s: %s\n", name, msg);
+	}
+
+	fprintf (stderr,
+		"Usage: %s [-n passes] [-m num_messages] [-c channel] [-x|f msg_type ...] [-o output_file] capture_file\n"
+		"  -n  replay the capture this many times (default 1)\n"
+		"  -m  replay this many messages, repeating the capture as needed (overrides -n)\n"
+		"  -c  only replay messages captured on this channel: status, broadcast, local ...\n"
+		"  -o  write printed messages here rather than discarding them\n"
+		, name
+	);
+
+	return 2;
+}
+
+
+static int
+handle_args (replay_info_t * info, int argc, char ** argv)
+{
+	int curr_arg_index = 1;
+
+	g_progname = argv [0];
+	info->passes = 1;
+
+	while (curr_arg_index < argc && argv [curr_arg_index][0] == '-')
+	{
+		char * arg = argv [curr_arg_index++];
+		message_filter_mode_t fmode = MESSAGE_FILTER_MODE_PASS;
+			// for f/x case below
+
+		if (arg [1] != 'x' && arg [1] != 'f' && curr_arg_index >= argc)
+		{
+			return usage ("Missing argument");
+		}
+
+		switch (arg [1])
+		{
+		case 'n':
+			info->passes = (unsigned int) strtoul (argv [curr_arg_index++], NULL, 0);
+			if (! info->passes)
+			{
+				return usage ("Invalid number of passes");
+			}
+			break;
+
+		case 'm':
+			info->num_messages = strtoul (argv [curr_arg_index++], NULL, 0);
+			if (! info->num_messages)
+			{
+				return usage ("Invalid number of messages");
+			}
+			break;
+
+		case 'o':
+			info->output = argv [curr_arg_index++];
+			break;
+
+		case 'c':
+			info->channel = argv [curr_arg_index++];
+			break;
+
+		case 'x':
+			fmode = MESSAGE_FILTER_MODE_FAIL;
+		case 'f':
+			if (info->n_filters)
+			{
+				if (fmode != info->filter_mode)
+					return usage ("Cannot use both -f and -x");
+			}
+			else
+			{
+				info->filter_mode = fmode;
+			}
+			if (curr_arg_index >= argc)
+			{
+				return usage ("Missing argument to -f");
+			}
+			else if (info->n_filters >= FILTER_MAX_FILTERS)
+			{
+				return usage ("Too many filters");
+			}
+			else
+			{
+				unsigned long argval = strtoul (argv [curr_arg_index++], NULL, 0);
+				if ((! argval) || argval > 0xFFFF)
+				{
+					return usage ("Invalid filter argument");
+				}
+				info->filter [info->n_filters++].mtype = (conmon_audinate_message_type_t) argval;
+			}
+			break;
+
+		default:
+			fprintf (stderr, "%s: Unknown option '%s'\n"
+				, pname (), arg
+			);
+			return usage (NULL);
+		}
+	}
+
+	if (curr_arg_index != argc - 1)
+	{
+		return usage ("Expected a single capture file");
+	}
+	info->capture = argv [curr_arg_index];
+	return 0;
+}
+
+
+static aud_error_t
+load_capture (replay_info_t * info)
+{
+	aud_error_t result;
+	aud_errbuf_t ebuf;
+	unsigned long capacity = 0;
+	FILE * fp = fopen (info->capture, "rb");
+
+	if (! fp)
+	{
+		fprintf (stderr, "%s: failed to open '%s': %s\n"
+			, pname (), info->capture, strerror (errno)
+		);
+		return AUD_ERR_NOTFOUND;
+	}
+
+	result = conmon_capture_read_file_head (fp);
+	if (result != AUD_SUCCESS)
+	{
+		fprintf (stderr, "%s: '%s' is not a compatible capture file\n"
+			, pname (), info->capture
+		);
+		goto l__done;
+	}
+
+	for (;;)
+	{
+		if (info->n_records == capacity)
+		{
+			conmon_capture_record_t * records;
+			capacity = capacity ? capacity * 2 : 1024;
+			records = realloc (info->records, capacity * sizeof (conmon_capture_record_t));
+			if (! records)
+			{
+				result = AUD_ERR_NOMEMORY;
+				goto l__done;
+			}
+			info->records = records;
+		}
+
+		result = conmon_capture_read_record (fp, info->records + info->n_records);
+		if (result != AUD_SUCCESS)
+		{
+			break;
+		}
+		info->n_records++;
+	}
+
+	if (result == AUD_ERR_DONE)
+	{
+		result = AUD_SUCCESS;
+	}
+	else
+	{
+		// keep what we have, a capture is often cut short
+		fprintf (stderr, "%s: stopped reading '%s' after %lu records: %s\n"
+			, pname (), info->capture, info->n_records
+			, aud_error_message (result, ebuf)
+		);
+		result = info->n_records ? AUD_SUCCESS : result;
+	}
+
+l__done:
+	fclose (fp);
+	return result;
+}
+
+
+/*
+	Mirrors the work done in conmon_audinate_listener's monitoring callback,
+	less the device name lookups which need a live client. Only Audinate
+	messages are decoded; anything else, or a message on another channel
+	than the one asked for, is counted and skipped.
+
+	@return AUD_TRUE if the message was printed
+ */
+static aud_bool_t
+replay_message (replay_info_t * info, const conmon_capture_record_t * record)
+{
+	conmon_instance_id_t id;
+	char id_buf[64];
+	uint16_t aud_type;
+
+	if (info->channel && strcmp (info->channel, conmon_example_channel_type_to_string (record->channel_type)))
+	{
+		info->n_other_channel++;
+		return AUD_FALSE;
+	}
+	if (! conmon_vendor_id_equals (conmon_message_head_get_vendor_id (& record->head), CONMON_VENDOR_ID_AUDINATE))
+	{
+		info->n_other_vendor++;
+		return AUD_FALSE;
+	}
+	if (record->body_size < sizeof (conmon_audinate_message_head_t))
+	{
+		info->n_short++;
+		return AUD_FALSE;
+	}
+
+	aud_type = conmon_audinate_message_get_type (& record->body);
+	if (! conmon_msg_filter_accepts (info->filter, info->n_filters, info->filter_mode, aud_type))
+	{
+		info->n_filtered++;
+		return AUD_FALSE;
+	}
+
+	conmon_message_head_get_instance_id (& record->head, & id);
+
+	printf (
+		"Received status message from %s (%s)\n:"
+		"  chan=%s (%s) size=%d aud-version=0x%04x aud-type=0x%04x\n"
+		, conmon_example_instance_id_to_string (& id, id_buf, sizeof (id_buf))
+		, "[unknown device]"
+		, conmon_example_channel_type_to_string (record->channel_type)
+		, (record->channel_direction == CONMON_CHANNEL_DIRECTION_TX ? "tx" : "rx")
+		, record->body_size
+		, (unsigned int) conmon_audinate_message_get_version (& record->body)
+		, (unsigned int) aud_type
+	);
+	conmon_aud_print_msg (& record->body, record->body_size);
+	return AUD_TRUE;
+}
+
+
+static void
+print_report (const replay_info_t * info, uint64_t elapsed_ns)
+{
+	unsigned int t;
+	uint64_t total_count = 0, total_ns = 0;
+
+	fprintf (stderr, "%-8s %-28s %12s %14s %10s\n"
+		, "type", "name", "messages", "messages/sec", "ns/msg"
+	);
+	for (t = 0; t < REPLAY_MAX_TYPES; t++)
+	{
+		const replay_type_stats_t * stats = info->types + t;
+		const char * name;
+		if (! stats->count)
+		{
+			continue;
+		}
+		name = conmon_aud_print_msg_type_name ((uint16_t) t);
+		fprintf (stderr, "0x%04x   %-28s %12llu %14.0f %10.0f\n"
+			, t, name ? name : "(unknown)"
+			, (unsigned long long) stats->count
+			, stats->ns ? stats->count * 1e9 / stats->ns : 0.0
+			, (double) stats->ns / stats->count
+		);
+		total_count += stats->count;
+		total_ns += stats->ns;
+	}
+	fprintf (stderr, "%-8s %-28s %12llu %14.0f %10.0f\n"
+		, "total", ""
+		, (unsigned long long) total_count
+		, total_ns ? total_count * 1e9 / total_ns : 0.0
+		, total_count ? (double) total_ns / total_count : 0.0
+	);
+	fprintf (stderr, "%llu messages filtered out, %llu on other channels, %llu from other vendors, %llu too short; %.3f s elapsed\n"
+		, (unsigned long long) info->n_filtered
+		, (unsigned long long) info->n_other_channel
+		, (unsigned long long) info->n_other_vendor
+		, (unsigned long long) info->n_short
+		, elapsed_ns / 1e9
+	);
+}
+
+
+//----------
+// Main
+
+int
+main (int argc, char ** argv)
+{
+	replay_info_t * info = & g_info;
+	unsigned long i, total;
+	uint64_t start;
+	int result;
+
+	result = handle_args (info, argc, argv);
+	if (result != 0)
+	{
+		return result;
+	}
+
+	if (load_capture (info) != AUD_SUCCESS)
+	{
+		return 1;
+	}
+	if (! info->n_records)
+	{
+		fprintf (stderr, "%s: '%s' contains no messages\n", pname (), info->capture);
+		return 1;
+	}
+
+	total = info->num_messages ? info->num_messages : info->n_records * info->passes;
+	fprintf (stderr, "%s: replaying %lu messages from a corpus of %lu\n"
+		, pname (), total, info->n_records
+	);
+
+	// message printing goes to stdout, so point it somewhere harmless
+	if (! freopen (info->output ? info->output : NULL_DEVICE, "w", stdout))
+	{
+		fprintf (stderr, "%s: failed to redirect output: %s\n", pname (), strerror (errno));
+		return 1;
+	}
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < total; i++)
+	{
+		const conmon_capture_record_t * record = info->records + (i % info->n_records);
+		replay_type_stats_t * stats =
+			info->types + conmon_audinate_message_get_type (& record->body);
+		uint64_t t0 = conmon_example_clock_ns ();
+
+		// only messages that were printed count towards their type
+		if (replay_message (info, record))
+		{
+			stats->ns += conmon_example_clock_ns () - t0;
+			stats->count++;
+		}
+	}
+	fflush (stdout);
+
+	print_report (info, conmon_example_clock_ns () - start);
+
+	free (info->records);
+	return 0;
+}
+
+
+//----------
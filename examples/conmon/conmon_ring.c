@@ -0,0 +1,276 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Lock-free single producer, single consumer ring of variable size records
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_ring.h"
+#include <stdlib.h>
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	RING_CACHE_LINE = 64,
+	RING_ALIGN = 8,
+	RING_MIN_SIZE = 64,
+	RING_MAX_SIZE = 0x40000000
+};
+
+// Precedes every record; a size of 0 marks the unused end of the buffer
+typedef struct ring_record_head
+{
+	uint32_t size;
+		// of the header and record, a multiple of RING_ALIGN
+	uint32_t reserved;
+} ring_record_head_t;
+
+/*
+	head and tail are free running byte counters; the offset for a counter
+	value is (value & mask). A record is never split: if it does not fit
+	before the end of the buffer, the rest of the buffer is marked unused
+	and the record starts again at offset 0.
+
+	Each side keeps a private copy of the other side's counter and only
+	re-reads the shared one when the copy says the ring is full (or empty),
+	so in the steady state each side touches the other's cache line once
+	per batch rather than once per record.
+ */
+struct conmon_ring
+{
+	uint8_t * data;
+	uint32_t size;
+	uint32_t mask;
+
+	char pad_producer [RING_CACHE_LINE];
+	volatile uint32_t head;
+		// written by the producer only
+	uint32_t producer_tail;
+	uint32_t reserved;
+		// bytes taken by the last reservation, including any unused end
+	volatile uint32_t overflows;
+		// written by the producer only
+
+	char pad_consumer [RING_CACHE_LINE];
+	volatile uint32_t tail;
+		// written by the consumer only
+	uint32_t consumer_head;
+	uint32_t peeked;
+		// bytes taken by the last record peeked, including any unused end
+
+	char pad_end [RING_CACHE_LINE];
+};
+
+
+//----------
+// Local functions
+
+#ifdef WIN32
+
+AUD_INLINE uint32_t
+ring_load_acquire (const volatile uint32_t * p)
+{
+	uint32_t value = *p;
+	MemoryBarrier ();
+	return value;
+}
+
+AUD_INLINE void
+ring_store_release (volatile uint32_t * p, uint32_t value)
+{
+	MemoryBarrier ();
+	*p = value;
+}
+
+#else
+
+AUD_INLINE uint32_t
+ring_load_acquire (const volatile uint32_t * p)
+{
+	return __atomic_load_n (p, __ATOMIC_ACQUIRE);
+}
+
+AUD_INLINE void
+ring_store_release (volatile uint32_t * p, uint32_t value)
+{
+	__atomic_store_n (p, value, __ATOMIC_RELEASE);
+}
+
+#endif
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_ring_new
+(
+	size_t size,
+	conmon_ring_t ** ring_ptr
+)
+{
+	conmon_ring_t * ring;
+	uint32_t n = RING_MIN_SIZE;
+
+	if (! (ring_ptr && size) || size > RING_MAX_SIZE)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (n < size)
+	{
+		n <<= 1;
+	}
+
+	ring = calloc (1, sizeof (* ring));
+	if (! ring)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	ring->data = malloc (n);
+	if (! ring->data)
+	{
+		free (ring);
+		return AUD_ERR_NOMEMORY;
+	}
+	ring->size = n;
+	ring->mask = n - 1;
+
+	* ring_ptr = ring;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_ring_delete
+(
+	conmon_ring_t * ring
+)
+{
+	if (ring)
+	{
+		free (ring->data);
+		free (ring);
+	}
+}
+
+
+void *
+conmon_ring_reserve
+(
+	conmon_ring_t * ring,
+	size_t size
+)
+{
+	const uint32_t head = ring->head;
+	const uint32_t offset = head & ring->mask;
+	const uint32_t to_end = ring->size - offset;
+	ring_record_head_t * record;
+	uint32_t need, total;
+
+	if (size > ring->size / 2)
+	{
+		return NULL;
+	}
+	need = (uint32_t) ((sizeof (ring_record_head_t) + size + RING_ALIGN - 1) & ~ (size_t) (RING_ALIGN - 1));
+	if (need > ring->size / 2)
+	{
+		// so that a record that must start again at offset 0 still fits an empty ring
+		return NULL;
+	}
+	total = (need <= to_end) ? need : to_end + need;
+
+	if (head + total - ring->producer_tail > ring->size)
+	{
+		ring->producer_tail = ring_load_acquire (& ring->tail);
+		if (head + total - ring->producer_tail > ring->size)
+		{
+			ring_store_release (& ring->overflows, ring->overflows + 1);
+			return NULL;
+		}
+	}
+
+	record = (ring_record_head_t *) (ring->data + offset);
+	if (need > to_end)
+	{
+		// offsets are multiples of RING_ALIGN, so there is always room for the marker
+		record->size = 0;
+		record = (ring_record_head_t *) ring->data;
+	}
+	record->size = need;
+	ring->reserved = total;
+	return record + 1;
+}
+
+
+void
+conmon_ring_commit
+(
+	conmon_ring_t * ring
+)
+{
+	ring_store_release (& ring->head, ring->head + ring->reserved);
+}
+
+
+const void *
+conmon_ring_peek
+(
+	conmon_ring_t * ring
+)
+{
+	const uint32_t tail = ring->tail;
+	const uint32_t offset = tail & ring->mask;
+	const ring_record_head_t * record;
+
+	if (tail == ring->consumer_head)
+	{
+		ring->consumer_head = ring_load_acquire (& ring->head);
+		if (tail == ring->consumer_head)
+		{
+			return NULL;
+		}
+	}
+	record = (const ring_record_head_t *) (ring->data + offset);
+	ring->peeked = 0;
+	if (! record->size)
+	{
+		// the record was published along with the marker, starting at offset 0
+		ring->peeked = ring->size - offset;
+		record = (const ring_record_head_t *) ring->data;
+	}
+	ring->peeked += record->size;
+	return record + 1;
+}
+
+
+void
+conmon_ring_release
+(
+	conmon_ring_t * ring
+)
+{
+	ring_store_release (& ring->tail, ring->tail + ring->peeked);
+}
+
+
+unsigned long
+conmon_ring_num_overflows
+(
+	const conmon_ring_t * ring
+)
+{
+	return ring_load_acquire (& ring->overflows);
+}
+
+
+//----------
@@ -0,0 +1,97 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Lock-free single producer, single consumer ring of variable size records
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_RING_H
+#define _CONMON_RING_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	A ring carries records from exactly one producer thread to exactly one
+	consumer thread without taking a lock. Each record takes only the
+	space asked for when it is reserved, plus a small header, so a ring's
+	memory is set by the bytes in flight rather than by the largest
+	record. The producer fills a record in place between
+	conmon_ring_reserve and conmon_ring_commit; the consumer reads it in
+	place between conmon_ring_peek and conmon_ring_release. Records are
+	8 byte aligned.
+
+	The ring never blocks. When it is full, conmon_ring_reserve returns NULL
+	and counts an overflow, and the producer decides whether to drop or retry.
+ */
+
+typedef struct conmon_ring conmon_ring_t;
+
+
+//----------
+// Functions
+
+// size is in bytes and rounded up to a power of two; a record and its header may use up to half of it
+aud_error_t
+conmon_ring_new
+(
+	size_t size,
+	conmon_ring_t ** ring_ptr
+);
+
+void
+conmon_ring_delete
+(
+	conmon_ring_t * ring
+);
+
+// Producer: returns space for a record of size bytes, or NULL if the ring is full
+void *
+conmon_ring_reserve
+(
+	conmon_ring_t * ring,
+	size_t size
+);
+
+// Producer: publish the record returned by the last conmon_ring_reserve
+void
+conmon_ring_commit
+(
+	conmon_ring_t * ring
+);
+
+// Consumer: returns the oldest published record, or NULL if the ring is empty
+const void *
+conmon_ring_peek
+(
+	conmon_ring_t * ring
+);
+
+// Consumer: hand the record returned by the last conmon_ring_peek back to the producer
+void
+conmon_ring_release
+(
+	conmon_ring_t * ring
+);
+
+// Number of times conmon_ring_reserve found the ring full. Safe from either thread.
+unsigned long
+conmon_ring_num_overflows
+(
+	const conmon_ring_t * ring
+);
+
+
+//----------
+
+#endif // _CONMON_RING_H
@@ -0,0 +1,475 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Per-device time series of fixed size samples with CSV and JSON export
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_series_store.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+typedef struct series_device
+{
+	conmon_name_t name;
+	unsigned int num_series;
+	conmon_series_t * series;
+		// max_series_per_device of them
+} series_device_t;
+
+/*
+	Devices are stored densely in order of first sample and indexed by a
+	set of instance ids. Nothing is removed, so a device's index in the set
+	is its index here too. Each device has a few series at most, so they
+	are searched linearly.
+ */
+struct conmon_series_store
+{
+	unsigned int max_devices;
+	unsigned int max_series;
+	unsigned int samples_per_series;
+	size_t sample_size;
+	const conmon_series_format_t * format;
+
+	series_device_t * devices;
+	conmon_series_t * series;
+	unsigned int num_devices;
+	dapi_id_map_t * ids;
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE uint64_t
+sample_time (const void * sample)
+{
+	return * (const uint64_t *) sample;
+}
+
+
+static void
+write_csv_string (FILE * fp, const char * s)
+{
+	if (! strpbrk (s, ",\"\r\n"))
+	{
+		fputs (s, fp);
+		return;
+	}
+	fputc ('"', fp);
+	for (; * s; s++)
+	{
+		if (* s == '"')
+		{
+			fputc ('"', fp);
+		}
+		fputc (* s, fp);
+	}
+	fputc ('"', fp);
+}
+
+
+static void
+write_json_string (FILE * fp, const char * s)
+{
+	fputc ('"', fp);
+	for (; * s; s++)
+	{
+		const unsigned char c = (unsigned char) * s;
+		if (c == '"' || c == '\\')
+		{
+			fputc ('\\', fp);
+			fputc (c, fp);
+		}
+		else if (c < 0x20)
+		{
+			fprintf (fp, "\\u%04x", c);
+		}
+		else
+		{
+			fputc (c, fp);
+		}
+	}
+	fputc ('"', fp);
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_series_store_new
+(
+	unsigned int max_devices,
+	unsigned int max_series_per_device,
+	unsigned int samples_per_series,
+	size_t sample_size,
+	const conmon_series_format_t * format,
+	conmon_series_store_t ** store_ptr
+)
+{
+	conmon_series_store_t * store;
+	unsigned int d;
+
+	if (! (max_devices && max_series_per_device && samples_per_series && format && store_ptr)
+		|| max_devices > 0x100000 || max_series_per_device > 0x100 || sample_size < sizeof (uint64_t))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	store = calloc (1, sizeof (* store));
+	if (! store)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	store->devices = calloc (max_devices, sizeof (* store->devices));
+	store->series = calloc (max_devices * max_series_per_device, sizeof (* store->series));
+	dapi_id_map_new (max_devices, 0, & store->ids);
+	if (! (store->devices && store->series && store->ids))
+	{
+		conmon_series_store_delete (store);
+		return AUD_ERR_NOMEMORY;
+	}
+	for (d = 0; d < max_devices; d++)
+	{
+		store->devices [d].series = store->series + d * max_series_per_device;
+	}
+	store->max_devices = max_devices;
+	store->max_series = max_series_per_device;
+	store->samples_per_series = samples_per_series;
+	store->sample_size = sample_size;
+	store->format = format;
+
+	* store_ptr = store;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_series_store_delete
+(
+	conmon_series_store_t * store
+)
+{
+	unsigned int d, s;
+
+	if (! store)
+	{
+		return;
+	}
+	for (d = 0; d < store->num_devices; d++)
+	{
+		for (s = 0; s < store->devices [d].num_series; s++)
+		{
+			conmon_history_delete (store->devices [d].series [s].samples);
+		}
+	}
+	dapi_id_map_delete (store->ids);
+	free (store->series);
+	free (store->devices);
+	free (store);
+}
+
+
+aud_error_t
+conmon_series_store_device
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	unsigned int * device_index
+)
+{
+	series_device_t * device;
+	unsigned int i;
+	aud_bool_t added;
+	aud_error_t result;
+
+	if (! (store && instance_id && device_name && device_index) || strlen (device_name) >= sizeof (device->name))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	// the map holds max_devices ids, so it is full exactly when the device table is
+	result = dapi_id_map_insert (store->ids, instance_id, & i, & added);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	device = store->devices + i;
+	if (added)
+	{
+		store->num_devices++;
+	}
+	// series point at the name, so they follow a rename
+	strcpy (device->name, device_name);
+
+	* device_index = i;
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_series_store_series
+(
+	conmon_series_store_t * store,
+	unsigned int device_index,
+	uint32_t key,
+	conmon_series_t ** series_ptr
+)
+{
+	series_device_t * device = store->devices + device_index;
+	conmon_series_t * series;
+	unsigned int i;
+	aud_error_t result;
+
+	for (i = 0; i < device->num_series; i++)
+	{
+		if (device->series [i].key == key)
+		{
+			* series_ptr = device->series + i;
+			return AUD_SUCCESS;
+		}
+	}
+
+	if (device->num_series >= store->max_series)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	series = device->series + device->num_series;
+	result = conmon_history_new (store->samples_per_series, store->sample_size, & series->samples);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	series->device_name = device->name;
+	series->device_index = device_index;
+	series->key = key;
+	series->attributes = 0;
+	device->num_series++;
+
+	* series_ptr = series;
+	return AUD_SUCCESS;
+}
+
+
+aud_bool_t
+conmon_series_push
+(
+	conmon_series_t * series,
+	uint64_t time_ms,
+	void * prev,
+	void ** sample_ptr
+)
+{
+	const void * newest = conmon_history_newest (series->samples);
+	const size_t sample_size = conmon_history_record_size (series->samples);
+	void * sample;
+
+	if (newest)
+	{
+		memcpy (prev, newest, sample_size);
+	}
+	sample = conmon_history_push (series->samples);
+	memset (sample, 0, sample_size);
+	* (uint64_t *) sample = time_ms;
+
+	* sample_ptr = sample;
+	return (newest != NULL);
+}
+
+
+uint32_t
+conmon_series_counter_delta
+(
+	uint32_t value,
+	uint32_t prev,
+	aud_bool_t * reset
+)
+{
+	if (value < prev)
+	{
+		* reset = AUD_TRUE;
+		return value;
+	}
+	return value - prev;
+}
+
+
+unsigned int
+conmon_series_store_num_devices
+(
+	const conmon_series_store_t * store
+)
+{
+	return store->num_devices;
+}
+
+
+const char *
+conmon_series_store_device_name
+(
+	const conmon_series_store_t * store,
+	unsigned int device_index
+)
+{
+	return (device_index < store->num_devices) ? store->devices [device_index].name : NULL;
+}
+
+
+const conmon_series_t *
+conmon_series_store_series_at_index
+(
+	const conmon_series_store_t * store,
+	unsigned int device_index,
+	unsigned int series_index
+)
+{
+	const series_device_t * device;
+
+	if (device_index >= store->num_devices)
+	{
+		return NULL;
+	}
+	device = store->devices + device_index;
+	return (series_index < device->num_series) ? device->series + series_index : NULL;
+}
+
+
+const conmon_series_t *
+conmon_series_store_find_series
+(
+	const conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	uint32_t key
+)
+{
+	const unsigned int d = dapi_id_map_find (store->ids, instance_id);
+	const series_device_t * device;
+	unsigned int s;
+
+	if (d == DAPI_ID_MAP_NO_ENTRY)
+	{
+		return NULL;
+	}
+	device = store->devices + d;
+	for (s = 0; s < device->num_series; s++)
+	{
+		if (device->series [s].key == key)
+		{
+			return device->series + s;
+		}
+	}
+	return NULL;
+}
+
+
+const void *
+conmon_series_sample_at
+(
+	const conmon_series_t * series,
+	unsigned int index
+)
+{
+	return conmon_history_at (series->samples, index);
+}
+
+
+aud_error_t
+conmon_series_store_write_csv
+(
+	const conmon_series_store_t * store,
+	uint64_t since_ms,
+	FILE * fp
+)
+{
+	const conmon_series_format_t * format = store->format;
+	unsigned int d, s, i;
+
+	fprintf (fp, "time_ms,device%s\n", format->csv_columns);
+	for (d = 0; d < store->num_devices; d++)
+	{
+		const series_device_t * device = store->devices + d;
+		for (s = 0; s < device->num_series; s++)
+		{
+			const conmon_series_t * series = device->series + s;
+			const void * sample;
+
+			for (i = 0; (sample = conmon_history_at (series->samples, i)) != NULL; i++)
+			{
+				if (sample_time (sample) < since_ms)
+				{
+					continue;
+				}
+				fprintf (fp, "%llu,", (unsigned long long) sample_time (sample));
+				write_csv_string (fp, device->name);
+				format->csv_row (fp, series, sample);
+				fputc ('\n', fp);
+			}
+		}
+	}
+	return ferror (fp) ? AUD_ERR_SYSTEM : AUD_SUCCESS;
+}
+
+
+aud_error_t
+conmon_series_store_write_json
+(
+	const conmon_series_store_t * store,
+	uint64_t since_ms,
+	FILE * fp
+)
+{
+	const conmon_series_format_t * format = store->format;
+	unsigned int d, s, i;
+
+	fputs ("{\"devices\":[", fp);
+	for (d = 0; d < store->num_devices; d++)
+	{
+		const series_device_t * device = store->devices + d;
+
+		fputs (d ? ",\n{\"name\":" : "\n{\"name\":", fp);
+		write_json_string (fp, device->name);
+		fprintf (fp, ",\"%s\":[", format->json_series_name);
+		for (s = 0; s < device->num_series; s++)
+		{
+			const conmon_series_t * series = device->series + s;
+			const void * sample;
+			aud_bool_t first = AUD_TRUE;
+
+			fputs (s ? ",{" : "{", fp);
+			format->json_series (fp, series, NULL);
+			fputs (",\"samples\":[", fp);
+			for (i = 0; (sample = conmon_history_at (series->samples, i)) != NULL; i++)
+			{
+				if (sample_time (sample) < since_ms)
+				{
+					continue;
+				}
+				fprintf (fp, "%s{\"time_ms\":%llu", first ? "" : ",", (unsigned long long) sample_time (sample));
+				format->json_sample (fp, series, sample);
+				fputc ('}', fp);
+				first = AUD_FALSE;
+			}
+			fputs ("]}", fp);
+		}
+		fputs ("]}", fp);
+	}
+	fputs ("\n]}\n", fp);
+	return ferror (fp) ? AUD_ERR_SYSTEM : AUD_SUCCESS;
+}
+
+
+//----------
@@ -0,0 +1,219 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Per-device time series of fixed size samples with CSV and JSON export
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_SERIES_STORE_H
+#define _CONMON_SERIES_STORE_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_history.h"
+#include <stdio.h>
+
+
+//----------
+// Types and Constants
+
+/*
+	The store keeps a fixed size history of samples for each series of
+	each device it has been given samples from. A series is whatever the
+	caller polls per device, usually a port, and is named by a key the
+	caller picks. Memory per series is fixed when the series is first
+	seen, so a long running collector does not grow.
+
+	Devices are keyed on their instance id, so a device keeps its history
+	if it is renamed and the store takes the new name. Devices and series
+	are numbered in the order they were first seen and never removed.
+
+	Every sample must start with a uint64_t time_ms field; the store uses
+	it to pick samples for export and writes it as the first column. The
+	rest of each sample is written by the callbacks in the store's format.
+ */
+
+typedef struct conmon_series_store conmon_series_store_t;
+
+typedef struct conmon_series
+{
+	const char * device_name;
+	unsigned int device_index;
+	uint32_t key;
+		// identifies the series within its device
+	uint32_t attributes;
+		// whatever else the caller keeps per series; may change between samples
+	conmon_history_t * samples;
+} conmon_series_t;
+
+// Write the caller's part of a CSV row or JSON object; sample is NULL for a JSON series
+typedef void
+conmon_series_write_fn
+(
+	FILE * fp,
+	const conmon_series_t * series,
+	const void * sample
+);
+
+typedef struct conmon_series_format
+{
+	const char * csv_columns;
+		// the header after "time_ms,device", starting with a comma
+	conmon_series_write_fn * csv_row;
+		// the values after time_ms and device, starting with a comma
+	const char * json_series_name;
+		// of each device's array of series, such as "ports"
+	conmon_series_write_fn * json_series;
+		// the series' fields, without braces
+	conmon_series_write_fn * json_sample;
+		// the fields after time_ms, starting with a comma
+} conmon_series_format_t;
+
+
+//----------
+// Functions
+
+// format must stay valid for the life of the store
+aud_error_t
+conmon_series_store_new
+(
+	unsigned int max_devices,
+	unsigned int max_series_per_device,
+	unsigned int samples_per_series,
+	size_t sample_size,
+	const conmon_series_format_t * format,
+	conmon_series_store_t ** store_ptr
+);
+
+void
+conmon_series_store_delete
+(
+	conmon_series_store_t * store
+);
+
+/*
+	Find a device by instance id, adding it if it is new and renaming it
+	if device_name has changed.
+
+	@return AUD_ERR_NOBUFS if this is a new device and max_devices are already stored,
+	AUD_ERR_INVALIDPARAMETER if the name is too long
+ */
+aud_error_t
+conmon_series_store_device
+(
+	conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	const char * device_name,
+	unsigned int * device_index
+);
+
+/*
+	Find a device's series by key, adding it if it is new.
+
+	@return AUD_ERR_NOBUFS if the device has max_series_per_device already
+ */
+aud_error_t
+conmon_series_store_series
+(
+	conmon_series_store_t * store,
+	unsigned int device_index,
+	uint32_t key,
+	conmon_series_t ** series_ptr
+);
+
+/*
+	Make room for a new newest sample, zeroed apart from its time. The
+	previous newest sample is copied to prev first, as a history of one
+	sample reuses its space.
+
+	@return AUD_TRUE if there was a previous sample
+ */
+aud_bool_t
+conmon_series_push
+(
+	conmon_series_t * series,
+	uint64_t time_ms,
+	void * prev,
+	void ** sample_ptr
+);
+
+/*
+	The change in a cumulative counter since prev. A counter that went
+	backwards was cleared or the device rebooted, so its change is its new
+	value and reset is set; reset is left alone otherwise.
+ */
+uint32_t
+conmon_series_counter_delta
+(
+	uint32_t value,
+	uint32_t prev,
+	aud_bool_t * reset
+);
+
+unsigned int
+conmon_series_store_num_devices
+(
+	const conmon_series_store_t * store
+);
+
+const char *
+conmon_series_store_device_name
+(
+	const conmon_series_store_t * store,
+	unsigned int device_index
+);
+
+// Returns NULL once series_index passes the device's last series
+const conmon_series_t *
+conmon_series_store_series_at_index
+(
+	const conmon_series_store_t * store,
+	unsigned int device_index,
+	unsigned int series_index
+);
+
+// Returns NULL if there is no such series
+const conmon_series_t *
+conmon_series_store_find_series
+(
+	const conmon_series_store_t * store,
+	const conmon_instance_id_t * instance_id,
+	uint32_t key
+);
+
+// Samples run from the oldest (0) to the newest. Returns NULL if index is out of range.
+const void *
+conmon_series_sample_at
+(
+	const conmon_series_t * series,
+	unsigned int index
+);
+
+// One row per sample taken at or after since_ms, with a header row
+aud_error_t
+conmon_series_store_write_csv
+(
+	const conmon_series_store_t * store,
+	uint64_t since_ms,
+	FILE * fp
+);
+
+// Devices, each with its series, each with its samples taken at or after since_ms
+aud_error_t
+conmon_series_store_write_json
+(
+	const conmon_series_store_t * store,
+	uint64_t since_ms,
+	FILE * fp
+);
+
+
+//----------
+
+#endif // _CONMON_SERIES_STORE_H
@@ -0,0 +1,666 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Bring a conmon client's subscriptions in line with a desired set
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_sub_manager.h"
+#include "conmon_examples.h"
+#include "dapi_io.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	SUB_MANAGER_INITIAL_ENTRIES = 64
+};
+
+#define SUB_MANAGER_NO_ENTRY 0xFFFFFFFFu
+
+typedef struct sub_manager_request
+{
+	conmon_client_request_id_t request_id;
+	unsigned int entry;
+} sub_manager_request_t;
+
+struct conmon_sub_manager
+{
+	conmon_client_t * client;
+	conmon_client_response_fn * response_fn;
+
+	// Entries are dense; the index is an open addressed hash table of
+	// entry numbers, at least twice the size of the entry array.
+	conmon_sub_manager_entry_t * entries;
+	uint32_t * entry_hashes;
+	unsigned int num_entries;
+	unsigned int max_entries;
+	uint32_t * slots;
+	unsigned int num_slots;
+
+	// FIFO of entry numbers with a request waiting to be issued
+	unsigned int * queue;
+	unsigned int queue_head;
+	unsigned int queue_len;
+
+	sub_manager_request_t * in_flight;
+	unsigned int num_in_flight;
+	unsigned int max_in_flight;
+
+	unsigned long num_subscribes;
+	unsigned long num_unsubscribes;
+	unsigned long num_failures;
+};
+
+
+//----------
+// Local functions
+
+// The case folded device name hash, mixed with the channel type
+static uint32_t
+entry_hash (conmon_channel_type_t channel_type, const char * device_name)
+{
+	return (dapi_name_hash(device_name) ^ (uint32_t) channel_type) * DAPI_FNV1A_PRIME;
+}
+
+
+static unsigned int
+find_entry
+(
+	const conmon_sub_manager_t * manager,
+	conmon_channel_type_t channel_type,
+	const char * device_name,
+	uint32_t hash
+) {
+	unsigned int mask = manager->num_slots - 1;
+	unsigned int s;
+
+	for (s = hash & mask; manager->slots[s] != SUB_MANAGER_NO_ENTRY; s = (s + 1) & mask)
+	{
+		unsigned int e = manager->slots[s];
+		const conmon_sub_manager_entry_t * entry = manager->entries + e;
+		if (manager->entry_hashes[e] == hash
+			&& entry->channel_type == channel_type
+			&& dapi_name_equals(entry->device_name, device_name))
+		{
+			return e;
+		}
+	}
+	return SUB_MANAGER_NO_ENTRY;
+}
+
+
+static void
+insert_slot (conmon_sub_manager_t * manager, unsigned int e)
+{
+	unsigned int mask = manager->num_slots - 1;
+	unsigned int s;
+
+	for (s = manager->entry_hashes[e] & mask; manager->slots[s] != SUB_MANAGER_NO_ENTRY; s = (s + 1) & mask)
+	{
+		// keep probing
+	}
+	manager->slots[s] = e;
+}
+
+
+static void
+rebuild_slots (conmon_sub_manager_t * manager)
+{
+	unsigned int e;
+	memset(manager->slots, 0xFF, manager->num_slots * sizeof(uint32_t));
+	for (e = 0; e < manager->num_entries; e++)
+	{
+		insert_slot(manager, e);
+	}
+}
+
+
+static aud_error_t
+grow (conmon_sub_manager_t * manager)
+{
+	unsigned int max_entries = manager->max_entries * 2;
+	conmon_sub_manager_entry_t * entries;
+	uint32_t * entry_hashes, * slots;
+	unsigned int * queue;
+
+	entries = realloc(manager->entries, max_entries * sizeof(conmon_sub_manager_entry_t));
+	if (!entries)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	manager->entries = entries;
+
+	entry_hashes = realloc(manager->entry_hashes, max_entries * sizeof(uint32_t));
+	if (!entry_hashes)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	manager->entry_hashes = entry_hashes;
+
+	// the queue can hold every entry at once, so it grows with them
+	queue = malloc(max_entries * sizeof(unsigned int));
+	slots = malloc(max_entries * 2 * sizeof(uint32_t));
+	if (!(queue && slots))
+	{
+		free(queue);
+		free(slots);
+		return AUD_ERR_NOMEMORY;
+	}
+	{
+		unsigned int i;
+		for (i = 0; i < manager->queue_len; i++)
+		{
+			queue[i] = manager->queue[(manager->queue_head + i) % manager->max_entries];
+		}
+		manager->queue_head = 0;
+	}
+	free(manager->queue);
+	manager->queue = queue;
+	free(manager->slots);
+	manager->slots = slots;
+	manager->num_slots = max_entries * 2;
+	manager->max_entries = max_entries;
+	rebuild_slots(manager);
+	return AUD_SUCCESS;
+}
+
+
+static aud_error_t
+find_or_add_entry
+(
+	conmon_sub_manager_t * manager,
+	conmon_channel_type_t channel_type,
+	const char * device_name,
+	unsigned int * entry_ptr
+) {
+	uint32_t hash = entry_hash(channel_type, device_name);
+	unsigned int e = find_entry(manager, channel_type, device_name, hash);
+	conmon_sub_manager_entry_t * entry;
+
+	if (e == SUB_MANAGER_NO_ENTRY)
+	{
+		if (strlen(device_name) >= CONMON_NAME_LENGTH)
+		{
+			return AUD_ERR_RANGE;
+		}
+		if (manager->num_entries == manager->max_entries)
+		{
+			aud_error_t result = grow(manager);
+			if (result != AUD_SUCCESS)
+			{
+				return result;
+			}
+		}
+		e = manager->num_entries++;
+		entry = manager->entries + e;
+		memset(entry, 0, sizeof(*entry));
+		entry->channel_type = channel_type;
+		SNPRINTF(entry->device_name, CONMON_NAME_LENGTH, "%s", device_name);
+		entry->rxstatus = CONMON_RXSTATUS_NONE;
+		entry->pending = CONMON_SUB_MANAGER_OP_NONE;
+		entry->next = CONMON_SUB_MANAGER_OP_NONE;
+		entry->last_error = AUD_SUCCESS;
+		manager->entry_hashes[e] = hash;
+		insert_slot(manager, e);
+	}
+	*entry_ptr = e;
+	return AUD_SUCCESS;
+}
+
+
+/*
+	Drop entries that are neither wanted nor subscribed. Entry numbers are
+	held by the queue and in-flight requests, so only do this when idle.
+ */
+static void
+compact_entries (conmon_sub_manager_t * manager)
+{
+	unsigned int e = 0, n = 0;
+
+	if (conmon_sub_manager_busy(manager))
+	{
+		return;
+	}
+	for (e = 0; e < manager->num_entries; e++)
+	{
+		const conmon_sub_manager_entry_t * entry = manager->entries + e;
+		if (entry->desired || entry->subscribed)
+		{
+			if (n != e)
+			{
+				manager->entries[n] = *entry;
+				manager->entry_hashes[n] = manager->entry_hashes[e];
+			}
+			n++;
+		}
+	}
+	if (n != manager->num_entries)
+	{
+		manager->num_entries = n;
+		rebuild_slots(manager);
+	}
+}
+
+
+// What a sync that found the entry's request still pending wants done once it completes
+static conmon_sub_manager_op_t
+next_op (const conmon_sub_manager_entry_t * entry)
+{
+	aud_bool_t will_be_subscribed = (entry->pending == CONMON_SUB_MANAGER_OP_SUBSCRIBE);
+
+	if (entry->desired && !will_be_subscribed)
+	{
+		return CONMON_SUB_MANAGER_OP_SUBSCRIBE;
+	}
+	if (!entry->desired && will_be_subscribed)
+	{
+		return CONMON_SUB_MANAGER_OP_UNSUBSCRIBE;
+	}
+	return CONMON_SUB_MANAGER_OP_NONE;
+}
+
+
+static void
+queue_op (conmon_sub_manager_t * manager, unsigned int e, conmon_sub_manager_op_t op)
+{
+	manager->entries[e].pending = op;
+	manager->queue[(manager->queue_head + manager->queue_len) % manager->max_entries] = e;
+	manager->queue_len++;
+}
+
+
+/*
+	A failed request leaves the entry for the next sync to retry. After a
+	successful one, anything a sync decided while it was pending is queued,
+	so an entry dropped from the desired set mid-flight is not left behind.
+	The entry is not in the queue while its request is out, so it fits.
+ */
+static void
+complete_op (conmon_sub_manager_t * manager, unsigned int e, aud_error_t result)
+{
+	conmon_sub_manager_entry_t * entry = manager->entries + e;
+	conmon_sub_manager_op_t next = entry->next;
+
+	entry->last_error = result;
+	entry->next = CONMON_SUB_MANAGER_OP_NONE;
+	if (result == AUD_SUCCESS)
+	{
+		entry->subscribed = (entry->pending == CONMON_SUB_MANAGER_OP_SUBSCRIBE);
+		if (!entry->subscribed)
+		{
+			entry->rxstatus = CONMON_RXSTATUS_NONE;
+		}
+	}
+	else
+	{
+		manager->num_failures++;
+		next = CONMON_SUB_MANAGER_OP_NONE;
+	}
+	entry->pending = CONMON_SUB_MANAGER_OP_NONE;
+	if (next != CONMON_SUB_MANAGER_OP_NONE)
+	{
+		queue_op(manager, e, next);
+	}
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_sub_manager_new
+(
+	conmon_client_t * client,
+	conmon_client_response_fn * response_fn,
+	unsigned int max_in_flight,
+	conmon_sub_manager_t ** manager_ptr
+) {
+	conmon_sub_manager_t * manager;
+
+	if (!(client && response_fn && max_in_flight && manager_ptr))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	manager = calloc(1, sizeof(conmon_sub_manager_t));
+	if (!manager)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	manager->client = client;
+	manager->response_fn = response_fn;
+	manager->max_in_flight = max_in_flight;
+	manager->max_entries = SUB_MANAGER_INITIAL_ENTRIES;
+	manager->num_slots = SUB_MANAGER_INITIAL_ENTRIES * 2;
+	manager->entries = malloc(manager->max_entries * sizeof(conmon_sub_manager_entry_t));
+	manager->entry_hashes = malloc(manager->max_entries * sizeof(uint32_t));
+	manager->queue = malloc(manager->max_entries * sizeof(unsigned int));
+	manager->slots = malloc(manager->num_slots * sizeof(uint32_t));
+	manager->in_flight = malloc(max_in_flight * sizeof(sub_manager_request_t));
+	if (!(manager->entries && manager->entry_hashes && manager->queue && manager->slots && manager->in_flight))
+	{
+		conmon_sub_manager_delete(manager);
+		return AUD_ERR_NOMEMORY;
+	}
+	rebuild_slots(manager);
+
+	*manager_ptr = manager;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_sub_manager_delete
+(
+	conmon_sub_manager_t * manager
+) {
+	if (manager)
+	{
+		free(manager->entries);
+		free(manager->entry_hashes);
+		free(manager->queue);
+		free(manager->slots);
+		free(manager->in_flight);
+		free(manager);
+	}
+}
+
+
+void
+conmon_sub_manager_clear_desired
+(
+	conmon_sub_manager_t * manager
+) {
+	unsigned int e;
+	for (e = 0; e < manager->num_entries; e++)
+	{
+		manager->entries[e].desired = AUD_FALSE;
+	}
+}
+
+
+aud_error_t
+conmon_sub_manager_add_desired
+(
+	conmon_sub_manager_t * manager,
+	conmon_channel_type_t channel_type,
+	const char * device_name
+) {
+	unsigned int e;
+	aud_error_t result;
+
+	if (!device_name || !device_name[0]
+		|| channel_type == CONMON_CHANNEL_TYPE_NONE
+		|| channel_type == CONMON_CHANNEL_TYPE_CONTROL)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	result = find_or_add_entry(manager, channel_type, device_name, &e);
+	if (result == AUD_SUCCESS)
+	{
+		manager->entries[e].desired = AUD_TRUE;
+	}
+	return result;
+}
+
+
+aud_error_t
+conmon_sub_manager_sync
+(
+	conmon_sub_manager_t * manager,
+	unsigned int * num_queued
+) {
+	uint16_t i, max = conmon_client_max_subscriptions(manager->client);
+	unsigned int e, queued = 0;
+
+	compact_entries(manager);
+
+	// entries with a request outstanding keep their state until it completes
+	for (e = 0; e < manager->num_entries; e++)
+	{
+		conmon_sub_manager_entry_t * entry = manager->entries + e;
+		if (entry->pending == CONMON_SUB_MANAGER_OP_NONE)
+		{
+			entry->subscribed = AUD_FALSE;
+			entry->rxstatus = CONMON_RXSTATUS_NONE;
+		}
+	}
+
+	for (i = 0; i < max; i++)
+	{
+		const conmon_client_subscription_t * sub = conmon_client_subscription_at_index(manager->client, i);
+		const char * device_name;
+		conmon_sub_manager_entry_t * entry;
+		aud_error_t result;
+
+		if (!sub)
+		{
+			continue;
+		}
+		device_name = conmon_client_subscription_get_device_name(sub);
+		if (!device_name || !device_name[0])
+		{
+			// global subscription
+			continue;
+		}
+		result = find_or_add_entry(manager, conmon_client_subscription_get_channel_type(sub), device_name, &e);
+		if (result != AUD_SUCCESS)
+		{
+			return result;
+		}
+		entry = manager->entries + e;
+		if (entry->pending == CONMON_SUB_MANAGER_OP_NONE)
+		{
+			entry->subscribed = AUD_TRUE;
+		}
+		entry->rxstatus = conmon_client_subscription_get_rxstatus(sub);
+	}
+
+	for (e = 0; e < manager->num_entries; e++)
+	{
+		conmon_sub_manager_entry_t * entry = manager->entries + e;
+		if (entry->pending != CONMON_SUB_MANAGER_OP_NONE)
+		{
+			entry->next = next_op(entry);
+			continue;
+		}
+		if (entry->desired && !entry->subscribed)
+		{
+			queue_op(manager, e, CONMON_SUB_MANAGER_OP_SUBSCRIBE);
+			queued++;
+		}
+		else if (!entry->desired && entry->subscribed)
+		{
+			queue_op(manager, e, CONMON_SUB_MANAGER_OP_UNSUBSCRIBE);
+			queued++;
+		}
+	}
+
+	if (num_queued)
+	{
+		*num_queued = queued;
+	}
+	return conmon_sub_manager_process(manager);
+}
+
+
+aud_error_t
+conmon_sub_manager_process
+(
+	conmon_sub_manager_t * manager
+) {
+	while (manager->queue_len && manager->num_in_flight < manager->max_in_flight)
+	{
+		unsigned int e = manager->queue[manager->queue_head];
+		conmon_sub_manager_entry_t * entry = manager->entries + e;
+		conmon_client_request_id_t req_id = CONMON_CLIENT_NULL_REQ_ID;
+		aud_error_t result;
+
+		manager->queue_head = (manager->queue_head + 1) % manager->max_entries;
+		manager->queue_len--;
+
+		if (entry->pending == CONMON_SUB_MANAGER_OP_SUBSCRIBE)
+		{
+			result = conmon_client_subscribe(manager->client, manager->response_fn, &req_id,
+				entry->channel_type, entry->device_name);
+			manager->num_subscribes++;
+		}
+		else
+		{
+			result = conmon_client_unsubscribe(manager->client, manager->response_fn, &req_id,
+				entry->channel_type, entry->device_name);
+			manager->num_unsubscribes++;
+		}
+
+		if (result == AUD_ERR_NOBUFS)
+		{
+			// the client is out of request slots, try again once some complete
+			manager->queue_head = (manager->queue_head + manager->max_entries - 1) % manager->max_entries;
+			manager->queue_len++;
+			if (entry->pending == CONMON_SUB_MANAGER_OP_SUBSCRIBE)
+			{
+				manager->num_subscribes--;
+			}
+			else
+			{
+				manager->num_unsubscribes--;
+			}
+			break;
+		}
+		if (result != AUD_SUCCESS)
+		{
+			complete_op(manager, e, result);
+			continue;
+		}
+		if (req_id == CONMON_CLIENT_NULL_REQ_ID)
+		{
+			// completed immediately, no response will follow
+			complete_op(manager, e, AUD_SUCCESS);
+			continue;
+		}
+		manager->in_flight[manager->num_in_flight].request_id = req_id;
+		manager->in_flight[manager->num_in_flight].entry = e;
+		manager->num_in_flight++;
+	}
+	return AUD_SUCCESS;
+}
+
+
+aud_bool_t
+conmon_sub_manager_busy
+(
+	const conmon_sub_manager_t * manager
+) {
+	return (manager->queue_len || manager->num_in_flight) ? AUD_TRUE : AUD_FALSE;
+}
+
+
+aud_bool_t
+conmon_sub_manager_handle_response
+(
+	conmon_sub_manager_t * manager,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+) {
+	unsigned int r;
+
+	for (r = 0; r < manager->num_in_flight; r++)
+	{
+		if (manager->in_flight[r].request_id == request_id)
+		{
+			complete_op(manager, manager->in_flight[r].entry, result);
+			manager->in_flight[r] = manager->in_flight[--manager->num_in_flight];
+			return AUD_TRUE;
+		}
+	}
+	return AUD_FALSE;
+}
+
+
+void
+conmon_sub_manager_handle_subscriptions_changed
+(
+	conmon_sub_manager_t * manager,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+) {
+	unsigned int i;
+
+	for (i = 0; i < num_changes; i++)
+	{
+		const conmon_client_subscription_t * sub = changes[i];
+		conmon_channel_type_t channel_type = conmon_client_subscription_get_channel_type(sub);
+		const char * device_name = conmon_client_subscription_get_device_name(sub);
+		unsigned int e;
+
+		if (!device_name || !device_name[0])
+		{
+			continue;
+		}
+		e = find_entry(manager, channel_type, device_name, entry_hash(channel_type, device_name));
+		if (e != SUB_MANAGER_NO_ENTRY)
+		{
+			manager->entries[e].rxstatus = conmon_client_subscription_get_rxstatus(sub);
+		}
+	}
+}
+
+
+const conmon_sub_manager_entry_t *
+conmon_sub_manager_lookup
+(
+	const conmon_sub_manager_t * manager,
+	conmon_channel_type_t channel_type,
+	const char * device_name
+) {
+	unsigned int e = find_entry(manager, channel_type, device_name, entry_hash(channel_type, device_name));
+	return (e == SUB_MANAGER_NO_ENTRY) ? NULL : manager->entries + e;
+}
+
+
+const conmon_sub_manager_entry_t *
+conmon_sub_manager_entry_at_index
+(
+	const conmon_sub_manager_t * manager,
+	unsigned int index
+) {
+	return (index < manager->num_entries) ? manager->entries + index : NULL;
+}
+
+
+void
+conmon_sub_manager_get_stats
+(
+	const conmon_sub_manager_t * manager,
+	conmon_sub_manager_stats_t * stats
+) {
+	unsigned int e;
+
+	stats->num_entries = manager->num_entries;
+	stats->num_desired = 0;
+	for (e = 0; e < manager->num_entries; e++)
+	{
+		if (manager->entries[e].desired)
+		{
+			stats->num_desired++;
+		}
+	}
+	stats->num_queued = manager->queue_len;
+	stats->num_in_flight = manager->num_in_flight;
+	stats->num_subscribes = manager->num_subscribes;
+	stats->num_unsubscribes = manager->num_unsubscribes;
+	stats->num_failures = manager->num_failures;
+}
+
+
+//----------
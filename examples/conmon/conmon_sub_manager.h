@@ -0,0 +1,197 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Bring a conmon client's subscriptions in line with a desired set
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_SUB_MANAGER_H
+#define _CONMON_SUB_MANAGER_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The subscription manager keeps a table of (channel type, device name)
+	pairs, indexed by a hash of the pair. Each entry records whether the
+	subscription is wanted, whether the client currently has it and the last
+	rxstatus reported for it.
+
+	conmon_sub_manager_sync compares the desired set against the client's
+	current subscriptions and queues a subscribe or unsubscribe for every
+	difference. conmon_sub_manager_process then keeps up to max_in_flight of
+	those requests outstanding at once rather than waiting for each response
+	in turn. An entry whose request is still out when a sync runs is
+	compared again once the request succeeds, and the correction is queued
+	then.
+
+	The manager does not own any conmon client callbacks. The application
+	passes the manager's requests a response function of its choosing, which
+	must hand the response to conmon_sub_manager_handle_response, and must
+	forward subscription changes to conmon_sub_manager_handle_subscriptions_changed.
+
+	Global (all device) subscriptions are left alone.
+ */
+
+typedef struct conmon_sub_manager conmon_sub_manager_t;
+
+typedef enum conmon_sub_manager_op
+{
+	CONMON_SUB_MANAGER_OP_NONE = 0,
+	CONMON_SUB_MANAGER_OP_SUBSCRIBE,
+	CONMON_SUB_MANAGER_OP_UNSUBSCRIBE
+} conmon_sub_manager_op_t;
+
+typedef struct conmon_sub_manager_entry
+{
+	conmon_channel_type_t channel_type;
+	conmon_name_t device_name;
+	aud_bool_t desired;
+	aud_bool_t subscribed;
+	conmon_rxstatus_t rxstatus;
+	conmon_sub_manager_op_t pending;
+		// queued or in flight
+	conmon_sub_manager_op_t next;
+		// queued once pending succeeds, as decided by a sync that ran while it was out
+	aud_error_t last_error;
+		// result of the most recent request for this entry
+} conmon_sub_manager_entry_t;
+
+typedef struct conmon_sub_manager_stats
+{
+	unsigned int num_entries;
+	unsigned int num_desired;
+	unsigned int num_queued;
+	unsigned int num_in_flight;
+	unsigned long num_subscribes;
+	unsigned long num_unsubscribes;
+	unsigned long num_failures;
+} conmon_sub_manager_stats_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_sub_manager_new
+(
+	conmon_client_t * client,
+	conmon_client_response_fn * response_fn,
+	unsigned int max_in_flight,
+	conmon_sub_manager_t ** manager_ptr
+);
+
+void
+conmon_sub_manager_delete
+(
+	conmon_sub_manager_t * manager
+);
+
+// Forget the desired set. Nothing changes until the next sync.
+void
+conmon_sub_manager_clear_desired
+(
+	conmon_sub_manager_t * manager
+);
+
+aud_error_t
+conmon_sub_manager_add_desired
+(
+	conmon_sub_manager_t * manager,
+	conmon_channel_type_t channel_type,
+	const char * device_name
+);
+
+/*
+	Compare the desired set with the client's subscriptions and queue the
+	requests needed to make them match. Requests already queued or in flight
+	are not repeated.
+
+	@return the number of requests queued by this call in num_queued
+ */
+aud_error_t
+conmon_sub_manager_sync
+(
+	conmon_sub_manager_t * manager,
+	unsigned int * num_queued
+);
+
+/*
+	Issue queued requests until max_in_flight are outstanding. Call this
+	whenever the client has processed responses.
+ */
+aud_error_t
+conmon_sub_manager_process
+(
+	conmon_sub_manager_t * manager
+);
+
+// True while requests are queued or in flight
+aud_bool_t
+conmon_sub_manager_busy
+(
+	const conmon_sub_manager_t * manager
+);
+
+/*
+	Match a response to one of the manager's requests.
+
+	@return AUD_TRUE if the request belonged to the manager
+ */
+aud_bool_t
+conmon_sub_manager_handle_response
+(
+	conmon_sub_manager_t * manager,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+);
+
+void
+conmon_sub_manager_handle_subscriptions_changed
+(
+	conmon_sub_manager_t * manager,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+);
+
+// Returns NULL if the pair is neither desired nor subscribed
+const conmon_sub_manager_entry_t *
+conmon_sub_manager_lookup
+(
+	const conmon_sub_manager_t * manager,
+	conmon_channel_type_t channel_type,
+	const char * device_name
+);
+
+/*
+	Entries are stored densely, so index runs from 0 to num_entries - 1.
+	Adding or removing entries may reorder them.
+ */
+const conmon_sub_manager_entry_t *
+conmon_sub_manager_entry_at_index
+(
+	const conmon_sub_manager_t * manager,
+	unsigned int index
+);
+
+void
+conmon_sub_manager_get_stats
+(
+	const conmon_sub_manager_t * manager,
+	conmon_sub_manager_stats_t * stats
+);
+
+
+//----------
+
+#endif // _CONMON_SUB_MANAGER_H
@@ -0,0 +1,588 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Minimal read-only TFTP server for serving a single firmware file
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_tftp_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#define TFTP_INVALID_SOCKET INVALID_SOCKET
+#define TFTP_CLOSE_SOCKET closesocket
+#define TFTP_STRCASECMP _stricmp
+typedef int tftp_addrlen_t;
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <strings.h>
+#define TFTP_INVALID_SOCKET (-1)
+#define TFTP_CLOSE_SOCKET close
+#define TFTP_STRCASECMP strcasecmp
+typedef socklen_t tftp_addrlen_t;
+#endif
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	TFTP_OP_RRQ = 1,
+	TFTP_OP_WRQ = 2,
+	TFTP_OP_DATA = 3,
+	TFTP_OP_ACK = 4,
+	TFTP_OP_ERROR = 5
+};
+
+enum
+{
+	TFTP_ERROR_UNDEFINED = 0,
+	TFTP_ERROR_FILE_NOT_FOUND = 1,
+	TFTP_ERROR_ILLEGAL_OPERATION = 4,
+	TFTP_ERROR_UNKNOWN_TID = 5
+};
+
+enum
+{
+	TFTP_HEADER_SIZE = 4,
+	TFTP_MAX_PACKET = TFTP_HEADER_SIZE + CONMON_TFTP_BLOCK_SIZE
+};
+
+typedef struct tftp_transfer
+{
+	aud_socket_t sock;
+		// TFTP_INVALID_SOCKET if the slot is free
+	struct sockaddr_in peer;
+	uint32_t block;
+		// block in flight, counting from 1; only the low 16 bits go on the wire
+	unsigned int retransmits;
+	uint64_t sent_ms;
+} tftp_transfer_t;
+
+struct conmon_tftp_server
+{
+	uint8_t * data;
+	uint32_t size;
+	char name [256];
+	uint16_t port;
+
+	aud_socket_t sock;
+	tftp_transfer_t * transfers;
+	unsigned int max_transfers;
+	unsigned int num_active;
+
+	unsigned long num_requests;
+	unsigned long num_refused;
+	unsigned long num_completed;
+	unsigned long num_failed;
+	unsigned long num_retransmits;
+	uint64_t bytes_sent;
+};
+
+
+//----------
+// Local functions
+
+static aud_socket_t
+open_socket (uint16_t port)
+{
+	struct sockaddr_in addr;
+	aud_socket_t sock = socket (AF_INET, SOCK_DGRAM, 0);
+
+	if (sock == TFTP_INVALID_SOCKET)
+	{
+		return sock;
+	}
+	memset (& addr, 0, sizeof (addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl (INADDR_ANY);
+	addr.sin_port = htons (port);
+	if (bind (sock, (struct sockaddr *) & addr, sizeof (addr)) != 0)
+	{
+		TFTP_CLOSE_SOCKET (sock);
+		return TFTP_INVALID_SOCKET;
+	}
+	return sock;
+}
+
+
+static void
+send_error
+(
+	aud_socket_t sock,
+	const struct sockaddr_in * peer,
+	uint16_t code,
+	const char * message
+)
+{
+	uint8_t packet [128];
+	const size_t len = strlen (message);
+
+	packet [0] = 0;
+	packet [1] = TFTP_OP_ERROR;
+	packet [2] = (uint8_t) (code >> 8);
+	packet [3] = (uint8_t) code;
+	memcpy (packet + 4, message, len + 1);
+	sendto (sock, (const char *) packet, (int) (4 + len + 1), 0, (const struct sockaddr *) peer, sizeof (* peer));
+}
+
+
+AUD_INLINE uint32_t
+block_length (const conmon_tftp_server_t * server, uint32_t block)
+{
+	const uint32_t offset = (block - 1) * CONMON_TFTP_BLOCK_SIZE;
+	const uint32_t remaining = server->size - offset;
+	return (remaining < CONMON_TFTP_BLOCK_SIZE) ? remaining : CONMON_TFTP_BLOCK_SIZE;
+}
+
+
+static void
+send_block
+(
+	conmon_tftp_server_t * server,
+	tftp_transfer_t * transfer,
+	uint64_t now_ms
+)
+{
+	uint8_t packet [TFTP_MAX_PACKET];
+	const uint32_t len = block_length (server, transfer->block);
+
+	packet [0] = 0;
+	packet [1] = TFTP_OP_DATA;
+	packet [2] = (uint8_t) (transfer->block >> 8);
+	packet [3] = (uint8_t) transfer->block;
+	memcpy (packet + TFTP_HEADER_SIZE, server->data + (transfer->block - 1) * CONMON_TFTP_BLOCK_SIZE, len);
+	sendto (transfer->sock, (const char *) packet, (int) (TFTP_HEADER_SIZE + len), 0,
+		(const struct sockaddr *) & transfer->peer, sizeof (transfer->peer));
+	transfer->sent_ms = now_ms;
+	server->bytes_sent += len;
+}
+
+
+static void
+end_transfer
+(
+	conmon_tftp_server_t * server,
+	tftp_transfer_t * transfer,
+	aud_bool_t completed
+)
+{
+	TFTP_CLOSE_SOCKET (transfer->sock);
+	transfer->sock = TFTP_INVALID_SOCKET;
+	server->num_active--;
+	if (completed)
+	{
+		server->num_completed++;
+	}
+	else
+	{
+		server->num_failed++;
+	}
+}
+
+
+static void
+handle_request
+(
+	conmon_tftp_server_t * server,
+	uint64_t now_ms
+)
+{
+	uint8_t packet [TFTP_MAX_PACKET + 1];
+	struct sockaddr_in peer;
+	tftp_addrlen_t peer_len = sizeof (peer);
+	const char * filename;
+	const char * mode;
+	tftp_transfer_t * transfer = NULL;
+	unsigned int i;
+	int len;
+
+	len = recvfrom (server->sock, (char *) packet, TFTP_MAX_PACKET, 0, (struct sockaddr *) & peer, & peer_len);
+	if (len < TFTP_HEADER_SIZE || packet [0] != 0)
+	{
+		return;
+	}
+	if (packet [1] != TFTP_OP_RRQ)
+	{
+		send_error (server->sock, & peer, TFTP_ERROR_ILLEGAL_OPERATION, "read requests only");
+		return;
+	}
+	server->num_requests++;
+
+	// filename and mode are both NUL terminated; make sure a bad packet can't run off the end
+	packet [len] = 0;
+	filename = (const char *) packet + 2;
+	mode = filename + strlen (filename) + 1;
+	if (mode >= (const char *) packet + len || TFTP_STRCASECMP (mode, "octet"))
+	{
+		server->num_refused++;
+		send_error (server->sock, & peer, TFTP_ERROR_ILLEGAL_OPERATION, "octet mode only");
+		return;
+	}
+	while (* filename == '/')
+	{
+		filename++;
+	}
+	if (strcmp (filename, server->name))
+	{
+		server->num_refused++;
+		send_error (server->sock, & peer, TFTP_ERROR_FILE_NOT_FOUND, "file not found");
+		return;
+	}
+
+	for (i = 0; i < server->max_transfers; i++)
+	{
+		if (server->transfers [i].sock == TFTP_INVALID_SOCKET)
+		{
+			transfer = server->transfers + i;
+			break;
+		}
+	}
+	if (! transfer || (transfer->sock = open_socket (0)) == TFTP_INVALID_SOCKET)
+	{
+		// the device will ask again when its own request times out
+		server->num_refused++;
+		send_error (server->sock, & peer, TFTP_ERROR_UNDEFINED, "server busy");
+		return;
+	}
+
+	transfer->peer = peer;
+	transfer->block = 1;
+	transfer->retransmits = 0;
+	server->num_active++;
+	send_block (server, transfer, now_ms);
+}
+
+
+static void
+handle_transfer
+(
+	conmon_tftp_server_t * server,
+	tftp_transfer_t * transfer,
+	uint64_t now_ms
+)
+{
+	uint8_t packet [TFTP_MAX_PACKET];
+	struct sockaddr_in peer;
+	tftp_addrlen_t peer_len = sizeof (peer);
+	int len;
+
+	len = recvfrom (transfer->sock, (char *) packet, sizeof (packet), 0, (struct sockaddr *) & peer, & peer_len);
+	if (len < TFTP_HEADER_SIZE)
+	{
+		return;
+	}
+	if (peer.sin_addr.s_addr != transfer->peer.sin_addr.s_addr || peer.sin_port != transfer->peer.sin_port)
+	{
+		send_error (transfer->sock, & peer, TFTP_ERROR_UNKNOWN_TID, "unknown transfer id");
+		return;
+	}
+	if (packet [0] != 0 || packet [1] == TFTP_OP_ERROR)
+	{
+		end_transfer (server, transfer, AUD_FALSE);
+		return;
+	}
+	if (packet [1] != TFTP_OP_ACK
+		|| (uint16_t) ((packet [2] << 8) | packet [3]) != (uint16_t) transfer->block)
+	{
+		// duplicate ACKs are ignored rather than answered, to avoid the sorcerer's apprentice problem
+		return;
+	}
+
+	// a block shorter than the block size, possibly empty, marks the end of the file
+	if (block_length (server, transfer->block) < CONMON_TFTP_BLOCK_SIZE)
+	{
+		end_transfer (server, transfer, AUD_TRUE);
+		return;
+	}
+	transfer->block++;
+	transfer->retransmits = 0;
+	send_block (server, transfer, now_ms);
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_tftp_server_new
+(
+	const char * path,
+	const char * served_name,
+	uint16_t port,
+	unsigned int max_transfers,
+	conmon_tftp_server_t ** server_ptr
+)
+{
+	conmon_tftp_server_t * server;
+	FILE * fp;
+	long size;
+	unsigned int i;
+
+	if (! (path && server_ptr && max_transfers))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	if (! served_name)
+	{
+		const char * slash = strrchr (path, '/');
+#ifdef WIN32
+		const char * backslash = strrchr (path, '\\');
+		if (backslash > slash)
+		{
+			slash = backslash;
+		}
+#endif
+		served_name = slash ? slash + 1 : path;
+	}
+	if (! * served_name || strlen (served_name) >= sizeof (server->name))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	server = calloc (1, sizeof (* server));
+	if (! server)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	server->sock = TFTP_INVALID_SOCKET;
+	strcpy (server->name, served_name);
+	server->port = port ? port : CONMON_TFTP_DEFAULT_PORT;
+
+	server->transfers = calloc (max_transfers, sizeof (* server->transfers));
+	if (! server->transfers)
+	{
+		conmon_tftp_server_delete (server);
+		return AUD_ERR_NOMEMORY;
+	}
+	server->max_transfers = max_transfers;
+	for (i = 0; i < max_transfers; i++)
+	{
+		server->transfers [i].sock = TFTP_INVALID_SOCKET;
+	}
+
+	fp = fopen (path, "rb");
+	if (! fp)
+	{
+		conmon_tftp_server_delete (server);
+		return AUD_ERR_NOTFOUND;
+	}
+	fseek (fp, 0, SEEK_END);
+	size = ftell (fp);
+	fseek (fp, 0, SEEK_SET);
+	// 16 bit block numbers roll over, but keep to files a device could sensibly take
+	if (size <= 0 || size > 0x40000000)
+	{
+		fclose (fp);
+		conmon_tftp_server_delete (server);
+		return AUD_ERR_RANGE;
+	}
+	server->data = malloc ((size_t) size);
+	if (! server->data || fread (server->data, 1, (size_t) size, fp) != (size_t) size)
+	{
+		fclose (fp);
+		conmon_tftp_server_delete (server);
+		return server->data ? AUD_ERR_SYSTEM : AUD_ERR_NOMEMORY;
+	}
+	fclose (fp);
+	server->size = (uint32_t) size;
+
+	server->sock = open_socket (server->port);
+	if (server->sock == TFTP_INVALID_SOCKET)
+	{
+		conmon_tftp_server_delete (server);
+		return AUD_ERR_SYSTEM;
+	}
+
+	* server_ptr = server;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_tftp_server_delete
+(
+	conmon_tftp_server_t * server
+)
+{
+	unsigned int i;
+
+	if (! server)
+	{
+		return;
+	}
+	for (i = 0; i < server->max_transfers; i++)
+	{
+		if (server->transfers [i].sock != TFTP_INVALID_SOCKET)
+		{
+			TFTP_CLOSE_SOCKET (server->transfers [i].sock);
+		}
+	}
+	if (server->sock != TFTP_INVALID_SOCKET)
+	{
+		TFTP_CLOSE_SOCKET (server->sock);
+	}
+	free (server->transfers);
+	free (server->data);
+	free (server);
+}
+
+
+const char *
+conmon_tftp_server_file_name
+(
+	const conmon_tftp_server_t * server
+)
+{
+	return server->name;
+}
+
+
+uint32_t
+conmon_tftp_server_file_size
+(
+	const conmon_tftp_server_t * server
+)
+{
+	return server->size;
+}
+
+
+uint16_t
+conmon_tftp_server_port
+(
+	const conmon_tftp_server_t * server
+)
+{
+	return server->port;
+}
+
+
+void
+conmon_tftp_server_add_sockets
+(
+	const conmon_tftp_server_t * server,
+	dante_sockets_t * sockets
+)
+{
+	unsigned int i;
+
+	dante_sockets_add_read (sockets, server->sock);
+	for (i = 0; i < server->max_transfers; i++)
+	{
+		if (server->transfers [i].sock != TFTP_INVALID_SOCKET)
+		{
+			dante_sockets_add_read (sockets, server->transfers [i].sock);
+		}
+	}
+}
+
+
+void
+conmon_tftp_server_process
+(
+	conmon_tftp_server_t * server,
+	const dante_sockets_t * ready,
+	uint64_t now_ms
+)
+{
+	unsigned int i;
+
+	if (ready && FD_ISSET (server->sock, & ready->read_fds))
+	{
+		handle_request (server, now_ms);
+	}
+	for (i = 0; i < server->max_transfers; i++)
+	{
+		tftp_transfer_t * transfer = server->transfers + i;
+
+		if (transfer->sock == TFTP_INVALID_SOCKET)
+		{
+			continue;
+		}
+		if (ready && FD_ISSET (transfer->sock, & ready->read_fds))
+		{
+			handle_transfer (server, transfer, now_ms);
+			if (transfer->sock == TFTP_INVALID_SOCKET)
+			{
+				continue;
+			}
+		}
+		if (now_ms - transfer->sent_ms >= CONMON_TFTP_RETRANSMIT_MS)
+		{
+			if (transfer->retransmits >= CONMON_TFTP_MAX_RETRANSMITS)
+			{
+				end_transfer (server, transfer, AUD_FALSE);
+				continue;
+			}
+			transfer->retransmits++;
+			server->num_retransmits++;
+			send_block (server, transfer, now_ms);
+		}
+	}
+}
+
+
+unsigned int
+conmon_tftp_server_ms_to_next
+(
+	const conmon_tftp_server_t * server,
+	uint64_t now_ms
+)
+{
+	unsigned int ms = CONMON_TFTP_RETRANSMIT_MS;
+	unsigned int i;
+
+	for (i = 0; i < server->max_transfers; i++)
+	{
+		const tftp_transfer_t * transfer = server->transfers + i;
+		uint64_t elapsed;
+
+		if (transfer->sock == TFTP_INVALID_SOCKET)
+		{
+			continue;
+		}
+		elapsed = now_ms - transfer->sent_ms;
+		if (elapsed >= CONMON_TFTP_RETRANSMIT_MS)
+		{
+			return 0;
+		}
+		if (CONMON_TFTP_RETRANSMIT_MS - elapsed < ms)
+		{
+			ms = (unsigned int) (CONMON_TFTP_RETRANSMIT_MS - elapsed);
+		}
+	}
+	return ms;
+}
+
+
+void
+conmon_tftp_server_get_stats
+(
+	const conmon_tftp_server_t * server,
+	conmon_tftp_server_stats_t * stats
+)
+{
+	stats->num_active = server->num_active;
+	stats->num_requests = server->num_requests;
+	stats->num_refused = server->num_refused;
+	stats->num_completed = server->num_completed;
+	stats->num_failed = server->num_failed;
+	stats->num_retransmits = server->num_retransmits;
+	stats->bytes_sent = server->bytes_sent;
+}
+
+
+//----------
@@ -0,0 +1,136 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Minimal read-only TFTP server for serving a single firmware file
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_TFTP_SERVER_H
+#define _CONMON_TFTP_SERVER_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	A stand-in for a real file server when upgrading from a workstation.
+	It answers read requests (RFC 1350, octet mode, 512 byte blocks, no
+	options) for one file, which is loaded into memory once and can be
+	sent to up to max_transfers devices at the same time. Each transfer
+	uses its own socket. Requests for any other file are refused.
+
+	The server is driven from the caller's select loop: add its sockets to
+	the read set with conmon_tftp_server_add_sockets before each select,
+	then call conmon_tftp_server_process with the ready set. Unacknowledged
+	blocks are sent again every CONMON_TFTP_RETRANSMIT_MS, up to
+	CONMON_TFTP_MAX_RETRANSMITS times.
+ */
+
+enum
+{
+	CONMON_TFTP_DEFAULT_PORT = 69,
+	CONMON_TFTP_BLOCK_SIZE = 512,
+	CONMON_TFTP_RETRANSMIT_MS = 1000,
+	CONMON_TFTP_MAX_RETRANSMITS = 5
+};
+
+typedef struct conmon_tftp_server conmon_tftp_server_t;
+
+typedef struct conmon_tftp_server_stats
+{
+	unsigned int num_active;
+	unsigned long num_requests;
+	unsigned long num_refused;
+	unsigned long num_completed;
+	unsigned long num_failed;
+	unsigned long num_retransmits;
+	uint64_t bytes_sent;
+} conmon_tftp_server_stats_t;
+
+
+//----------
+// Functions
+
+/*
+	Load the file at path and start listening on port (0 for the default).
+	Devices request it as served_name, or as the last component of path if
+	served_name is NULL.
+ */
+aud_error_t
+conmon_tftp_server_new
+(
+	const char * path,
+	const char * served_name,
+	uint16_t port,
+	unsigned int max_transfers,
+	conmon_tftp_server_t ** server_ptr
+);
+
+void
+conmon_tftp_server_delete
+(
+	conmon_tftp_server_t * server
+);
+
+const char *
+conmon_tftp_server_file_name
+(
+	const conmon_tftp_server_t * server
+);
+
+uint32_t
+conmon_tftp_server_file_size
+(
+	const conmon_tftp_server_t * server
+);
+
+uint16_t
+conmon_tftp_server_port
+(
+	const conmon_tftp_server_t * server
+);
+
+void
+conmon_tftp_server_add_sockets
+(
+	const conmon_tftp_server_t * server,
+	dante_sockets_t * sockets
+);
+
+// Handle whatever is readable in ready (which may be NULL) and retransmit as needed
+void
+conmon_tftp_server_process
+(
+	conmon_tftp_server_t * server,
+	const dante_sockets_t * ready,
+	uint64_t now_ms
+);
+
+// Milliseconds until the next retransmission is due, or CONMON_TFTP_RETRANSMIT_MS if idle
+unsigned int
+conmon_tftp_server_ms_to_next
+(
+	const conmon_tftp_server_t * server,
+	uint64_t now_ms
+);
+
+void
+conmon_tftp_server_get_stats
+(
+	const conmon_tftp_server_t * server,
+	conmon_tftp_server_stats_t * stats
+);
+
+
+//----------
+
+#endif // _CONMON_TFTP_SERVER_H
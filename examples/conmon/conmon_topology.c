@@ -0,0 +1,631 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Model device interfaces, links and redundancy from interface status messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_topology.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+#define TOPOLOGY_NO_ENTRY 0xFFFFFFFFu
+
+/*
+	Devices are stored densely in order of first status and found through an
+	id set. Nothing is ever removed, so the set's index for an instance id
+	is also its device index. The address table holds interface rows,
+	numbered device index * CONMON_TOPOLOGY_MAX_INTERFACES + interface,
+	keyed on the row's current IP address; addresses used by several
+	interfaces simply sit in the same probe run, which is why it is not an
+	id map. The bitmaps have one bit per device index.
+ */
+struct conmon_topology
+{
+	conmon_topology_change_fn * change_fn;
+	void * change_context;
+
+	conmon_topology_device_t * devices;
+	unsigned int num_devices;
+	dapi_id_map_t * index;
+
+	uint32_t * addresses;
+	uint32_t address_mask;
+
+	uint32_t num_words;
+	uint32_t * bits;
+		// one allocation holding all of the bitmaps below
+	uint32_t * link_down_bits [CONMON_TOPOLOGY_MAX_INTERFACES];
+	uint32_t * redundancy_bits [CONMON_NUM_TOPOLOGY_REDUNDANCY];
+
+	unsigned int num_in_redundancy [CONMON_NUM_TOPOLOGY_REDUNDANCY];
+	unsigned int num_link_down [CONMON_TOPOLOGY_MAX_INTERFACES];
+	unsigned long num_updates;
+	unsigned long num_changes;
+};
+
+
+//----------
+// Local functions
+
+AUD_INLINE void
+set_bit (uint32_t * bits, unsigned int i, aud_bool_t on)
+{
+	if (on)
+	{
+		bits [i >> 5] |= (uint32_t) 1 << (i & 31);
+	}
+	else
+	{
+		bits [i >> 5] &= ~((uint32_t) 1 << (i & 31));
+	}
+}
+
+
+AUD_INLINE uint32_t
+row_ip (const conmon_topology_t * topology, uint32_t row)
+{
+	return topology->devices [row / CONMON_TOPOLOGY_MAX_INTERFACES]
+		.interfaces [row % CONMON_TOPOLOGY_MAX_INTERFACES].ip_address;
+}
+
+
+static void
+add_address (conmon_topology_t * topology, uint32_t row)
+{
+	uint32_t slot = dapi_hash_mix64 (row_ip (topology, row)) & topology->address_mask;
+
+	while (topology->addresses [slot] != TOPOLOGY_NO_ENTRY)
+	{
+		slot = (slot + 1) & topology->address_mask;
+	}
+	topology->addresses [slot] = row;
+}
+
+
+// The row must still hold the address it was added with
+static void
+remove_address (conmon_topology_t * topology, uint32_t row)
+{
+	const uint32_t mask = topology->address_mask;
+	uint32_t hole = dapi_hash_mix64 (row_ip (topology, row)) & mask;
+	uint32_t slot;
+
+	while (topology->addresses [hole] != row)
+	{
+		if (topology->addresses [hole] == TOPOLOGY_NO_ENTRY)
+		{
+			return;
+		}
+		hole = (hole + 1) & mask;
+	}
+
+	// shift back any later entry in the run whose home slot is not between the hole and itself
+	for (slot = (hole + 1) & mask; topology->addresses [slot] != TOPOLOGY_NO_ENTRY; slot = (slot + 1) & mask)
+	{
+		const uint32_t home = dapi_hash_mix64 (row_ip (topology, topology->addresses [slot])) & mask;
+		if (((slot - home) & mask) >= ((slot - hole) & mask))
+		{
+			topology->addresses [hole] = topology->addresses [slot];
+			hole = slot;
+		}
+	}
+	topology->addresses [hole] = TOPOLOGY_NO_ENTRY;
+}
+
+
+static conmon_topology_redundancy_t
+redundancy_of (const conmon_aud_decoded_interface_status_t * status)
+{
+	if (status->mode == CONMON_AUDINATE_INTERFACE_MODE_SWITCHED
+		&& (status->flags & CONMON_AUDINATE_INTERFACES_SWITCH_REDUNDANCY))
+	{
+		return CONMON_TOPOLOGY_REDUNDANCY_SWITCH;
+	}
+	if (status->mode == CONMON_AUDINATE_INTERFACE_MODE_DIRECT && status->num_interfaces >= 2)
+	{
+		return CONMON_TOPOLOGY_REDUNDANCY_DUAL;
+	}
+	return CONMON_TOPOLOGY_REDUNDANCY_NONE;
+}
+
+
+static void
+set_link_down (conmon_topology_t * topology, unsigned int device_index, uint16_t interface, aud_bool_t down)
+{
+	set_bit (topology->link_down_bits [interface], device_index, down);
+	if (down)
+	{
+		topology->num_link_down [interface]++;
+	}
+	else
+	{
+		topology->num_link_down [interface]--;
+	}
+}
+
+
+// Bring a stored interface up to date with a decoded one and return what changed
+static unsigned int
+apply_interface
+(
+	conmon_topology_t * topology,
+	unsigned int device_index,
+	uint16_t interface,
+	const conmon_aud_decoded_interface_t * in,
+	aud_bool_t is_new,
+	uint64_t now_ms
+)
+{
+	conmon_topology_interface_t * out = topology->devices [device_index].interfaces + interface;
+	const uint32_t row = (uint32_t) device_index * CONMON_TOPOLOGY_MAX_INTERFACES + interface;
+	const aud_bool_t link_up = (in->flags & CONMON_AUDINATE_INTERFACE_FLAG_UP) && in->link_speed;
+	unsigned int changes = 0;
+
+	if (is_new)
+	{
+		memset (out, 0, sizeof (* out));
+		out->link_up = AUD_TRUE;
+		out->link_since_ms = now_ms;
+		changes = CONMON_TOPOLOGY_CHANGE_NEW;
+	}
+	else
+	{
+		if (out->link_speed != in->link_speed)
+		{
+			changes |= CONMON_TOPOLOGY_CHANGE_SPEED;
+		}
+		if (out->ip_address != in->ip_address || out->netmask != in->netmask
+			|| out->gateway != in->gateway
+			|| memcmp (out->mac_address, in->mac_address, sizeof (out->mac_address)))
+		{
+			changes |= CONMON_TOPOLOGY_CHANGE_ADDRESS;
+		}
+		if ((out->flags ^ in->flags) & ~CONMON_AUDINATE_INTERFACE_FLAG_UP)
+		{
+			changes |= CONMON_TOPOLOGY_CHANGE_FLAGS;
+		}
+	}
+
+	if (link_up != out->link_up)
+	{
+		if (! is_new)
+		{
+			changes |= CONMON_TOPOLOGY_CHANGE_LINK;
+			out->link_since_ms = now_ms;
+			out->num_link_changes++;
+		}
+		set_link_down (topology, device_index, interface, ! link_up);
+		out->link_up = link_up;
+	}
+
+	if (out->ip_address != in->ip_address || is_new)
+	{
+		if (out->ip_address && ! is_new)
+		{
+			remove_address (topology, row);
+		}
+		out->ip_address = in->ip_address;
+		if (out->ip_address)
+		{
+			add_address (topology, row);
+		}
+	}
+	out->flags = in->flags;
+	out->link_speed = in->link_speed;
+	memcpy (out->mac_address, in->mac_address, sizeof (out->mac_address));
+	out->netmask = in->netmask;
+	out->gateway = in->gateway;
+	return changes;
+}
+
+
+static void
+remove_interface (conmon_topology_t * topology, unsigned int device_index, uint16_t interface)
+{
+	conmon_topology_interface_t * out = topology->devices [device_index].interfaces + interface;
+
+	if (out->ip_address)
+	{
+		remove_address (topology, (uint32_t) device_index * CONMON_TOPOLOGY_MAX_INTERFACES + interface);
+	}
+	if (! out->link_up)
+	{
+		set_link_down (topology, device_index, interface, AUD_FALSE);
+	}
+	memset (out, 0, sizeof (* out));
+}
+
+
+// Write the set bits of a bitmap as indexes, returning how many there are
+static unsigned int
+collect_bits
+(
+	const conmon_topology_t * topology,
+	const uint32_t * bits,
+	const uint32_t * mask_a,
+	const uint32_t * mask_b,
+	unsigned int * indexes,
+	unsigned int max
+)
+{
+	unsigned int n = 0;
+	uint32_t k;
+
+	for (k = 0; k < topology->num_words; k++)
+	{
+		uint32_t w = bits [k];
+		unsigned int i;
+
+		if (mask_a)
+		{
+			w &= mask_a [k] | mask_b [k];
+		}
+		for (i = k * 32; w; i++, w >>= 1)
+		{
+			if (w & 1)
+			{
+				if (n < max)
+				{
+					indexes [n] = i;
+				}
+				n++;
+			}
+		}
+	}
+	return n;
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_topology_new
+(
+	unsigned int max_devices,
+	conmon_topology_change_fn * change_fn,
+	void * change_context,
+	conmon_topology_t ** topology_ptr
+)
+{
+	conmon_topology_t * topology;
+	uint32_t address_size = 1;
+	unsigned int i;
+
+	if (! topology_ptr || ! max_devices || max_devices > 0x1000000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (address_size < 2 * max_devices * CONMON_TOPOLOGY_MAX_INTERFACES)
+	{
+		address_size <<= 1;
+	}
+
+	topology = calloc (1, sizeof (* topology));
+	if (! topology)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	topology->num_words = (max_devices + 31) / 32;
+	topology->devices = malloc (max_devices * sizeof (* topology->devices));
+	topology->addresses = malloc (address_size * sizeof (uint32_t));
+	topology->bits = calloc (
+		(CONMON_TOPOLOGY_MAX_INTERFACES + CONMON_NUM_TOPOLOGY_REDUNDANCY) * topology->num_words, sizeof (uint32_t));
+	if (! (topology->devices && topology->addresses && topology->bits)
+		|| dapi_id_map_new (max_devices, 0, & topology->index) != AUD_SUCCESS)
+	{
+		conmon_topology_delete (topology);
+		return AUD_ERR_NOMEMORY;
+	}
+	// 0xFF bytes give TOPOLOGY_NO_ENTRY in every slot
+	memset (topology->addresses, 0xFF, address_size * sizeof (uint32_t));
+
+	for (i = 0; i < CONMON_TOPOLOGY_MAX_INTERFACES; i++)
+	{
+		topology->link_down_bits [i] = topology->bits + i * topology->num_words;
+	}
+	for (i = 0; i < CONMON_NUM_TOPOLOGY_REDUNDANCY; i++)
+	{
+		topology->redundancy_bits [i] = topology->bits + (CONMON_TOPOLOGY_MAX_INTERFACES + i) * topology->num_words;
+	}
+
+	topology->change_fn = change_fn;
+	topology->change_context = change_context;
+	topology->address_mask = address_size - 1;
+
+	* topology_ptr = topology;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_topology_delete
+(
+	conmon_topology_t * topology
+)
+{
+	if (topology)
+	{
+		free (topology->bits);
+		free (topology->addresses);
+		dapi_id_map_delete (topology->index);
+		free (topology->devices);
+		free (topology);
+	}
+}
+
+
+aud_error_t
+conmon_topology_update
+(
+	conmon_topology_t * topology,
+	const conmon_instance_id_t * instance_id,
+	const conmon_aud_decoded_interface_status_t * status,
+	uint64_t now_ms
+)
+{
+	conmon_topology_device_t * device;
+	conmon_topology_device_t previous;
+	conmon_topology_redundancy_t redundancy;
+	conmon_topology_change_t change;
+	unsigned int changes [CONMON_TOPOLOGY_MAX_INTERFACES];
+	unsigned int device_changes = 0;
+	unsigned int device_index;
+	uint16_t i, kept;
+	aud_bool_t added;
+
+	if (! (topology && instance_id && status))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+
+	if (dapi_id_map_insert (topology->index, instance_id, & device_index, & added) != AUD_SUCCESS)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+	if (added)
+	{
+		topology->num_devices++;
+		device = topology->devices + device_index;
+		memset (device, 0, sizeof (* device));
+		device->instance_id = * instance_id;
+		device_changes = CONMON_TOPOLOGY_CHANGE_NEW;
+	}
+	device = topology->devices + device_index;
+	previous = * device;
+	topology->num_updates++;
+
+	redundancy = redundancy_of (status);
+	if (device_changes)
+	{
+		topology->num_in_redundancy [redundancy]++;
+		set_bit (topology->redundancy_bits [redundancy], device_index, AUD_TRUE);
+	}
+	else
+	{
+		if (status->mode != device->mode || status->flags != device->flags || redundancy != device->redundancy)
+		{
+			device_changes |= CONMON_TOPOLOGY_CHANGE_MODE;
+		}
+		if (status->num_interfaces != device->num_interfaces)
+		{
+			device_changes |= CONMON_TOPOLOGY_CHANGE_INTERFACES;
+		}
+		if (redundancy != device->redundancy)
+		{
+			topology->num_in_redundancy [device->redundancy]--;
+			set_bit (topology->redundancy_bits [device->redundancy], device_index, AUD_FALSE);
+			topology->num_in_redundancy [redundancy]++;
+			set_bit (topology->redundancy_bits [redundancy], device_index, AUD_TRUE);
+		}
+	}
+
+	kept = status->interfaces_decoded;
+	if (kept > CONMON_TOPOLOGY_MAX_INTERFACES)
+	{
+		kept = CONMON_TOPOLOGY_MAX_INTERFACES;
+	}
+	for (i = 0; i < CONMON_TOPOLOGY_MAX_INTERFACES; i++)
+	{
+		changes [i] = 0;
+		if (i < kept)
+		{
+			changes [i] = apply_interface (topology, device_index, i, status->interfaces + i,
+				i >= previous.interfaces_kept, now_ms);
+		}
+		else if (i < previous.interfaces_kept)
+		{
+			remove_interface (topology, device_index, i);
+		}
+	}
+
+	device->mode = status->mode;
+	device->flags = status->flags;
+	device->redundancy = redundancy;
+	device->num_interfaces = status->num_interfaces;
+	device->interfaces_kept = kept;
+	device->last_update_ms = now_ms;
+
+	memset (& change, 0, sizeof (change));
+	change.device = device;
+	change.previous = & previous;
+	change.device_index = device_index;
+	change.now_ms = now_ms;
+	for (i = 0; i <= CONMON_TOPOLOGY_MAX_INTERFACES; i++)
+	{
+		// the device as a whole first, then each interface
+		change.interface = i ? (uint16_t) (i - 1) : CONMON_TOPOLOGY_DEVICE;
+		change.changes = i ? changes [i - 1] : device_changes;
+		if (! change.changes)
+		{
+			continue;
+		}
+		device->num_changes++;
+		topology->num_changes++;
+		if (topology->change_fn)
+		{
+			topology->change_fn (topology->change_context, & change);
+		}
+	}
+	return AUD_SUCCESS;
+}
+
+
+const conmon_topology_device_t *
+conmon_topology_device_at_index
+(
+	const conmon_topology_t * topology,
+	unsigned int index
+)
+{
+	if (! topology || index >= topology->num_devices)
+	{
+		return NULL;
+	}
+	return topology->devices + index;
+}
+
+
+const conmon_topology_device_t *
+conmon_topology_find
+(
+	const conmon_topology_t * topology,
+	const conmon_instance_id_t * instance_id
+)
+{
+	unsigned int i;
+
+	if (! (topology && instance_id))
+	{
+		return NULL;
+	}
+	i = dapi_id_map_find (topology->index, instance_id);
+	return (i == DAPI_ID_MAP_NO_ENTRY) ? NULL : topology->devices + i;
+}
+
+
+unsigned int
+conmon_topology_find_link_down
+(
+	const conmon_topology_t * topology,
+	unsigned int interface,
+	aud_bool_t redundant_only,
+	unsigned int * device_indexes,
+	unsigned int max
+)
+{
+	if (! topology || interface >= CONMON_TOPOLOGY_MAX_INTERFACES)
+	{
+		return 0;
+	}
+	if (redundant_only)
+	{
+		return collect_bits (topology, topology->link_down_bits [interface],
+			topology->redundancy_bits [CONMON_TOPOLOGY_REDUNDANCY_DUAL],
+			topology->redundancy_bits [CONMON_TOPOLOGY_REDUNDANCY_SWITCH],
+			device_indexes, max);
+	}
+	return collect_bits (topology, topology->link_down_bits [interface], NULL, NULL, device_indexes, max);
+}
+
+
+unsigned int
+conmon_topology_find_redundancy
+(
+	const conmon_topology_t * topology,
+	conmon_topology_redundancy_t redundancy,
+	unsigned int * device_indexes,
+	unsigned int max
+)
+{
+	if (! topology || (unsigned int) redundancy >= CONMON_NUM_TOPOLOGY_REDUNDANCY)
+	{
+		return 0;
+	}
+	return collect_bits (topology, topology->redundancy_bits [redundancy], NULL, NULL, device_indexes, max);
+}
+
+
+unsigned int
+conmon_topology_find_address
+(
+	const conmon_topology_t * topology,
+	uint32_t ip_address,
+	conmon_topology_address_t * found,
+	unsigned int max
+)
+{
+	uint32_t slot, row;
+	unsigned int n = 0;
+
+	if (! topology || ! ip_address)
+	{
+		return 0;
+	}
+	slot = dapi_hash_mix64 (ip_address) & topology->address_mask;
+	while ((row = topology->addresses [slot]) != TOPOLOGY_NO_ENTRY)
+	{
+		if (row_ip (topology, row) == ip_address)
+		{
+			if (n < max)
+			{
+				found [n].device_index = row / CONMON_TOPOLOGY_MAX_INTERFACES;
+				found [n].interface = (uint16_t) (row % CONMON_TOPOLOGY_MAX_INTERFACES);
+			}
+			n++;
+		}
+		slot = (slot + 1) & topology->address_mask;
+	}
+	return n;
+}
+
+
+void
+conmon_topology_get_summary
+(
+	const conmon_topology_t * topology,
+	conmon_topology_summary_t * summary
+)
+{
+	if (! (topology && summary))
+	{
+		return;
+	}
+	summary->num_devices = topology->num_devices;
+	memcpy (summary->num_in_redundancy, topology->num_in_redundancy, sizeof (summary->num_in_redundancy));
+	memcpy (summary->num_link_down, topology->num_link_down, sizeof (summary->num_link_down));
+	summary->num_updates = topology->num_updates;
+	summary->num_changes = topology->num_changes;
+}
+
+
+const char *
+conmon_topology_redundancy_to_string
+(
+	conmon_topology_redundancy_t redundancy
+)
+{
+	switch (redundancy)
+	{
+	case CONMON_TOPOLOGY_REDUNDANCY_NONE:   return "NONE";
+	case CONMON_TOPOLOGY_REDUNDANCY_DUAL:   return "DUAL";
+	case CONMON_TOPOLOGY_REDUNDANCY_SWITCH: return "SWITCH";
+	default:                                return "???";
+	}
+}
+
+
+//----------
@@ -0,0 +1,261 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Model device interfaces, links and redundancy from interface status messages
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_TOPOLOGY_H
+#define _CONMON_TOPOLOGY_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+#include "conmon_aud_decode_msg.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The topology keeps the last interface status from each device: its
+	interface mode, the redundancy that mode gives it, and for each
+	interface the flags, link speed and addresses. Interface 0 is the
+	primary and interface 1 the secondary.
+
+	Each new status is compared with the stored one and only what differs
+	is reported, one change per device and one per interface, so a venue
+	full of devices resending unchanged status costs a compare per
+	interface and no output.
+
+	Alongside the device table the topology keeps indexes that are updated
+	as changes are applied, so the common audit questions are answered
+	without walking every device:
+	- a bitmap per interface number of the devices whose link is down,
+	  combined with a bitmap of redundant devices for "secondary link down
+	  on a redundant device";
+	- a bitmap per redundancy mode;
+	- a hash table from IP address to interfaces, which also finds
+	  addresses used by more than one interface.
+
+	A link is up when the interface is flagged UP and has a link speed.
+	Times are supplied by the caller in milliseconds from any monotonic
+	clock.
+ */
+
+enum
+{
+	CONMON_TOPOLOGY_MAX_INTERFACES = 4
+		// interfaces kept per device; more are counted but not stored
+};
+
+#define CONMON_TOPOLOGY_DEVICE 0xFFFFu
+	// the interface number of a change to the device as a whole
+
+typedef struct conmon_topology conmon_topology_t;
+
+typedef enum conmon_topology_redundancy
+{
+	CONMON_TOPOLOGY_REDUNDANCY_NONE = 0,
+	CONMON_TOPOLOGY_REDUNDANCY_DUAL,
+		// DIRECT mode with separate primary and secondary interfaces
+	CONMON_TOPOLOGY_REDUNDANCY_SWITCH,
+		// SWITCHED mode with switch redundancy on
+	CONMON_NUM_TOPOLOGY_REDUNDANCY
+} conmon_topology_redundancy_t;
+
+enum
+{
+	CONMON_TOPOLOGY_CHANGE_NEW = 0x01,
+		// the first status from the device
+	CONMON_TOPOLOGY_CHANGE_MODE = 0x02,
+		// the interface mode or the redundancy flags
+	CONMON_TOPOLOGY_CHANGE_INTERFACES = 0x04,
+		// the number of interfaces
+	CONMON_TOPOLOGY_CHANGE_LINK = 0x08,
+	CONMON_TOPOLOGY_CHANGE_SPEED = 0x10,
+	CONMON_TOPOLOGY_CHANGE_ADDRESS = 0x20,
+		// IP address, netmask or gateway
+	CONMON_TOPOLOGY_CHANGE_FLAGS = 0x40
+		// interface flags other than UP
+};
+
+typedef struct conmon_topology_interface
+{
+	uint16_t flags;
+	uint32_t link_speed;
+	uint8_t mac_address [6];
+	uint32_t ip_address;
+	uint32_t netmask;
+	uint32_t gateway;
+	aud_bool_t link_up;
+	uint64_t link_since_ms;
+		// when the link last went up or down, or was first seen
+	unsigned long num_link_changes;
+} conmon_topology_interface_t;
+
+typedef struct conmon_topology_device
+{
+	conmon_instance_id_t instance_id;
+	uint16_t mode;
+	conmon_audinate_interfaces_flags_t flags;
+	conmon_topology_redundancy_t redundancy;
+	uint16_t num_interfaces;
+		// as reported by the device
+	uint16_t interfaces_kept;
+	conmon_topology_interface_t interfaces [CONMON_TOPOLOGY_MAX_INTERFACES];
+	uint64_t last_update_ms;
+	unsigned long num_changes;
+} conmon_topology_device_t;
+
+typedef struct conmon_topology_change
+{
+	const conmon_topology_device_t * device;
+		// state after the whole status has been applied
+	const conmon_topology_device_t * previous;
+		// state before it, all zero for a new device
+	unsigned int device_index;
+	uint16_t interface;
+		// CONMON_TOPOLOGY_DEVICE for mode and interface count changes
+	unsigned int changes;
+		// CONMON_TOPOLOGY_CHANGE_* bits
+	uint64_t now_ms;
+} conmon_topology_change_t;
+
+// Called for each device, then each interface, that a status changed
+typedef void
+conmon_topology_change_fn
+(
+	void * context,
+	const conmon_topology_change_t * change
+);
+
+// One interface using an address
+typedef struct conmon_topology_address
+{
+	unsigned int device_index;
+	uint16_t interface;
+} conmon_topology_address_t;
+
+typedef struct conmon_topology_summary
+{
+	unsigned int num_devices;
+	unsigned int num_in_redundancy [CONMON_NUM_TOPOLOGY_REDUNDANCY];
+	unsigned int num_link_down [CONMON_TOPOLOGY_MAX_INTERFACES];
+		// devices with that interface present and its link down
+	unsigned long num_updates;
+	unsigned long num_changes;
+} conmon_topology_summary_t;
+
+
+//----------
+// Functions
+
+aud_error_t
+conmon_topology_new
+(
+	unsigned int max_devices,
+	conmon_topology_change_fn * change_fn,
+	void * change_context,
+	conmon_topology_t ** topology_ptr
+);
+
+void
+conmon_topology_delete
+(
+	conmon_topology_t * topology
+);
+
+/*
+	Apply an interface status from a device and report what changed.
+
+	@return AUD_ERR_NOBUFS if this is a new device and max_devices are already tracked
+ */
+aud_error_t
+conmon_topology_update
+(
+	conmon_topology_t * topology,
+	const conmon_instance_id_t * instance_id,
+	const conmon_aud_decoded_interface_status_t * status,
+	uint64_t now_ms
+);
+
+// Devices are never removed, so index runs from 0 to num_devices - 1 in order of first status
+const conmon_topology_device_t *
+conmon_topology_device_at_index
+(
+	const conmon_topology_t * topology,
+	unsigned int index
+);
+
+// NULL if the device has sent no interface status
+const conmon_topology_device_t *
+conmon_topology_find
+(
+	const conmon_topology_t * topology,
+	const conmon_instance_id_t * instance_id
+);
+
+/*
+	Find the devices that have the given interface with its link down, in
+	device index order, or only those with redundancy if redundant_only is
+	set: interface 1 with redundant_only finds every redundant device that
+	has lost its secondary link.
+
+	Up to max indexes are written to device_indexes (which may be NULL if
+	max is 0).
+
+	@return the number of devices found, which may be more than max
+ */
+unsigned int
+conmon_topology_find_link_down
+(
+	const conmon_topology_t * topology,
+	unsigned int interface,
+	aud_bool_t redundant_only,
+	unsigned int * device_indexes,
+	unsigned int max
+);
+
+// As conmon_topology_find_link_down, for the devices with a redundancy mode
+unsigned int
+conmon_topology_find_redundancy
+(
+	const conmon_topology_t * topology,
+	conmon_topology_redundancy_t redundancy,
+	unsigned int * device_indexes,
+	unsigned int max
+);
+
+// As conmon_topology_find_link_down, for the interfaces using an IP address
+unsigned int
+conmon_topology_find_address
+(
+	const conmon_topology_t * topology,
+	uint32_t ip_address,
+	conmon_topology_address_t * found,
+	unsigned int max
+);
+
+void
+conmon_topology_get_summary
+(
+	const conmon_topology_t * topology,
+	conmon_topology_summary_t * summary
+);
+
+const char *
+conmon_topology_redundancy_to_string
+(
+	conmon_topology_redundancy_t redundancy
+);
+
+
+//----------
+
+#endif // _CONMON_TOPOLOGY_H
@@ -0,0 +1,621 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Report link, speed, address and redundancy changes across all devices
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_name_cache.h"
+#include "conmon_topology.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	TOPOLOGY_NAME_CACHE_SIZE = 2048,
+	TOPOLOGY_DEFAULT_MAX_DEVICES = 1024,
+	TOPOLOGY_MAX_LISTED = 4096
+		// devices listed per line of the audit
+};
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static conmon_topology_t * g_topology = NULL;
+static conmon_name_cache_t * g_names = NULL;
+static aud_bool_t g_full_reported = AUD_FALSE;
+static aud_bool_t g_show_new = AUD_FALSE;
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_ms (void)
+{
+	return conmon_example_clock_ns () / 1000000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+static const char *
+device_name (const conmon_instance_id_t * instance_id)
+{
+	const char * name = conmon_name_cache_lookup (g_names, instance_id)->device_name;
+	return name ? name : "[unknown device]";
+}
+
+
+static const char *
+mode_to_string (uint16_t mode)
+{
+	switch (mode)
+	{
+	case CONMON_AUDINATE_INTERFACE_MODE_DIRECT:   return "DIRECT";
+	case CONMON_AUDINATE_INTERFACE_MODE_SWITCHED: return "SWITCHED";
+	default:                                      return "???";
+	}
+}
+
+
+// Addresses are held in network order, as in the message
+static char *
+ip_to_string (uint32_t ip, char * buf, size_t len)
+{
+	const uint8_t * b = (const uint8_t *) & ip;
+	SNPRINTF (buf, len, "%u.%u.%u.%u", b[0], b[1], b[2], b[3]);
+	return buf;
+}
+
+
+static const char *
+interface_role (uint16_t interface)
+{
+	return (interface == 0) ? "primary" : (interface == 1) ? "secondary" : "interface";
+}
+
+
+static void
+handle_topology_change
+(
+	void * context,
+	const conmon_topology_change_t * change
+)
+{
+	const conmon_topology_device_t * device = change->device;
+	const char * name = device_name (& device->instance_id);
+	aud_ctime_buf_t time_buf;
+	const char * time = aud_utime_ctime_no_newline (NULL, time_buf);
+
+	AUD_UNUSED (context);
+
+	if (change->interface == CONMON_TOPOLOGY_DEVICE)
+	{
+		const conmon_topology_device_t * previous = change->previous;
+
+		if (change->changes & CONMON_TOPOLOGY_CHANGE_NEW)
+		{
+			if (g_show_new)
+			{
+				printf ("#NEW %s: '%s' %s, redundancy %s, %u interfaces\n"
+					, time, name, mode_to_string (device->mode)
+					, conmon_topology_redundancy_to_string (device->redundancy), device->num_interfaces
+				);
+			}
+			return;
+		}
+		if (change->changes & CONMON_TOPOLOGY_CHANGE_MODE)
+		{
+			printf ("#MODE %s: '%s' %s -> %s, redundancy %s -> %s\n"
+				, time, name
+				, mode_to_string (previous->mode), mode_to_string (device->mode)
+				, conmon_topology_redundancy_to_string (previous->redundancy)
+				, conmon_topology_redundancy_to_string (device->redundancy)
+			);
+		}
+		if (change->changes & CONMON_TOPOLOGY_CHANGE_INTERFACES)
+		{
+			printf ("#INTERFACES %s: '%s' %u -> %u interfaces\n"
+				, time, name, previous->num_interfaces, device->num_interfaces
+			);
+		}
+	}
+	else
+	{
+		const conmon_topology_interface_t * now = device->interfaces + change->interface;
+		const conmon_topology_interface_t * was = change->previous->interfaces + change->interface;
+		char was_buf [32], now_buf [32];
+
+		if (change->changes & CONMON_TOPOLOGY_CHANGE_NEW)
+		{
+			if (g_show_new && ! now->link_up)
+			{
+				printf ("#LINK %s: '%s' %s %u is DOWN\n"
+					, time, name, interface_role (change->interface), change->interface
+				);
+			}
+			return;
+		}
+		if (change->changes & CONMON_TOPOLOGY_CHANGE_LINK)
+		{
+			printf ("#LINK %s: '%s' %s %u is %s after %u s %s\n"
+				, time, name, interface_role (change->interface), change->interface
+				, now->link_up ? "UP" : "DOWN"
+				, (unsigned int) ((change->now_ms - was->link_since_ms) / 1000)
+				, was->link_up ? "up" : "down"
+			);
+		}
+		if ((change->changes & CONMON_TOPOLOGY_CHANGE_SPEED) && now->link_up && was->link_up)
+		{
+			printf ("#SPEED %s: '%s' %s %u %u -> %u\n"
+				, time, name, interface_role (change->interface), change->interface
+				, was->link_speed, now->link_speed
+			);
+		}
+		if (change->changes & CONMON_TOPOLOGY_CHANGE_ADDRESS)
+		{
+			printf ("#ADDRESS %s: '%s' %s %u %s -> %s\n"
+				, time, name, interface_role (change->interface), change->interface
+				, ip_to_string (was->ip_address, was_buf, sizeof (was_buf))
+				, ip_to_string (now->ip_address, now_buf, sizeof (now_buf))
+			);
+		}
+	}
+	fflush (stdout);
+}
+
+
+static void
+print_device_list (const char * heading, const unsigned int * indexes, unsigned int n)
+{
+	unsigned int i;
+
+	printf ("#AUDIT %s: %u\n", heading, n);
+	if (n > TOPOLOGY_MAX_LISTED)
+	{
+		n = TOPOLOGY_MAX_LISTED;
+	}
+	for (i = 0; i < n; i++)
+	{
+		const conmon_topology_device_t * device = conmon_topology_device_at_index (g_topology, indexes [i]);
+		printf ("  %s\n", device_name (& device->instance_id));
+	}
+}
+
+
+static void
+print_audit (aud_bool_t full)
+{
+	static unsigned int indexes [TOPOLOGY_MAX_LISTED];
+	const conmon_topology_device_t * device;
+	conmon_topology_summary_t summary;
+	unsigned int d, n;
+	uint16_t i;
+
+	conmon_topology_get_summary (g_topology, & summary);
+	printf ("#SUMMARY %u devices: %u dual, %u switch and %u without redundancy; "
+		"%u primary and %u secondary links down; %lu updates, %lu changes\n"
+		, summary.num_devices
+		, summary.num_in_redundancy [CONMON_TOPOLOGY_REDUNDANCY_DUAL]
+		, summary.num_in_redundancy [CONMON_TOPOLOGY_REDUNDANCY_SWITCH]
+		, summary.num_in_redundancy [CONMON_TOPOLOGY_REDUNDANCY_NONE]
+		, summary.num_link_down [0], summary.num_link_down [1]
+		, summary.num_updates, summary.num_changes
+	);
+	if (! full)
+	{
+		return;
+	}
+
+	n = conmon_topology_find_link_down (g_topology, 0, AUD_FALSE, indexes, TOPOLOGY_MAX_LISTED);
+	print_device_list ("primary link down", indexes, n);
+	n = conmon_topology_find_link_down (g_topology, 1, AUD_TRUE, indexes, TOPOLOGY_MAX_LISTED);
+	print_device_list ("redundant devices with secondary link down", indexes, n);
+	n = conmon_topology_find_redundancy (g_topology, CONMON_TOPOLOGY_REDUNDANCY_NONE, indexes, TOPOLOGY_MAX_LISTED);
+	print_device_list ("devices without redundancy", indexes, n);
+
+	printf ("#AUDIT speed mismatches and shared addresses:\n");
+	for (d = 0; (device = conmon_topology_device_at_index (g_topology, d)) != NULL; d++)
+	{
+		const conmon_topology_interface_t * ifs = device->interfaces;
+
+		if (device->redundancy == CONMON_TOPOLOGY_REDUNDANCY_DUAL && device->interfaces_kept >= 2
+			&& ifs[0].link_up && ifs[1].link_up && ifs[0].link_speed != ifs[1].link_speed)
+		{
+			printf ("  %s: primary at %u, secondary at %u\n"
+				, device_name (& device->instance_id), ifs[0].link_speed, ifs[1].link_speed
+			);
+		}
+		for (i = 0; i < device->interfaces_kept; i++)
+		{
+			const unsigned int users = conmon_topology_find_address (g_topology, ifs[i].ip_address, NULL, 0);
+			if (users > 1)
+			{
+				char ip_buf [32];
+				printf ("  %s: %s %u address %s is used by %u interfaces\n"
+					, device_name (& device->instance_id), interface_role (i), i
+					, ip_to_string (ifs[i].ip_address, ip_buf, sizeof (ip_buf)), users
+				);
+			}
+		}
+	}
+	fflush (stdout);
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_status_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	conmon_aud_decoded_interface_status_t status;
+	conmon_instance_id_t instance_id;
+	aud_error_t result;
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+
+	if (!conmon_vendor_id_equals (conmon_message_head_get_vendor_id (head), CONMON_VENDOR_ID_AUDINATE))
+	{
+		return;
+	}
+	if (conmon_audinate_message_get_type (body) != CONMON_AUDINATE_MESSAGE_TYPE_INTERFACE_STATUS)
+	{
+		return;
+	}
+	result = conmon_aud_decode_interface_status (body, conmon_message_head_get_body_size (head), & status);
+	if (result != AUD_SUCCESS && result != AUD_ERR_TRUNCATED)
+	{
+		return;
+	}
+
+	conmon_message_head_get_instance_id (head, & instance_id);
+	result = conmon_topology_update (g_topology, & instance_id, & status, now_ms ());
+	if (result == AUD_ERR_NOBUFS && ! g_full_reported)
+	{
+		fprintf (stderr, "Device table is full, new devices will not be tracked (see -max)\n");
+		g_full_reported = AUD_TRUE;
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (num_changes);
+	AUD_UNUSED (changes);
+
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Main
+
+static void
+usage (const char * bin)
+{
+	printf ("Usage: %s [-p=PORT] [-max=N] [-summary=SEC] [-audit=SEC] [-new]\n", bin);
+	printf ("  Report link, speed, address and redundancy changes across all devices\n");
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -max=N: track at most N devices (default %u)\n", TOPOLOGY_DEFAULT_MAX_DEVICES);
+	printf ("  -summary=SEC: print a one line summary every SEC seconds\n");
+	printf ("  -audit=SEC: print a redundancy audit every SEC seconds: links down,\n"
+		"      devices without redundancy, speed mismatches and shared addresses\n");
+	printf ("  -new: also report each device the first time it is seen\n");
+	printf ("  Ctrl-C prints the audit and exits\n");
+}
+
+
+int
+main (int argc, char * argv[])
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	dante_sockets_t sockets;
+	uint16_t server_port = 0;
+	unsigned int max_devices = TOPOLOGY_DEFAULT_MAX_DEVICES;
+	unsigned int summary_s = 0, audit_s = 0;
+	uint64_t next_summary_ms = 0, next_audit_ms = 0;
+	int a;
+
+	for (a = 1; a < argc; a++)
+	{
+		const char * arg = argv[a];
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if (!strncmp (arg, "-max=", 5) && strlen (arg) > 5)
+		{
+			max_devices = (unsigned int) atoi (arg + 5);
+		}
+		else if (!strncmp (arg, "-summary=", 9) && strlen (arg) > 9)
+		{
+			summary_s = (unsigned int) atoi (arg + 9);
+		}
+		else if (!strncmp (arg, "-audit=", 7) && strlen (arg) > 7)
+		{
+			audit_s = (unsigned int) atoi (arg + 7);
+		}
+		else if (!strcmp (arg, "-new"))
+		{
+			g_show_new = AUD_TRUE;
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+
+	result = conmon_topology_new (max_devices, & handle_topology_change, NULL, & g_topology);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device table: %s\n", aud_error_message (result, errbuf));
+		usage (argv[0]);
+		exit (1);
+	}
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	config = conmon_client_config_new ("topology_monitor");
+	if (!config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (config, server_port);
+	}
+	result = conmon_client_new_config (env, config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, TOPOLOGY_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device name cache: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+			handle_status_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for status messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_subscribe_global (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error subscribing to status from all devices: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	printf ("Tracking interface status from all devices\n");
+
+	// The loop runs until the user hits CTRL-C, waking once a second to print summaries and audits
+	signal (SIGINT, sig_handler);
+	if (summary_s)
+	{
+		next_summary_ms = now_ms () + summary_s * 1000;
+	}
+	if (audit_s)
+	{
+		next_audit_ms = now_ms () + audit_s * 1000;
+	}
+	while (g_running)
+	{
+		aud_utime_t timeout;
+		uint64_t now;
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& sockets);
+			conmon_client_get_sockets (client, & sockets);
+		}
+
+		timeout.tv_sec = 1;
+		timeout.tv_usec = 0;
+		conmon_example_client_process (client, & sockets, & timeout, NULL);
+
+		now = now_ms ();
+		if (audit_s && now >= next_audit_ms)
+		{
+			print_audit (AUD_TRUE);
+			next_audit_ms = now + audit_s * 1000;
+		}
+		else if (summary_s && now >= next_summary_ms)
+		{
+			print_audit (AUD_FALSE);
+		}
+		if (summary_s && now >= next_summary_ms)
+		{
+			next_summary_ms = now + summary_s * 1000;
+		}
+	}
+
+	print_audit (AUD_TRUE);
+	result = AUD_SUCCESS;
+
+cleanup:
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (config)
+	{
+		conmon_client_config_delete (config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	conmon_topology_delete (g_topology);
+	return result;
+}
+
+
+//----------
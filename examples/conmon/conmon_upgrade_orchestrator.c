@@ -0,0 +1,798 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Upgrade the firmware of many devices, several at a time
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_name_cache.h"
+#include "conmon_sub_manager.h"
+#include "conmon_tftp_server.h"
+#include "conmon_upgrade_plan.h"
+#include "dapi_io.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	UPGRADE_MAX_DEVICES = 4096,
+	UPGRADE_NAME_CACHE_SIZE = 2048,
+	UPGRADE_SUBS_IN_FLIGHT = 32,
+	UPGRADE_PROGRESS_STEP = 10
+		// report progress every this many percent
+};
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static conmon_upgrade_plan_t * g_plan = NULL;
+static conmon_name_cache_t * g_names = NULL;
+static conmon_sub_manager_t * g_subs = NULL;
+static conmon_tftp_server_t * g_tftp = NULL;
+
+// the request is the same for every device, so it is built once
+static conmon_message_body_t g_request;
+static uint16_t g_request_size = 0;
+
+// outstanding upgrade request and last reported progress step for each job
+static conmon_client_request_id_t g_job_requests [UPGRADE_MAX_DEVICES];
+static unsigned int g_job_progress [UPGRADE_MAX_DEVICES];
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+// how long the server keeps trying to deliver each upgrade request
+static const aud_utime_t k_control_timeout = {5, 0};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_ms (void)
+{
+	return conmon_example_clock_ns () / 1000000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static void
+handle_sub_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	conmon_sub_manager_handle_response (g_subs, request_id, result);
+}
+
+
+static void
+handle_upgrade_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	const conmon_upgrade_job_t * job;
+	unsigned int i;
+
+	AUD_UNUSED (client);
+
+	for (i = 0; (job = conmon_upgrade_plan_job_at_index (g_plan, i)) != NULL; i++)
+	{
+		if (g_job_requests [i] == request_id && job->state == CONMON_UPGRADE_JOB_REQUESTED)
+		{
+			conmon_upgrade_plan_request_result (g_plan, i, result, now_ms ());
+			return;
+		}
+	}
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+// Parse ADDR[:PORT], leaving the port alone if there isn't one
+static aud_bool_t
+parse_server (char * arg, uint32_t * addr, uint16_t * port)
+{
+	char * colon = strchr (arg, ':');
+
+	if (colon)
+	{
+		* colon = 0;
+		* port = (uint16_t) atoi (colon + 1);
+		if (! * port)
+		{
+			return AUD_FALSE;
+		}
+	}
+	* addr = inet_addr (arg);
+	return * addr != 0 && * addr != INADDR_NONE;
+}
+
+
+static aud_error_t
+build_request
+(
+	uint32_t server_addr,
+	uint16_t server_port,
+	char * path,
+	uint32_t file_len,
+	const dante_id64_t * manufacturer,
+	const dante_id64_t * model
+)
+{
+	conmon_audinate_upgrade_source_file_t src_file = { 0 };
+	conmon_message_size_info_t size = { 0 };
+	aud_error_t result;
+
+	conmon_audinate_init_upgrade_control_v3 (& g_request, & size, 0);
+
+	src_file.protocol = CONMON_AUDINATE_UPGRADE_PROTOCOL_TFTP_GET;
+	src_file.addr_inet.s_addr = server_addr;
+	src_file.port = server_port;
+	src_file.filename = path;
+	src_file.file_len = file_len;
+	result = conmon_audinate_upgrade_control_set_source_file (& g_request, & size, & src_file);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	conmon_audinate_upgrade_control_set_override (& g_request, manufacturer, model);
+
+	g_request_size = (uint16_t) size.curr;
+	return AUD_SUCCESS;
+}
+
+
+static aud_error_t
+add_devices_from_file (const char * filename)
+{
+	char line [256];
+	aud_error_t result = AUD_SUCCESS;
+	FILE * fp = fopen (filename, "r");
+
+	if (! fp)
+	{
+		return AUD_ERR_NOTFOUND;
+	}
+	while (result == AUD_SUCCESS && fgets (line, sizeof (line), fp))
+	{
+		char * end = line + strlen (line);
+		while (end > line && (end [-1] == '\n' || end [-1] == '\r' || end [-1] == ' ' || end [-1] == '\t'))
+		{
+			* -- end = 0;
+		}
+		if (line [0] && line [0] != '#')
+		{
+			result = conmon_upgrade_plan_add (g_plan, line);
+		}
+	}
+	fclose (fp);
+	return result;
+}
+
+
+static void
+send_upgrade (conmon_client_t * client, unsigned int job_index)
+{
+	const conmon_upgrade_job_t * job = conmon_upgrade_plan_job_at_index (g_plan, job_index);
+	aud_error_t result;
+
+	g_job_progress [job_index] = 0;
+	result =
+		conmon_client_send_control_message (
+			client, & handle_upgrade_response, & g_job_requests [job_index],
+			job->device_name, CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+			& g_request, g_request_size, & k_control_timeout
+		);
+	if (result != AUD_SUCCESS)
+	{
+		conmon_upgrade_plan_request_result (g_plan, job_index, result, now_ms ());
+	}
+}
+
+
+static void
+print_summary (void)
+{
+	conmon_upgrade_plan_summary_t summary;
+	const conmon_upgrade_job_t * job;
+	aud_errbuf_t errbuf;
+	unsigned int i;
+
+	conmon_upgrade_plan_get_summary (g_plan, & summary);
+	printf ("%u devices: %u done, %u failed, %u pending, %u in progress, %u waiting to retry; %lu attempts\n"
+		, summary.num_jobs
+		, summary.num_in_state [CONMON_UPGRADE_JOB_DONE]
+		, summary.num_in_state [CONMON_UPGRADE_JOB_FAILED]
+		, summary.num_in_state [CONMON_UPGRADE_JOB_PENDING]
+		, summary.num_in_state [CONMON_UPGRADE_JOB_REQUESTED] + summary.num_in_state [CONMON_UPGRADE_JOB_RUNNING]
+		, summary.num_in_state [CONMON_UPGRADE_JOB_BACKOFF]
+		, summary.num_attempts
+	);
+	for (i = 0; (job = conmon_upgrade_plan_job_at_index (g_plan, i)) != NULL; i++)
+	{
+		if (job->state == CONMON_UPGRADE_JOB_DONE)
+		{
+			continue;
+		}
+		printf ("  %-32s %-9s after %u attempts, last failure: %s (device error 0x%x)\n"
+			, job->device_name
+			, conmon_upgrade_job_state_to_string (job->state)
+			, job->attempts
+			, job->last_failure == AUD_SUCCESS ? "none" : aud_error_message (job->last_failure, errbuf)
+			, job->last_error
+		);
+	}
+	if (g_tftp)
+	{
+		conmon_tftp_server_stats_t stats;
+
+		conmon_tftp_server_get_stats (g_tftp, & stats);
+		printf ("File server: %lu requests, %lu completed, %lu failed, %lu refused, %lu retransmits, %llu bytes\n"
+			, stats.num_requests, stats.num_completed, stats.num_failed
+			, stats.num_refused, stats.num_retransmits
+			, (unsigned long long) stats.bytes_sent
+		);
+	}
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_job_event
+(
+	void * context,
+	const conmon_upgrade_job_t * job,
+	conmon_upgrade_job_state_t old_state
+)
+{
+	aud_ctime_buf_t time_buf;
+	aud_errbuf_t errbuf;
+
+	AUD_UNUSED (context);
+
+	printf ("#UPGRADE %s '%s' %s -> %s"
+		, aud_utime_ctime_no_newline (NULL, time_buf)
+		, job->device_name
+		, conmon_upgrade_job_state_to_string (old_state)
+		, conmon_upgrade_job_state_to_string (job->state)
+	);
+	if (job->state == CONMON_UPGRADE_JOB_BACKOFF || job->state == CONMON_UPGRADE_JOB_FAILED)
+	{
+		printf (" (attempt %u: %s)", job->attempts, aud_error_message (job->last_failure, errbuf));
+	}
+	putchar ('\n');
+	fflush (stdout);
+}
+
+
+static void
+handle_status_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	const conmon_name_cache_entry_t * source;
+	conmon_aud_decoded_upgrade_status_t status;
+	conmon_instance_id_t instance_id;
+	const conmon_upgrade_job_t * job;
+	unsigned int i;
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+
+	if (!conmon_vendor_id_equals (conmon_message_head_get_vendor_id (head), CONMON_VENDOR_ID_AUDINATE)
+		|| conmon_audinate_message_get_type (body) != CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_STATUS)
+	{
+		return;
+	}
+	if (conmon_aud_decode_upgrade_status (body, conmon_message_head_get_body_size (head), & status) != AUD_SUCCESS)
+	{
+		return;
+	}
+	conmon_message_head_get_instance_id (head, & instance_id);
+	source = conmon_name_cache_lookup (g_names, & instance_id);
+	if (! source->device_name)
+	{
+		return;
+	}
+
+	conmon_upgrade_plan_status (g_plan, source->device_name, & status, now_ms ());
+
+	// report progress in steps rather than for every status message
+	for (i = 0; (job = conmon_upgrade_plan_job_at_index (g_plan, i)) != NULL; i++)
+	{
+		if (! STRCASECMP (job->device_name, source->device_name))
+		{
+			break;
+		}
+	}
+	if (job && job->state == CONMON_UPGRADE_JOB_RUNNING && job->progress_total)
+	{
+		const unsigned int percent = (unsigned int) ((uint64_t) job->progress_curr * 100 / job->progress_total);
+		const unsigned int step = percent / UPGRADE_PROGRESS_STEP;
+		if (step != g_job_progress [i])
+		{
+			g_job_progress [i] = step;
+			printf ("#PROGRESS '%s' %u%% (%s)\n"
+				, job->device_name, percent
+				, job->upgrade_status == CONMON_UPGRADE_STATUS_FLASH_WRITE ? "writing flash" : "fetching file"
+			);
+			fflush (stdout);
+		}
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	AUD_UNUSED (client);
+
+	conmon_name_cache_invalidate (g_names);
+	if (g_subs)
+	{
+		conmon_sub_manager_handle_subscriptions_changed (g_subs, num_changes, changes);
+	}
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Main
+
+static void
+usage (const char * bin)
+{
+	conmon_upgrade_plan_config_t defaults;
+
+	conmon_upgrade_plan_config_init (& defaults);
+	printf ("Usage: %s [-p=PORT] (-tftp=ADDR[:PORT] | -serve=ADDR[:PORT]) -file=PATH [-len=BYTES]\n"
+		"    [-mf=ID] [-model=ID] [-window=N] [-attempts=N] [-backoff=MS] [-timeout=SEC]\n"
+		"    [-devices=FILE] [DEVICE...]\n", bin);
+	printf ("  Upgrade the firmware of the named devices, several at a time\n");
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -tftp=ADDR[:PORT]: devices fetch PATH from the TFTP server at ADDR\n");
+	printf ("  -serve=ADDR[:PORT]: serve the local file PATH over TFTP from this host,\n"
+		"      which devices reach at ADDR\n");
+	printf ("  -file=PATH: the firmware file; -len gives its size when it is not served locally\n");
+	printf ("  -mf=ID, -model=ID: override the manufacturer and model ids (hex)\n");
+	printf ("  -window=N: upgrade at most N devices at once (default %u)\n", defaults.window);
+	printf ("  -attempts=N: try each device at most N times (default %u)\n", defaults.max_attempts);
+	printf ("  -backoff=MS: wait MS milliseconds before the first retry, doubling for each\n"
+		"      further retry (default %u, at most %u)\n", defaults.backoff_ms, defaults.max_backoff_ms);
+	printf ("  -timeout=SEC: fail an attempt after SEC seconds without progress (default %u)\n",
+		defaults.timeout_ms / 1000);
+	printf ("  -devices=FILE: read device names from FILE, one per line\n");
+}
+
+
+int
+main (int argc, char * argv[])
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	conmon_upgrade_plan_config_t plan_config;
+	conmon_upgrade_plan_summary_t summary;
+	dante_sockets_t client_sockets;
+	uint16_t server_port = 0;
+	uint32_t file_server_addr = 0;
+	uint16_t file_server_port = CONMON_TFTP_DEFAULT_PORT;
+	aud_bool_t serve = AUD_FALSE;
+	char * file = NULL;
+	uint32_t file_len = 0;
+	const char * devices_file = NULL;
+	dante_id64_t mf, model, * mfp = NULL, * modelp = NULL;
+	unsigned int i;
+	int a;
+
+	conmon_upgrade_plan_config_init (& plan_config);
+
+	for (a = 1; a < argc; a++)
+	{
+		char * arg = argv[a];
+		if (arg[0] != '-')
+		{
+			break;
+		}
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if ((!strncmp (arg, "-tftp=", 6) && parse_server (arg + 6, & file_server_addr, & file_server_port))
+			|| (!strncmp (arg, "-serve=", 7) && parse_server (arg + 7, & file_server_addr, & file_server_port)))
+		{
+			serve = (arg[1] == 's');
+		}
+		else if (!strncmp (arg, "-file=", 6) && strlen (arg) > 6)
+		{
+			file = arg + 6;
+		}
+		else if (!strncmp (arg, "-len=", 5) && strlen (arg) > 5)
+		{
+			file_len = (uint32_t) atoi (arg + 5);
+		}
+		else if (!strncmp (arg, "-mf=", 4) && dante_id64_from_hex (& mf, arg + 4) == AUD_SUCCESS)
+		{
+			mfp = & mf;
+		}
+		else if (!strncmp (arg, "-model=", 7) && dante_id64_from_hex (& model, arg + 7) == AUD_SUCCESS)
+		{
+			modelp = & model;
+		}
+		else if (!strncmp (arg, "-window=", 8) && strlen (arg) > 8)
+		{
+			plan_config.window = (unsigned int) atoi (arg + 8);
+		}
+		else if (!strncmp (arg, "-attempts=", 10) && strlen (arg) > 10)
+		{
+			plan_config.max_attempts = (unsigned int) atoi (arg + 10);
+		}
+		else if (!strncmp (arg, "-backoff=", 9) && strlen (arg) > 9)
+		{
+			plan_config.backoff_ms = (unsigned int) atoi (arg + 9);
+			if (plan_config.backoff_ms > plan_config.max_backoff_ms)
+			{
+				plan_config.max_backoff_ms = plan_config.backoff_ms;
+			}
+		}
+		else if (!strncmp (arg, "-timeout=", 9) && strlen (arg) > 9)
+		{
+			plan_config.timeout_ms = (unsigned int) atoi (arg + 9) * 1000;
+		}
+		else if (!strncmp (arg, "-devices=", 9) && strlen (arg) > 9)
+		{
+			devices_file = arg + 9;
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+	if (! file_server_addr || ! file)
+	{
+		usage (argv[0]);
+		exit (1);
+	}
+
+	result = conmon_upgrade_plan_new (& plan_config, UPGRADE_MAX_DEVICES, & handle_job_event, NULL, & g_plan);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Invalid upgrade settings: %s\n", aud_error_message (result, errbuf));
+		usage (argv[0]);
+		exit (1);
+	}
+	if (devices_file)
+	{
+		result = add_devices_from_file (devices_file);
+		if (result != AUD_SUCCESS)
+		{
+			printf ("Error reading devices from %s: %s\n", devices_file, aud_error_message (result, errbuf));
+			goto cleanup;
+		}
+	}
+	for (; a < argc; a++)
+	{
+		result = conmon_upgrade_plan_add (g_plan, argv[a]);
+		if (result != AUD_SUCCESS)
+		{
+			printf ("Error adding device '%s': %s\n", argv[a], aud_error_message (result, errbuf));
+			goto cleanup;
+		}
+	}
+	conmon_upgrade_plan_get_summary (g_plan, & summary);
+	if (! summary.num_jobs)
+	{
+		printf ("No devices to upgrade\n");
+		usage (argv[0]);
+		result = AUD_ERR_INVALIDPARAMETER;
+		goto cleanup;
+	}
+
+	if (serve)
+	{
+		result = conmon_tftp_server_new (file, NULL, file_server_port, plan_config.window, & g_tftp);
+		if (result != AUD_SUCCESS)
+		{
+			printf ("Error serving %s on port %u: %s\n", file, file_server_port, aud_error_message (result, errbuf));
+			goto cleanup;
+		}
+		file = (char *) conmon_tftp_server_file_name (g_tftp);
+		file_len = conmon_tftp_server_file_size (g_tftp);
+	}
+	result = build_request (file_server_addr, file_server_port, file, file_len, mfp, modelp);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error building upgrade request: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	config = conmon_client_config_new ("upgrade_orchestrator");
+	if (!config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (config, server_port);
+	}
+	result = conmon_client_new_config (env, config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, UPGRADE_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result == AUD_SUCCESS)
+	{
+		result = conmon_sub_manager_new (client, & handle_sub_response, UPGRADE_SUBS_IN_FLIGHT, & g_subs);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating client helpers: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+			handle_status_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for status messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// progress comes from each device's status channel
+	for (i = 0; i < summary.num_jobs; i++)
+	{
+		conmon_sub_manager_add_desired (g_subs, CONMON_CHANNEL_TYPE_STATUS,
+			conmon_upgrade_plan_job_at_index (g_plan, i)->device_name);
+	}
+	conmon_sub_manager_sync (g_subs, NULL);
+	conmon_sub_manager_process (g_subs);
+
+	printf ("Upgrading %u devices, %u at a time, from tftp://%s:%u/%s%s\n"
+		, summary.num_jobs, plan_config.window
+		, inet_ntoa (* (struct in_addr *) & file_server_addr), file_server_port, file
+		, g_tftp ? " (served locally)" : ""
+	);
+
+	// The loop runs until every device is done or has failed, or the user hits CTRL-C
+	signal (SIGINT, sig_handler);
+	while (g_running && ! conmon_upgrade_plan_is_finished (g_plan))
+	{
+		dante_sockets_t sockets;
+		aud_utime_t timeout;
+		unsigned int ms, job_index;
+		uint64_t now = now_ms ();
+		int count;
+
+		while (conmon_upgrade_plan_next (g_plan, now, & job_index))
+		{
+			send_upgrade (client, job_index);
+		}
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& client_sockets);
+			conmon_client_get_sockets (client, & client_sockets);
+		}
+		sockets = client_sockets;
+		ms = conmon_upgrade_plan_ms_to_next (g_plan, now);
+		if (g_tftp)
+		{
+			const unsigned int tftp_ms = conmon_tftp_server_ms_to_next (g_tftp, now);
+			conmon_tftp_server_add_sockets (g_tftp, & sockets);
+			if (tftp_ms < ms)
+			{
+				ms = tftp_ms;
+			}
+		}
+		if (ms > 1000)
+		{
+			ms = 1000;
+		}
+		timeout.tv_sec = ms / 1000;
+		timeout.tv_usec = (ms % 1000) * 1000;
+
+		count = select (sockets.n, & sockets.read_fds, NULL, NULL, & timeout);
+		if (count < 0)
+		{
+			result = aud_error_from_system_error (aud_system_error_get_last ());
+			if (result == AUD_ERR_INTERRUPTED)
+			{
+				continue;
+			}
+			printf ("Error select()ing: %s\n", aud_error_message (result, errbuf));
+			break;
+		}
+		now = now_ms ();
+		if (g_tftp)
+		{
+			conmon_tftp_server_process (g_tftp, count > 0 ? & sockets : NULL, now);
+		}
+		if (count > 0)
+		{
+			conmon_client_process_sockets (client, & sockets, NULL);
+		}
+		conmon_sub_manager_process (g_subs);
+		conmon_upgrade_plan_advance (g_plan, now_ms ());
+	}
+
+	print_summary ();
+	conmon_upgrade_plan_get_summary (g_plan, & summary);
+	result = (summary.num_in_state [CONMON_UPGRADE_JOB_DONE] == summary.num_jobs)
+		? AUD_SUCCESS : AUD_ERR_DONE;
+
+cleanup:
+	if (g_subs)
+	{
+		conmon_sub_manager_delete (g_subs);
+	}
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (config)
+	{
+		conmon_client_config_delete (config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	conmon_tftp_server_delete (g_tftp);
+	conmon_upgrade_plan_delete (g_plan);
+	return result;
+}
+
+
+//----------
@@ -0,0 +1,493 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Schedule firmware upgrades across many devices
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_upgrade_plan.h"
+#include "dapi_io.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+#define UPGRADE_PLAN_NO_ENTRY 0xFFFFFFFFu
+
+struct conmon_upgrade_plan
+{
+	conmon_upgrade_plan_config_t config;
+	conmon_upgrade_plan_event_fn * event_fn;
+	void * event_context;
+
+	conmon_upgrade_job_t * jobs;
+	unsigned int num_jobs;
+	unsigned int max_jobs;
+	uint32_t * index;
+		// open addressing on the case-folded device name
+	uint32_t index_mask;
+
+	unsigned int num_in_state [CONMON_NUM_UPGRADE_JOB_STATES];
+	unsigned int next_pending;
+		// jobs before this one are not PENDING
+	unsigned long num_attempts;
+};
+
+
+//----------
+// Local functions
+
+// Returns the slot holding the job, or the empty slot where it would go
+static uint32_t
+find_job_slot (const conmon_upgrade_plan_t * plan, const char * device_name)
+{
+	uint32_t slot = dapi_name_hash (device_name) & plan->index_mask;
+	uint32_t i;
+
+	while ((i = plan->index [slot]) != UPGRADE_PLAN_NO_ENTRY)
+	{
+		if (dapi_name_equals (plan->jobs [i].device_name, device_name))
+		{
+			break;
+		}
+		slot = (slot + 1) & plan->index_mask;
+	}
+	return slot;
+}
+
+
+AUD_INLINE aud_bool_t
+is_active (conmon_upgrade_job_state_t state)
+{
+	return state == CONMON_UPGRADE_JOB_REQUESTED || state == CONMON_UPGRADE_JOB_RUNNING;
+}
+
+
+static void
+set_state
+(
+	conmon_upgrade_plan_t * plan,
+	conmon_upgrade_job_t * job,
+	conmon_upgrade_job_state_t state,
+	uint64_t now_ms
+)
+{
+	const conmon_upgrade_job_state_t old_state = job->state;
+
+	plan->num_in_state [old_state]--;
+	plan->num_in_state [state]++;
+	job->state = state;
+	job->state_since_ms = now_ms;
+	if (plan->event_fn)
+	{
+		plan->event_fn (plan->event_context, job, old_state);
+	}
+}
+
+
+static void
+fail_attempt
+(
+	conmon_upgrade_plan_t * plan,
+	conmon_upgrade_job_t * job,
+	aud_error_t reason,
+	uint64_t now_ms
+)
+{
+	unsigned int backoff_ms = plan->config.backoff_ms;
+	unsigned int i;
+
+	job->last_failure = reason;
+	if (job->attempts >= plan->config.max_attempts)
+	{
+		set_state (plan, job, CONMON_UPGRADE_JOB_FAILED, now_ms);
+		return;
+	}
+	for (i = 1; i < job->attempts && backoff_ms < plan->config.max_backoff_ms; i++)
+	{
+		backoff_ms *= 2;
+	}
+	if (backoff_ms > plan->config.max_backoff_ms)
+	{
+		backoff_ms = plan->config.max_backoff_ms;
+	}
+	job->due_ms = now_ms + backoff_ms;
+	set_state (plan, job, CONMON_UPGRADE_JOB_BACKOFF, now_ms);
+}
+
+
+//----------
+// Functions
+
+void
+conmon_upgrade_plan_config_init
+(
+	conmon_upgrade_plan_config_t * config
+)
+{
+	config->window = 8;
+	config->max_attempts = 3;
+	config->backoff_ms = 10000;
+	config->max_backoff_ms = 120000;
+	config->timeout_ms = 120000;
+}
+
+
+aud_error_t
+conmon_upgrade_plan_new
+(
+	const conmon_upgrade_plan_config_t * config,
+	unsigned int max_jobs,
+	conmon_upgrade_plan_event_fn * event_fn,
+	void * event_context,
+	conmon_upgrade_plan_t ** plan_ptr
+)
+{
+	conmon_upgrade_plan_t * plan;
+	uint32_t index_size = 1;
+
+	if (! (config && plan_ptr && max_jobs) || max_jobs > 0x100000
+		|| ! config->window || ! config->max_attempts || ! config->timeout_ms
+		|| config->backoff_ms > config->max_backoff_ms)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (index_size < 2 * max_jobs)
+	{
+		index_size <<= 1;
+	}
+
+	plan = calloc (1, sizeof (* plan));
+	if (! plan)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	plan->jobs = calloc (max_jobs, sizeof (* plan->jobs));
+	plan->index = malloc (index_size * sizeof (uint32_t));
+	if (! (plan->jobs && plan->index))
+	{
+		conmon_upgrade_plan_delete (plan);
+		return AUD_ERR_NOMEMORY;
+	}
+	// 0xFF bytes give UPGRADE_PLAN_NO_ENTRY in every slot
+	memset (plan->index, 0xFF, index_size * sizeof (uint32_t));
+	plan->index_mask = index_size - 1;
+	plan->max_jobs = max_jobs;
+	plan->config = * config;
+	plan->event_fn = event_fn;
+	plan->event_context = event_context;
+
+	* plan_ptr = plan;
+	return AUD_SUCCESS;
+}
+
+
+void
+conmon_upgrade_plan_delete
+(
+	conmon_upgrade_plan_t * plan
+)
+{
+	if (plan)
+	{
+		free (plan->index);
+		free (plan->jobs);
+		free (plan);
+	}
+}
+
+
+aud_error_t
+conmon_upgrade_plan_add
+(
+	conmon_upgrade_plan_t * plan,
+	const char * device_name
+)
+{
+	conmon_upgrade_job_t * job;
+	uint32_t slot;
+
+	if (! (plan && device_name && * device_name) || strlen (device_name) >= sizeof (job->device_name))
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	slot = find_job_slot (plan, device_name);
+	if (plan->index [slot] != UPGRADE_PLAN_NO_ENTRY)
+	{
+		return AUD_SUCCESS;
+	}
+	if (plan->num_jobs >= plan->max_jobs)
+	{
+		return AUD_ERR_NOBUFS;
+	}
+
+	plan->index [slot] = plan->num_jobs;
+	job = plan->jobs + plan->num_jobs++;
+	strcpy (job->device_name, device_name);
+	job->state = CONMON_UPGRADE_JOB_PENDING;
+	job->last_failure = AUD_SUCCESS;
+	plan->num_in_state [CONMON_UPGRADE_JOB_PENDING]++;
+	return AUD_SUCCESS;
+}
+
+
+aud_bool_t
+conmon_upgrade_plan_next
+(
+	conmon_upgrade_plan_t * plan,
+	uint64_t now_ms,
+	unsigned int * job_index
+)
+{
+	const unsigned int active =
+		plan->num_in_state [CONMON_UPGRADE_JOB_REQUESTED] + plan->num_in_state [CONMON_UPGRADE_JOB_RUNNING];
+	conmon_upgrade_job_t * job = NULL;
+	unsigned int i;
+
+	if (active >= plan->config.window)
+	{
+		return AUD_FALSE;
+	}
+
+	// retries go first, so that a device is not starved by a long queue
+	if (plan->num_in_state [CONMON_UPGRADE_JOB_BACKOFF])
+	{
+		for (i = 0; i < plan->num_jobs; i++)
+		{
+			if (plan->jobs [i].state == CONMON_UPGRADE_JOB_BACKOFF && plan->jobs [i].due_ms <= now_ms)
+			{
+				job = plan->jobs + i;
+				break;
+			}
+		}
+	}
+	if (! job && plan->num_in_state [CONMON_UPGRADE_JOB_PENDING])
+	{
+		// jobs only leave PENDING, so the scan can resume where it stopped
+		for (i = plan->next_pending; i < plan->num_jobs; i++)
+		{
+			if (plan->jobs [i].state == CONMON_UPGRADE_JOB_PENDING)
+			{
+				job = plan->jobs + i;
+				plan->next_pending = i + 1;
+				break;
+			}
+		}
+	}
+	if (! job)
+	{
+		return AUD_FALSE;
+	}
+
+	job->attempts++;
+	plan->num_attempts++;
+	job->upgrade_status = CONMON_UPGRADE_STATUS_NONE;
+	job->progress_curr = 0;
+	job->progress_total = 0;
+	job->due_ms = now_ms + plan->config.timeout_ms;
+	set_state (plan, job, CONMON_UPGRADE_JOB_REQUESTED, now_ms);
+	* job_index = (unsigned int) (job - plan->jobs);
+	return AUD_TRUE;
+}
+
+
+void
+conmon_upgrade_plan_request_result
+(
+	conmon_upgrade_plan_t * plan,
+	unsigned int job_index,
+	aud_error_t result,
+	uint64_t now_ms
+)
+{
+	conmon_upgrade_job_t * job;
+
+	if (job_index >= plan->num_jobs)
+	{
+		return;
+	}
+	job = plan->jobs + job_index;
+	if (job->state != CONMON_UPGRADE_JOB_REQUESTED)
+	{
+		return;
+	}
+
+	if (result == AUD_SUCCESS)
+	{
+		job->due_ms = now_ms + plan->config.timeout_ms;
+		set_state (plan, job, CONMON_UPGRADE_JOB_RUNNING, now_ms);
+	}
+	else
+	{
+		fail_attempt (plan, job, result, now_ms);
+	}
+}
+
+
+void
+conmon_upgrade_plan_status
+(
+	conmon_upgrade_plan_t * plan,
+	const char * device_name,
+	const conmon_aud_decoded_upgrade_status_t * status,
+	uint64_t now_ms
+)
+{
+	const uint32_t i = plan->index [find_job_slot (plan, device_name)];
+	conmon_upgrade_job_t * job;
+	aud_bool_t progressed;
+
+	if (i == UPGRADE_PLAN_NO_ENTRY)
+	{
+		return;
+	}
+	job = plan->jobs + i;
+	if (! is_active (job->state))
+	{
+		return;
+	}
+
+	progressed = status->status.status != job->upgrade_status
+		|| status->status.progress.curr != job->progress_curr;
+	job->upgrade_status = status->status.status;
+	job->last_error = status->status.last_error;
+	job->progress_curr = status->status.progress.curr;
+	job->progress_total = status->status.progress.total;
+
+	switch (job->upgrade_status)
+	{
+	case CONMON_UPGRADE_STATUS_END_DONE:
+		set_state (plan, job, CONMON_UPGRADE_JOB_DONE, now_ms);
+		break;
+	case CONMON_UPGRADE_STATUS_END_FAIL:
+		fail_attempt (plan, job, AUD_ERR_SYSTEM, now_ms);
+		break;
+	case CONMON_UPGRADE_STATUS_GET_FILE:
+	case CONMON_UPGRADE_STATUS_FLASH_WRITE:
+		// a status report also shows the request got through, even if the response was lost
+		if (job->state == CONMON_UPGRADE_JOB_REQUESTED)
+		{
+			set_state (plan, job, CONMON_UPGRADE_JOB_RUNNING, now_ms);
+			progressed = AUD_TRUE;
+		}
+		if (progressed)
+		{
+			job->due_ms = now_ms + plan->config.timeout_ms;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+void
+conmon_upgrade_plan_advance
+(
+	conmon_upgrade_plan_t * plan,
+	uint64_t now_ms
+)
+{
+	unsigned int i;
+
+	if (! (plan->num_in_state [CONMON_UPGRADE_JOB_REQUESTED] + plan->num_in_state [CONMON_UPGRADE_JOB_RUNNING]))
+	{
+		return;
+	}
+	for (i = 0; i < plan->num_jobs; i++)
+	{
+		conmon_upgrade_job_t * job = plan->jobs + i;
+		if (is_active (job->state) && job->due_ms <= now_ms)
+		{
+			fail_attempt (plan, job, AUD_ERR_TIMEDOUT, now_ms);
+		}
+	}
+}
+
+
+unsigned int
+conmon_upgrade_plan_ms_to_next
+(
+	const conmon_upgrade_plan_t * plan,
+	uint64_t now_ms
+)
+{
+	uint64_t next_ms = now_ms + plan->config.timeout_ms;
+	unsigned int i;
+
+	for (i = 0; i < plan->num_jobs; i++)
+	{
+		const conmon_upgrade_job_t * job = plan->jobs + i;
+		if ((is_active (job->state) || job->state == CONMON_UPGRADE_JOB_BACKOFF) && job->due_ms < next_ms)
+		{
+			next_ms = job->due_ms;
+		}
+	}
+	return (next_ms > now_ms) ? (unsigned int) (next_ms - now_ms) : 0;
+}
+
+
+aud_bool_t
+conmon_upgrade_plan_is_finished
+(
+	const conmon_upgrade_plan_t * plan
+)
+{
+	return plan->num_in_state [CONMON_UPGRADE_JOB_DONE] + plan->num_in_state [CONMON_UPGRADE_JOB_FAILED]
+		== plan->num_jobs;
+}
+
+
+const conmon_upgrade_job_t *
+conmon_upgrade_plan_job_at_index
+(
+	const conmon_upgrade_plan_t * plan,
+	unsigned int job_index
+)
+{
+	return (job_index < plan->num_jobs) ? plan->jobs + job_index : NULL;
+}
+
+
+void
+conmon_upgrade_plan_get_summary
+(
+	const conmon_upgrade_plan_t * plan,
+	conmon_upgrade_plan_summary_t * summary
+)
+{
+	summary->num_jobs = plan->num_jobs;
+	memcpy (summary->num_in_state, plan->num_in_state, sizeof (summary->num_in_state));
+	summary->num_attempts = plan->num_attempts;
+}
+
+
+const char *
+conmon_upgrade_job_state_to_string
+(
+	conmon_upgrade_job_state_t state
+)
+{
+	switch (state)
+	{
+	case CONMON_UPGRADE_JOB_PENDING:   return "PENDING";
+	case CONMON_UPGRADE_JOB_REQUESTED: return "REQUESTED";
+	case CONMON_UPGRADE_JOB_RUNNING:   return "RUNNING";
+	case CONMON_UPGRADE_JOB_BACKOFF:   return "BACKOFF";
+	case CONMON_UPGRADE_JOB_DONE:      return "DONE";
+	case CONMON_UPGRADE_JOB_FAILED:    return "FAILED";
+	default:                           return "???";
+	}
+}
+
+
+//----------
@@ -0,0 +1,222 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Schedule firmware upgrades across many devices
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CONMON_UPGRADE_PLAN_H
+#define _CONMON_UPGRADE_PLAN_H
+
+
+//----------
+// Include
+
+#include "conmon_aud_decode_msg.h"
+
+
+//----------
+// Types and Constants
+
+/*
+	The plan decides when each device should be sent its upgrade request;
+	the caller sends the requests and feeds back the control responses and
+	UPGRADE_STATUS messages. At most window devices are upgrading at once.
+
+	A device fails an attempt if the request is rejected, if it reports
+	End-Fail, or if it makes no progress for timeout_ms. A failed device
+	waits backoff_ms before trying again, doubling for each further failure
+	up to max_backoff_ms, until max_attempts have been made.
+
+	Times are supplied by the caller in milliseconds from any monotonic
+	clock.
+ */
+
+// Values of conmon_audinate_upgrade_status_t.status, as named in conmon_aud_print_msg.c
+enum
+{
+	CONMON_UPGRADE_STATUS_NONE = 0,
+	CONMON_UPGRADE_STATUS_GET_FILE,
+	CONMON_UPGRADE_STATUS_END_DONE,
+	CONMON_UPGRADE_STATUS_END_FAIL,
+	CONMON_UPGRADE_STATUS_FLASH_WRITE
+};
+
+typedef struct conmon_upgrade_plan conmon_upgrade_plan_t;
+
+typedef enum conmon_upgrade_job_state
+{
+	CONMON_UPGRADE_JOB_PENDING = 0,
+		// waiting for a slot in the window
+	CONMON_UPGRADE_JOB_REQUESTED,
+		// request sent, waiting for the response
+	CONMON_UPGRADE_JOB_RUNNING,
+		// request accepted, following UPGRADE_STATUS
+	CONMON_UPGRADE_JOB_BACKOFF,
+		// failed, waiting to try again
+	CONMON_UPGRADE_JOB_DONE,
+	CONMON_UPGRADE_JOB_FAILED,
+		// out of attempts
+	CONMON_NUM_UPGRADE_JOB_STATES
+} conmon_upgrade_job_state_t;
+
+typedef struct conmon_upgrade_plan_config
+{
+	unsigned int window;
+	unsigned int max_attempts;
+	unsigned int backoff_ms;
+	unsigned int max_backoff_ms;
+	unsigned int timeout_ms;
+} conmon_upgrade_plan_config_t;
+
+typedef struct conmon_upgrade_job
+{
+	conmon_name_t device_name;
+	conmon_upgrade_job_state_t state;
+	unsigned int attempts;
+	uint32_t upgrade_status;
+		// last status reported by the device
+	uint32_t last_error;
+	uint32_t progress_curr;
+	uint32_t progress_total;
+	aud_error_t last_failure;
+		// AUD_SUCCESS until an attempt fails
+	uint64_t state_since_ms;
+	uint64_t due_ms;
+		// when a BACKOFF job may start again, or a REQUESTED or RUNNING job times out
+} conmon_upgrade_job_t;
+
+typedef void
+conmon_upgrade_plan_event_fn
+(
+	void * context,
+	const conmon_upgrade_job_t * job,
+	conmon_upgrade_job_state_t old_state
+);
+
+typedef struct conmon_upgrade_plan_summary
+{
+	unsigned int num_jobs;
+	unsigned int num_in_state [CONMON_NUM_UPGRADE_JOB_STATES];
+	unsigned long num_attempts;
+} conmon_upgrade_plan_summary_t;
+
+
+//----------
+// Functions
+
+// Fill in defaults: 8 at a time, 3 attempts, 10 s backoff doubling to 2 min, 2 min progress timeout
+void
+conmon_upgrade_plan_config_init
+(
+	conmon_upgrade_plan_config_t * config
+);
+
+aud_error_t
+conmon_upgrade_plan_new
+(
+	const conmon_upgrade_plan_config_t * config,
+	unsigned int max_jobs,
+	conmon_upgrade_plan_event_fn * event_fn,
+	void * event_context,
+	conmon_upgrade_plan_t ** plan_ptr
+);
+
+void
+conmon_upgrade_plan_delete
+(
+	conmon_upgrade_plan_t * plan
+);
+
+// Adding a device that is already in the plan does nothing
+// @return AUD_ERR_NOBUFS if max_jobs devices are already in the plan
+aud_error_t
+conmon_upgrade_plan_add
+(
+	conmon_upgrade_plan_t * plan,
+	const char * device_name
+);
+
+/*
+	If a device should be sent its upgrade request now, return AUD_TRUE with
+	its job index and move it to REQUESTED. Call repeatedly until it
+	returns AUD_FALSE.
+ */
+aud_bool_t
+conmon_upgrade_plan_next
+(
+	conmon_upgrade_plan_t * plan,
+	uint64_t now_ms,
+	unsigned int * job_index
+);
+
+// Feed back the result of sending the request, or of the server's response to it
+void
+conmon_upgrade_plan_request_result
+(
+	conmon_upgrade_plan_t * plan,
+	unsigned int job_index,
+	aud_error_t result,
+	uint64_t now_ms
+);
+
+// Feed back an UPGRADE_STATUS message; ignored unless the device is REQUESTED or RUNNING
+void
+conmon_upgrade_plan_status
+(
+	conmon_upgrade_plan_t * plan,
+	const char * device_name,
+	const conmon_aud_decoded_upgrade_status_t * status,
+	uint64_t now_ms
+);
+
+// Fail attempts that have timed out
+void
+conmon_upgrade_plan_advance
+(
+	conmon_upgrade_plan_t * plan,
+	uint64_t now_ms
+);
+
+// Milliseconds until the next timeout or backoff ends, for use as a poll timeout
+unsigned int
+conmon_upgrade_plan_ms_to_next
+(
+	const conmon_upgrade_plan_t * plan,
+	uint64_t now_ms
+);
+
+// True once every job is DONE or FAILED
+aud_bool_t
+conmon_upgrade_plan_is_finished
+(
+	const conmon_upgrade_plan_t * plan
+);
+
+const conmon_upgrade_job_t *
+conmon_upgrade_plan_job_at_index
+(
+	const conmon_upgrade_plan_t * plan,
+	unsigned int job_index
+);
+
+void
+conmon_upgrade_plan_get_summary
+(
+	const conmon_upgrade_plan_t * plan,
+	conmon_upgrade_plan_summary_t * summary
+);
+
+const char *
+conmon_upgrade_job_state_to_string
+(
+	conmon_upgrade_job_state_t state
+);
+
+
+//----------
+
+#endif // _CONMON_UPGRADE_PLAN_H
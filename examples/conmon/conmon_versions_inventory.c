@@ -0,0 +1,872 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Keep an inventory of device versions, models and capabilities
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "conmon_aud_decode_msg.h"
+#include "conmon_aud_print_msg.h"
+#include "conmon_inventory.h"
+#include "conmon_name_cache.h"
+#include "conmon_upgrade_plan.h"
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	INVENTORY_NAME_CACHE_SIZE = 2048,
+	INVENTORY_MAX_QUERIES_PER_PASS = 16
+		// spread a large initial refresh over several passes of the loop
+};
+
+static aud_bool_t g_running = AUD_TRUE;
+static aud_bool_t g_sockets_changed = AUD_TRUE;
+
+static conmon_inventory_t * g_inventory = NULL;
+static conmon_name_cache_t * g_names = NULL;
+static conmon_inventory_filter_t g_filter;
+static aud_bool_t g_print_changes = AUD_TRUE;
+static aud_bool_t g_full_reported = AUD_FALSE;
+
+static unsigned long g_num_query_errors = 0;
+
+static const char * g_csv_file = NULL;
+
+// how long to wait for a response from the server
+static const aud_utime_t k_comms_timeout = {2, 0};
+// how long the server keeps trying to deliver each query
+static const aud_utime_t k_control_timeout = {1, 500000};
+
+static aud_bool_t g_communicating = AUD_FALSE;
+static aud_error_t g_last_result = AUD_SUCCESS;
+
+
+//----------
+// Local functions
+
+static void
+sig_handler (int sig)
+{
+	AUD_UNUSED (sig);
+	signal (SIGINT, sig_handler);
+	g_running = AUD_FALSE;
+}
+
+
+AUD_INLINE uint64_t
+now_ms (void)
+{
+	return conmon_example_clock_ns () / 1000000;
+}
+
+
+static void
+handle_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	g_communicating = AUD_FALSE;
+	g_last_result = result;
+}
+
+
+static void
+handle_query_response
+(
+	conmon_client_t * client,
+	conmon_client_request_id_t request_id,
+	aud_error_t result
+)
+{
+	AUD_UNUSED (client);
+	AUD_UNUSED (request_id);
+
+	if (result != AUD_SUCCESS)
+	{
+		g_num_query_errors++;
+	}
+}
+
+
+static aud_error_t
+wait_for_response
+(
+	conmon_client_t * client,
+	const aud_utime_t * timeout
+)
+{
+	aud_utime_t now, then;
+
+	aud_utime_get (& now);
+	then = now;
+	aud_utime_add (& then, timeout);
+
+	g_communicating = AUD_TRUE;
+	while (g_communicating && aud_utime_compare (& now, & then) < 0)
+	{
+		const aud_utime_t delay = {0, 100000};
+		conmon_example_sleep (& delay);
+		conmon_client_process_sockets (client, NULL, NULL);
+		aud_utime_get (& now);
+	}
+	if (g_communicating)
+	{
+		return AUD_ERR_TIMEDOUT;
+	}
+	return g_last_result;
+}
+
+
+static void
+report_full (aud_error_t result)
+{
+	if (result == AUD_ERR_NOBUFS && ! g_full_reported)
+	{
+		fprintf (stderr, "Inventory is full, new devices will not be recorded (see -max)\n");
+		g_full_reported = AUD_TRUE;
+	}
+}
+
+
+static void
+send_query (conmon_client_t * client, const char * name, uint16_t type)
+{
+	conmon_message_body_t body;
+	conmon_client_request_id_t req_id;
+	aud_error_t result;
+
+	conmon_audinate_init_query_message (& body, type, 0);
+	result =
+		conmon_client_send_control_message (
+			client, & handle_query_response, & req_id,
+			name, CONMON_MESSAGE_CLASS_VENDOR_SPECIFIC, CONMON_VENDOR_ID_AUDINATE,
+			& body, conmon_audinate_query_message_get_size (& body), & k_control_timeout
+		);
+	if (result != AUD_SUCCESS)
+	{
+		g_num_query_errors++;
+	}
+}
+
+
+// Parse MAJOR.MINOR.BUGFIX with an optional .BUILD
+static aud_bool_t
+parse_version (const char * str, dante_version_t * version, dante_version_build_t * build)
+{
+	unsigned int major = 0, minor = 0, bugfix = 0, build_number = 0;
+	int n = sscanf (str, "%u.%u.%u.%u", & major, & minor, & bugfix, & build_number);
+
+	if (n < 3 || major > 0xFF || minor > 0xFF || bugfix > 0xFFFF)
+	{
+		return AUD_FALSE;
+	}
+	version->major = (uint8_t) major;
+	version->minor = (uint8_t) minor;
+	version->bugfix = (uint16_t) bugfix;
+	build->build_number = build_number;
+	return AUD_TRUE;
+}
+
+
+// Parse a capability name, or a capability name prefixed by '!' for one that must be missing
+static aud_bool_t
+parse_capability (const char * str)
+{
+	const aud_bool_t clear = (str [0] == '!');
+	unsigned int i;
+
+	if (clear)
+	{
+		str++;
+	}
+	for (i = 0; i < CONMON_AUDINATE_NUM_CAPABILITIES; i++)
+	{
+		if (! STRCASECMP (str, CAPABILITY_NAMES [i]))
+		{
+			if (clear)
+			{
+				g_filter.capabilities_clear |= 1u << i;
+			}
+			else
+			{
+				g_filter.capabilities_set |= 1u << i;
+			}
+			g_filter.criteria |= CONMON_INVENTORY_FILTER_CAPABILITIES;
+			return AUD_TRUE;
+		}
+	}
+	return AUD_FALSE;
+}
+
+
+static void
+capabilities_to_string (uint32_t flags, char * buf, size_t len)
+{
+	size_t used = 0;
+	unsigned int i;
+
+	buf [0] = 0;
+	for (i = 0; i < 32 && used < len; i++)
+	{
+		if (flags & (1u << i))
+		{
+			used += SNPRINTF (buf + used, len - used, "%s%s", used ? "|" : ""
+				, i < CONMON_AUDINATE_NUM_CAPABILITIES ? CAPABILITY_NAMES [i] : "UNKNOWN"
+			);
+		}
+	}
+}
+
+
+static void
+print_record (const conmon_inventory_record_t * record)
+{
+	char model_id [32];
+
+	if (! (record->have & CONMON_INVENTORY_VERSIONS))
+	{
+		printf ("  %-32s (no versions yet)\n", record->device_name);
+		return;
+	}
+	printf ("  %-32s fw %u.%u.%u.%u sw %u.%u.%u.%u model %s \"%s\" caps 0x%08x%s\n"
+		, record->device_name
+		, record->firmware_version.major, record->firmware_version.minor
+		, record->firmware_version.bugfix, record->firmware_build.build_number
+		, record->software_version.major, record->software_version.minor
+		, record->software_version.bugfix, record->software_build.build_number
+		, conmon_example_model_id_to_string (& record->model_id, model_id, sizeof (model_id))
+		, record->model_name
+		, record->capability_flags
+		, record->pending ? " (stale)" : ""
+	);
+}
+
+
+static void
+print_report (void)
+{
+	conmon_inventory_stats_t stats;
+	unsigned int * indices;
+	unsigned int i, num_matches;
+
+	conmon_inventory_get_stats (g_inventory, & stats);
+	printf ("%u devices: %u current, %u stale (%u awaiting a query); %lu queries (%lu failed), "
+		"%lu updates, %lu changes\n"
+		, stats.num_devices, stats.num_current, stats.num_stale, stats.num_scheduled
+		, stats.num_queries, g_num_query_errors, stats.num_updates, stats.num_changes
+	);
+
+	indices = malloc ((stats.num_devices + 1) * sizeof (* indices));
+	if (! indices)
+	{
+		return;
+	}
+	num_matches = conmon_inventory_query (g_inventory, & g_filter, indices, stats.num_devices);
+	if (g_filter.criteria)
+	{
+		printf ("%u devices match\n", num_matches);
+	}
+	for (i = 0; i < num_matches; i++)
+	{
+		print_record (conmon_inventory_record_at_index (g_inventory, indices [i]));
+	}
+	free (indices);
+	fflush (stdout);
+}
+
+
+static aud_error_t
+write_csv (FILE * fp)
+{
+	const conmon_inventory_record_t * record;
+	unsigned int i;
+
+	fprintf (fp, "device,stale,software,firmware,dante_api,uboot,upgrade,model_id,model_name,"
+		"capabilities,capability_names,manufacturer,manufacturer_name,manf_model_id,manf_model_name,"
+		"manf_model_version,serial_id,manf_software,manf_firmware,manf_capabilities\n");
+	for (i = 0; (record = conmon_inventory_record_at_index (g_inventory, i)) != NULL; i++)
+	{
+		char caps [1024], id [32];
+
+		fprintf (fp, "%s,%u", record->device_name, record->pending ? 1 : 0);
+		if (record->have & CONMON_INVENTORY_VERSIONS)
+		{
+			capabilities_to_string (record->capability_flags, caps, sizeof (caps));
+			fprintf (fp, ",%u.%u.%u.%u,%u.%u.%u.%u,0x%08x,0x%08x,0x%04x,%s,\"%s\",0x%08x,%s"
+				, record->software_version.major, record->software_version.minor
+				, record->software_version.bugfix, record->software_build.build_number
+				, record->firmware_version.major, record->firmware_version.minor
+				, record->firmware_version.bugfix, record->firmware_build.build_number
+				, record->dante_api_version, record->uboot_version, record->upgrade_version
+				, conmon_example_model_id_to_string (& record->model_id, id, sizeof (id))
+				, record->model_name, record->capability_flags, caps
+			);
+		}
+		else
+		{
+			fputs (",,,,,,,,,", fp);
+		}
+		if (record->have & CONMON_INVENTORY_MANF_VERSIONS)
+		{
+			dante_version_t model_version;
+
+			dante_version_from_uint32_8_8_16 (record->manf_model_version, & model_version);
+			fprintf (fp, ",%s,\"%s\""
+				, conmon_example_vendor_id_to_string (& record->manufacturer, id, sizeof (id))
+				, record->manufacturer_name
+			);
+			fprintf (fp, ",%s,\"%s\",%u.%u.%u"
+				, conmon_example_model_id_to_string (& record->manf_model_id, id, sizeof (id))
+				, record->manf_model_name
+				, model_version.major, model_version.minor, model_version.bugfix
+			);
+			fprintf (fp, ",%s,%u.%u.%u.%u,%u.%u.%u.%u,0x%08x\n"
+				, conmon_example_device_id_to_string (& record->serial_id, id, sizeof (id))
+				, record->manf_software_version.major, record->manf_software_version.minor
+				, record->manf_software_version.bugfix, record->manf_software_build.build_number
+				, record->manf_firmware_version.major, record->manf_firmware_version.minor
+				, record->manf_firmware_version.bugfix, record->manf_firmware_build.build_number
+				, record->manf_capabilities
+			);
+		}
+		else
+		{
+			fputs (",,,,,,,,,\n", fp);
+		}
+	}
+	return ferror (fp) ? AUD_ERR_SYSTEM : AUD_SUCCESS;
+}
+
+
+static void
+export_csv (void)
+{
+	aud_errbuf_t errbuf;
+	aud_error_t result;
+	FILE * fp;
+
+	if (! g_csv_file)
+	{
+		return;
+	}
+	fp = fopen (g_csv_file, "w");
+	if (! fp)
+	{
+		fprintf (stderr, "Error opening %s for writing\n", g_csv_file);
+		return;
+	}
+	result = write_csv (fp);
+	if (fclose (fp) != 0 && result == AUD_SUCCESS)
+	{
+		result = AUD_ERR_SYSTEM;
+	}
+	if (result != AUD_SUCCESS)
+	{
+		fprintf (stderr, "Error writing %s: %s\n", g_csv_file, aud_error_message (result, errbuf));
+	}
+}
+
+
+//----------
+// Callbacks
+
+static void
+handle_inventory_event
+(
+	void * context,
+	const conmon_inventory_record_t * record,
+	unsigned int changes
+)
+{
+	static const char * k_change_names[] =
+		{ "new", "software", "firmware", "capabilities", "model", "manufacturer", NULL };
+	aud_ctime_buf_t time_buf;
+	aud_bool_t first = AUD_TRUE;
+	unsigned int i;
+
+	AUD_UNUSED (context);
+
+	if (! g_print_changes)
+	{
+		return;
+	}
+	printf ("#VERSIONS %s '%s' ", aud_utime_ctime_no_newline (NULL, time_buf), record->device_name);
+	for (i = 0; k_change_names [i]; i++)
+	{
+		if (changes & (1u << i))
+		{
+			printf ("%s%s", first ? "" : ",", k_change_names [i]);
+			first = AUD_FALSE;
+		}
+	}
+	putchar ('\n');
+	print_record (record);
+	fflush (stdout);
+}
+
+
+static void
+handle_status_message
+(
+	conmon_client_t * client,
+	conmon_channel_type_t channel_type,
+	conmon_channel_direction_t channel_direction,
+	const conmon_message_head_t * head,
+	const conmon_message_body_t * body
+)
+{
+	const conmon_name_cache_entry_t * source;
+	conmon_instance_id_t instance_id;
+	conmon_aud_decoded_msg_t decoded;
+	const uint16_t body_size = conmon_message_head_get_body_size (head);
+	const uint64_t now = now_ms ();
+
+	AUD_UNUSED (client);
+	AUD_UNUSED (channel_type);
+	AUD_UNUSED (channel_direction);
+
+	if (!conmon_vendor_id_equals (conmon_message_head_get_vendor_id (head), CONMON_VENDOR_ID_AUDINATE))
+	{
+		return;
+	}
+
+	conmon_message_head_get_instance_id (head, & instance_id);
+	source = conmon_name_cache_lookup (g_names, & instance_id);
+	if (! source->device_name)
+	{
+		return;
+	}
+
+	// any status message makes a device known; only version messages change its record
+	switch (conmon_audinate_message_get_type (body))
+	{
+	case CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_STATUS:
+		conmon_aud_decode_versions_status (body, body_size, & decoded.u.versions_status);
+		report_full (conmon_inventory_update_versions (g_inventory,
+			& instance_id, source->device_name, & decoded.u.versions_status, now));
+		break;
+
+	case CONMON_AUDINATE_MESSAGE_TYPE_MANF_VERSIONS_STATUS:
+		conmon_aud_decode_manf_versions_status (body, body_size, & decoded.u.manf_versions_status);
+		report_full (conmon_inventory_update_manf_versions (g_inventory,
+			& instance_id, source->device_name, & decoded.u.manf_versions_status, now));
+		break;
+
+	case CONMON_AUDINATE_MESSAGE_TYPE_UPGRADE_STATUS:
+		// a finished upgrade means new versions once the device restarts
+		if (conmon_aud_decode_upgrade_status (body, body_size, & decoded.u.upgrade_status) == AUD_SUCCESS
+			&& decoded.u.upgrade_status.status.status == CONMON_UPGRADE_STATUS_END_DONE)
+		{
+			report_full (conmon_inventory_invalidate (g_inventory, & instance_id, source->device_name, now));
+			break;
+		}
+		report_full (conmon_inventory_seen (g_inventory, & instance_id, source->device_name, now));
+		break;
+
+	default:
+		report_full (conmon_inventory_seen (g_inventory, & instance_id, source->device_name, now));
+		break;
+	}
+}
+
+
+static void
+handle_sockets_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	g_sockets_changed = AUD_TRUE;
+}
+
+
+static void
+handle_subscriptions_changed
+(
+	conmon_client_t * client,
+	unsigned int num_changes,
+	const conmon_client_subscription_t * const * changes
+)
+{
+	unsigned int i;
+
+	AUD_UNUSED (client);
+
+	conmon_name_cache_invalidate (g_names);
+
+	// a named device coming (back) may have restarted with new versions
+	for (i = 0; i < num_changes; i++)
+	{
+		const char * device_name = conmon_client_subscription_get_device_name (changes [i]);
+		const conmon_instance_id_t * instance_id = conmon_client_subscription_get_instance_id (changes [i]);
+		const conmon_rxstatus_t rxstatus = conmon_client_subscription_get_rxstatus (changes [i]);
+
+		if (device_name && device_name [0] && instance_id
+			&& (rxstatus == CONMON_RXSTATUS_UNICAST || rxstatus == CONMON_RXSTATUS_MULTICAST))
+		{
+			report_full (conmon_inventory_invalidate (g_inventory, instance_id, device_name, now_ms ()));
+		}
+	}
+}
+
+
+static void
+handle_dante_device_name_changed
+(
+	conmon_client_t * client
+)
+{
+	AUD_UNUSED (client);
+	conmon_name_cache_invalidate (g_names);
+}
+
+
+//----------
+// Main
+
+static void
+usage (const char * bin)
+{
+	conmon_inventory_config_t defaults;
+
+	conmon_inventory_config_init (& defaults);
+	printf ("Usage: %s [-p=PORT] [-max=N] [-retry=MS] [-report=SEC] [-csv=FILE] [-quiet]\n"
+		"    [-fw-below=VER] [-fw-at-least=VER] [-sw-below=VER] [-sw-at-least=VER]\n"
+		"    [-cap=[!]NAME] [-model=NAME] [-stale] [DEVICE...]\n", bin);
+	printf ("  Collect versions, model and capabilities from devices into an inventory\n");
+	printf ("  -p=PORT: connect to the conmon server on PORT\n");
+	printf ("  -max=N: hold at most N devices (default %u)\n", defaults.max_devices);
+	printf ("  -retry=MS: query a device again after MS milliseconds without an answer\n"
+		"      (default %u, at most %u queries)\n", defaults.retry_ms, defaults.max_attempts);
+	printf ("  -report=SEC: print the matching devices every SEC seconds as well as on exit\n");
+	printf ("  -csv=FILE: write the whole inventory to FILE as CSV with each report\n");
+	printf ("  -quiet: don't print each change as it happens\n");
+	printf ("  VER is MAJOR.MINOR.BUGFIX[.BUILD]; reports list only devices that match\n"
+		"  every criterion given:\n");
+	printf ("  -fw-below=VER, -fw-at-least=VER: firmware version range\n");
+	printf ("  -sw-below=VER, -sw-at-least=VER: software version range\n");
+	printf ("  -cap=NAME: has capability NAME, or lacks it with -cap=!NAME; may be repeated\n");
+	printf ("  -model=NAME: has the Dante model name NAME\n");
+	printf ("  -stale: is still waiting for its versions\n");
+	printf ("  DEVICE: inventory the named devices, otherwise every device seen on the network\n");
+	printf ("  Ctrl-C prints a report, writes the CSV file and exits\n");
+}
+
+
+int
+main (int argc, char * argv[])
+{
+	aud_error_t result;
+	aud_errbuf_t errbuf;
+	aud_env_t * env = NULL;
+	conmon_client_config_t * config = NULL;
+	conmon_client_t * client = NULL;
+	conmon_client_request_id_t req_id;
+	conmon_inventory_config_t inventory_config;
+	dante_sockets_t sockets;
+	uint16_t server_port = 0;
+	unsigned int report_s = 0;
+	uint64_t next_report_ms = 0;
+	aud_bool_t discover;
+	int a, first_device = argc;
+
+	conmon_inventory_config_init (& inventory_config);
+	conmon_inventory_filter_init (& g_filter);
+
+	for (a = 1; a < argc; a++)
+	{
+		const char * arg = argv[a];
+		if (arg[0] != '-')
+		{
+			first_device = a;
+			break;
+		}
+		if (!strncmp (arg, "-p=", 3) && strlen (arg) > 3)
+		{
+			server_port = (uint16_t) atoi (arg + 3);
+		}
+		else if (!strncmp (arg, "-max=", 5) && strlen (arg) > 5)
+		{
+			inventory_config.max_devices = (unsigned int) atoi (arg + 5);
+		}
+		else if (!strncmp (arg, "-retry=", 7) && strlen (arg) > 7)
+		{
+			inventory_config.retry_ms = (unsigned int) atoi (arg + 7);
+		}
+		else if (!strncmp (arg, "-report=", 8) && strlen (arg) > 8)
+		{
+			report_s = (unsigned int) atoi (arg + 8);
+		}
+		else if (!strncmp (arg, "-csv=", 5) && strlen (arg) > 5)
+		{
+			g_csv_file = arg + 5;
+		}
+		else if (!strcmp (arg, "-quiet"))
+		{
+			g_print_changes = AUD_FALSE;
+		}
+		else if (!strncmp (arg, "-fw-below=", 10)
+			&& parse_version (arg + 10, & g_filter.firmware_below, & g_filter.firmware_below_build))
+		{
+			g_filter.criteria |= CONMON_INVENTORY_FILTER_FIRMWARE_BELOW;
+		}
+		else if (!strncmp (arg, "-fw-at-least=", 13)
+			&& parse_version (arg + 13, & g_filter.firmware_at_least, & g_filter.firmware_at_least_build))
+		{
+			g_filter.criteria |= CONMON_INVENTORY_FILTER_FIRMWARE_AT_LEAST;
+		}
+		else if (!strncmp (arg, "-sw-below=", 10)
+			&& parse_version (arg + 10, & g_filter.software_below, & g_filter.software_below_build))
+		{
+			g_filter.criteria |= CONMON_INVENTORY_FILTER_SOFTWARE_BELOW;
+		}
+		else if (!strncmp (arg, "-sw-at-least=", 13)
+			&& parse_version (arg + 13, & g_filter.software_at_least, & g_filter.software_at_least_build))
+		{
+			g_filter.criteria |= CONMON_INVENTORY_FILTER_SOFTWARE_AT_LEAST;
+		}
+		else if (!strncmp (arg, "-cap=", 5) && parse_capability (arg + 5))
+		{
+			// added to the filter by parse_capability
+		}
+		else if (!strncmp (arg, "-model=", 7) && strlen (arg) > 7)
+		{
+			g_filter.model_name = arg + 7;
+			g_filter.criteria |= CONMON_INVENTORY_FILTER_MODEL_NAME;
+		}
+		else if (!strcmp (arg, "-stale"))
+		{
+			g_filter.criteria |= CONMON_INVENTORY_FILTER_STALE;
+		}
+		else
+		{
+			usage (argv[0]);
+			exit (1);
+		}
+	}
+
+	result = conmon_inventory_new (& inventory_config, & handle_inventory_event, NULL, & g_inventory);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating inventory: %s\n", aud_error_message (result, errbuf));
+		usage (argv[0]);
+		exit (1);
+	}
+	for (a = first_device; a < argc; a++)
+	{
+		result = conmon_inventory_expect (g_inventory, argv[a], now_ms ());
+		if (result != AUD_SUCCESS)
+		{
+			printf ("Invalid device name '%s': %s\n", argv[a], aud_error_message (result, errbuf));
+			goto cleanup;
+		}
+	}
+	discover = (first_device == argc);
+
+	result = aud_env_setup (& env);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error initialising conmon client library: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	config = conmon_client_config_new ("versions_inventory");
+	if (!config)
+	{
+		result = AUD_ERR_NOMEMORY;
+		printf ("Error initialising conmon client config: %s\n",
+			aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+	if (server_port)
+	{
+		conmon_client_config_set_server_port (config, server_port);
+	}
+	result = conmon_client_new_config (env, config, & client);
+	if (client == NULL)
+	{
+		printf ("Error creating client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result = conmon_name_cache_new (client, INVENTORY_NAME_CACHE_SIZE, NULL, NULL, & g_names);
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error creating device name cache: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	// set before connecting to avoid possible race conditions / missed notifications
+	conmon_client_set_sockets_changed_callback (client, handle_sockets_changed);
+	conmon_client_set_subscriptions_changed_callback (client, handle_subscriptions_changed);
+	conmon_client_set_dante_device_name_changed_callback (client, handle_dante_device_name_changed);
+
+	result = conmon_client_connect (client, & handle_response, & req_id);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error connecting client: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	result =
+		conmon_client_register_monitoring_messages (
+			client, & handle_response, & req_id,
+			CONMON_CHANNEL_TYPE_STATUS, CONMON_CHANNEL_DIRECTION_RX,
+			handle_status_message
+		);
+	if (result == AUD_SUCCESS)
+	{
+		result = wait_for_response (client, & k_comms_timeout);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		printf ("Error registering for status messages: %s\n", aud_error_message (result, errbuf));
+		goto cleanup;
+	}
+
+	if (discover)
+	{
+		result =
+			conmon_client_subscribe_global (
+				client, & handle_response, & req_id,
+				CONMON_CHANNEL_TYPE_STATUS
+			);
+		if (result == AUD_SUCCESS)
+		{
+			result = wait_for_response (client, & k_comms_timeout);
+		}
+		if (result != AUD_SUCCESS)
+		{
+			printf ("Error subscribing to status from all devices: %s\n", aud_error_message (result, errbuf));
+			goto cleanup;
+		}
+	}
+	else
+	{
+		for (a = first_device; a < argc; a++)
+		{
+			result =
+				conmon_client_subscribe (
+					client, & handle_response, & req_id,
+					CONMON_CHANNEL_TYPE_STATUS, argv[a]
+				);
+			if (result == AUD_SUCCESS)
+			{
+				result = wait_for_response (client, & k_comms_timeout);
+			}
+			if (result != AUD_SUCCESS)
+			{
+				printf ("Error subscribing to status from %s: %s\n", argv[a], aud_error_message (result, errbuf));
+				goto cleanup;
+			}
+		}
+	}
+
+	printf ("Collecting versions from %s\n", discover ? "all devices" : "the named devices");
+
+	// The loop runs until the user hits CTRL-C, waking whenever a query or report is due
+	signal (SIGINT, sig_handler);
+	if (report_s)
+	{
+		next_report_ms = now_ms () + report_s * 1000;
+	}
+	while (g_running)
+	{
+		aud_utime_t timeout;
+		unsigned int ms, record_index, queries, num_sent = 0;
+		uint64_t now;
+
+		if (g_sockets_changed)
+		{
+			g_sockets_changed = AUD_FALSE;
+			dante_sockets_clear (& sockets);
+			conmon_client_get_sockets (client, & sockets);
+		}
+
+		now = now_ms ();
+		while (num_sent < INVENTORY_MAX_QUERIES_PER_PASS
+			&& conmon_inventory_next_refresh (g_inventory, now, & record_index, & queries))
+		{
+			const char * name = conmon_inventory_record_at_index (g_inventory, record_index)->device_name;
+			if (queries & CONMON_INVENTORY_VERSIONS)
+			{
+				send_query (client, name, CONMON_AUDINATE_MESSAGE_TYPE_VERSIONS_QUERY);
+			}
+			if (queries & CONMON_INVENTORY_MANF_VERSIONS)
+			{
+				send_query (client, name, CONMON_AUDINATE_MESSAGE_TYPE_MANF_VERSIONS_QUERY);
+			}
+			num_sent++;
+		}
+		if (report_s && now >= next_report_ms)
+		{
+			print_report ();
+			export_csv ();
+			next_report_ms = now + report_s * 1000;
+		}
+
+		ms = (num_sent < INVENTORY_MAX_QUERIES_PER_PASS)
+			? conmon_inventory_ms_to_next_refresh (g_inventory, now) : 100;
+		if (report_s && next_report_ms - now < ms)
+		{
+			ms = (unsigned int) (next_report_ms - now);
+		}
+		if (ms > 1000)
+		{
+			ms = 1000;
+		}
+		timeout.tv_sec = ms / 1000;
+		timeout.tv_usec = (ms % 1000) * 1000;
+		conmon_example_client_process (client, & sockets, & timeout, NULL);
+	}
+
+	print_report ();
+	export_csv ();
+	result = AUD_SUCCESS;
+
+cleanup:
+	if (g_names)
+	{
+		conmon_name_cache_delete (g_names);
+	}
+	if (client)
+	{
+		conmon_client_delete (client);
+	}
+	if (config)
+	{
+		conmon_client_config_delete (config);
+	}
+	if (env)
+	{
+		aud_env_release (env);
+	}
+	conmon_inventory_delete (g_inventory);
+	return result;
+}
+
+
+//----------
@@ -12,38 +12,298 @@
 
 #include "dapi_io.h"
 #include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef DAPI_IO_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DAPI_IO_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#define DAPI_IO_AVX2
+#include <immintrin.h>
+#endif
+#endif
 
 //----------------------------------------------------------
 
+static const char k_hex_digits[] = "0123456789abcdef";
 
+// Value of each hex digit, 0xFF for anything else
+static const uint8_t k_hex_values[256] =
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+
+AUD_INLINE void
+hex_encode8_scalar
+(
+	const uint8_t * src,
+	char * hex
+)
+{
+	unsigned i;
+	for (i = 0; i < DANTE_ID64_LEN; i++)
+	{
+		hex[i * 2] = k_hex_digits[src[i] >> 4];
+		hex[i * 2 + 1] = k_hex_digits[src[i] & 0xF];
+	}
+}
+
+/*
+	Decode 16 hex digits. Stops at the first character that is not a hex
+	digit, so it never reads beyond the end of a shorter string.
+ */
+AUD_INLINE aud_bool_t
+hex_decode8_scalar
+(
+	const char * hex,
+	uint8_t * dst
+)
+{
+	unsigned i;
+	for (i = 0; i < DANTE_ID64_LEN; i++)
+	{
+		uint8_t hi = k_hex_values[(uint8_t) hex[i * 2]];
+		uint8_t lo;
+		if (hi > 0xF)
+			return AUD_FALSE;
+		lo = k_hex_values[(uint8_t) hex[i * 2 + 1]];
+		if (lo > 0xF)
+			return AUD_FALSE;
+		dst[i] = (uint8_t) ((hi << 4) | lo);
+	}
+	return AUD_TRUE;
+}
+
+/*
+	Bytes outside 0x20-0x7e become '.'. This is the rule the vector
+	kernels use, and unlike isprint it does not depend on the locale.
+ */
 AUD_INLINE char
-nibble_to_hexchar(uint8_t nibble)
+ascii_or_dot
+(
+	uint8_t ch
+)
 {
-	return nibble + ((nibble <= 9) ? '0' : ('a' - 10));
+	return (ch >= 0x20 && ch < 0x7F) ? (char) ch : '.';
+}
+
+#ifdef DAPI_IO_SSE2
+
+// Nibble values 0-15 in each byte to '0'-'9', 'a'-'f'
+AUD_INLINE __m128i
+sse2_nibbles_to_hex(__m128i x)
+{
+	__m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+	return _mm_add_epi8(_mm_add_epi8(x, _mm_set1_epi8('0')), alpha);
 }
 
 AUD_INLINE void
-byte_to_hex_str
+sse2_hex_encode8
 (
-	uint8_t byte,
+	const uint8_t * src,
 	char * hex
 )
 {
-	hex[0] = nibble_to_hexchar(byte >> 4);
-	hex[1] = nibble_to_hexchar(byte & 0xF);
+	__m128i v = _mm_loadl_epi64((const __m128i *) src);
+	__m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+	__m128i lo = _mm_and_si128(v, _mm_set1_epi8(0x0F));
+	_mm_storeu_si128((__m128i *) hex, sse2_nibbles_to_hex(_mm_unpacklo_epi8(hi, lo)));
 }
 
-AUD_INLINE uint8_t
-hexchar_to_nibble(char hex)
+// Two consecutive identifiers at once
+AUD_INLINE void
+sse2_hex_encode16
+(
+	const uint8_t * src,
+	char * hex0,
+	char * hex1
+)
 {
-	if ('0' <= hex && hex <= '9')
-		return hex - '0';
-	else if ('a' <= hex && hex <= 'f')
-		return hex - 'a' + 10;
-	else if ('A' <= hex && hex <= 'F')
-		return hex - 'A' + 10;
-	else
-		return 0xFF;
+	__m128i v = _mm_loadu_si128((const __m128i *) src);
+	__m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+	__m128i lo = _mm_and_si128(v, _mm_set1_epi8(0x0F));
+	_mm_storeu_si128((__m128i *) hex0, sse2_nibbles_to_hex(_mm_unpacklo_epi8(hi, lo)));
+	_mm_storeu_si128((__m128i *) hex1, sse2_nibbles_to_hex(_mm_unpackhi_epi8(hi, lo)));
+}
+
+/*
+	Decode 16 hex digits. Digits become their value; anything else fails the
+	mask check. Each pair is then combined as (hi << 4) | lo in 16 bit lanes
+	and packed down to bytes.
+ */
+AUD_INLINE aud_bool_t
+sse2_hex_decode8
+(
+	const char * hex,
+	uint8_t * dst
+)
+{
+	__m128i c = _mm_loadu_si128((const __m128i *) hex);
+	__m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+	__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+	__m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+	__m128i value, pairs;
+
+	if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF)
+		return AUD_FALSE;
+
+	value = _mm_or_si128(
+		_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+		_mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+	pairs = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(value, 4), _mm_srli_epi16(value, 8)), _mm_set1_epi16(0x00FF));
+	_mm_storel_epi64((__m128i *) dst, _mm_packus_epi16(pairs, pairs));
+	return AUD_TRUE;
+}
+
+// Two consecutive identifiers, bytes outside 0x20-0x7e become '.'
+AUD_INLINE void
+sse2_ascii_encode16
+(
+	const uint8_t * src,
+	char * dst0,
+	char * dst1
+)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *) src);
+	__m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1F)), _mm_cmpgt_epi8(_mm_set1_epi8(0x7F), v));
+	__m128i out = _mm_or_si128(_mm_and_si128(printable, v), _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+	_mm_storel_epi64((__m128i *) dst0, out);
+	_mm_storel_epi64((__m128i *) dst1, _mm_srli_si128(out, 8));
+}
+
+#endif
+
+#ifdef DAPI_IO_AVX2
+
+AUD_INLINE __m256i
+avx2_nibbles_to_hex(__m256i x)
+{
+	__m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+	return _mm256_add_epi8(_mm256_add_epi8(x, _mm256_set1_epi8('0')), alpha);
+}
+
+// Four consecutive identifiers; unpacking works within each 128 bit lane, so the halves hold 0 and 2, 1 and 3
+AUD_INLINE void
+avx2_hex_encode32
+(
+	const uint8_t * src,
+	char * hex0,
+	char * hex1,
+	char * hex2,
+	char * hex3
+)
+{
+	__m256i v = _mm256_loadu_si256((const __m256i *) src);
+	__m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+	__m256i lo = _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
+	__m256i even = avx2_nibbles_to_hex(_mm256_unpacklo_epi8(hi, lo));
+	__m256i odd = avx2_nibbles_to_hex(_mm256_unpackhi_epi8(hi, lo));
+	_mm_storeu_si128((__m128i *) hex0, _mm256_castsi256_si128(even));
+	_mm_storeu_si128((__m128i *) hex1, _mm256_castsi256_si128(odd));
+	_mm_storeu_si128((__m128i *) hex2, _mm256_extracti128_si256(even, 1));
+	_mm_storeu_si128((__m128i *) hex3, _mm256_extracti128_si256(odd, 1));
+}
+
+// Two identifiers at once, as sse2_hex_decode8
+AUD_INLINE aud_bool_t
+avx2_hex_decode16
+(
+	const char * hex0,
+	const char * hex1,
+	uint8_t * dst0,
+	uint8_t * dst1
+)
+{
+	__m256i c = _mm256_inserti128_si256(
+		_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) hex0)),
+		_mm_loadu_si128((const __m128i *) hex1), 1);
+	__m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+	__m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+	__m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+	__m256i value, pairs, packed;
+
+	if (_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) != -1)
+		return AUD_FALSE;
+
+	value = _mm256_or_si256(
+		_mm256_and_si256(digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+		_mm256_and_si256(alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+	pairs = _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi16(value, 4), _mm256_srli_epi16(value, 8)), _mm256_set1_epi16(0x00FF));
+	packed = _mm256_packus_epi16(pairs, pairs);
+	_mm_storel_epi64((__m128i *) dst0, _mm256_castsi256_si128(packed));
+	_mm_storel_epi64((__m128i *) dst1, _mm256_extracti128_si256(packed, 1));
+	return AUD_TRUE;
+}
+
+#endif
+
+// 8 bytes to 16 hex digits, with the widest kernel available for a single identifier
+AUD_INLINE void
+hex_encode8
+(
+	const uint8_t * src,
+	char * hex
+)
+{
+#ifdef DAPI_IO_SSE2
+	sse2_hex_encode8(src, hex);
+#else
+	hex_encode8_scalar(src, hex);
+#endif
+}
+
+// 16 hex digits to 8 bytes; hex must have at least 16 readable characters
+AUD_INLINE aud_bool_t
+hex_decode8
+(
+	const char * hex,
+	uint8_t * dst
+)
+{
+#ifdef DAPI_IO_SSE2
+	return sse2_hex_decode8(hex, dst);
+#else
+	return hex_decode8_scalar(hex, dst);
+#endif
+}
+
+AUD_INLINE aud_bool_t
+hex_decode4_scalar
+(
+	const char * hex,
+	uint16_t * dst
+)
+{
+	uint16_t value = 0;
+	unsigned i;
+	for (i = 0; i < 4; i++)
+	{
+		uint8_t nibble = k_hex_values[(uint8_t) hex[i]];
+		if (nibble > 0xF)
+			return AUD_FALSE;
+		value = (uint16_t) ((value << 4) | nibble);
+	}
+	*dst = value;
+	return AUD_TRUE;
 }
 
 
@@ -65,13 +325,9 @@ dante_id64_to_str
 	char * buf
 )
 {
-	unsigned i;
 	if (buf)
 	{
-		for (i = 0; i < DANTE_ID64_LEN; i++)
-		{
-			byte_to_hex_str(src_id->data[i], buf + i * 2);
-		}
+		hex_encode8(src_id->data, buf);
 	}
 
 	return buf;
@@ -97,6 +353,12 @@ dante_id64_from_hex
 		str += 2;
 	}
 
+	// the usual case, 16 digits with nothing embedded
+	if (hex_decode8_scalar(str, dst_id->data))
+	{
+		return AUD_SUCCESS;
+	}
+
 	for (i = 0; i < DANTE_ID64_LEN; i++)
 	{
 		uint8_t hi, lo;
@@ -106,8 +368,8 @@ dante_id64_from_hex
 		if (isspace(str[0]))
 			str = drop_whitespace(str);
 
-		hi = hexchar_to_nibble(str[0]);
-		lo = hexchar_to_nibble(str[1]);
+		hi = k_hex_values[(uint8_t) str[0]];
+		lo = k_hex_values[(uint8_t) str[1]];
 		if (hi >= 0x10 || lo >= 0x10)
 			return AUD_ERR_INVALIDDATA;
 		dst_id->data[i] = (hi << 4) | lo;
@@ -130,11 +392,7 @@ dante_id64_to_ascii
 	{
 		for (i = 0; i < DANTE_ID64_LEN; i++)
 		{
-			int ch = (int) src_id->data[i];
-			if (isprint(ch))
-				buf[i] = (char) src_id->data[i];
-			else
-				buf[i] = '.';
+			buf[i] = ascii_or_dot(src_id->data[i]);
 		}
 	}
 
@@ -165,4 +423,461 @@ dante_id64_from_ascii
 }
 
 
+//----------------------------------------------------------
+// Bulk conversions
+
+const char *
+dapi_io_bulk_kernel_name(void)
+{
+#if defined(DAPI_IO_AVX2)
+	return "avx2";
+#elif defined(DAPI_IO_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+
+void
+dante_id64_array_to_hex
+(
+	const dante_id64_t * src_ids,
+	size_t num_ids,
+	char * buf,
+	size_t stride
+)
+{
+	size_t i = 0;
+
+#ifdef DAPI_IO_AVX2
+	for (; i + 4 <= num_ids; i += 4)
+	{
+		char * hex = buf + i * stride;
+		avx2_hex_encode32(src_ids[i].data, hex, hex + stride, hex + stride * 2, hex + stride * 3);
+	}
+#endif
+#ifdef DAPI_IO_SSE2
+	for (; i + 2 <= num_ids; i += 2)
+	{
+		char * hex = buf + i * stride;
+		sse2_hex_encode16(src_ids[i].data, hex, hex + stride);
+	}
+#endif
+	for (; i < num_ids; i++)
+	{
+		hex_encode8(src_ids[i].data, buf + i * stride);
+	}
+}
+
+
+aud_error_t
+dante_id64_array_from_hex
+(
+	dante_id64_t * dst_ids,
+	size_t num_ids,
+	const char * buf,
+	size_t stride,
+	size_t * num_parsed
+)
+{
+	size_t i = 0;
+
+#ifdef DAPI_IO_AVX2
+	for (; i + 2 <= num_ids; i += 2)
+	{
+		const char * hex = buf + i * stride;
+		if (! avx2_hex_decode16(hex, hex + stride, dst_ids[i].data, dst_ids[i + 1].data))
+			break;
+	}
+	// an invalid pair is retried one at a time below to find which failed
+#endif
+	for (; i < num_ids; i++)
+	{
+		if (! hex_decode8(buf + i * stride, dst_ids[i].data))
+			break;
+	}
+
+	if (num_parsed)
+	{
+		*num_parsed = i;
+	}
+	return (i == num_ids) ? AUD_SUCCESS : AUD_ERR_INVALIDDATA;
+}
+
+
+void
+dante_id64_array_to_ascii
+(
+	const dante_id64_t * src_ids,
+	size_t num_ids,
+	char * buf,
+	size_t stride
+)
+{
+	size_t i = 0;
+
+#ifdef DAPI_IO_SSE2
+	for (; i + 2 <= num_ids; i += 2)
+	{
+		char * dst = buf + i * stride;
+		sse2_ascii_encode16(src_ids[i].data, dst, dst + stride);
+	}
+#endif
+	for (; i < num_ids; i++)
+	{
+		char * dst = buf + i * stride;
+		unsigned j;
+		for (j = 0; j < DANTE_ID64_LEN; j++)
+		{
+			dst[j] = ascii_or_dot(src_ids[i].data[j]);
+		}
+	}
+}
+
+
+void
+dante_id64_array_from_ascii
+(
+	dante_id64_t * dst_ids,
+	size_t num_ids,
+	const char * buf,
+	size_t stride
+)
+{
+	size_t i;
+	for (i = 0; i < num_ids; i++)
+	{
+		memcpy(dst_ids[i].data, buf + i * stride, DANTE_ID64_LEN);
+	}
+}
+
+
+void
+conmon_instance_id_array_to_str
+(
+	const conmon_instance_id_t * src_ids,
+	size_t num_ids,
+	char * buf,
+	size_t stride
+)
+{
+	size_t i;
+	for (i = 0; i < num_ids; i++)
+	{
+		char * str = buf + i * stride;
+		uint16_t process_id = src_ids[i].process_id;
+
+		hex_encode8(src_ids[i].device_id.data, str);
+		str[16] = '/';
+		str[17] = k_hex_digits[(process_id >> 12) & 0xF];
+		str[18] = k_hex_digits[(process_id >> 8) & 0xF];
+		str[19] = k_hex_digits[(process_id >> 4) & 0xF];
+		str[20] = k_hex_digits[process_id & 0xF];
+	}
+}
+
+
+aud_error_t
+conmon_instance_id_array_from_str
+(
+	conmon_instance_id_t * dst_ids,
+	size_t num_ids,
+	const char * buf,
+	size_t stride,
+	size_t * num_parsed
+)
+{
+	size_t i;
+	for (i = 0; i < num_ids; i++)
+	{
+		const char * str = buf + i * stride;
+		if (! (hex_decode8(str, dst_ids[i].device_id.data)
+			&& str[16] == '/'
+			&& hex_decode4_scalar(str + 17, &dst_ids[i].process_id)))
+		{
+			break;
+		}
+	}
+
+	if (num_parsed)
+	{
+		*num_parsed = i;
+	}
+	return (i == num_ids) ? AUD_SUCCESS : AUD_ERR_INVALIDDATA;
+}
+
+
+//----------------------------------------------------------
+// Maps and sets keyed on identifiers
+
+struct dapi_id_map
+{
+	unsigned int capacity;
+	unsigned int num_entries;
+	size_t value_stride;
+
+	conmon_instance_id_t * keys;
+	uint32_t * hashes;
+		// kept so probes can skip most key compares and removal can find home slots
+	uint8_t * values;
+
+	uint32_t * slots;
+	uint32_t mask;
+
+	unsigned long num_lookups;
+	unsigned long num_probes;
+};
+
+
+// The slot holding key, or the empty slot where it would go
+static uint32_t
+id_map_probe
+(
+	dapi_id_map_t * map,
+	const conmon_instance_id_t * key,
+	uint32_t hash
+)
+{
+	uint32_t slot = hash & map->mask;
+	uint32_t index;
+
+	map->num_lookups++;
+	while ((index = map->slots[slot]) != DAPI_ID_MAP_NO_ENTRY)
+	{
+		map->num_probes++;
+		if (map->hashes[index] == hash && dapi_instance_id_equals(map->keys + index, key))
+		{
+			break;
+		}
+		slot = (slot + 1) & map->mask;
+	}
+	return slot;
+}
+
+
+aud_error_t
+dapi_id_map_new
+(
+	unsigned int capacity,
+	size_t value_size,
+	dapi_id_map_t ** map_ptr
+)
+{
+	dapi_id_map_t * map;
+	uint32_t num_slots = 1;
+
+	if (! (capacity && map_ptr) || capacity > 0x1000000)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	while (num_slots < 2 * capacity)
+	{
+		num_slots <<= 1;
+	}
+
+	map = calloc(1, sizeof(*map));
+	if (! map)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	map->capacity = capacity;
+	map->value_stride = (value_size + 7) & ~(size_t) 7;
+	map->mask = num_slots - 1;
+	map->keys = malloc(capacity * sizeof(*map->keys));
+	map->hashes = malloc(capacity * sizeof(*map->hashes));
+	map->slots = malloc(num_slots * sizeof(*map->slots));
+	if (map->value_stride)
+	{
+		map->values = malloc(capacity * map->value_stride);
+	}
+	if (! (map->keys && map->hashes && map->slots && (map->values || ! map->value_stride)))
+	{
+		dapi_id_map_delete(map);
+		return AUD_ERR_NOMEMORY;
+	}
+	dapi_id_map_clear(map);
+
+	*map_ptr = map;
+	return AUD_SUCCESS;
+}
+
+
+void
+dapi_id_map_delete
+(
+	dapi_id_map_t * map
+)
+{
+	if (map)
+	{
+		free(map->slots);
+		free(map->values);
+		free(map->hashes);
+		free(map->keys);
+		free(map);
+	}
+}
+
+
+void
+dapi_id_map_clear
+(
+	dapi_id_map_t * map
+)
+{
+	// 0xFF bytes give DAPI_ID_MAP_NO_ENTRY in every slot
+	memset(map->slots, 0xFF, (map->mask + 1) * sizeof(*map->slots));
+	map->num_entries = 0;
+}
+
+
+unsigned int
+dapi_id_map_size
+(
+	const dapi_id_map_t * map
+)
+{
+	return map->num_entries;
+}
+
+
+unsigned int
+dapi_id_map_find
+(
+	dapi_id_map_t * map,
+	const conmon_instance_id_t * key
+)
+{
+	return map->slots[id_map_probe(map, key, dapi_instance_id_hash(key))];
+}
+
+
+aud_error_t
+dapi_id_map_insert
+(
+	dapi_id_map_t * map,
+	const conmon_instance_id_t * key,
+	unsigned int * index,
+	aud_bool_t * added
+)
+{
+	const uint32_t hash = dapi_instance_id_hash(key);
+	const uint32_t slot = id_map_probe(map, key, hash);
+	uint32_t i = map->slots[slot];
+
+	if (i == DAPI_ID_MAP_NO_ENTRY)
+	{
+		if (map->num_entries >= map->capacity)
+		{
+			return AUD_ERR_NOBUFS;
+		}
+		i = map->num_entries++;
+		map->slots[slot] = i;
+		map->keys[i] = *key;
+		map->hashes[i] = hash;
+		if (map->value_stride)
+		{
+			memset(map->values + i * map->value_stride, 0, map->value_stride);
+		}
+		if (added)
+		{
+			*added = AUD_TRUE;
+		}
+	}
+	else if (added)
+	{
+		*added = AUD_FALSE;
+	}
+	*index = i;
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+dapi_id_map_remove
+(
+	dapi_id_map_t * map,
+	const conmon_instance_id_t * key
+)
+{
+	uint32_t hole = id_map_probe(map, key, dapi_instance_id_hash(key));
+	uint32_t i = map->slots[hole];
+	uint32_t last, slot;
+
+	if (i == DAPI_ID_MAP_NO_ENTRY)
+	{
+		return AUD_ERR_NOTFOUND;
+	}
+
+	// shift back any later entry in the run whose home slot is not between the hole and itself
+	for (slot = (hole + 1) & map->mask; map->slots[slot] != DAPI_ID_MAP_NO_ENTRY; slot = (slot + 1) & map->mask)
+	{
+		uint32_t home = map->hashes[map->slots[slot]] & map->mask;
+		if (((slot - home) & map->mask) >= ((slot - hole) & map->mask))
+		{
+			map->slots[hole] = map->slots[slot];
+			hole = slot;
+		}
+	}
+	map->slots[hole] = DAPI_ID_MAP_NO_ENTRY;
+
+	// keep the entries dense by moving the last one into the gap
+	last = --map->num_entries;
+	if (i != last)
+	{
+		for (slot = map->hashes[last] & map->mask; map->slots[slot] != last; slot = (slot + 1) & map->mask)
+			;
+		map->slots[slot] = i;
+		map->keys[i] = map->keys[last];
+		map->hashes[i] = map->hashes[last];
+		if (map->value_stride)
+		{
+			memcpy(map->values + i * map->value_stride, map->values + last * map->value_stride, map->value_stride);
+		}
+	}
+	return AUD_SUCCESS;
+}
+
+
+const conmon_instance_id_t *
+dapi_id_map_key_at
+(
+	const dapi_id_map_t * map,
+	unsigned int index
+)
+{
+	return (index < map->num_entries) ? map->keys + index : NULL;
+}
+
+
+void *
+dapi_id_map_value_at
+(
+	const dapi_id_map_t * map,
+	unsigned int index
+)
+{
+	if (index >= map->num_entries || ! map->value_stride)
+	{
+		return NULL;
+	}
+	return map->values + index * map->value_stride;
+}
+
+
+void
+dapi_id_map_get_stats
+(
+	const dapi_id_map_t * map,
+	dapi_id_map_stats_t * stats
+)
+{
+	stats->num_entries = map->num_entries;
+	stats->capacity = map->capacity;
+	stats->num_lookups = map->num_lookups;
+	stats->num_probes = map->num_probes;
+}
+
+
 //----------------------------------------------------------
@@ -13,6 +13,8 @@
 
 #include "audinate/dante_api.h"
 
+#include <string.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -95,6 +97,382 @@ dante_id64_from_ascii
 );
 
 
+//----------------------------------------------------------
+// Bulk conversions
+
+/*
+	The bulk functions convert arrays of identifiers held at a fixed stride
+	in a text buffer: identifier i is read from or written to buf + i * stride.
+	The bytes between identifiers are never touched, so a caller can fill in
+	separators and line endings once and re-use the buffer for each batch.
+
+	They use SSE2 or AVX2 when the compiler targets them (__SSE2__, __AVX2__,
+	or x64 with MSVC) and a table-driven scalar loop otherwise. Results are
+	the same either way.
+ */
+
+// Name of the kernel the bulk conversions were built with: "avx2", "sse2" or "scalar"
+const char *
+dapi_io_bulk_kernel_name(void);
+
+/*
+	Render an array of dante_id64_t as lower case hex, as dante_id64_to_str.
+
+	@param stride Distance between identifiers in buf. At least 16.
+ */
+void
+dante_id64_array_to_hex
+(
+	const dante_id64_t * src_ids,
+	size_t num_ids,
+	char * buf,
+	size_t stride
+);
+
+/*
+	Parse an array of dante_id64_t from hex. Each identifier must be exactly
+	16 hex digits in either case, with no prefix or whitespace.
+
+	@param stride Distance between identifiers in buf. At least 16.
+	@param num_parsed If not NULL, set to the number of identifiers parsed
+		before the first invalid one (or num_ids on success)
+
+	@return AUD_ERR_INVALIDDATA if an identifier contains a non-hex character
+ */
+aud_error_t
+dante_id64_array_from_hex
+(
+	dante_id64_t * dst_ids,
+	size_t num_ids,
+	const char * buf,
+	size_t stride,
+	size_t * num_parsed
+);
+
+/*
+	Render an array of dante_id64_t as ASCII, as dante_id64_to_ascii in the
+	"C" locale: bytes outside 0x20-0x7e are rendered as '.'.
+
+	@param stride Distance between identifiers in buf. At least 8.
+ */
+void
+dante_id64_array_to_ascii
+(
+	const dante_id64_t * src_ids,
+	size_t num_ids,
+	char * buf,
+	size_t stride
+);
+
+/*
+	Copy an array of dante_id64_t from ASCII, 8 characters each.
+
+	@param stride Distance between identifiers in buf. At least 8.
+ */
+void
+dante_id64_array_from_ascii
+(
+	dante_id64_t * dst_ids,
+	size_t num_ids,
+	const char * buf,
+	size_t stride
+);
+
+// Length of an instance id rendered as 16 hex digits, '/' and a 4 digit process id
+#define CONMON_INSTANCE_ID_STR_LEN (DANTE_ID64_LEN * 2 + 5)
+
+/*
+	Render an array of conmon_instance_id_t in the same form as
+	conmon_example_instance_id_to_string, eg. "001dc1fffe000001/0001".
+
+	@param stride Distance between identifiers in buf. At least
+		CONMON_INSTANCE_ID_STR_LEN.
+ */
+void
+conmon_instance_id_array_to_str
+(
+	const conmon_instance_id_t * src_ids,
+	size_t num_ids,
+	char * buf,
+	size_t stride
+);
+
+/*
+	Parse an array of conmon_instance_id_t written by
+	conmon_instance_id_array_to_str. Hex digits may be in either case.
+
+	@return AUD_ERR_INVALIDDATA if an identifier is malformed, with
+		num_parsed (if not NULL) set to its index
+ */
+aud_error_t
+conmon_instance_id_array_from_str
+(
+	conmon_instance_id_t * dst_ids,
+	size_t num_ids,
+	const char * buf,
+	size_t stride,
+	size_t * num_parsed
+);
+
+
+//----------------------------------------------------------
+// Hashing and comparison
+
+/*
+	Hashes for in-memory tables. An identifier is read as one 64 bit word and
+	run through the MurmurHash3 finaliser, so identifiers that differ only in
+	their last bytes (as devices from one manufacturer do) still spread over
+	the whole table. Hashes depend on byte order and must not be stored.
+ */
+
+AUD_INLINE uint64_t
+dapi_id64_bits(const dante_id64_t * id)
+{
+	uint64_t bits;
+	memcpy(&bits, id->data, sizeof(bits));
+	return bits;
+}
+
+AUD_INLINE uint32_t
+dapi_hash_mix64(uint64_t v)
+{
+	v ^= v >> 33;
+	v *= 0xFF51AFD7ED558CCDull;
+	v ^= v >> 33;
+	v *= 0xC4CEB9FE1A85EC53ull;
+	v ^= v >> 33;
+	return (uint32_t) v;
+}
+
+AUD_INLINE uint32_t
+dapi_id64_hash(const dante_id64_t * id)
+{
+	return dapi_hash_mix64(dapi_id64_bits(id));
+}
+
+AUD_INLINE aud_bool_t
+dapi_id64_equals(const dante_id64_t * a, const dante_id64_t * b)
+{
+	return dapi_id64_bits(a) == dapi_id64_bits(b);
+}
+
+AUD_INLINE uint32_t
+dapi_instance_id_hash(const conmon_instance_id_t * id)
+{
+	uint64_t bits;
+	memcpy(&bits, id->device_id.data, sizeof(bits));
+	return dapi_hash_mix64(bits ^ (id->process_id * 0x9E3779B97F4A7C15ull));
+}
+
+AUD_INLINE aud_bool_t
+dapi_instance_id_equals(const conmon_instance_id_t * a, const conmon_instance_id_t * b)
+{
+	return a->process_id == b->process_id
+		&& ! memcmp(a->device_id.data, b->device_id.data, sizeof(a->device_id.data));
+}
+
+/*
+	Names are hashed with FNV-1a, which is cheap on short strings. Device
+	and channel names compare case-insensitively, so dapi_name_hash folds
+	ASCII case and dapi_name_equals matches it; neither depends on the
+	locale. The byte version is for keys that are not names or that are
+	case sensitive, and can be chained through hash.
+ */
+
+#define DAPI_FNV1A_BASIS 2166136261u
+#define DAPI_FNV1A_PRIME 16777619u
+
+AUD_INLINE uint32_t
+dapi_fnv1a_bytes(uint32_t hash, const void * data, size_t len)
+{
+	const uint8_t * p = (const uint8_t *) data;
+	size_t i;
+	for (i = 0; i < len; i++)
+	{
+		hash ^= p[i];
+		hash *= DAPI_FNV1A_PRIME;
+	}
+	return hash;
+}
+
+AUD_INLINE uint8_t
+dapi_ascii_fold(char c)
+{
+	return (uint8_t) ((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+}
+
+AUD_INLINE uint32_t
+dapi_name_hash(const char * name)
+{
+	uint32_t hash = DAPI_FNV1A_BASIS;
+	for (; *name; name++)
+	{
+		hash ^= dapi_ascii_fold(*name);
+		hash *= DAPI_FNV1A_PRIME;
+	}
+	return hash;
+}
+
+AUD_INLINE aud_bool_t
+dapi_name_equals(const char * a, const char * b)
+{
+	for (; *a && *b; a++, b++)
+	{
+		if (dapi_ascii_fold(*a) != dapi_ascii_fold(*b))
+		{
+			return AUD_FALSE;
+		}
+	}
+	return *a == *b;
+}
+
+
+//----------------------------------------------------------
+// Maps and sets keyed on identifiers
+
+/*
+	An open addressing hash map from conmon_instance_id_t to a fixed size
+	value, for per-device indexes. A map created with a value size of 0 is a
+	set.
+
+	Keys and values are stored densely in order of insertion and found
+	through a table of slot indexes at least twice the capacity, probed
+	linearly. Removal shifts later probes back rather than leaving
+	tombstones, and moves the last entry into the hole, so entry indexes are
+	stable until the next removal or clear.
+
+	Maps keyed on dante_id64_t use the _id64 wrappers, which use a process
+	id of 0. A map should be keyed on one kind of identifier or the other.
+
+	Values are zeroed when their key is inserted and aligned to 8 bytes.
+ */
+
+#define DAPI_ID_MAP_NO_ENTRY 0xFFFFFFFFu
+
+typedef struct dapi_id_map dapi_id_map_t;
+
+typedef struct dapi_id_map_stats
+{
+	unsigned int num_entries;
+	unsigned int capacity;
+	unsigned long num_lookups;
+	unsigned long num_probes;
+		// slots examined by all lookups, so probes per lookup shows how well keys spread
+} dapi_id_map_stats_t;
+
+aud_error_t
+dapi_id_map_new
+(
+	unsigned int capacity,
+	size_t value_size,
+	dapi_id_map_t ** map_ptr
+);
+
+void
+dapi_id_map_delete
+(
+	dapi_id_map_t * map
+);
+
+void
+dapi_id_map_clear
+(
+	dapi_id_map_t * map
+);
+
+unsigned int
+dapi_id_map_size
+(
+	const dapi_id_map_t * map
+);
+
+// @return the index of the entry for key, or DAPI_ID_MAP_NO_ENTRY
+unsigned int
+dapi_id_map_find
+(
+	dapi_id_map_t * map,
+	const conmon_instance_id_t * key
+);
+
+/*
+	Find the entry for key, adding one with a zeroed value if there is none.
+
+	@param index Set to the index of the entry
+	@param added If not NULL, set to whether the entry is new
+
+	@return AUD_ERR_NOBUFS if the key is new and the map is full
+ */
+aud_error_t
+dapi_id_map_insert
+(
+	dapi_id_map_t * map,
+	const conmon_instance_id_t * key,
+	unsigned int * index,
+	aud_bool_t * added
+);
+
+// @return AUD_ERR_NOTFOUND if there is no entry for key
+aud_error_t
+dapi_id_map_remove
+(
+	dapi_id_map_t * map,
+	const conmon_instance_id_t * key
+);
+
+const conmon_instance_id_t *
+dapi_id_map_key_at
+(
+	const dapi_id_map_t * map,
+	unsigned int index
+);
+
+// @return NULL for a set
+void *
+dapi_id_map_value_at
+(
+	const dapi_id_map_t * map,
+	unsigned int index
+);
+
+void
+dapi_id_map_get_stats
+(
+	const dapi_id_map_t * map,
+	dapi_id_map_stats_t * stats
+);
+
+AUD_INLINE void
+dapi_id_map_key_from_id64(conmon_instance_id_t * key, const dante_id64_t * id)
+{
+	memcpy(key->device_id.data, id->data, sizeof(key->device_id.data));
+	key->process_id = 0;
+}
+
+AUD_INLINE unsigned int
+dapi_id_map_find_id64(dapi_id_map_t * map, const dante_id64_t * id)
+{
+	conmon_instance_id_t key;
+	dapi_id_map_key_from_id64(&key, id);
+	return dapi_id_map_find(map, &key);
+}
+
+AUD_INLINE aud_error_t
+dapi_id_map_insert_id64(dapi_id_map_t * map, const dante_id64_t * id, unsigned int * index, aud_bool_t * added)
+{
+	conmon_instance_id_t key;
+	dapi_id_map_key_from_id64(&key, id);
+	return dapi_id_map_insert(map, &key, index, added);
+}
+
+AUD_INLINE aud_error_t
+dapi_id_map_remove_id64(dapi_id_map_t * map, const dante_id64_t * id)
+{
+	conmon_instance_id_t key;
+	dapi_id_map_key_from_id64(&key, id);
+	return dapi_id_map_remove(map, &key);
+}
+
+
 //----------------------------------------------------------
 
 #ifdef __cplusplus
@@ -0,0 +1,927 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Check the bulk identifier conversions in dapi_io against the
+ *            single identifier ones, then time them
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+/*
+	The bulk conversions are checked first, and nothing is timed unless they
+	agree with the single identifier functions (and with the printf based
+	helpers in conmon_examples.h) on every input:
+
+	  - random identifiers at random strides and buffer offsets, checking
+	    that the bytes between identifiers are left alone
+	  - hex with random upper and lower case digits
+	  - hex with one character replaced by a random byte, checking the
+	    error and the number of identifiers parsed before it
+
+	With -c only the checks run, which is quick enough for every build; the
+	exit status is 0 if they all passed.
+
+	The timings compare the bulk functions with a loop over the single
+	identifier functions and with snprintf, on identifiers laid out one per
+	line as in a log or an export. Results are CSV, one line per path.
+
+	The id map is checked against a plain array with random inserts, finds
+	and removes over a small set of keys, so that the map fills, empties and
+	shifts probes back on removal, and is then timed for inserts, hits,
+	misses and removes. How many slots a lookup examines is also reported
+	for identifiers allocated in sequence from one manufacturer prefix, for
+	the map's hash and for FNV-1a over the bytes.
+
+	The kernel in use is fixed when dapi_io.c is compiled; build with
+	-mavx2, with the default flags, or with -DDAPI_IO_NO_SIMD to compare.
+ */
+
+//----------
+// Include
+
+#include "conmon_examples.h"
+#include "dapi_io.h"
+
+#include <ctype.h>
+
+#ifndef WIN32
+	#include <libgen.h>
+#endif
+
+//----------
+// Types and Constants
+
+static char * g_progname;
+
+enum
+{
+	BENCH_DEFAULT_IDS = 1000000,
+	BENCH_DEFAULT_ROUNDS = 10000,
+	BENCH_MAX_FUZZ_IDS = 67,
+		// odd, so every kernel's tail loop is exercised
+	BENCH_MAX_FUZZ_STRIDE = CONMON_INSTANCE_ID_STR_LEN + 8,
+	BENCH_FUZZ_BUF_SIZE = BENCH_MAX_FUZZ_IDS * BENCH_MAX_FUZZ_STRIDE + 32,
+	BENCH_SENTINEL = 0xA5,
+	BENCH_MAP_DEVICES = 8,
+	BENCH_MAP_KEYS = 64,
+		// BENCH_MAP_DEVICES devices with several processes each
+	BENCH_MAP_CAPACITY = 48,
+		// less than BENCH_MAP_KEYS so the map fills up
+	BENCH_MAP_OPS = 256
+};
+
+typedef struct bench_info
+{
+	// options
+	unsigned long num_ids;
+	unsigned long rounds;
+	uint64_t seed;
+	aud_bool_t check_only;
+
+	uint64_t rng;
+	unsigned long failures;
+	dapi_id_map_t * check_map;
+
+	// stops the compiler discarding results
+	uint32_t checksum;
+} bench_info_t;
+
+static bench_info_t g_info;
+
+
+//----------
+// Local functions
+
+AUD_INLINE const char *
+pname (void)
+{
+#ifdef WIN32
+	return g_progname;
+#else
+	return basename (g_progname);
+#endif
+}
+
+
+static int
+usage (const char * msg)
+{
+	const char * name = pname ();
+
+	if (msg)
+	{
+		fprintf (stderr, "%s: %s\n", name, msg);
+	}
+
+	fprintf (stderr,
+		"Usage: %s [-c] [-n ids] [-r rounds] [-s seed]\n"
+		"  -c  run the randomised checks only, without timing\n"
+		"  -n  identifiers per timed run (default %u)\n"
+		"  -r  rounds of randomised checks before timing (default %u)\n"
+		"  -s  seed for the randomised checks (default: time)\n"
+		, name, BENCH_DEFAULT_IDS, BENCH_DEFAULT_ROUNDS
+	);
+
+	return 2;
+}
+
+
+static int
+handle_args (bench_info_t * info, int argc, char ** argv)
+{
+	int curr_arg_index = 1;
+
+	g_progname = argv [0];
+	info->num_ids = BENCH_DEFAULT_IDS;
+	info->rounds = BENCH_DEFAULT_ROUNDS;
+	info->seed = conmon_example_clock_ns ();
+
+	while (curr_arg_index < argc && argv [curr_arg_index][0] == '-')
+	{
+		char * arg = argv [curr_arg_index++];
+
+		if (! strcmp (arg, "-c"))
+		{
+			info->check_only = AUD_TRUE;
+			continue;
+		}
+		if (curr_arg_index >= argc)
+		{
+			return usage ("Missing argument");
+		}
+
+		switch (arg [1])
+		{
+		case 'n':
+			info->num_ids = strtoul (argv [curr_arg_index++], NULL, 0);
+			if (! info->num_ids)
+			{
+				return usage ("Invalid number of identifiers");
+			}
+			break;
+
+		case 'r':
+			info->rounds = strtoul (argv [curr_arg_index++], NULL, 0);
+			break;
+
+		case 's':
+			info->seed = strtoul (argv [curr_arg_index++], NULL, 0);
+			break;
+
+		default:
+			fprintf (stderr, "%s: Unknown option '%s'\n"
+				, pname (), arg
+			);
+			return usage (NULL);
+		}
+	}
+
+	if (curr_arg_index != argc)
+	{
+		return usage ("Unexpected arguments");
+	}
+	return 0;
+}
+
+
+// xorshift64*, good enough to spread test cases and cheap to reproduce from a seed
+AUD_INLINE uint64_t
+random64 (bench_info_t * info)
+{
+	info->rng ^= info->rng >> 12;
+	info->rng ^= info->rng << 25;
+	info->rng ^= info->rng >> 27;
+	return info->rng * 0x2545F4914F6CDD1Dull;
+}
+
+
+AUD_INLINE unsigned int
+random_below (bench_info_t * info, unsigned int n)
+{
+	return (unsigned int) (random64 (info) % n);
+}
+
+
+static void
+random_id64 (bench_info_t * info, dante_id64_t * id)
+{
+	uint64_t r = random64 (info);
+	unsigned int i;
+
+	// mix in runs of printable and zero bytes, as real identifiers have
+	switch (random_below (info, 4))
+	{
+	case 0:
+		memset (id->data, 0, DANTE_ID64_LEN);
+		id->data [random_below (info, DANTE_ID64_LEN)] = (uint8_t) r;
+		break;
+	case 1:
+		for (i = 0; i < DANTE_ID64_LEN; i++)
+		{
+			id->data [i] = (uint8_t) (0x20 + random_below (info, 0x60));
+		}
+		break;
+	default:
+		for (i = 0; i < DANTE_ID64_LEN; i++)
+		{
+			id->data [i] = (uint8_t) (r >> (i * 8));
+		}
+		break;
+	}
+}
+
+
+static void
+fail (bench_info_t * info, const char * check, unsigned long round, const char * detail)
+{
+	info->failures++;
+	if (info->failures <= 10)
+	{
+		fprintf (stderr, "%s: %s failed in round %lu (seed %llu): %s\n"
+			, pname (), check, round, (unsigned long long) info->seed, detail
+		);
+	}
+}
+
+
+// The bytes between identifiers, and either side of the buffer, must still be the sentinel
+static aud_bool_t
+gaps_untouched (const uint8_t * buf, size_t offset, size_t n, size_t stride, size_t width)
+{
+	size_t i, end = offset + (n ? (n - 1) * stride + width : 0);
+
+	for (i = 0; i < BENCH_FUZZ_BUF_SIZE; i++)
+	{
+		aud_bool_t inside = (i >= offset && i < end && (i - offset) % stride < width);
+		if (! inside && buf [i] != BENCH_SENTINEL)
+		{
+			return AUD_FALSE;
+		}
+	}
+	return AUD_TRUE;
+}
+
+
+// A strict reference: exactly 16 hex digits, with the value from dante_id64_from_hex
+static aud_bool_t
+reference_from_hex (const char * hex, dante_id64_t * id)
+{
+	char tmp [DANTE_ID64_LEN * 2 + 1];
+	unsigned int i;
+
+	for (i = 0; i < DANTE_ID64_LEN * 2; i++)
+	{
+		if (! isxdigit ((unsigned char) hex [i]))
+		{
+			return AUD_FALSE;
+		}
+	}
+	memcpy (tmp, hex, DANTE_ID64_LEN * 2);
+	tmp [DANTE_ID64_LEN * 2] = '\0';
+	return dante_id64_from_hex (id, tmp) == AUD_SUCCESS;
+}
+
+
+static void
+verify_id64 (bench_info_t * info, unsigned long round)
+{
+	static dante_id64_t ids [BENCH_MAX_FUZZ_IDS], parsed [BENCH_MAX_FUZZ_IDS];
+	static uint8_t buf [BENCH_FUZZ_BUF_SIZE];
+	size_t n = random_below (info, BENCH_MAX_FUZZ_IDS + 1);
+	size_t stride = DANTE_ID64_LEN * 2 + random_below (info, 9);
+	size_t offset = random_below (info, 16);
+	char * text = (char *) buf + offset;
+	size_t i, num_parsed, expect_parsed;
+	aud_error_t result;
+
+	for (i = 0; i < n; i++)
+	{
+		random_id64 (info, ids + i);
+	}
+
+	// encode
+	memset (buf, BENCH_SENTINEL, sizeof (buf));
+	dante_id64_array_to_hex (ids, n, text, stride);
+	for (i = 0; i < n; i++)
+	{
+		dante_id64_str_buf_t expect;
+		dante_id64_to_str (ids + i, expect);
+		if (memcmp (text + i * stride, expect, DANTE_ID64_LEN * 2))
+		{
+			fail (info, "dante_id64_array_to_hex", round, "differs from dante_id64_to_str");
+			return;
+		}
+	}
+	if (! gaps_untouched (buf, offset, n, stride, DANTE_ID64_LEN * 2))
+	{
+		fail (info, "dante_id64_array_to_hex", round, "wrote outside the identifiers");
+		return;
+	}
+
+	// decode, in mixed case and perhaps with one bad character
+	for (i = 0; i < n * stride; i++)
+	{
+		if ((i % stride) < DANTE_ID64_LEN * 2 && random_below (info, 2))
+		{
+			text [i] = (char) toupper ((unsigned char) text [i]);
+		}
+	}
+	if (n && random_below (info, 2))
+	{
+		size_t bad = random_below (info, (unsigned int) n) * stride + random_below (info, DANTE_ID64_LEN * 2);
+		text [bad] = (char) random_below (info, 256);
+	}
+	expect_parsed = n;
+	for (i = 0; i < n; i++)
+	{
+		dante_id64_t expect;
+		if (! reference_from_hex (text + i * stride, & expect))
+		{
+			expect_parsed = i;
+			break;
+		}
+		// a replacement that is still a hex digit changes the value
+		ids [i] = expect;
+	}
+	result = dante_id64_array_from_hex (parsed, n, text, stride, & num_parsed);
+	if (num_parsed != expect_parsed
+		|| result != ((expect_parsed == n) ? AUD_SUCCESS : AUD_ERR_INVALIDDATA))
+	{
+		fail (info, "dante_id64_array_from_hex", round, "wrong result or count");
+		return;
+	}
+	if (num_parsed && memcmp (parsed, ids, num_parsed * sizeof (dante_id64_t)))
+	{
+		fail (info, "dante_id64_array_from_hex", round, "differs from dante_id64_from_hex");
+		return;
+	}
+
+	// ascii
+	memset (buf, BENCH_SENTINEL, sizeof (buf));
+	stride = DANTE_ID64_LEN + random_below (info, 9);
+	dante_id64_array_to_ascii (ids, n, text, stride);
+	for (i = 0; i < n; i++)
+	{
+		dante_id64_ascii_buf_t expect;
+		dante_id64_to_ascii (ids + i, expect);
+		if (memcmp (text + i * stride, expect, DANTE_ID64_LEN))
+		{
+			fail (info, "dante_id64_array_to_ascii", round, "differs from dante_id64_to_ascii");
+			return;
+		}
+	}
+	if (! gaps_untouched (buf, offset, n, stride, DANTE_ID64_LEN))
+	{
+		fail (info, "dante_id64_array_to_ascii", round, "wrote outside the identifiers");
+		return;
+	}
+	dante_id64_array_from_ascii (parsed, n, text, stride);
+	for (i = 0; i < n; i++)
+	{
+		dante_id64_t expect;
+		char tmp [DANTE_ID64_LEN + 1];
+		memcpy (tmp, text + i * stride, DANTE_ID64_LEN);
+		tmp [DANTE_ID64_LEN] = '\0';
+		if (dante_id64_from_ascii (& expect, tmp) == AUD_SUCCESS
+			&& memcmp (& expect, parsed + i, sizeof (expect)))
+		{
+			fail (info, "dante_id64_array_from_ascii", round, "differs from dante_id64_from_ascii");
+			return;
+		}
+	}
+}
+
+
+static void
+verify_instance_id (bench_info_t * info, unsigned long round)
+{
+	static conmon_instance_id_t ids [BENCH_MAX_FUZZ_IDS], parsed [BENCH_MAX_FUZZ_IDS];
+	static uint8_t buf [BENCH_FUZZ_BUF_SIZE];
+	size_t n = random_below (info, BENCH_MAX_FUZZ_IDS + 1);
+	size_t stride = CONMON_INSTANCE_ID_STR_LEN + random_below (info, 8);
+	size_t offset = random_below (info, 16);
+	char * text = (char *) buf + offset;
+	size_t i, num_parsed, bad_id = n;
+	aud_error_t result;
+
+	memset (ids, 0, sizeof (ids));
+	for (i = 0; i < n; i++)
+	{
+		dante_id64_t device_id;
+		random_id64 (info, & device_id);
+		memcpy (ids [i].device_id.data, device_id.data, DANTE_ID64_LEN);
+		ids [i].process_id = (uint16_t) random64 (info);
+	}
+
+	memset (buf, BENCH_SENTINEL, sizeof (buf));
+	conmon_instance_id_array_to_str (ids, n, text, stride);
+	for (i = 0; i < n; i++)
+	{
+		char expect [64];
+		conmon_example_instance_id_to_string (ids + i, expect, sizeof (expect));
+		if (strlen (expect) != CONMON_INSTANCE_ID_STR_LEN
+			|| memcmp (text + i * stride, expect, CONMON_INSTANCE_ID_STR_LEN))
+		{
+			fail (info, "conmon_instance_id_array_to_str", round, "differs from conmon_example_instance_id_to_string");
+			return;
+		}
+	}
+	if (! gaps_untouched (buf, offset, n, stride, CONMON_INSTANCE_ID_STR_LEN))
+	{
+		fail (info, "conmon_instance_id_array_to_str", round, "wrote outside the identifiers");
+		return;
+	}
+
+	// break the separator or a process id digit in one identifier
+	if (n && random_below (info, 2))
+	{
+		bad_id = random_below (info, (unsigned int) n);
+		text [bad_id * stride + 16 + random_below (info, 5)] = 'g';
+	}
+	memset (parsed, 0, sizeof (parsed));
+	result = conmon_instance_id_array_from_str (parsed, n, text, stride, & num_parsed);
+	if (num_parsed != bad_id || result != ((bad_id == n) ? AUD_SUCCESS : AUD_ERR_INVALIDDATA))
+	{
+		fail (info, "conmon_instance_id_array_from_str", round, "wrong result or count");
+		return;
+	}
+	for (i = 0; i < num_parsed; i++)
+	{
+		if (memcmp (parsed [i].device_id.data, ids [i].device_id.data, DANTE_ID64_LEN)
+			|| parsed [i].process_id != ids [i].process_id)
+		{
+			fail (info, "conmon_instance_id_array_from_str", round, "did not round trip");
+			return;
+		}
+	}
+}
+
+
+static void
+verify_id_map (bench_info_t * info, unsigned long round)
+{
+	dapi_id_map_t * map = info->check_map;
+	conmon_instance_id_t keys [BENCH_MAP_KEYS];
+	aud_bool_t present [BENCH_MAP_KEYS];
+	uint32_t values [BENCH_MAP_KEYS];
+	unsigned int num_present = 0, op, i;
+
+	for (i = 0; i < BENCH_MAP_DEVICES; i++)
+	{
+		dante_id64_t device_id;
+		unsigned int j;
+
+		// the reference needs distinct keys, so redraw a device that repeats an earlier one
+		do
+		{
+			random_id64 (info, & device_id);
+			for (j = 0; j < i && memcmp (keys [j].device_id.data, device_id.data, DANTE_ID64_LEN); j++)
+				;
+		} while (j < i);
+		for (j = i; j < BENCH_MAP_KEYS; j += BENCH_MAP_DEVICES)
+		{
+			memcpy (keys [j].device_id.data, device_id.data, DANTE_ID64_LEN);
+			keys [j].process_id = (uint16_t) (j / BENCH_MAP_DEVICES);
+		}
+	}
+	memset (present, 0, sizeof (present));
+	dapi_id_map_clear (map);
+
+	for (op = 0; op < BENCH_MAP_OPS; op++)
+	{
+		unsigned int k = random_below (info, BENCH_MAP_KEYS);
+		unsigned int index;
+		aud_bool_t added;
+		aud_error_t result;
+		uint32_t * value;
+
+		switch (random_below (info, 3))
+		{
+		case 0:
+			result = dapi_id_map_insert (map, keys + k, & index, & added);
+			if (! present [k] && num_present == BENCH_MAP_CAPACITY)
+			{
+				if (result != AUD_ERR_NOBUFS)
+				{
+					fail (info, "dapi_id_map_insert", round, "did not report a full map");
+					return;
+				}
+				break;
+			}
+			value = dapi_id_map_value_at (map, index);
+			if (result != AUD_SUCCESS || added == present [k] || ! value
+				|| * value != (present [k] ? values [k] : 0))
+			{
+				fail (info, "dapi_id_map_insert", round, "wrong entry");
+				return;
+			}
+			if (added)
+			{
+				present [k] = AUD_TRUE;
+				num_present++;
+				values [k] = (uint32_t) random64 (info);
+				* value = values [k];
+			}
+			break;
+
+		case 1:
+			result = dapi_id_map_remove (map, keys + k);
+			if (result != (present [k] ? AUD_SUCCESS : AUD_ERR_NOTFOUND))
+			{
+				fail (info, "dapi_id_map_remove", round, "wrong result");
+				return;
+			}
+			if (present [k])
+			{
+				present [k] = AUD_FALSE;
+				num_present--;
+			}
+			break;
+
+		default:
+			index = dapi_id_map_find (map, keys + k);
+			if ((index != DAPI_ID_MAP_NO_ENTRY) != present [k]
+				|| (present [k] && * (uint32_t *) dapi_id_map_value_at (map, index) != values [k]))
+			{
+				fail (info, "dapi_id_map_find", round, "wrong entry");
+				return;
+			}
+			break;
+		}
+
+		if (dapi_id_map_size (map) != num_present)
+		{
+			fail (info, "dapi_id_map_size", round, "wrong number of entries");
+			return;
+		}
+	}
+
+	// every entry is one of the keys present, with its value
+	for (i = 0; i < dapi_id_map_size (map); i++)
+	{
+		const conmon_instance_id_t * key = dapi_id_map_key_at (map, i);
+		unsigned int k = key->process_id * BENCH_MAP_DEVICES;
+
+		for (; k < BENCH_MAP_KEYS && ! dapi_instance_id_equals (keys + k, key); k++)
+			;
+		if (k == BENCH_MAP_KEYS || ! present [k]
+			|| * (uint32_t *) dapi_id_map_value_at (map, i) != values [k])
+		{
+			fail (info, "dapi_id_map_key_at", round, "entries do not match the keys present");
+			return;
+		}
+	}
+}
+
+
+AUD_INLINE uint32_t
+hash_fnv1a (const conmon_instance_id_t * id)
+{
+	uint32_t hash = dapi_fnv1a_bytes (DAPI_FNV1A_BASIS, id->device_id.data, sizeof (id->device_id.data));
+
+	hash ^= id->process_id;
+	hash *= DAPI_FNV1A_PRIME;
+	return hash;
+}
+
+
+// Average slots examined to find each key in a linear probing table of num_slots
+static double
+probes_per_key (const uint32_t * hashes, unsigned long n, uint32_t num_slots, uint8_t * used)
+{
+	const uint32_t mask = num_slots - 1;
+	uint64_t probes = 0;
+	unsigned long i;
+
+	memset (used, 0, num_slots);
+	for (i = 0; i < n; i++)
+	{
+		uint32_t slot = hashes [i] & mask;
+		probes++;
+		while (used [slot])
+		{
+			slot = (slot + 1) & mask;
+			probes++;
+		}
+		used [slot] = 1;
+	}
+	return (double) probes / n;
+}
+
+
+static void
+print_result (const char * path, unsigned long n, uint64_t ns, size_t bytes_per_id)
+{
+	printf ("%s,%s,%lu,%llu,%.2f,%.1f\n"
+		, dapi_io_bulk_kernel_name (), path, n
+		, (unsigned long long) ns
+		, (double) ns / n
+		, ns ? (double) n * bytes_per_id * 1000.0 / ns : 0.0
+	);
+	fflush (stdout);
+}
+
+
+static aud_error_t
+run_map_benchmarks (bench_info_t * info, const conmon_instance_id_t * ids, unsigned long n)
+{
+	dapi_id_map_t * map;
+	dapi_id_map_stats_t stats;
+	conmon_instance_id_t * keys = malloc (n * sizeof (conmon_instance_id_t));
+	uint32_t * hashes = malloc (n * sizeof (uint32_t));
+	uint8_t * used;
+	uint32_t num_slots = 1;
+	unsigned long i, num_found = 0;
+	unsigned int index;
+	uint64_t start;
+	aud_error_t result;
+
+	while (num_slots < 2 * n)
+	{
+		num_slots <<= 1;
+	}
+	used = malloc (num_slots);
+	result = dapi_id_map_new ((unsigned int) n, sizeof (uint32_t), & map);
+	if (result != AUD_SUCCESS || ! (keys && hashes && used))
+	{
+		if (result == AUD_SUCCESS)
+		{
+			dapi_id_map_delete (map);
+		}
+		free (keys);
+		free (hashes);
+		free (used);
+		return (result == AUD_SUCCESS) ? AUD_ERR_NOMEMORY : result;
+	}
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		info->checksum += hash_fnv1a (ids + i);
+	}
+	print_result ("hash_fnv1a", n, conmon_example_clock_ns () - start, sizeof (conmon_instance_id_t));
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		info->checksum += dapi_instance_id_hash (ids + i);
+	}
+	print_result ("dapi_instance_id_hash", n, conmon_example_clock_ns () - start, sizeof (conmon_instance_id_t));
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		if (dapi_id_map_insert (map, ids + i, & index, NULL) == AUD_SUCCESS)
+		{
+			* (uint32_t *) dapi_id_map_value_at (map, index) = (uint32_t) i;
+		}
+	}
+	print_result ("dapi_id_map_insert", n, conmon_example_clock_ns () - start, sizeof (conmon_instance_id_t));
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		num_found += (dapi_id_map_find (map, ids + i) != DAPI_ID_MAP_NO_ENTRY);
+	}
+	print_result ("dapi_id_map_find_hit", n, conmon_example_clock_ns () - start, sizeof (conmon_instance_id_t));
+
+	// the same devices with the top process id bit set, which the benchmark ids never have
+	for (i = 0; i < n; i++)
+	{
+		keys [i] = ids [i];
+		keys [i].process_id = (uint16_t) (0x8000 | (i & 0x7FFF));
+	}
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		num_found += (dapi_id_map_find (map, keys + i) != DAPI_ID_MAP_NO_ENTRY);
+	}
+	print_result ("dapi_id_map_find_miss", n, conmon_example_clock_ns () - start, sizeof (conmon_instance_id_t));
+	info->checksum += (uint32_t) num_found;
+
+	dapi_id_map_get_stats (map, & stats);
+	fprintf (stderr, "%s: id map holds %u of %lu ids, %.2f slots per lookup\n"
+		, pname (), stats.num_entries, n, (double) stats.num_probes / stats.num_lookups
+	);
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		dapi_id_map_remove (map, ids + i);
+	}
+	print_result ("dapi_id_map_remove", n, conmon_example_clock_ns () - start, sizeof (conmon_instance_id_t));
+	if (dapi_id_map_size (map))
+	{
+		fprintf (stderr, "%s: id map not empty after removing every id\n", pname ());
+		info->failures++;
+	}
+
+	// ids handed out in sequence under one manufacturer prefix, as a production run would be
+	for (i = 0; i < n; i++)
+	{
+		static const uint8_t prefix [5] = { 0x00, 0x1d, 0xc1, 0xff, 0xfe };
+		memcpy (keys [i].device_id.data, prefix, sizeof (prefix));
+		keys [i].device_id.data [5] = (uint8_t) (i >> 16);
+		keys [i].device_id.data [6] = (uint8_t) (i >> 8);
+		keys [i].device_id.data [7] = (uint8_t) i;
+		keys [i].process_id = 0;
+	}
+	for (i = 0; i < n; i++)
+	{
+		hashes [i] = hash_fnv1a (keys + i);
+	}
+	fprintf (stderr, "%s: sequential ids, slots per lookup: fnv1a %.2f", pname (), probes_per_key (hashes, n, num_slots, used));
+	for (i = 0; i < n; i++)
+	{
+		hashes [i] = dapi_instance_id_hash (keys + i);
+	}
+	fprintf (stderr, ", dapi_instance_id_hash %.2f\n", probes_per_key (hashes, n, num_slots, used));
+
+	dapi_id_map_delete (map);
+	free (keys);
+	free (hashes);
+	free (used);
+	return AUD_SUCCESS;
+}
+
+
+/*
+	Identifiers are laid out one per line, as a log or an export would
+	write them, so the bulk functions run with a stride one past the text.
+ */
+static aud_error_t
+run_benchmarks (bench_info_t * info)
+{
+	unsigned long n = info->num_ids, i;
+	size_t hex_stride = DANTE_ID64_LEN * 2 + 1;
+	size_t ascii_stride = DANTE_ID64_LEN + 1;
+	size_t instance_stride = CONMON_INSTANCE_ID_STR_LEN + 1;
+	dante_id64_t * ids = malloc (n * sizeof (dante_id64_t));
+	dante_id64_t * parsed = malloc (n * sizeof (dante_id64_t));
+	conmon_instance_id_t * instance_ids = malloc (n * sizeof (conmon_instance_id_t));
+	char * text = malloc (n * instance_stride + 1);
+	uint64_t start;
+	size_t num_parsed;
+	aud_error_t result;
+
+	if (! (ids && parsed && instance_ids && text))
+	{
+		free (ids);
+		free (parsed);
+		free (instance_ids);
+		free (text);
+		return AUD_ERR_NOMEMORY;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		random_id64 (info, ids + i);
+		memcpy (instance_ids [i].device_id.data, ids [i].data, DANTE_ID64_LEN);
+		instance_ids [i].process_id = (uint16_t) i;
+	}
+	for (i = 0; i < n; i++)
+	{
+		text [i * hex_stride + hex_stride - 1] = '\n';
+	}
+
+	printf ("kernel,path,ids,ns,ns_per_id,mb_per_s\n");
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		char buf [32];
+		conmon_example_device_id_to_string (& instance_ids [i].device_id, buf, sizeof (buf));
+		info->checksum += (uint8_t) buf [15];
+	}
+	print_result ("snprintf_to_hex", n, conmon_example_clock_ns () - start, DANTE_ID64_LEN * 2);
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		dante_id64_to_str (ids + i, text + i * hex_stride);
+	}
+	print_result ("dante_id64_to_str", n, conmon_example_clock_ns () - start, DANTE_ID64_LEN * 2);
+
+	start = conmon_example_clock_ns ();
+	dante_id64_array_to_hex (ids, n, text, hex_stride);
+	print_result ("dante_id64_array_to_hex", n, conmon_example_clock_ns () - start, DANTE_ID64_LEN * 2);
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		// the newline after each identifier stops the parse
+		dante_id64_from_hex (parsed + i, text + i * hex_stride);
+	}
+	print_result ("dante_id64_from_hex", n, conmon_example_clock_ns () - start, DANTE_ID64_LEN * 2);
+	info->checksum += parsed [n - 1].data [0];
+
+	start = conmon_example_clock_ns ();
+	if (dante_id64_array_from_hex (parsed, n, text, hex_stride, & num_parsed) != AUD_SUCCESS
+		|| memcmp (parsed, ids, n * sizeof (dante_id64_t)))
+	{
+		fprintf (stderr, "%s: bulk hex did not round trip\n", pname ());
+		info->failures++;
+	}
+	print_result ("dante_id64_array_from_hex", n, conmon_example_clock_ns () - start, DANTE_ID64_LEN * 2);
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		dante_id64_to_ascii (ids + i, text + i * ascii_stride);
+	}
+	print_result ("dante_id64_to_ascii", n, conmon_example_clock_ns () - start, DANTE_ID64_LEN);
+
+	start = conmon_example_clock_ns ();
+	dante_id64_array_to_ascii (ids, n, text, ascii_stride);
+	print_result ("dante_id64_array_to_ascii", n, conmon_example_clock_ns () - start, DANTE_ID64_LEN);
+
+	start = conmon_example_clock_ns ();
+	for (i = 0; i < n; i++)
+	{
+		char buf [64];
+		conmon_example_instance_id_to_string (instance_ids + i, buf, sizeof (buf));
+		info->checksum += (uint8_t) buf [20];
+	}
+	print_result ("snprintf_instance_id", n, conmon_example_clock_ns () - start, CONMON_INSTANCE_ID_STR_LEN);
+
+	start = conmon_example_clock_ns ();
+	conmon_instance_id_array_to_str (instance_ids, n, text, instance_stride);
+	print_result ("conmon_instance_id_array_to_str", n, conmon_example_clock_ns () - start, CONMON_INSTANCE_ID_STR_LEN);
+
+	start = conmon_example_clock_ns ();
+	if (conmon_instance_id_array_from_str (instance_ids, n, text, instance_stride, & num_parsed) != AUD_SUCCESS)
+	{
+		fprintf (stderr, "%s: bulk instance ids did not round trip\n", pname ());
+		info->failures++;
+	}
+	print_result ("conmon_instance_id_array_from_str", n, conmon_example_clock_ns () - start, CONMON_INSTANCE_ID_STR_LEN);
+
+	result = run_map_benchmarks (info, instance_ids, n);
+
+	free (ids);
+	free (parsed);
+	free (instance_ids);
+	free (text);
+	return result;
+}
+
+
+//----------
+// Main
+
+int
+main (int argc, char ** argv)
+{
+	bench_info_t * info = & g_info;
+	unsigned long round;
+	aud_error_t result;
+	aud_errbuf_t ebuf;
+	int rc = handle_args (info, argc, argv);
+
+	if (rc)
+	{
+		return rc;
+	}
+
+	info->rng = info->seed ? info->seed : 1;
+	result = dapi_id_map_new (BENCH_MAP_CAPACITY, sizeof (uint32_t), & info->check_map);
+	if (result != AUD_SUCCESS)
+	{
+		fprintf (stderr, "%s: %s\n", pname (), aud_error_message (result, ebuf));
+		return 1;
+	}
+	for (round = 0; round < info->rounds && info->failures < 10; round++)
+	{
+		verify_id64 (info, round);
+		verify_instance_id (info, round);
+		verify_id_map (info, round);
+	}
+	dapi_id_map_delete (info->check_map);
+	if (info->failures)
+	{
+		fprintf (stderr, "%s: %lu checks failed with the %s kernel, not timing\n"
+			, pname (), info->failures, dapi_io_bulk_kernel_name ()
+		);
+		return 1;
+	}
+	fprintf (stderr, "%s: %lu rounds of checks passed with the %s kernel\n"
+		, pname (), info->rounds, dapi_io_bulk_kernel_name ()
+	);
+	if (info->check_only)
+	{
+		return 0;
+	}
+
+	result = run_benchmarks (info);
+	if (result != AUD_SUCCESS)
+	{
+		fprintf (stderr, "%s: %s\n", pname (), aud_error_message (result, ebuf));
+		return 1;
+	}
+	fprintf (stderr, "%s: checksum %08x\n", pname (), info->checksum);
+	return info->failures ? 1 : 0;
+}
+
+//----------
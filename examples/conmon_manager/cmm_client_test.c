@@ -1,12 +1,26 @@
 #include "audinate/dante_api.h"
+#include "cmm_driver.h"
+#include "cmm_journal.h"
 
 #include <stdio.h>
 #include <signal.h>
 
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+#ifdef CMM_DRIVER_EPOLL
+#include <errno.h>
+#include <sys/epoll.h>
+#endif
+
 typedef struct
 {
 	aud_env_t * env;
 	cmm_client_t * client;
+	cmm_driver_t * driver;
+	cmm_journal_t * journal;
+	FILE * journal_file;
 } cmm_client_test_t;
 
 //-------------------
@@ -140,7 +154,7 @@ void signal_handler(int sig)
 	running = AUD_FALSE;
 }
 
-cmm_client_event_fn cmm_client_test_event;
+cmm_driver_event_fn cmm_client_test_event;
 
 //----------------------------------------------------------
 // Callback event handlers
@@ -162,30 +176,15 @@ cmm_client_test_on_connection_changed
 }
 
 static void
-cmm_client_test_on_options_changed
+cmm_client_test_on_journal_record
 (
-	cmm_client_t * client
+	void * context,
+	const cmm_journal_record_t * record
 ) {
-	printf("Options have changed, now:\n");
-	cmm_client_test_print_options(cmm_client_get_system_options(client));
-}
+	(void) context;
 
-static void
-cmm_client_test_on_state_changed
-(
-	cmm_client_t * client
-) {
-	printf("State has changed, now:\n");
-	cmm_client_test_print_state(cmm_client_get_system_state(client));
-}
-
-static void
-cmm_client_test_on_process_changed
-(
-	cmm_client_t * client
-) {
-	printf("Process has changed, now:\n");
-	cmm_client_test_print_process(cmm_client_get_process(client));
+	printf("  ");
+	cmm_journal_print_record(stdout, record);
 }
 
 static void
@@ -201,34 +200,40 @@ cmm_client_test_on_request_completed
 void
 cmm_client_test_event
 (
+	cmm_driver_t * driver,
 	cmm_client_t * client,
-	const cmm_client_event_info_t * event_info
+	uint32_t flags
 ) {
-	//cmm_client_test_t * test = (cmm_client_test_t *) cmm_client_get_context(client);
+	cmm_client_test_t * test = (cmm_client_test_t *) cmm_driver_get_context(driver);
+	uint32_t changed = flags & (CMM_CLIENT_EVENT_FLAG_CONNECTION_CHANGED
+		| CMM_CLIENT_EVENT_FLAG_OPTIONS_CHANGED
+		| CMM_CLIENT_EVENT_FLAG_STATE_CHANGED
+		| CMM_CLIENT_EVENT_FLAG_PROCESS_CHANGED);
 
-	printf("Got an event, flags=0x%08x\n", event_info->flags);
+	printf("Got events, flags=0x%08x\n", flags);
 	
-	if (event_info->flags & CMM_CLIENT_EVENT_FLAG_CONNECTION_CHANGED)
+	if (flags & CMM_CLIENT_EVENT_FLAG_CONNECTION_CHANGED)
 	{
 		cmm_client_test_on_connection_changed(client);
 	}
 
-	if (event_info->flags & CMM_CLIENT_EVENT_FLAG_OPTIONS_CHANGED)
+	if (changed)
 	{
-		cmm_client_test_on_options_changed(client);
-	}
-
-	if (event_info->flags & CMM_CLIENT_EVENT_FLAG_STATE_CHANGED)
-	{
-		cmm_client_test_on_state_changed(client);
-	}
-
-	if (event_info->flags & CMM_CLIENT_EVENT_FLAG_PROCESS_CHANGED)
-	{
-		cmm_client_test_on_process_changed(client);
+		// only the fields that differ from last time are printed and journalled
+		aud_utime_t now;
+		aud_error_t result;
+		aud_errbuf_t errbuf;
+
+		aud_utime_get(&now);
+		result = cmm_journal_update(test->journal, client, changed,
+			(uint64_t) now.tv_sec * 1000 + now.tv_usec / 1000, NULL);
+		if (result != AUD_SUCCESS)
+		{
+			printf("Error writing journal: %s\n", aud_error_message(result, errbuf));
+		}
 	}
 
-	if (event_info->flags & CMM_CLIENT_EVENT_FLAG_REQUEST_COMPLETED)
+	if (flags & CMM_CLIENT_EVENT_FLAG_REQUEST_COMPLETED)
 	{
 		cmm_client_test_on_request_completed(client);
 	}
@@ -245,11 +250,15 @@ cmm_client_test_run
 	cmm_client_test_t * test
 ) {
 	aud_error_t result;
-	aud_socket_t s = cmm_client_get_socket(test->client);
-	aud_utime_t timeout = {1, 0};
+	aud_socket_t s = cmm_driver_get_socket(test->driver);
+	unsigned int ms = cmm_driver_ms_to_next(test->driver);
+	aud_utime_t timeout;
 	fd_set read_fds;
 	int select_result;
 
+	timeout.tv_sec = ms / 1000;
+	timeout.tv_usec = (ms % 1000) * 1000;
+
 	FD_ZERO(&read_fds);
 
 #ifdef WIN32
@@ -271,7 +280,7 @@ cmm_client_test_run
 	}
 	else if (select_result >= 0)
 	{
-		result = cmm_client_process(test->client, NULL);
+		result = cmm_driver_process(test->driver);
 		if (result != AUD_SUCCESS)
 		{
 			//aud_log(test->env->log, AUD_LOG_ERROR, "Error processing dvs client: %s\n", aud_error_message(result, errbuf)); 
@@ -281,6 +290,39 @@ cmm_client_test_run
 	return AUD_SUCCESS;
 }
 
+#ifdef CMM_DRIVER_EPOLL
+// Listen for events from an epoll loop, as an application with other sockets would
+static aud_error_t
+cmm_client_test_listen_epoll
+(
+	cmm_client_test_t * test
+) {
+	aud_error_t result = AUD_SUCCESS;
+	int epfd = epoll_create(1);
+
+	if (epfd < 0)
+	{
+		return aud_error_get_last();
+	}
+	cmm_driver_set_epoll(test->driver, epfd);
+	while (running && result == AUD_SUCCESS)
+	{
+		struct epoll_event events[4];
+		int n = epoll_wait(epfd, events, 4, (int) cmm_driver_ms_to_next(test->driver));
+		if (n < 0 && errno != EINTR)
+		{
+			result = aud_error_get_last();
+			break;
+		}
+		// readable or timed out, the driver needs a turn either way
+		result = cmm_driver_process(test->driver);
+	}
+	cmm_driver_set_epoll(test->driver, -1);
+	close(epfd);
+	return result;
+}
+#endif
+
 static aud_error_t
 cmm_test_set_interface(cmm_client_test_t * test, const wchar_t * name)
 {
@@ -314,24 +356,18 @@ cmm_test_set_interface(cmm_client_test_t * test, const wchar_t * name)
 		printf("Error sending config: %s\n", aud_error_message(result, errbuf));
 		return result;
 	}
-	while (cmm_client_has_active_request(test->client))
+	result = cmm_driver_wait(test->driver, CMM_DRIVER_READY_IDLE, CMM_DRIVER_WAIT_FOREVER, &running);
+	if (result != AUD_SUCCESS)
 	{
-		if (!running)
-		{
-			return AUD_ERR_INTERRUPTED;
-		}
-		cmm_client_test_run(test);
+		return result;
 	}
 	if (cmm_state_get_pending_config(cmm_client_get_system_state(test->client)))
 	{
 		printf("Sent config, waiting for new configuration to be applied\n");
-		while (cmm_state_get_pending_config(cmm_client_get_system_state(test->client)))
+		result = cmm_driver_wait(test->driver, CMM_DRIVER_READY_CONFIG_APPLIED, CMM_DRIVER_WAIT_FOREVER, &running);
+		if (result != AUD_SUCCESS)
 		{
-			if (!running)
-			{
-				return AUD_ERR_INTERRUPTED;
-			}
-			cmm_client_test_run(test);
+			return result;
 		}
 		printf("New configuration has been applied\n");
 	}
@@ -342,11 +378,70 @@ cmm_test_set_interface(cmm_client_test_t * test, const wchar_t * name)
 	return AUD_SUCCESS;
 }
 
+// Print every record in a journal file
+static aud_error_t
+cmm_client_test_read_journal(const char * filename)
+{
+	cmm_journal_reader_t reader;
+	cmm_journal_record_t record;
+	aud_error_t result;
+	uint8_t * buf;
+	long len;
+	FILE * fp = fopen(filename, "rb");
+
+	if (!fp)
+	{
+		printf("Can't open journal '%s'\n", filename);
+		return AUD_ERR_NOTFOUND;
+	}
+	fseek(fp, 0, SEEK_END);
+	len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	buf = (uint8_t *) malloc(len > 0 ? (size_t) len : 1);
+	if (!buf)
+	{
+		fclose(fp);
+		return AUD_ERR_NOMEMORY;
+	}
+	if (len < 0 || fread(buf, 1, (size_t) len, fp) != (size_t) len)
+	{
+		free(buf);
+		fclose(fp);
+		return AUD_ERR_SYSTEM;
+	}
+	fclose(fp);
+
+	result = cmm_journal_reader_init(&reader, buf, (size_t) len);
+	if (result != AUD_SUCCESS)
+	{
+		printf("'%s' is not a journal\n", filename);
+		free(buf);
+		return result;
+	}
+	printf("Journal from host '%s'\n", reader.host);
+	while ((result = cmm_journal_reader_next(&reader, &record)) == AUD_SUCCESS)
+	{
+		cmm_journal_print_record(stdout, &record);
+	}
+	if (result == AUD_ERR_TRUNCATED)
+	{
+		printf("Journal ends part way through a record\n");
+	}
+	else if (result != AUD_ERR_DONE)
+	{
+		printf("Journal is corrupt at offset %lu\n", (unsigned long) reader.offset);
+	}
+	free(buf);
+	return result == AUD_ERR_DONE ? AUD_SUCCESS : result;
+}
+
 static void usage(char * bin)
 {
 	printf("Usage: %s OPTIONS\n", bin);
 	printf("  -l         connect to the server and listen for events\n");
 	printf("  -i=NAME    switch to the interface with name NAME\n");
+	printf("  -j=FILE    write a binary journal of changes to FILE\n");
+	printf("  -r=FILE    print the changes in a journal written with -j and exit\n");
 }
 
 typedef enum
@@ -363,11 +458,13 @@ int main(int argc, char * argv[])
 	wchar_t name[CMM_INTERFACE_NAME_LENGTH];
 	int a;
 	uint16_t port = 0;
+	const char * journal_filename = NULL;
+	char host[CMM_JOURNAL_MAX_STRING];
 
 	aud_error_t result;
 	aud_errbuf_t errbuf;
 
-	cmm_client_test_t test;
+	cmm_client_test_t test = { 0 };
 
 	for (a = 1; a < argc; a++)
 	{
@@ -391,6 +488,14 @@ int main(int argc, char * argv[])
 			name[i] = '\0';
 			mode = CMM_CLIENT_TEST_MODE_NAME;
 		}
+		else if (!strncmp(arg, "-j=", 3) && strlen(arg) > 3)
+		{
+			journal_filename = arg + 3;
+		}
+		else if (!strncmp(arg, "-r=", 3) && strlen(arg) > 3)
+		{
+			return cmm_client_test_read_journal(arg + 3);
+		}
 		else
 		{
 			usage(argv[0]);
@@ -423,8 +528,33 @@ int main(int argc, char * argv[])
 		fprintf(stderr, "Error initialising client: %s\n", aud_error_message(result, errbuf));
 		goto cleanup;
 	}
-	cmm_client_set_context(test.client, &test);
-	cmm_client_set_event_cb(test.client, &cmm_client_test_event);
+	if (journal_filename)
+	{
+		test.journal_file = fopen(journal_filename, "wb");
+		if (!test.journal_file)
+		{
+			fprintf(stderr, "Error opening journal '%s'\n", journal_filename);
+			goto cleanup;
+		}
+	}
+	if (gethostname(host, sizeof(host)) != 0)
+	{
+		host[0] = '\0';
+	}
+	host[sizeof(host) - 1] = '\0';
+	result = cmm_journal_new(test.journal_file, host,
+		&cmm_client_test_on_journal_record, &test, &test.journal);
+	if (result != AUD_SUCCESS)
+	{
+		fprintf(stderr, "Error creating journal: %s\n", aud_error_message(result, errbuf));
+		goto cleanup;
+	}
+	result = cmm_driver_new(test.client, &cmm_client_test_event, &test, &test.driver);
+	if (result != AUD_SUCCESS)
+	{
+		fprintf(stderr, "Error creating client driver: %s\n", aud_error_message(result, errbuf));
+		goto cleanup;
+	}
 	result = cmm_client_connect(test.client);
 	if (result != AUD_SUCCESS)
 	{
@@ -435,25 +565,19 @@ int main(int argc, char * argv[])
 	signal(SIGINT, signal_handler);
 
 	printf("Waiting for connection\n");
-	while (cmm_client_get_connection_state(test.client) != CMM_CONNECTION_STATE_CONNECTED)
+	if (cmm_driver_wait(test.driver, CMM_DRIVER_READY_CONNECTED, CMM_DRIVER_WAIT_FOREVER, &running) != AUD_SUCCESS)
 	{
-		if (!running)
-		{
-			goto cleanup;
-		}
-		cmm_client_test_run(&test);
+		goto cleanup;
 	}
 	printf("Waiting for connected\n");
 
-	while (cmm_client_get_system_options(test.client) == NULL || cmm_client_get_system_state(test.client) == NULL)
+	if (cmm_driver_wait(test.driver, CMM_DRIVER_READY_OPTIONS | CMM_DRIVER_READY_STATE, CMM_DRIVER_WAIT_FOREVER, &running) != AUD_SUCCESS)
 	{
-		if (!running)
-		{
-			goto cleanup;
-		}
-		cmm_client_test_run(&test);
+		goto cleanup;
 	}
 	printf("Acquired options and state\n");
+	cmm_client_test_print_options(cmm_client_get_system_options(test.client));
+	cmm_client_test_print_state(cmm_client_get_system_state(test.client));
 
 	if (mode == CMM_CLIENT_TEST_MODE_NAME)
 	{
@@ -461,14 +585,38 @@ int main(int argc, char * argv[])
 	}
 	else if (mode == CMM_CLIENT_TEST_MODE_LISTEN)
 	{
+#ifdef CMM_DRIVER_EPOLL
+		cmm_client_test_listen_epoll(&test);
+#else
 		while (running)
 		{
 			cmm_client_test_run(&test);
 		}
+#endif
 	}
 
 cleanup:
 
+	if (test.driver)
+	{
+		cmm_driver_stats_t stats;
+		cmm_driver_get_stats(test.driver, &stats);
+		printf("%lu events coalesced into %lu dispatches over %lu process calls\n",
+			stats.num_events, stats.num_dispatches, stats.num_process_calls);
+		cmm_driver_delete(test.driver);
+	}
+	if (test.journal)
+	{
+		cmm_journal_stats_t stats;
+		cmm_journal_get_stats(test.journal, &stats);
+		printf("%lu journal records (%lu bytes) from %lu updates\n",
+			stats.num_records, stats.num_bytes, stats.num_updates);
+		cmm_journal_delete(test.journal);
+	}
+	if (test.journal_file)
+	{
+		fclose(test.journal_file);
+	}
 	if (test.client)
 	{
 		cmm_client_disconnect(test.client);
@@ -0,0 +1,509 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Drive a conmon manager client from an application's event loop
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "cmm_driver.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CMM_DRIVER_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#ifdef WIN32
+#define CMM_DRIVER_INVALID_SOCKET INVALID_SOCKET
+#else
+#define CMM_DRIVER_INVALID_SOCKET (-1)
+#endif
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	CMM_DRIVER_TICK_MS = 1000
+		// how often the client runs its timers when the socket is quiet
+};
+
+struct cmm_driver
+{
+	cmm_client_t * client;
+	cmm_driver_event_fn * event_fn;
+	void * context;
+
+	uint32_t pending_flags;
+		// events collected during the current cmm_client_process call
+	unsigned int ready;
+	cmm_driver_future_t * futures;
+
+	aud_socket_t socket;
+#ifdef CMM_DRIVER_EPOLL
+	int epfd;
+		// -1 if not using epoll
+#endif
+
+	cmm_driver_stats_t stats;
+};
+
+
+//----------
+// Local functions
+
+static void
+cmm_driver_on_event
+(
+	cmm_client_t * client,
+	const cmm_client_event_info_t * event_info
+) {
+	cmm_driver_t * driver = (cmm_driver_t *) cmm_client_get_context(client);
+
+	driver->pending_flags |= event_info->flags;
+	driver->stats.num_events++;
+}
+
+
+static unsigned int
+cmm_driver_compute_ready
+(
+	cmm_client_t * client
+) {
+	const cmm_state_t * state = cmm_client_get_system_state(client);
+	unsigned int ready = 0;
+
+	if (cmm_client_get_connection_state(client) == CMM_CONNECTION_STATE_CONNECTED)
+	{
+		ready |= CMM_DRIVER_READY_CONNECTED;
+	}
+	if (cmm_client_get_system_info(client))
+	{
+		ready |= CMM_DRIVER_READY_INFO;
+	}
+	if (cmm_client_get_system_options(client))
+	{
+		ready |= CMM_DRIVER_READY_OPTIONS;
+	}
+	if (state)
+	{
+		ready |= CMM_DRIVER_READY_STATE;
+		if (!cmm_state_get_pending_config(state))
+		{
+			ready |= CMM_DRIVER_READY_CONFIG_APPLIED;
+		}
+	}
+	if (!cmm_client_has_active_request(client))
+	{
+		ready |= CMM_DRIVER_READY_IDLE;
+	}
+	return ready;
+}
+
+
+// Complete every future whose wants are all ready, letting callbacks await or cancel others
+static void
+cmm_driver_complete_futures
+(
+	cmm_driver_t * driver
+) {
+	cmm_driver_future_t ** link = &driver->futures;
+
+	while (*link)
+	{
+		cmm_driver_future_t * future = *link;
+		if ((driver->ready & future->want) != future->want)
+		{
+			link = &future->next;
+			continue;
+		}
+
+		*link = future->next;
+		future->next = NULL;
+		future->waiting = AUD_FALSE;
+		future->done = AUD_TRUE;
+		driver->stats.num_futures_completed++;
+		if (future->fn)
+		{
+			future->fn(driver, future);
+			// the list may have changed under us, so start again
+			link = &driver->futures;
+		}
+	}
+}
+
+
+#ifdef CMM_DRIVER_EPOLL
+static void
+cmm_driver_update_epoll
+(
+	cmm_driver_t * driver,
+	aud_socket_t old_socket
+) {
+	struct epoll_event ev;
+
+	if (driver->epfd < 0)
+	{
+		return;
+	}
+	if (old_socket != CMM_DRIVER_INVALID_SOCKET)
+	{
+		epoll_ctl(driver->epfd, EPOLL_CTL_DEL, old_socket, NULL);
+	}
+	if (driver->socket != CMM_DRIVER_INVALID_SOCKET)
+	{
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.ptr = driver;
+		epoll_ctl(driver->epfd, EPOLL_CTL_ADD, driver->socket, &ev);
+	}
+}
+#endif
+
+
+static void
+cmm_driver_update_socket
+(
+	cmm_driver_t * driver
+) {
+	aud_socket_t s = cmm_client_get_socket(driver->client);
+
+	if (s != driver->socket)
+	{
+		aud_socket_t old_socket = driver->socket;
+		driver->socket = s;
+#ifdef CMM_DRIVER_EPOLL
+		cmm_driver_update_epoll(driver, old_socket);
+#else
+		AUD_UNUSED(old_socket);
+#endif
+	}
+}
+
+
+static unsigned int
+cmm_driver_elapsed_ms
+(
+	const aud_utime_t * since
+) {
+	aud_utime_t now;
+	aud_utime_get(&now);
+	return (unsigned int) ((now.tv_sec - since->tv_sec) * 1000 + (now.tv_usec - since->tv_usec) / 1000);
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+cmm_driver_new
+(
+	cmm_client_t * client,
+	cmm_driver_event_fn * event_fn,
+	void * context,
+	cmm_driver_t ** driver_ptr
+) {
+	cmm_driver_t * driver;
+
+	if (!client || !driver_ptr)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	driver = (cmm_driver_t *) calloc(1, sizeof(*driver));
+	if (!driver)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	driver->client = client;
+	driver->event_fn = event_fn;
+	driver->context = context;
+	driver->socket = CMM_DRIVER_INVALID_SOCKET;
+#ifdef CMM_DRIVER_EPOLL
+	driver->epfd = -1;
+#endif
+
+	cmm_client_set_context(client, driver);
+	cmm_client_set_event_cb(client, &cmm_driver_on_event);
+	cmm_driver_update_socket(driver);
+	driver->ready = cmm_driver_compute_ready(client);
+
+	*driver_ptr = driver;
+	return AUD_SUCCESS;
+}
+
+
+void
+cmm_driver_delete
+(
+	cmm_driver_t * driver
+) {
+	if (!driver)
+	{
+		return;
+	}
+#ifdef CMM_DRIVER_EPOLL
+	cmm_driver_set_epoll(driver, -1);
+#endif
+	cmm_client_set_event_cb(driver->client, NULL);
+	cmm_client_set_context(driver->client, NULL);
+	free(driver);
+}
+
+
+cmm_client_t *
+cmm_driver_get_client
+(
+	const cmm_driver_t * driver
+) {
+	return driver->client;
+}
+
+
+void *
+cmm_driver_get_context
+(
+	const cmm_driver_t * driver
+) {
+	return driver->context;
+}
+
+
+aud_socket_t
+cmm_driver_get_socket
+(
+	const cmm_driver_t * driver
+) {
+	return driver->socket;
+}
+
+
+#ifdef CMM_DRIVER_EPOLL
+aud_error_t
+cmm_driver_set_epoll
+(
+	cmm_driver_t * driver,
+	int epfd
+) {
+	aud_socket_t s = driver->socket;
+
+	// drop the old registration, then register the current socket with the new set
+	driver->socket = CMM_DRIVER_INVALID_SOCKET;
+	cmm_driver_update_epoll(driver, s);
+	driver->epfd = epfd;
+	driver->socket = s;
+	cmm_driver_update_epoll(driver, CMM_DRIVER_INVALID_SOCKET);
+	return AUD_SUCCESS;
+}
+#endif
+
+
+aud_error_t
+cmm_driver_process
+(
+	cmm_driver_t * driver
+) {
+	aud_error_t result;
+	uint32_t flags;
+
+	driver->stats.num_process_calls++;
+	result = cmm_client_process(driver->client, NULL);
+	cmm_driver_update_socket(driver);
+
+	flags = driver->pending_flags;
+	driver->pending_flags = 0;
+	driver->ready = cmm_driver_compute_ready(driver->client);
+	if (flags && driver->event_fn)
+	{
+		driver->stats.num_dispatches++;
+		driver->event_fn(driver, driver->client, flags);
+	}
+	cmm_driver_complete_futures(driver);
+	return result;
+}
+
+
+unsigned int
+cmm_driver_ms_to_next
+(
+	const cmm_driver_t * driver
+) {
+	AUD_UNUSED(driver);
+	return CMM_DRIVER_TICK_MS;
+}
+
+
+unsigned int
+cmm_driver_get_ready
+(
+	const cmm_driver_t * driver
+) {
+	return driver->ready;
+}
+
+
+void
+cmm_driver_future_init
+(
+	cmm_driver_future_t * future,
+	unsigned int want,
+	cmm_driver_future_fn * fn,
+	void * context
+) {
+	memset(future, 0, sizeof(*future));
+	future->want = want;
+	future->fn = fn;
+	future->context = context;
+}
+
+
+void
+cmm_driver_await
+(
+	cmm_driver_t * driver,
+	cmm_driver_future_t * future
+) {
+	if (future->waiting)
+	{
+		return;
+	}
+	future->done = AUD_FALSE;
+	future->waiting = AUD_TRUE;
+	future->next = driver->futures;
+	driver->futures = future;
+	cmm_driver_complete_futures(driver);
+}
+
+
+void
+cmm_driver_cancel
+(
+	cmm_driver_t * driver,
+	cmm_driver_future_t * future
+) {
+	cmm_driver_future_t ** link;
+
+	for (link = &driver->futures; *link; link = &(*link)->next)
+	{
+		if (*link == future)
+		{
+			*link = future->next;
+			future->next = NULL;
+			future->waiting = AUD_FALSE;
+			return;
+		}
+	}
+}
+
+
+aud_error_t
+cmm_driver_wait
+(
+	cmm_driver_t * driver,
+	unsigned int want,
+	unsigned int timeout_ms,
+	const aud_bool_t * running
+) {
+	cmm_driver_future_t future;
+	aud_utime_t start;
+	aud_error_t result = AUD_SUCCESS;
+
+	cmm_driver_future_init(&future, want, NULL, NULL);
+	cmm_driver_await(driver, &future);
+	aud_utime_get(&start);
+
+	while (!future.done)
+	{
+		unsigned int elapsed = cmm_driver_elapsed_ms(&start);
+		unsigned int ms = cmm_driver_ms_to_next(driver);
+		aud_utime_t timeout;
+		fd_set read_fds;
+		int select_result;
+
+		if (running && !*running)
+		{
+			result = AUD_ERR_INTERRUPTED;
+			break;
+		}
+		// the client may have connected since the last pass, e.g. straight
+		// after the driver was created, so select on its socket right away
+		cmm_driver_update_socket(driver);
+		if (timeout_ms != CMM_DRIVER_WAIT_FOREVER)
+		{
+			if (elapsed >= timeout_ms)
+			{
+				result = AUD_ERR_TIMEDOUT;
+				break;
+			}
+			if (timeout_ms - elapsed < ms)
+			{
+				ms = timeout_ms - elapsed;
+			}
+		}
+		timeout.tv_sec = ms / 1000;
+		timeout.tv_usec = (ms % 1000) * 1000;
+
+		FD_ZERO(&read_fds);
+		if (driver->socket != CMM_DRIVER_INVALID_SOCKET)
+		{
+#ifdef WIN32
+#pragma warning(push)
+#pragma warning(disable:4127)
+			FD_SET(driver->socket, &read_fds);
+#pragma warning(pop)
+			select_result = select(1, &read_fds, NULL, NULL, &timeout);
+#else
+			FD_SET(driver->socket, &read_fds);
+			select_result = select(driver->socket + 1, &read_fds, NULL, NULL, &timeout);
+#endif
+		}
+		else
+		{
+			// not connected yet, so just let the client's timers run
+#ifdef WIN32
+			Sleep(ms);
+			select_result = 0;
+#else
+			select_result = select(0, NULL, NULL, NULL, &timeout);
+#endif
+		}
+		if (select_result < 0)
+		{
+			result = aud_error_from_system_error(aud_system_error_get_last());
+			if (result == AUD_ERR_INTERRUPTED)
+			{
+				continue;
+			}
+			break;
+		}
+		result = cmm_driver_process(driver);
+		if (result != AUD_SUCCESS)
+		{
+			break;
+		}
+	}
+
+	cmm_driver_cancel(driver, &future);
+	return future.done ? AUD_SUCCESS : result;
+}
+
+
+void
+cmm_driver_get_stats
+(
+	const cmm_driver_t * driver,
+	cmm_driver_stats_t * stats
+) {
+	*stats = driver->stats;
+}
+
+
+//----------
@@ -0,0 +1,241 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Drive a conmon manager client from an application's event loop
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CMM_DRIVER_H
+#define _CMM_DRIVER_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+#ifdef __linux__
+#define CMM_DRIVER_EPOLL
+#endif
+
+
+//----------
+// Types and Constants
+
+/*
+	The driver owns the client's event callback and context. Events raised
+	while one call to cmm_client_process runs are collected, and their flags
+	ORed together and handed to the application once when it returns, so a
+	burst of updates is handled once rather than once per message.
+
+	After each dispatch the driver works out which parts of the client are
+	ready (connected, info, options, state, no request in flight, no config
+	pending) and completes any futures waiting on them. A future is owned by
+	the caller and completes once all of the bits it wants are ready at the
+	same time; it can be used from a callback or waited on with
+	cmm_driver_wait, which returns as soon as the client is ready instead of
+	on the next tick.
+
+	The client's socket changes when it reconnects. With epoll the driver
+	moves its registration itself; with select the application should ask
+	for the socket again after each call to cmm_driver_process.
+ */
+
+// Pass as the timeout to cmm_driver_wait to wait until ready or interrupted
+#define CMM_DRIVER_WAIT_FOREVER 0xFFFFFFFFu
+
+typedef struct cmm_driver cmm_driver_t;
+typedef struct cmm_driver_future cmm_driver_future_t;
+
+enum
+{
+	CMM_DRIVER_READY_CONNECTED = 0x01,
+	CMM_DRIVER_READY_INFO = 0x02,
+	CMM_DRIVER_READY_OPTIONS = 0x04,
+	CMM_DRIVER_READY_STATE = 0x08,
+	CMM_DRIVER_READY_IDLE = 0x10,
+		// no request in flight
+	CMM_DRIVER_READY_CONFIG_APPLIED = 0x20
+		// state known and no config pending
+};
+
+// Called once per cmm_driver_process call that saw any events, with their flags combined
+typedef void
+cmm_driver_event_fn
+(
+	cmm_driver_t * driver,
+	cmm_client_t * client,
+	uint32_t flags
+);
+
+typedef void
+cmm_driver_future_fn
+(
+	cmm_driver_t * driver,
+	cmm_driver_future_t * future
+);
+
+struct cmm_driver_future
+{
+	unsigned int want;
+	cmm_driver_future_fn * fn;
+		// may be NULL
+	void * context;
+	aud_bool_t done;
+
+	// private to the driver
+	cmm_driver_future_t * next;
+	aud_bool_t waiting;
+};
+
+typedef struct cmm_driver_stats
+{
+	unsigned long num_process_calls;
+	unsigned long num_events;
+		// raised by the client
+	unsigned long num_dispatches;
+		// handed to the application after coalescing
+	unsigned long num_futures_completed;
+} cmm_driver_stats_t;
+
+
+//----------
+// Functions
+
+/*
+	Take over a client's event callback and context. The client must have
+	been initialised with cmm_client_init but need not be connected yet.
+ */
+aud_error_t
+cmm_driver_new
+(
+	cmm_client_t * client,
+	cmm_driver_event_fn * event_fn,
+	void * context,
+	cmm_driver_t ** driver_ptr
+);
+
+void
+cmm_driver_delete
+(
+	cmm_driver_t * driver
+);
+
+cmm_client_t *
+cmm_driver_get_client
+(
+	const cmm_driver_t * driver
+);
+
+void *
+cmm_driver_get_context
+(
+	const cmm_driver_t * driver
+);
+
+// The socket to watch for reading
+aud_socket_t
+cmm_driver_get_socket
+(
+	const cmm_driver_t * driver
+);
+
+#ifdef CMM_DRIVER_EPOLL
+/*
+	Watch the client's socket with an epoll set, with data.ptr set to the
+	driver. The driver keeps the registration up to date as the client
+	reconnects. Pass -1 to stop using epoll.
+ */
+aud_error_t
+cmm_driver_set_epoll
+(
+	cmm_driver_t * driver,
+	int epfd
+);
+#endif
+
+/*
+	Let the client do its work, dispatch the coalesced events and complete
+	any futures that are now ready. Call this whenever the socket is
+	readable, and after cmm_driver_ms_to_next has passed without it being
+	readable so the client can run its timers.
+ */
+aud_error_t
+cmm_driver_process
+(
+	cmm_driver_t * driver
+);
+
+// How long to wait before calling cmm_driver_process if the socket stays quiet
+unsigned int
+cmm_driver_ms_to_next
+(
+	const cmm_driver_t * driver
+);
+
+// The CMM_DRIVER_READY_ flags as of the last call to cmm_driver_process
+unsigned int
+cmm_driver_get_ready
+(
+	const cmm_driver_t * driver
+);
+
+void
+cmm_driver_future_init
+(
+	cmm_driver_future_t * future,
+	unsigned int want,
+	cmm_driver_future_fn * fn,
+	void * context
+);
+
+/*
+	Wait for a future without blocking. It completes straight away if the
+	client is already ready; otherwise the future must stay valid until it
+	completes or is cancelled.
+ */
+void
+cmm_driver_await
+(
+	cmm_driver_t * driver,
+	cmm_driver_future_t * future
+);
+
+void
+cmm_driver_cancel
+(
+	cmm_driver_t * driver,
+	cmm_driver_future_t * future
+);
+
+/*
+	Run the client until everything in want is ready, returning as soon as
+	it is. running, if not NULL, is checked between waits so a signal
+	handler can break out.
+
+	@return AUD_ERR_TIMEDOUT after timeout_ms, AUD_ERR_INTERRUPTED if
+	running was cleared, or an error from processing the client
+ */
+aud_error_t
+cmm_driver_wait
+(
+	cmm_driver_t * driver,
+	unsigned int want,
+	unsigned int timeout_ms,
+	const aud_bool_t * running
+);
+
+void
+cmm_driver_get_stats
+(
+	const cmm_driver_t * driver,
+	cmm_driver_stats_t * stats
+);
+
+
+//----------
+
+#endif // _CMM_DRIVER_H
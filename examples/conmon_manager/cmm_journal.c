@@ -0,0 +1,1146 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Field-level change journal for conmon manager state
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+
+//----------
+// Include
+
+#include "cmm_journal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//----------
+// Types and Constants
+
+enum
+{
+	CMM_JOURNAL_HAVE_INFO = 0x1,
+	CMM_JOURNAL_HAVE_OPTIONS = 0x2,
+	CMM_JOURNAL_HAVE_STATE = 0x4,
+	CMM_JOURNAL_HAVE_PROCESS = 0x8,
+	CMM_JOURNAL_HAVE_CONNECTION = 0x10
+};
+
+enum
+{
+	CMM_JOURNAL_MAX_VARINT = 10,
+	CMM_JOURNAL_MAX_RECORD = CMM_JOURNAL_MAX_VARINT * 4 + 1 + CMM_JOURNAL_MAX_VALUE * 2,
+	CMM_JOURNAL_MAX_HEADER = 5 + CMM_JOURNAL_MAX_VARINT + CMM_JOURNAL_MAX_STRING
+};
+
+static const uint8_t CMM_JOURNAL_MAGIC[4] = { 'C', 'M', 'M', 'J' };
+
+typedef struct cmm_journal_interface
+{
+	uint8_t mac[6];
+	char name[CMM_JOURNAL_MAX_STRING];
+} cmm_journal_interface_t;
+
+typedef struct cmm_journal_interface_list
+{
+	uint16_t num_interfaces;
+	cmm_journal_interface_t interfaces[CMM_JOURNAL_MAX_INTERFACES];
+} cmm_journal_interface_list_t;
+
+typedef struct cmm_journal_process
+{
+	int id;
+	aud_bool_t locking;
+	char name[CMM_JOURNAL_MAX_STRING];
+} cmm_journal_process_t;
+
+typedef struct cmm_journal_snapshot
+{
+	unsigned int have;
+		// CMM_JOURNAL_HAVE_ bits for the parts copied so far
+	cmm_connection_state_t connection;
+
+	dante_version_t version;
+	uint16_t max_dante_networks;
+
+	cmm_journal_interface_list_t options;
+
+	cmm_system_status_t system_status;
+	char dante_device_name[CMM_JOURNAL_MAX_STRING];
+	cmm_journal_interface_list_t current;
+	aud_bool_t pending;
+	cmm_journal_interface_list_t pending_config;
+	uint16_t num_processes;
+	cmm_journal_process_t processes[CMM_JOURNAL_MAX_PROCESSES];
+
+	cmm_journal_process_t process;
+} cmm_journal_snapshot_t;
+
+struct cmm_journal
+{
+	FILE * file;
+	cmm_journal_change_fn * change_fn;
+	void * context;
+
+	cmm_journal_snapshot_t prev;
+	cmm_journal_snapshot_t next;
+		// kept here rather than on the stack, it is a few kilobytes
+
+	uint64_t last_ms;
+	unsigned int update_records;
+		// records written by the current update
+	cmm_journal_record_t record;
+	cmm_journal_stats_t stats;
+};
+
+
+//----------
+// Local functions
+
+static size_t
+cmm_journal_put_varint
+(
+	uint8_t * p,
+	uint64_t value
+) {
+	size_t n = 0;
+	while (value >= 0x80)
+	{
+		p[n++] = (uint8_t) (value | 0x80);
+		value >>= 7;
+	}
+	p[n++] = (uint8_t) value;
+	return n;
+}
+
+
+static aud_error_t
+cmm_journal_get_varint
+(
+	cmm_journal_reader_t * reader,
+	uint64_t * value
+) {
+	uint64_t v = 0;
+	unsigned int shift;
+
+	for (shift = 0; shift < 64; shift += 7)
+	{
+		uint8_t b;
+		if (reader->offset >= reader->len)
+		{
+			return AUD_ERR_TRUNCATED;
+		}
+		b = reader->buf[reader->offset++];
+		v |= ((uint64_t) (b & 0x7F)) << shift;
+		if (!(b & 0x80))
+		{
+			*value = v;
+			return AUD_SUCCESS;
+		}
+	}
+	return AUD_ERR_INVALIDDATA;
+}
+
+
+static void
+cmm_journal_put_u16
+(
+	uint8_t * p,
+	uint16_t value
+) {
+	p[0] = (uint8_t) (value >> 8);
+	p[1] = (uint8_t) value;
+}
+
+
+static void
+cmm_journal_put_u32
+(
+	uint8_t * p,
+	uint32_t value
+) {
+	p[0] = (uint8_t) (value >> 24);
+	p[1] = (uint8_t) (value >> 16);
+	p[2] = (uint8_t) (value >> 8);
+	p[3] = (uint8_t) value;
+}
+
+
+static uint16_t
+cmm_journal_get_u16
+(
+	const uint8_t * p
+) {
+	return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+
+static uint32_t
+cmm_journal_get_u32
+(
+	const uint8_t * p
+) {
+	return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+
+// Copy a string, counting it if it had to be cut short
+static void
+cmm_journal_copy_string
+(
+	cmm_journal_t * journal,
+	char * out,
+	const char * in
+) {
+	size_t len = in ? strlen(in) : 0;
+	if (len >= CMM_JOURNAL_MAX_STRING)
+	{
+		len = CMM_JOURNAL_MAX_STRING - 1;
+		journal->stats.num_truncated++;
+	}
+	memcpy(out, in, len);
+	out[len] = '\0';
+}
+
+
+/*
+	Encode a wide interface name as UTF-8. Surrogate pairs are joined where
+	wchar_t is 16 bits, and anything that is not a valid code point becomes
+	'?'. A character that does not fit is dropped whole.
+ */
+static void
+cmm_journal_copy_wide_string
+(
+	cmm_journal_t * journal,
+	char * out,
+	const wchar_t * in
+) {
+	size_t n = 0;
+
+	while (in && *in)
+	{
+		uint32_t c = (uint32_t) *in++;
+		uint8_t buf[4];
+		size_t len;
+
+		if (c >= 0xD800 && c < 0xDC00 && *in >= 0xDC00 && *in < 0xE000)
+		{
+			c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t) *in++ - 0xDC00);
+		}
+		else if ((c >= 0xD800 && c < 0xE000) || c > 0x10FFFF)
+		{
+			c = '?';
+		}
+
+		if (c < 0x80)
+		{
+			buf[0] = (uint8_t) c;
+			len = 1;
+		}
+		else if (c < 0x800)
+		{
+			buf[0] = (uint8_t) (0xC0 | (c >> 6));
+			buf[1] = (uint8_t) (0x80 | (c & 0x3F));
+			len = 2;
+		}
+		else if (c < 0x10000)
+		{
+			buf[0] = (uint8_t) (0xE0 | (c >> 12));
+			buf[1] = (uint8_t) (0x80 | ((c >> 6) & 0x3F));
+			buf[2] = (uint8_t) (0x80 | (c & 0x3F));
+			len = 3;
+		}
+		else
+		{
+			buf[0] = (uint8_t) (0xF0 | (c >> 18));
+			buf[1] = (uint8_t) (0x80 | ((c >> 12) & 0x3F));
+			buf[2] = (uint8_t) (0x80 | ((c >> 6) & 0x3F));
+			buf[3] = (uint8_t) (0x80 | (c & 0x3F));
+			len = 4;
+		}
+
+		if (n + len >= CMM_JOURNAL_MAX_STRING)
+		{
+			journal->stats.num_truncated++;
+			break;
+		}
+		memcpy(out + n, buf, len);
+		n += len;
+	}
+	out[n] = '\0';
+}
+
+
+static void
+cmm_journal_copy_config
+(
+	cmm_journal_t * journal,
+	cmm_journal_interface_list_t * list,
+	const cmm_config_t * config
+) {
+	uint16_t i, n = config ? cmm_config_num_interfaces(config) : 0;
+
+	if (n > CMM_JOURNAL_MAX_INTERFACES)
+	{
+		n = CMM_JOURNAL_MAX_INTERFACES;
+		journal->stats.num_truncated++;
+	}
+	for (i = 0; i < n; i++)
+	{
+		const cmm_interface_t * iface = cmm_config_interface_at_index(config, i);
+		memcpy(list->interfaces[i].mac, cmm_interface_get_mac_address(iface), 6);
+		cmm_journal_copy_wide_string(journal, list->interfaces[i].name, cmm_interface_get_name(iface));
+	}
+	list->num_interfaces = n;
+}
+
+
+static void
+cmm_journal_copy_options
+(
+	cmm_journal_t * journal,
+	cmm_journal_interface_list_t * list,
+	const cmm_options_t * options
+) {
+	uint16_t i, n = cmm_options_num_interfaces(options);
+
+	if (n > CMM_JOURNAL_MAX_INTERFACES)
+	{
+		n = CMM_JOURNAL_MAX_INTERFACES;
+		journal->stats.num_truncated++;
+	}
+	for (i = 0; i < n; i++)
+	{
+		const cmm_interface_t * iface = cmm_options_interface_at_index(options, i);
+		memcpy(list->interfaces[i].mac, cmm_interface_get_mac_address(iface), 6);
+		cmm_journal_copy_wide_string(journal, list->interfaces[i].name, cmm_interface_get_name(iface));
+	}
+	list->num_interfaces = n;
+}
+
+
+static void
+cmm_journal_copy_process
+(
+	cmm_journal_t * journal,
+	cmm_journal_process_t * out,
+	const cmm_process_t * process
+) {
+	out->id = cmm_process_get_id(process);
+	out->locking = cmm_process_is_locking_configuration(process) ? AUD_TRUE : AUD_FALSE;
+	cmm_journal_copy_string(journal, out->name, cmm_process_get_name(process));
+}
+
+
+// Copy the parts of the client that flags say may have changed, keeping the rest
+static void
+cmm_journal_take_snapshot
+(
+	cmm_journal_t * journal,
+	cmm_client_t * client,
+	uint32_t flags
+) {
+	cmm_journal_snapshot_t * snap = &journal->next;
+
+	*snap = journal->prev;
+	if (flags & CMM_CLIENT_EVENT_FLAG_CONNECTION_CHANGED)
+	{
+		const cmm_info_t * info = cmm_client_get_system_info(client);
+
+		snap->connection = cmm_client_get_connection_state(client);
+		snap->have |= CMM_JOURNAL_HAVE_CONNECTION;
+		if (info)
+		{
+			cmm_info_get_version(info, &snap->version);
+			snap->max_dante_networks = cmm_info_max_dante_networks(info);
+			snap->have |= CMM_JOURNAL_HAVE_INFO;
+		}
+	}
+	if (flags & CMM_CLIENT_EVENT_FLAG_OPTIONS_CHANGED)
+	{
+		const cmm_options_t * options = cmm_client_get_system_options(client);
+		if (options)
+		{
+			cmm_journal_copy_options(journal, &snap->options, options);
+			snap->have |= CMM_JOURNAL_HAVE_OPTIONS;
+		}
+	}
+	if (flags & CMM_CLIENT_EVENT_FLAG_STATE_CHANGED)
+	{
+		const cmm_state_t * state = cmm_client_get_system_state(client);
+		if (state)
+		{
+			const cmm_config_t * pending = cmm_state_get_pending_config(state);
+			uint16_t i, n = cmm_state_num_processes(state);
+
+			snap->system_status = cmm_state_get_system_status(state);
+			cmm_journal_copy_string(journal, snap->dante_device_name, cmm_state_get_dante_device_name(state));
+			cmm_journal_copy_config(journal, &snap->current, cmm_state_get_current_config(state));
+			snap->pending = pending ? AUD_TRUE : AUD_FALSE;
+			cmm_journal_copy_config(journal, &snap->pending_config, pending);
+			if (n > CMM_JOURNAL_MAX_PROCESSES)
+			{
+				n = CMM_JOURNAL_MAX_PROCESSES;
+				journal->stats.num_truncated++;
+			}
+			for (i = 0; i < n; i++)
+			{
+				cmm_journal_copy_process(journal, &snap->processes[i], cmm_state_process_at_index(state, i));
+			}
+			snap->num_processes = n;
+			snap->have |= CMM_JOURNAL_HAVE_STATE;
+		}
+	}
+	if (flags & CMM_CLIENT_EVENT_FLAG_PROCESS_CHANGED)
+	{
+		const cmm_process_t * process = cmm_client_get_process(client);
+		if (process)
+		{
+			cmm_journal_copy_process(journal, &snap->process, process);
+			snap->have |= CMM_JOURNAL_HAVE_PROCESS;
+		}
+	}
+}
+
+
+static aud_error_t
+cmm_journal_write
+(
+	cmm_journal_t * journal,
+	const uint8_t * buf,
+	size_t len
+) {
+	if (journal->file && fwrite(buf, 1, len, journal->file) != len)
+	{
+		return AUD_ERR_SYSTEM;
+	}
+	journal->stats.num_bytes += (unsigned long) len;
+	return AUD_SUCCESS;
+}
+
+
+// Encode journal->record, write it and hand it to the change function
+static aud_error_t
+cmm_journal_emit
+(
+	cmm_journal_t * journal
+) {
+	cmm_journal_record_t * record = &journal->record;
+	uint8_t buf[CMM_JOURNAL_MAX_RECORD];
+	int64_t delta = (int64_t) (record->time_ms - journal->last_ms);
+	uint64_t zigzag = ((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63);
+	size_t n = 0;
+	aud_error_t result;
+
+	n += cmm_journal_put_varint(buf + n, zigzag);
+	buf[n++] = (uint8_t) record->field;
+	n += cmm_journal_put_varint(buf + n, record->index);
+	n += cmm_journal_put_varint(buf + n, record->old_len);
+	memcpy(buf + n, record->old_value, record->old_len);
+	n += record->old_len;
+	n += cmm_journal_put_varint(buf + n, record->new_len);
+	memcpy(buf + n, record->new_value, record->new_len);
+	n += record->new_len;
+
+	result = cmm_journal_write(journal, buf, n);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	journal->last_ms = record->time_ms;
+	journal->stats.num_records++;
+	journal->update_records++;
+	if (journal->change_fn)
+	{
+		journal->change_fn(journal->context, record);
+	}
+	return AUD_SUCCESS;
+}
+
+
+static uint16_t
+cmm_journal_encode_string
+(
+	uint8_t * p,
+	const char * s
+) {
+	size_t len = strlen(s);
+	memcpy(p, s, len);
+	return (uint16_t) len;
+}
+
+
+static uint16_t
+cmm_journal_encode_interface
+(
+	uint8_t * p,
+	const cmm_journal_interface_t * iface
+) {
+	memcpy(p, iface->mac, 6);
+	return (uint16_t) (6 + cmm_journal_encode_string(p + 6, iface->name));
+}
+
+
+static uint16_t
+cmm_journal_encode_process
+(
+	uint8_t * p,
+	const cmm_journal_process_t * process
+) {
+	cmm_journal_put_u32(p, (uint32_t) process->id);
+	p[4] = (uint8_t) (process->locking ? 1 : 0);
+	return (uint16_t) (5 + cmm_journal_encode_string(p + 5, process->name));
+}
+
+
+// Write a record if the old and new values differ, or unconditionally if the part is new
+static aud_error_t
+cmm_journal_diff_value
+(
+	cmm_journal_t * journal,
+	cmm_journal_field_t field,
+	unsigned int index,
+	aud_bool_t had_old
+) {
+	cmm_journal_record_t * record = &journal->record;
+
+	if (!had_old)
+	{
+		record->old_len = 0;
+	}
+	else if (record->old_len == record->new_len
+		&& !memcmp(record->old_value, record->new_value, record->new_len))
+	{
+		return AUD_SUCCESS;
+	}
+	record->field = field;
+	record->index = index;
+	return cmm_journal_emit(journal);
+}
+
+
+static int
+cmm_journal_find_interface
+(
+	const cmm_journal_interface_list_t * list,
+	const uint8_t * mac
+) {
+	uint16_t i;
+	for (i = 0; i < list->num_interfaces; i++)
+	{
+		if (!memcmp(list->interfaces[i].mac, mac, 6))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+// Interfaces are matched by MAC address, a renamed interface gives one record with both names
+static aud_error_t
+cmm_journal_diff_interfaces
+(
+	cmm_journal_t * journal,
+	cmm_journal_field_t field,
+	const cmm_journal_interface_list_t * old_list,
+	const cmm_journal_interface_list_t * new_list
+) {
+	cmm_journal_record_t * record = &journal->record;
+	aud_error_t result;
+	uint16_t i;
+
+	for (i = 0; i < old_list->num_interfaces; i++)
+	{
+		if (cmm_journal_find_interface(new_list, old_list->interfaces[i].mac) < 0)
+		{
+			record->old_len = cmm_journal_encode_interface(record->old_value, &old_list->interfaces[i]);
+			record->new_len = 0;
+			result = cmm_journal_diff_value(journal, field, i, AUD_TRUE);
+			if (result != AUD_SUCCESS)
+			{
+				return result;
+			}
+		}
+	}
+	for (i = 0; i < new_list->num_interfaces; i++)
+	{
+		int old_index = cmm_journal_find_interface(old_list, new_list->interfaces[i].mac);
+
+		record->new_len = cmm_journal_encode_interface(record->new_value, &new_list->interfaces[i]);
+		if (old_index < 0)
+		{
+			record->old_len = 0;
+		}
+		else
+		{
+			record->old_len = cmm_journal_encode_interface(record->old_value, &old_list->interfaces[old_index]);
+		}
+		result = cmm_journal_diff_value(journal, field, i, AUD_TRUE);
+		if (result != AUD_SUCCESS)
+		{
+			return result;
+		}
+	}
+	return AUD_SUCCESS;
+}
+
+
+static int
+cmm_journal_find_process
+(
+	const cmm_journal_snapshot_t * snap,
+	const cmm_journal_process_t * process
+) {
+	uint16_t i;
+	for (i = 0; i < snap->num_processes; i++)
+	{
+		if (snap->processes[i].id == process->id && !strcmp(snap->processes[i].name, process->name))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+static aud_error_t
+cmm_journal_diff_processes
+(
+	cmm_journal_t * journal,
+	const cmm_journal_snapshot_t * old_snap,
+	const cmm_journal_snapshot_t * new_snap
+) {
+	cmm_journal_record_t * record = &journal->record;
+	aud_error_t result;
+	uint16_t i;
+
+	for (i = 0; i < old_snap->num_processes; i++)
+	{
+		if (cmm_journal_find_process(new_snap, &old_snap->processes[i]) < 0)
+		{
+			record->old_len = cmm_journal_encode_process(record->old_value, &old_snap->processes[i]);
+			record->new_len = 0;
+			result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_STATE_PROCESS, i, AUD_TRUE);
+			if (result != AUD_SUCCESS)
+			{
+				return result;
+			}
+		}
+	}
+	for (i = 0; i < new_snap->num_processes; i++)
+	{
+		int old_index = cmm_journal_find_process(old_snap, &new_snap->processes[i]);
+
+		record->new_len = cmm_journal_encode_process(record->new_value, &new_snap->processes[i]);
+		if (old_index < 0)
+		{
+			record->old_len = 0;
+		}
+		else
+		{
+			record->old_len = cmm_journal_encode_process(record->old_value, &old_snap->processes[old_index]);
+		}
+		result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_STATE_PROCESS, i, AUD_TRUE);
+		if (result != AUD_SUCCESS)
+		{
+			return result;
+		}
+	}
+	return AUD_SUCCESS;
+}
+
+
+static aud_error_t
+cmm_journal_diff_info
+(
+	cmm_journal_t * journal,
+	const cmm_journal_snapshot_t * old_snap,
+	const cmm_journal_snapshot_t * new_snap
+) {
+	cmm_journal_record_t * record = &journal->record;
+	aud_bool_t had_old = (old_snap->have & CMM_JOURNAL_HAVE_INFO) ? AUD_TRUE : AUD_FALSE;
+	aud_error_t result;
+
+	record->old_value[0] = old_snap->version.major;
+	record->old_value[1] = old_snap->version.minor;
+	cmm_journal_put_u16(record->old_value + 2, old_snap->version.bugfix);
+	record->new_value[0] = new_snap->version.major;
+	record->new_value[1] = new_snap->version.minor;
+	cmm_journal_put_u16(record->new_value + 2, new_snap->version.bugfix);
+	record->old_len = record->new_len = 4;
+	result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_INFO_VERSION, 0, had_old);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	cmm_journal_put_u16(record->old_value, old_snap->max_dante_networks);
+	cmm_journal_put_u16(record->new_value, new_snap->max_dante_networks);
+	record->old_len = record->new_len = 2;
+	return cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_INFO_MAX_DANTE_NETWORKS, 0, had_old);
+}
+
+
+static aud_error_t
+cmm_journal_diff_state
+(
+	cmm_journal_t * journal,
+	const cmm_journal_snapshot_t * old_snap,
+	const cmm_journal_snapshot_t * new_snap
+) {
+	cmm_journal_record_t * record = &journal->record;
+	aud_bool_t had_old = (old_snap->have & CMM_JOURNAL_HAVE_STATE) ? AUD_TRUE : AUD_FALSE;
+	aud_error_t result;
+
+	cmm_journal_put_u16(record->old_value, old_snap->system_status);
+	cmm_journal_put_u16(record->new_value, new_snap->system_status);
+	record->old_len = record->new_len = 2;
+	result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_STATE_SYSTEM_STATUS, 0, had_old);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	record->old_len = cmm_journal_encode_string(record->old_value, old_snap->dante_device_name);
+	record->new_len = cmm_journal_encode_string(record->new_value, new_snap->dante_device_name);
+	result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_STATE_DANTE_DEVICE_NAME, 0, had_old);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	result = cmm_journal_diff_interfaces(journal, CMM_JOURNAL_FIELD_STATE_CURRENT_INTERFACE,
+		&old_snap->current, &new_snap->current);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	record->old_value[0] = (uint8_t) (old_snap->pending ? 1 : 0);
+	record->new_value[0] = (uint8_t) (new_snap->pending ? 1 : 0);
+	record->old_len = record->new_len = 1;
+	result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_STATE_PENDING, 0, had_old);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	result = cmm_journal_diff_interfaces(journal, CMM_JOURNAL_FIELD_STATE_PENDING_INTERFACE,
+		&old_snap->pending_config, &new_snap->pending_config);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	return cmm_journal_diff_processes(journal, old_snap, new_snap);
+}
+
+
+static aud_error_t
+cmm_journal_diff_process
+(
+	cmm_journal_t * journal,
+	const cmm_journal_process_t * old_process,
+	const cmm_journal_process_t * new_process,
+	aud_bool_t had_old
+) {
+	cmm_journal_record_t * record = &journal->record;
+	aud_error_t result;
+
+	record->old_len = cmm_journal_encode_string(record->old_value, old_process->name);
+	record->new_len = cmm_journal_encode_string(record->new_value, new_process->name);
+	result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_PROCESS_NAME, 0, had_old);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	cmm_journal_put_u32(record->old_value, (uint32_t) old_process->id);
+	cmm_journal_put_u32(record->new_value, (uint32_t) new_process->id);
+	record->old_len = record->new_len = 4;
+	result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_PROCESS_ID, 0, had_old);
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+
+	record->old_value[0] = (uint8_t) (old_process->locking ? 1 : 0);
+	record->new_value[0] = (uint8_t) (new_process->locking ? 1 : 0);
+	record->old_len = record->new_len = 1;
+	return cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_PROCESS_LOCKING, 0, had_old);
+}
+
+
+static aud_error_t
+cmm_journal_get_value
+(
+	cmm_journal_reader_t * reader,
+	uint8_t * value,
+	uint16_t * len
+) {
+	uint64_t n;
+	aud_error_t result = cmm_journal_get_varint(reader, &n);
+
+	if (result != AUD_SUCCESS)
+	{
+		return result;
+	}
+	if (n > CMM_JOURNAL_MAX_VALUE)
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+	if (reader->len - reader->offset < n)
+	{
+		return AUD_ERR_TRUNCATED;
+	}
+	memcpy(value, reader->buf + reader->offset, (size_t) n);
+	reader->offset += (size_t) n;
+	*len = (uint16_t) n;
+	return AUD_SUCCESS;
+}
+
+
+static void
+cmm_journal_print_value
+(
+	FILE * file,
+	cmm_journal_field_t field,
+	const uint8_t * value,
+	uint16_t len
+) {
+	if (!len)
+	{
+		fprintf(file, "-");
+		return;
+	}
+	switch (field)
+	{
+	case CMM_JOURNAL_FIELD_CONNECTION:
+	case CMM_JOURNAL_FIELD_STATE_PENDING:
+	case CMM_JOURNAL_FIELD_PROCESS_LOCKING:
+		fprintf(file, "%u", value[0]);
+		break;
+	case CMM_JOURNAL_FIELD_INFO_VERSION:
+		if (len >= 4)
+		{
+			fprintf(file, "%u.%u.%u", value[0], value[1], cmm_journal_get_u16(value + 2));
+		}
+		break;
+	case CMM_JOURNAL_FIELD_INFO_MAX_DANTE_NETWORKS:
+		if (len >= 2)
+		{
+			fprintf(file, "%u", cmm_journal_get_u16(value));
+		}
+		break;
+	case CMM_JOURNAL_FIELD_STATE_SYSTEM_STATUS:
+		if (len >= 2)
+		{
+			fprintf(file, "%04x", cmm_journal_get_u16(value));
+		}
+		break;
+	case CMM_JOURNAL_FIELD_PROCESS_ID:
+		if (len >= 4)
+		{
+			fprintf(file, "%d", (int) cmm_journal_get_u32(value));
+		}
+		break;
+	case CMM_JOURNAL_FIELD_OPTIONS_INTERFACE:
+	case CMM_JOURNAL_FIELD_STATE_CURRENT_INTERFACE:
+	case CMM_JOURNAL_FIELD_STATE_PENDING_INTERFACE:
+		if (len >= 6)
+		{
+			fprintf(file, "%.*s(%02x:%02x:%02x:%02x:%02x:%02x)",
+				(int) (len - 6), (const char *) value + 6,
+				value[0], value[1], value[2], value[3], value[4], value[5]);
+		}
+		break;
+	case CMM_JOURNAL_FIELD_STATE_PROCESS:
+		if (len >= 5)
+		{
+			fprintf(file, "%.*s:%d(%s)", (int) (len - 5), (const char *) value + 5,
+				(int) cmm_journal_get_u32(value), value[4] ? "locking" : "not locking");
+		}
+		break;
+	default:
+		fprintf(file, "\"%.*s\"", (int) len, (const char *) value);
+		break;
+	}
+}
+
+
+//----------
+// Functions
+
+aud_error_t
+cmm_journal_new
+(
+	FILE * file,
+	const char * host,
+	cmm_journal_change_fn * change_fn,
+	void * context,
+	cmm_journal_t ** journal_ptr
+) {
+	cmm_journal_t * journal;
+	uint8_t header[CMM_JOURNAL_MAX_HEADER];
+	size_t host_len = host ? strlen(host) : 0;
+	size_t n;
+	aud_error_t result;
+
+	if (!journal_ptr)
+	{
+		return AUD_ERR_INVALIDPARAMETER;
+	}
+	journal = (cmm_journal_t *) calloc(1, sizeof(*journal));
+	if (!journal)
+	{
+		return AUD_ERR_NOMEMORY;
+	}
+	journal->file = file;
+	journal->change_fn = change_fn;
+	journal->context = context;
+
+	if (host_len >= CMM_JOURNAL_MAX_STRING)
+	{
+		host_len = CMM_JOURNAL_MAX_STRING - 1;
+		journal->stats.num_truncated++;
+	}
+	memcpy(header, CMM_JOURNAL_MAGIC, sizeof(CMM_JOURNAL_MAGIC));
+	header[4] = CMM_JOURNAL_VERSION;
+	n = 5 + cmm_journal_put_varint(header + 5, host_len);
+	memcpy(header + n, host, host_len);
+	n += host_len;
+	result = cmm_journal_write(journal, header, n);
+	if (result != AUD_SUCCESS)
+	{
+		free(journal);
+		return result;
+	}
+
+	*journal_ptr = journal;
+	return AUD_SUCCESS;
+}
+
+
+void
+cmm_journal_delete
+(
+	cmm_journal_t * journal
+) {
+	if (journal)
+	{
+		if (journal->file)
+		{
+			fflush(journal->file);
+		}
+		free(journal);
+	}
+}
+
+
+aud_error_t
+cmm_journal_update
+(
+	cmm_journal_t * journal,
+	cmm_client_t * client,
+	uint32_t flags,
+	uint64_t now_ms,
+	unsigned int * num_records
+) {
+	const cmm_journal_snapshot_t * old_snap = &journal->prev;
+	const cmm_journal_snapshot_t * new_snap = &journal->next;
+	cmm_journal_record_t * record = &journal->record;
+	aud_error_t result = AUD_SUCCESS;
+
+	journal->stats.num_updates++;
+	journal->update_records = 0;
+	cmm_journal_take_snapshot(journal, client, flags);
+	record->time_ms = now_ms;
+
+	if (new_snap->have & CMM_JOURNAL_HAVE_CONNECTION)
+	{
+		record->old_value[0] = (uint8_t) old_snap->connection;
+		record->new_value[0] = (uint8_t) new_snap->connection;
+		record->old_len = record->new_len = 1;
+		result = cmm_journal_diff_value(journal, CMM_JOURNAL_FIELD_CONNECTION, 0,
+			(old_snap->have & CMM_JOURNAL_HAVE_CONNECTION) ? AUD_TRUE : AUD_FALSE);
+	}
+	if (result == AUD_SUCCESS && (new_snap->have & CMM_JOURNAL_HAVE_INFO))
+	{
+		result = cmm_journal_diff_info(journal, old_snap, new_snap);
+	}
+	if (result == AUD_SUCCESS && (new_snap->have & CMM_JOURNAL_HAVE_OPTIONS))
+	{
+		result = cmm_journal_diff_interfaces(journal, CMM_JOURNAL_FIELD_OPTIONS_INTERFACE,
+			&old_snap->options, &new_snap->options);
+	}
+	if (result == AUD_SUCCESS && (new_snap->have & CMM_JOURNAL_HAVE_STATE))
+	{
+		result = cmm_journal_diff_state(journal, old_snap, new_snap);
+	}
+	if (result == AUD_SUCCESS && (new_snap->have & CMM_JOURNAL_HAVE_PROCESS))
+	{
+		result = cmm_journal_diff_process(journal, &old_snap->process, &new_snap->process,
+			(old_snap->have & CMM_JOURNAL_HAVE_PROCESS) ? AUD_TRUE : AUD_FALSE);
+	}
+
+	// keep the snapshot even on a write error, so the next update does not repeat the same records
+	journal->prev = journal->next;
+	if (num_records)
+	{
+		*num_records = journal->update_records;
+	}
+	return result;
+}
+
+
+void
+cmm_journal_get_stats
+(
+	const cmm_journal_t * journal,
+	cmm_journal_stats_t * stats
+) {
+	*stats = journal->stats;
+}
+
+
+const char *
+cmm_journal_field_to_string
+(
+	cmm_journal_field_t field
+) {
+	switch (field)
+	{
+	case CMM_JOURNAL_FIELD_CONNECTION:                return "connection";
+	case CMM_JOURNAL_FIELD_INFO_VERSION:              return "info.version";
+	case CMM_JOURNAL_FIELD_INFO_MAX_DANTE_NETWORKS:   return "info.max_dante_networks";
+	case CMM_JOURNAL_FIELD_OPTIONS_INTERFACE:         return "options.interface";
+	case CMM_JOURNAL_FIELD_STATE_SYSTEM_STATUS:       return "state.system_status";
+	case CMM_JOURNAL_FIELD_STATE_DANTE_DEVICE_NAME:   return "state.dante_device_name";
+	case CMM_JOURNAL_FIELD_STATE_CURRENT_INTERFACE:   return "state.current.interface";
+	case CMM_JOURNAL_FIELD_STATE_PENDING:             return "state.pending";
+	case CMM_JOURNAL_FIELD_STATE_PENDING_INTERFACE:   return "state.pending.interface";
+	case CMM_JOURNAL_FIELD_STATE_PROCESS:             return "state.process";
+	case CMM_JOURNAL_FIELD_PROCESS_NAME:              return "process.name";
+	case CMM_JOURNAL_FIELD_PROCESS_ID:                return "process.id";
+	case CMM_JOURNAL_FIELD_PROCESS_LOCKING:           return "process.locking";
+	default: return "?";
+	}
+}
+
+
+void
+cmm_journal_print_record
+(
+	FILE * file,
+	const cmm_journal_record_t * record
+) {
+	fprintf(file, "%llu %s[%u] ", (unsigned long long) record->time_ms,
+		cmm_journal_field_to_string(record->field), record->index);
+	cmm_journal_print_value(file, record->field, record->old_value, record->old_len);
+	fprintf(file, " -> ");
+	cmm_journal_print_value(file, record->field, record->new_value, record->new_len);
+	fprintf(file, "\n");
+}
+
+
+aud_error_t
+cmm_journal_reader_init
+(
+	cmm_journal_reader_t * reader,
+	const uint8_t * buf,
+	size_t len
+) {
+	uint64_t host_len;
+	aud_error_t result;
+
+	memset(reader, 0, sizeof(*reader));
+	reader->buf = buf;
+	reader->len = len;
+	if (len < 5 || memcmp(buf, CMM_JOURNAL_MAGIC, sizeof(CMM_JOURNAL_MAGIC)))
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+	reader->version = buf[4];
+	if (reader->version != CMM_JOURNAL_VERSION)
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+	reader->offset = 5;
+	result = cmm_journal_get_varint(reader, &host_len);
+	if (result != AUD_SUCCESS)
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+	if (host_len >= CMM_JOURNAL_MAX_STRING || reader->len - reader->offset < host_len)
+	{
+		return AUD_ERR_INVALIDDATA;
+	}
+	memcpy(reader->host, buf + reader->offset, (size_t) host_len);
+	reader->host[host_len] = '\0';
+	reader->offset += (size_t) host_len;
+	return AUD_SUCCESS;
+}
+
+
+aud_error_t
+cmm_journal_reader_next
+(
+	cmm_journal_reader_t * reader,
+	cmm_journal_record_t * record
+) {
+	size_t start = reader->offset;
+	uint64_t zigzag, index;
+	aud_error_t result;
+
+	if (reader->offset >= reader->len)
+	{
+		return AUD_ERR_DONE;
+	}
+
+	result = cmm_journal_get_varint(reader, &zigzag);
+	if (result == AUD_SUCCESS)
+	{
+		if (reader->offset >= reader->len)
+		{
+			result = AUD_ERR_TRUNCATED;
+		}
+		else
+		{
+			record->field = (cmm_journal_field_t) reader->buf[reader->offset++];
+			if (record->field < CMM_JOURNAL_FIELD_CONNECTION || record->field >= CMM_JOURNAL_NUM_FIELDS)
+			{
+				result = AUD_ERR_INVALIDDATA;
+			}
+		}
+	}
+	if (result == AUD_SUCCESS)
+	{
+		result = cmm_journal_get_varint(reader, &index);
+		record->index = (unsigned int) index;
+	}
+	if (result == AUD_SUCCESS)
+	{
+		result = cmm_journal_get_value(reader, record->old_value, &record->old_len);
+	}
+	if (result == AUD_SUCCESS)
+	{
+		result = cmm_journal_get_value(reader, record->new_value, &record->new_len);
+	}
+	if (result != AUD_SUCCESS)
+	{
+		// leave the reader where it was so a growing file can be read again
+		reader->offset = start;
+		return result;
+	}
+
+	reader->time_ms += (zigzag >> 1) ^ (0 - (zigzag & 1));
+	record->time_ms = reader->time_ms;
+	return AUD_SUCCESS;
+}
+
+
+//----------
@@ -0,0 +1,227 @@
+/*
+ * Created  : October 2026
+ * Author   :
+ * Synopsis : Field-level change journal for conmon manager state
+ *
+ * This software is copyright (c) 2004-2026 Audinate Pty Ltd and/or its licensors
+ *
+ * Audinate Copyright Header Version 1
+ */
+
+#ifndef _CMM_JOURNAL_H
+#define _CMM_JOURNAL_H
+
+
+//----------
+// Include
+
+#include "audinate/dante_api.h"
+
+#include <stdio.h>
+
+
+//----------
+// Types and Constants
+
+/*
+	The journal keeps a copy of the last system info, options, state and
+	process seen from a client. On each update the parts named by the event
+	flags are copied again and compared field by field, and one record is
+	written for every field that changed. The first time a part is seen
+	every field is written with an empty old value, giving a baseline.
+
+	Interfaces are matched by MAC address and processes by id and name, so
+	a record says which interface came, went or was renamed rather than
+	repeating the whole list.
+
+	Journal layout, with multi-byte fixed values big-endian and varints
+	7 bits per byte, low bits first:
+
+		"CMMJ", version byte, varint host length, host
+
+	followed by records:
+
+		varint time    zigzag ms since the previous record (the first is
+		               relative to the epoch)
+		field byte     CMM_JOURNAL_FIELD_
+		varint index   position in the list, or 0 for single fields
+		varint length, old value
+		varint length, new value
+
+	Values are:
+
+		connection      1 byte cmm_connection_state_t
+		version         major, minor, 2 bytes bugfix
+		u16 fields      2 bytes
+		strings         UTF-8, no terminator
+		interfaces      6 byte MAC then UTF-8 name
+		processes       4 byte id, 1 byte locking, then UTF-8 name
+		flags           1 byte 0 or 1
+
+	An added list entry has an empty old value and a removed one an empty
+	new value. Strings and lists are truncated to CMM_JOURNAL_MAX_STRING - 1
+	bytes and CMM_JOURNAL_MAX_INTERFACES or CMM_JOURNAL_MAX_PROCESSES
+	entries.
+ */
+
+#define CMM_JOURNAL_VERSION 1
+
+enum
+{
+	CMM_JOURNAL_MAX_STRING = 64,
+	CMM_JOURNAL_MAX_INTERFACES = 32,
+	CMM_JOURNAL_MAX_PROCESSES = 32,
+	CMM_JOURNAL_MAX_VALUE = 6 + CMM_JOURNAL_MAX_STRING
+};
+
+typedef struct cmm_journal cmm_journal_t;
+
+typedef enum
+{
+	CMM_JOURNAL_FIELD_CONNECTION = 1,
+	CMM_JOURNAL_FIELD_INFO_VERSION,
+	CMM_JOURNAL_FIELD_INFO_MAX_DANTE_NETWORKS,
+	CMM_JOURNAL_FIELD_OPTIONS_INTERFACE,
+	CMM_JOURNAL_FIELD_STATE_SYSTEM_STATUS,
+	CMM_JOURNAL_FIELD_STATE_DANTE_DEVICE_NAME,
+	CMM_JOURNAL_FIELD_STATE_CURRENT_INTERFACE,
+	CMM_JOURNAL_FIELD_STATE_PENDING,
+		// whether a config is pending
+	CMM_JOURNAL_FIELD_STATE_PENDING_INTERFACE,
+	CMM_JOURNAL_FIELD_STATE_PROCESS,
+	CMM_JOURNAL_FIELD_PROCESS_NAME,
+	CMM_JOURNAL_FIELD_PROCESS_ID,
+	CMM_JOURNAL_FIELD_PROCESS_LOCKING,
+	CMM_JOURNAL_NUM_FIELDS
+} cmm_journal_field_t;
+
+// One change, as written by the journal and read back by the reader
+typedef struct cmm_journal_record
+{
+	uint64_t time_ms;
+	cmm_journal_field_t field;
+	unsigned int index;
+	uint16_t old_len;
+	uint16_t new_len;
+	uint8_t old_value [CMM_JOURNAL_MAX_VALUE];
+	uint8_t new_value [CMM_JOURNAL_MAX_VALUE];
+} cmm_journal_record_t;
+
+// Called for each record as it is written
+typedef void
+cmm_journal_change_fn
+(
+	void * context,
+	const cmm_journal_record_t * record
+);
+
+typedef struct cmm_journal_stats
+{
+	unsigned long num_updates;
+	unsigned long num_records;
+	unsigned long num_bytes;
+		// including the journal header
+	unsigned long num_truncated;
+		// strings or lists cut short to fit
+} cmm_journal_stats_t;
+
+typedef struct cmm_journal_reader
+{
+	const uint8_t * buf;
+	size_t len;
+	size_t offset;
+	uint64_t time_ms;
+	unsigned int version;
+	char host [CMM_JOURNAL_MAX_STRING];
+} cmm_journal_reader_t;
+
+
+//----------
+// Functions
+
+/*
+	Create a journal writing to file, which may be NULL to only call
+	change_fn. The header is written straight away with host as the name
+	of the machine the journal came from.
+ */
+aud_error_t
+cmm_journal_new
+(
+	FILE * file,
+	const char * host,
+	cmm_journal_change_fn * change_fn,
+	void * context,
+	cmm_journal_t ** journal_ptr
+);
+
+// Does not close the file
+void
+cmm_journal_delete
+(
+	cmm_journal_t * journal
+);
+
+/*
+	Copy the parts of the client named by flags (CMM_CLIENT_EVENT_FLAG_
+	values) and write a record for every field that changed since they
+	were last copied. Parts the client does not have, such as state while
+	disconnected, keep their last value so a reconnect only records what
+	really changed.
+
+	@return the number of records written, via num_records if not NULL
+ */
+aud_error_t
+cmm_journal_update
+(
+	cmm_journal_t * journal,
+	cmm_client_t * client,
+	uint32_t flags,
+	uint64_t now_ms,
+	unsigned int * num_records
+);
+
+void
+cmm_journal_get_stats
+(
+	const cmm_journal_t * journal,
+	cmm_journal_stats_t * stats
+);
+
+const char *
+cmm_journal_field_to_string
+(
+	cmm_journal_field_t field
+);
+
+// Print a record as one line, decoding its values
+void
+cmm_journal_print_record
+(
+	FILE * file,
+	const cmm_journal_record_t * record
+);
+
+// @return AUD_ERR_INVALIDDATA if buf does not start with a journal header
+aud_error_t
+cmm_journal_reader_init
+(
+	cmm_journal_reader_t * reader,
+	const uint8_t * buf,
+	size_t len
+);
+
+/*
+	@return AUD_ERR_DONE at the end of the journal, AUD_ERR_TRUNCATED if the
+	last record is incomplete, or AUD_ERR_INVALIDDATA if a record is malformed
+ */
+aud_error_t
+cmm_journal_reader_next
+(
+	cmm_journal_reader_t * reader,
+	cmm_journal_record_t * record
+);
+
+
+//----------
+
+#endif // _CMM_JOURNAL_H
@@ -24,7 +24,14 @@
 #include <assert.h>
 #include <ctype.h>
 
+#ifdef DNSSD_BRQ_MOCK
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "dnssd_mock.h"
+#else
 #include "dns_sd.h"
+#endif
+#include "dnssd_txt.h"
 
 #ifndef MIN
 #define MIN(X,Y) (((X) < (Y)) ? (X) : (Y))
@@ -37,7 +44,6 @@
 #define MAX_NAME 256
 #define MAX_ADVERTS 2048
 #define MAX_BROWSE 3
-#define MAX_TXT 512
 
 typedef enum brq_interface_filter_mode
 {
@@ -100,8 +106,7 @@ struct brq_resolve
 	char target[MAX_NAME];
 	uint16_t port;
 
-	int txt_len;
-	uint8_t txt[MAX_TXT];	
+	brq_txt_t txt;
 };
 
 struct brq_advert
@@ -135,6 +140,17 @@ struct brq_stats
 	uint32_t num_queried;
 };
 
+// TXT records are counted separately as re-announcements must not reset stability
+typedef struct brq_txt_stats
+{
+	uint32_t num_parsed;
+	uint32_t num_unchanged;
+	uint32_t num_invalid;
+} brq_txt_stats_t;
+
+static brq_txt_stats_t g_txt_stats;
+static brq_txt_t g_txt_scratch;
+
 static int fds[1024];
 
 static int select_ref(brq_ref_t * ref, fd_set * fds, int n)
@@ -285,6 +301,36 @@ query_callback
 		query->_.addr8[0], query->_.addr8[1], query->_.addr8[2], query->_.addr8[3]);		
 }
 
+static void
+print_txt_change
+(
+	void * context,
+	brq_txt_change_t change,
+	const brq_txt_t * old_txt,
+	const brq_txt_entry_t * old_entry,
+	const brq_txt_t * new_txt,
+	const brq_txt_entry_t * new_entry
+) {
+	(void) context;
+	switch (change)
+	{
+	case BRQ_TXT_CHANGE_ADDED:
+		fprintf(stderr, " +%.*s='%.*s'",
+			new_entry->key_len, brq_txt_entry_key(new_txt, new_entry),
+			new_entry->value_len, brq_txt_entry_value(new_txt, new_entry));
+		break;
+	case BRQ_TXT_CHANGE_REMOVED:
+		fprintf(stderr, " -%.*s", old_entry->key_len, brq_txt_entry_key(old_txt, old_entry));
+		break;
+	case BRQ_TXT_CHANGE_MODIFIED:
+		fprintf(stderr, " ~%.*s='%.*s'->'%.*s'",
+			new_entry->key_len, brq_txt_entry_key(new_txt, new_entry),
+			old_entry->value_len, brq_txt_entry_value(old_txt, old_entry),
+			new_entry->value_len, brq_txt_entry_value(new_txt, new_entry));
+		break;
+	}
+}
+
 static void DNSSD_API
 resolve_common
 (
@@ -321,47 +367,40 @@ resolve_common
 		}
 	}
 
-	if (!txt_len || txt_len != resolve->txt_len || !txt_record || memcmp(txt_record, resolve->txt, MAX_TXT))
-	{
-		resolve->txt_len = 0;
-		memset(resolve->txt, 0, MAX_TXT);
-	}
-
-	if (txt_len && txt_record)
-	{
-		resolve->txt_len = txt_len;
-		memcpy(resolve->txt, txt_record, MIN(MAX_TXT, txt_len));
-	}
-
 	/*fprintf(stderr, "%s: RESOLVED: %08x %d %s %s %d %d %p =>", __FUNCTION__, flags,
 		interface_index, full_name,
 		host_target, ntohs(port),
 		txt_len, txt_record);*/
-	fprintf(stderr, "%s: RESOLVED: %s => %s:%d\n", __FUNCTION__,
+	fprintf(stderr, "%s: RESOLVED: %s => %s:%d", __FUNCTION__,
 		full_name, resolve->target, resolve->port);
+
+	if (txt_len && txt_record)
 	{
-		uint16_t i, count;
-		
-		if (resolve->txt_len)
+		uint32_t hash = brq_txt_hash(txt_record, txt_len);
+		if (brq_txt_matches(&resolve->txt, txt_record, txt_len, hash))
 		{
-			count = TXTRecordGetCount(resolve->txt_len, resolve->txt);
-			for (i = 0; i < count; i++)
-			{
-				char entry[MAX_TXT];
-				char key[MAX_TXT];
-				char * value;
-				uint8_t tmp, len;
-				memset(entry, 0, MAX_TXT);
-				TXTRecordGetItemAtIndex(resolve->txt_len, resolve->txt, i, MAX_TXT, key, &len, (const void **) &value);
-				SNPRINTF(entry, MAX_TXT, "%s='", key);
-				tmp = (uint8_t) strlen(entry);
-				memcpy(((char *) entry) + tmp, value, len);
-				entry[tmp + len] = '\'';
-				entry[tmp + len+1] = '\0';
-				fprintf(stderr, " %s", entry);
-			}
+			// re-announcement of a record we have already parsed
+			fprintf(stderr, " (txt unchanged)");
+			g_txt_stats.num_unchanged++;
+		}
+		else if (brq_txt_parse(&g_txt_scratch, txt_record, txt_len, hash))
+		{
+			fprintf(stderr, " (txt invalid, len=%u)", txt_len);
+			brq_txt_reset(&resolve->txt);
+			g_txt_stats.num_invalid++;
+		}
+		else
+		{
+			brq_txt_diff(&resolve->txt, &g_txt_scratch, print_txt_change, NULL);
+			// the old record's buffers become the next scratch
+			brq_txt_swap(&resolve->txt, &g_txt_scratch);
+			g_txt_stats.num_parsed++;
 		}
 	}
+	else
+	{
+		brq_txt_reset(&resolve->txt);
+	}
 	fprintf(stderr, "\n");
 }
 
@@ -589,6 +628,7 @@ browse_callback
 
 		cleanup_ref(&advert->resolve.ref);
 		cleanup_ref(&advert->query.ref);
+		brq_txt_free(&advert->resolve.txt);
 		memset(advert, 0, sizeof(brq_advert_t));
 
 		advert->interface_index = interface_index;
@@ -667,6 +707,7 @@ browse_callback
 
 		cleanup_ref(&advert->resolve.ref);
 		cleanup_ref(&advert->query.ref);
+		brq_txt_free(&advert->resolve.txt);
 		memset(advert, 0, sizeof(brq_advert_t));
 	}
 }
@@ -686,9 +727,65 @@ void usage(char * bin)
 	fprintf(stderr, "-q        Query A records\n");
 	fprintf(stderr, "-u        Print incomplete operations when system stabilises\n");
 	fprintf(stderr, "-x        Exit when system stabilises\n");
+#ifdef DNSSD_BRQ_MOCK
+	fprintf(stderr, "MOCK OPTIONS:\n");
+	fprintf(stderr, "-mn=COUNT Serve COUNT adverts for each '_netaudio-*' type (default 100)\n");
+	fprintf(stderr, "-mt=BYTES Pad TXT records to BYTES (default 0)\n");
+	fprintf(stderr, "-mc=RATE  Simulate RATE device reboots per second (default 0)\n");
+	fprintf(stderr, "-ml=SECS  Stop after SECS seconds (default 0, no limit)\n");
+#endif
 	exit(0);
 }
 
+#ifdef DNSSD_BRQ_MOCK
+
+static double
+elapsed_ms
+(
+	const struct timeval * start
+) {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+/*
+	Print a single machine-readable line to stdout summarising the run.
+	Discovery time is the time until every served advert was browsed and had
+	completed all of the requested resolves and queries, or -1 if that never
+	happened.
+ */
+static void
+print_bench_summary
+(
+	unsigned int num_expected,
+	double discovery_ms,
+	double run_ms
+) {
+	struct rusage usage;
+	dnssd_mock_stats_t mock_stats;
+	double cpu_ms;
+
+	getrusage(RUSAGE_SELF, &usage);
+	dnssd_mock_get_stats(&mock_stats);
+	cpu_ms = usage.ru_utime.tv_sec * 1000.0 + usage.ru_utime.tv_usec / 1000.0
+		+ usage.ru_stime.tv_sec * 1000.0 + usage.ru_stime.tv_usec / 1000.0;
+
+	printf("BENCH adverts=%u discovery_ms=%.1f run_ms=%.1f cpu_ms=%.1f cpu_us_per_advert=%.2f"
+		" maxrss_kb=%ld replies=%llu reboots=%llu max_refs=%u"
+		" txt_parsed=%u txt_unchanged=%u txt_invalid=%u\n",
+		num_expected, discovery_ms, run_ms, cpu_ms,
+		num_expected ? cpu_ms * 1000.0 / num_expected : 0.0,
+		usage.ru_maxrss,
+		(unsigned long long) mock_stats.num_replies,
+		(unsigned long long) mock_stats.num_reboots,
+		mock_stats.max_refs,
+		g_txt_stats.num_parsed, g_txt_stats.num_unchanged, g_txt_stats.num_invalid);
+	fflush(stdout);
+}
+
+#endif
+
 static int g_num_browses = 0;
 static brq_browse_t g_browses[MAX_BROWSE];
 
@@ -705,6 +802,14 @@ int main(int argc, char * argv[])
 
 	int changes, stable = 0;
 
+#ifdef DNSSD_BRQ_MOCK
+	dnssd_mock_config_t mock_config = {100, 0, 0, 1};
+	unsigned int mock_limit_secs = 0;
+	unsigned int num_expected = 0;
+	double discovery_ms = -1;
+	struct timeval start;
+#endif
+
 	for (b = 0; b < MAX_BROWSE; b++)
 	{
 		memset(g_browses+b, 0, sizeof(brq_browse_t));
@@ -753,6 +858,24 @@ int main(int argc, char * argv[])
 		{
 			exit_stable = 1;
 		}
+#ifdef DNSSD_BRQ_MOCK
+		else if (!strncmp(argv[a], "-mn=", 4) && strlen(argv[a]) > 4)
+		{
+			mock_config.num_adverts = atoi(argv[a] + 4);
+		}
+		else if (!strncmp(argv[a], "-mt=", 4) && strlen(argv[a]) > 4)
+		{
+			mock_config.txt_size = atoi(argv[a] + 4);
+		}
+		else if (!strncmp(argv[a], "-mc=", 4) && strlen(argv[a]) > 4)
+		{
+			mock_config.churn_rate = atoi(argv[a] + 4);
+		}
+		else if (!strncmp(argv[a], "-ml=", 4) && strlen(argv[a]) > 4)
+		{
+			mock_limit_secs = atoi(argv[a] + 4);
+		}
+#endif
 		else
 		{
 			usage(argv[0]);
@@ -763,6 +886,26 @@ int main(int argc, char * argv[])
 	{
 		usage(argv[0]);
 	}
+
+#ifdef DNSSD_BRQ_MOCK
+	if (mock_config.num_adverts > MAX_ADVERTS)
+	{
+		fprintf(stderr, "%s: at most %d adverts can be tracked per browse\n", __FUNCTION__, MAX_ADVERTS);
+		exit(1);
+	}
+	if (dnssd_mock_init(&mock_config))
+	{
+		exit(1);
+	}
+	for (b = 0; b < g_num_browses; b++)
+	{
+		if (!strncmp(g_browses[b].service_type, "_netaudio-", 10))
+		{
+			num_expected += mock_config.num_adverts;
+		}
+	}
+	gettimeofday(&start, NULL);
+#endif
 	
 	for (b = 0; b < g_num_browses; b++)
 	{
@@ -867,7 +1010,7 @@ int main(int argc, char * argv[])
 					}
 					else if (g_resolve)
 					{
-						if (advert->resolve.target[0] && advert->resolve.txt_len)
+						if (advert->resolve.target[0] && advert->resolve.txt.len)
 						{
 							curr_stats.num_resolved++;
 						}
@@ -907,9 +1050,29 @@ int main(int argc, char * argv[])
 					curr_stats.num_resolving, curr_stats.num_resolved,
 					curr_stats.num_querying, curr_stats.num_queried);
 			}
+			if (g_resolve && !g_resolve_llq)
+			{
+				fprintf(stderr, "%s: TXT STATS parsed=%u unchanged=%u invalid=%u\n", __FUNCTION__,
+					g_txt_stats.num_parsed, g_txt_stats.num_unchanged, g_txt_stats.num_invalid);
+			}
 			fprintf(stderr, "\n");
 		}
 
+#ifdef DNSSD_BRQ_MOCK
+		if (discovery_ms < 0
+			&& curr_stats.num_browsed == num_expected
+			&& (!(g_resolve || g_resolve_llq) || g_getaddrinfo || curr_stats.num_resolved == num_expected)
+			&& (!(g_query || g_getaddrinfo) || curr_stats.num_queried == num_expected))
+		{
+			discovery_ms = elapsed_ms(&start);
+			fprintf(stderr, "%s: DISCOVERED ALL %u adverts in %.1fms\n", __FUNCTION__, num_expected, discovery_ms);
+		}
+		if (mock_limit_secs && elapsed_ms(&start) >= mock_limit_secs * 1000.0)
+		{
+			break;
+		}
+#endif
+
 		if (changes)
 		{
 			stable = 0;
@@ -977,6 +1140,13 @@ int main(int argc, char * argv[])
 	}
 
 	// TODO: cleanup
-	
+
+#ifdef DNSSD_BRQ_MOCK
+	print_bench_summary(num_expected, discovery_ms, elapsed_ms(&start));
+	dnssd_mock_shutdown();
+	// usable as a regression gate: fail if discovery never completed
+	return discovery_ms < 0;
+#else
 	return 0;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,732 @@
+#include "dnssd_mock.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+#define MOCK_MAX_NAME 256
+#define MOCK_MAX_TXT 4096	// dnssd_txt parses records of any size
+#define MOCK_PORT 4440
+#define MOCK_TTL 120
+#define MOCK_INTERFACE_INDEX 1
+#define MOCK_CHURN_PERIOD_NS 10000000	// 10ms
+
+typedef enum mock_op
+{
+	MOCK_OP_BROWSE,
+	MOCK_OP_RESOLVE,
+	MOCK_OP_QUERY_SRV,
+	MOCK_OP_QUERY_A,
+	MOCK_OP_GETADDRINFO
+} mock_op_t;
+
+// A queued reply. Everything else in a reply is derived from the advert index.
+typedef struct mock_reply
+{
+	uint32_t advert;
+	uint32_t generation;
+	uint32_t add;
+} mock_reply_t;
+
+struct _DNSServiceRef_t
+{
+	mock_op_t op;
+	int fd;	// eventfd, readable while replies are queued
+	union
+	{
+		DNSServiceBrowseReply browse;
+		DNSServiceResolveReply resolve;
+		DNSServiceQueryRecordReply query;
+		DNSServiceGetAddrInfoReply getaddrinfo;
+	} callback;
+	void * context;
+
+	char regtype[MOCK_MAX_NAME];
+	char domain[MOCK_MAX_NAME];
+	uint32_t advert;	// target of a resolve or query
+
+	mock_reply_t * queue;
+	unsigned int head;
+	unsigned int count;
+	unsigned int capacity;
+
+	struct _DNSServiceRef_t * prev;
+	struct _DNSServiceRef_t * next;
+};
+
+static dnssd_mock_config_t g_config;
+static dnssd_mock_stats_t g_stats;
+static uint32_t * g_generations;
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static DNSServiceRef g_refs;
+
+static pthread_t g_churn_thread;
+static int g_churn_running = 0;	// guarded by g_lock once the churn thread is started
+
+//----------
+// Synthetic adverts
+
+static int
+parse_advert
+(
+	const char * name,
+	uint32_t * advert
+) {
+	unsigned int index;
+	if (!name || sscanf(name, "mock-%5u", &index) != 1 || index >= g_config.num_adverts)
+	{
+		return -1;
+	}
+	*advert = index;
+	return 0;
+}
+
+static uint16_t
+append_txt_item
+(
+	uint8_t * txt,
+	uint16_t len,
+	const char * item
+) {
+	size_t item_len = strlen(item);
+	if (item_len > 255 || len + 1 + item_len > MOCK_MAX_TXT)
+	{
+		return len;
+	}
+	txt[len] = (uint8_t) item_len;
+	memcpy(txt + len + 1, item, item_len);
+	return (uint16_t) (len + 1 + item_len);
+}
+
+// Build a TXT record resembling a Dante device, padded out to the configured size
+static uint16_t
+build_txt
+(
+	uint8_t * txt,
+	uint32_t advert,
+	uint32_t generation
+) {
+	char item[256];
+	uint16_t len = 0;
+	unsigned int pad;
+
+	len = append_txt_item(txt, len, "txtvers=2");
+	len = append_txt_item(txt, len, "mf=Audinate");
+	len = append_txt_item(txt, len, "model=MOCK");
+	snprintf(item, sizeof(item), "id=001dc1fffe%06x", advert);
+	len = append_txt_item(txt, len, item);
+	len = append_txt_item(txt, len, "rate=48000");
+	len = append_txt_item(txt, len, "latency_ns=1000000");
+	snprintf(item, sizeof(item), "boot=%u", generation);
+	len = append_txt_item(txt, len, item);
+
+	for (pad = 0; (unsigned int) len + 8 < g_config.txt_size && len + 8 < MOCK_MAX_TXT; pad++)
+	{
+		size_t prefix, fill = g_config.txt_size - len - 1;
+		if (fill > 255)
+		{
+			fill = 255;
+		}
+		prefix = snprintf(item, sizeof(item), "pad%u=", pad);
+		if (fill <= prefix)
+		{
+			break;
+		}
+		memset(item + prefix, 'a' + (pad % 26), fill - prefix);
+		item[fill] = '\0';
+		len = append_txt_item(txt, len, item);
+	}
+	return len;
+}
+
+static void
+advert_address
+(
+	uint32_t advert,
+	uint8_t addr[4]
+) {
+	addr[0] = 10;
+	addr[1] = 42;
+	addr[2] = (uint8_t) (advert >> 8);
+	addr[3] = (uint8_t) advert;
+}
+
+//----------
+// Refs and reply queues
+
+// called with g_lock held
+static int
+queue_reply
+(
+	DNSServiceRef ref,
+	uint32_t advert,
+	uint32_t add
+) {
+	mock_reply_t * reply;
+
+	if (ref->count == ref->capacity)
+	{
+		unsigned int i, capacity = ref->capacity ? ref->capacity * 2 : 16;
+		mock_reply_t * queue = (mock_reply_t *) malloc(capacity * sizeof(mock_reply_t));
+		if (!queue)
+		{
+			return -1;
+		}
+		for (i = 0; i < ref->count; i++)
+		{
+			queue[i] = ref->queue[(ref->head + i) % ref->capacity];
+		}
+		free(ref->queue);
+		ref->queue = queue;
+		ref->head = 0;
+		ref->capacity = capacity;
+	}
+
+	reply = ref->queue + (ref->head + ref->count) % ref->capacity;
+	reply->advert = advert;
+	reply->generation = g_generations[advert];
+	reply->add = add;
+
+	if (ref->count++ == 0)
+	{
+		uint64_t one = 1;
+		if (write(ref->fd, &one, sizeof(one)) != sizeof(one))
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static DNSServiceErrorType
+new_ref
+(
+	DNSServiceRef * result,
+	mock_op_t op,
+	void * context
+) {
+	DNSServiceRef ref;
+
+	if (!result || !g_generations)
+	{
+		return kDNSServiceErr_BadParam;
+	}
+	ref = (DNSServiceRef) calloc(1, sizeof(struct _DNSServiceRef_t));
+	if (!ref)
+	{
+		return kDNSServiceErr_NoMemory;
+	}
+	ref->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (ref->fd < 0)
+	{
+		free(ref);
+		return kDNSServiceErr_NoMemory;
+	}
+	ref->op = op;
+	ref->context = context;
+
+	// linked in by the caller once the ref is fully set up
+	*result = ref;
+	return kDNSServiceErr_NoError;
+}
+
+// called with g_lock held
+static void
+link_ref
+(
+	DNSServiceRef ref
+) {
+	ref->next = g_refs;
+	if (g_refs)
+	{
+		g_refs->prev = ref;
+	}
+	g_refs = ref;
+	g_stats.num_refs++;
+	if (g_stats.num_refs > g_stats.max_refs)
+	{
+		g_stats.max_refs = g_stats.num_refs;
+	}
+}
+
+static void
+free_ref
+(
+	DNSServiceRef ref
+) {
+	close(ref->fd);
+	free(ref->queue);
+	free(ref);
+}
+
+//----------
+// Churn
+
+static void *
+churn_thread
+(
+	void * arg
+) {
+	struct timespec period = {0, MOCK_CHURN_PERIOD_NS};
+	unsigned int seed = g_config.seed;
+	double due = 0;
+
+	(void) arg;
+	for (;;)
+	{
+		nanosleep(&period, NULL);
+
+		due += g_config.churn_rate * (MOCK_CHURN_PERIOD_NS / 1e9);
+		pthread_mutex_lock(&g_lock);
+		if (!g_churn_running)
+		{
+			pthread_mutex_unlock(&g_lock);
+			break;
+		}
+		for (; due >= 1; due -= 1)
+		{
+			uint32_t advert = (uint32_t) (rand_r(&seed) % g_config.num_adverts);
+			DNSServiceRef ref;
+
+			// a reboot withdraws the advert and then announces it with a new TXT record
+			g_generations[advert]++;
+			for (ref = g_refs; ref; ref = ref->next)
+			{
+				if (ref->op == MOCK_OP_BROWSE)
+				{
+					queue_reply(ref, advert, 0);
+					queue_reply(ref, advert, 1);
+				}
+			}
+			g_stats.num_reboots++;
+		}
+		pthread_mutex_unlock(&g_lock);
+	}
+	return NULL;
+}
+
+//----------
+// Mock configuration
+
+int
+dnssd_mock_init
+(
+	const dnssd_mock_config_t * config
+) {
+	if (!config->num_adverts || config->num_adverts > DNSSD_MOCK_MAX_ADVERTS)
+	{
+		fprintf(stderr, "%s: number of adverts must be 1..%u\n", __FUNCTION__, DNSSD_MOCK_MAX_ADVERTS);
+		return -1;
+	}
+	if (config->txt_size > MOCK_MAX_TXT)
+	{
+		fprintf(stderr, "%s: TXT size must be at most %u\n", __FUNCTION__, MOCK_MAX_TXT);
+		return -1;
+	}
+
+	g_config = *config;
+	memset(&g_stats, 0, sizeof(g_stats));
+	g_generations = (uint32_t *) calloc(g_config.num_adverts, sizeof(uint32_t));
+	if (!g_generations)
+	{
+		return -1;
+	}
+
+	if (g_config.churn_rate)
+	{
+		g_churn_running = 1;
+		if (pthread_create(&g_churn_thread, NULL, churn_thread, NULL))
+		{
+			g_churn_running = 0;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+void
+dnssd_mock_shutdown(void)
+{
+	int churning;
+
+	pthread_mutex_lock(&g_lock);
+	churning = g_churn_running;
+	g_churn_running = 0;
+	pthread_mutex_unlock(&g_lock);
+	if (churning)
+	{
+		pthread_join(g_churn_thread, NULL);
+	}
+	free(g_generations);
+	g_generations = NULL;
+}
+
+void
+dnssd_mock_get_stats
+(
+	dnssd_mock_stats_t * stats
+) {
+	pthread_mutex_lock(&g_lock);
+	*stats = g_stats;
+	pthread_mutex_unlock(&g_lock);
+}
+
+//----------
+// dns_sd.h subset
+
+int DNSSD_API
+DNSServiceRefSockFD(DNSServiceRef ref)
+{
+	return ref ? ref->fd : -1;
+}
+
+DNSServiceErrorType DNSSD_API
+DNSServiceProcessResult(DNSServiceRef ref)
+{
+	mock_op_t op;
+	mock_reply_t reply;
+	DNSServiceFlags flags;
+	void * context;
+	char regtype[MOCK_MAX_NAME];
+	char domain[MOCK_MAX_NAME];
+	char name[MOCK_MAX_NAME];
+	char full_name[kDNSServiceMaxDomainName];
+	char host[MOCK_MAX_NAME];
+	uint8_t addr[4];
+
+	if (!ref)
+	{
+		return kDNSServiceErr_BadReference;
+	}
+
+	// the callback may deallocate the ref, so take copies of everything first
+	pthread_mutex_lock(&g_lock);
+	if (!ref->count)
+	{
+		pthread_mutex_unlock(&g_lock);
+		return kDNSServiceErr_NoError;
+	}
+	reply = ref->queue[ref->head];
+	ref->head = (ref->head + 1) % ref->capacity;
+	ref->count--;
+	if (!ref->count)
+	{
+		uint64_t value;
+		if (read(ref->fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+		{
+			pthread_mutex_unlock(&g_lock);
+			return kDNSServiceErr_Unknown;
+		}
+	}
+	flags = ref->count ? kDNSServiceFlagsMoreComing : 0;
+	op = ref->op;
+	context = ref->context;
+	memcpy(regtype, ref->regtype, sizeof(regtype));
+	memcpy(domain, ref->domain, sizeof(domain));
+	g_stats.num_replies++;
+	pthread_mutex_unlock(&g_lock);
+
+	snprintf(name, sizeof(name), "mock-%05u", reply.advert);
+	snprintf(host, sizeof(host), "mock-%05u.local.", reply.advert);
+	advert_address(reply.advert, addr);
+
+	switch (op)
+	{
+	case MOCK_OP_BROWSE:
+		ref->callback.browse(ref, flags | (reply.add ? kDNSServiceFlagsAdd : 0),
+			MOCK_INTERFACE_INDEX, kDNSServiceErr_NoError,
+			name, regtype, domain, context);
+		break;
+
+	case MOCK_OP_RESOLVE:
+		{
+			uint8_t txt[MOCK_MAX_TXT];
+			uint16_t txt_len = build_txt(txt, reply.advert, reply.generation);
+			DNSServiceConstructFullName(full_name, name, regtype, domain);
+			ref->callback.resolve(ref, flags, MOCK_INTERFACE_INDEX, kDNSServiceErr_NoError,
+				full_name, host, htons(MOCK_PORT), txt_len, txt, context);
+		}
+		break;
+
+	case MOCK_OP_QUERY_SRV:
+		{
+			// priority, weight, port, then the target as DNS labels
+			uint8_t rdata[6 + MOCK_MAX_NAME];
+			uint16_t rdlen = 6;
+			size_t label_len = strlen(name);
+
+			memset(rdata, 0, 4);
+			rdata[4] = MOCK_PORT >> 8;
+			rdata[5] = MOCK_PORT & 0xff;
+			rdata[rdlen++] = (uint8_t) label_len;
+			memcpy(rdata + rdlen, name, label_len);
+			rdlen += (uint16_t) label_len;
+			rdata[rdlen++] = 5;
+			memcpy(rdata + rdlen, "local", 5);
+			rdlen += 5;
+			rdata[rdlen++] = 0;
+
+			ref->callback.query(ref, flags, MOCK_INTERFACE_INDEX, kDNSServiceErr_NoError,
+				regtype, kDNSServiceType_SRV, kDNSServiceClass_IN,
+				rdlen, rdata, MOCK_TTL, context);
+		}
+		break;
+
+	case MOCK_OP_QUERY_A:
+		ref->callback.query(ref, flags, MOCK_INTERFACE_INDEX, kDNSServiceErr_NoError,
+			host, kDNSServiceType_A, kDNSServiceClass_IN,
+			sizeof(addr), addr, MOCK_TTL, context);
+		break;
+
+	case MOCK_OP_GETADDRINFO:
+		{
+			struct sockaddr_in in;
+			memset(&in, 0, sizeof(in));
+			in.sin_family = AF_INET;
+			in.sin_port = htons(MOCK_PORT);
+			memcpy(&in.sin_addr.s_addr, addr, sizeof(addr));
+			ref->callback.getaddrinfo(ref, flags, MOCK_INTERFACE_INDEX, kDNSServiceErr_NoError,
+				host, (const struct sockaddr *) &in, MOCK_TTL, context);
+		}
+		break;
+	}
+	return kDNSServiceErr_NoError;
+}
+
+void DNSSD_API
+DNSServiceRefDeallocate(DNSServiceRef ref)
+{
+	if (!ref)
+	{
+		return;
+	}
+	pthread_mutex_lock(&g_lock);
+	if (ref->prev)
+	{
+		ref->prev->next = ref->next;
+	}
+	else
+	{
+		g_refs = ref->next;
+	}
+	if (ref->next)
+	{
+		ref->next->prev = ref->prev;
+	}
+	g_stats.num_refs--;
+	pthread_mutex_unlock(&g_lock);
+
+	free_ref(ref);
+}
+
+DNSServiceErrorType DNSSD_API
+DNSServiceBrowse
+(
+	DNSServiceRef * result,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	const char * regtype,
+	const char * domain,
+	DNSServiceBrowseReply callback,
+	void * context
+) {
+	DNSServiceRef ref;
+	DNSServiceErrorType err;
+	uint32_t a;
+
+	(void) flags;
+	(void) interface_index;
+
+	if (!regtype || !callback)
+	{
+		return kDNSServiceErr_BadParam;
+	}
+	err = new_ref(&ref, MOCK_OP_BROWSE, context);
+	if (err)
+	{
+		return err;
+	}
+	ref->callback.browse = callback;
+	snprintf(ref->regtype, sizeof(ref->regtype), "%s.", regtype);
+	snprintf(ref->domain, sizeof(ref->domain), "%s", domain ? domain : "local.");
+
+	pthread_mutex_lock(&g_lock);
+	link_ref(ref);
+	if (!strncmp(regtype, "_netaudio-", 10))
+	{
+		// everything is already in the cache, so announce it all straight away
+		for (a = 0; a < g_config.num_adverts; a++)
+		{
+			queue_reply(ref, a, 1);
+		}
+	}
+	pthread_mutex_unlock(&g_lock);
+
+	*result = ref;
+	return kDNSServiceErr_NoError;
+}
+
+// Create a ref that answers a single advert, or never answers if the name is unknown
+static DNSServiceErrorType
+new_query_ref
+(
+	DNSServiceRef * result,
+	mock_op_t op,
+	const char * name,
+	void * context
+) {
+	DNSServiceRef ref;
+	DNSServiceErrorType err;
+	uint32_t advert;
+	int known;
+
+	err = new_ref(&ref, op, context);
+	if (err)
+	{
+		return err;
+	}
+	known = !parse_advert(name, &advert);
+	ref->advert = known ? advert : 0;
+
+	pthread_mutex_lock(&g_lock);
+	link_ref(ref);
+	if (known)
+	{
+		queue_reply(ref, advert, 1);
+	}
+	pthread_mutex_unlock(&g_lock);
+
+	*result = ref;
+	return kDNSServiceErr_NoError;
+}
+
+DNSServiceErrorType DNSSD_API
+DNSServiceResolve
+(
+	DNSServiceRef * result,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	const char * name,
+	const char * regtype,
+	const char * domain,
+	DNSServiceResolveReply callback,
+	void * context
+) {
+	DNSServiceErrorType err;
+
+	(void) flags;
+	(void) interface_index;
+
+	if (!name || !regtype || !callback)
+	{
+		return kDNSServiceErr_BadParam;
+	}
+	err = new_query_ref(result, MOCK_OP_RESOLVE, name, context);
+	if (!err)
+	{
+		// set before the caller can process the ref
+		(*result)->callback.resolve = callback;
+		snprintf((*result)->regtype, MOCK_MAX_NAME, "%s", regtype);
+		snprintf((*result)->domain, MOCK_MAX_NAME, "%s", domain ? domain : "local.");
+	}
+	return err;
+}
+
+DNSServiceErrorType DNSSD_API
+DNSServiceQueryRecord
+(
+	DNSServiceRef * result,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	const char * fullname,
+	uint16_t rrtype,
+	uint16_t rrclass,
+	DNSServiceQueryRecordReply callback,
+	void * context
+) {
+	DNSServiceErrorType err;
+	mock_op_t op;
+
+	(void) flags;
+	(void) interface_index;
+
+	if (!fullname || !callback || rrclass != kDNSServiceClass_IN)
+	{
+		return kDNSServiceErr_BadParam;
+	}
+	if (rrtype == kDNSServiceType_SRV)
+	{
+		op = MOCK_OP_QUERY_SRV;
+	}
+	else if (rrtype == kDNSServiceType_A)
+	{
+		op = MOCK_OP_QUERY_A;
+	}
+	else
+	{
+		return kDNSServiceErr_Unsupported;
+	}
+	err = new_query_ref(result, op, fullname, context);
+	if (!err)
+	{
+		(*result)->callback.query = callback;
+		snprintf((*result)->regtype, MOCK_MAX_NAME, "%s", fullname);
+	}
+	return err;
+}
+
+DNSServiceErrorType DNSSD_API
+DNSServiceGetAddrInfo
+(
+	DNSServiceRef * result,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	uint32_t protocol,
+	const char * hostname,
+	DNSServiceGetAddrInfoReply callback,
+	void * context
+) {
+	DNSServiceErrorType err;
+
+	(void) flags;
+	(void) interface_index;
+	(void) protocol;
+
+	if (!hostname || !callback)
+	{
+		return kDNSServiceErr_BadParam;
+	}
+	err = new_query_ref(result, MOCK_OP_GETADDRINFO, hostname, context);
+	if (!err)
+	{
+		(*result)->callback.getaddrinfo = callback;
+	}
+	return err;
+}
+
+int DNSSD_API
+DNSServiceConstructFullName
+(
+	char * full_name,
+	const char * service,
+	const char * regtype,
+	const char * domain
+) {
+	size_t len;
+	if (!full_name || !regtype)
+	{
+		return kDNSServiceErr_BadParam;
+	}
+	len = strlen(regtype);
+	snprintf(full_name, kDNSServiceMaxDomainName, "%s%s%s%s%s",
+		service ? service : "", service ? "." : "",
+		regtype, (len && regtype[len-1] == '.') ? "" : ".",
+		domain ? domain : "local.");
+	return kDNSServiceErr_NoError;
+}
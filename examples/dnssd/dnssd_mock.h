@@ -0,0 +1,239 @@
+#ifndef DNSSD_MOCK_H
+#define DNSSD_MOCK_H
+
+/*
+	An in-process stand-in for the mDNSResponder client library, used to
+	benchmark dnssd_brq on a machine with no Dante devices (or no mDNS daemon).
+
+	The mock implements the subset of dns_sd.h that dnssd_brq uses. It serves
+	a configurable number of synthetic Dante adverts under every browsed
+	'_netaudio-*' service type; browsing for any other type finds nothing.
+	Every DNSServiceRef owns a file descriptor that becomes readable while
+	replies are queued for it, so the existing select loop is exercised just
+	as it is against a real daemon. A background thread simulates devices
+	rebooting at a configurable rate by removing and re-adding adverts with a
+	changed TXT record.
+
+	The mock is Linux only. Build the benchmark with:
+
+		cc -O2 -DDNSSD_BRQ_MOCK -o dnssd_brq_bench dnssd_brq.c dnssd_txt.c dnssd_mock.c -lpthread
+
+	and run, for example:
+
+		./dnssd_brq_bench -b=_netaudio-arc._udp -r -q -mn=1000 -mt=200 -x 2>/dev/null
+*/
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//----------
+// dns_sd.h subset
+
+#define DNSSD_API
+
+typedef struct _DNSServiceRef_t * DNSServiceRef;
+typedef uint32_t DNSServiceFlags;
+typedef int32_t DNSServiceErrorType;
+
+enum
+{
+	kDNSServiceFlagsMoreComing = 0x1,
+	kDNSServiceFlagsAdd = 0x2,
+	kDNSServiceFlagsLongLivedQuery = 0x100
+};
+
+enum
+{
+	kDNSServiceErr_NoError = 0,
+	kDNSServiceErr_Unknown = -65537,
+	kDNSServiceErr_NoMemory = -65539,
+	kDNSServiceErr_BadParam = -65540,
+	kDNSServiceErr_BadReference = -65541,
+	kDNSServiceErr_Unsupported = -65544
+};
+
+enum
+{
+	kDNSServiceType_A = 1,
+	kDNSServiceType_SRV = 33
+};
+
+enum
+{
+	kDNSServiceClass_IN = 1
+};
+
+enum
+{
+	kDNSServiceProtocol_IPv4 = 0x01
+};
+
+#define kDNSServiceInterfaceIndexAny 0
+#define kDNSServiceMaxDomainName 1009
+
+typedef void (DNSSD_API * DNSServiceBrowseReply)
+(
+	DNSServiceRef ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	DNSServiceErrorType error_code,
+	const char * service_name,
+	const char * service_type,
+	const char * service_domain,
+	void * context
+);
+
+typedef void (DNSSD_API * DNSServiceResolveReply)
+(
+	DNSServiceRef ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	DNSServiceErrorType error_code,
+	const char * full_name,
+	const char * host_target,
+	uint16_t port,	// network byte order
+	uint16_t txt_len,
+	const unsigned char * txt_record,
+	void * context
+);
+
+typedef void (DNSSD_API * DNSServiceQueryRecordReply)
+(
+	DNSServiceRef ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	DNSServiceErrorType error_code,
+	const char * full_name,
+	uint16_t rrtype,
+	uint16_t rrclass,
+	uint16_t rdlen,
+	const void * rdata,
+	uint32_t ttl,
+	void * context
+);
+
+typedef void (DNSSD_API * DNSServiceGetAddrInfoReply)
+(
+	DNSServiceRef ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	DNSServiceErrorType error_code,
+	const char * hostname,
+	const struct sockaddr * address,
+	uint32_t ttl,
+	void * context
+);
+
+int DNSSD_API
+DNSServiceRefSockFD(DNSServiceRef ref);
+
+DNSServiceErrorType DNSSD_API
+DNSServiceProcessResult(DNSServiceRef ref);
+
+void DNSSD_API
+DNSServiceRefDeallocate(DNSServiceRef ref);
+
+DNSServiceErrorType DNSSD_API
+DNSServiceBrowse
+(
+	DNSServiceRef * ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	const char * regtype,
+	const char * domain,
+	DNSServiceBrowseReply callback,
+	void * context
+);
+
+DNSServiceErrorType DNSSD_API
+DNSServiceResolve
+(
+	DNSServiceRef * ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	const char * name,
+	const char * regtype,
+	const char * domain,
+	DNSServiceResolveReply callback,
+	void * context
+);
+
+DNSServiceErrorType DNSSD_API
+DNSServiceQueryRecord
+(
+	DNSServiceRef * ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	const char * fullname,
+	uint16_t rrtype,
+	uint16_t rrclass,
+	DNSServiceQueryRecordReply callback,
+	void * context
+);
+
+DNSServiceErrorType DNSSD_API
+DNSServiceGetAddrInfo
+(
+	DNSServiceRef * ref,
+	DNSServiceFlags flags,
+	uint32_t interface_index,
+	uint32_t protocol,
+	const char * hostname,
+	DNSServiceGetAddrInfoReply callback,
+	void * context
+);
+
+int DNSSD_API
+DNSServiceConstructFullName
+(
+	char * full_name,
+	const char * service,
+	const char * regtype,
+	const char * domain
+);
+
+//----------
+// Mock configuration
+
+#define DNSSD_MOCK_MAX_ADVERTS 4096
+
+typedef struct dnssd_mock_config
+{
+	unsigned int num_adverts;	// adverts served per '_netaudio-*' type
+	unsigned int txt_size;	// approximate TXT record size in bytes
+	unsigned int churn_rate;	// simulated device reboots per second
+	unsigned int seed;	// seed for choosing which devices reboot
+} dnssd_mock_config_t;
+
+typedef struct dnssd_mock_stats
+{
+	uint64_t num_replies;	// replies delivered through DNSServiceProcessResult
+	uint64_t num_reboots;	// simulated device reboots
+	unsigned int num_refs;	// currently allocated refs
+	unsigned int max_refs;	// high water mark of allocated refs
+} dnssd_mock_stats_t;
+
+/*
+	Configure the mock. Must be called before any other function and returns
+	non-zero if the configuration is invalid.
+ */
+int
+dnssd_mock_init
+(
+	const dnssd_mock_config_t * config
+);
+
+// Stop the churn thread and release the advert table
+void
+dnssd_mock_shutdown(void);
+
+void
+dnssd_mock_get_stats
+(
+	dnssd_mock_stats_t * stats
+);
+
+#endif
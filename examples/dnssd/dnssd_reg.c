@@ -1,43 +1,187 @@
 #include "dnssd_examples.h"
 
+#include <string.h>
+
+#ifdef __linux__
+#define DNSSD_REG_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#define MAX_SERVICES 16384
+#ifndef DNSSD_REG_EPOLL
+// Leave room in the fd_set for stdio, the daemon connection and the shared connection
+#define MAX_SELECT_SERVICES (FD_SETSIZE - 16)
+#endif
+#define MAX_TXT 1024
+#define MAX_EVENTS 64
+#define CHURN_PERIOD_MS 100
+#define CHURN_REPORT_MS 5000
+
+struct runtime;
+
+typedef struct service
+{
+	struct runtime * r;
+	DNSServiceRef sdRef;
+	int fd;	// -1 when sharing the runtime's connection
+	unsigned int index;
+	unsigned int generation;	// bumped each time the service is re-registered
+	aud_bool_t registered;
+} service_t;
+
 typedef struct runtime
 {
 	int running;
 	aud_bool_t status;
-	
-	DNSServiceRef sdRef;
+
+	DNSServiceRef sdRef;	// shared connection, if any
 	unsigned int port;
 	const char * service_type;
-	
+	const char * name_prefix;	// NULL for a single service with the default name
+
+	unsigned int num_services;
+	service_t * services;
+	aud_bool_t share_connection;
+	unsigned int churn_rate;	// re-registrations per second
+	unsigned int txt_size;
+	unsigned int seed;
+	aud_bool_t seed_set;
+
+	unsigned int num_registered;
+	unsigned int num_reregistered;
+	unsigned int num_failed;
+	aud_bool_t all_registered;
+	aud_utime_t start;
+
 	fd_set rfd;
 	int fd_max;
+#ifdef DNSSD_REG_EPOLL
+	int epfd;
+#endif
 } runtime_t;
 
 
+static unsigned int
+elapsed_ms (const aud_utime_t * since)
+{
+	aud_utime_t now;
+	aud_utime_get (& now);
+	return (unsigned int) ((now.tv_sec - since->tv_sec) * 1000 + (now.tv_usec - since->tv_usec) / 1000);
+}
+
+
+static void
+add_fd (runtime_t * r, int fd, void * context)
+{
+#ifdef DNSSD_REG_EPOLL
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.ptr = context;
+	if (epoll_ctl (r->epfd, EPOLL_CTL_ADD, fd, & ev) < 0)
+	{
+		fprintf (stderr,
+			"epoll_ctl error: %s (%d)\n"
+			, strerror (errno), errno
+		);
+	}
+#else
+	AUD_UNUSED (context);
+	FD_SET (fd, & r->rfd);
+	if (fd + 1 > r->fd_max)
+	{
+		r->fd_max = fd+1;
+	}
+#endif
+}
+
+static void
+remove_fd (runtime_t * r, int fd)
+{
+#ifdef DNSSD_REG_EPOLL
+	epoll_ctl (r->epfd, EPOLL_CTL_DEL, fd, NULL);
+#else
+	FD_CLR (fd, & r->rfd);
+#endif
+}
+
+
+static void
+process_service (runtime_t * r, service_t * svc)
+{
+	DNSServiceErrorType errcode;
+
+	errcode = DNSServiceProcessResult (svc ? svc->sdRef : r->sdRef);
+	if (errcode != kDNSServiceErr_NoError)
+	{
+		fprintf (stderr,
+			"Error processing result: %d\n"
+			, errcode
+		);
+		r->running = AUD_FALSE;
+		r->status = AUD_FALSE;
+	}
+}
+
+
+static aud_bool_t reregister_services (runtime_t * r, unsigned int count);
 
 static aud_bool_t
 run_loop (runtime_t * r)
 {
+	unsigned int churn_time = 0, report_time = 0;
+	double churn_due = 0;
+
 	r->running = AUD_TRUE;
 	r->status = AUD_TRUE;
 
 	while (r->running)
 	{
+		int sel_result, timeout_ms = r->churn_rate ? CHURN_PERIOD_MS : -1;
+#ifdef DNSSD_REG_EPOLL
+		struct epoll_event events[MAX_EVENTS];
+
+		sel_result = epoll_wait (r->epfd, events, MAX_EVENTS, timeout_ms);
+		if (sel_result > 0)
+		{
+			int i;
+			for (i = 0; i < sel_result && r->running; i++)
+			{
+				process_service (r, (service_t *) events[i].data.ptr);
+			}
+		}
+#else
 		fd_set r_curr;
-		int sel_result;
+		struct timeval timeout = {0, CHURN_PERIOD_MS * 1000};
 
 		AUD_FD_COPY (& r->rfd, & r_curr);
-		
-		sel_result = select (r->fd_max, & r_curr, NULL, NULL, NULL);
+
+		sel_result = select (r->fd_max, & r_curr, NULL, NULL, timeout_ms < 0 ? NULL : & timeout);
 		if (sel_result > 0)
 		{
-			int fd = DNSServiceRefSockFD (r->sdRef);
-			if (FD_ISSET (fd, & r_curr))
+			if (r->share_connection)
+			{
+				if (FD_ISSET (DNSServiceRefSockFD (r->sdRef), & r_curr))
+				{
+					process_service (r, NULL);
+				}
+			}
+			else
 			{
-				DNSServiceProcessResult (r->sdRef);
+				// a ref may be re-registered while processing, so only trust refs that were in the set
+				unsigned int i;
+				for (i = 0; i < r->num_services && r->running; i++)
+				{
+					service_t * svc = r->services + i;
+					if (svc->sdRef && FD_ISSET (svc->fd, & r_curr))
+					{
+						FD_CLR (svc->fd, & r_curr);
+						process_service (r, svc);
+					}
+				}
 			}
 		}
-		else
+#endif
+		else if (sel_result < 0)
 		{
 			int err = errno;
 			if (err != EINTR)
@@ -50,32 +194,41 @@ run_loop (runtime_t * r)
 				r->status = AUD_FALSE;
 			}
 		}
-	}
-	
-	return r->status;
-}
-
 
-static void
-add_fd (runtime_t * r, int fd)
-{
-	FD_SET (fd, & r->rfd);
-	if (fd + 1 > r->fd_max)
-	{
-		r->fd_max = fd+1;
+		if (r->churn_rate && r->running)
+		{
+			unsigned int now = elapsed_ms (& r->start);
+			if (now - churn_time >= CHURN_PERIOD_MS)
+			{
+				churn_due += r->churn_rate * (now - churn_time) / 1000.0;
+				churn_time = now;
+				if (churn_due >= 1)
+				{
+					unsigned int count = (unsigned int) churn_due;
+					churn_due -= count;
+					if (! reregister_services (r, count))
+					{
+						r->running = AUD_FALSE;
+						r->status = AUD_FALSE;
+					}
+				}
+			}
+			if (now - report_time >= CHURN_REPORT_MS)
+			{
+				report_time = now;
+				printf (
+					"Re-registered %u services (%u registered, %u failed)\n"
+					, r->num_reregistered, r->num_registered, r->num_failed
+				);
+			}
+		}
 	}
-}
 
-#if 0
-// this function is unused at the moment
-static void
-remove_fd (runtime_t * r, int fd)
-{
-	FD_CLR (fd, & r->rfd);
+	return r->status;
 }
-#endif
 
-static void DNSSD_API 
+
+static void DNSSD_API
 register_reply (
 	DNSServiceRef sdRef,
 	DNSServiceFlags flags,
@@ -86,13 +239,30 @@ register_reply (
 	void * context
 )
 {
-	runtime_t * r = context;
+	service_t * svc = context;
+	runtime_t * r = svc->r;
 	if (errCode == kDNSServiceErr_NoError)
 	{
-		printf (
-			"Registered %s.%s%s\n"
-			, name, regtype, domain
-		);
+		if (! svc->registered)
+		{
+			svc->registered = AUD_TRUE;
+			r->num_registered++;
+		}
+		if (r->num_services == 1)
+		{
+			printf (
+				"Registered %s.%s%s\n"
+				, name, regtype, domain
+			);
+		}
+		else if (r->num_registered == r->num_services && ! r->all_registered)
+		{
+			r->all_registered = AUD_TRUE;
+			printf (
+				"Registered %u services in %u ms\n"
+				, r->num_services, elapsed_ms (& r->start)
+			);
+		}
 	}
 	else
 	{
@@ -100,31 +270,103 @@ register_reply (
 			"Registeration failed: %d\n"
 			, errCode
 		);
-		r->running = AUD_FALSE;
-		r->status = AUD_FALSE;
+		r->num_failed++;
+		if (r->num_services == 1)
+		{
+			r->running = AUD_FALSE;
+			r->status = AUD_FALSE;
+		}
+	}
+}
+
+
+static uint16_t
+append_txt_item (uint8_t * txt, uint16_t len, const char * item)
+{
+	size_t item_len = strlen (item);
+	if (item_len > 255 || len + 1 + item_len > MAX_TXT)
+	{
+		return len;
+	}
+	txt[len] = (uint8_t) item_len;
+	memcpy (txt + len + 1, item, item_len);
+	return (uint16_t) (len + 1 + item_len);
+}
+
+// Build a synthetic TXT record of roughly the requested size
+static uint16_t
+build_txt (const runtime_t * r, const service_t * svc, uint8_t * txt)
+{
+	char item[256];
+	uint16_t len = 0;
+	unsigned int pad;
+
+	len = append_txt_item (txt, len, "txtvers=1");
+	sprintf (item, "boot=%u", svc->generation);
+	len = append_txt_item (txt, len, item);
+
+	for (pad = 0; (unsigned int) len + 8 < r->txt_size && len + 8 < MAX_TXT; pad++)
+	{
+		size_t prefix, fill = r->txt_size - len - 1;
+		if (fill > 255)
+		{
+			fill = 255;
+		}
+		if (len + 1 + fill > MAX_TXT)
+		{
+			fill = MAX_TXT - len - 1;
+		}
+		prefix = sprintf (item, "pad%u=", pad);
+		if (fill <= prefix)
+		{
+			break;
+		}
+		memset (item + prefix, 'x', fill - prefix);
+		item[fill] = '\0';
+		len = append_txt_item (txt, len, item);
 	}
+	return len;
 }
 
 
 static aud_bool_t
-register_service (runtime_t * r)
+register_service (runtime_t * r, service_t * svc)
 {
 	DNSServiceErrorType errcode;
-	
+	DNSServiceFlags flags = 0;
+	char name[64];
+	uint8_t txt[MAX_TXT];
+	uint16_t txt_len = 0;
+
+	if (r->name_prefix)
+	{
+		sprintf (name, "%.48s-%05u", r->name_prefix, svc->index);
+	}
+	if (r->txt_size)
+	{
+		txt_len = build_txt (r, svc, txt);
+	}
+	if (r->share_connection)
+	{
+		// subordinate refs are created by copying the shared connection
+		svc->sdRef = r->sdRef;
+		flags |= kDNSServiceFlagsShareConnection;
+	}
+
 	errcode =
 		DNSServiceRegister (
-			& r->sdRef,
-			0,	// no flags
+			& svc->sdRef,
+			flags,
 			0,	// all interfaces
-			NULL,	// hostname
+			r->name_prefix ? name : NULL,	// default name for a single service
 			r->service_type,
-			NULL,	// default domain 
+			NULL,	// default domain
 			NULL,	// default host
-			htons (r->port),
-			0,	// no TXT record
-			NULL,	// no TXT record
+			htons ((uint16_t) r->port),
+			txt_len,
+			txt_len ? txt : NULL,
 			register_reply,	// callback
-			r	// context
+			svc	// context
 		);
 	if (errcode != kDNSServiceErr_NoError)
 	{
@@ -132,29 +374,220 @@ register_service (runtime_t * r)
 			"Failed to register %s on port %u: %d\n"
 			, r->service_type, r->port, errcode
 		);
+		svc->sdRef = NULL;
+		return AUD_FALSE;
+	}
+
+	if (r->share_connection)
+	{
+		svc->fd = -1;
+	}
+	else
+	{
+		svc->fd = DNSServiceRefSockFD (svc->sdRef);
+		add_fd (r, svc->fd, svc);
+	}
+
+	return AUD_TRUE;
+}
+
+
+static void
+deregister_service (runtime_t * r, service_t * svc)
+{
+	if (svc->sdRef)
+	{
+		if (svc->fd >= 0)
+		{
+			remove_fd (r, svc->fd);
+		}
+		DNSServiceRefDeallocate (svc->sdRef);
+		svc->sdRef = NULL;
+	}
+	if (svc->registered)
+	{
+		svc->registered = AUD_FALSE;
+		r->num_registered--;
+	}
+}
+
+
+// Simulate devices rebooting by withdrawing and re-registering random services
+static aud_bool_t
+reregister_services (runtime_t * r, unsigned int count)
+{
+	unsigned int i;
+	for (i = 0; i < count; i++)
+	{
+		service_t * svc = r->services + (rand () % r->num_services);
+		deregister_service (r, svc);
+		svc->generation++;
+		if (! register_service (r, svc))
+		{
+			return AUD_FALSE;
+		}
+		r->num_reregistered++;
+	}
+	return AUD_TRUE;
+}
+
+
+static aud_bool_t
+register_services (runtime_t * r)
+{
+	unsigned int i;
+
+	r->services = calloc (r->num_services, sizeof (service_t));
+	if (! r->services)
+	{
+		fprintf (stderr, "Failed to allocate %u services\n", r->num_services);
+		return AUD_FALSE;
+	}
+
+#ifdef DNSSD_REG_EPOLL
+	r->epfd = epoll_create1 (EPOLL_CLOEXEC);
+	if (r->epfd < 0)
+	{
+		fprintf (stderr,
+			"epoll_create error: %s (%d)\n"
+			, strerror (errno), errno
+		);
 		return AUD_FALSE;
 	}
+#endif
+
+	if (r->share_connection)
+	{
+		DNSServiceErrorType errcode = DNSServiceCreateConnection (& r->sdRef);
+		if (errcode != kDNSServiceErr_NoError)
+		{
+			fprintf (stderr,
+				"Failed to create shared connection: %d\n"
+				, errcode
+			);
+			return AUD_FALSE;
+		}
+		add_fd (r, DNSServiceRefSockFD (r->sdRef), NULL);
+	}
+
+	aud_utime_get (& r->start);
+	if (r->churn_rate)
+	{
+		if (! r->seed_set)
+		{
+			r->seed = (unsigned int) (r->start.tv_sec ^ r->start.tv_usec);
+		}
+		srand (r->seed);
+		printf ("Churn seed %u\n", r->seed);
+	}
+	for (i = 0; i < r->num_services; i++)
+	{
+		service_t * svc = r->services + i;
+		svc->r = r;
+		svc->index = i;
+		svc->fd = -1;
+		if (! register_service (r, svc))
+		{
+			return AUD_FALSE;
+		}
+	}
 
-	add_fd (r, DNSServiceRefSockFD (r->sdRef));
-	
 	return AUD_TRUE;
 }
 
 
+static void
+usage (const char * bin)
+{
+	fprintf (stderr, "Usage: %s [OPTIONS]\n", bin);
+	fprintf (stderr, "OPTIONS:\n");
+	fprintf (stderr, "-t=TYPE     Register services of type TYPE (default _example._udp)\n");
+	fprintf (stderr, "-p=PORT     Register services on PORT (default 6789)\n");
+	fprintf (stderr, "-n=COUNT    Register COUNT synthetic services (default 1)\n");
+	fprintf (stderr, "-name=NAME  Name synthetic services NAME-00000, NAME-00001, ... (default reg)\n");
+	fprintf (stderr, "-s          Register all services over one shared connection\n");
+	fprintf (stderr, "-c=RATE     Re-register RATE random services per second\n");
+	fprintf (stderr, "-seed=N     Pick the services to re-register with seed N (default from the time)\n");
+	fprintf (stderr, "-txt=BYTES  Attach a TXT record of about BYTES bytes\n");
+	exit (1);
+}
+
+
 int
-main (void)
+main (int argc, char * argv[])
 {
 	aud_bool_t success = AUD_FALSE;
+	int a;
 
 	runtime_t r = {0};
-	
+
 	r.port = 6789;
 	r.service_type = "_example._udp";
-	
-	if (register_service (& r))
+	r.num_services = 1;
+
+	for (a = 1; a < argc; a++)
+	{
+		if (! strncmp (argv[a], "-t=", 3) && argv[a][3])
+		{
+			r.service_type = argv[a] + 3;
+		}
+		else if (! strncmp (argv[a], "-p=", 3) && argv[a][3])
+		{
+			r.port = atoi (argv[a] + 3);
+		}
+		else if (! strncmp (argv[a], "-n=", 3) && argv[a][3])
+		{
+			r.num_services = atoi (argv[a] + 3);
+		}
+		else if (! strncmp (argv[a], "-name=", 6) && argv[a][6])
+		{
+			r.name_prefix = argv[a] + 6;
+		}
+		else if (! strcmp (argv[a], "-s"))
+		{
+			r.share_connection = AUD_TRUE;
+		}
+		else if (! strncmp (argv[a], "-c=", 3) && argv[a][3])
+		{
+			r.churn_rate = atoi (argv[a] + 3);
+		}
+		else if (! strncmp (argv[a], "-seed=", 6) && argv[a][6])
+		{
+			r.seed = (unsigned int) strtoul (argv[a] + 6, NULL, 0);
+			r.seed_set = AUD_TRUE;
+		}
+		else if (! strncmp (argv[a], "-txt=", 5) && argv[a][5])
+		{
+			r.txt_size = atoi (argv[a] + 5);
+		}
+		else
+		{
+			usage (argv[0]);
+		}
+	}
+	if (r.num_services < 1 || r.num_services > MAX_SERVICES || r.port > 0xffff)
+	{
+		usage (argv[0]);
+	}
+#ifndef DNSSD_REG_EPOLL
+	if (! r.share_connection && r.num_services > MAX_SELECT_SERVICES)
+	{
+		fprintf (stderr,
+			"At most %d services can be registered on separate connections here, use -s for more\n"
+			, MAX_SELECT_SERVICES
+		);
+		exit (1);
+	}
+#endif
+	if (r.num_services > 1 && ! r.name_prefix)
+	{
+		r.name_prefix = "reg";
+	}
+
+	if (register_services (& r))
 	{
 		success = run_loop (& r);
 	}
-	
+
 	return ! success;
 }
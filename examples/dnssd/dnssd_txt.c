@@ -0,0 +1,372 @@
+#include "dnssd_txt.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Interned keys live in a fixed arena indexed by an open-addressing table.
+// TXT records from any one service type share a small set of keys, so the
+// table only ever holds a few dozen entries in practice. Keys seen once it
+// is full are left uninterned and compared by their bytes.
+#define BRQ_TXT_KEY_SLOTS 1024	// must be a power of two
+#define BRQ_TXT_KEY_ARENA (32 * 1024)
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static const char * g_key_slots[BRQ_TXT_KEY_SLOTS];
+static uint32_t g_key_hashes[BRQ_TXT_KEY_SLOTS];
+static char g_key_arena[BRQ_TXT_KEY_ARENA];
+static size_t g_key_arena_used = 0;
+static unsigned int g_num_keys = 0;
+
+static uint32_t
+fnv1a
+(
+	uint32_t hash,
+	const uint8_t * data,
+	size_t len
+) {
+	size_t i;
+	for (i = 0; i < len; i++)
+	{
+		hash ^= data[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static uint8_t
+fold
+(
+	uint8_t c
+) {
+	return (c >= 'A' && c <= 'Z') ? (uint8_t) (c + ('a' - 'A')) : c;
+}
+
+static uint32_t
+key_hash
+(
+	const char * key,
+	size_t len
+) {
+	uint32_t hash = FNV_OFFSET_BASIS;
+	size_t i;
+	for (i = 0; i < len; i++)
+	{
+		hash ^= fold((uint8_t) key[i]);
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+// Keys compare ignoring ASCII case (RFC 6763 section 6.4)
+static int
+key_equals
+(
+	const char * a,
+	size_t a_len,
+	const char * b,
+	size_t b_len
+) {
+	size_t i;
+	if (a_len != b_len)
+	{
+		return 0;
+	}
+	for (i = 0; i < a_len; i++)
+	{
+		if (fold((uint8_t) a[i]) != fold((uint8_t) b[i]))
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static int
+reserve
+(
+	brq_txt_t * txt,
+	size_t len,
+	size_t num_entries
+) {
+	if (len > txt->max_len)
+	{
+		uint8_t * raw = realloc(txt->raw, len);
+		if (!raw)
+		{
+			return -1;
+		}
+		txt->raw = raw;
+		txt->max_len = len;
+	}
+	if (num_entries > txt->max_entries)
+	{
+		brq_txt_entry_t * entries = realloc(txt->entries, num_entries * sizeof(brq_txt_entry_t));
+		if (!entries)
+		{
+			return -1;
+		}
+		txt->entries = entries;
+		txt->max_entries = num_entries;
+	}
+	return 0;
+}
+
+// Find an entry by interned key if it has one, otherwise by its bytes
+static const brq_txt_entry_t *
+find_key
+(
+	const brq_txt_t * txt,
+	const char * key,
+	const char * name,
+	size_t name_len
+) {
+	uint16_t i;
+	for (i = 0; i < txt->num_entries; i++)
+	{
+		const brq_txt_entry_t * entry = txt->entries + i;
+		if (key && entry->key)
+		{
+			// interned keys are unique, whatever their case
+			if (entry->key == key)
+			{
+				return entry;
+			}
+		}
+		else if (key_equals(brq_txt_entry_key(txt, entry), entry->key_len, name, name_len))
+		{
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+uint32_t
+brq_txt_hash
+(
+	const uint8_t * record,
+	uint16_t len
+) {
+	return fnv1a(FNV_OFFSET_BASIS, record, len);
+}
+
+const char *
+brq_txt_intern
+(
+	const char * key,
+	size_t len
+) {
+	uint32_t hash = key_hash(key, len);
+	uint32_t slot = hash & (BRQ_TXT_KEY_SLOTS - 1);
+
+	while (g_key_slots[slot])
+	{
+		const char * curr = g_key_slots[slot];
+		if (g_key_hashes[slot] == hash && key_equals(curr, strlen(curr), key, len))
+		{
+			return curr;
+		}
+		slot = (slot + 1) & (BRQ_TXT_KEY_SLOTS - 1);
+	}
+
+	// keep the table at most half full so probe sequences stay short
+	if (g_num_keys >= BRQ_TXT_KEY_SLOTS / 2 || g_key_arena_used + len + 1 > BRQ_TXT_KEY_ARENA)
+	{
+		return NULL;
+	}
+
+	{
+		char * copy = g_key_arena + g_key_arena_used;
+		memcpy(copy, key, len);
+		copy[len] = '\0';
+		g_key_arena_used += len + 1;
+
+		g_key_slots[slot] = copy;
+		g_key_hashes[slot] = hash;
+		g_num_keys++;
+		return copy;
+	}
+}
+
+void
+brq_txt_reset
+(
+	brq_txt_t * txt
+) {
+	txt->hash = 0;
+	txt->len = 0;
+	txt->num_entries = 0;
+}
+
+void
+brq_txt_free
+(
+	brq_txt_t * txt
+) {
+	free(txt->entries);
+	free(txt->raw);
+	memset(txt, 0, sizeof(brq_txt_t));
+}
+
+void
+brq_txt_swap
+(
+	brq_txt_t * a,
+	brq_txt_t * b
+) {
+	brq_txt_t tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+int
+brq_txt_matches
+(
+	const brq_txt_t * txt,
+	const uint8_t * record,
+	uint16_t len,
+	uint32_t hash
+) {
+	return txt->len
+		&& txt->len == len
+		&& txt->hash == hash
+		&& !memcmp(txt->raw, record, len);
+}
+
+int
+brq_txt_parse
+(
+	brq_txt_t * txt,
+	const uint8_t * record,
+	uint16_t len,
+	uint32_t hash
+) {
+	uint16_t offset = 0;
+
+	brq_txt_reset(txt);
+
+	// every entry takes at least two bytes, its length and one key byte
+	if (reserve(txt, len, len / 2 + 1))
+	{
+		return -1;
+	}
+	memcpy(txt->raw, record, len);
+
+	while (offset < len)
+	{
+		uint8_t item_len = txt->raw[offset];
+		uint16_t item = offset + 1;
+		uint16_t key_len;
+		const char * name = (const char *) txt->raw + item;
+		brq_txt_entry_t * entry;
+
+		if ((uint32_t) item + item_len > len)
+		{
+			brq_txt_reset(txt);
+			return -1;
+		}
+		offset = item + item_len;
+		if (!item_len)
+		{
+			// empty strings are legal (an empty TXT record is a single 0 byte)
+			continue;
+		}
+
+		for (key_len = 0; key_len < item_len && name[key_len] != '='; key_len++)
+			;
+		if (!key_len)
+		{
+			// entries with no key are ignored (RFC 6763 section 6.4)
+			continue;
+		}
+
+		entry = txt->entries + txt->num_entries++;
+		entry->key = brq_txt_intern(name, key_len);
+		entry->key_len = (uint8_t) key_len;
+		entry->key_offset = item;
+		if (key_len < item_len)
+		{
+			entry->has_value = 1;
+			entry->value_offset = item + key_len + 1;
+			entry->value_len = (uint8_t) (item_len - key_len - 1);
+		}
+		else
+		{
+			entry->has_value = 0;
+			entry->value_offset = offset;
+			entry->value_len = 0;
+		}
+	}
+
+	txt->len = len;
+	txt->hash = hash;
+	return 0;
+}
+
+const brq_txt_entry_t *
+brq_txt_find
+(
+	const brq_txt_t * txt,
+	const char * key
+) {
+	return find_key(txt, key, key, strlen(key));
+}
+
+const char *
+brq_txt_entry_key
+(
+	const brq_txt_t * txt,
+	const brq_txt_entry_t * entry
+) {
+	return (const char *) txt->raw + entry->key_offset;
+}
+
+const char *
+brq_txt_entry_value
+(
+	const brq_txt_t * txt,
+	const brq_txt_entry_t * entry
+) {
+	return (const char *) txt->raw + entry->value_offset;
+}
+
+unsigned int
+brq_txt_diff
+(
+	const brq_txt_t * old_txt,
+	const brq_txt_t * new_txt,
+	brq_txt_diff_fn * fn,
+	void * context
+) {
+	unsigned int changes = 0;
+	uint16_t i;
+
+	for (i = 0; i < new_txt->num_entries; i++)
+	{
+		const brq_txt_entry_t * n = new_txt->entries + i;
+		const brq_txt_entry_t * o = find_key(old_txt, n->key, brq_txt_entry_key(new_txt, n), n->key_len);
+		if (!o)
+		{
+			fn(context, BRQ_TXT_CHANGE_ADDED, old_txt, NULL, new_txt, n);
+			changes++;
+		}
+		else if (o->has_value != n->has_value
+			|| o->value_len != n->value_len
+			|| memcmp(old_txt->raw + o->value_offset, new_txt->raw + n->value_offset, n->value_len))
+		{
+			fn(context, BRQ_TXT_CHANGE_MODIFIED, old_txt, o, new_txt, n);
+			changes++;
+		}
+	}
+	for (i = 0; i < old_txt->num_entries; i++)
+	{
+		const brq_txt_entry_t * o = old_txt->entries + i;
+		if (!find_key(new_txt, o->key, brq_txt_entry_key(old_txt, o), o->key_len))
+		{
+			fn(context, BRQ_TXT_CHANGE_REMOVED, old_txt, o, new_txt, NULL);
+			changes++;
+		}
+	}
+	return changes;
+}
@@ -0,0 +1,176 @@
+#ifndef DNSSD_TXT_H
+#define DNSSD_TXT_H
+
+/*
+	Parsed DNS-SD TXT records for dnssd_brq.
+
+	A TXT record is parsed once into a table of (key, value) entries. Keys are
+	interned, ignoring case (RFC 6763 section 6.4), so that entries can be
+	compared by pointer; once the key table is full, new keys are compared by
+	their bytes instead. Keys and values are kept as offsets into a private
+	copy of the raw record. The copy and the entry table grow to fit the
+	largest record parsed into them and are kept across parses, so a parsed
+	record can be handed over by swapping it with another. A hash of the raw
+	record is stored alongside so that a re-announced record that has not
+	changed can be recognised without being parsed again.
+*/
+
+#include <stddef.h>
+
+#ifdef WIN32
+#include "dns_sd.h"	// the Bonjour SDK provides the fixed-width types on windows
+#else
+#include <stdint.h>
+#endif
+
+typedef struct brq_txt_entry
+{
+	const char * key;	// interned, compare by pointer; NULL if the key table was full
+	uint8_t key_len;
+	uint8_t has_value;	// 0 for a 'key' entry, 1 for 'key=' or 'key=value'
+	uint8_t value_len;
+	uint16_t key_offset;	// offset of the key within brq_txt_t.raw
+	uint16_t value_offset;	// offset of the value within brq_txt_t.raw
+} brq_txt_entry_t;
+
+typedef struct brq_txt
+{
+	uint32_t hash;
+	uint16_t len;
+	uint16_t num_entries;
+	brq_txt_entry_t * entries;
+	uint8_t * raw;
+	size_t max_entries;
+	size_t max_len;	// allocated sizes of entries and raw
+} brq_txt_t;
+
+typedef enum brq_txt_change
+{
+	BRQ_TXT_CHANGE_ADDED,
+	BRQ_TXT_CHANGE_REMOVED,
+	BRQ_TXT_CHANGE_MODIFIED
+} brq_txt_change_t;
+
+/*
+	Called once for each key that differs between two parsed records.
+	old_entry is NULL for an added key and new_entry is NULL for a removed key.
+ */
+typedef void
+brq_txt_diff_fn
+(
+	void * context,
+	brq_txt_change_t change,
+	const brq_txt_t * old_txt,
+	const brq_txt_entry_t * old_entry,
+	const brq_txt_t * new_txt,
+	const brq_txt_entry_t * new_entry
+);
+
+// FNV-1a hash of a raw TXT record
+uint32_t
+brq_txt_hash
+(
+	const uint8_t * record,
+	uint16_t len
+);
+
+/*
+	Return the interned copy of the given key, adding it if needed. Keys
+	that differ only in case share a copy, spelt as first seen.
+	Returns NULL if the key table is full.
+ */
+const char *
+brq_txt_intern
+(
+	const char * key,
+	size_t len
+);
+
+// Clear a parsed record, keeping its buffers
+void
+brq_txt_reset
+(
+	brq_txt_t * txt
+);
+
+// Free a record's buffers, leaving it empty
+void
+brq_txt_free
+(
+	brq_txt_t * txt
+);
+
+// Swap two records, buffers and all
+void
+brq_txt_swap
+(
+	brq_txt_t * a,
+	brq_txt_t * b
+);
+
+/*
+	Returns non-zero if the parsed record was parsed from exactly the given
+	raw record. The hash is compared first so that the common cases (a
+	re-announcement of an unchanged record, or a different record) are cheap.
+ */
+int
+brq_txt_matches
+(
+	const brq_txt_t * txt,
+	const uint8_t * record,
+	uint16_t len,
+	uint32_t hash
+);
+
+/*
+	Parse a raw TXT record of any size. Returns 0 on success or -1 if the
+	record is malformed or its buffers cannot be grown. On failure txt is
+	left empty.
+ */
+int
+brq_txt_parse
+(
+	brq_txt_t * txt,
+	const uint8_t * record,
+	uint16_t len,
+	uint32_t hash
+);
+
+// Find an entry using an interned key
+const brq_txt_entry_t *
+brq_txt_find
+(
+	const brq_txt_t * txt,
+	const char * key
+);
+
+// Get a pointer to an entry's key (not null terminated, see key_len)
+const char *
+brq_txt_entry_key
+(
+	const brq_txt_t * txt,
+	const brq_txt_entry_t * entry
+);
+
+// Get a pointer to an entry's value (not null terminated)
+const char *
+brq_txt_entry_value
+(
+	const brq_txt_t * txt,
+	const brq_txt_entry_t * entry
+);
+
+/*
+	Report the key-level differences between two parsed records, returning the
+	number of differences.
+ */
+unsigned int
+brq_txt_diff
+(
+	const brq_txt_t * old_txt,
+	const brq_txt_t * new_txt,
+	brq_txt_diff_fn * fn,
+	void * context
+);
+
+#endif